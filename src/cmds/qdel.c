@@ -353,6 +353,19 @@ cnt:
     if (past_failure == 0)
       past_failure = any_failed;
 
+    if ((stat == 0) &&
+        (!strcasecmp(job_id, "all")))
+      {
+      char *summary;
+
+      /* the server reports what it deleted or how far along it is */
+      if ((summary = pbs_geterrmsg(connect)) != NULL)
+        {
+        fprintf(stdout, "qdel: %s\n", summary);
+        free(summary);
+        }
+      }
+
     if (stat &&
         (any_failed != PBSE_UNKJOBID))
       {
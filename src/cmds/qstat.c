@@ -97,6 +97,7 @@ int                  E_opt;
 
 std::string          ExtendOpt;
 bool                 condensed = false;
+bool                 history_opt = false;
 struct attropl      *p_atropl = 0;
 struct attrl        *attrib = NULL;
 char                 user[MAXPATHLEN];
@@ -2596,7 +2597,7 @@ int process_commandline_opts(
   int rc = PBSE_NONE;
 
 #if !defined(PBS_NO_POSIX_VIOLATION)
-#define GETOPT_ARGS "acCeE:filn1pqrstu:xGMQRBW:-:"
+#define GETOPT_ARGS "acCeE:fHiln1pqrstu:xGMQRBW:-:"
 #else
 #define GETOPT_ARGS "flpQBW:"
 #endif /* PBS_NO_POSIX_VIOLATION */
@@ -2773,6 +2774,13 @@ int process_commandline_opts(
 
         break;
 
+      case 'H':
+
+        /* report finished jobs from the server's job history */
+        history_opt = true;
+
+        break;
+
       case 'B':
 
         B_opt = 1;
@@ -3461,6 +3469,7 @@ void print_usage()
   static char usage[] = "usage: \n\
                           qstat [-f [-1]] [-W site_specific] [-x] [ job_identifier... | destination... ]\n\
                           qstat [-a|-i|-r|-e] [-u user] [-n [-1]] [-s] [-t] [-G|-M] [-R] [job_id... | destination...]\n\
+                          qstat -H [-f [-1]] [-a] [-u user] [-x] [ job_identifier... | destination... ]\n\
                           qstat -Q [-f [-1]] [-W site_specific] [ destination... ]\n\
                           qstat -q [-G|-M] [ destination... ]\n\
                           qstat -B [-f [-1]] [-W site_specific] [ server_name... ]\n\
@@ -3553,6 +3562,21 @@ int main(
   if (condensed == true)
     ExtendOpt += "C";
 
+  if (history_opt == true)
+    {
+    /* the user filter travels with the request instead of as a select */
+    ExtendOpt = JOBHISTORY;
+
+    if (alt_opt & ALT_DISPLAY_u)
+      {
+      ExtendOpt += ":user=";
+      ExtendOpt += user;
+      }
+
+    exec_only = 0;
+    do_not_display_complete = false;
+    }
+
   def_server = pbs_default();
 
   if (def_server == NULL)
@@ -3568,10 +3592,11 @@ int main(
 
   if (alt_opt & ALT_DISPLAY_u)
     {
-    if (f_opt == 0)
-      add_atropl(&p_atropl, (char *)ATTR_u, NULL, user, EQ);
-    else
+    /* the history extension carries the user itself */
+    if (f_opt != 0)
       alt_opt &= ~ALT_DISPLAY_u;
+    else if (history_opt == false)
+      add_atropl(&p_atropl, (char *)ATTR_u, NULL, user, EQ);
     }
 
 
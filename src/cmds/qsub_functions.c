@@ -38,6 +38,7 @@
 #include <grp.h>
 #include <csv.h>
 #include <pwd.h>
+#include <vector>
 
 #ifdef sun
 #include <sys/stream.h>
@@ -79,6 +80,8 @@ char *new_jobname = NULL;           /* return from submit request */
 /* for reference purposes:
  * pbs_server is defined in pbsD_connect.c and the extern is in pbs_ifl.h */
 static char server_out[PBS_MAXSERVERNAME + PBS_MAXPORTNUM + 2];
+/* whether the server accepts SubmitJob: -1 until it has been asked */
+static int server_has_submitjob = -1;
 struct termios oldtio;
 /* END: bailout globals */
 
@@ -2961,8 +2964,16 @@ void process_opts(
       case '-':
         /**
          * We have already tested for --version and --about, in process_early_opts().
-         * Any other opt that has - as the first char is invalid.
+         * --bulk=<file> is the only other long option.
          */
+        if ((strncmp(optarg, "bulk=", 5) == 0) &&
+            (optarg[5] != '\0'))
+          {
+          hash_add_or_exit(ji->client_attr, "bulk_file", optarg + 5, data_type);
+
+          break;
+          }
+
         print_qsub_usage_exit("a single - is not a valid option");
 
         break;
@@ -4284,6 +4295,363 @@ bool retry_submit_error(
 
 
 
+/*
+ * server_accepts_submitjob()
+ *
+ * Asks the server for its combined_submit attribute, which only servers that
+ * accept the SubmitJob request report. Any other answer, including the
+ * rejection an older server sends for an attribute it doesn't know, means the
+ * job has to go in the QueueJob, JobScript and Commit sequence. The server is
+ * asked once per qsub.
+ *
+ * @param sock_num - the server connection
+ * @return true if the server accepts SubmitJob
+ */
+
+bool server_accepts_submitjob(
+
+  int sock_num)
+
+  {
+  struct attrl         attr;
+  struct batch_status *status;
+
+  if (server_has_submitjob != -1)
+    return(server_has_submitjob == 1);
+
+  memset(&attr, 0, sizeof(attr));
+  attr.name = (char *)ATTR_combined_submit;
+
+  server_has_submitjob = 0;
+
+  if ((status = pbs_statserver(sock_num, &attr, NULL)) != NULL)
+    {
+    for (struct attrl *pattr = status->attribs; pattr != NULL; pattr = pattr->next)
+      {
+      if ((!strcmp(pattr->name, ATTR_combined_submit)) &&
+          (pattr->value != NULL) &&
+          (!strcasecmp(pattr->value, ATR_TRUE)))
+        server_has_submitjob = 1;
+      }
+
+    pbs_statfree(status);
+    }
+
+  return(server_has_submitjob == 1);
+  } // END server_accepts_submitjob()
+
+
+
+/*
+ * submit_job()
+ *
+ * Sends the job to the server in a single SubmitJob request if the server
+ * accepts it, otherwise in the QueueJob, JobScript and Commit sequence.
+ *
+ * @param sock_num - the server connection
+ * @return PBSE_NONE on success, otherwise a PBSE_* error code
+ */
+
+int submit_job(
+
+  int                *sock_num,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char               *script,
+  char               *destination,
+  char              **job_id,
+  char              **errmsg)
+
+  {
+  if (server_accepts_submitjob(*sock_num) == true)
+    return(pbs_submitjob_hash(*sock_num, job_attr, res_attr, script, destination, NULL, job_id, errmsg));
+
+  return(pbs_submit_hash(*sock_num, job_attr, res_attr, script, destination, NULL, job_id, errmsg));
+  } // END submit_job()
+
+
+
+/*
+ * parse_bulk_spec()
+ *
+ * Parses one line of a --bulk file into the attributes that job changes from
+ * the rest of the submission. A line holds any of -N name, -l resource_list
+ * and -v variable_list.
+ *
+ * @param line - the line to parse
+ * @param spec - the job's attributes (O)
+ * @return PBSE_NONE on success, or PBSE_IVALREQ if the line is bad
+ */
+
+int parse_bulk_spec(
+
+  const char *line,
+  job_info   *spec)
+
+  {
+  int          argc = 0;
+  int          i;
+  char        *res;
+  char        *value;
+  char        *ptr;
+  job_data    *v_value;
+  static char *vect[MAX_ARGV_LEN + 1] = {};
+
+  make_argv(&argc, vect, line);
+
+  /* vect[0] is the "qsub" make_argv() puts in front */
+  for (i = 1; i < argc; i += 2)
+    {
+    if ((i + 1 >= argc) ||
+        (vect[i][0] != '-') ||
+        (vect[i][1] == '\0') ||
+        (vect[i][2] != '\0'))
+      return(PBSE_IVALREQ);
+
+    switch (vect[i][1])
+      {
+      case 'N':
+
+        if (check_job_name(vect[i + 1], 0) != 0)
+          return(PBSE_IVALREQ);
+
+        hash_add_or_exit(spec->job_attr, ATTR_N, vect[i + 1], CMDLINE_DATA);
+
+        break;
+
+      case 'l':
+
+        for (res = strtok_r(vect[i + 1], ",", &ptr); res != NULL; res = strtok_r(NULL, ",", &ptr))
+          {
+          if ((value = strchr(res, '=')) == NULL)
+            return(PBSE_IVALREQ);
+
+          *value++ = '\0';
+
+          hash_add_or_exit(spec->res_attr, res, value, CMDLINE_DATA);
+          }
+
+        break;
+
+      case 'v':
+
+        if (hash_find(spec->job_attr, ATTR_v, &v_value))
+          {
+          std::string vars(v_value->value);
+
+          vars += ",";
+          vars += vect[i + 1];
+          hash_add_or_exit(spec->job_attr, ATTR_v, vars.c_str(), CMDLINE_DATA);
+          }
+        else
+          hash_add_or_exit(spec->job_attr, ATTR_v, vect[i + 1], CMDLINE_DATA);
+
+        break;
+
+      default:
+
+        return(PBSE_IVALREQ);
+      }
+    }
+
+  return(PBSE_NONE);
+  } // END parse_bulk_spec()
+
+
+
+/*
+ * submit_bulk_job_singly()
+ *
+ * Submits one --bulk job by itself, for servers without the SubmitJobs request.
+ */
+
+int submit_bulk_job_singly(
+
+  int        *sock_num,
+  job_info   *ji,
+  job_info   *spec,
+  char       *script,
+  char       *destination,
+  char      **job_id)
+
+  {
+  job_info   job;
+  job_data  *v_value;
+  job_data  *spec_v;
+  char      *errmsg = NULL;
+  int        rc;
+
+  hash_add_hash(job.job_attr, ji->job_attr, TRUE);
+  hash_add_hash(job.res_attr, ji->res_attr, TRUE);
+
+  /* a job's variables are added to everyone's rather than replacing them */
+  if ((hash_find(spec->job_attr, ATTR_v, &spec_v)) &&
+      (hash_find(job.job_attr, ATTR_v, &v_value)))
+    {
+    std::string vars(v_value->value);
+
+    vars += ",";
+    vars += spec_v->value;
+
+    hash_add_hash(job.job_attr, spec->job_attr, TRUE);
+    hash_add_or_exit(job.job_attr, ATTR_v, vars.c_str(), CMDLINE_DATA);
+    }
+  else
+    hash_add_hash(job.job_attr, spec->job_attr, TRUE);
+
+  hash_add_hash(job.res_attr, spec->res_attr, TRUE);
+
+  rc = submit_job(sock_num, job.job_attr, job.res_attr, script, destination, job_id, &errmsg);
+
+  if (errmsg != NULL)
+    free(errmsg);
+
+  return(rc);
+  } // END submit_bulk_job_singly()
+
+
+
+/*
+ * submit_bulk_jobs()
+ *
+ * Submits one job for each line of spec_file ("-" is standard input), all
+ * built from the rest of the submission, with a single SubmitJobs request
+ * when the server supports it. Prints the job ids in order.
+ *
+ * @return PBSE_NONE if every job was submitted, otherwise the last error
+ */
+
+int submit_bulk_jobs(
+
+  int        *sock_num,
+  job_info   *ji,
+  char       *script,
+  char       *destination,
+  const char *spec_file)
+
+  {
+  FILE                               *fp;
+  char                                line[MAXBUF];
+  char                               *errmsg = NULL;
+  char                               *ptr;
+  int                                 line_num = 0;
+  int                                 count;
+  int                                 i;
+  int                                 rc = PBSE_NONE;
+  int                                 last_rc = PBSE_NONE;
+  std::vector<job_info *>             specs;
+  std::vector<job_data_container *>   job_overrides;
+  std::vector<job_data_container *>   res_overrides;
+  job_data                           *tmp_job_info;
+
+  if (!strcmp(spec_file, "-"))
+    fp = stdin;
+  else if ((fp = fopen(spec_file, "r")) == NULL)
+    {
+    fprintf(stderr, "qsub: cannot open bulk file '%s' - %s\n", spec_file, strerror(errno));
+    return(PBSE_IVALREQ);
+    }
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+    line_num++;
+
+    if ((ptr = strchr(line, '\n')) != NULL)
+      *ptr = '\0';
+
+    for (ptr = line; isspace(*ptr); ptr++);
+
+    if ((*ptr == '\0') ||
+        (*ptr == '#'))
+      continue;
+
+    job_info *spec = new job_info();
+
+    specs.push_back(spec);
+
+    if (parse_bulk_spec(ptr, spec) != PBSE_NONE)
+      {
+      fprintf(stderr, "qsub: invalid job in bulk file on line %d: %s\n", line_num, ptr);
+      rc = PBSE_IVALREQ;
+      break;
+      }
+
+    job_overrides.push_back(spec->job_attr);
+    res_overrides.push_back(spec->res_attr);
+    }
+
+  if (fp != stdin)
+    fclose(fp);
+
+  count = job_overrides.size();
+
+  if ((rc == PBSE_NONE) &&
+      (count == 0))
+    {
+    fprintf(stderr, "qsub: no jobs in bulk file '%s'\n", spec_file);
+    rc = PBSE_IVALREQ;
+    }
+
+  if (rc != PBSE_NONE)
+    {
+    for (i = 0; i < (int)specs.size(); i++)
+      delete specs[i];
+
+    return(rc);
+    }
+
+  std::vector<char *> job_ids(count, NULL);
+  std::vector<int>    job_rcs(count, PBSE_NONE);
+
+  if (server_accepts_submitjob(*sock_num) == true)
+    {
+    rc = pbs_submitjobs_hash(*sock_num, ji->job_attr, ji->res_attr, script, destination, count,
+           &job_overrides[0], &res_overrides[0], &job_ids[0], &job_rcs[0], &errmsg);
+
+    if (rc != PBSE_NONE)
+      {
+      for (i = 0; i < count; i++)
+        {
+        if (job_ids[i] == NULL)
+          job_rcs[i] = rc;
+        }
+
+      rc = PBSE_NONE;
+      }
+
+    if (errmsg != NULL)
+      {
+      fprintf(stderr, "qsub: submit error (%s)\n", errmsg);
+      free(errmsg);
+      }
+    }
+  else
+    {
+    for (i = 0; i < count; i++)
+      job_rcs[i] = submit_bulk_job_singly(sock_num, ji, specs[i], script, destination, &job_ids[i]);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+    if (job_rcs[i] != PBSE_NONE)
+      {
+      fprintf(stderr, "qsub: submit error for job %d (%s)\n", i + 1, pbs_strerror(job_rcs[i]));
+      last_rc = job_rcs[i];
+      }
+    else if (hash_find(ji->client_attr, "no_jobid_out", &tmp_job_info) == FALSE)
+      printf("%s\n", job_ids[i]);
+
+    if (job_ids[i] != NULL)
+      free(job_ids[i]);
+
+    delete specs[i];
+    }
+
+  return(last_rc);
+  } // END submit_bulk_jobs()
+
+
+
 /** 
  * qsub main 
  *
@@ -4310,6 +4678,7 @@ void main_func(
   char             *errmsg = NULL;                /* return from pbs_geterrmsg */
   int               local_errno = 0;
   int               job_is_interactive = FALSE;
+  job_data         *bulk_file;
   int               prefix_index = -1;
 
   struct stat       statbuf;
@@ -4484,6 +4853,16 @@ void main_func(
   /* (2) cmdline options */
   process_opts(argc, argv, &ji, CMDLINE_DATA);
 
+  if (hash_find(ji.client_attr, "bulk_file", &bulk_file))
+    {
+    if (hash_find(ji.job_attr, ATTR_inter, &tmp_job_info))
+      print_qsub_usage_exit("qsub: --bulk cannot be used with interactive jobs");
+
+    if ((bulk_file->value == "-") &&
+        ((!strcmp(script, "")) || (!strcmp(script, "-"))))
+      print_qsub_usage_exit("qsub: --bulk=- needs a script file");
+    }
+
   if (((optind + 1) < argc) && (hash_find(ji.job_attr, ATTR_inter, &tmp_job_info) == FALSE))
     print_qsub_usage_exit("index issues");
   
@@ -4668,17 +5047,26 @@ void main_func(
 
   /* Send submit request to the server. */
 
+  if (hash_find(ji.client_attr, "bulk_file", &tmp_job_info))
+    {
+    local_errno = submit_bulk_jobs(&sock_num, &ji, script_tmp, destination, tmp_job_info->value.c_str());
+
+    pbs_disconnect(sock_num);
+    unlink(script_tmp);
+
+    exit(local_errno);
+    }
+
   int retries = 0;
 
   do
     {
-    local_errno = pbs_submit_hash(
-                  sock_num,
+    local_errno = submit_job(
+                  &sock_num,
                   ji.job_attr,
                   ji.res_attr,
                   script_tmp,
                   destination,
-                  NULL,
                   &new_jobname,
                   &errmsg);
 
@@ -96,6 +96,9 @@
 
 #define PBS_ACCT_MAX_RCD 262144         /* increased from 4095 */
 
+#define ACCT_BUFFER_SIZE    65536  /* bytes of records buffered before a write */
+#define ACCT_FLUSH_INTERVAL 1      /* seconds a record may wait in the buffer */
+
 #define PBS_ACCT_QUEUE (int)'Q' /* Job Queued record */
 #define PBS_ACCT_RUN (int)'S' /* Job run (Started) */
 #define PBS_ACCT_RERUN (int)'R' /* Job Rerun record */
@@ -107,6 +110,8 @@
 
 extern int  acct_open (char *filename, bool acct_mutex_locked);
 void        acct_close (bool acct_mutex_locked);
+void        acct_flush (void);
+void        acct_usage_enable (bool enable);
 extern void account_record (int acctype, job *pjob, const char *text);
 extern void account_jobstr (job *pjob);
 extern void account_jobend (job *pjob, std::string &acct_data);
@@ -0,0 +1,155 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#ifndef ACCT_USAGE_H
+#define ACCT_USAGE_H
+
+#include <stdint.h>
+#include "pbs_ifl.h" /* PBS_MAXSVRJOBID */
+
+/*
+ * acct_usage.h - the binary job usage sidecar of the accounting log
+ *
+ * When record_job_usage is set, pbs_server writes a fixed size record for
+ * each job end ('E') accounting record to <accounting file>.usage, so usage
+ * can be summed without parsing the text log. When a usage file is closed
+ * the server also writes <accounting file>.usage.idx, which lists the
+ * records of each user. printacct reads both.
+ *
+ * A usage file is an acct_usage_header followed by records of
+ * uh_record_size bytes. An index file is an acct_usage_index_header,
+ * uih_user_count acct_usage_index_entry structures and then the record
+ * numbers the entries point into.
+ */
+
+#define ACCT_USAGE_MAGIC          0x50424155  /* "PBAU" */
+#define ACCT_USAGE_INDEX_MAGIC    0x50424149  /* "PBAI" */
+#define ACCT_USAGE_VERSION        2
+#define ACCT_USAGE_SUFFIX         ".usage"
+#define ACCT_USAGE_INDEX_SUFFIX   ".usage.idx"
+#define ACCT_USAGE_BUFFER_RECORDS 64  /* records buffered before a write */
+#define ACCT_USAGE_NAME_LEN       32
+#define ACCT_USAGE_JOBID_LEN      (PBS_MAXSVRJOBID + 1)
+
+typedef struct acct_usage_header
+  {
+  uint32_t uh_magic;
+  uint32_t uh_version;
+  uint32_t uh_record_size;  /* sizeof(acct_usage_record) when written */
+  uint32_t uh_pad;
+  int64_t  uh_created;
+  } acct_usage_header;
+
+typedef struct acct_usage_record
+  {
+  int64_t  ur_time;         /* when the accounting record was written */
+  int64_t  ur_qtime;
+  int64_t  ur_start;
+  int64_t  ur_end;
+  uint64_t ur_walltime;     /* seconds */
+  uint64_t ur_cput;         /* seconds */
+  uint64_t ur_mem;          /* kb */
+  uint64_t ur_vmem;         /* kb */
+  uint32_t ur_slots;        /* total_execution_slots */
+  uint32_t ur_nodes;        /* unique_node_count */
+  int32_t  ur_exit_status;
+  int32_t  ur_type;         /* the accounting record type, PBS_ACCT_END */
+  char     ur_job_id[ACCT_USAGE_JOBID_LEN];
+  char     ur_user[ACCT_USAGE_NAME_LEN];
+  char     ur_group[ACCT_USAGE_NAME_LEN];
+  char     ur_queue[ACCT_USAGE_NAME_LEN];
+  char     ur_account[ACCT_USAGE_NAME_LEN];
+  } acct_usage_record;
+
+typedef struct acct_usage_index_header
+  {
+  uint32_t uih_magic;
+  uint32_t uih_version;
+  uint32_t uih_user_count;
+  uint32_t uih_record_count;  /* records in the usage file when indexed */
+  } acct_usage_index_header;
+
+typedef struct acct_usage_index_entry
+  {
+  char     uie_user[ACCT_USAGE_NAME_LEN];
+  uint32_t uie_first;  /* position of the user's first record number */
+  uint32_t uie_count;
+  } acct_usage_index_entry;
+
+#endif /* ACCT_USAGE_H */
@@ -2,6 +2,10 @@
 #define ARRAY_H
 
 #include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
 
 /* these are required if you include array.h */
 #include "pbs_ifl.h"
@@ -131,12 +135,45 @@ class array_info
   };
 
 
+/*
+ * The indices of an array that haven't been created yet, kept as the
+ * [first, last] ranges they were requested in so a large array only costs
+ * a few pairs until its sub-jobs are instantiated. Indices are handed out
+ * from the front in request order.
+ */
+
+class index_ranges
+  {
+  std::vector<std::pair<int, int> > ranges;
+  size_t                            head;  // first range that still has indices
+  int                               count; // indices left in all ranges
+
+  public:
+  index_ranges() : ranges(), head(0), count(0) {}
+
+  int    parse(const char *range_string);
+  void   clear();
+  int    size() const;
+  bool   empty() const;
+  int    front() const;
+  void   pop_front();
+  int    max_index() const;
+  void   remove_through(int index);
+  size_t range_count() const;
+  void   get_range(size_t i, int &first, int &last) const;
+  };
+
+
+
 /* pbs_server will keep a list of these structs, with one struct per job array*/
 
 class job_array
   {
   public:
-  char             **job_ids; // Array of the sub job ids for this array
+  // Ids of the sub-jobs that have been created, keyed by index. The indices
+  // that haven't been created yet are in uncreated_ids, so only sub-jobs
+  // that exist take an entry.
+  std::map<int, std::string> job_ids;
   
   /* on server restart we track the number of array tasks that have been recovered. This is
    * in case the server is restarted (cleanly) before the array is completely setup */
@@ -146,8 +183,8 @@ class job_array
   // order to not lose sub-jobs
   bool               ai_ghost_recovered;
 
-  // Vector of array sub jobs indices that haven't been created
-  std::vector<int>   uncreated_ids;
+  // Array sub job indices that haven't been created
+  index_ranges       uncreated_ids;
 
   pthread_mutex_t   *ai_mutex;
 
@@ -169,12 +206,38 @@ class job_array
   void update_array_values(int old_state, enum ArrayEventsEnum event, const char *job_id,
                             int job_exit_status);
   void create_job_if_needed();
-  int  get_next_index_to_create(int &internal_index);
+  int  get_next_index_to_create();
   void initialize_uncreated_ids();
 
   bool need_to_update_slot_limits() const;
   void mark_deleted();
   bool is_deleted() const;
+
+  // the id of the sub-job at index, or NULL if it doesn't exist
+  const char *get_job_id(int index) const
+    {
+    std::map<int, std::string>::const_iterator it = this->job_ids.find(index);
+
+    return((it == this->job_ids.end()) ? NULL : it->second.c_str());
+    }
+
+  // the first index after index that has a sub-job, or -1 if there is none
+  int next_job_index(int index) const
+    {
+    std::map<int, std::string>::const_iterator it = this->job_ids.upper_bound(index);
+
+    return((it == this->job_ids.end()) ? -1 : it->first);
+    }
+
+  void set_job_id(int index, const char *job_id)
+    {
+    this->job_ids[index] = job_id;
+    }
+
+  void remove_job_id(int index)
+    {
+    this->job_ids.erase(index);
+    }
   };
 
 
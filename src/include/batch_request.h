@@ -151,6 +151,25 @@ struct rq_jobfile
   char *rq_data;
   };
 
+/* SubmitJob - QueueJob, JobCredential, JobScript and Commit in one request */
+
+struct rq_submitjob
+  {
+  struct rq_queuejob rq_job;   /* must be first, read as rq_ind.rq_queuejob */
+  struct rq_jobcred  rq_cred;
+  long               rq_script_size;
+  char              *rq_script;
+  };
+
+/* SubmitJobs - many SubmitJobs sharing one set of attributes and one script */
+
+struct rq_submitjobs
+  {
+  struct rq_submitjob rq_template;  /* must be first, read as rq_ind.rq_submitjob */
+  int                 rq_count;
+  tlist_head         *rq_overrides; /* per job, attributes replacing the template's */
+  };
+
 /*
  * job or destination id - used by RdyToCommit, Commit, RerunJob,
  * status ..., locate job, and run job - is just a char *
@@ -314,6 +333,16 @@ struct rq_jobobit
   tlist_head rq_attr;   /* svrattrlist */
   };
 
+/* Batched Job Obituaries (MOM -> Server Only) */
+
+#define PBS_MAX_OBIT_BATCH  256  /* most obits one JobObitBatch request carries */
+
+struct rq_jobobit_batch
+  {
+  int                rq_count;
+  struct rq_jobobit *rq_obits;   /* rq_count entries */
+  };
+
 /*
  * ok we now have all the individual request structures defined,
  * so here is the union ...
@@ -351,6 +380,10 @@ struct batch_request
     struct rq_jobcred     rq_jobcred;
 
     struct rq_jobfile     rq_jobfile;
+
+    struct rq_submitjob   rq_submitjob;
+
+    struct rq_submitjobs  rq_submitjobs;
     char                  rq_rdytocommit[PBS_MAXSVRJOBID+1];
     char                  rq_commit[PBS_MAXSVRJOBID+1];
 
@@ -393,6 +426,8 @@ struct batch_request
     struct rq_returnfiles rq_returnfiles;
 
     struct rq_jobobit     rq_jobobit;
+
+    struct rq_jobobit_batch rq_jobobit_batch;
     } rq_ind;
   };
 
@@ -453,10 +488,13 @@ extern int decode_DIS_CopyFiles (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_JobCred (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_JobFile (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_JobObit (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_JobObitBatch (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Manage (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_MoveJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_MessageJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_QueueJob (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_SubmitJob (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_SubmitJobs (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Register (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ReturnFiles (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ReqExtend (struct tcp_chan *chan, struct batch_request *);
@@ -475,6 +513,7 @@ extern int decode_DIS_PowerState (struct tcp_chan *chan, struct batch_request *)
 
 extern int encode_DIS_CopyFiles (struct tcp_chan *chan, struct batch_request *);
 extern int encode_DIS_JobObit (struct tcp_chan *chan, struct batch_request *);
+extern int encode_DIS_JobObitBatch (struct tcp_chan *chan, struct batch_request *);
 extern int encode_DIS_Register (struct tcp_chan *chan, struct batch_request *);
 extern int encode_DIS_ReturnFiles (struct tcp_chan *chan, struct batch_request *);
 extern int encode_DIS_TrackJob (struct tcp_chan *chan, struct batch_request *);
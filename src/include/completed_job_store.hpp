@@ -0,0 +1,186 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#ifndef COMPLETED_JOB_STORE_HPP
+#define COMPLETED_JOB_STORE_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <pthread.h>
+
+#define COMPLETED_STORE_MAGIC      0x4a434250 /* "PBCJ" */
+#define COMPLETED_STORE_SPILL_FILE "completed_jobs"
+#define COMPLETED_STORE_MIN_MAP    (1024 * 1024)
+
+/* one encoded status entry of a compacted job. ca_index is the job
+ * attribute index it came from, or -1 if it wasn't a plain attribute */
+typedef struct completed_job_attr
+  {
+  int         ca_index;
+  std::string ca_name;
+  std::string ca_resc;
+  std::string ca_value;
+  } completed_job_attr;
+
+/* what the server needs to authorize and place a compacted job */
+typedef struct completed_job_info
+  {
+  std::string ci_owner;
+  std::string ci_submit_host;
+  std::string ci_queue;
+  time_t      ci_mod_time;
+  time_t      ci_expires;
+  } completed_job_info;
+
+/* fixed part of a record, followed by its strings and attributes */
+typedef struct completed_record_header
+  {
+  unsigned int  cr_magic;
+  unsigned int  cr_length;
+  unsigned int  cr_live;
+  unsigned int  cr_attr_count;
+  long long     cr_mod_time;
+  long long     cr_expires;
+  } completed_record_header;
+
+/*
+ * completed_job_store
+ *
+ * Read-only records of completed jobs that are being kept for
+ * keep_completed. A job's status is encoded once when it completes and
+ * the job itself is purged, so retention costs one packed record per job
+ * instead of a full job in alljobs. Records live in memory, or in a
+ * memory-mapped spill file under server_priv that also survives restarts.
+ */
+
+class completed_job_store
+  {
+  typedef struct stored_record
+    {
+    std::string sr_queue;
+    time_t      sr_expires;
+    size_t      sr_offset; /* offset into the spill file */
+    size_t      sr_length;
+    std::string sr_data;   /* the record itself when not spilled */
+    } stored_record;
+
+  std::map<std::string, stored_record>        records;
+  std::set<std::pair<time_t, std::string> >   expiry;
+  pthread_mutex_t                             lock;
+
+  std::string                                 spill_path;
+  int                                         spill_fd;
+  char                                       *spill_map;
+  size_t                                      spill_size;
+  size_t                                      spill_used;
+  size_t                                      spill_dead;
+
+  void   remove_record(std::map<std::string, stored_record>::iterator it);
+  bool   spill_reserve(size_t needed);
+  bool   spill_append(stored_record &rec, const std::string &data);
+  void   spill_recover();
+  void   spill_compact();
+  void   spill_close();
+  const char *record_data(const stored_record &rec);
+
+  public:
+    completed_job_store();
+    ~completed_job_store();
+
+    bool   add_job(const char *job_id, const completed_job_info &info, const std::vector<completed_job_attr> &attrs);
+    bool   remove_job(const char *job_id);
+    bool   has_job(const char *job_id);
+    bool   get_job(const char *job_id, completed_job_info &info, std::vector<completed_job_attr> &attrs);
+    void   get_job_ids(const char *queue, std::vector<std::string> &ids);
+    int    cleanup_expired(time_t now);
+    int    set_spill_file(const char *path);
+    bool   is_spilled();
+    size_t count();
+    size_t spill_bytes_used();
+  };
+
+int  encode_completed_record(const char *job_id, const completed_job_info &info, const std::vector<completed_job_attr> &attrs, std::string &out);
+bool decode_completed_record(const char *data, size_t length, std::string &job_id, completed_job_info &info, std::vector<completed_job_attr> *attrs);
+
+extern completed_job_store completed_store;
+
+#endif /* COMPLETED_JOB_STORE_HPP */
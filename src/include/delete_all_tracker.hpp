@@ -83,8 +83,9 @@
 
 class delete_all_tracker
   {
-    std::map<std::string, bool> qdel_map;
-    pthread_mutex_t             lock;
+    std::map<std::string, bool>                  qdel_map;
+    std::map<std::string, std::pair<int, int> >  progress_map; /* jobs handled, jobs total */
+    pthread_mutex_t                              lock;
 
   public:
     delete_all_tracker();
@@ -93,6 +94,8 @@ class delete_all_tracker
     bool currently_deleting_all(const char *user, int perm);
     bool start_deleting_all_if_possible(const char *user, int perm);
     void done_deleting_all(const char *user, int perm);
+    void update_progress(const char *user, int perm, int handled, int total);
+    bool get_progress(const char *user, int perm, int &handled, int &total);
   };
 
 extern delete_all_tracker can_qdel;
@@ -0,0 +1,144 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * event_trace.h - the binary job event trace
+ *
+ * When tracing is on, pbs_server and pbs_mom append a fixed size record for
+ * each job lifecycle event to YYYYMMDD.trace in their log directory. The
+ * records are buffered in memory and written in blocks, so tracing can stay
+ * on at a cost far below text logging. printtrace decodes the files.
+ */
+
+#define TRACE_MAGIC          0x50425354  /* "PBST" */
+#define TRACE_VERSION        1
+#define TRACE_FILE_SUFFIX    ".trace"
+#define TRACE_BUFFER_RECORDS 128  /* records buffered before a write */
+#define TRACE_FLUSH_INTERVAL 1    /* seconds a record may wait in the buffer */
+
+/* the meaning of tr_duration and tr_value depends on the event */
+enum trace_event_type
+  {
+  TRACE_FILE_HEADER,   /* first record of a file, tr_value is TRACE_VERSION */
+  TRACE_JOB_QUEUED,    /* server: job committed to a queue, duration is the time since it was created */
+  TRACE_JOB_RUN,       /* server: job sent to its mother superior, duration is the queue wait */
+  TRACE_JOB_OBIT,      /* server: obit received, duration is the run time, value the exit status */
+  TRACE_JOB_REQUEUE,   /* server: job requeued, duration is the run time */
+  TRACE_JOB_COMPLETE,  /* server: job completed, duration is the time since it was queued */
+  TRACE_JOB_DELETED,   /* server: job deleted by a user, duration is the time since it was queued */
+  TRACE_JOB_START,     /* mom: job launched, value is its session id */
+  TRACE_JOB_EXIT,      /* mom: job exited, duration is the run time, value the exit status */
+  TRACE_EVENT_COUNT
+  };
+
+enum trace_source
+  {
+  TRACE_SOURCE_SERVER,
+  TRACE_SOURCE_MOM
+  };
+
+typedef struct trace_record
+  {
+  uint64_t tr_time;      /* usecs since the epoch */
+  uint64_t tr_duration;  /* usecs */
+  uint32_t tr_job_hash;  /* trace_job_hash() of the full job id */
+  uint32_t tr_job_num;   /* the sequence number from the job id */
+  uint16_t tr_event;     /* trace_event_type */
+  uint16_t tr_source;    /* trace_source */
+  int32_t  tr_value;
+  } trace_record;
+
+int         trace_open(const char *directory, int source);
+void        trace_close(void);
+void        trace_flush(void);
+bool        trace_is_open(void);
+void        trace_event(int event, const char *job_id, uint64_t duration, int value);
+uint64_t    trace_elapsed(time_t since);
+uint32_t    trace_job_hash(const char *job_id);
+uint32_t    trace_job_num(const char *job_id);
+const char *trace_event_name(int event);
+int         trace_event_from_name(const char *name);
+
+#endif /* EVENT_TRACE_H */
@@ -80,12 +80,14 @@
 * without reference to its choice of law rules.
 */
 
-#include <vector>
+#include "slot_bitset.hpp"
 
 class execution_slot_tracker
   {
-  std::vector<bool> slots;
-  int               open_count;
+  slot_bitset slots;
+  int         open_count;
+
+  void grow_to(int size);
 
   public:
     execution_slot_tracker(const execution_slot_tracker& est);
@@ -0,0 +1,151 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#ifndef JOB_HISTORY_HPP
+#define JOB_HISTORY_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <pthread.h>
+
+#include "completed_job_store.hpp"
+
+#define JOB_HISTORY_DIR          "job_history"
+#define JOB_HISTORY_DAYS_DEFAULT 30
+
+/* where a history record is kept */
+typedef struct history_location
+  {
+  int         hl_day;    /* YYYYMMDD of the file holding it */
+  size_t      hl_offset;
+  size_t      hl_length;
+  time_t      hl_end;
+  std::string hl_user;
+  std::string hl_queue;
+  } history_location;
+
+/*
+ * job_history
+ *
+ * Append-only record of the jobs that finished on this server. Each job is
+ * written once, in the completed_store record format, to a YYYYMMDD file
+ * in server_priv/job_history for the day it finished. The indexes by job
+ * id, by user and by completion time are rebuilt from the files when the
+ * history is opened, so status requests for finished jobs never touch the
+ * job table or scan the files. Whole days are removed once they are older
+ * than job_history_days.
+ */
+
+class job_history
+  {
+  std::string                                                        directory;
+  std::map<int, int>                                                 day_fds;
+  std::map<std::string, history_location>                            by_id;
+  std::map<std::string, std::set<std::pair<time_t, std::string> > >  by_user;
+  std::set<std::pair<time_t, std::string> >                          by_time;
+  pthread_mutex_t                                                    lock;
+
+  int  day_fd(int day);
+  int  load_day(int day);
+  void index_record(const std::string &job_id, const history_location &loc);
+  void close_unlocked();
+
+  public:
+    job_history();
+    ~job_history();
+
+    int    open_history(const char *dir);
+    void   close_history();
+    bool   is_open();
+    int    add_job(const char *job_id, const completed_job_info &info, const std::vector<completed_job_attr> &attrs);
+    bool   has_job(const char *job_id);
+    bool   get_job(const char *job_id, completed_job_info &info, std::vector<completed_job_attr> &attrs);
+    void   find_jobs(const char *user, const char *queue, time_t since, time_t until, std::vector<std::string> &ids);
+    int    expire(time_t now, long keep_days);
+    size_t count();
+  };
+
+int history_day(time_t when);
+
+extern job_history job_hist;
+
+#endif /* JOB_HISTORY_HPP */
@@ -324,6 +324,11 @@ char *PBSD_queuejob (int c, int *, const char *j, const char *d, struct attropl
 char *PBSD_queuejob2 (int c, int *, const char *j, const char *d, struct attropl *a, char *ex);
 int PBSD_QueueJob_hash(int c, char *j, char *d, job_data_container *ja, job_data_container *ra, char *ex, char **job_id, char **msg);
 int PBSD_QueueJob2_hash(int c, const char *j, const char *d, job_data_container *ja, job_data_container *ra, const char *ex, char **job_id, char **msg);
+int PBSD_SubmitJob_hash(int c, const char *d, job_data_container *ja, job_data_container *ra, const char *script, const char *ex, char **job_id, char **msg);
+int PBSD_SubmitJobs_hash(int c, const char *d, job_data_container *ja, job_data_container *ra, const char *script, int count, job_data_container **jo, job_data_container **ro, char **job_ids, int *job_rcs, char **msg);
+
+/* most jobs sent in one SubmitJobs request */
+#define PBS_MAX_SUBMIT_BATCH 1024
 
 
 extern int decode_DIS_JobId (struct tcp_chan *chan, char *jobid);
@@ -338,6 +343,8 @@ extern int encode_DIS_MoveJob (struct tcp_chan *chan, char *jid, char *dest);
 extern int encode_DIS_MessageJob (struct tcp_chan *chan, char *jid, int fopt, char *m);
 extern int encode_DIS_QueueJob (struct tcp_chan *chan, const char *jid, const char *dest, struct attropl *);
 int encode_DIS_QueueJob_hash(struct tcp_chan *chan, char *jid, char *destin, job_data_container *job_attr, job_data_container *res_attr);
+int encode_DIS_SubmitJob_hash(struct tcp_chan *chan, char *destin, job_data_container *job_attr, job_data_container *res_attr, char *script, size_t script_len);
+int encode_DIS_SubmitJobs_hash(struct tcp_chan *chan, char *destin, job_data_container *job_attr, job_data_container *res_attr, char *script, size_t script_len, int count, job_data_container **job_overrides, job_data_container **res_overrides);
 extern int encode_DIS_ReqExtend (struct tcp_chan *chan, char *extend);
 extern int encode_DIS_PowerState (struct tcp_chan *chan, unsigned short power_state);
 extern int encode_DIS_ReqHdr (struct tcp_chan *chan, int reqt, char *user);
@@ -349,6 +356,7 @@ extern int encode_DIS_Status (struct tcp_chan *chan, char *objid, struct attrl *
 extern int encode_DIS_attrl (struct tcp_chan *chan, struct attrl *);
 extern int encode_DIS_attropl (struct tcp_chan *chan, struct attropl *);
 int encode_DIS_attropl_hash(struct tcp_chan *chan, job_data_container *job_attr, job_data_container *res_attr);
+int encode_DIS_attropl_hash_single(struct tcp_chan *chan, job_data_container *attrs, int is_res);
 
 extern int DIS_reply_read (struct tcp_chan *chan, struct batch_reply *preply);
 #endif /* LIBPBS_H */
@@ -33,8 +33,20 @@ extern const int THREAD_INT;
 
 using namespace std;
 
+/* Relative NUMA distances in the ACPI SLIT scale (local access is 10). These are used
+ * for placement costs when hwloc doesn't report a distance matrix. */
+#define LOCAL_NUMA_DISTANCE  10
+#define SOCKET_NUMA_DISTANCE 16
+#define REMOTE_NUMA_DISTANCE 21
+
+/* Cost added per chip for each unrequested accelerator type a placement would sit on */
+#define ACCELERATOR_LOCALITY_COST 0.5
+
+typedef std::vector<std::vector<int> > numa_distance_matrix;
+
 int get_hardware_style(hwloc_topology_t topology);
 int get_machine_total_memory(hwloc_topology_t topology, hwloc_uint64_t *memory);
+int numa_distance(const numa_distance_matrix &distances, int from, int to, bool same_socket);
 
 
 class PCI_Device 
@@ -222,6 +234,7 @@ class Chip
     bool reserve_chip_thread(int core_index, allocation &a);
     bool reserve_place_thread(int core_index, allocation &a);
     bool reserve_chip_place_thread(int core_index, allocation &a);
+    float placement_cost(const req &r, int tasks) const;
   };
 
 
@@ -273,7 +286,7 @@ class Socket
     void place_all_execution_slots(req &r, allocation &task_alloc);
     bool spread_place(req &r, allocation &master, int execution_slots_per, int &remainder, bool chips);
     bool spread_place_pu(req &r, allocation &task_alloc, int &cores, int &lprocs, int &gpus, int &mics);
-    int  place_task(req &r, allocation &a, int to_place, const char *hostname);
+    int  place_task(req &r, allocation &a, int to_place, const char *hostname, bool lowest_cost = false);
     bool free_task(const char *jobid);
     bool is_available() const;
     bool is_completely_free() const;
@@ -283,6 +296,9 @@ class Socket
     void update_internal_counts(vector<allocation> &allocs);
     int  get_gpus_remaining();
     int  get_mics_remaining();
+    void get_chip_ids(std::vector<int> &ids) const;
+    int  lowest_cost_chip(const req &r, int place_type, int tasks) const;
+    float placement_cost(const req &r, int place_type, int tasks, const numa_distance_matrix &distances) const;
   };
 
 
@@ -305,6 +321,8 @@ class Machine
   std::vector<Socket> sockets;
   std::vector<PCI_Device> NVIDIA_device;
   vector<allocation>  allocations;
+  numa_distance_matrix numa_distances; /* indexed by chip id, empty if unknown */
+  bool                topology_aware; /* place using the lowest cost socket and chip */
 #ifdef NVIDIA_GPUS
   #ifdef NVML_API
   hwloc_obj_t get_non_nvml_device(hwloc_topology_t topology, nvmlDevice_t device);
@@ -360,6 +378,14 @@ class Machine
     bool check_if_possible(int &sockets, int &numa_nodes, int &cores, int &threads) const;
     bool is_initialized() const;
     void reinitialize_from_json(const std::string &json_layout, std::vector<std::string> &valid_ids);
+    void initialize_numa_distances(hwloc_topology_t topology);
+    void initialize_numa_distances(const Json::Value &distances);
+    void set_topology_aware(bool aware);
+    bool is_topology_aware() const;
+    int  get_numa_distance(int from_chip, int to_chip) const;
+    int  get_socket_distance(int from_socket, int to_socket) const;
+    int  lowest_cost_socket(const req &r, int place_type, int tasks) const;
+    void order_sockets_by_distance(const req &r, int place_type, std::vector<int> &order) const;
   };
 
 extern Machine this_node;
@@ -93,16 +93,31 @@
 #define CHECK_POLL_TIME             45
 #define MAX_JOIN_WAIT_TIME          600
 #define RESEND_WAIT_TIME            300
+#define DEFAULT_COPY_THREADS        4
+#define MAX_COPY_THREADS            64
+#define JOB_RADIX_AUTO              0   /* $job_launch_radix: pick one from the node count */
+#define JOB_RADIX_FLAT              -1  /* $job_launch_radix: contact every sister directly */
+#define MIN_AUTO_RADIX_NODES        16
+#define MIN_AUTO_JOB_RADIX          4
+#define MAX_AUTO_JOB_RADIX          64
 
 
 
 extern bool             thread_unlink_calls;
+extern bool             record_job_trace;
 extern int              ignwalltime;
 extern int              ignmem;
 extern int              igncput;
 extern int              ignvmem;
 extern int              spoolasfinalname;
 extern int              maxupdatesbeforesending;
+extern int              copy_threads;
+extern int              copy_node_threads;
+extern long             copy_bandwidth;
+extern long             copy_node_bandwidth;
+extern bool             copy_fsync;
+extern int              job_launch_radix;
+extern bool             status_snapshot;
 extern char            *apbasil_path;
 extern char            *apbasil_protocol;
 extern int              reject_job_submit;
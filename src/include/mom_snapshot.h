@@ -0,0 +1,92 @@
+#ifndef MOM_SNAPSHOT_H
+#define MOM_SNAPSHOT_H
+#include "license_pbs.h" /* See here for the software license */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * mom_snapshot.h - pbs_mom's shared status snapshot
+ *
+ * After each poll of its jobs pbs_mom rewrites mom_priv/status_snapshot, a
+ * memory-mapped file holding the node's state and the last polled usage of
+ * every job it has. Local monitoring agents map the file read-only and copy a
+ * consistent view out of it with mom_snapshot_read(), without a round trip
+ * to the MOM.
+ *
+ * The file is a mom_snapshot_header followed by ms_job_capacity entries, the
+ * first ms_job_count of which are in use. ms_sequence is odd while the MOM is
+ * writing; readers copy what they need and start over if it changed. Later
+ * versions only add fields at the end of either structure, so readers find
+ * the entries with ms_header_size and ms_job_size. The file only grows while
+ * the MOM runs, so a reader's mapping stays valid.
+ */
+
+#define MOM_SNAPSHOT_MAGIC      0x504d5353  /* "PMSS" */
+#define MOM_SNAPSHOT_VERSION    1
+#define MOM_SNAPSHOT_FILE       "status_snapshot"  /* in mom_priv */
+#define MOM_SNAPSHOT_MIN_JOBS   64    /* entries a new file has room for */
+#define MOM_SNAPSHOT_RETRIES    1000  /* copies mom_snapshot_read() tries while the MOM writes */
+#define MOM_SNAPSHOT_HOST_LEN   256
+#define MOM_SNAPSHOT_JOBID_LEN  256
+#define MOM_SNAPSHOT_USER_LEN   64
+
+typedef struct mom_snapshot_header
+  {
+  uint32_t          ms_magic;
+  uint32_t          ms_version;
+  uint32_t          ms_header_size;   /* sizeof(mom_snapshot_header) when written */
+  uint32_t          ms_job_size;      /* sizeof(mom_snapshot_job) when written */
+  volatile uint64_t ms_sequence;      /* odd while an update is in progress */
+  int64_t           ms_updated;       /* when the MOM last rewrote the snapshot */
+  int64_t           ms_started;       /* when the MOM started publishing */
+  int32_t           ms_mom_pid;
+  int32_t           ms_state;         /* INUSE_* bits the MOM reports for the node */
+  int32_t           ms_ncpus;
+  uint32_t          ms_job_capacity;
+  uint32_t          ms_job_count;
+  uint32_t          ms_polls;         /* updates since the MOM started */
+  double            ms_loadave;
+  char              ms_host[MOM_SNAPSHOT_HOST_LEN];
+  } mom_snapshot_header;
+
+typedef struct mom_snapshot_job
+  {
+  char     mj_jobid[MOM_SNAPSHOT_JOBID_LEN];
+  char     mj_owner[MOM_SNAPSHOT_USER_LEN];
+  int32_t  mj_state;                  /* JOB_STATE_* */
+  int32_t  mj_substate;               /* JOB_SUBSTATE_* */
+  int32_t  mj_mother_superior;        /* 1 if usage is polled here, 0 on a sister */
+  int32_t  mj_nodes;
+  int32_t  mj_tasks;
+  int32_t  mj_session;                /* session of the first task, 0 before it starts */
+  int64_t  mj_start_time;
+  uint64_t mj_cput;                   /* seconds */
+  uint64_t mj_walltime;               /* seconds */
+  uint64_t mj_mem;                    /* kb */
+  uint64_t mj_vmem;                   /* kb */
+  } mom_snapshot_job;
+
+typedef struct mom_snapshot_map
+  {
+  int                  sm_fd;
+  size_t               sm_len;
+  bool                 sm_writable;
+  mom_snapshot_header *sm_header;
+  } mom_snapshot_map;
+
+/* used by pbs_mom */
+int               mom_snapshot_create(const char *path, mom_snapshot_map *map);
+int               mom_snapshot_reserve(mom_snapshot_map *map, uint32_t jobs);
+void              mom_snapshot_begin(mom_snapshot_map *map);
+void              mom_snapshot_end(mom_snapshot_map *map);
+mom_snapshot_job *mom_snapshot_job_at(mom_snapshot_map *map, uint32_t index);
+
+/* used by readers */
+int               mom_snapshot_attach(const char *path, mom_snapshot_map *map);
+int               mom_snapshot_read(mom_snapshot_map *map, mom_snapshot_header *header,
+                                    mom_snapshot_job *jobs, uint32_t max_jobs);
+
+void              mom_snapshot_detach(mom_snapshot_map *map);
+
+#endif /* MOM_SNAPSHOT_H */
@@ -24,4 +24,5 @@ extern const char *JOBID;
 extern const char *CPUS;
 extern const char *EXCLUSIVE;
 extern const char *OS_INDEX;
+extern const char *DISTANCES;
 
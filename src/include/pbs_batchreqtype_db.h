@@ -83,5 +83,8 @@ PbsBatchReqType(PBS_BATCH_DeleteReservation,    "DeleteAlpsReservation")
 PbsBatchReqType(PBS_BATCH_SelStatAttr,          "SelStatAttr")
 PbsBatchReqType(PBS_BATCH_ChangePowerState,     "ChangePowerState")
 PbsBatchReqType(PBS_BATCH_ModifyNode,           "ModifyNode")
+PbsBatchReqType(PBS_BATCH_JobObitBatch,         "JobObituaryBatch")
+PbsBatchReqType(PBS_BATCH_SubmitJob,            "SubmitJob")
+PbsBatchReqType(PBS_BATCH_SubmitJobs,           "SubmitJobs")
 #endif
 #endif /* _PBS_BATCHREQTYPE_DB_H */
@@ -383,6 +383,15 @@
 #define ATTR_user_kill_delay           "user_kill_delay"
 #define ATTR_idle_slot_limit           "idle_slot_limit"
 #define ATTR_default_gpu_mode          "default_gpu_mode"
+#define ATTR_sched_min_interval        "scheduler_min_interval"
+#define ATTR_topology_aware_placement  "topology_aware_placement"
+#define ATTR_record_job_trace          "record_job_trace"
+#define ATTR_record_job_usage          "record_job_usage"
+#define ATTR_compact_completed_jobs    "compact_completed_jobs"
+#define ATTR_spill_completed_jobs      "spill_completed_jobs"
+#define ATTR_record_job_history        "record_job_history"
+#define ATTR_job_history_days          "job_history_days"
+#define ATTR_combined_submit           "combined_submit"
 #define ATTR_copy_on_rerun             "copy_on_rerun"
 #define ATTR_job_exclusive_on_use      "job_exclusive_on_use"
 #define ATTR_disable_automatic_requeue "disable_automatic_requeue"
@@ -421,6 +430,7 @@
 #define DELASYNC     "delasync"   /* see req_delete.c */
 #define PURGECOMP    "purgecomplete="   /* see req_delete.c */
 #define EXECQUEONLY  "exec_queue_only"   /* see req_stat.c */
+#define JOBHISTORY   "history"   /* see req_stat.c */
 #define RERUNFORCE   "force"
 
 #define USER_HOLD   "u"
@@ -708,6 +718,10 @@ char *pbs_submit(int connect, struct attropl *attrib, char *script, char *destin
 
 int pbs_submit_hash_ext(int connect, void *job_attr, void *res_attr, char *script, char *destination, char *extend, char **job_id, char **msg);
 
+int pbs_submitjob_hash_ext(int connect, void *job_attr, void *res_attr, char *script, char *destination, char *extend, char **job_id, char **msg);
+
+int pbs_submitjobs_hash_ext(int connect, void *job_attr, void *res_attr, char *script, char *destination, int count, void **job_overrides, void **res_overrides, char **job_ids, int *job_rcs, char **msg);
+
 int pbs_terminate(int connect, int manner, char *extend);
 
 int totpool(int connect, int update);
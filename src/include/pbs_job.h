@@ -939,8 +939,9 @@ class obitent
   {
   public:
   fwdevent oe_info; /* who gets the event */
+  bool     oe_batch; /* oe_info.fe_event names a tm_obit_multi batch */
 
-  obitent() : oe_info() {}
+  obitent() : oe_info(), oe_batch(false) {}
   };
 
 /*
@@ -1061,7 +1062,12 @@ typedef struct job_file_delete_info
 #define IM_FENCE          15
 #define IM_CONNECT        16
 #define IM_DISCONNECT     17
-#define IM_MAX            18
+#define IM_SPAWN_TASKS    18
+#define IM_OBIT_TASKS     19
+#define IM_FENCE_RELEASE  20
+#define IM_DMODEX_REQ     21
+#define IM_DMODEX_DATA    22
+#define IM_MAX            23
 
 #define IM_ERROR          99
 
@@ -8,6 +8,7 @@
 #include <string>
 #include <list>
 #include <set>
+#include <vector>
 #include <netinet/in.h>
 
 #include <pmix_server.h>
@@ -26,6 +27,9 @@ class pmix_operation
   std::string            data; // fence only
   std::set<std::string>  hosts_reported;
   std::set<std::string>  hosts_to_report;
+  std::string            parent; // fence only, empty at the root of the fence tree
+  std::set<std::string>  children; // fence only
+  bool                   joined; // fence only, false until the local fence request arrives
   std::set<int>          local_ranks; // connect only
   std::set<int>          all_ranks; // connect only
   pmix_modex_cbfunc_t    to_call_fence;
@@ -50,6 +54,13 @@ class pmix_operation
   pmix_operation              &operator =(const pmix_operation &other);
   bool                         operator ==(const pmix_operation &other) const;
   bool                         mark_reported(const std::string &hostname);
+  void                         absorb(const pmix_operation &early);
+  void                         build_fence_tree(job *pjob, const pmix_proc_t procs[], size_t nprocs);
+  const std::string           &get_parent() const;
+  const std::set<std::string> &get_children() const;
+  const std::string           &get_data() const;
+  void                         set_data(const std::string &all_data);
+  bool                         has_joined() const;
   const std::set<std::string> &get_hosts_reported() const;
   bool                         safe_insert_rank(job *pjob, int rank);
   void                         add_data(const std::string &additional);
@@ -71,12 +82,37 @@ class pmix_operation
 // jobid, fence operation object
 extern std::map<std::string, pmix_operation> pending_fences;
 
+// jobid, rank, modex data fetched from the rank's host
+extern std::map<std::string, std::map<int, std::string> > modex_cache;
+
+// a local direct modex request waiting for data from another host
+class dmodex_waiter
+  {
+  public:
+  pmix_modex_cbfunc_t  cbfunc;
+  void                *cbdata;
+
+  dmodex_waiter(pmix_modex_cbfunc_t f, void *d) : cbfunc(f), cbdata(d) {}
+  };
+
+// jobid, rank, requests waiting on the fetch already in flight for that rank
+extern std::map<std::string, std::map<int, std::vector<dmodex_waiter> > > dmodex_waiting;
+
 // operation id, connection operation object
 extern std::map<unsigned int, pmix_operation> existing_connections;
 
 int  matches_existing_connection(const pmix_proc_t procs[], size_t nprocs);
 int  clean_up_connection(job *pjob, struct sockaddr_in *source_addr, unsigned int op_id, bool ms);
 void check_and_act_on_obit(job *pjob, int rank);
+int  fence_tree_parent(int index, int radix);
+void fence_tree_children(int index, int count, int radix, std::vector<int> &kids);
+void pass_modex_data(pmix_modex_cbfunc_t cbfunc, void *cbdata, pmix_status_t status,
+                     const std::string &modex);
+void record_fence_contribution(job *pjob, const char *host, const std::string &data);
+void release_fence(job *pjob, const std::string &all_data);
+void serve_modex_request(job *pjob, const char *requestor, int rank);
+void deliver_modex(job *pjob, int rank, int status, const std::string &data);
+void forget_pmix_job(const char *jobid);
 
 #endif
 #endif
@@ -288,8 +288,10 @@ void disconnect_from_server();
   "acl_user_enable - enables user level access control\n" \
   "acl_users - list of users allowed/denied access to server\n" \
   "comment - informational text string about the server\n" \
+  "compact_completed_jobs - when true keep completed jobs as compact read-only status records instead of full jobs\n" \
   "default_queue - default queue used when a queue is not specified\n" \
   "gres_modifiers - list of users granted permission to modify their own running jobs' gres resource\n" \
+  "job_history_days - number of days of finished jobs kept by record_job_history\n" \
   "log_events - a bit string which specfiies what is logged\n"
 
 #define HELP_SERVERPUBLIC2 \
@@ -302,13 +304,19 @@ void disconnect_from_server();
   "query_other_jobs - when true users can query jobs owned by other users\n"
 
 #define HELP_SERVERPUBLIC3 \
+  "record_job_history - when true record finished jobs in server_priv/job_history for qstat -H\n" \
+  "record_job_trace - when true record job lifecycle events in binary YYYYMMDD.trace files in server_logs\n" \
+  "record_job_usage - when true also write binary usage records for job ends next to the accounting files\n" \
   "resources_available - amount of resources which are available to the server\n" \
   "resources_cost - the cost factors of resources.  Used for sync. job starting\n" \
   "resources_default - the default resource value when the job does not specify\n" \
   "resource_max - the maximum amount of resources that are on the system\n" \
   "scheduler_iteration - the amount of seconds between timed scheduler iterations\n" \
+  "scheduler_min_interval - the minimum amount of seconds between event triggered scheduler iterations\n" \
   "scheduling - when true the server should tell the scheduler to run\n" \
+  "spill_completed_jobs - when true keep compacted completed jobs in a memory-mapped file in server_priv\n" \
   "system_cost - arbitrary value factored into resource costs\n" \
+  "topology_aware_placement - when true place job tasks on the sockets and numa nodes with the lowest NUMA distance cost\n" \
   "use_jobs_subdirs - when true divide storage of jobs into subdirectories in $PBS_HOME/server_priv/{jobs,arrays}\n" \
    
 #define HELP_SERVERRO \
@@ -319,6 +327,7 @@ void disconnect_from_server();
   "state_count - total number of jobs in each state\n" \
   "total_jobs - total number of jobs managed by the server\n" \
   "pbs_version - the release version of PBS\n" \
+  "combined_submit - true if the server accepts a job in a single SubmitJob request\n" \
    
 #define HELP_QUEUEPUBLIC \
   "Queue Public Attributes:\n" \
@@ -204,3 +204,11 @@ ATTR_ghost_array_recovery,
 ATTR_cgroup_per_task,
 ATTR_idle_slot_limit,
 ATTR_default_gpu_mode,
+ATTR_sched_min_interval,
+ATTR_topology_aware_placement,
+ATTR_record_job_trace,
+ATTR_record_job_usage,
+ATTR_compact_completed_jobs,
+ATTR_spill_completed_jobs,
+ATTR_record_job_history,
+ATTR_job_history_days,
@@ -87,6 +87,7 @@
 #include "server_limits.h" /* PBS_NUMJOBSTATE */
 #include "attribute.h" /* attribute_def, pbs_attribute */
 #include "user_info.h"
+#include "job_rank_index.hpp"
 
 #define INITIAL_QUEUE_SIZE 5
 
@@ -196,6 +197,8 @@ typedef struct pbs_queue
 #ifndef PBS_MOM
   all_jobs *qu_jobs;  /* jobs in this queue */
   all_jobs *qu_jobs_array_sum; /* jobs with job arrays summarized */
+  job_rank_index *qu_jobs_ranks; /* qu_jobs by queue rank */
+  job_rank_index *qu_jobs_array_sum_ranks; /* qu_jobs_array_sum by queue rank */
 #else
   tlist_head       qu_jobs;  /* jobs in this queue */
   tlist_head       qu_jobs_array_sum; /* jobs with job arrays summarized */
@@ -266,7 +269,6 @@ void garbage_collect_recycling();
 
 pbs_queue *find_queuebyname(const char *quename);
 pbs_queue *que_alloc(const char *name, int sv_qs_mutex_held);
-int   count_user_queued_jobs(pbs_queue *,char *);
 int   svr_chkque(job *, pbs_queue *, char *, int, char *);
 int   default_router(job *, pbs_queue *, long);
 int   site_alt_router(job *, pbs_queue *, long);
@@ -229,6 +229,15 @@ enum srv_atr
   SRV_ATR_CgroupPerTask,
   SRV_ATR_IdleSlotLimit,
   SRV_ATR_DefaultGpuMode,
+  SRV_ATR_scheduler_min_interval,
+  SRV_ATR_TopologyAwarePlacement,
+  SRV_ATR_RecordJobTrace,
+  SRV_ATR_RecordJobUsage,
+  SRV_ATR_CompactCompletedJobs,
+  SRV_ATR_SpillCompletedJobs,
+  SRV_ATR_RecordJobHistory,
+  SRV_ATR_JobHistoryDays,
+  SRV_ATR_CombinedSubmit,
 
   /* This must be last */
   SRV_ATR_LAST
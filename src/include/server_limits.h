@@ -122,6 +122,8 @@
                                      if log_file_max_size is set */
 #define PBS_ACCT_CHECK_RATE   60*60  /* check accounting files every hour
 																		 if accounting_keep_days is set */
+#define PBS_QUEUED_CT_CHECK_RATE 300 /* recount the per user queued jobs every 5 min
+                                       in debug builds */
 #define PBS_LOCKFILE_UPDATE_TIME 3   /* how often TORQUE updates HA lock file */
 #define PBS_LOCKFILE_CHECK_TIME  9   /* how often secondary TORQUE checks HA lock file */
 
@@ -0,0 +1,312 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#ifndef SLOT_BITSET_HPP
+#define SLOT_BITSET_HPP
+
+#include <vector>
+
+/*
+ * slot_bitset
+ *
+ * A growable bitset packed into machine words.  Searches skip whole words at a
+ * time using find-first-set and popcount, which makes it cheap to find free
+ * slots on nodes with hundreds of execution slots or processing units.
+ *
+ * Bits past size() are always kept clear.
+ */
+
+class slot_bitset
+  {
+  std::vector<unsigned long> words;
+  int                        bit_count;
+
+  static const int bits_per_word = sizeof(unsigned long) * 8;
+
+  static int word_index(int index)
+    {
+    return(index / bits_per_word);
+    }
+
+  static unsigned long bit_mask(int index)
+    {
+    return(1UL << (index % bits_per_word));
+    }
+
+  /* clears the unused bits of the last word */
+  void trim()
+    {
+    if (this->bit_count % bits_per_word != 0)
+      this->words[word_index(this->bit_count)] &= bit_mask(this->bit_count) - 1;
+    }
+
+  public:
+    slot_bitset() : words(), bit_count(0) {}
+
+    slot_bitset(int size) : words(), bit_count(0)
+      {
+      this->resize(size);
+      }
+
+    bool operator ==(const slot_bitset &other) const
+      {
+      return((this->bit_count == other.bit_count) &&
+             (this->words == other.words));
+      }
+
+    int size() const
+      {
+      return(this->bit_count);
+      }
+
+    /* grows or shrinks the set; new bits are clear */
+    void resize(int size)
+      {
+      if (size < 0)
+        size = 0;
+
+      this->words.resize((size + bits_per_word - 1) / bits_per_word, 0);
+      this->bit_count = size;
+      this->trim();
+      }
+
+    void push_back(bool value)
+      {
+      this->resize(this->bit_count + 1);
+
+      if (value == true)
+        this->set(this->bit_count - 1);
+      }
+
+    void pop_back()
+      {
+      if (this->bit_count > 0)
+        this->resize(this->bit_count - 1);
+      }
+
+    bool test(int index) const
+      {
+      if ((index < 0) ||
+          (index >= this->bit_count))
+        return(false);
+
+      return((this->words[word_index(index)] & bit_mask(index)) != 0);
+      }
+
+    void set(int index)
+      {
+      if ((index >= 0) &&
+          (index < this->bit_count))
+        this->words[word_index(index)] |= bit_mask(index);
+      }
+
+    void reset(int index)
+      {
+      if ((index >= 0) &&
+          (index < this->bit_count))
+        this->words[word_index(index)] &= ~bit_mask(index);
+      }
+
+    /* the number of set bits */
+    int count() const
+      {
+      int total = 0;
+
+      for (size_t i = 0; i < this->words.size(); i++)
+        total += __builtin_popcountl(this->words[i]);
+
+      return(total);
+      }
+
+    /* the index of the first set bit at or after from, or -1 */
+    int find_next_set(int from) const
+      {
+      if (from < 0)
+        from = 0;
+
+      if (from >= this->bit_count)
+        return(-1);
+
+      int           w = word_index(from);
+      unsigned long word = this->words[w] & ~(bit_mask(from) - 1);
+
+      while (word == 0)
+        {
+        if (++w >= (int)this->words.size())
+          return(-1);
+
+        word = this->words[w];
+        }
+
+      return(w * bits_per_word + __builtin_ctzl(word));
+      }
+
+    /* the index of the first clear bit at or after from, or -1 */
+    int find_next_clear(int from) const
+      {
+      if (from < 0)
+        from = 0;
+
+      if (from >= this->bit_count)
+        return(-1);
+
+      int           w = word_index(from);
+      unsigned long word = ~this->words[w] & ~(bit_mask(from) - 1);
+
+      while (word == 0)
+        {
+        if (++w >= (int)this->words.size())
+          return(-1);
+
+        word = ~this->words[w];
+        }
+
+      int index = w * bits_per_word + __builtin_ctzl(word);
+
+      if (index >= this->bit_count)
+        return(-1);
+
+      return(index);
+      }
+
+    /* the index of the last set bit, or -1 */
+    int find_last_set() const
+      {
+      for (int w = (int)this->words.size() - 1; w >= 0; w--)
+        {
+        if (this->words[w] != 0)
+          return(w * bits_per_word + bits_per_word - 1 - __builtin_clzl(this->words[w]));
+        }
+
+      return(-1);
+      }
+
+    /*
+     * the index of the first run of at least length consecutive clear bits
+     * starting at or after from, or -1 if there is no such run
+     */
+    int find_clear_run(int length, int from) const
+      {
+      int start = this->find_next_clear(from);
+
+      while (start != -1)
+        {
+        int end = this->find_next_set(start);
+
+        if (end == -1)
+          end = this->bit_count;
+
+        if (end - start >= length)
+          return(start);
+
+        start = this->find_next_clear(end);
+        }
+
+      return(-1);
+      }
+
+    /* clears every bit that is set in other */
+    void subtract(const slot_bitset &other)
+      {
+      size_t limit = this->words.size();
+
+      if (other.words.size() < limit)
+        limit = other.words.size();
+
+      for (size_t i = 0; i < limit; i++)
+        this->words[i] &= ~other.words[i];
+      }
+
+    /* sets every bit that is set in other */
+    void merge(const slot_bitset &other)
+      {
+      size_t limit = this->words.size();
+
+      if (other.words.size() < limit)
+        limit = other.words.size();
+
+      for (size_t i = 0; i < limit; i++)
+        this->words[i] |= other.words[i];
+
+      /* other may be longer than this */
+      this->trim();
+      }
+  };
+
+#endif /* SLOT_BITSET_HPP */
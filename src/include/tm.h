@@ -78,6 +78,19 @@ int tm_obit(tm_task_id tid,
             int  *obitval,
             tm_event_t *event);
 
+int tm_spawn_multi(int   argc,
+                   char  *argv[],
+                   char  *envp[],
+                   int   count,
+                   tm_node_id *where,
+                   tm_task_id *tids,
+                   tm_event_t *event);
+
+int tm_obit_multi(int   count,
+                  tm_task_id *tids,
+                  int  *obitvals,
+                  tm_event_t *event);
+
 int tm_nodeinfo(tm_node_id **list,
                 int  *nnodes);
 
@@ -175,6 +175,16 @@ typedef unsigned int tm_task_id;
 #define TM_ADOPT_ALTID    113    /* tm_adopt request with alternative management system task id */
 #define TM_ADOPT_JOBID    114     /* tm_adopt with jobid */
 
+/*
+ * Batched requests.  One tm_spawn_multi request starts a task on each
+ * listed node and one tm_obit_multi event reports when all of the
+ * listed tasks have exited, so a launcher starting thousands of ranks
+ * does not need a round trip per rank.
+ */
+
+#define TM_SPAWN_MULTI    115    /* tm_spawn_multi request */
+#define TM_OBIT_MULTI     116    /* tm_obit_multi request */
+
 /*
  * Timeout parameter for tm_poll()
  */
@@ -82,6 +82,7 @@
 
 #include <pthread.h>
 #include <string>
+#include <map>
 #include "container.hpp"
 #include "pbs_job.h"
 
@@ -107,5 +108,7 @@ int          decrement_queued_jobs(user_info_holder *uih, char *user_name, job *
 unsigned int get_num_queued(user_info_holder *uih, const char *user_name);
 void         free_user_info_holder(user_info_holder *uih);
 void         remove_server_suffix(std::string &user_name);
+unsigned int count_jobs_submitted(job *pjob);
+int          reconcile_queued_jobs(user_info_holder *uih, std::map<std::string, unsigned int> &counted);
 
 #endif /* ifndef USER_INFO_H */
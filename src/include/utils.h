@@ -208,6 +208,7 @@ int put_env_var(const char *, const char *);
 int rmdir_ext(const char *dir, int retry_limit = 20);
 int unlink_ext(const char *filename, int retry_limit = 20);
 int mkdir_wrapper(const char *pathname, mode_t mode);
+int open_ext(const char *path, int flags, mode_t mode);
 
 #endif /* END #ifndef UTILS_H */
  
@@ -78,10 +78,12 @@
 */
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <string>
 #include "portability.h"
 #include "libpbs.h"
 #include "dis.h"
@@ -898,6 +900,324 @@ int PBSD_QueueJob2_hash(
 
 
 
+/*
+ * read_job_script() - read the whole job script into script
+ */
+
+static int read_job_script(
+
+  const char  *script_file,
+  std::string &script)
+
+  {
+  int  fd;
+  int  cc;
+  char s_buf[SCRIPT_CHUNK_Z];
+
+  if ((fd = open(script_file, O_RDONLY, 0)) < 0)
+    return(-1);
+
+  while ((cc = read_ac_socket(fd, s_buf, SCRIPT_CHUNK_Z)) > 0)
+    script.append(s_buf, cc);
+
+  close(fd);
+
+  return((cc < 0) ? -1 : PBSE_NONE);
+  }  /* END read_job_script() */
+
+
+
+
+/* PBSD_SubmitJob_hash
+
+ This function queues, sends the script for and commits a job in a
+ single SubmitJob request. script_file may be NULL or empty.
+*/
+
+int PBSD_SubmitJob_hash(
+
+  int                 connect,     /* I */
+  const char         *destin,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  const char         *script_file,
+  const char         *extend,
+  char              **job_id,
+  char              **msg)
+
+  {
+  struct batch_reply *reply;
+  int                 rc = PBSE_NONE;
+  int                 sock;
+  std::string         script;
+  struct tcp_chan    *chan = NULL;
+  
+  if ((connect < 0) || 
+      (connect >= PBS_NET_MAX_CONNECTIONS))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  if ((script_file != NULL) &&
+      (*script_file != '\0') &&
+      (read_job_script(script_file, script) != PBSE_NONE))
+    {
+    return(PBSE_BADSCRIPT);
+    }
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  sock = connection[connect].ch_socket;
+  connection[connect].ch_errno = 0;
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    return(PBSE_PROTOCOL);
+    }
+  else if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_SubmitJob, pbs_current_user)) ||
+           (rc = encode_DIS_SubmitJob_hash(chan, const_cast<char *>(destin), job_attr, res_attr, const_cast<char *>(script.c_str()), script.size())) ||
+           (rc = encode_DIS_ReqExtend(chan, const_cast<char *>(extend))))
+    {
+    pthread_mutex_lock(connection[connect].ch_mutex);
+    if (connection[connect].ch_errtxt == NULL)
+      {
+      if ((rc >= 0) &&
+          (rc <= DIS_INVALID))
+        connection[connect].ch_errtxt = strdup(dis_emsg[rc]);
+      }
+
+    if (connection[connect].ch_errtxt != NULL)  
+      *msg = strdup(connection[connect].ch_errtxt);
+
+    pthread_mutex_unlock(connection[connect].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+
+  if ((rc = DIS_tcp_wflush(chan)))
+    {
+    pthread_mutex_lock(connection[connect].ch_mutex);
+    if (connection[connect].ch_errtxt != NULL)
+      {
+      *msg = strdup(connection[connect].ch_errtxt);
+      }
+    pthread_mutex_unlock(connection[connect].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+    
+  DIS_tcp_cleanup(chan);
+
+  /* read reply from stream into presentation element */
+  reply = PBSD_rdrpy(&rc, connect);
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  if (reply == NULL)
+    {
+    if (rc == PBSE_TIMEOUT)
+      rc = PBSE_EXPIRED;
+    }
+  else if (reply->brp_choice &&
+           reply->brp_choice != BATCH_REPLY_CHOICE_Text &&
+           reply->brp_choice != BATCH_REPLY_CHOICE_Queue)
+    {
+    rc = PBSE_PROTOCOL;
+    }
+  else if (reply->brp_choice == BATCH_REPLY_CHOICE_Text)
+    {
+    *msg = strdup(reply->brp_un.brp_txt.brp_str);
+    }
+  else if (connection[connect].ch_errno == 0)
+    {
+    *job_id = strdup(reply->brp_un.brp_jid);
+    }
+    
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  PBSD_FreeReply(reply);
+
+  return(rc);
+  }  /* END PBSD_SubmitJob_hash() */
+
+
+
+
+/*
+ * read_submitjobs_reply() - pick each job's result out of a SubmitJobs reply
+ *
+ * The reply has a "code jobid" line for each job, in the order they were sent.
+ */
+
+static int read_submitjobs_reply(
+
+  const char  *text,
+  int          count,
+  char       **job_ids,
+  int         *job_rcs)
+
+  {
+  int         i;
+  char       *end;
+  const char *ptr = text;
+  
+  for (i = 0; i < count; i++)
+    {
+    if (ptr == NULL)
+      return(PBSE_PROTOCOL);
+
+    job_rcs[i] = strtol(ptr, &end, 10);
+
+    if ((end == ptr) ||
+        (*end != ' '))
+      return(PBSE_PROTOCOL);
+
+    ptr = end + 1;
+
+    if (job_rcs[i] == PBSE_NONE)
+      job_ids[i] = strndup(ptr, strcspn(ptr, "\n"));
+
+    if ((ptr = strchr(ptr, '\n')) != NULL)
+      ptr++;
+    }
+
+  return(PBSE_NONE);
+  }  /* END read_submitjobs_reply() */
+
+
+
+
+/* PBSD_SubmitJobs_hash
+
+ This function queues, sends the script for and commits count jobs
+ in a single SubmitJobs request. Each job's id, or the reason it was
+ rejected, is returned in job_ids and job_rcs.
+*/
+
+int PBSD_SubmitJobs_hash(
+
+  int                  connect,     /* I */
+  const char          *destin,
+  job_data_container  *job_attr,
+  job_data_container  *res_attr,
+  const char          *script_file,
+  int                  count,
+  job_data_container **job_overrides,
+  job_data_container **res_overrides,
+  char               **job_ids,     /* O */
+  int                 *job_rcs,     /* O */
+  char               **msg)
+
+  {
+  struct batch_reply *reply;
+  int                 rc = PBSE_NONE;
+  int                 sock;
+  std::string         script;
+  struct tcp_chan    *chan = NULL;
+  
+  if ((connect < 0) || 
+      (connect >= PBS_NET_MAX_CONNECTIONS) ||
+      (count <= 0) ||
+      (count > PBS_MAX_SUBMIT_BATCH))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  if ((script_file != NULL) &&
+      (*script_file != '\0') &&
+      (read_job_script(script_file, script) != PBSE_NONE))
+    {
+    return(PBSE_BADSCRIPT);
+    }
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  sock = connection[connect].ch_socket;
+  connection[connect].ch_errno = 0;
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    return(PBSE_PROTOCOL);
+    }
+  else if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_SubmitJobs, pbs_current_user)) ||
+           (rc = encode_DIS_SubmitJobs_hash(chan, const_cast<char *>(destin), job_attr, res_attr,
+                   const_cast<char *>(script.c_str()), script.size(), count, job_overrides, res_overrides)) ||
+           (rc = encode_DIS_ReqExtend(chan, NULL)))
+    {
+    pthread_mutex_lock(connection[connect].ch_mutex);
+    if (connection[connect].ch_errtxt == NULL)
+      {
+      if ((rc >= 0) &&
+          (rc <= DIS_INVALID))
+        connection[connect].ch_errtxt = strdup(dis_emsg[rc]);
+      }
+
+    if (connection[connect].ch_errtxt != NULL)  
+      *msg = strdup(connection[connect].ch_errtxt);
+
+    pthread_mutex_unlock(connection[connect].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+
+  if ((rc = DIS_tcp_wflush(chan)))
+    {
+    pthread_mutex_lock(connection[connect].ch_mutex);
+    if (connection[connect].ch_errtxt != NULL)
+      {
+      *msg = strdup(connection[connect].ch_errtxt);
+      }
+    pthread_mutex_unlock(connection[connect].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+    
+  DIS_tcp_cleanup(chan);
+
+  /* read reply from stream into presentation element */
+  reply = PBSD_rdrpy(&rc, connect);
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  if (reply == NULL)
+    {
+    if (rc == PBSE_TIMEOUT)
+      rc = PBSE_EXPIRED;
+    }
+  else if (reply->brp_code != PBSE_NONE)
+    {
+    rc = reply->brp_code;
+
+    if ((reply->brp_choice == BATCH_REPLY_CHOICE_Text) &&
+        (reply->brp_un.brp_txt.brp_str != NULL))
+      *msg = strdup(reply->brp_un.brp_txt.brp_str);
+    }
+  else if ((reply->brp_choice != BATCH_REPLY_CHOICE_Text) ||
+           (reply->brp_un.brp_txt.brp_str == NULL))
+    {
+    rc = PBSE_PROTOCOL;
+    }
+  else
+    {
+    rc = read_submitjobs_reply(reply->brp_un.brp_txt.brp_str, count, job_ids, job_rcs);
+    }
+    
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  PBSD_FreeReply(reply);
+
+  return(rc);
+  }  /* END PBSD_SubmitJobs_hash() */
+
+
+
+
 int PBSD_QueueJob_hash(
 
   int                connect,     /* I */
@@ -135,6 +135,73 @@ int decode_DIS_JobObit(
   }  /* END decode_DIS_JobObit() */
 
 
+
+
+/*
+ * decode_DIS_JobObitBatch() - decode a batch of Job Obituary notices
+ *
+ * This request is used by the server ONLY.
+ * The batch request structure must already exist; the entries are
+ * allocated here and released by free_br().
+ *
+ * Data items are: unsigned int count
+ *   then count times:
+ *   string  job id
+ *   signed int status
+ *   list of  svrattrl
+ */
+
+int decode_DIS_JobObitBatch(
+
+  struct tcp_chan      *chan,
+  struct batch_request *preq)  /* O */
+
+  {
+  int                      rc;
+  int                      i;
+  unsigned int             count;
+  struct rq_jobobit_batch *pbatch = &preq->rq_ind.rq_jobobit_batch;
+
+  pbatch->rq_count = 0;
+  pbatch->rq_obits = NULL;
+
+  count = disrui(chan, &rc);
+
+  if (rc != 0)
+    return(rc);
+
+  if ((count == 0) ||
+      (count > PBS_MAX_OBIT_BATCH))
+    return(DIS_PROTO);
+
+  if ((pbatch->rq_obits = (struct rq_jobobit *)calloc(count, sizeof(struct rq_jobobit))) == NULL)
+    return(DIS_NOMALLOC);
+
+  for (i = 0; i < (int)count; i++)
+    CLEAR_HEAD(pbatch->rq_obits[i].rq_attr);
+
+  pbatch->rq_count = count;
+
+  for (i = 0; i < (int)count; i++)
+    {
+    struct rq_jobobit *pobit = &pbatch->rq_obits[i];
+
+    if ((rc = disrfst(chan, PBS_MAXSVRJOBID, pobit->rq_jid)) != 0)
+      return(rc);
+
+    pobit->rq_status = disrsi(chan, &rc);
+
+    if (rc != 0)
+      return(rc);
+
+    if ((rc = decode_DIS_svrattrl(chan, &pobit->rq_attr)) != 0)
+      return(rc);
+    }
+
+  return(0);
+  }  /* END decode_DIS_JobObitBatch() */
+
+
 /* END dec_JobObit.c */
 
 
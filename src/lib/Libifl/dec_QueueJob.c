@@ -128,4 +128,110 @@ int decode_DIS_QueueJob(
 
 
 
+/*
+ * decode_DIS_SubmitJob() - decode a Submit Job Batch Request
+ *
+ * Data items are: the Queue Job items, see decode_DIS_QueueJob()
+ *   unsigned int credential type
+ *   counted string the credential
+ *   counted string the job script
+ */
+
+int decode_DIS_SubmitJob(
+
+  struct tcp_chan      *chan,
+  struct batch_request *preq)
+
+  {
+  int                  rc;
+  size_t               size;
+  struct rq_submitjob *psubmit = &preq->rq_ind.rq_submitjob;
+
+  psubmit->rq_cred.rq_data = NULL;
+  psubmit->rq_cred.rq_size = 0;
+  psubmit->rq_script = NULL;
+  psubmit->rq_script_size = 0;
+
+  /* fills in psubmit->rq_job */
+  if ((rc = decode_DIS_QueueJob(chan, preq)) != 0)
+    return(rc);
+
+  psubmit->rq_cred.rq_type = disrui(chan, &rc);
+
+  if (rc != 0)
+    return(rc);
+
+  psubmit->rq_cred.rq_data = disrcs(chan, &size, &rc);
+  psubmit->rq_cred.rq_size = size;
+
+  if (rc != 0)
+    return(rc);
+
+  psubmit->rq_script = disrcs(chan, &size, &rc);
+  psubmit->rq_script_size = size;
+
+  return(rc);
+  }  /* END decode_DIS_SubmitJob() */
+
+
+
+
+/*
+ * decode_DIS_SubmitJobs() - decode a Submit Jobs Batch Request
+ *
+ * The per job lists are allocated here and released by free_br().
+ *
+ * Data items are: the Submit Job items, see decode_DIS_SubmitJob()
+ *   unsigned int count
+ *   then count times:
+ *   list of attributes (svrattrl)
+ */
+
+int decode_DIS_SubmitJobs(
+
+  struct tcp_chan      *chan,
+  struct batch_request *preq)
+
+  {
+  int                   rc;
+  int                   i;
+  unsigned int          count;
+  struct rq_submitjobs *psubmits = &preq->rq_ind.rq_submitjobs;
+
+  psubmits->rq_count = 0;
+  psubmits->rq_overrides = NULL;
+
+  /* fills in psubmits->rq_template */
+  if ((rc = decode_DIS_SubmitJob(chan, preq)) != 0)
+    return(rc);
+
+  count = disrui(chan, &rc);
+
+  if (rc != 0)
+    return(rc);
+
+  if ((count == 0) ||
+      (count > PBS_MAX_SUBMIT_BATCH))
+    return(DIS_PROTO);
+
+  if ((psubmits->rq_overrides = (tlist_head *)calloc(count, sizeof(tlist_head))) == NULL)
+    return(DIS_NOMALLOC);
+
+  for (i = 0; i < (int)count; i++)
+    CLEAR_HEAD(psubmits->rq_overrides[i]);
+
+  psubmits->rq_count = count;
+
+  for (i = 0; i < (int)count; i++)
+    {
+    if ((rc = decode_DIS_svrattrl(chan, &psubmits->rq_overrides[i])) != 0)
+      return(rc);
+    }
+
+  return(PBSE_NONE);
+  }  /* END decode_DIS_SubmitJobs() */
+
+
+
+
 
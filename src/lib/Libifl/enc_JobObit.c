@@ -126,3 +126,46 @@ int encode_DIS_JobObit(
 
 
 
+/*
+ * encode_DIS_JobObitBatch() - encode a batch of Job Obituary notices
+ *
+ * Data items are: unsigned int count
+ *   then count times:
+ *   string  job id
+ *   signed int status
+ *   list of  svrattrl
+ */
+
+int encode_DIS_JobObitBatch(
+
+  struct tcp_chan      *chan,  /* I */
+  struct batch_request *preq)  /* I */
+
+  {
+  int                      rc;
+  int                      i;
+  struct rq_jobobit_batch *pbatch = &preq->rq_ind.rq_jobobit_batch;
+
+  if ((rc = diswui(chan, pbatch->rq_count)) != 0)
+    return(rc);
+
+  for (i = 0; i < pbatch->rq_count; i++)
+    {
+    struct rq_jobobit *pobit = &pbatch->rq_obits[i];
+
+    if (((rc = diswst(chan, pobit->rq_jid)) != 0) ||
+        ((rc = diswsi(chan, pobit->rq_status)) != 0) ||
+        ((rc = encode_DIS_svrattrl(chan, (svrattrl *)GET_NEXT(pobit->rq_attr))) != 0))
+      {
+      /* FAILURE */
+
+      return(rc);
+      }
+    }
+
+  return(0);
+  }  /* END encode_DIS_JobObitBatch() */
+
+
+
+
@@ -128,3 +128,96 @@ int encode_DIS_QueueJob_hash(
 
 
 
+
+
+
+
+/*
+ * encode_DIS_SubmitJob_hash() - encode a Submit Job Batch Request
+ *
+ * This request carries everything the QueueJob, JobCredential, JobScript
+ * and Commit requests would, so the job is queued in one round trip.
+ *
+ * Data items are: the Queue Job items, see encode_DIS_QueueJob_hash()
+ *   the Job Credential items, see encode_DIS_JobCred()
+ *   counted string the job script (empty if there is none)
+ */
+
+int encode_DIS_SubmitJob_hash(
+
+  struct tcp_chan    *chan,
+  char               *destin,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char               *script,
+  size_t              script_len)
+
+  {
+  int   rc;
+
+  if (script == NULL)
+    {
+    script = (char *)"";
+    script_len = 0;
+    }
+
+  if ((rc = encode_DIS_QueueJob_hash(chan, (char *)"", destin, job_attr, res_attr)) ||
+      (rc = encode_DIS_JobCred(chan, 0, (char *)"", 0)) ||
+      (rc = diswcs(chan, script, script_len)))
+    {
+    return(rc);
+    }
+
+  return(PBSE_NONE);
+  }  /* END encode_DIS_SubmitJob_hash() */
+
+
+
+
+/*
+ * encode_DIS_SubmitJobs_hash() - encode a Submit Jobs Batch Request
+ *
+ * Every job is built from the shared attributes and script, with its own
+ * attributes replacing the shared ones of the same name. A job's
+ * Variable_List is added to the shared one instead.
+ *
+ * Data items are: the Submit Job items, see encode_DIS_SubmitJob_hash()
+ *   unsigned int count
+ *   then count times:
+ *   list of attributes, see encode_DIS_attropl_hash_single()
+ */
+
+int encode_DIS_SubmitJobs_hash(
+
+  struct tcp_chan     *chan,
+  char                *destin,
+  job_data_container  *job_attr,
+  job_data_container  *res_attr,
+  char                *script,
+  size_t               script_len,
+  int                  count,
+  job_data_container **job_overrides,
+  job_data_container **res_overrides)
+
+  {
+  int   rc;
+  int   i;
+
+  if ((rc = encode_DIS_SubmitJob_hash(chan, destin, job_attr, res_attr, script, script_len)) ||
+      (rc = diswui(chan, count)))
+    {
+    return(rc);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+    if ((rc = diswui(chan, hash_count(job_overrides[i]) + hash_count(res_overrides[i]))) ||
+        (rc = encode_DIS_attropl_hash_single(chan, job_overrides[i], 0)) ||
+        (rc = encode_DIS_attropl_hash_single(chan, res_overrides[i], 1)))
+      {
+      return(rc);
+      }
+    }
+
+  return(PBSE_NONE);
+  }  /* END encode_DIS_SubmitJobs_hash() */
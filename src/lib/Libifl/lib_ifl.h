@@ -79,6 +79,27 @@ int pbs_submit_hash(
   char              *extend,  /* (optional) */
   char              **return_jobid,
   char              **msg);
+int pbs_submitjob_hash(
+  int                socket,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char              *script,
+  char              *destination,
+  char              *extend,  /* (optional) */
+  char              **return_jobid,
+  char              **msg);
+int pbs_submitjobs_hash(
+  int                 socket,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char               *script,
+  char               *destination,
+  int                 count,
+  job_data_container **job_overrides,
+  job_data_container **res_overrides,
+  char              **job_ids,
+  int                *job_rcs,
+  char              **msg);
 /* static int PBSD_scbuf(int c, int reqtype, int seq, char *buf, int len, char *jobid, enum job_file which);  */
 int PBSD_jscript(int c, const char *script_file, const char *jobid);
 int PBSD_jobfile(int c, int req_type, char *path, char *jobid, enum job_file which);
@@ -114,6 +135,7 @@ int decode_DIS_JobId(struct tcp_chan *chan, char *jobid);
 
 /* dec_JobObit.c */
 int decode_DIS_JobObit(struct tcp_chan *chan, struct batch_request *preq); 
+int decode_DIS_JobObitBatch(struct tcp_chan *chan, struct batch_request *preq); 
 
 /* dec_Manage.c */
 int decode_DIS_Manage(struct tcp_chan *chan, struct batch_request *preq);
@@ -126,6 +148,8 @@ int decode_DIS_MessageJob(struct tcp_chan *chan, struct batch_request *preq);
 
 /* dec_QueueJob.c */
 int decode_DIS_QueueJob(struct tcp_chan *chan, struct batch_request *preq);
+int decode_DIS_SubmitJob(struct tcp_chan *chan, struct batch_request *preq);
+int decode_DIS_SubmitJobs(struct tcp_chan *chan, struct batch_request *preq);
 
 /* dec_Reg.c */
 int decode_DIS_Register(struct tcp_chan *chan, struct batch_request *preq);
@@ -189,6 +213,7 @@ int encode_DIS_JobId(struct tcp_chan *chan, char *jobid);
 
 /* enc_JobObit.c */
 int encode_DIS_JobObit(struct tcp_chan *chan, struct batch_request *preq); 
+int encode_DIS_JobObitBatch(struct tcp_chan *chan, struct batch_request *preq); 
 
 /* enc_Manage.c */
 int encode_DIS_Manage(struct tcp_chan *chan, int command, int objtype, const char *objname, struct attropl *aoplp);
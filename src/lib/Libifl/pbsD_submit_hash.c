@@ -189,4 +189,170 @@ int pbs_submit_hash_ext(
       script,destination,extend,return_jobid,msg);
   }
 
+
+
+
+/*
+ * pbs_submitjob_hash() - submit a job in a single SubmitJob request
+ *
+ * Takes the same arguments as pbs_submit_hash(). A server that predates
+ * the SubmitJob request closes the connection without replying, so only
+ * send it to a server that reports combined_submit as true, and use
+ * pbs_submit_hash() otherwise.
+ */
+
+int pbs_submitjob_hash(
+
+  int                socket,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char              *script,
+  char              *destination,
+  char              *extend,  /* (optional) */
+  char              **return_jobid,
+  char              **msg)
+
+  {
+  int rc;
+
+  if ((socket < 0) || 
+      (socket >= PBS_NET_MAX_CONNECTIONS))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  if ((script != NULL) &&
+      (*script != '\0') &&
+      (access(script, R_OK) != 0))
+    {
+    return(PBSE_BADSCRIPT);
+    }
+
+  rc = PBSD_SubmitJob_hash(socket, destination, job_attr, res_attr, script, extend, return_jobid, msg);
+
+  if ((rc != PBSE_NONE) &&
+      (*msg == NULL) &&
+      (connection[socket].ch_errtxt != NULL))
+    {
+    *msg = strdup(connection[socket].ch_errtxt);
+    }
+
+  return(rc);
+  }  /* END pbs_submitjob_hash() */
+
+int pbs_submitjob_hash_ext(
+  int                socket,
+  void               *job_attr,
+  void              *res_attr,
+  char              *script,
+  char              *destination,
+  char              *extend,  /* (optional) */
+  char              **return_jobid,
+  char              **msg)
+  {
+  return pbs_submitjob_hash(socket,
+      (job_data_container *)job_attr,
+      (job_data_container *)res_attr,
+      script,destination,extend,return_jobid,msg);
+  }
+
+
+
+
+/*
+ * pbs_submitjobs_hash() - submit many jobs sharing one set of attributes and one script
+ *
+ * Job i is built from job_attr and res_attr with job_overrides[i] and
+ * res_overrides[i] applied. The jobs go to the server PBS_MAX_SUBMIT_BATCH
+ * at a time. job_ids[i] gets job i's id, or job_rcs[i] the reason it was
+ * rejected. Like pbs_submitjob_hash(), only send it to a server that
+ * reports combined_submit as true.
+ */
+
+int pbs_submitjobs_hash(
+
+  int                  socket,
+  job_data_container  *job_attr,
+  job_data_container  *res_attr,
+  char                *script,
+  char                *destination,
+  int                  count,
+  job_data_container **job_overrides,
+  job_data_container **res_overrides,
+  char               **job_ids,  /* O */
+  int                 *job_rcs,  /* O */
+  char               **msg)
+
+  {
+  int rc = PBSE_NONE;
+  int first;
+  int chunk;
+
+  if ((socket < 0) || 
+      (socket >= PBS_NET_MAX_CONNECTIONS) ||
+      (count <= 0))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  if ((script != NULL) &&
+      (*script != '\0') &&
+      (access(script, R_OK) != 0))
+    {
+    return(PBSE_BADSCRIPT);
+    }
+
+  for (first = 0; first < count; first += chunk)
+    {
+    job_data_container template_attr;
+
+    chunk = count - first;
+
+    if (chunk > PBS_MAX_SUBMIT_BATCH)
+      chunk = PBS_MAX_SUBMIT_BATCH;
+
+    /* encoding consumes the variable list, so send a copy each time */
+    hash_add_hash(&template_attr, job_attr, TRUE);
+
+    rc = PBSD_SubmitJobs_hash(socket, destination, &template_attr, res_attr, script,
+           chunk, job_overrides + first, res_overrides + first, job_ids + first, job_rcs + first, msg);
+
+    hash_clear(&template_attr);
+
+    if (rc != PBSE_NONE)
+      break;
+    }
+
+  if ((rc != PBSE_NONE) &&
+      (*msg == NULL) &&
+      (connection[socket].ch_errtxt != NULL))
+    {
+    *msg = strdup(connection[socket].ch_errtxt);
+    }
+
+  return(rc);
+  }  /* END pbs_submitjobs_hash() */
+
+int pbs_submitjobs_hash_ext(
+  int                socket,
+  void               *job_attr,
+  void              *res_attr,
+  char              *script,
+  char              *destination,
+  int                count,
+  void              **job_overrides,
+  void              **res_overrides,
+  char              **job_ids,
+  int               *job_rcs,
+  char              **msg)
+  {
+  return pbs_submitjobs_hash(socket,
+      (job_data_container *)job_attr,
+      (job_data_container *)res_attr,
+      script,destination,count,
+      (job_data_container **)job_overrides,
+      (job_data_container **)res_overrides,
+      job_ids,job_rcs,msg);
+  }
+
 /* END pbsD_submit.c */
@@ -169,6 +169,18 @@ typedef struct event_info
 
 static event_info *event_hash[EVENT_HASH];
 
+/*
+** Saved with a tm_spawn_multi() or tm_obit_multi() event.  The reply
+** carries one value per task in the order they were requested.
+*/
+struct multihold
+  {
+  int         count;
+  tm_node_id *where;    /* node of each task */
+  tm_task_id *tids;     /* filled in for TM_SPAWN_MULTI */
+  int        *obitvals; /* filled in for TM_OBIT_MULTI */
+  };
+
 /*
  * check if the owner of this process matches the owner of pid
  *  returns TRUE if so, FALSE otherwise
@@ -256,6 +268,17 @@ void del_event(
       free(ep->e_info);
       break;
 
+    case TM_SPAWN_MULTI:
+
+    case TM_OBIT_MULTI:
+      {
+      struct multihold *mhold = (struct multihold *)ep->e_info;
+
+      free(mhold->where);
+      free(mhold);
+      }
+      break;
+
     default:
       TM_DBPRT(("del_event: unknown event command %d\n", ep->e_mtype))
       break;
@@ -913,6 +936,147 @@ tm_spawn_cleanup:
 
 
 
+/*
+** Starts <argv>[0] with environment <envp> once on each of the <count>
+** nodes in <where>, using a single request to MOM.  When the event is
+** returned by tm_poll(), tids[i] holds the task started on where[i], or
+** TM_NULL_TASK if that task could not be started.
+*/
+
+int tm_spawn_multi(
+
+  int          argc,   /* in  */
+  char       **argv,   /* in  */
+  char       **envp,   /* in  */
+  int          count,  /* in  */
+  tm_node_id  *where,  /* in  */
+  tm_task_id  *tids,   /* out */
+  tm_event_t  *event)  /* out */
+
+  {
+  int rc = TM_SUCCESS;
+  char *cp;
+  int   i;
+  struct tcp_chan *chan = NULL;
+  struct multihold *mhold;
+
+  if (!init_done)
+    {
+    return(TM_BADINIT);
+    }
+
+  if ((argc <= 0) || (argv == NULL) || (argv[0] == NULL) || (*argv[0] == '\0'))
+    {
+    return(TM_ENOTFOUND);
+    }
+
+  if ((count <= 0) || (where == NULL) || (tids == NULL))
+    {
+    return(TM_EBADENVIRONMENT);
+    }
+
+  if ((mhold = (struct multihold *)calloc(1, sizeof(struct multihold))) == NULL)
+    {
+    return(TM_ESYSTEM);
+    }
+
+  if ((mhold->where = (tm_node_id *)calloc(count, sizeof(tm_node_id))) == NULL)
+    {
+    free(mhold);
+    return(TM_ESYSTEM);
+    }
+
+  memcpy(mhold->where, where, count * sizeof(tm_node_id));
+  mhold->count = count;
+  mhold->tids = tids;
+
+  *event = new_event();
+
+  if (startcom(TM_SPAWN_MULTI, *event, &chan) != DIS_SUCCESS)
+    {
+    rc = TM_ENOTCONNECTED;
+    goto tm_spawn_multi_cleanup;
+    }
+
+  if (diswsi(chan, count) != DIS_SUCCESS)
+    {
+    rc = TM_ENOTCONNECTED;
+    goto tm_spawn_multi_cleanup;
+    }
+
+  for (i = 0;i < count;i++)
+    {
+    if (diswsi(chan, where[i]) != DIS_SUCCESS)
+      {
+      rc = TM_ENOTCONNECTED;
+      goto tm_spawn_multi_cleanup;
+      }
+    }
+
+  if (diswsi(chan, argc) != DIS_SUCCESS)
+    {
+    rc = TM_ENOTCONNECTED;
+    goto tm_spawn_multi_cleanup;
+    }
+
+  for (i = 0;i < argc;i++)
+    {
+    cp = argv[i];
+
+    if (diswcs(chan, cp, strlen(cp)) != DIS_SUCCESS)
+      {
+      rc = TM_ENOTCONNECTED;
+      goto tm_spawn_multi_cleanup;
+      }
+    }
+
+  if (getenv("PBSDEBUG") != NULL)
+    {
+    if (diswcs(chan, "PBSDEBUG=1", strlen("PBSDEBUG=1")) != DIS_SUCCESS)
+      {
+      rc = TM_ENOTCONNECTED;
+      goto tm_spawn_multi_cleanup;
+      }
+    }
+
+  if (envp != NULL)
+    {
+    for (i = 0;(cp = envp[i]) != NULL;i++)
+      {
+      if (diswcs(chan, cp, strlen(cp)) != DIS_SUCCESS)
+        {
+        rc = TM_ENOTCONNECTED;
+        goto tm_spawn_multi_cleanup;
+        }
+      }
+    }
+
+  if (diswcs(chan, "", 0) != DIS_SUCCESS)
+    {
+    rc = TM_ENOTCONNECTED;
+    goto tm_spawn_multi_cleanup;
+    }
+
+  DIS_tcp_wflush(chan);
+
+  add_event(*event, where[0], TM_SPAWN_MULTI, (void *)mhold);
+  mhold = NULL;
+
+tm_spawn_multi_cleanup:
+  if (chan != NULL)
+    DIS_tcp_cleanup(chan);
+
+  if (mhold != NULL)
+    {
+    free(mhold->where);
+    free(mhold);
+    }
+
+  return(rc);
+  }  /* END tm_spawn_multi() */
+
+
+
 
 /*
 ** Sends a <sig> signal to all the process groups in the task
@@ -1034,6 +1198,101 @@ tm_obit_cleanup:
   return rc;
   }
 
+
+/*
+** Returns one event that is reported once every task in <tids> has
+** exited.  obitvals[i] will contain the exit value of tids[i], or -1
+** if MOM could not find the task.
+*/
+int tm_obit_multi(
+
+  int         count,    /* in  */
+  tm_task_id *tids,     /* in  */
+  int        *obitvals, /* out */
+  tm_event_t *event)    /* out */
+
+  {
+  int rc = TM_SUCCESS;
+  int i;
+  task_info *tp;
+  struct tcp_chan *chan = NULL;
+  struct multihold *mhold = NULL;
+
+  if (!init_done)
+    {
+    rc = TM_BADINIT;
+    goto tm_obit_multi_cleanup;
+    }
+
+  if ((count <= 0) || (tids == NULL) || (obitvals == NULL))
+    {
+    rc = TM_EBADENVIRONMENT;
+    goto tm_obit_multi_cleanup;
+    }
+
+  if (((mhold = (struct multihold *)calloc(1, sizeof(struct multihold))) == NULL) ||
+      ((mhold->where = (tm_node_id *)calloc(count, sizeof(tm_node_id))) == NULL))
+    {
+    rc = TM_ESYSTEM;
+    goto tm_obit_multi_cleanup;
+    }
+
+  for (i = 0;i < count;i++)
+    {
+    if ((tp = find_task(tids[i])) == NULL)
+      {
+      rc = TM_ENOTFOUND;
+      goto tm_obit_multi_cleanup;
+      }
+
+    mhold->where[i] = tp->t_node;
+    }
+
+  mhold->count = count;
+  mhold->obitvals = obitvals;
+
+  *event = new_event();
+
+  if (startcom(TM_OBIT_MULTI, *event, &chan) != DIS_SUCCESS)
+    {
+    rc = TM_ESYSTEM;
+    goto tm_obit_multi_cleanup;
+    }
+
+  if (diswsi(chan, count) != DIS_SUCCESS)
+    {
+    rc = TM_ESYSTEM;
+    goto tm_obit_multi_cleanup;
+    }
+
+  for (i = 0;i < count;i++)
+    {
+    if ((diswsi(chan, mhold->where[i]) != DIS_SUCCESS) ||
+        (diswsi(chan, tids[i]) != DIS_SUCCESS))
+      {
+      rc = TM_ESYSTEM;
+      goto tm_obit_multi_cleanup;
+      }
+    }
+
+  DIS_tcp_wflush(chan);
+
+  add_event(*event, mhold->where[0], TM_OBIT_MULTI, (void *)mhold);
+  mhold = NULL;
+
+tm_obit_multi_cleanup:
+  if (chan != NULL)
+    DIS_tcp_cleanup(chan);
+
+  if (mhold != NULL)
+    {
+    free(mhold->where);
+    free(mhold);
+    }
+
+  return rc;
+  }
+
 struct taskhold
   {
   tm_task_id *list;
@@ -1457,6 +1716,8 @@ int tm_poll(
   struct infohold *ihold;
 
   struct reschold *rhold;
+
+  struct multihold *mhold;
   extern time_t pbs_tcp_timeout;
 
   if (!init_done)
@@ -1721,6 +1982,46 @@ int tm_poll(
       *tidp = new_task(tm_jobid, ep->e_node, tid);
       break;
 
+    case TM_SPAWN_MULTI:
+
+    case TM_OBIT_MULTI:
+      /*
+      ** auxiliary info (
+      **  count int;
+      **  task id or exit value int;
+      **  ...
+      ** )
+      */
+      mhold = (struct multihold *)ep->e_info;
+      num = disrsi(static_chan, &ret);
+
+      if ((ret != DIS_SUCCESS) ||
+          (num != mhold->count))
+        {
+        TM_DBPRT(("%s: MULTI failed count\n", __func__))
+        goto tm_poll_error;
+        }
+
+      for (i = 0;i < num;i++)
+        {
+        tid = disrsi(static_chan, &ret);
+
+        if (ret != DIS_SUCCESS)
+          {
+          TM_DBPRT(("%s: MULTI failed value %d\n", __func__, i))
+          goto tm_poll_error;
+          }
+
+        if (ep->e_mtype == TM_OBIT_MULTI)
+          mhold->obitvals[i] = (int)tid;
+        else if (tid == TM_NULL_TASK)
+          mhold->tids[i] = TM_NULL_TASK;
+        else
+          mhold->tids[i] = new_task(tm_jobid, mhold->where[i], tid);
+        }
+
+      break;
+
     case TM_SIGNAL:
       break;
 
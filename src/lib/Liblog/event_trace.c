@@ -0,0 +1,536 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+/*
+ * event_trace.c - binary job event trace, see event_trace.h
+ *
+ * Functions included are:
+ * trace_open()
+ * trace_close()
+ * trace_flush()
+ * trace_event()
+ * trace_elapsed()
+ * trace_job_hash()
+ * trace_job_num()
+ * trace_event_name()
+ * trace_event_from_name()
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "event_trace.h"
+#include "pbs_error.h"
+#include "utils.h"
+
+#ifndef TRUE
+#define TRUE  1
+#define FALSE 0
+#endif
+
+static pthread_mutex_t  trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t   trace_once = PTHREAD_ONCE_INIT;
+static volatile int     trace_opened = FALSE;
+static int              trace_fd = -1;
+static int              trace_open_day = -1;
+static int              trace_source_id = TRACE_SOURCE_SERVER;
+static char             trace_directory[_POSIX_PATH_MAX];
+static trace_record     trace_buf[TRACE_BUFFER_RECORDS];
+static int              trace_count = 0;
+
+/* the order of these names MUST match enum trace_event_type */
+static const char *trace_event_names[] =
+  {
+  "header",
+  "queued",
+  "run",
+  "obit",
+  "requeue",
+  "complete",
+  "deleted",
+  "start",
+  "exit"
+  };
+
+
+
+/*
+ * trace_open_file - opens YYYYMMDD.trace for the current day, writing the
+ * header record if the file is new
+ *
+ * The caller must hold trace_mutex.
+ */
+
+static int trace_open_file(void)
+
+  {
+  char         path[sizeof(trace_directory) + 64]; /* the directory, any three ints and the suffix */
+  time_t       now = time(NULL);
+  struct tm    tm;
+  struct stat  sb;
+  int          fd;
+
+  localtime_r(&now, &tm);
+
+  snprintf(path, sizeof(path), "%s/%04d%02d%02d%s",
+    trace_directory,
+    tm.tm_year + 1900,
+    tm.tm_mon + 1,
+    tm.tm_mday,
+    TRACE_FILE_SUFFIX);
+
+  if ((fd = open_ext(path, O_CREAT | O_WRONLY | O_APPEND, 0644)) < 0)
+    return(-1);
+
+  if ((fstat(fd, &sb) == 0) &&
+      (sb.st_size == 0))
+    {
+    trace_record header;
+
+    memset(&header, 0, sizeof(header));
+    header.tr_time = (uint64_t)now * 1000000;
+    header.tr_event = TRACE_FILE_HEADER;
+    header.tr_source = trace_source_id;
+    header.tr_job_hash = TRACE_MAGIC;
+    header.tr_job_num = sizeof(trace_record);
+    header.tr_value = TRACE_VERSION;
+
+    if (write(fd, &header, sizeof(header)) != sizeof(header))
+      {
+      close(fd);
+      return(-1);
+      }
+    }
+
+  trace_fd = fd;
+  trace_open_day = tm.tm_yday;
+
+  return(PBSE_NONE);
+  }  /* END trace_open_file() */
+
+
+
+/*
+ * trace_write_buffer - writes the buffered records, switching files at midnight
+ *
+ * The caller must hold trace_mutex.
+ */
+
+static void trace_write_buffer(void)
+
+  {
+  time_t     now;
+  struct tm  tm;
+  char      *ptr = (char *)trace_buf;
+  size_t     remaining = trace_count * sizeof(trace_record);
+
+  if (trace_count == 0)
+    return;
+
+  trace_count = 0;
+
+  now = time(NULL);
+  localtime_r(&now, &tm);
+
+  if ((trace_fd < 0) ||
+      (tm.tm_yday != trace_open_day))
+    {
+    if (trace_fd >= 0)
+      {
+      close(trace_fd);
+      trace_fd = -1;
+      }
+
+    /* the trace is best effort, the records are lost if the file can't be opened */
+    if (trace_open_file() != PBSE_NONE)
+      return;
+    }
+
+  while (remaining > 0)
+    {
+    ssize_t written = write(trace_fd, ptr, remaining);
+
+    if (written < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      break;
+      }
+
+    ptr += written;
+    remaining -= written;
+    }
+  }  /* END trace_write_buffer() */
+
+
+
+/*
+ * fork handlers - children never write the parent's buffered records
+ */
+
+static void trace_prepare(void)
+
+  {
+  pthread_mutex_lock(&trace_mutex);
+  }
+
+static void trace_parent(void)
+
+  {
+  pthread_mutex_unlock(&trace_mutex);
+  }
+
+static void trace_child(void)
+
+  {
+  trace_opened = FALSE;
+  trace_count = 0;
+
+  if (trace_fd >= 0)
+    {
+    close(trace_fd);
+    trace_fd = -1;
+    }
+
+  pthread_mutex_unlock(&trace_mutex);
+  }
+
+
+
+static void trace_init(void)
+
+  {
+  pthread_atfork(trace_prepare, trace_parent, trace_child);
+  atexit(trace_close);
+  }  /* END trace_init() */
+
+
+
+/*
+ * trace_open - start tracing job events to directory
+ *
+ * @param directory - the directory for the YYYYMMDD.trace files
+ * @param source - TRACE_SOURCE_SERVER or TRACE_SOURCE_MOM
+ * @return PBSE_NONE if the trace file could be opened, -1 otherwise
+ */
+
+int trace_open(
+
+  const char *directory,
+  int         source)
+
+  {
+  int rc;
+
+  if (directory == NULL)
+    return(-1);
+
+  pthread_once(&trace_once, trace_init);
+
+  pthread_mutex_lock(&trace_mutex);
+
+  if (trace_fd >= 0)
+    {
+    trace_write_buffer();
+    close(trace_fd);
+    trace_fd = -1;
+    }
+
+  snprintf(trace_directory, sizeof(trace_directory), "%s", directory);
+  trace_source_id = source;
+
+  if ((rc = trace_open_file()) == PBSE_NONE)
+    trace_opened = TRUE;
+
+  pthread_mutex_unlock(&trace_mutex);
+
+  return(rc);
+  }  /* END trace_open() */
+
+
+
+/*
+ * trace_close - writes the buffered records and stops tracing
+ */
+
+void trace_close(void)
+
+  {
+  pthread_mutex_lock(&trace_mutex);
+
+  trace_opened = FALSE;
+
+  if (trace_fd >= 0)
+    {
+    trace_write_buffer();
+    close(trace_fd);
+    trace_fd = -1;
+    }
+
+  trace_count = 0;
+
+  pthread_mutex_unlock(&trace_mutex);
+  }  /* END trace_close() */
+
+
+
+/*
+ * trace_flush - writes the buffered records
+ */
+
+void trace_flush(void)
+
+  {
+  if (trace_opened == FALSE)
+    return;
+
+  pthread_mutex_lock(&trace_mutex);
+  trace_write_buffer();
+  pthread_mutex_unlock(&trace_mutex);
+  }  /* END trace_flush() */
+
+
+
+bool trace_is_open(void)
+
+  {
+  return(trace_opened == TRUE);
+  }
+
+
+
+/*
+ * trace_event - buffer a record of a job event
+ *
+ * Does nothing unless trace_open() has been called. The buffer is written
+ * when it is full or holds a record older than TRACE_FLUSH_INTERVAL.
+ *
+ * @param event - the trace_event_type
+ * @param job_id - the full job id
+ * @param duration - usecs, see trace_event_type
+ * @param value - see trace_event_type
+ */
+
+void trace_event(
+
+  int         event,
+  const char *job_id,
+  uint64_t    duration,
+  int         value)
+
+  {
+  trace_record   *rec;
+  struct timeval  now;
+  uint32_t        hash;
+  uint32_t        num;
+
+  if ((trace_opened == FALSE) ||
+      (job_id == NULL))
+    return;
+
+  gettimeofday(&now, NULL);
+  hash = trace_job_hash(job_id);
+  num = trace_job_num(job_id);
+
+  pthread_mutex_lock(&trace_mutex);
+
+  if (trace_opened == FALSE)
+    {
+    pthread_mutex_unlock(&trace_mutex);
+    return;
+    }
+
+  rec = &trace_buf[trace_count++];
+  rec->tr_time = (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
+  rec->tr_duration = duration;
+  rec->tr_job_hash = hash;
+  rec->tr_job_num = num;
+  rec->tr_event = event;
+  rec->tr_source = trace_source_id;
+  rec->tr_value = value;
+
+  if ((trace_count == TRACE_BUFFER_RECORDS) ||
+      (rec->tr_time - trace_buf[0].tr_time >= (uint64_t)TRACE_FLUSH_INTERVAL * 1000000))
+    trace_write_buffer();
+
+  pthread_mutex_unlock(&trace_mutex);
+  }  /* END trace_event() */
+
+
+
+/*
+ * trace_elapsed - usecs from since until now, 0 if since is unset
+ */
+
+uint64_t trace_elapsed(
+
+  time_t since)
+
+  {
+  time_t now = time(NULL);
+
+  if ((since <= 0) ||
+      (since > now))
+    return(0);
+
+  return((uint64_t)(now - since) * 1000000);
+  }  /* END trace_elapsed() */
+
+
+
+/*
+ * trace_job_hash - 32 bit FNV-1a hash of a job id
+ */
+
+uint32_t trace_job_hash(
+
+  const char *job_id)
+
+  {
+  uint32_t hash = 2166136261U;
+
+  for (const unsigned char *ptr = (const unsigned char *)job_id; *ptr != '\0'; ptr++)
+    {
+    hash ^= *ptr;
+    hash *= 16777619U;
+    }
+
+  return(hash);
+  }  /* END trace_job_hash() */
+
+
+
+/*
+ * trace_job_num - the leading sequence number of a job id, 0 if there isn't one
+ */
+
+uint32_t trace_job_num(
+
+  const char *job_id)
+
+  {
+  return((uint32_t)strtoul(job_id, NULL, 10));
+  }  /* END trace_job_num() */
+
+
+
+const char *trace_event_name(
+
+  int event)
+
+  {
+  if ((event < 0) ||
+      (event >= TRACE_EVENT_COUNT))
+    return("unknown");
+
+  return(trace_event_names[event]);
+  }  /* END trace_event_name() */
+
+
+
+/*
+ * trace_event_from_name - the trace_event_type named name, -1 if there is none
+ */
+
+int trace_event_from_name(
+
+  const char *name)
+
+  {
+  for (int i = 0; i < TRACE_EVENT_COUNT; i++)
+    {
+    if (!strcasecmp(name, trace_event_names[i]))
+      return(i);
+    }
+
+  return(-1);
+  }  /* END trace_event_from_name() */
@@ -88,6 +88,9 @@
  * log_close()
  * log_roll()
  * log_size()
+ * log_async_start()
+ * log_async_stop()
+ * log_async_flush()
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -112,6 +115,8 @@
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
+#include <sys/uio.h>
+#include <signal.h>
 
 #include "log.h"
 #if SYSLOG
@@ -156,6 +161,54 @@ static volatile int  job_log_opened = 0;
 
 pthread_mutex_t job_log_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * asynchronous logging
+ *
+ * Once log_async_start() is called each thread formats its records into its own
+ * ring buffer without taking log_mutex, and a writer thread copies them to the
+ * log with writev(). Records carry a global sequence number so the writer can
+ * merge the rings back into the order they were logged. A thread whose ring is
+ * full empties the rings itself when log_mutex is free, otherwise it drops the
+ * record and counts it; the writer logs the count.
+ */
+
+#define LOG_RING_SIZE        65536  /* bytes of pending records per thread */
+#define LOG_RECORD_MAX       4096   /* larger records are written synchronously */
+#define LOG_WRITEV_BATCH     256    /* records per writev() */
+#define LOG_WRITER_INTERVAL  10000  /* usecs the writer waits between passes unless a ring fills */
+
+typedef struct log_ring_record
+  {
+  unsigned long seq;   /* order the record was logged in */
+  unsigned int  size;  /* bytes used in the ring, 0 marks a skip to the start */
+  unsigned int  len;   /* bytes of text following this header */
+  } log_ring_record;
+
+typedef struct log_ring
+  {
+  char                   buf[LOG_RING_SIZE];
+  volatile unsigned long head;      /* bytes written, only changed by the owning thread */
+  volatile unsigned long tail;      /* bytes consumed, only changed by the writer */
+  volatile unsigned long dropped;   /* records dropped because the ring was full */
+  unsigned long          reported;  /* dropped records already logged */
+  volatile int           orphaned;  /* the owning thread has exited */
+  pid_t                  thr_id;
+  time_t                 stamp_sec; /* the second stamp was formatted for */
+  char                   stamp[80]; /* cached "mm/dd/yyyy hh:mm:ss", room for any six ints */
+  struct log_ring       *next;
+  } log_ring;
+
+static pthread_mutex_t         log_writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t          log_writer_cond = PTHREAD_COND_INITIALIZER;
+static volatile int            log_async_active = FALSE;
+static volatile int            log_async_running = FALSE;
+static volatile unsigned long  log_seq = 0;
+static volatile unsigned long  log_total_dropped = 0;
+static log_ring               *log_rings = NULL; /* protected by log_mutex */
+static int                     log_draining = FALSE;
+static pthread_key_t           log_ring_key;
+static pthread_once_t          log_async_once = PTHREAD_ONCE_INIT;
+
 /*
  * the order of these names MUST match the defintions of
  * PBS_EVENTCLASS_* in log.h
@@ -178,6 +231,8 @@ static const char *class_names[] =
 
 /* local prototypes */
 const char *log_get_severity_string(int);
+static void log_record_sync(int, int, const char *, const char *);
+static void log_async_drain(void);
 
 
 /*
@@ -401,7 +456,7 @@ int log_open(
   else
     snprintf(buf2, sizeof(buf2), "Log opened");
 
-  log_record(
+  log_record_sync(
     PBSEVENT_SYSTEM,
     PBS_EVENTCLASS_SERVER,
     "Log",
@@ -749,16 +804,10 @@ bool log_available(int eventtype)
 
 
 /*
- * log_record - log a message to the log file
- * The log file must have been opened by log_open().
- *
- * NOTE:  do not use in pbs_mom spawned children - does not write to syslog!!!
- *
- * The caller should ensure proper formating of the message if "text"
- * is to contain "continuation lines".
+ * log_record_sync - format and write a message to the log file while holding log_mutex
  */
 
-void log_record(
+static void log_record_sync(
 
   int         eventtype,  /* I */
   int         objclass,   /* I */
@@ -766,7 +815,8 @@ void log_record(
   const char *text)       /* I */
 
   {
-  int tryagain = 2;
+  int tryagain;
+  int reopened = FALSE;
   time_t now;
   pid_t  thr_id = -1;
 
@@ -803,6 +853,10 @@ void log_record(
     return;
     }
 
+  /* keep the file in order with the records waiting in the rings */
+  if (log_async_active == TRUE)
+    log_async_drain();
+
   now = time((time_t *)0); /* get time for message */
 
   ptm = localtime_r(&now,&tmpPtm);
@@ -851,6 +905,9 @@ void log_record(
     if (*end == '\r' && *(end + 1) == '\n')
       end++;
 
+    /* every line gets written, but the log is only reopened once */
+    tryagain = (reopened == TRUE) ? 1 : 2;
+
     while (tryagain)
       {
       if (eventclass != PBS_EVENTCLASS_TRQAUTHD)
@@ -891,6 +948,7 @@ void log_record(
 
         log_opened = 0;
         log_open(NULL, log_directory);
+        reopened = TRUE;
         tryagain--;
         }
       else
@@ -932,6 +990,700 @@ void log_record(
   pthread_mutex_unlock(&log_mutex);
 
   return;
+  }  /* END log_record_sync() */
+
+
+
+/*
+ * log_ring_release - pthread key destructor, lets the writer free an exiting thread's ring
+ */
+
+static void log_ring_release(
+
+  void *ring)
+
+  {
+  ((log_ring *)ring)->orphaned = TRUE;
+  }  /* END log_ring_release() */
+
+
+
+/*
+ * log_async_child - fork handlers. Children don't have the writer thread, so
+ * they write their records synchronously. The pending records belong to the
+ * parent, which still writes them, so the child discards its copy of the rings.
+ * log_mutex is only held across the fork while the rings are being filled.
+ */
+
+static int log_fork_locked = FALSE;
+
+static void log_async_prepare(void)
+
+  {
+  if (log_async_active == TRUE)
+    {
+    pthread_mutex_lock(&log_mutex);
+    log_fork_locked = TRUE;
+    }
+  }
+
+static void log_async_parent(void)
+
+  {
+  if (log_fork_locked == TRUE)
+    {
+    log_fork_locked = FALSE;
+    pthread_mutex_unlock(&log_mutex);
+    }
+  }
+
+static void log_async_child(void)
+
+  {
+  log_ring *ring;
+
+  log_async_active = FALSE;
+  log_async_running = FALSE;
+
+  if (log_rings != NULL)
+    {
+    while ((ring = log_rings) != NULL)
+      {
+      log_rings = ring->next;
+      free(ring);
+      }
+
+    pthread_setspecific(log_ring_key, NULL);
+    }
+
+  log_draining = FALSE;
+
+  if (log_fork_locked == TRUE)
+    {
+    log_fork_locked = FALSE;
+    pthread_mutex_unlock(&log_mutex);
+    }
+  }
+
+
+
+static void log_async_init(void)
+
+  {
+  pthread_key_create(&log_ring_key, log_ring_release);
+  pthread_atfork(log_async_prepare, log_async_parent, log_async_child);
+  atexit(log_async_flush);
+  }  /* END log_async_init() */
+
+
+
+/*
+ * log_get_ring - returns the calling thread's ring, creating it if needed
+ */
+
+static log_ring *log_get_ring(void)
+
+  {
+  log_ring *ring = (log_ring *)pthread_getspecific(log_ring_key);
+
+  if (ring != NULL)
+    return(ring);
+
+  if ((ring = (log_ring *)calloc(1, sizeof(log_ring))) == NULL)
+    return(NULL);
+
+  ring->thr_id = syscall(SYS_gettid);
+  ring->stamp_sec = -1;
+
+  pthread_mutex_lock(&log_mutex);
+  ring->next = log_rings;
+  log_rings = ring;
+  pthread_mutex_unlock(&log_mutex);
+
+  pthread_setspecific(log_ring_key, ring);
+
+  return(ring);
+  }  /* END log_get_ring() */
+
+
+
+/*
+ * log_async_enqueue - format a record into the calling thread's ring
+ *
+ * @return PBSE_NONE if the record was queued or dropped, -1 if it must be
+ * written synchronously instead
+ */
+
+static int log_async_enqueue(
+
+  int         eventtype,
+  int         objclass,
+  const char *objname,
+  const char *text)
+
+  {
+  char             record[LOG_RECORD_MAX];
+  int              len = 0;
+  int              eventclass = 0;
+  const char      *start = text;
+  const char      *end;
+  struct timeval   now;
+  log_ring        *ring;
+  log_ring_record  hdr;
+  unsigned long    pos;
+  unsigned long    to_end;
+  unsigned long    skip = 0;
+  unsigned long    need;
+
+#if SYSLOG
+  if (eventtype & PBSEVENT_SYSLOG)
+    return(-1);
+#endif /* SYSLOG */
+
+  log_get_set_eventclass(&eventclass, GETV);
+
+  if ((eventclass == PBS_EVENTCLASS_TRQAUTHD) ||
+      (log_opened < 1) ||
+      ((ring = log_get_ring()) == NULL))
+    return(-1);
+
+  gettimeofday(&now, NULL);
+
+  /* localtime_r() is only needed once a second */
+  if (now.tv_sec != ring->stamp_sec)
+    {
+    struct tm tm;
+
+    localtime_r(&now.tv_sec, &tm);
+    snprintf(ring->stamp, sizeof(ring->stamp), "%02d/%02d/%04d %02d:%02d:%02d",
+      tm.tm_mon + 1,
+      tm.tm_mday,
+      tm.tm_year + 1900,
+      tm.tm_hour,
+      tm.tm_min,
+      tm.tm_sec);
+    ring->stamp_sec = now.tv_sec;
+    }
+
+  /* split the text on newlines the same way log_record_sync() does */
+  while (1)
+    {
+    int rc;
+
+    for (end = start; *end != '\n' && *end != '\r' && *end != '\0'; end++)
+      ;
+
+    rc = snprintf(record + len, sizeof(record) - len,
+      "%s.%03d;%02d;%10.10s.%d;%s;%s;%s%.*s\n",
+      ring->stamp,
+      (int)(now.tv_usec / 1000),
+      (eventtype & ~PBSEVENT_FORCE),
+      msg_daemonname,
+      ring->thr_id,
+      class_names[objclass],
+      objname,
+      (text == start ? "" : "[continued]"),
+      (int)(end - start),
+      start);
+
+    if ((rc < 0) ||
+        (rc >= (int)sizeof(record) - len))
+      return(-1);
+
+    len += rc;
+
+    if (*end == '\r' && *(end + 1) == '\n')
+      end++;
+
+    if (*end == '\0')
+      break;
+
+    start = end + 1;
+    }
+
+  hdr.seq = __sync_fetch_and_add(&log_seq, 1);
+  hdr.len = len;
+  hdr.size = (sizeof(hdr) + len + 7) & ~7;
+  need = hdr.size;
+
+  /* records don't wrap; skip the end of the ring if this one won't fit there */
+  pos = ring->head % LOG_RING_SIZE;
+  to_end = LOG_RING_SIZE - pos;
+
+  if (to_end < need)
+    skip = to_end;
+
+  if (ring->head + skip + need - ring->tail > LOG_RING_SIZE)
+    {
+    /* the writer is behind; empty the rings ourselves if nobody else is logging */
+    if (pthread_mutex_trylock(&log_mutex) == 0)
+      {
+      log_async_drain();
+      pthread_mutex_unlock(&log_mutex);
+      }
+
+    if (ring->head + skip + need - ring->tail > LOG_RING_SIZE)
+      {
+      ring->dropped++;
+      __sync_fetch_and_add(&log_total_dropped, 1);
+      return(PBSE_NONE);
+      }
+    }
+
+  /* don't overwrite space before the writer is done with it */
+  __sync_synchronize();
+
+  if ((skip != 0) &&
+      (skip >= sizeof(hdr)))
+    {
+    log_ring_record marker;
+
+    memset(&marker, 0, sizeof(marker));
+    memcpy(ring->buf + pos, &marker, sizeof(marker));
+    }
+
+  pos = (ring->head + skip) % LOG_RING_SIZE;
+  memcpy(ring->buf + pos, &hdr, sizeof(hdr));
+  memcpy(ring->buf + pos + sizeof(hdr), record, len);
+
+  /* the record must be visible before the writer sees the new head */
+  __sync_synchronize();
+  ring->head += skip + need;
+
+  /* don't wait for the writer's next pass once the ring is half full */
+  if (ring->head - ring->tail > LOG_RING_SIZE / 2)
+    pthread_cond_signal(&log_writer_cond);
+
+  return(PBSE_NONE);
+  }  /* END log_async_enqueue() */
+
+
+
+/*
+ * log_ring_peek - finds the next record in ring at or after cursor
+ *
+ * @return the record header or NULL if the ring has nothing before head
+ */
+
+static log_ring_record *log_ring_peek(
+
+  log_ring      *ring,
+  unsigned long *cursor,
+  unsigned long  head)
+
+  {
+  while (*cursor < head)
+    {
+    unsigned long    pos = *cursor % LOG_RING_SIZE;
+    log_ring_record *hdr;
+
+    if (LOG_RING_SIZE - pos < sizeof(log_ring_record))
+      {
+      *cursor += LOG_RING_SIZE - pos;
+      continue;
+      }
+
+    hdr = (log_ring_record *)(ring->buf + pos);
+
+    if (hdr->size == 0)
+      {
+      *cursor += LOG_RING_SIZE - pos;
+      continue;
+      }
+
+    return(hdr);
+    }
+
+  return(NULL);
+  }  /* END log_ring_peek() */
+
+
+
+/*
+ * log_writev - writes all of iov to fd, reopening the log once on EPIPE like log_record_sync()
+ */
+
+static int log_writev(
+
+  struct iovec *iov,
+  int           count)
+
+  {
+  int tryagain = 1;
+
+  while (count > 0)
+    {
+    ssize_t written = writev(fileno(logfile), iov, count);
+
+    if (written < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      if ((errno == EPIPE) &&
+          (tryagain-- > 0))
+        {
+        log_opened = 0;
+        log_open(NULL, log_directory);
+
+        if (log_opened < 1)
+          return(-1);
+
+        continue;
+        }
+
+      return(-1);
+      }
+
+    /* skip what was written */
+    while ((count > 0) &&
+           ((size_t)written >= iov->iov_len))
+      {
+      written -= iov->iov_len;
+      iov++;
+      count--;
+      }
+
+    if (count > 0)
+      {
+      iov->iov_base = (char *)iov->iov_base + written;
+      iov->iov_len -= written;
+      }
+    }
+
+  return(PBSE_NONE);
+  }  /* END log_writev() */
+
+
+
+/*
+ * log_async_drain - writes every queued record to the log in the order it was logged
+ *
+ * The caller must hold log_mutex.
+ */
+
+static void log_async_drain(void)
+
+  {
+  log_ring       *ring;
+  log_ring       *prev;
+  int             ring_count = 0;
+  int             count = 0;
+  int             rc = PBSE_NONE;
+  int             write_errno = 0;
+  struct iovec    iov[LOG_WRITEV_BATCH];
+  unsigned long  *cursors;
+  unsigned long  *heads;
+  log_ring      **rings;
+
+  if ((log_draining == TRUE) ||
+      (log_rings == NULL))
+    return;
+
+  log_draining = TRUE;
+
+  if (log_opened > 0)
+    {
+    struct tm  tm;
+    time_t     now = time(NULL);
+
+    if ((log_auto_switch) &&
+        (localtime_r(&now, &tm)->tm_yday != log_open_day))
+      {
+      log_close(1);
+      log_open(NULL, log_directory);
+      }
+    }
+
+  for (ring = log_rings; ring != NULL; ring = ring->next)
+    ring_count++;
+
+  rings = (log_ring **)calloc(ring_count, sizeof(log_ring *));
+  cursors = (unsigned long *)calloc(ring_count, sizeof(unsigned long));
+  heads = (unsigned long *)calloc(ring_count, sizeof(unsigned long));
+
+  if ((rings == NULL) ||
+      (cursors == NULL) ||
+      (heads == NULL))
+    {
+    free(rings);
+    free(cursors);
+    free(heads);
+    log_draining = FALSE;
+    return;
+    }
+
+  ring_count = 0;
+
+  for (ring = log_rings; ring != NULL; ring = ring->next)
+    {
+    rings[ring_count] = ring;
+    cursors[ring_count] = ring->tail;
+    heads[ring_count] = ring->head;
+    ring_count++;
+    }
+
+  /* only read records published before the heads were sampled */
+  __sync_synchronize();
+
+  if (log_opened > 0)
+    fflush(logfile);
+
+  while (1)
+    {
+    log_ring_record *next = NULL;
+    int              which = -1;
+
+    for (int i = 0; i < ring_count; i++)
+      {
+      log_ring_record *hdr = log_ring_peek(rings[i], &cursors[i], heads[i]);
+
+      if ((hdr != NULL) &&
+          ((next == NULL) ||
+           (hdr->seq < next->seq)))
+        {
+        next = hdr;
+        which = i;
+        }
+      }
+
+    if ((next == NULL) ||
+        (count == LOG_WRITEV_BATCH))
+      {
+      if ((count > 0) &&
+          (log_opened > 0) &&
+          (rc == PBSE_NONE) &&
+          ((rc = log_writev(iov, count)) != PBSE_NONE))
+        write_errno = errno;
+
+      count = 0;
+
+      /* everything before the cursors has been written */
+      __sync_synchronize();
+      for (int i = 0; i < ring_count; i++)
+        rings[i]->tail = cursors[i];
+
+      if (next == NULL)
+        break;
+      }
+
+    iov[count].iov_base = (char *)(next + 1);
+    iov[count].iov_len = next->len;
+    count++;
+    cursors[which] += next->size;
+    }
+
+  free(rings);
+  free(cursors);
+  free(heads);
+
+  if (rc != PBSE_NONE)
+    {
+    FILE *console = fopen("/dev/console", "w");
+
+    if (console != NULL)
+      {
+      fprintf(console, "%s: PBS cannot write to its log: %s\n", msg_daemonname, strerror(write_errno));
+      fclose(console);
+      }
+    }
+
+  /* report drops and free the rings of threads that have exited */
+  prev = NULL;
+  ring = log_rings;
+
+  while (ring != NULL)
+    {
+    log_ring *next_ring = ring->next;
+
+    if (ring->dropped != ring->reported)
+      {
+      char buf[256];
+
+      snprintf(buf, sizeof(buf), "%lu log records dropped by thread %d because its log buffer was full",
+        ring->dropped - ring->reported,
+        ring->thr_id);
+      ring->reported = ring->dropped;
+
+      log_record_sync(PBSEVENT_ERROR | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER, msg_daemonname, buf);
+      }
+
+    if ((ring->orphaned == TRUE) &&
+        (ring->tail == ring->head))
+      {
+      if (prev == NULL)
+        log_rings = next_ring;
+      else
+        prev->next = next_ring;
+
+      free(ring);
+      }
+    else
+      prev = ring;
+
+    ring = next_ring;
+    }
+
+  log_draining = FALSE;
+  }  /* END log_async_drain() */
+
+
+
+/*
+ * log_async_writer - background thread that empties the rings into the log
+ */
+
+static void *log_async_writer(
+
+  void *arg)
+
+  {
+  sigset_t all;
+
+  /* signals are for the daemon's main thread */
+  sigfillset(&all);
+  pthread_sigmask(SIG_BLOCK, &all, NULL);
+
+  while (log_async_running == TRUE)
+    {
+    struct timeval  now;
+    struct timespec wake;
+
+    gettimeofday(&now, NULL);
+    wake.tv_sec = now.tv_sec;
+    wake.tv_nsec = (now.tv_usec + LOG_WRITER_INTERVAL) * 1000;
+
+    if (wake.tv_nsec >= 1000000000)
+      {
+      wake.tv_sec++;
+      wake.tv_nsec -= 1000000000;
+      }
+
+    pthread_mutex_lock(&log_writer_mutex);
+    pthread_cond_timedwait(&log_writer_cond, &log_writer_mutex, &wake);
+    pthread_mutex_unlock(&log_writer_mutex);
+
+    pthread_mutex_lock(&log_mutex);
+    log_async_drain();
+    pthread_mutex_unlock(&log_mutex);
+    }
+
+  return(NULL);
+  }  /* END log_async_writer() */
+
+
+
+/*
+ * log_async_start - hand log_record() writes to a writer thread
+ *
+ * Must be called after the daemon has forked into the background.
+ * @return PBSE_NONE on success, PBSE_SYSTEM if the thread couldn't be started
+ */
+
+int log_async_start(void)
+
+  {
+  pthread_t      writer;
+  pthread_attr_t attr;
+
+  pthread_once(&log_async_once, log_async_init);
+
+  if (log_async_running == TRUE)
+    return(PBSE_NONE);
+
+  log_async_running = TRUE;
+  log_async_active = TRUE;
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  if (pthread_create(&writer, &attr, log_async_writer, NULL) != 0)
+    {
+    log_async_running = FALSE;
+    log_async_active = FALSE;
+    pthread_attr_destroy(&attr);
+    return(PBSE_SYSTEM);
+    }
+
+  pthread_attr_destroy(&attr);
+
+  return(PBSE_NONE);
+  }  /* END log_async_start() */
+
+
+
+/*
+ * log_async_stop - writes the pending records and returns to synchronous logging
+ */
+
+void log_async_stop(void)
+
+  {
+  pthread_mutex_lock(&log_mutex);
+
+  log_async_active = FALSE;
+  log_async_running = FALSE;
+
+  log_async_drain();
+
+  pthread_mutex_unlock(&log_mutex);
+  }  /* END log_async_stop() */
+
+
+
+/*
+ * log_async_flush - writes every pending record before returning, does nothing
+ * unless asynchronous logging is on
+ */
+
+void log_async_flush(void)
+
+  {
+  if (log_async_active != TRUE)
+    return;
+
+  pthread_mutex_lock(&log_mutex);
+  log_async_drain();
+  pthread_mutex_unlock(&log_mutex);
+  }  /* END log_async_flush() */
+
+
+
+/*
+ * log_async_dropped - the number of records dropped because a ring was full
+ */
+
+unsigned long log_async_dropped(void)
+
+  {
+  return(log_total_dropped);
+  }  /* END log_async_dropped() */
+
+
+
+/*
+ * log_record - log a message to the log file
+ * The log file must have been opened by log_open().
+ *
+ * NOTE:  do not use in pbs_mom spawned children - does not write to syslog!!!
+ *
+ * The caller should ensure proper formating of the message if "text"
+ * is to contain "continuation lines".
+ */
+
+void log_record(
+
+  int         eventtype,  /* I */
+  int         objclass,   /* I */
+  const char *objname,    /* I */
+  const char *text)       /* I */
+
+  {
+  if ((log_async_active == TRUE) &&
+      (log_async_enqueue(eventtype, objclass, objname, text) == PBSE_NONE))
+    return;
+
+  log_record_sync(eventtype, objclass, objname, text);
   }  /* END log_record() */
 
 
@@ -949,6 +1701,14 @@ void log_close(
   char buf[1024];
   if (log_opened == 1)
     {
+    /* pending records belong in this file */
+    if (log_async_active == TRUE)
+      {
+      pthread_mutex_lock(&log_mutex);
+      log_async_drain();
+      pthread_mutex_unlock(&log_mutex);
+      }
+
     log_auto_switch = 0;
 
     if (msg)
@@ -959,7 +1719,7 @@ void log_close(
         snprintf(buf, sizeof(buf), "Log closed");
 
       pthread_mutex_unlock(&log_mutex);
-      log_record(
+      log_record_sync(
         PBSEVENT_SYSTEM,
         PBS_EVENTCLASS_SERVER,
         "Log",
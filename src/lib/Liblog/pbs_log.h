@@ -40,4 +40,12 @@ void log_set_hostname_sharelogging(const char *server_name, const char *server_p
 
 void log_get_host_port(char *host_n_port, size_t s);
 
+int log_async_start(void);
+
+void log_async_stop(void);
+
+void log_async_flush(void);
+
+unsigned long log_async_dropped(void);
+
 #endif /* _PBS_LOG_H */
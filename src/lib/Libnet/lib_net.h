@@ -40,6 +40,7 @@ int socket_get_tcp_priv();
 int socket_connect_unix(int local_socket, const char *sock_name, char **err_msg);
 int socket_connect(int &local_socket, char *dest_addr, int dest_addr_len, int dest_port, int family, int is_privileged, std::string &err_msg);
 int socket_connect_addr(int &local_socket, struct sockaddr *remote, size_t remote_size, int is_privileged, std::string &err_msg);
+int socket_connect_addrs(struct sockaddr_in **remotes, int count, int *sockets, int is_privileged, unsigned int timeout);
 int socket_wait_for_write(int socket);
 int socket_wait_for_xbytes(int socket, int len);
 int socket_wait_for_read(int socket, unsigned int timeout);
@@ -326,6 +326,165 @@ int socket_connect(
 
 
 
+/*
+ * socket_connect_addrs()
+ *
+ * connects a socket to each of several remote addresses, overlapping the
+ * handshakes instead of waiting for each one in turn
+ * @param remotes - the addresses to connect to
+ * @param count - the number of addresses
+ * @param sockets - O: the connected socket for each address, or
+ * PERMANENT_SOCKET_FAIL/TRANSIENT_SOCKET_FAIL when it could not be connected
+ * @param is_privileged - indicates whether sockets are bound to privileged ports or not
+ * @param timeout - seconds to wait for the handshakes to complete
+ * @return the number of sockets connected
+ */
+
+int socket_connect_addrs(
+
+  struct sockaddr_in **remotes,
+  int                  count,
+  int                 *sockets,
+  int                  is_privileged,
+  unsigned int         timeout)
+
+  {
+  int            i;
+  int            rc;
+  int            connected = 0;
+  int            pending = 0;
+  int           *flags;
+  struct pollfd *pfds;
+  struct timeval start;
+  struct timeval now;
+  long           elapsed_ms;
+  int            sock_err;
+  socklen_t      len;
+
+  if (count <= 0)
+    return(0);
+
+  flags = (int *)calloc(count, sizeof(int));
+  pfds = (struct pollfd *)calloc(count, sizeof(struct pollfd));
+
+  if ((flags == NULL) ||
+      (pfds == NULL))
+    {
+    free(flags);
+    free(pfds);
+
+    for (i = 0; i < count; i++)
+      sockets[i] = TRANSIENT_SOCKET_FAIL;
+
+    return(0);
+    }
+
+  /* start every handshake before waiting on any of them */
+  for (i = 0; i < count; i++)
+    {
+    pfds[i].fd = -1;
+
+    if (is_privileged)
+      sockets[i] = socket_get_tcp_priv();
+    else
+      sockets[i] = socket_get_tcp();
+
+    if (sockets[i] < 0)
+      {
+      sockets[i] = TRANSIENT_SOCKET_FAIL;
+      continue;
+      }
+
+    flags[i] = fcntl(sockets[i], F_GETFL);
+    fcntl(sockets[i], F_SETFL, flags[i] | O_NONBLOCK);
+
+    if (connect(sockets[i], (struct sockaddr *)remotes[i], sizeof(struct sockaddr_in)) == 0)
+      {
+      fcntl(sockets[i], F_SETFL, flags[i]);
+      connected++;
+      }
+    else if ((errno == EINPROGRESS) ||
+             (errno == EINTR))
+      {
+      pfds[i].fd = sockets[i];
+      pfds[i].events = POLLOUT;
+      pending++;
+      }
+    else
+      {
+      close(sockets[i]);
+      sockets[i] = ((errno == ECONNREFUSED) || (errno == ETIMEDOUT)) ?
+                   PERMANENT_SOCKET_FAIL :
+                   TRANSIENT_SOCKET_FAIL;
+      }
+    }
+
+  gettimeofday(&start, NULL);
+
+  while (pending > 0)
+    {
+    gettimeofday(&now, NULL);
+    elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_usec - start.tv_usec) / 1000;
+
+    if (elapsed_ms >= (long)timeout * 1000)
+      break;
+
+    if ((rc = poll(pfds, count, (long)timeout * 1000 - elapsed_ms)) < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      break;
+      }
+
+    for (i = 0; (i < count) && (rc > 0); i++)
+      {
+      if ((pfds[i].fd < 0) ||
+          (pfds[i].revents == 0))
+        continue;
+
+      rc--;
+      pending--;
+
+      sock_err = 0;
+      len = sizeof(sock_err);
+
+      if ((getsockopt(sockets[i], SOL_SOCKET, SO_ERROR, &sock_err, &len) == 0) &&
+          (sock_err == 0))
+        {
+        fcntl(sockets[i], F_SETFL, flags[i]);
+        connected++;
+        }
+      else
+        {
+        close(sockets[i]);
+        sockets[i] = ((sock_err == ECONNREFUSED) || (sock_err == ETIMEDOUT)) ?
+                     PERMANENT_SOCKET_FAIL :
+                     TRANSIENT_SOCKET_FAIL;
+        }
+
+      pfds[i].fd = -1;
+      }
+    }
+
+  /* whatever has not answered by now is treated as a transient failure */
+  for (i = 0; i < count; i++)
+    {
+    if (pfds[i].fd >= 0)
+      {
+      close(sockets[i]);
+      sockets[i] = TRANSIENT_SOCKET_FAIL;
+      }
+    }
+
+  free(flags);
+  free(pfds);
+
+  return(connected);
+  } /* END socket_connect_addrs() */
+
+
+
 /*
  * socket_connect_addr()
  *
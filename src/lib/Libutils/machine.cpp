@@ -113,6 +113,8 @@ Machine& Machine::operator= (const Machine& newMachine)
   availableChips = newMachine.availableChips;
   availableCores = newMachine.availableCores;
   availableThreads = newMachine.availableThreads;
+  numa_distances = newMachine.numa_distances;
+  topology_aware = newMachine.topology_aware;
   this->initialized = newMachine.initialized;
   return *this;
   }
@@ -177,6 +179,9 @@ void Machine::initialize_from_json(
       this->totalSockets++;
       }
 
+    if (root.isMember(DISTANCES))
+      this->initialize_numa_distances(root[DISTANCES]);
+
     update_internal_counts();
     this->initialized = true;
     }
@@ -212,6 +217,7 @@ void Machine::reinitialize_from_json(
   this->sockets.clear();
   this->NVIDIA_device.clear();
   this->allocations.clear();
+  this->numa_distances.clear();
 
   this->initialize_from_json(json_layout, valid_ids);
   } // END reinitialize_from_json()
@@ -236,10 +242,14 @@ void Machine::reinitialize_from_json(
  *     [, "numanode" ... ]
  *     }
  *   [, "socket" ...]
- *   }
+ *   },
+ *  "distances" : [[<distance>, ...], ...]
  * }
  *
- * mics and gpus are optional and only present if they actually exist on the node
+ * mics and gpus are optional and only present if they actually exist on the node.
+ * distances is optional and holds the relative NUMA distances, one row per chip id.
+ * Chip ids are hwloc logical indices, which is also what the numanode's "os_index"
+ * holds despite its name.
  *
  */
 
@@ -250,7 +260,8 @@ Machine::Machine(const std::string &json_layout,
                                                         availableSockets(0), availableChips(0),
                                                         availableCores(0), availableThreads(0),
                                                         initialized(true), sockets(),
-                                                        NVIDIA_device(), allocations()
+                                                        NVIDIA_device(), allocations(),
+                                                        numa_distances(), topology_aware(false)
 
   {
   this->initialize_from_json(json_layout, valid_ids);
@@ -261,7 +272,7 @@ Machine::Machine(const std::string &json_layout,
 Machine::Machine() : hardwareStyle(0), totalMemory(0), totalSockets(0), totalChips(0),
                      totalCores(0), totalThreads(0), availableSockets(0), availableChips(0),
                      availableCores(0), availableThreads(0), initialized(false), sockets(),
-                     NVIDIA_device(), allocations()
+                     NVIDIA_device(), allocations(), numa_distances(), topology_aware(false)
   
   { 
   memset(allowed_cpuset_string, 0, MAX_CPUSET_SIZE);
@@ -277,7 +288,8 @@ Machine::Machine(
   int sockets) : hardwareStyle(0), totalMemory(0), totalSockets(sockets), totalChips(numa_nodes),
                  totalCores(np), totalThreads(np), availableSockets(sockets),
                  availableChips(numa_nodes), availableCores(np), availableThreads(np),
-                 initialized(true), sockets(), NVIDIA_device(), allocations()
+                 initialized(true), sockets(), NVIDIA_device(), allocations(),
+                 numa_distances(), topology_aware(false)
 
   {
   int np_remainder = np % sockets;
@@ -414,6 +426,8 @@ int Machine::initializeMachine(hwloc_topology_t topology)
 
     prev = socket_obj;
     }
+
+  initialize_numa_distances(topology);
   
 #ifdef NVIDIA_GPUS
     initializeNVIDIADevices(obj, topology);
@@ -512,6 +526,12 @@ void Machine::displayAsJson(
     {
     this->sockets[i].displayAsJson(node[NODE][i][SOCKET], include_jobs);
     }
+
+  for (unsigned int i = 0; i < this->numa_distances.size(); i++)
+    {
+    for (unsigned int j = 0; j < this->numa_distances[i].size(); j++)
+      node[DISTANCES][i][j] = this->numa_distances[i][j];
+    }
   
   out << node;
   }
@@ -958,9 +978,21 @@ int Machine::fit_tasks_within_sockets(
   int        &remaining_tasks)
 
   {
-  for (unsigned int i = 0; i < this->sockets.size() && remaining_tasks > 0; i++)
+  std::vector<int> order;
+
+  if (this->topology_aware == true)
+    this->order_sockets_by_distance(r, job_alloc.place_type, order);
+  else
+    {
+    for (unsigned int i = 0; i < this->sockets.size(); i++)
+      order.push_back(i);
+    }
+
+  for (unsigned int o = 0; o < order.size() && remaining_tasks > 0; o++)
     {
-    int placed = this->sockets[i].place_task(r, job_alloc, remaining_tasks, hostname);
+    int i = order[o];
+    int placed = this->sockets[i].place_task(r, job_alloc, remaining_tasks, hostname,
+                                             this->topology_aware);
     if (placed != 0)
       {
       remaining_tasks -= placed;
@@ -1026,6 +1058,21 @@ int Machine::place_job(
       if ((rc = spread_place(r, job_alloc, tasks_for_node, hostname)) != PBSE_NONE)
         return(rc);
       }
+    else if (this->topology_aware == true)
+      {
+      int j = this->lowest_cost_socket(r, job_alloc.place_type, tasks_for_node);
+
+      if (j != -1)
+        {
+        // place the req entirely on the cheapest socket that can hold it
+        placed = true;
+
+        if (this->sockets[j].place_task(r, job_alloc, tasks_for_node, hostname, true) == 0)
+          return(-1);
+        }
+      else
+        partially_place.push_back(i);
+      }
     else
       {
       for (unsigned int j = 0; j < this->sockets.size(); j++)
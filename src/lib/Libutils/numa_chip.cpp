@@ -22,6 +22,7 @@
 #include "log.h"
 #include "utils.h"
 #include "numa_constants.h"
+#include "slot_bitset.hpp"
 
 using namespace std;
 
@@ -1170,9 +1171,9 @@ bool Chip::getContiguousCoreVector(
   int               execution_slots_per_task)
 
   {
-  unsigned int j = 0;
-  int i = execution_slots_per_task;
-  bool fits = false;
+  slot_bitset busy_cores(this->cores.size());
+  int         start;
+  bool        fits = false;
 
   /* this makes it so users can request gpus and mics 
      from numanodes which are not where the cores or threads
@@ -1180,49 +1181,39 @@ bool Chip::getContiguousCoreVector(
   if (execution_slots_per_task == 0)
     return(true);
 
-  /* First try to get contiguous cores */
-  do
+  for (unsigned int j = 0; j < this->cores.size(); j++)
     {
-    if (this->cores[j].is_free() == true)
-      {
+    if (this->cores[j].is_free() == false)
+      busy_cores.set(j);
+    }
+
+  slots.reserve(execution_slots_per_task);
+
+  /* First try to get contiguous cores. A run of free cores that goes to the
+     end of the chip is also taken, even if it is too short */
+  start = busy_cores.find_clear_run(execution_slots_per_task, 0);
+
+  if ((start == -1) &&
+      (busy_cores.find_last_set() < busy_cores.size() - 1))
+    start = busy_cores.find_last_set() + 1;
+
+  if (start != -1)
+    {
+    for (int j = start; j < busy_cores.size() && (int)slots.size() < execution_slots_per_task; j++)
       slots.push_back(j);
-      i--;
-      j++;
-      if ((i ==0) || (j == this->cores.size()))
-        {
-        /* We fit if all of the execution slots have been filled
-           or it we have used all the chip */
-        fits = true;
-        }
-      }
-    else
-      {
-      i = execution_slots_per_task;
-      j++;
-      slots.clear();
-      }
-    }while((i != 0) && (j < this->cores.size()));
 
-  if (fits == false)
+    fits = true;
+    }
+  else
     {
     /* Can't get contiguous cores. Just get them where you can find them */
     // Get the core indices we will use
-    j = 0;
-    for (int i = 0; i < execution_slots_per_task; i++)
-      {
-      while (j < this->cores.size())
-        {
-        if (this->cores[j].is_free() == true)
-          {
-          slots.push_back(j);
-          j++;
-          break;
-          }
-        else
-          j++;
-        }
-      }
+    for (int j = busy_cores.find_next_clear(0);
+         (j != -1) && ((int)slots.size() < execution_slots_per_task);
+         j = busy_cores.find_next_clear(j + 1))
+      slots.push_back(j);
     }
+
   return(fits);
   }
 
@@ -28,3 +28,4 @@ const char *JOBID       = "jobid";
 const char *CPUS        = "cpus";
 const char *EXCLUSIVE   = "exclusive";
 const char *OS_INDEX    = "os_index";
+const char *DISTANCES   = "distances";
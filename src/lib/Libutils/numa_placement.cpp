@@ -0,0 +1,581 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include <string>
+#include <vector>
+#include "pbs_config.h"
+
+#ifdef PENABLE_LINUX_CGROUPS
+#include <hwloc.h>
+#include "machine.hpp"
+#include "req.hpp"
+#include "numa_constants.h"
+
+/*
+ * Topology aware placement
+ *
+ * When a node's layout is topology aware, each socket and chip that could hold a req
+ * is scored and the lowest cost candidate is used instead of the first one that fits.
+ * A placement costs the average NUMA distance between its tasks (1.0 when all tasks
+ * share a chip) plus, for each chip used, the fraction of the chip's execution slots
+ * that would be left idle and a penalty for sitting on accelerators the req didn't ask
+ * for.
+ */
+
+
+
+/*
+ * numa_distance()
+ *
+ * @param distances - the distance matrix, indexed by chip id. May be empty.
+ * @param from - the id of the first chip
+ * @param to - the id of the second chip
+ * @param same_socket - true if both chips are on the same socket
+ * @return the relative distance between the chips, estimated from the layout if
+ * distances doesn't cover both chips.
+ */
+
+int numa_distance(
+
+  const numa_distance_matrix &distances,
+  int                         from,
+  int                         to,
+  bool                        same_socket)
+
+  {
+  if ((from >= 0) &&
+      (to >= 0) &&
+      (from < (int)distances.size()) &&
+      (to < (int)distances[from].size()))
+    return(distances[from][to]);
+
+  if (from == to)
+    return(LOCAL_NUMA_DISTANCE);
+  else if (same_socket == true)
+    return(SOCKET_NUMA_DISTANCE);
+
+  return(REMOTE_NUMA_DISTANCE);
+  } // END numa_distance()
+
+
+
+/*
+ * placement_cost()
+ *
+ * Scores placing tasks from r on this chip. Lower is better.
+ * @param r - the req whose tasks are being placed
+ * @param tasks - the number of tasks that would be placed on this chip
+ * @return the cost of the placement
+ */
+
+float Chip::placement_cost(
+
+  const req &r,
+  int        tasks) const
+
+  {
+  float cost = 0;
+  float per_task = r.getExecutionSlots();
+  float available;
+
+  if (r.getPlaceCores() > 0)
+    per_task = r.getPlaceCores();
+  else if (r.getPlaceThreads() > 0)
+    per_task = r.getPlaceThreads();
+
+  if (r.getThreadUsageString() == use_cores)
+    available = this->free_core_count();
+  else
+    available = this->availableThreads;
+
+  // Filling a chip keeps the tasks on its shared caches and leaves emptier chips for wider reqs
+  if (available > 0)
+    {
+    float idle = (available - (per_task * tasks)) / available;
+
+    if (idle > 0)
+      cost += idle;
+    }
+
+  // Save the cores near accelerators for the jobs that use them
+  if ((r.getGpus() == 0) &&
+      (this->available_gpus > 0))
+    cost += ACCELERATOR_LOCALITY_COST;
+
+  if ((r.getMics() == 0) &&
+      (this->available_mics > 0))
+    cost += ACCELERATOR_LOCALITY_COST;
+
+  return(cost);
+  } // END placement_cost()
+
+
+
+/*
+ * get_chip_ids()
+ *
+ * @param ids (O) - populated with the ids of this socket's chips
+ */
+
+void Socket::get_chip_ids(
+
+  std::vector<int> &ids) const
+
+  {
+  for (unsigned int i = 0; i < this->chips.size(); i++)
+    ids.push_back(this->chips[i].get_id());
+  } // END get_chip_ids()
+
+
+
+/*
+ * lowest_cost_chip()
+ *
+ * @param r - the req whose tasks are being placed
+ * @param place_type - the job's placement type
+ * @param tasks - the number of tasks to place
+ * @return the index of the cheapest chip that can hold all of the tasks, or -1 if none can
+ */
+
+int Socket::lowest_cost_chip(
+
+  const req &r,
+  int        place_type,
+  int        tasks) const
+
+  {
+  int   best = -1;
+  float best_cost = 0;
+
+  for (unsigned int i = 0; i < this->chips.size(); i++)
+    {
+    if (this->chips[i].how_many_tasks_fit(r, place_type) >= tasks)
+      {
+      float cost = this->chips[i].placement_cost(r, tasks);
+
+      if ((best == -1) ||
+          (cost < best_cost))
+        {
+        best = i;
+        best_cost = cost;
+        }
+      }
+    }
+
+  return(best);
+  } // END lowest_cost_chip()
+
+
+
+/*
+ * placement_cost()
+ *
+ * Scores placing tasks from r on this socket the way place_task() would: on the cheapest
+ * chip that holds them all, otherwise split across the chips in order, with any tasks
+ * that don't fit in a single chip spanning chips.
+ *
+ * @param r - the req whose tasks are being placed
+ * @param place_type - the job's placement type
+ * @param tasks - the number of tasks to place
+ * @param distances - the machine's NUMA distance matrix
+ * @return the cost of the placement
+ */
+
+float Socket::placement_cost(
+
+  const req                  &r,
+  int                         place_type,
+  int                         tasks,
+  const numa_distance_matrix &distances) const
+
+  {
+  if (tasks <= 0)
+    return(0);
+
+  int best = this->lowest_cost_chip(r, place_type, tasks);
+
+  if (best != -1)
+    return(1.0 + this->chips[best].placement_cost(r, tasks));
+
+  std::vector<int> used;
+  std::vector<int> counts;
+  int              remaining = tasks;
+  float            chip_cost = 0;
+  float            weighted = 0;
+  int              max_distance = LOCAL_NUMA_DISTANCE;
+
+  for (unsigned int i = 0; i < this->chips.size(); i++)
+    {
+    int fit = this->chips[i].how_many_tasks_fit(r, place_type);
+
+    if (fit > remaining)
+      fit = remaining;
+
+    if (fit > 0)
+      {
+      used.push_back(i);
+      counts.push_back(fit);
+      remaining -= fit;
+      chip_cost += fit * this->chips[i].placement_cost(r, fit);
+      }
+
+    for (unsigned int j = 0; j < this->chips.size(); j++)
+      {
+      int d = numa_distance(distances, this->chips[i].get_id(), this->chips[j].get_id(), true);
+
+      if (d > max_distance)
+        max_distance = d;
+      }
+    }
+
+  for (unsigned int i = 0; i < used.size(); i++)
+    {
+    for (unsigned int j = 0; j < used.size(); j++)
+      {
+      weighted += counts[i] * counts[j] *
+                  numa_distance(distances,
+                                this->chips[used[i]].get_id(),
+                                this->chips[used[j]].get_id(),
+                                true);
+      }
+    }
+
+  // Every pair involving a task that spans chips is charged the socket's widest distance
+  int placed = tasks - remaining;
+  weighted += ((float)tasks * tasks - (float)placed * placed) * max_distance;
+
+  return((weighted / ((float)tasks * tasks)) / LOCAL_NUMA_DISTANCE + (chip_cost / tasks));
+  } // END placement_cost()
+
+
+
+/*
+ * initialize_numa_distances()
+ *
+ * Stores hwloc's NUMA latency matrix, normalized so that local access is LOCAL_NUMA_DISTANCE.
+ * hwloc indexes the matrix by the NUMA nodes' logical indices, which are also our chip ids.
+ */
+
+void Machine::initialize_numa_distances(
+
+  hwloc_topology_t topology)
+
+  {
+  const struct hwloc_distances_s *matrix;
+
+  this->numa_distances.clear();
+
+  matrix = hwloc_get_whole_distance_matrix_by_type(topology, HWLOC_OBJ_NODE);
+
+  if ((matrix == NULL) ||
+      (matrix->latency == NULL))
+    return;
+
+  for (unsigned int i = 0; i < matrix->nbobjs; i++)
+    {
+    std::vector<int> row;
+
+    for (unsigned int j = 0; j < matrix->nbobjs; j++)
+      row.push_back((int)(matrix->latency[i * matrix->nbobjs + j] * LOCAL_NUMA_DISTANCE + 0.5));
+
+    this->numa_distances.push_back(row);
+    }
+  } // END initialize_numa_distances()
+
+
+
+/*
+ * initialize_numa_distances()
+ *
+ * Reads the distance matrix from the "distances" array of a json layout, one row per chip id.
+ */
+
+void Machine::initialize_numa_distances(
+
+  const Json::Value &distances)
+
+  {
+  this->numa_distances.clear();
+
+  for (unsigned int i = 0; i < distances.size(); i++)
+    {
+    std::vector<int>   row;
+    const Json::Value &json_row = distances[i];
+
+    for (unsigned int j = 0; j < json_row.size(); j++)
+      row.push_back(json_row[j].asInt());
+
+    this->numa_distances.push_back(row);
+    }
+  } // END initialize_numa_distances()
+
+
+
+void Machine::set_topology_aware(
+
+  bool aware)
+
+  {
+  this->topology_aware = aware;
+  }
+
+
+
+bool Machine::is_topology_aware() const
+
+  {
+  return(this->topology_aware);
+  }
+
+
+
+/*
+ * get_numa_distance()
+ *
+ * @return the relative distance between the chips with ids from_chip and to_chip
+ */
+
+int Machine::get_numa_distance(
+
+  int from_chip,
+  int to_chip) const
+
+  {
+  int from_socket = -1;
+  int to_socket = -1;
+
+  for (unsigned int i = 0; i < this->sockets.size(); i++)
+    {
+    std::vector<int> ids;
+
+    this->sockets[i].get_chip_ids(ids);
+
+    for (unsigned int j = 0; j < ids.size(); j++)
+      {
+      if (ids[j] == from_chip)
+        from_socket = i;
+
+      if (ids[j] == to_chip)
+        to_socket = i;
+      }
+    }
+
+  return(numa_distance(this->numa_distances, from_chip, to_chip,
+                       (from_socket != -1) && (from_socket == to_socket)));
+  } // END get_numa_distance()
+
+
+
+/*
+ * get_socket_distance()
+ *
+ * @return the average distance between the chips of the two sockets
+ */
+
+int Machine::get_socket_distance(
+
+  int from_socket,
+  int to_socket) const
+
+  {
+  std::vector<int> from_ids;
+  std::vector<int> to_ids;
+  int              total = 0;
+
+  this->sockets[from_socket].get_chip_ids(from_ids);
+  this->sockets[to_socket].get_chip_ids(to_ids);
+
+  if ((from_ids.size() == 0) ||
+      (to_ids.size() == 0))
+    {
+    if (from_socket == to_socket)
+      return(LOCAL_NUMA_DISTANCE);
+
+    return(REMOTE_NUMA_DISTANCE);
+    }
+
+  for (unsigned int i = 0; i < from_ids.size(); i++)
+    for (unsigned int j = 0; j < to_ids.size(); j++)
+      total += numa_distance(this->numa_distances, from_ids[i], to_ids[j], from_socket == to_socket);
+
+  return(total / (int)(from_ids.size() * to_ids.size()));
+  } // END get_socket_distance()
+
+
+
+/*
+ * lowest_cost_socket()
+ *
+ * @param r - the req whose tasks are being placed
+ * @param place_type - the job's placement type
+ * @param tasks - the number of tasks to place
+ * @return the index of the cheapest socket that can hold all of the tasks, or -1 if none can
+ */
+
+int Machine::lowest_cost_socket(
+
+  const req &r,
+  int        place_type,
+  int        tasks) const
+
+  {
+  int   best = -1;
+  float best_cost = 0;
+
+  for (unsigned int i = 0; i < this->sockets.size(); i++)
+    {
+    if (this->sockets[i].how_many_tasks_fit(r, place_type) >= tasks)
+      {
+      float cost = this->sockets[i].placement_cost(r, place_type, tasks, this->numa_distances);
+
+      if ((best == -1) ||
+          (cost < best_cost))
+        {
+        best = i;
+        best_cost = cost;
+        }
+      }
+    }
+
+  return(best);
+  } // END lowest_cost_socket()
+
+
+
+/*
+ * order_sockets_by_distance()
+ *
+ * Orders the sockets for a req that must be split across them: the socket that can hold
+ * the most tasks first, followed by the others from nearest to farthest from it.
+ *
+ * @param r - the req whose tasks are being placed
+ * @param place_type - the job's placement type
+ * @param order (O) - the socket indices in the order they should be used
+ */
+
+void Machine::order_sockets_by_distance(
+
+  const req        &r,
+  int               place_type,
+  std::vector<int> &order) const
+
+  {
+  int              anchor = -1;
+  float            most = 0;
+  std::vector<int> distances;
+
+  order.clear();
+
+  for (unsigned int i = 0; i < this->sockets.size(); i++)
+    {
+    float fit = this->sockets[i].how_many_tasks_fit(r, place_type);
+
+    if ((anchor == -1) ||
+        (fit > most))
+      {
+      anchor = i;
+      most = fit;
+      }
+    }
+
+  if (anchor == -1)
+    return;
+
+  order.push_back(anchor);
+  distances.push_back(0);
+
+  for (unsigned int i = 0; i < this->sockets.size(); i++)
+    {
+    if ((int)i == anchor)
+      continue;
+
+    int d = this->get_socket_distance(anchor, i);
+    unsigned int pos = order.size();
+
+    // keep the order stable for sockets at the same distance
+    while ((pos > 1) &&
+           (distances[pos - 1] > d))
+      pos--;
+
+    order.insert(order.begin() + pos, i);
+    distances.insert(distances.begin() + pos, d);
+    }
+  } // END order_sockets_by_distance()
+
+#endif /* PENABLE_LINUX_CGROUPS */
@@ -636,6 +636,7 @@ bool Socket::spread_place(
  * @param master - the allocation for the entire job
  * @param to_place - the maximum number of tasks that should be placed
  * @param hostname - the name of the host where we're placing
+ * @param lowest_cost - if true, use the cheapest chip that holds all tasks instead of the first
  * @return the number of tasks placed
  */
 
@@ -644,7 +645,8 @@ int Socket::place_task(
   req        &r,
   allocation &master,
   int         to_place,
-  const char *hostname)
+  const char *hostname,
+  bool        lowest_cost)
 
   {
   int        tasks_to_place = to_place;
@@ -658,6 +660,14 @@ int Socket::place_task(
     if (this->socket_exclusive == false)
       {
       // Attempt to fit all tasks from this req on a single numa chip if possible
+      if (lowest_cost == true)
+        {
+        int best = this->lowest_cost_chip(r, master.place_type, to_place);
+
+        if (best != -1)
+          tasks_to_place -= this->chips[best].place_task(r, a, to_place, hostname);
+        }
+
       for (unsigned int i = 0; i < this->chips.size() && tasks_to_place > 0; i++)
         {
         if (this->chips[i].how_many_tasks_fit(r, master.place_type) >= to_place)
@@ -0,0 +1,546 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+
+/*
+ * u_mom_snapshot.c - pbs_mom's shared status snapshot, see mom_snapshot.h
+ *
+ * Functions included are:
+ * mom_snapshot_create()
+ * mom_snapshot_reserve()
+ * mom_snapshot_begin()
+ * mom_snapshot_end()
+ * mom_snapshot_job_at()
+ * mom_snapshot_attach()
+ * mom_snapshot_read()
+ * mom_snapshot_detach()
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mom_snapshot.h"
+#include "pbs_error.h"
+#include "utils.h"
+
+/* how long mom_snapshot_read() waits for an update in progress to finish */
+#define MOM_SNAPSHOT_RETRY_NSEC  100000
+
+
+
+/*
+ * snapshot_size - the file length needed for jobs entries
+ */
+
+static size_t snapshot_size(
+
+  size_t   header_size,
+  size_t   job_size,
+  uint32_t jobs)
+
+  {
+  return(header_size + (job_size * jobs));
+  } /* END snapshot_size() */
+
+
+
+
+/*
+ * snapshot_open - opens the snapshot file away from stdin, stdout and stderr
+ */
+
+static int snapshot_open(
+
+  const char *path,
+  int         flags)
+
+  {
+  return(open_ext(path, flags, 0644));
+  } /* END snapshot_open() */
+
+
+
+
+/*
+ * snapshot_map - maps len bytes of map->sm_fd, replacing any existing mapping
+ *
+ * The new mapping is made before the old one is released so that a failure
+ * leaves map as it was.
+ */
+
+static int snapshot_map(
+
+  mom_snapshot_map *map,
+  size_t            len)
+
+  {
+  int   prot = (map->sm_writable == true) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  void *addr;
+
+  if ((addr = mmap(NULL, len, prot, MAP_SHARED, map->sm_fd, 0)) == MAP_FAILED)
+    return(-1);
+
+  if (map->sm_header != NULL)
+    munmap(map->sm_header, map->sm_len);
+
+  map->sm_header = (mom_snapshot_header *)addr;
+  map->sm_len = len;
+
+  return(PBSE_NONE);
+  } /* END snapshot_map() */
+
+
+
+
+/*
+ * mom_snapshot_create - opens (creating if needed) the snapshot at path for
+ * writing and stamps a fresh header into it
+ *
+ * An existing file is reused rather than replaced so that readers which
+ * already have it mapped keep seeing updates. Its sequence carries on from
+ * where the last MOM left it, and it is never made smaller.
+ *
+ * @return PBSE_NONE on success, -1 if the file cannot be opened or mapped
+ */
+
+int mom_snapshot_create(
+
+  const char       *path,
+  mom_snapshot_map *map)
+
+  {
+  struct stat          sb;
+  uint32_t             capacity = MOM_SNAPSHOT_MIN_JOBS;
+  uint64_t             sequence = 0;
+  size_t               len;
+  mom_snapshot_header *hdr;
+
+  memset(map, 0, sizeof(*map));
+  map->sm_writable = true;
+
+  if ((map->sm_fd = snapshot_open(path, O_RDWR | O_CREAT)) < 0)
+    return(-1);
+
+  if (fstat(map->sm_fd, &sb) != 0)
+    {
+    mom_snapshot_detach(map);
+    return(-1);
+    }
+
+  if ((size_t)sb.st_size >= sizeof(mom_snapshot_header))
+    {
+    mom_snapshot_header old;
+
+    if ((pread(map->sm_fd, &old, sizeof(old), 0) == sizeof(old)) &&
+        (old.ms_magic == MOM_SNAPSHOT_MAGIC) &&
+        (old.ms_header_size == sizeof(mom_snapshot_header)) &&
+        (old.ms_job_size == sizeof(mom_snapshot_job)))
+      {
+      sequence = (old.ms_sequence + 1) & ~((uint64_t)1);
+
+      if (old.ms_job_capacity > capacity)
+        capacity = old.ms_job_capacity;
+      }
+    }
+
+  len = snapshot_size(sizeof(mom_snapshot_header), sizeof(mom_snapshot_job), capacity);
+
+  if ((size_t)sb.st_size > len)
+    len = sb.st_size;
+  else if (((size_t)sb.st_size < len) &&
+           (ftruncate(map->sm_fd, len) != 0))
+    {
+    mom_snapshot_detach(map);
+    return(-1);
+    }
+
+  if (snapshot_map(map, len) != PBSE_NONE)
+    {
+    mom_snapshot_detach(map);
+    return(-1);
+    }
+
+  hdr = map->sm_header;
+
+  hdr->ms_sequence = sequence;
+  mom_snapshot_begin(map);
+
+  hdr->ms_magic = MOM_SNAPSHOT_MAGIC;
+  hdr->ms_version = MOM_SNAPSHOT_VERSION;
+  hdr->ms_header_size = sizeof(mom_snapshot_header);
+  hdr->ms_job_size = sizeof(mom_snapshot_job);
+  hdr->ms_updated = time(NULL);
+  hdr->ms_started = hdr->ms_updated;
+  hdr->ms_mom_pid = getpid();
+  hdr->ms_state = 0;
+  hdr->ms_ncpus = 0;
+  hdr->ms_job_capacity = (len - sizeof(mom_snapshot_header)) / sizeof(mom_snapshot_job);
+  hdr->ms_job_count = 0;
+  hdr->ms_polls = 0;
+  hdr->ms_loadave = 0.0;
+  memset(hdr->ms_host, 0, sizeof(hdr->ms_host));
+
+  mom_snapshot_end(map);
+
+  return(PBSE_NONE);
+  } /* END mom_snapshot_create() */
+
+
+
+
+/*
+ * mom_snapshot_reserve - makes room for at least jobs entries
+ *
+ * The file at least doubles each time it grows so that a MOM whose job count
+ * creeps up does not remap on every poll.
+ *
+ * @return PBSE_NONE on success, -1 if the file could not be grown
+ */
+
+int mom_snapshot_reserve(
+
+  mom_snapshot_map *map,
+  uint32_t          jobs)
+
+  {
+  uint32_t capacity;
+  size_t   len;
+
+  if ((map->sm_header == NULL) ||
+      (map->sm_writable == false))
+    return(-1);
+
+  capacity = map->sm_header->ms_job_capacity;
+
+  if (jobs <= capacity)
+    return(PBSE_NONE);
+
+  if (jobs < capacity * 2)
+    jobs = capacity * 2;
+
+  len = snapshot_size(sizeof(mom_snapshot_header), sizeof(mom_snapshot_job), jobs);
+
+  if ((ftruncate(map->sm_fd, len) != 0) ||
+      (snapshot_map(map, len) != PBSE_NONE))
+    return(-1);
+
+  mom_snapshot_begin(map);
+  map->sm_header->ms_job_capacity = jobs;
+  mom_snapshot_end(map);
+
+  return(PBSE_NONE);
+  } /* END mom_snapshot_reserve() */
+
+
+
+
+/*
+ * mom_snapshot_begin - marks the snapshot as being updated
+ *
+ * Readers that see an odd sequence, or a different sequence after copying,
+ * throw their copy away and try again.
+ */
+
+void mom_snapshot_begin(
+
+  mom_snapshot_map *map)
+
+  {
+  map->sm_header->ms_sequence++;
+  __sync_synchronize();
+  } /* END mom_snapshot_begin() */
+
+
+
+
+/*
+ * mom_snapshot_end - publishes the changes made since mom_snapshot_begin()
+ */
+
+void mom_snapshot_end(
+
+  mom_snapshot_map *map)
+
+  {
+  __sync_synchronize();
+  map->sm_header->ms_sequence++;
+  } /* END mom_snapshot_end() */
+
+
+
+
+/*
+ * mom_snapshot_job_at - returns the entry at index, or NULL if the snapshot
+ * has no room for it
+ */
+
+mom_snapshot_job *mom_snapshot_job_at(
+
+  mom_snapshot_map *map,
+  uint32_t          index)
+
+  {
+  mom_snapshot_header *hdr = map->sm_header;
+
+  if ((hdr == NULL) ||
+      (index >= hdr->ms_job_capacity))
+    return(NULL);
+
+  return((mom_snapshot_job *)((char *)hdr + hdr->ms_header_size + ((size_t)hdr->ms_job_size * index)));
+  } /* END mom_snapshot_job_at() */
+
+
+
+
+/*
+ * mom_snapshot_attach - maps the snapshot at path read-only
+ *
+ * @return PBSE_NONE on success, -1 if the file is missing or is not a
+ * snapshot this reader understands
+ */
+
+int mom_snapshot_attach(
+
+  const char       *path,
+  mom_snapshot_map *map)
+
+  {
+  struct stat          sb;
+  mom_snapshot_header *hdr;
+
+  memset(map, 0, sizeof(*map));
+  map->sm_writable = false;
+
+  if ((map->sm_fd = snapshot_open(path, O_RDONLY)) < 0)
+    return(-1);
+
+  if ((fstat(map->sm_fd, &sb) != 0) ||
+      ((size_t)sb.st_size < sizeof(mom_snapshot_header)) ||
+      (snapshot_map(map, sb.st_size) != PBSE_NONE))
+    {
+    mom_snapshot_detach(map);
+    return(-1);
+    }
+
+  hdr = map->sm_header;
+
+  /* newer MOMs only append fields, so larger structures are still readable */
+  if ((hdr->ms_magic != MOM_SNAPSHOT_MAGIC) ||
+      (hdr->ms_header_size < sizeof(mom_snapshot_header)) ||
+      (hdr->ms_job_size < sizeof(mom_snapshot_job)))
+    {
+    mom_snapshot_detach(map);
+    errno = EINVAL;
+    return(-1);
+    }
+
+  return(PBSE_NONE);
+  } /* END mom_snapshot_attach() */
+
+
+
+
+/*
+ * mom_snapshot_read - copies a consistent view of the snapshot
+ *
+ * The header is copied into header and up to max_jobs entries into jobs.
+ * If the MOM grew the file since it was mapped it is mapped again.
+ *
+ * @return the number of entries copied, or -1 if no consistent copy could be
+ * made within MOM_SNAPSHOT_RETRIES attempts
+ */
+
+int mom_snapshot_read(
+
+  mom_snapshot_map    *map,
+  mom_snapshot_header *header,
+  mom_snapshot_job    *jobs,
+  uint32_t             max_jobs)
+
+  {
+  int attempt;
+
+  if (map->sm_header == NULL)
+    return(-1);
+
+  for (attempt = 0; attempt < MOM_SNAPSHOT_RETRIES; attempt++)
+    {
+    volatile mom_snapshot_header *hdr = map->sm_header;
+    uint64_t                      before;
+    uint32_t                      count;
+    uint32_t                      i;
+    size_t                        needed;
+
+    if (attempt > 0)
+      {
+      /* the MOM is mid-update, give it the cpu rather than spinning */
+      struct timespec pause = { 0, MOM_SNAPSHOT_RETRY_NSEC };
+
+      nanosleep(&pause, NULL);
+      }
+
+    before = hdr->ms_sequence;
+
+    if (before & 1)
+      continue;
+
+    __sync_synchronize();
+
+    memcpy(header, (const void *)hdr, sizeof(mom_snapshot_header));
+
+    if ((header->ms_header_size < sizeof(mom_snapshot_header)) ||
+        (header->ms_job_size < sizeof(mom_snapshot_job)))
+      continue;
+
+    count = header->ms_job_count;
+    needed = snapshot_size(header->ms_header_size, header->ms_job_size, count);
+
+    if (needed > map->sm_len)
+      {
+      struct stat sb;
+
+      __sync_synchronize();
+
+      if (hdr->ms_sequence != before)
+        continue;
+
+      /* the MOM has grown the file since we mapped it */
+      if ((fstat(map->sm_fd, &sb) != 0) ||
+          ((size_t)sb.st_size < needed) ||
+          (snapshot_map(map, sb.st_size) != PBSE_NONE))
+        return(-1);
+
+      attempt--;
+      continue;
+      }
+
+    if (count > max_jobs)
+      count = max_jobs;
+
+    for (i = 0; i < count; i++)
+      {
+      const char *entry = (const char *)hdr + header->ms_header_size + ((size_t)header->ms_job_size * i);
+
+      memcpy(jobs + i, entry, sizeof(mom_snapshot_job));
+      }
+
+    __sync_synchronize();
+
+    if (hdr->ms_sequence == before)
+      {
+      header->ms_sequence = before;
+
+      return((int)count);
+      }
+    }
+
+  errno = EAGAIN;
+
+  return(-1);
+  } /* END mom_snapshot_read() */
+
+
+
+
+/*
+ * mom_snapshot_detach - unmaps and closes the snapshot
+ */
+
+void mom_snapshot_detach(
+
+  mom_snapshot_map *map)
+
+  {
+  if (map->sm_header != NULL)
+    munmap(map->sm_header, map->sm_len);
+
+  if (map->sm_fd >= 0)
+    close(map->sm_fd);
+
+  map->sm_header = NULL;
+  map->sm_len = 0;
+  map->sm_fd = -1;
+  } /* END mom_snapshot_detach() */
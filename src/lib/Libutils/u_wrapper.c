@@ -7,6 +7,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 
 #include "log.h"
@@ -253,3 +254,45 @@ int mkdir_wrapper(
 
   return(rc);
   } // END mkdir_wrapper()
+
+
+
+/*
+ * open_ext - opens path with close-on-exec set, away from stdin, stdout and
+ * stderr which daemons reuse
+ *
+ * @return the descriptor or -1 with errno set
+ */
+
+int open_ext(
+
+  const char *path,
+  int         flags,
+  mode_t      mode)
+
+  {
+  int fd;
+
+  if ((fd = open(path, flags, mode)) < 0)
+    return(-1);
+
+  if (fd < 3)
+    {
+    int dup_fd = fcntl(fd, F_DUPFD, 3);
+    int save_errno = errno;
+
+    close(fd);
+
+    if (dup_fd < 0)
+      {
+      errno = save_errno;
+      return(-1);
+      }
+
+    fd = dup_fd;
+    }
+
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+  return(fd);
+  } // END open_ext()
@@ -29,9 +29,14 @@ extern char *optarg;
 #include "log.h"
 #include "../lib/Liblog/chk_file_sec.h"
 #include "lib_ifl.h"
+#include "mom_snapshot.h"
 
 #define MAX_QUERY  128
 
+#ifndef PBS_SERVER_HOME
+#define PBS_SERVER_HOME "/var/spool/torque"
+#endif
+
 const char *LocalHost = "localhost";
 
 const char *DiagPtr  = "diag";
@@ -57,7 +62,8 @@ enum MOMCmdEnum
   momQuery,
   momReconfig,
   momShutdown,
-  momLayout
+  momLayout,
+  momSnapshot
   };
 
 enum MOMCmdEnum CmdIndex = momNONE;
@@ -67,6 +73,7 @@ enum MOMCmdEnum CmdIndex = momNONE;
 
 void MCShowUsage(const char *);
 int do_mom(char *, int, int);
+int show_mom_snapshot(void);
 
 /* END prototypes */
 
@@ -126,7 +133,7 @@ int main(
   char **ArgV)  /* I */
 
   {
-  const char *OptString = "c:Cd:f:h:lp:q:r:sv";
+  const char *OptString = "c:Cd:f:h:lp:q:r:sSv";
 
   char  HostList[65536];
 
@@ -371,6 +378,14 @@ int main(
 
         break;
 
+      case 'S':
+
+        /* read the local mom's status snapshot */
+
+        CmdIndex = momSnapshot;
+
+        break;
+
       case 'v':
 
         /* report verbose logging */
@@ -386,6 +401,10 @@ int main(
     MCShowUsage("no command specified");
     }
 
+  /* the snapshot is a local file, there is no mom to contact */
+  if (CmdIndex == momSnapshot)
+    exit((show_mom_snapshot() == PBSE_NONE) ? EXIT_SUCCESS : EXIT_FAILURE);
+
   if (HostList[0] == '\0')
     snprintf(HostList, sizeof(HostList), "%s", LocalHost);
 
@@ -949,6 +968,104 @@ do_mom_fail:
 
 
 
+/*
+ * show_mom_snapshot - prints the status snapshot the local mom keeps in
+ * mom_priv, reading it straight from the file
+ *
+ * @return PBSE_NONE on success, -1 if there is no snapshot to read
+ */
+
+int show_mom_snapshot(void)
+
+  {
+  char                 path[1024];
+  const char          *home = getenv("PBSMOMHOME");
+  mom_snapshot_map     map;
+  mom_snapshot_header  hdr;
+  mom_snapshot_job    *jobs = NULL;
+  uint32_t             max_jobs = 0;
+  int                  count;
+  int                  i;
+
+  if (home == NULL)
+    home = PBS_SERVER_HOME;
+
+  snprintf(path, sizeof(path), "%s/mom_priv/%s", home, MOM_SNAPSHOT_FILE);
+
+  if (mom_snapshot_attach(path, &map) != PBSE_NONE)
+    {
+    fprintf(stderr, "ERROR:    cannot read status snapshot %s (%s)\n",
+      path,
+      strerror(errno));
+
+    return(-1);
+    }
+
+  /* size the copy from the header, retrying if jobs arrive in between */
+  while ((count = mom_snapshot_read(&map, &hdr, jobs, max_jobs)) >= 0)
+    {
+    if (hdr.ms_job_count <= max_jobs)
+      break;
+
+    max_jobs = hdr.ms_job_count + 16;
+
+    free(jobs);
+
+    if ((jobs = (mom_snapshot_job *)calloc(max_jobs, sizeof(mom_snapshot_job))) == NULL)
+      {
+      count = -1;
+      break;
+      }
+    }
+
+  mom_snapshot_detach(&map);
+
+  if (count < 0)
+    {
+    fprintf(stderr, "ERROR:    cannot read status snapshot %s (%s)\n",
+      path,
+      strerror(errno));
+
+    free(jobs);
+
+    return(-1);
+    }
+
+  fprintf(stdout, "Host: %s  Pid: %d  Updated: %lld  Polls: %u  State: 0x%x  Cpus: %d  Loadave: %.2f  Jobs: %u\n",
+    hdr.ms_host,
+    hdr.ms_mom_pid,
+    (long long)hdr.ms_updated,
+    hdr.ms_polls,
+    hdr.ms_state,
+    hdr.ms_ncpus,
+    hdr.ms_loadave,
+    hdr.ms_job_count);
+
+  for (i = 0; i < count; i++)
+    {
+    fprintf(stdout, "Job: %s  Owner: %s  State: %d/%d  %s  Nodes: %d  Tasks: %d  Session: %d  cput: %llu  walltime: %llu  mem: %llukb  vmem: %llukb\n",
+      jobs[i].mj_jobid,
+      jobs[i].mj_owner,
+      jobs[i].mj_state,
+      jobs[i].mj_substate,
+      (jobs[i].mj_mother_superior != 0) ? "MS" : "sister",
+      jobs[i].mj_nodes,
+      jobs[i].mj_tasks,
+      jobs[i].mj_session,
+      (unsigned long long)jobs[i].mj_cput,
+      (unsigned long long)jobs[i].mj_walltime,
+      (unsigned long long)jobs[i].mj_mem,
+      (unsigned long long)jobs[i].mj_vmem);
+    }
+
+  free(jobs);
+
+  return(PBSE_NONE);
+  }  /* END show_mom_snapshot() */
+
+
+
+
 void MCShowUsage(
 
   const char *Msg)  /* I (optional) */
@@ -980,9 +1097,11 @@ void MCShowUsage(
 
   fprintf(stderr, "            [ -s ]                // SHUTDOWN\n");
 
+  fprintf(stderr, "            [ -S ]                // PRINT LOCAL STATUS SNAPSHOT\n");
+
   fprintf(stderr, "\n");
 
-  fprintf(stderr, " Only one of c, C, d, q, r, or s must be specified, but -q may\n");
+  fprintf(stderr, " Only one of c, C, d, q, r, s, or S must be specified, but -q may\n");
 
   fprintf(stderr, " be used multiple times. HOST may be a hostname or \":property\".\n");
 
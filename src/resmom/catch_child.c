@@ -1,6 +1,10 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <pbs_config.h>   /* the master config generated by configure */
 #include <sstream>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
 #include "catch_child.h"
 
 #include <sys/types.h>
@@ -52,8 +56,11 @@
 #endif
 #include "mom_config.h"
 #include "json/json.h"
+#include "event_trace.h"
 
 #define DIS_REPLY_READ_RETRY 10
+/* seconds before a server that failed a JobObitBatch is sent batches again */
+#define OBIT_BATCH_RECHECK   3600
 
 
 /* External Functions */
@@ -87,6 +94,7 @@ int release_job_reservation(job *pjob);
 u_long resc_used(job *, const char *, u_long(*f) (resource *));
 void preobit_preparation (job *);
 void *obit_reply (void *);
+void *obit_batch_reply (void *);
 extern u_long addclient (const char *);
 extern void encode_used (job *, int, Json::Value *, tlist_head *);
 extern void encode_flagged_attrs (job *, int, Json::Value *, tlist_head *);
@@ -110,6 +118,11 @@ int send_back_std_and_staged_files(job *pjob, int exit_status);
 
 void exit_mom_job(job *pjob, int mom_radix);
 
+/* jobs whose obits send_pending_obits() will send */
+std::vector<std::string> pending_obits;
+/* when each server last failed a JobObitBatch */
+std::map<std::string, time_t> obit_batch_failed;
+
 /*
  * catch_child() - the signal handler for SIGCHLD.
  *
@@ -421,6 +434,11 @@ void check_jobs_main_process(
     }
 
   log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, "job was terminated");
+
+  trace_event(TRACE_JOB_EXIT,
+    pjob->ji_qs.ji_jobid,
+    trace_elapsed(pjob->ji_qs.ji_stime),
+    pjob->ji_qs.ji_un.ji_momt.ji_exitstat);
     
   mom_radix = pjob->ji_wattr[JOB_ATR_job_radix].at_val.at_long;
 
@@ -532,6 +550,14 @@ void process_tm_obits(
     {
     obitent &pobit = ptask->ti_obits[i];
 
+    if (pobit.oe_batch == true)
+      {
+      /* one of the tasks in a tm_obit_multi() request */
+      tm_batch_obit(pjob, pobit.oe_info.fe_event, ptask);
+
+      continue;
+      }
+
 #ifndef NUMA_SUPPORT
     hnodent *pnode;
 
@@ -1124,13 +1150,49 @@ int run_epilogues(
 
 
 
+/*
+ * fill_job_obit() - fill in the obit for pjob with its exit status and usage
+ */
+
+void fill_job_obit(
+
+  job               *pjob,   /* I */
+  struct rq_jobobit *pobit)  /* O */
+
+  {
+  int resc_access_perm = ATR_DFLAG_RDACC;
+
+  snprintf(pobit->rq_jid, sizeof(pobit->rq_jid), "%s", pjob->ji_qs.ji_jobid);
+
+  if (pjob->ji_job_is_being_rerun == TRUE)
+    {
+    pjob->ji_qs.ji_un.ji_momt.ji_exitstat = 0;
+    }
+
+  pobit->rq_status = pjob->ji_qs.ji_un.ji_momt.ji_exitstat;
+
+  CLEAR_HEAD(pobit->rq_attr);
+
+  if (check_rur == true)
+    {
+    get_energy_used(pjob);
+    }
+  
+  encode_used(pjob, resc_access_perm, NULL, &pobit->rq_attr);
+
+  encode_flagged_attrs(pjob, resc_access_perm, NULL, &pobit->rq_attr);
+
+  encode_complete_req(&pjob->ji_wattr[JOB_ATR_req_information], &pobit->rq_attr, ATTR_req_information, NULL, 0, 0);
+  } /* END fill_job_obit() */
+
+
+
 /**
  * send_job_obit()
- * Send obit to server.
+ * Get the job ready for its obit and queue the obit for send_pending_obits().
  *
  * @see scan_for_terminated() - calls post_epilog() via ji_mompost job pbs_attribute
- * @see mom_open_socket_to_jobs_server() - child
- * @see obit_reply() - registered handler for obit connection
+ * @see send_pending_obits() - sends the queued obits
  *
  * @see scan_for_exiting() for Obit overview
  */
@@ -1141,11 +1203,6 @@ int send_job_obit(
   int  ev)    /* I exit value (COPY_FILE_FAIL means we didn't copy the output files successfully) */
 
   {
-  int                   sock;
-  int                   resc_access_perm;
-  struct batch_request *preq;
-  struct tcp_chan *chan = NULL;
-  
   set_jobs_substate(pjob, JOB_SUBSTATE_OBIT);
 
   pjob->ji_obit_sent = time(NULL);
@@ -1162,7 +1219,31 @@ int send_job_obit(
     pjob->ji_wattr[JOB_ATR_sched_hint].at_val.at_str = strdup("Unable to copy files back - please see the mother superior's log for exact details.");
     }
 
-  /* This is the child code */
+  if (std::find(pending_obits.begin(), pending_obits.end(), pjob->ji_qs.ji_jobid) == pending_obits.end())
+    pending_obits.push_back(pjob->ji_qs.ji_jobid);
+
+  return(0);
+  } /* END send_job_obit() */
+
+
+
+/**
+ * send_single_job_obit()
+ * Send one job's obit to server in a JobObit request.
+ *
+ * @see mom_open_socket_to_jobs_server() - child
+ * @see obit_reply() - registered handler for obit connection
+ */
+
+int send_single_job_obit(
+
+  job *pjob)  /* I */
+
+  {
+  int                   sock;
+  struct batch_request *preq;
+  struct tcp_chan *chan = NULL;
+
   /* open new connection - register obit_reply as handler */
   sock = mom_open_socket_to_jobs_server_with_retries(pjob, __func__, obit_reply, 2);
 
@@ -1189,42 +1270,117 @@ int send_job_obit(
     return(1);
     }
 
-  strcpy(preq->rq_ind.rq_jobobit.rq_jid, pjob->ji_qs.ji_jobid);
+  fill_job_obit(pjob, &preq->rq_ind.rq_jobobit);
 
-  if (pjob->ji_job_is_being_rerun == TRUE)
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
     {
-    pjob->ji_qs.ji_un.ji_momt.ji_exitstat = 0;
     }
+  else if (encode_DIS_ReqHdr(chan, PBS_BATCH_JobObit, pbs_current_user) ||
+           encode_DIS_JobObit(chan, preq) ||
+           encode_DIS_ReqExtend(chan, 0))
+    {
+    /* FAILURE */
 
-  preq->rq_ind.rq_jobobit.rq_status = pjob->ji_qs.ji_un.ji_momt.ji_exitstat;
+    sprintf(log_buffer, 
+      "cannot create obit message for job %s",
+      pjob->ji_qs.ji_jobid);
 
-  CLEAR_HEAD(preq->rq_ind.rq_jobobit.rq_attr);
+    log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, __func__, log_buffer);
 
-  resc_access_perm = ATR_DFLAG_RDACC;
+    close_conn(chan->sock, FALSE);
+    DIS_tcp_cleanup(chan);
+    free_br(preq);
+    return(1);
+    }
 
-  if (check_rur == true)
+  if (chan != NULL)
     {
-    get_energy_used(pjob);
+    DIS_tcp_wflush(chan);
+    DIS_tcp_cleanup(chan);
+    pjob->ji_obit_sent = time(NULL);
     }
-  
-  encode_used(pjob, resc_access_perm, NULL, &preq->rq_ind.rq_jobobit.rq_attr);
 
-  encode_flagged_attrs(pjob, resc_access_perm, NULL, &preq->rq_ind.rq_jobobit.rq_attr);
+  free_br(preq);
+  /* SUCCESS */
+
+  /* FYI: socket gets closed and pjob->ji_momhandle is unset in obit_reply, the reply handler */
+
+  log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, "obit sent to server");
+
+  return(0);
+  } /* END send_single_job_obit() */
+
+
+
+/**
+ * send_job_obit_batch()
+ * Send the obits of jobs[first] through jobs[last - 1], which all belong to
+ * the same server, in one JobObitBatch request.
+ *
+ * @see obit_batch_reply() - registered handler for the connection
+ */
+
+int send_job_obit_batch(
+
+  std::vector<job *> &jobs,   /* I */
+  size_t              first,  /* I */
+  size_t              last)   /* I */
+
+  {
+  int                      sock;
+  size_t                   i;
+  struct batch_request    *preq;
+  struct rq_jobobit_batch *pbatch = NULL;
+  struct tcp_chan         *chan = NULL;
+
+  sock = mom_open_socket_to_jobs_server_with_retries(jobs[first], __func__, obit_batch_reply, 2);
 
-  encode_complete_req(&pjob->ji_wattr[JOB_ATR_req_information], &preq->rq_ind.rq_jobobit.rq_attr, ATTR_req_information, NULL, 0, 0);
+  if (sock < 0)
+    {
+    // jobs stuck in JOB_SUBSTATE_OBIT are retried
+    return(1);
+    }
+
+  if ((preq = alloc_br(PBS_BATCH_JobObitBatch)) != NULL)
+    {
+    pbatch = &preq->rq_ind.rq_jobobit_batch;
+    pbatch->rq_obits = (struct rq_jobobit *)calloc(last - first, sizeof(struct rq_jobobit));
+    }
+
+  if ((preq == NULL) ||
+      (pbatch->rq_obits == NULL))
+    {
+    /* FAILURE */
+
+    sprintf(log_buffer, "cannot allocate memory for obit message");
+
+    log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, __func__, log_buffer);
+
+    if (preq != NULL)
+      free_br(preq);
+
+    close_conn(sock, FALSE);
+
+    return(1);
+    }
+
+  for (i = first; i < last; i++)
+    {
+    fill_job_obit(jobs[i], &pbatch->rq_obits[pbatch->rq_count++]);
+
+    jobs[i]->ji_momhandle = sock;
+    }
 
   if ((chan = DIS_tcp_setup(sock)) == NULL)
     {
     }
-  else if (encode_DIS_ReqHdr(chan, PBS_BATCH_JobObit, pbs_current_user) ||
-           encode_DIS_JobObit(chan, preq) ||
+  else if (encode_DIS_ReqHdr(chan, PBS_BATCH_JobObitBatch, pbs_current_user) ||
+           encode_DIS_JobObitBatch(chan, preq) ||
            encode_DIS_ReqExtend(chan, 0))
     {
     /* FAILURE */
 
-    sprintf(log_buffer, 
-      "cannot create obit message for job %s",
-      pjob->ji_qs.ji_jobid);
+    sprintf(log_buffer, "cannot create obit message for %d jobs", pbatch->rq_count);
 
     log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, __func__, log_buffer);
 
@@ -1238,18 +1394,77 @@ int send_job_obit(
     {
     DIS_tcp_wflush(chan);
     DIS_tcp_cleanup(chan);
-    pjob->ji_obit_sent = time(NULL);
+
+    for (i = first; i < last; i++)
+      {
+      jobs[i]->ji_obit_sent = time(NULL);
+
+      log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, jobs[i]->ji_qs.ji_jobid, "obit sent to server");
+      }
     }
 
   free_br(preq);
-  /* SUCCESS */
 
-  /* FYI: socket gets closed and pjob->ji_momhandle is unset in obit_reply, the reply handler */
+  return(0);
+  } /* END send_job_obit_batch() */
 
-  log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, "obit sent to server");
 
-  return(0);
-  } /* END send_job_obit() */
+
+/**
+ * send_pending_obits()
+ * Send the obits queued by send_job_obit() since the last call. Obits for
+ * the same server go out together in JobObitBatch requests of up to
+ * PBS_MAX_OBIT_BATCH jobs; a lone obit, or one for a server that recently
+ * failed a JobObitBatch, is sent on its own.
+ *
+ * @see main_loop() - parent
+ */
+
+void send_pending_obits(void)
+
+  {
+  std::map<std::string, std::vector<job *> >           by_server;
+  std::map<std::string, std::vector<job *> >::iterator it;
+
+  if (pending_obits.size() == 0)
+    return;
+
+  for (size_t i = 0; i < pending_obits.size(); i++)
+    {
+    job        *pjob = mom_find_job(pending_obits[i].c_str());
+    const char *server;
+
+    // the job may have been purged or moved on since its obit was queued
+    if ((pjob == NULL) ||
+        (pjob->ji_qs.ji_substate != JOB_SUBSTATE_OBIT))
+      continue;
+
+    server = pjob->ji_wattr[JOB_ATR_at_server].at_val.at_str;
+
+    by_server[(server != NULL) ? server : ""].push_back(pjob);
+    }
+
+  pending_obits.clear();
+
+  for (it = by_server.begin(); it != by_server.end(); it++)
+    {
+    std::vector<job *>                     &jobs = it->second;
+    std::map<std::string, time_t>::iterator failed = obit_batch_failed.find(it->first);
+
+    if ((jobs.size() == 1) ||
+        ((failed != obit_batch_failed.end()) &&
+         (time(NULL) - failed->second < OBIT_BATCH_RECHECK)))
+      {
+      for (size_t i = 0; i < jobs.size(); i++)
+        send_single_job_obit(jobs[i]);
+
+      continue;
+      }
+
+    for (size_t first = 0; first < jobs.size(); first += PBS_MAX_OBIT_BATCH)
+      send_job_obit_batch(jobs, first, std::min(jobs.size(), first + PBS_MAX_OBIT_BATCH));
+    }
+  } /* END send_pending_obits() */
 
 
 
@@ -1334,21 +1549,20 @@ void preobit_preparation(
 
 
 /*
- * process_jobs_obit_reply()
+ * process_obit_reply_code()
  *
- * Processes the reply to this job's obituary which we received from the server
+ * Acts on the code the server answered this job's obituary with
  * @param pjob - the job in question
- * @param preq - the reply information
- * @return - the return code from pbs server
+ * @param rc - the server's code for this job's obit
+ * @return - rc
  */
 
-int process_jobs_obit_reply(
+int process_obit_reply_code(
 
   job *pjob,
-  batch_request *preq)
+  int  rc)
 
   {
-  int          rc = preq->rq_reply.brp_code;
   char         tmp_line[MAXLINE];
 
   // Make sure we have cleared a previous busy reply from the server.
@@ -1420,7 +1634,7 @@ int process_jobs_obit_reply(
       {
       // Random other cases, also delete
 
-      switch (preq->rq_reply.brp_code)
+      switch (rc)
         {
 
         case PBSE_BADSTATE:
@@ -1438,10 +1652,10 @@ int process_jobs_obit_reply(
         default:
 
           sprintf(tmp_line, "server rejected job obit - %d",
-                  preq->rq_reply.brp_code);
+                  rc);
 
           break;
-        }  /* END switch (preq->rq_reply.brp_code) */
+        }  /* END switch (rc) */
 
       log_ext(-1,__func__,tmp_line,LOG_ALERT);
 
@@ -1451,9 +1665,29 @@ int process_jobs_obit_reply(
 
       break;
       }  /* END BLOCK */
-    }  /* END switch (preq->rq_reply.brp_code) */
+    }  /* END switch (rc) */
 
   return(rc);
+  } // END process_obit_reply_code()
+
+
+
+/*
+ * process_jobs_obit_reply()
+ *
+ * Processes the reply to this job's obituary which we received from the server
+ * @param pjob - the job in question
+ * @param preq - the reply information
+ * @return - the return code from pbs server
+ */
+
+int process_jobs_obit_reply(
+
+  job *pjob,
+  batch_request *preq)
+
+  {
+  return(process_obit_reply_code(pjob, preq->rq_reply.brp_code));
   } // END process_jobs_obit_reply()
 
 
@@ -1575,6 +1809,128 @@ void *obit_reply(
 
 
 
+/*
+ * obit_batch_reply
+ *
+ * The message handler for a connection opened by send_job_obit_batch().
+ * The server answers a JobObitBatch with a text reply holding one
+ * "<jobid> <code>" line per obit, and each job's code is handled as
+ * obit_reply() would handle it. Jobs the reply leaves out are retried.
+ * A server that does not know the request closes the connection without
+ * a reply, so if no reply can be read the obits are sent again one at a
+ * time and that server is not sent batches for OBIT_BATCH_RECHECK seconds.
+ */
+
+void *obit_batch_reply(
+
+  void *new_sock)  /* I */
+
+  {
+  int                        irtn;
+  batch_request             *preq;
+  int                        sock = *(int *)new_sock;
+  struct tcp_chan           *chan = NULL;
+  int                        count = 0;
+  bool                       deleted_one = false;
+  std::vector<job *>         jobs;
+  std::map<std::string, int> codes;
+
+  if ((preq = alloc_br(PBS_BATCH_JobObitBatch)) == NULL)
+    return(NULL);
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    free_br(preq);
+    return(NULL);
+    }
+
+  /* make sure errno isn't stale */
+  errno = 0;
+
+  while ((irtn = DIS_reply_read(chan, &preq->rq_reply)) &&
+         (errno == EINTR) &&
+         (count < DIS_REPLY_READ_RETRY))
+    count++;
+
+  DIS_tcp_cleanup(chan);
+
+  if (irtn != 0)
+    {
+    sprintf(log_buffer, "DIS_reply_read failed, rc=%d sock=%d",
+            irtn,
+            sock);
+
+    log_err(errno, __func__, log_buffer);
+
+    preq->rq_reply.brp_code = -1;
+    }
+  else if ((preq->rq_reply.brp_code == PBSE_NONE) &&
+           (preq->rq_reply.brp_choice == BATCH_REPLY_CHOICE_Text) &&
+           (preq->rq_reply.brp_un.brp_txt.brp_str != NULL))
+    {
+    std::istringstream results(preq->rq_reply.brp_un.brp_txt.brp_str);
+    std::string        jobid;
+    int                code;
+
+    while (results >> jobid >> code)
+      codes[jobid] = code;
+    }
+
+  /* the jobs in the batch all had their ji_momhandle set to this socket */
+  for (std::list<job *>::iterator iter = alljobs_list.begin(); iter != alljobs_list.end(); iter++)
+    {
+    if ((*iter)->ji_momhandle == sock)
+      jobs.push_back(*iter);
+    }
+
+  for (size_t i = 0; i < jobs.size(); i++)
+    {
+    job *pjob = jobs[i];
+    int  rc = preq->rq_reply.brp_code;
+
+    pjob->ji_momhandle = -1;
+
+    if ((irtn != 0) ||
+        (rc == PBSE_UNKREQ))
+      {
+      const char *server = pjob->ji_wattr[JOB_ATR_at_server].at_val.at_str;
+
+      obit_batch_failed[(server != NULL) ? server : ""] = time(NULL);
+
+      send_single_job_obit(pjob);
+      continue;
+      }
+
+    if (rc == PBSE_NONE)
+      {
+      std::map<std::string, int>::iterator found = codes.find(pjob->ji_qs.ji_jobid);
+
+      rc = (found != codes.end()) ? found->second : -1;
+      }
+
+    if (process_obit_reply_code(pjob, rc) != PBSE_SERVER_BUSY)
+      deleted_one = true;
+    }
+
+  free_br(preq);
+
+  pbs_disconnect_socket(sock);
+  /* pbs_disconnect_socket has closed our socket, see obit_reply() */
+  clear_conn(sock, false);
+
+  if ((deleted_one == true) &&
+      (PBSNodeCheckEpilog))
+    {
+    check_state(1);
+
+    mom_server_all_update_stat();
+    }
+
+  return(NULL);
+  }  /* END obit_batch_reply() */
+
+
+
 
 int has_exec_host_and_port(
 
@@ -20,6 +20,12 @@ void *preobit_reply(void *new_sock);
 
 void *obit_reply(void *new_sock);
 
+void *obit_batch_reply(void *new_sock);
+
+int send_single_job_obit(job *pjob);
+
+void send_pending_obits(void);
+
 int has_exec_host_and_port(job *pjob);
 
 void init_abort_jobs(int recover);
@@ -0,0 +1,1219 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+/*
+ * file_copy.c - in-process replacement for "cp -rp", used by MOM to deliver
+ * output and staged files whose destination is local or NFS mounted.
+ *
+ * File data is moved with copy_file_range() where the kernel supports it,
+ * then sendfile(), then read()/write().  Modes and timestamps are preserved
+ * and ownership is kept where permitted, the same way cp -p does it.
+ *
+ * copy_files_in_parallel() spreads a request's copies over a few worker
+ * processes.
+ * It can pace them to a bandwidth per request and per node slot, and it can
+ * limit the copies in flight on the whole node.  Node slots are byte-range
+ * locks on a file in mom_priv, so they are released when a copy process dies.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
+
+#include "pbs_error.h"
+#include "file_copy.h"
+
+#define COPY_CHUNK_SIZE   (8 * 1024 * 1024) /* bytes per copy_file_range() or sendfile() call */
+#define COPY_BUFFER_SIZE  (64 * 1024)       /* bytes per read() when neither can be used */
+#define COPY_PACED_CHUNK  (1024 * 1024)     /* bytes per call when a bandwidth is set */
+#define COPY_SLOT_POLL_USEC 50000         /* wait between looks for a free node slot */
+
+/* what one copy is counted against */
+typedef struct copy_context
+  {
+  copy_stats   *cx_stats;
+  rate_limiter *cx_request_rate;  /* NULL if unlimited */
+  rate_limiter *cx_slot_rate;     /* NULL if unlimited */
+  bool          cx_sync;
+  } copy_context;
+
+/* sent back to copy_files_in_parallel() by a copy worker for each task */
+typedef struct copy_result
+  {
+  int        cr_worker;
+  size_t     cr_index;
+  int        cr_rc;
+  copy_stats cr_stats;
+  char       cr_err[1024];
+  } copy_result;
+
+
+int copy_path(const std::string &src, const std::string &target, copy_context *ctx, std::string &err);
+
+
+
+static double copy_clock()
+
+  {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return(ts.tv_sec + ts.tv_nsec / 1000000000.0);
+  } /* END copy_clock() */
+
+
+
+void init_rate_limiter(
+
+  rate_limiter *rl,
+  double        rate)
+
+  {
+  pthread_mutex_init(&rl->rl_mutex, NULL);
+  rl->rl_rate = rate;
+  rl->rl_next = 0.0;
+  } /* END init_rate_limiter() */
+
+
+
+/*
+ * throttle_copy()
+ *
+ * Books bytes against rl and sleeps until they may be sent.  Each caller
+ * reserves the next slice of time, so callers sharing rl add up to its rate.
+ */
+
+void throttle_copy(
+
+  rate_limiter *rl,
+  size_t        bytes)
+
+  {
+  double now;
+  double wait;
+
+  if ((rl == NULL) ||
+      (rl->rl_rate <= 0.0))
+    return;
+
+  pthread_mutex_lock(&rl->rl_mutex);
+
+  now = copy_clock();
+
+  if (rl->rl_next < now)
+    rl->rl_next = now;
+
+  wait = rl->rl_next - now;
+  rl->rl_next += bytes / rl->rl_rate;
+
+  pthread_mutex_unlock(&rl->rl_mutex);
+
+  if (wait > 0.0)
+    {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)wait;
+    ts.tv_nsec = (long)((wait - ts.tv_sec) * 1000000000.0);
+
+    while ((nanosleep(&ts, &ts) != 0) &&
+           (errno == EINTR))
+      /* NO-OP, sleep the rest */;
+    }
+  } /* END throttle_copy() */
+
+
+
+/*
+ * pace_copy()
+ *
+ * @return how many bytes the next call may move, after waiting for them
+ */
+
+static size_t pace_copy(
+
+  copy_context *ctx,
+  size_t        chunk)
+
+  {
+  if ((ctx->cx_request_rate == NULL) &&
+      (ctx->cx_slot_rate == NULL))
+    return(chunk);
+
+  if (chunk > COPY_PACED_CHUNK)
+    chunk = COPY_PACED_CHUNK;
+
+  throttle_copy(ctx->cx_request_rate, chunk);
+  throttle_copy(ctx->cx_slot_rate, chunk);
+
+  return(chunk);
+  } /* END pace_copy() */
+
+
+
+/*
+ * set_copy_error()
+ *
+ * Describes which path failed and why
+ * @return the errno value, to be passed back up
+ */
+
+static int set_copy_error(
+
+  const std::string &path,
+  const char        *action,
+  int                error,
+  std::string       &err)
+
+  {
+  err = action;
+  err += " ";
+  err += path;
+  err += ": ";
+  err += strerror(error);
+
+  return(error);
+  } /* END set_copy_error() */
+
+
+
+/*
+ * use_next_copy_method()
+ *
+ * @return true if errno from copy_file_range() or sendfile() only means the
+ * call can't be used for this pair of files
+ */
+
+static bool use_next_copy_method(
+
+  int error)
+
+  {
+  return((error == EXDEV) ||
+         (error == EINVAL) ||
+         (error == ENOSYS) ||
+         (error == EOPNOTSUPP) ||
+         (error == EBADF));
+  } /* END use_next_copy_method() */
+
+
+
+/*
+ * chown_failure_ok()
+ *
+ * cp -p keeps going when it isn't allowed to give away a file
+ */
+
+static bool chown_failure_ok(
+
+  int error)
+
+  {
+  return((error == EPERM) ||
+         (error == EINVAL));
+  } /* END chown_failure_ok() */
+
+
+
+/*
+ * copy_data()
+ *
+ * Copies everything from the current offset of in_fd to out_fd.  Each method
+ * continues from the offsets the previous one left behind, so falling back
+ * part way through a file is safe.
+ *
+ * @param in_fd - the source file
+ * @param out_fd - the destination file
+ * @param size - the size of the source when it was opened
+ * @param ctx - the limits to pace the copy to
+ * @param bytes - incremented by the number of bytes copied
+ * @return PBSE_NONE or the errno value of the call that failed
+ */
+
+static int copy_data(
+
+  int                 in_fd,
+  int                 out_fd,
+  off_t               size,
+  copy_context       *ctx,
+  unsigned long long *bytes)
+
+  {
+  ssize_t rc;
+  char    buf[COPY_BUFFER_SIZE];
+
+#ifdef HAVE_COPY_FILE_RANGE
+  unsigned long long start = *bytes;
+
+  while ((rc = copy_file_range(in_fd, NULL, out_fd, NULL, pace_copy(ctx, COPY_CHUNK_SIZE), 0)) != 0)
+    {
+    if (rc > 0)
+      {
+      *bytes += rc;
+      continue;
+      }
+
+    if (errno == EINTR)
+      continue;
+
+    if (use_next_copy_method(errno) == false)
+      return(errno);
+
+    break;
+    }
+
+  /* some file systems report 0 instead of an error, so only trust it at the size we expect */
+  if ((rc == 0) &&
+      ((off_t)(*bytes - start) >= size))
+    return(PBSE_NONE);
+#endif /* HAVE_COPY_FILE_RANGE */
+
+#ifdef HAVE_SENDFILE
+  while ((rc = sendfile(out_fd, in_fd, NULL, pace_copy(ctx, COPY_CHUNK_SIZE))) != 0)
+    {
+    if (rc > 0)
+      {
+      *bytes += rc;
+      continue;
+      }
+
+    if (errno == EINTR)
+      continue;
+
+    if (use_next_copy_method(errno) == false)
+      return(errno);
+
+    break;
+    }
+
+  if (rc == 0)
+    return(PBSE_NONE);
+#endif /* HAVE_SENDFILE */
+
+  while ((rc = read(in_fd, buf, pace_copy(ctx, sizeof(buf)))) != 0)
+    {
+    char    *ptr = buf;
+    ssize_t  left = rc;
+
+    if (rc < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      return(errno);
+      }
+
+    while (left > 0)
+      {
+      ssize_t written = write(out_fd, ptr, left);
+
+      if (written < 0)
+        {
+        if (errno == EINTR)
+          continue;
+
+        return(errno);
+        }
+
+      ptr  += written;
+      left -= written;
+      }
+
+    *bytes += rc;
+    }
+
+  return(PBSE_NONE);
+  } /* END copy_data() */
+
+
+
+/*
+ * preserve_attributes()
+ *
+ * Gives the copy open on fd the ownership, mode and times of the source. As
+ * with cp -p, the set-id bits are dropped if the owner can't be kept.
+ */
+
+static int preserve_attributes(
+
+  int                fd,
+  const std::string &target,
+  struct stat       *st,
+  std::string       &err)
+
+  {
+  mode_t          mode = st->st_mode & 07777;
+  struct timespec times[2];
+
+  if (fchown(fd, st->st_uid, st->st_gid) != 0)
+    {
+    if (chown_failure_ok(errno) == false)
+      return(set_copy_error(target, "cannot preserve ownership of", errno, err));
+
+    mode &= ~(S_ISUID | S_ISGID);
+    }
+
+  if (fchmod(fd, mode) != 0)
+    return(set_copy_error(target, "cannot preserve permissions of", errno, err));
+
+  times[0] = st->st_atim;
+  times[1] = st->st_mtim;
+
+  if (futimens(fd, times) != 0)
+    return(set_copy_error(target, "cannot preserve times of", errno, err));
+
+  return(PBSE_NONE);
+  } /* END preserve_attributes() */
+
+
+
+static int copy_regular_file(
+
+  const std::string &src,
+  const std::string &target,
+  struct stat       *st,
+  copy_context      *ctx,
+  std::string       &err)
+
+  {
+  int                in_fd;
+  int                out_fd;
+  int                rc;
+  unsigned long long bytes = 0;
+
+  if ((in_fd = open(src.c_str(), O_RDONLY)) < 0)
+    return(set_copy_error(src, "cannot open", errno, err));
+
+  if ((out_fd = open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, st->st_mode & 0777)) < 0)
+    {
+    rc = set_copy_error(target, "cannot create", errno, err);
+
+    close(in_fd);
+
+    return(rc);
+    }
+
+  if ((rc = copy_data(in_fd, out_fd, st->st_size, ctx, &bytes)) != PBSE_NONE)
+    set_copy_error(target, "error writing", rc, err);
+  else if (((rc = preserve_attributes(out_fd, target, st, err)) == PBSE_NONE) &&
+           (ctx->cx_sync == true) &&
+           (fsync(out_fd) != 0))
+    rc = set_copy_error(target, "cannot sync", errno, err);
+
+  close(in_fd);
+
+  /* NFS may not report a failed write until close */
+  if ((close(out_fd) != 0) &&
+      (rc == PBSE_NONE))
+    rc = set_copy_error(target, "error closing", errno, err);
+
+  ctx->cx_stats->cs_bytes += bytes;
+
+  if (rc == PBSE_NONE)
+    ctx->cx_stats->cs_files++;
+
+  return(rc);
+  } /* END copy_regular_file() */
+
+
+
+/*
+ * copy_symlink()
+ *
+ * Recreates the link itself, cp -r does not follow links
+ */
+
+static int copy_symlink(
+
+  const std::string &src,
+  const std::string &target,
+  struct stat       *st,
+  std::string       &err)
+
+  {
+  char            link_value[PATH_MAX + 1];
+  ssize_t         len;
+  struct timespec times[2];
+
+  if ((len = readlink(src.c_str(), link_value, sizeof(link_value) - 1)) < 0)
+    return(set_copy_error(src, "cannot read link", errno, err));
+
+  link_value[len] = '\0';
+
+  if (symlink(link_value, target.c_str()) != 0)
+    {
+    if ((errno != EEXIST) ||
+        (unlink(target.c_str()) != 0) ||
+        (symlink(link_value, target.c_str()) != 0))
+      return(set_copy_error(target, "cannot create link", errno, err));
+    }
+
+  if ((lchown(target.c_str(), st->st_uid, st->st_gid) != 0) &&
+      (chown_failure_ok(errno) == false))
+    return(set_copy_error(target, "cannot preserve ownership of", errno, err));
+
+  times[0] = st->st_atim;
+  times[1] = st->st_mtim;
+
+  if (utimensat(AT_FDCWD, target.c_str(), times, AT_SYMLINK_NOFOLLOW) != 0)
+    return(set_copy_error(target, "cannot preserve times of", errno, err));
+
+  return(PBSE_NONE);
+  } /* END copy_symlink() */
+
+
+
+/*
+ * copy_directory()
+ *
+ * Copies src into target, creating target or merging into it if it is
+ * already a directory.  The attributes are applied after the contents so
+ * the source's times survive and a read-only source directory can be filled.
+ */
+
+static int copy_directory(
+
+  const std::string &src,
+  const std::string &target,
+  struct stat       *st,
+  copy_context      *ctx,
+  std::string       &err)
+
+  {
+  DIR           *dp;
+  struct dirent *pdirent;
+  struct stat    target_st;
+  int            fd;
+  int            rc = PBSE_NONE;
+
+  if (mkdir(target.c_str(), (st->st_mode & 0777) | S_IRWXU) != 0)
+    {
+    int error = errno;
+
+    if ((error != EEXIST) ||
+        (stat(target.c_str(), &target_st) != 0) ||
+        (!S_ISDIR(target_st.st_mode)))
+      return(set_copy_error(target, "cannot create directory", (error == EEXIST) ? ENOTDIR : error, err));
+    }
+
+  if ((dp = opendir(src.c_str())) == NULL)
+    return(set_copy_error(src, "cannot open directory", errno, err));
+
+  while ((pdirent = readdir(dp)) != NULL)
+    {
+    if ((!strcmp(pdirent->d_name, ".")) ||
+        (!strcmp(pdirent->d_name, "..")))
+      continue;
+
+    if ((rc = copy_path(src + "/" + pdirent->d_name, target + "/" + pdirent->d_name, ctx, err)) != PBSE_NONE)
+      break;
+    }
+
+  closedir(dp);
+
+  if (rc != PBSE_NONE)
+    return(rc);
+
+  if ((fd = open(target.c_str(), O_RDONLY | O_DIRECTORY)) < 0)
+    return(set_copy_error(target, "cannot open directory", errno, err));
+
+  rc = preserve_attributes(fd, target, st, err);
+
+  close(fd);
+
+  if (rc == PBSE_NONE)
+    ctx->cx_stats->cs_dirs++;
+
+  return(rc);
+  } /* END copy_directory() */
+
+
+
+/*
+ * copy_path()
+ *
+ * Copies src to exactly target, whatever src is
+ * @return PBSE_NONE, an errno value, or COPY_UNSUPPORTED for fifos, sockets
+ * and devices, which are left to /bin/cp
+ */
+
+int copy_path(
+
+  const std::string &src,
+  const std::string &target,
+  copy_context      *ctx,
+  std::string       &err)
+
+  {
+  struct stat st;
+
+  if (lstat(src.c_str(), &st) != 0)
+    return(set_copy_error(src, "cannot stat", errno, err));
+
+  if (S_ISREG(st.st_mode))
+    return(copy_regular_file(src, target, &st, ctx, err));
+
+  if (S_ISDIR(st.st_mode))
+    return(copy_directory(src, target, &st, ctx, err));
+
+  if (S_ISLNK(st.st_mode))
+    return(copy_symlink(src, target, &st, err));
+
+  err = "unsupported file type ";
+  err += src;
+
+  return(COPY_UNSUPPORTED);
+  } /* END copy_path() */
+
+
+
+/*
+ * copy_target()
+ *
+ * @return the path that copying src to dest creates - dest itself, or
+ * dest/<last component of src> when dest is an existing directory
+ */
+
+std::string copy_target(
+
+  const char *src,
+  const char *dest)
+
+  {
+  std::string target(dest);
+  struct stat st;
+
+  if ((stat(dest, &st) == 0) &&
+      (S_ISDIR(st.st_mode)))
+    {
+    std::string base(src);
+    size_t      pos;
+
+    while ((base.size() > 1) &&
+           (base[base.size() - 1] == '/'))
+      base.erase(base.size() - 1);
+
+    if ((pos = base.rfind('/')) != std::string::npos)
+      base.erase(0, pos + 1);
+
+    if ((target.size() == 0) ||
+        (target[target.size() - 1] != '/'))
+      target += "/";
+
+    target += base;
+    }
+
+  return(target);
+  } /* END copy_target() */
+
+
+
+/*
+ * local_copy()
+ *
+ * Does what "cp -rp src dest" does, without the fork and exec
+ *
+ * @param src - the file, directory or link to copy
+ * @param dest - the destination path or an existing directory to copy into
+ * @param stats - incremented with what was copied
+ * @param err - set to the path and reason when the copy fails
+ * @return PBSE_NONE, the errno value of the failure, or COPY_UNSUPPORTED
+ */
+
+int local_copy(
+
+  const char  *src,
+  const char  *dest,
+  copy_stats  *stats,
+  std::string &err)
+
+  {
+  copy_context ctx;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.cx_stats = stats;
+
+  err.clear();
+
+  return(copy_path(src, copy_target(src, dest), &ctx, err));
+  } /* END local_copy() */
+
+
+
+void init_copy_limits(
+
+  copy_limits *limits)
+
+  {
+  memset(limits, 0, sizeof(copy_limits));
+
+  limits->cl_workers = 1;
+  } /* END init_copy_limits() */
+
+
+
+/*
+ * acquire_node_slot()
+ *
+ * Takes one of the node's copy slots by locking its byte in the slot file,
+ * polling until one is free.  The locks belong to the open file description,
+ * so each worker needs its own fd.
+ *
+ * @return the slot taken, or -1 if the node isn't limited or the lock can't work
+ */
+
+static int acquire_node_slot(
+
+  int fd,
+  int slots,
+  int preferred)
+
+  {
+#ifdef F_OFD_SETLK
+  struct flock fl;
+
+  if ((fd < 0) ||
+      (slots <= 0))
+    return(-1);
+
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type = F_WRLCK;
+  fl.l_whence = SEEK_SET;
+  fl.l_len = 1;
+
+  while (true)
+    {
+    for (int i = 0; i < slots; i++)
+      {
+      fl.l_start = (preferred + i) % slots;
+
+      if (fcntl(fd, F_OFD_SETLK, &fl) == 0)
+        return(fl.l_start);
+
+      if ((errno != EAGAIN) &&
+          (errno != EACCES) &&
+          (errno != EINTR))
+        return(-1);
+      }
+
+    usleep(COPY_SLOT_POLL_USEC);
+    }
+#else
+  return(-1);
+#endif /* F_OFD_SETLK */
+  } /* END acquire_node_slot() */
+
+
+
+static void release_node_slot(
+
+  int fd,
+  int slot)
+
+  {
+#ifdef F_OFD_SETLK
+  struct flock fl;
+
+  if (slot < 0)
+    return;
+
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type = F_UNLCK;
+  fl.l_whence = SEEK_SET;
+  fl.l_start = slot;
+  fl.l_len = 1;
+
+  fcntl(fd, F_OFD_SETLK, &fl);
+#endif /* F_OFD_SETLK */
+  } /* END release_node_slot() */
+
+
+
+/*
+ * copy_one_task()
+ *
+ * Makes one task's copy within the node's copy slots.
+ * @return the task's ct_rc
+ */
+
+static int copy_one_task(
+
+  copy_task    &task,
+  copy_limits  *limits,
+  rate_limiter *request_rate,
+  rate_limiter *slot_rate,
+  int           slot_fd,
+  int           preferred_slot,
+  copy_stats   *task_stats,
+  std::string  &err)
+
+  {
+  copy_context ctx;
+  int          slot;
+  int          rc;
+
+  slot = acquire_node_slot(slot_fd, limits->cl_node_slots, preferred_slot);
+
+  ctx.cx_stats = task_stats;
+  ctx.cx_request_rate = (request_rate->rl_rate > 0.0) ? request_rate : NULL;
+  ctx.cx_slot_rate = ((slot >= 0) && (slot_rate->rl_rate > 0.0)) ? slot_rate : NULL;
+  ctx.cx_sync = limits->cl_sync;
+
+  err.clear();
+  rc = copy_path(task.ct_src, copy_target(task.ct_src.c_str(), task.ct_dest.c_str()), &ctx, err);
+
+  release_node_slot(slot_fd, slot);
+
+  return(rc);
+  } /* END copy_one_task() */
+
+
+
+/*
+ * copy_worker()
+ *
+ * The body of a copy worker process.  Copies the task whose index is read
+ * from task_fd and writes a copy_result to result_fd, until task_fd is closed.
+ */
+
+static void copy_worker(
+
+  std::vector<copy_task> &tasks,
+  copy_limits            *limits,
+  rate_limiter           *request_rate,
+  int                     index,
+  int                     task_fd,
+  int                     result_fd)
+
+  {
+  rate_limiter slot_rate;
+  int          slot_fd = -1;
+  size_t       task_index;
+
+  if (index < limits->cl_slot_fd_count)
+    slot_fd = limits->cl_slot_fds[index];
+
+  init_rate_limiter(&slot_rate, limits->cl_slot_bandwidth);
+
+  while (read(task_fd, &task_index, sizeof(task_index)) == sizeof(task_index))
+    {
+    copy_result result;
+    std::string err;
+
+    if (task_index >= tasks.size())
+      break;
+
+    memset(&result, 0, sizeof(result));
+
+    result.cr_worker = index;
+    result.cr_index = task_index;
+    result.cr_rc = copy_one_task(tasks[task_index], limits, request_rate, &slot_rate, slot_fd, index, &result.cr_stats, err);
+    snprintf(result.cr_err, sizeof(result.cr_err), "%s", err.c_str());
+
+    /* smaller than PIPE_BUF, so the workers' results don't interleave */
+    if (write(result_fd, &result, sizeof(result)) != sizeof(result))
+      break;
+    }
+  } /* END copy_worker() */
+
+
+
+/*
+ * send_copy_task()
+ *
+ * @return true if the worker reading task_fd was given the task
+ */
+
+static bool send_copy_task(
+
+  int    task_fd,
+  size_t task_index)
+
+  {
+  return(send(task_fd, &task_index, sizeof(task_index), MSG_NOSIGNAL) == sizeof(task_index));
+  } /* END send_copy_task() */
+
+
+
+/*
+ * copy_files_in_parallel()
+ *
+ * Runs the tasks on up to limits->cl_workers worker processes, fewer if the
+ * node is limited and there aren't as many slot fds.  Processes are used
+ * rather than threads because MOM calls this in a child forked from a
+ * threaded process.  Tasks are handed out in order, and once one fails no
+ * more are started; those left have ct_rc set to COPY_SKIPPED.  The calling
+ * process waits and reports progress through limits->cl_progress every
+ * cl_progress_interval seconds.  The tasks must not share a copy_target().
+ *
+ * @return the number of tasks that failed
+ */
+
+int copy_files_in_parallel(
+
+  std::vector<copy_task> &tasks,
+  copy_limits            *limits,
+  copy_stats             *stats)
+
+  {
+  std::vector<pid_t>   pids;
+  std::vector<int>     task_fds;
+  std::vector<long>    busy;        /* the task each worker is copying, or -1 */
+  rate_limiter        *request_rate;
+  pthread_mutexattr_t  attr;
+  int                  result_pipe[2];
+  int                  workers = limits->cl_workers;
+  int                  in_flight = 0;
+  int                  failed = 0;
+  size_t               next = 0;
+  size_t               done = 0;
+  bool                 stop = false;
+  double               next_report = 0.0;
+
+  for (size_t i = 0; i < tasks.size(); i++)
+    {
+    tasks[i].ct_rc = COPY_SKIPPED;
+    tasks[i].ct_err.clear();
+    }
+
+  if ((limits->cl_node_slots > 0) &&
+      (limits->cl_slot_fd_count > 0) &&
+      (workers > limits->cl_slot_fd_count))
+    workers = limits->cl_slot_fd_count;
+
+  if (workers > (int)tasks.size())
+    workers = tasks.size();
+
+  if (workers < 1)
+    workers = 1;
+
+  /* the request's bandwidth is shared by all of its workers */
+  request_rate = (rate_limiter *)mmap(NULL, sizeof(rate_limiter), PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+  if (request_rate == MAP_FAILED)
+    return(tasks.size());
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutex_init(&request_rate->rl_mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+  request_rate->rl_rate = limits->cl_bandwidth;
+  request_rate->rl_next = 0.0;
+
+  if (pipe(result_pipe) != 0)
+    {
+    result_pipe[0] = -1;
+    result_pipe[1] = -1;
+    workers = 0;
+    }
+
+  for (int i = 0; i < workers; i++)
+    {
+    int   sv[2];
+    pid_t pid;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+      break;
+
+    if ((pid = fork()) == 0)
+      {
+      /* worker */
+      close(sv[0]);
+      close(result_pipe[0]);
+
+      for (size_t j = 0; j < task_fds.size(); j++)
+        close(task_fds[j]);
+
+      copy_worker(tasks, limits, request_rate, i, sv[1], result_pipe[1]);
+
+      _exit(0);
+      }
+
+    close(sv[1]);
+
+    if (pid < 0)
+      {
+      close(sv[0]);
+      break;
+      }
+
+    pids.push_back(pid);
+    task_fds.push_back(sv[0]);
+    busy.push_back(-1);
+    }
+
+  if (result_pipe[1] >= 0)
+    close(result_pipe[1]);
+
+  /* give each worker its first task */
+  for (size_t i = 0; (i < task_fds.size()) && (next < tasks.size()); i++)
+    {
+    if (send_copy_task(task_fds[i], next) == true)
+      {
+      busy[i] = next++;
+      in_flight++;
+      }
+    }
+
+  if (limits->cl_progress_interval > 0)
+    next_report = copy_clock() + limits->cl_progress_interval;
+
+  while (in_flight > 0)
+    {
+    struct pollfd pfd;
+    copy_result   result;
+    int           rc;
+
+    pfd.fd = result_pipe[0];
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    rc = poll(&pfd, 1, 1000);
+
+    if (rc > 0)
+      {
+      ssize_t len = read(result_pipe[0], &result, sizeof(result));
+
+      if (len == 0)
+        break; /* every worker has exited */
+
+      if ((len == sizeof(result)) &&
+          (result.cr_worker >= 0) &&
+          (result.cr_worker < (int)busy.size()) &&
+          (busy[result.cr_worker] == (long)result.cr_index))
+        {
+        copy_task &task = tasks[result.cr_index];
+
+        task.ct_rc = result.cr_rc;
+        task.ct_err = result.cr_err;
+
+        stats->cs_files += result.cr_stats.cs_files;
+        stats->cs_dirs  += result.cr_stats.cs_dirs;
+        stats->cs_bytes += result.cr_stats.cs_bytes;
+
+        busy[result.cr_worker] = -1;
+        in_flight--;
+        done++;
+
+        /* COPY_UNSUPPORTED is left to /bin/cp, it isn't a failure */
+        if (result.cr_rc > 0)
+          stop = true;
+
+        if ((stop == false) &&
+            (next < tasks.size()) &&
+            (send_copy_task(task_fds[result.cr_worker], next) == true))
+          {
+          busy[result.cr_worker] = next++;
+          in_flight++;
+          }
+        }
+      }
+    else if ((rc < 0) &&
+             (errno != EINTR))
+      break;
+    else
+      {
+      /* a worker that died can't report its task */
+      for (size_t i = 0; i < pids.size(); i++)
+        {
+        if ((busy[i] >= 0) &&
+            (waitpid(pids[i], NULL, WNOHANG) == pids[i]))
+          {
+          tasks[busy[i]].ct_rc = ECHILD;
+          tasks[busy[i]].ct_err = "copy worker exited";
+          pids[i] = -1;
+          busy[i] = -1;
+          in_flight--;
+          done++;
+          stop = true;
+          }
+        }
+      }
+
+    if ((limits->cl_progress != NULL) &&
+        (next_report > 0.0) &&
+        (in_flight > 0) &&
+        (copy_clock() >= next_report))
+      {
+      limits->cl_progress(stats, done, tasks.size(), limits->cl_progress_arg);
+
+      next_report = copy_clock() + limits->cl_progress_interval;
+      }
+    }
+
+  /* tasks still out when the workers went away */
+  for (size_t i = 0; i < busy.size(); i++)
+    {
+    if (busy[i] >= 0)
+      {
+      tasks[busy[i]].ct_rc = ECHILD;
+      tasks[busy[i]].ct_err = "copy worker exited";
+      }
+    }
+
+  for (size_t i = 0; i < task_fds.size(); i++)
+    close(task_fds[i]);
+
+  for (size_t i = 0; i < pids.size(); i++)
+    {
+    if (pids[i] > 0)
+      {
+      while ((waitpid(pids[i], NULL, 0) < 0) &&
+             (errno == EINTR))
+        /* NO-OP, wait again */;
+      }
+    }
+
+  if (result_pipe[0] >= 0)
+    close(result_pipe[0]);
+
+  /* no worker could be started, copy in this process */
+  if (pids.size() == 0)
+    {
+    rate_limiter slot_rate;
+    int          slot_fd = (limits->cl_slot_fd_count > 0) ? limits->cl_slot_fds[0] : -1;
+
+    init_rate_limiter(&slot_rate, limits->cl_slot_bandwidth);
+
+    for (size_t i = 0; i < tasks.size(); i++)
+      {
+      tasks[i].ct_rc = copy_one_task(tasks[i], limits, request_rate, &slot_rate, slot_fd, 0, stats, tasks[i].ct_err);
+
+      if (tasks[i].ct_rc > 0)
+        break;
+      }
+
+    pthread_mutex_destroy(&slot_rate.rl_mutex);
+    }
+
+  pthread_mutex_destroy(&request_rate->rl_mutex);
+  munmap(request_rate, sizeof(rate_limiter));
+
+  for (size_t i = 0; i < tasks.size(); i++)
+    {
+    if (tasks[i].ct_rc > 0)
+      failed++;
+    }
+
+  return(failed);
+  } /* END copy_files_in_parallel() */
+
+
+
+void format_copy_stats(
+
+  char             *buf,
+  int               size,
+  const copy_stats *stats,
+  int               workers,
+  double            elapsed)
+
+  {
+  double rate = 0.0;
+
+  if (elapsed > 0.0)
+    rate = stats->cs_bytes / elapsed / (1024 * 1024);
+
+  snprintf(buf, size, "copied %lu files and %lu directories (%llu bytes) in %.3f seconds, %.2f MB/s using %d workers",
+    stats->cs_files,
+    stats->cs_dirs,
+    stats->cs_bytes,
+    elapsed,
+    rate,
+    workers);
+  } /* END format_copy_stats() */
@@ -0,0 +1,69 @@
+#ifndef _FILE_COPY_H
+#define _FILE_COPY_H
+#include "license_pbs.h" /* See here for the software license */
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+/* returned by local_copy() for sources it leaves to /bin/cp (fifos, devices) */
+#define COPY_UNSUPPORTED      -1
+/* set by copy_files_in_parallel() for tasks not started because an earlier one failed */
+#define COPY_SKIPPED          -2
+
+typedef struct copy_stats
+  {
+  unsigned long      cs_files;    /* regular files copied */
+  unsigned long      cs_dirs;     /* directories created or merged */
+  unsigned long long cs_bytes;    /* bytes of file data copied */
+  } copy_stats;
+
+/* one local source/destination pair handed to the copy workers */
+typedef struct copy_task
+  {
+  std::string ct_src;
+  std::string ct_dest;
+  int         ct_rc;      /* PBSE_NONE, an errno value, COPY_UNSUPPORTED or COPY_SKIPPED */
+  std::string ct_err;     /* path and reason when ct_rc is an errno value */
+  } copy_task;
+
+/* paces copies to a number of bytes per second, shared by the copies using it */
+typedef struct rate_limiter
+  {
+  pthread_mutex_t rl_mutex;
+  double          rl_rate;    /* bytes per second, 0 is unlimited */
+  double          rl_next;    /* when the next chunk may start */
+  } rate_limiter;
+
+typedef void (*copy_progress_func)(const copy_stats *stats, size_t done, size_t total, void *arg);
+
+/* how hard copy_files_in_parallel() may push the node */
+typedef struct copy_limits
+  {
+  int                cl_workers;           /* copies in flight for this request */
+  double             cl_bandwidth;         /* bytes per second for this request, 0 is unlimited */
+  bool               cl_sync;              /* fsync each file before it counts as copied */
+  int                cl_node_slots;        /* copies in flight on the node, 0 is unlimited */
+  int               *cl_slot_fds;          /* one open description of the node's slot file per worker */
+  int                cl_slot_fd_count;
+  double             cl_slot_bandwidth;    /* bytes per second for each node slot, 0 is unlimited */
+  int                cl_progress_interval; /* seconds between calls to cl_progress */
+  copy_progress_func cl_progress;
+  void              *cl_progress_arg;
+  } copy_limits;
+
+void        init_rate_limiter(rate_limiter *rl, double rate);
+
+void        throttle_copy(rate_limiter *rl, size_t bytes);
+
+void        init_copy_limits(copy_limits *limits);
+
+std::string copy_target(const char *src, const char *dest);
+
+int         local_copy(const char *src, const char *dest, copy_stats *stats, std::string &err);
+
+int         copy_files_in_parallel(std::vector<copy_task> &tasks, copy_limits *limits, copy_stats *stats);
+
+void        format_copy_stats(char *buf, int size, const copy_stats *stats, int workers, double elapsed);
+
+#endif /* _FILE_COPY_H */
@@ -134,6 +134,7 @@
 #include "mom_config.h"
 #include <string>
 #include <vector>
+#include <map>
 #include "container.hpp"
 #include "trq_cgroups.h"
 #ifdef PENABLE_LINUX_CGROUPS
@@ -195,7 +196,12 @@ const char *PMOMCommand[] =
   "PMIx_FENCE",
   "PMIx_CONNECT",
   "PMIx_DISCONNECT",
-  "ERROR",     /* 18+ */
+  "SPAWN_TASKS",
+  "OBIT_TASKS",
+  "PMIx_FENCE_RELEASE",
+  "PMIx_DMODEX_REQ",
+  "PMIx_DMODEX_DATA",
+  "ERROR",     /* 23+ */
   NULL
   };
 
@@ -1529,6 +1535,19 @@ void node_bailout(
 
         break;
 
+      case IM_SPAWN_TASKS:
+
+      case IM_OBIT_TASKS:
+
+        /*
+        ** Part of a batched request will never be answered,
+        ** report those tasks as failed.
+        */
+
+        tm_batch_abandon(pjob, ep->ee_forward.fe_event, ep->ee_event);
+
+        break;
+
       case IM_POLL_JOB:
 
         /*
@@ -5260,6 +5279,13 @@ int process_error_reply(
       
       break;
       
+    case IM_SPAWN_TASKS:
+    case IM_OBIT_TASKS:
+
+      tm_batch_abandon(pjob, efwd.fe_event, event);
+
+      break;
+
     case IM_POLL_JOB:
 
       rc = im_poll_error(pjob, np, errcode);
@@ -5349,6 +5375,19 @@ int process_valid_response(
 
       break;
 
+    case IM_SPAWN_TASKS:
+    case IM_OBIT_TASKS:
+
+      ret = handle_im_batch_response(chan, pjob, &efwd, event);
+
+      close_conn(chan->sock, FALSE);
+      chan->sock = -1;
+
+      if (ret == IM_FAILURE)
+        log_err(-1, __func__, "handle_im_batch_response error");
+
+      break;
+
     case IM_GET_TASKS:
 
       ret = handle_im_get_tasks_response(chan,pjob,event_task,event);
@@ -5834,38 +5873,34 @@ int process_valid_intermediate_response(
 
 
 
+/*
+ * process_pmix_fence()
+ *
+ * A child in the fence tree is passing up the modex data of everyone below it
+ */
+
 int process_pmix_fence(
     
   tcp_chan *chan,
   job      *pjob)
 
   {
-  int   rc = IM_DONE;
-  char *data = disrst(chan, &rc);
+  int     rc = IM_DONE;
+  size_t  len = 0;
+  char   *host = disrst(chan, &rc);
+  char   *data = NULL;
 
-#ifdef ENABLE_PMIX
   if (rc == PBSE_NONE)
-    {
-    if (pending_fences.find(pjob->ji_qs.ji_jobid) != pending_fences.end())
-      {
-      pending_fences[pjob->ji_qs.ji_jobid].add_data(data);
+    data = disrcs(chan, &len, &rc);
 
-      if (am_i_mother_superior(*pjob))
-        {
-        // A sister has replied. Mark this host from the list
-        
-        if (pending_fences[pjob->ji_qs.ji_jobid].mark_reported(mom_alias) == true)
-          pending_fences[pjob->ji_qs.ji_jobid].complete_operation(pjob, 0);
-        }
-      else
-        {
-        // Mother superior is telling me the fence is complete
-        pending_fences[pjob->ji_qs.ji_jobid].execute_callback();
-        }
-      }
-    }
+#ifdef ENABLE_PMIX
+  if (rc == PBSE_NONE)
+    record_fence_contribution(pjob, host, std::string(data, len));
 #endif
 
+  if (host != NULL)
+    free(host);
+
   if (data != NULL)
     free(data);
   
@@ -5874,6 +5909,113 @@ int process_pmix_fence(
 
 
 
+/*
+ * process_pmix_fence_release()
+ *
+ * Our parent in the fence tree is passing down the completed fence's data
+ */
+
+int process_pmix_fence_release(
+
+  tcp_chan *chan,
+  job      *pjob)
+
+  {
+  int     rc = IM_DONE;
+  size_t  len = 0;
+  char   *data = disrcs(chan, &len, &rc);
+
+#ifdef ENABLE_PMIX
+  if (rc == PBSE_NONE)
+    release_fence(pjob, std::string(data, len));
+#endif
+
+  if (data != NULL)
+    free(data);
+
+  return(rc);
+  } // END process_pmix_fence_release()
+
+
+
+/*
+ * process_pmix_dmodex_request()
+ *
+ * Another host wants the modex data of a rank that runs here
+ */
+
+int process_pmix_dmodex_request(
+
+  tcp_chan *chan,
+  job      *pjob)
+
+  {
+  int   rc = IM_DONE;
+  int   rank = -1;
+  char *requestor = disrst(chan, &rc);
+
+  if (rc == PBSE_NONE)
+    rank = disrsi(chan, &rc);
+
+#ifdef ENABLE_PMIX
+  if (rc == PBSE_NONE)
+    serve_modex_request(pjob, requestor, rank);
+#else
+  /* the request is still read off the stream */
+  (void)rank;
+#endif
+
+  if (requestor != NULL)
+    free(requestor);
+
+  return(rc);
+  } // END process_pmix_dmodex_request()
+
+
+
+/*
+ * process_pmix_dmodex_data()
+ *
+ * The answer to a direct modex request we sent
+ */
+
+int process_pmix_dmodex_data(
+
+  tcp_chan *chan,
+  job      *pjob)
+
+  {
+  int     rc = IM_DONE;
+  int     rank = -1;
+  int     status = 0;
+  size_t  len = 0;
+  char   *data = NULL;
+
+  rank = disrsi(chan, &rc);
+
+  if (rc == PBSE_NONE)
+    status = disrsi(chan, &rc);
+
+  if (rc == PBSE_NONE)
+    data = disrcs(chan, &len, &rc);
+
+#ifdef ENABLE_PMIX
+  if (rc == PBSE_NONE)
+    deliver_modex(pjob, rank, status, std::string(data, len));
+#else
+  /* the data is still read off the stream */
+  (void)rank;
+  (void)status;
+#endif
+
+  if (data != NULL)
+    free(data);
+
+  return(rc);
+  } // END process_pmix_dmodex_data()
+
+
+
 /*
  * process_pmix_connect()
  *
@@ -6362,6 +6504,35 @@ void im_request(
       break;
       }
  
+    case IM_SPAWN_TASKS:
+      {
+      ret = im_spawn_tasks(chan, pjob, cookie, event, pSockAddr, fromtask);
+      close_conn(chan->sock, FALSE);
+      svr_conn[chan->sock].cn_stay_open = FALSE;
+      chan->sock = -1;
+
+      if (ret == IM_FAILURE)
+        {
+        log_err(-1, __func__, "im_spawn_tasks error");
+        goto err;
+        }
+
+      break;
+      }
+
+    case IM_OBIT_TASKS:
+      {
+      ret = im_obit_tasks(chan, pjob, cookie, event, fromtask);
+
+      if (ret == IM_FAILURE)
+        {
+        log_err(-1, __func__, "im_obit_tasks error");
+        goto err;
+        }
+
+      break;
+      }
+
     case IM_SIGNAL_TASK:
       {
       ret = im_signal_task(chan,pjob,cookie,event,fromtask);
@@ -6520,6 +6691,24 @@ void im_request(
       break;
       }
 
+    case IM_FENCE_RELEASE:
+      {
+      ret = process_pmix_fence_release(chan, pjob);
+      break;
+      }
+
+    case IM_DMODEX_REQ:
+      {
+      ret = process_pmix_dmodex_request(chan, pjob);
+      break;
+      }
+
+    case IM_DMODEX_DATA:
+      {
+      ret = process_pmix_dmodex_data(chan, pjob);
+      break;
+      }
+
     default:
       {
       sprintf(log_buffer, "unknown command %d sent", command);
@@ -7487,90 +7676,1398 @@ int tm_obit_request(
 
 
 
+/* tm_batch entries by batch id */
+std::map<int, tm_batch> tm_batches;
+
 
 
 /*
- * tm_getinfo_request
+ * tm_batch_create()
  *
- * Get named info for a specified task.
+ * Starts tracking a batch of count tasks for pjob.  Batches left behind by
+ * jobs that have gone away are dropped here.
  *
- * read (
- *  task   int
- *  name   string
- * )
+ * @return the new batch
  */
- 
-int tm_getinfo_request(
- 
-  struct tcp_chan *chan,
-  job        *pjob,       /* I */
-  int         prev_error, /* I */
-  int         event,      /* I */
-  char       *cookie,     /* I */
-  int        *reply_ptr,  /* O */
-  int        *ret,        /* O */
-  tm_task_id  fromtask,   /* I */
-  hnodent    *phost,      /* M */
-  int         nodeid)     /* I */
- 
+
+tm_batch *tm_batch_create(
+
+  job        *pjob,
+  int         command,
+  tm_node_id  node,
+  tm_event_t  event,
+  tm_task_id  fromtask,
+  int         count)
+
   {
-  int       taskid;
-  char     *jobid = pjob->ji_qs.ji_jobid;
-  char     *name;
-  task     *ptask;
-  infoent  *ip;
+  static int                        next_batch = 1;
+  int                               id;
+  std::map<int, tm_batch>::iterator it = tm_batches.begin();
 
-#ifndef NUMA_SUPPORT 
-  int local_socket;
-  struct tcp_chan *local_chan = NULL;
-#endif
-  
-  taskid = disrui(chan, ret);
-  
-  if (*ret == DIS_SUCCESS)
+  while (it != tm_batches.end())
     {
-    name = disrst(chan, ret);
+    if (mom_find_job(it->second.tb_jobid.c_str()) == NULL)
+      tm_batches.erase(it++);
+    else
+      it++;
     }
-  
-  if (*ret != DIS_SUCCESS)
-    return(TM_ERROR);
-  
-  if (LOGLEVEL >= 7)
+
+  do
     {
-    snprintf(log_buffer,sizeof(log_buffer),
-      "%s: GETINFO %s from node %d task %d name %s\n",
-      __func__,
-      jobid,
-      nodeid,
-      taskid,
-      name);
-    
-    log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,jobid,log_buffer);
-    }
-  
-  if (prev_error)
+    id = next_batch++;
+
+    if (next_batch == INT_MAX)
+      next_batch = 1;
+    } while (tm_batches.find(id) != tm_batches.end());
+
+  tm_batch &tb = tm_batches[id];
+
+  tb.tb_id = id;
+  tb.tb_jobid = pjob->ji_qs.ji_jobid;
+  tb.tb_command = command;
+  tb.tb_node = node;
+  tb.tb_event = event;
+  tb.tb_fromtask = fromtask;
+  tb.tb_tasks.assign(count, TM_NULL_TASK);
+  tb.tb_values.assign(count, 0);
+  tb.tb_events.assign(count, TM_NULL_EVENT);
+  tb.tb_filled.assign(count, false);
+  tb.tb_pending = count;
+
+  return(&tb);
+  } /* END tm_batch_create() */
+
+
+
+tm_batch *tm_batch_find(
+
+  int id)
+
+  {
+  std::map<int, tm_batch>::iterator it = tm_batches.find(id);
+
+  if (it == tm_batches.end())
+    return(NULL);
+
+  return(&it->second);
+  } /* END tm_batch_find() */
+
+
+
+void tm_batch_free(
+
+  tm_batch *tb)
+
+  {
+  tm_batches.erase(tb->tb_id);
+  } /* END tm_batch_free() */
+
+
+
+/*
+ * tm_batch_fill()
+ *
+ * Records value for a slot of tb.  A slot is only filled once.
+ *
+ * @return the number of slots still waiting
+ */
+
+int tm_batch_fill(
+
+  tm_batch *tb,
+  int       slot,
+  int       value)
+
+  {
+  if ((slot >= 0) &&
+      (slot < (int)tb->tb_filled.size()) &&
+      (tb->tb_filled[slot] == false))
     {
-    free(name);
-    return(TM_DONE);
+    tb->tb_filled[slot] = true;
+    tb->tb_values[slot] = value;
+    tb->tb_pending--;
     }
-  
-#ifndef NUMA_SUPPORT
-  if (is_nodeid_on_this_host(pjob, nodeid) == false)
-    {
-    /* not me */
-    event_alloc(IM_GET_INFO,phost,event,fromtask);
-    
-    local_socket = tcp_connect_sockaddr((struct sockaddr *)&phost->sock_addr,sizeof(phost->sock_addr), true);
-    
-    if (IS_VALID_STREAM(local_socket) == FALSE)
-      {
-      free(name);
 
-      return(TM_ERROR);
-      }
-    if ((local_chan = DIS_tcp_setup(local_socket)) == NULL)
-      {
-      }
+  return(tb->tb_pending);
+  } /* END tm_batch_fill() */
+
+
+
+/*
+ * tm_batch_fill_task()
+ *
+ * Records value for the first waiting local slot watching taskid.
+ *
+ * @return the number of slots still waiting
+ */
+
+int tm_batch_fill_task(
+
+  tm_batch   *tb,
+  tm_task_id  taskid,
+  int         value)
+
+  {
+  for (unsigned int i = 0; i < tb->tb_tasks.size(); i++)
+    {
+    if ((tb->tb_tasks[i] == taskid) &&
+        (tb->tb_events[i] == TM_NULL_EVENT) &&
+        (tb->tb_filled[i] == false))
+      return(tm_batch_fill(tb, i, value));
+    }
+
+  return(tb->tb_pending);
+  } /* END tm_batch_fill_task() */
+
+
+
+/*
+ * tm_batch_fill_event()
+ *
+ * Records value for every waiting slot that was sent to a sister with
+ * event, used when the sister cannot answer.
+ *
+ * @return the number of slots still waiting
+ */
+
+int tm_batch_fill_event(
+
+  tm_batch   *tb,
+  tm_event_t  event,
+  int         value)
+
+  {
+  for (unsigned int i = 0; i < tb->tb_events.size(); i++)
+    {
+    if (tb->tb_events[i] == event)
+      tm_batch_fill(tb, i, value);
+    }
+
+  return(tb->tb_pending);
+  } /* END tm_batch_fill_event() */
+
+
+
+/*
+ * tm_batch_reply()
+ *
+ * Sends the values of a completed batch to whoever is waiting for them
+ * and stops tracking it.  A local task gets a TM reply, the MOM that asked
+ * for IM_OBIT_TASKS gets an IM_ALL_OKAY.
+ *
+ * reply (
+ *  count  int;
+ *  value  int;
+ *  ...
+ * )
+ */
+
+int tm_batch_reply(
+
+  job      *pjob,
+  tm_batch *tb)
+
+  {
+  int              ret = DIS_SUCCESS;
+  int              stream = -1;
+  struct tcp_chan *chan = NULL;
+  task            *ptask;
+  vnodent         *vp;
+  int              i;
+
+  if (tb->tb_command == IM_OBIT_TASKS)
+    {
+    for (vp = pjob->ji_vnods, i = 0; i < pjob->ji_numvnod; vp++, i++)
+      {
+      if (vp->vn_node == tb->tb_node)
+        break;
+      }
+
+    if (i == pjob->ji_numvnod)
+      ret = DIS_PROTO;
+    else
+      {
+      stream = tcp_connect_sockaddr((struct sockaddr *)&vp->vn_host->sock_addr,
+                                    sizeof(vp->vn_host->sock_addr), true);
+
+      if (IS_VALID_STREAM(stream) == FALSE)
+        ret = DIS_NOCOMMIT;
+      else if ((chan = DIS_tcp_setup(stream)) == NULL)
+        ret = DIS_NOMALLOC;
+      else
+        ret = im_compose(chan, pjob->ji_qs.ji_jobid, pjob->ji_wattr[JOB_ATR_Cookie].at_val.at_str,
+                         IM_ALL_OKAY, tb->tb_event, tb->tb_fromtask);
+      }
+    }
+  else if (((ptask = task_check(pjob, tb->tb_fromtask)) == NULL) ||
+           ((chan = ptask->ti_chan) == NULL))
+    ret = DIS_NOCOMMIT;
+  else
+    ret = tm_reply(chan, TM_OKAY, tb->tb_event);
+
+  if (ret == DIS_SUCCESS)
+    ret = diswsi(chan, tb->tb_values.size());
+
+  for (unsigned int j = 0; (ret == DIS_SUCCESS) && (j < tb->tb_values.size()); j++)
+    ret = diswsi(chan, tb->tb_values[j]);
+
+  if (ret == DIS_SUCCESS)
+    ret = DIS_tcp_wflush(chan);
+
+  if (ret != DIS_SUCCESS)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "could not answer %s for %d tasks of job %s",
+      (tb->tb_command == TM_SPAWN_MULTI) ? "tm_spawn_multi" : "tm_obit_multi",
+      (int)tb->tb_values.size(),
+      pjob->ji_qs.ji_jobid);
+
+    log_err(-1, __func__, log_buffer);
+    }
+
+  if (IS_VALID_STREAM(stream))
+    {
+    close(stream);
+
+    if (chan != NULL)
+      DIS_tcp_cleanup(chan);
+    }
+
+  tm_batch_free(tb);
+
+  return(ret);
+  } /* END tm_batch_reply() */
+
+
+
+/*
+ * tm_batch_obit()
+ *
+ * Called when a task watched by a batch exits.
+ */
+
+void tm_batch_obit(
+
+  job  *pjob,
+  int   id,
+  task *ptask)
+
+  {
+  tm_batch *tb = tm_batch_find(id);
+
+  if (tb == NULL)
+    return;
+
+  if (tm_batch_fill_task(tb, ptask->ti_qs.ti_task, ptask->ti_qs.ti_exitstat) == 0)
+    tm_batch_reply(pjob, tb);
+  } /* END tm_batch_obit() */
+
+
+
+/*
+ * tm_batch_abandon()
+ *
+ * A sister will never answer the part of batch id it was sent with event.
+ * Those slots report TM_NULL_TASK for a spawn and -1 for an obit.
+ */
+
+void tm_batch_abandon(
+
+  job        *pjob,
+  int         id,
+  tm_event_t  event)
+
+  {
+  tm_batch *tb = tm_batch_find(id);
+
+  if (tb == NULL)
+    return;
+
+  if (tm_batch_fill_event(tb, event, (tb->tb_command == TM_SPAWN_MULTI) ? TM_NULL_TASK : -1) == 0)
+    tm_batch_reply(pjob, tb);
+  } /* END tm_batch_abandon() */
+
+
+
+/*
+ * tm_batch_watch()
+ *
+ * Fills slot of tb with the exit value of the local task it names, or
+ * hangs an obit on the task if it is still running.
+ */
+
+void tm_batch_watch(
+
+  job      *pjob,
+  tm_batch *tb,
+  int       slot)
+
+  {
+  task    *ptask = task_find(pjob, tb->tb_tasks[slot]);
+  obitent  op;
+
+  if (ptask == NULL)
+    tm_batch_fill(tb, slot, -1);
+  else if (ptask->ti_qs.ti_status >= TI_STATE_EXITED)
+    tm_batch_fill(tb, slot, ptask->ti_qs.ti_exitstat);
+  else
+    {
+    op.oe_info.fe_node = pjob->ji_nodeid;
+    op.oe_info.fe_event = tb->tb_id;
+    op.oe_info.fe_taskid = tb->tb_fromtask;
+    op.oe_batch = true;
+
+    ptask->ti_obits.push_back(op);
+    }
+  } /* END tm_batch_watch() */
+
+
+
+/*
+ * read_batch_strings()
+ *
+ * Reads strings up to an empty one or the end of the message.
+ *
+ * @return a NULL terminated array to free with arrayfree(), or NULL
+ */
+
+char **read_batch_strings(
+
+  struct tcp_chan *chan,
+  int             *ret)
+
+  {
+  std::vector<char *>  strings;
+  char               **array;
+  char                *cp;
+
+  for (;;)
+    {
+    cp = disrst(chan, ret);
+
+    if ((*ret == DIS_EOD) ||
+        (*ret == DIS_EOF))
+      {
+      if (cp != NULL)
+        free(cp);
+
+      *ret = DIS_SUCCESS;
+
+      break;
+      }
+
+    if (*ret != DIS_SUCCESS)
+      {
+      if (cp != NULL)
+        free(cp);
+
+      for (unsigned int i = 0; i < strings.size(); i++)
+        free(strings[i]);
+
+      return(NULL);
+      }
+
+    if (*cp == '\0')
+      {
+      free(cp);
+
+      break;
+      }
+
+    strings.push_back(cp);
+    }
+
+  if ((array = (char **)calloc(strings.size() + 1, sizeof(char *))) == NULL)
+    {
+    for (unsigned int i = 0; i < strings.size(); i++)
+      free(strings[i]);
+
+    *ret = DIS_NOMALLOC;
+
+    return(NULL);
+    }
+
+  for (unsigned int i = 0; i < strings.size(); i++)
+    array[i] = strings[i];
+
+  return(array);
+  } /* END read_batch_strings() */
+
+
+
+/*
+ * spawn_batch_task()
+ *
+ * Starts argv as task taskid, or a new task if taskid is TM_NULL_TASK,
+ * with PBS_VNODENUM set to nodeid.
+ *
+ * @return the id of the started task or TM_NULL_TASK
+ */
+
+tm_task_id spawn_batch_task(
+
+  job        *pjob,
+  char      **argv,
+  char      **envp,
+  tm_node_id  nodeid,
+  tm_node_id  parentnode,
+  tm_task_id  parenttask,
+  tm_task_id  taskid)
+
+  {
+  task  *ptask;
+  char   vnodenum[MAXLINE];
+  char **env;
+  int    envc;
+
+  for (envc = 0; envp[envc] != NULL; envc++)
+    ;
+
+  if ((env = (char **)calloc(envc + 2, sizeof(char *))) == NULL)
+    return(TM_NULL_TASK);
+
+  memcpy(env, envp, envc * sizeof(char *));
+
+  snprintf(vnodenum, sizeof(vnodenum), "PBS_VNODENUM=%d", nodeid);
+  env[envc] = vnodenum;
+
+  if ((ptask = pbs_task_create(pjob, taskid)) == NULL)
+    taskid = TM_NULL_TASK;
+  else
+    {
+    snprintf(ptask->ti_qs.ti_parentjobid, sizeof(ptask->ti_qs.ti_parentjobid), "%s", pjob->ji_qs.ji_jobid);
+
+    ptask->ti_qs.ti_parentnode = parentnode;
+    ptask->ti_qs.ti_parenttask = parenttask;
+
+    if ((task_save(ptask) == -1) ||
+        (start_process(ptask, argv, env) == -1))
+      taskid = TM_NULL_TASK;
+    else
+      taskid = ptask->ti_qs.ti_task;
+    }
+
+  free(env);
+
+  return(taskid);
+  } /* END spawn_batch_task() */
+
+
+
+/*
+ * group_batch_slots()
+ *
+ * Collects the slots of tb whose nodes are not on this host by the host
+ * that runs them.  Local slots are left alone.
+ */
+
+void group_batch_slots(
+
+  job                                     *pjob,
+  std::vector<tm_node_id>                 &where,
+  std::vector<hnodent *>                  &hosts,
+  std::map<hnodent *, std::vector<int> >  &host_slots)
+
+  {
+  vnodent *vp;
+  int      i;
+
+  for (unsigned int slot = 0; slot < where.size(); slot++)
+    {
+#ifndef NUMA_SUPPORT
+    if (is_nodeid_on_this_host(pjob, where[slot]) == true)
+#endif /* ndef NUMA_SUPPORT */
+      continue;
+
+    for (vp = pjob->ji_vnods, i = 0; i < pjob->ji_numvnod; vp++, i++)
+      {
+      if (vp->vn_node == where[slot])
+        break;
+      }
+
+    if (host_slots.find(vp->vn_host) == host_slots.end())
+      hosts.push_back(vp->vn_host);
+
+    host_slots[vp->vn_host].push_back(slot);
+    }
+  } /* END group_batch_slots() */
+
+
+
+/*
+ * connect_batch_hosts()
+ *
+ * Opens connections to up to SISTER_CONNECT_BATCH hosts starting with
+ * hosts[first], all at once, falling back to a plain connect for any that
+ * did not finish in time.
+ */
+
+void connect_batch_hosts(
+
+  std::vector<hnodent *> &hosts,
+  unsigned int            first,
+  std::vector<int>       &streams)
+
+  {
+  std::vector<struct sockaddr_in *> addrs;
+
+  for (unsigned int i = first; (i < hosts.size()) && (addrs.size() < SISTER_CONNECT_BATCH); i++)
+    addrs.push_back(&hosts[i]->sock_addr);
+
+  streams.assign(addrs.size(), TRANSIENT_SOCKET_FAIL);
+
+  if (addrs.size() > 0)
+    socket_connect_addrs(&addrs[0], addrs.size(), &streams[0], TRUE, SISTER_CONNECT_TIMEOUT);
+
+  for (unsigned int i = 0; i < streams.size(); i++)
+    {
+    if (streams[i] == TRANSIENT_SOCKET_FAIL)
+      streams[i] = tcp_connect_sockaddr((struct sockaddr *)addrs[i], sizeof(*addrs[i]), true);
+    }
+  } /* END connect_batch_hosts() */
+
+
+
+/*
+ * send_batch_to_hosts()
+ *
+ * Sends each host its share of batch tb in one command message, opening
+ * the connections SISTER_CONNECT_BATCH at a time.  The slots of a host
+ * that cannot be reached are filled as failed.
+ *
+ * IM_SPAWN_TASKS (
+ *  sending node int;
+ *  count  int;
+ *  node   int;
+ *  task   int;
+ *  ...
+ *  global id string;
+ *  arg 0  string;
+ *  ...
+ *  ""
+ *  env 0  string;
+ *  ...
+ *  ""
+ * )
+ *
+ * IM_OBIT_TASKS (
+ *  sending node int;
+ *  count  int;
+ *  task   int;
+ *  ...
+ * )
+ */
+
+void send_batch_to_hosts(
+
+  job                                    *pjob,
+  tm_batch                               *tb,
+  int                                     command,
+  std::vector<hnodent *>                 &hosts,
+  std::map<hnodent *, std::vector<int> > &host_slots,
+  std::vector<tm_node_id>                &where,
+  char                                  **argv,
+  char                                  **envp)
+
+  {
+  std::vector<int>  streams;
+  char             *jobid = pjob->ji_qs.ji_jobid;
+  int               rc;
+
+  for (unsigned int first = 0; first < hosts.size(); first += SISTER_CONNECT_BATCH)
+    {
+    connect_batch_hosts(hosts, first, streams);
+
+    for (unsigned int k = 0; k < streams.size(); k++)
+      {
+      hnodent          *np = hosts[first + k];
+      std::vector<int> &slots = host_slots[np];
+      struct tcp_chan  *chan = NULL;
+      tm_event_t        event = tb->tb_events[slots[0]];
+
+      rc = DIS_NOCOMMIT;
+
+      if (IS_VALID_STREAM(streams[k]) == FALSE)
+        {
+        }
+      else if ((chan = DIS_tcp_setup(streams[k])) == NULL)
+        {
+        }
+      else if ((rc = im_compose(chan, jobid, pjob->ji_wattr[JOB_ATR_Cookie].at_val.at_str,
+                                command, event, tb->tb_fromtask)) == DIS_SUCCESS)
+        {
+        if ((rc = diswsi(chan, pjob->ji_nodeid)) == DIS_SUCCESS)
+          rc = diswsi(chan, slots.size());
+
+        for (unsigned int i = 0; (rc == DIS_SUCCESS) && (i < slots.size()); i++)
+          {
+          if (command == IM_SPAWN_TASKS)
+            rc = diswsi(chan, where[slots[i]]);
+
+          if (rc == DIS_SUCCESS)
+            rc = diswsi(chan, tb->tb_tasks[slots[i]]);
+          }
+
+        if (command == IM_SPAWN_TASKS)
+          {
+          if (rc == DIS_SUCCESS)
+            rc = diswst(chan, pjob->ji_globid);
+
+          for (int i = 0; (rc == DIS_SUCCESS) && (argv[i] != NULL); i++)
+            rc = diswst(chan, argv[i]);
+
+          if (rc == DIS_SUCCESS)
+            rc = diswst(chan, "");
+
+          for (int i = 0; (rc == DIS_SUCCESS) && (envp[i] != NULL); i++)
+            rc = diswst(chan, envp[i]);
+
+          if (rc == DIS_SUCCESS)
+            rc = diswst(chan, "");
+          }
+
+        if (rc == DIS_SUCCESS)
+          rc = DIS_tcp_wflush(chan);
+        }
+
+      if (IS_VALID_STREAM(streams[k]))
+        close(streams[k]);
+
+      if (chan != NULL)
+        DIS_tcp_cleanup(chan);
+
+      if (rc != DIS_SUCCESS)
+        {
+        eventent *ep = (eventent *)GET_NEXT(np->hn_events);
+
+        snprintf(log_buffer, sizeof(log_buffer),
+          "Unable to send %s request to node %s for job %s",
+          PMOMCommand[command],
+          np->hn_host,
+          jobid);
+
+        log_err(-1, __func__, log_buffer);
+
+        while (ep != NULL)
+          {
+          if (ep->ee_event == event)
+            {
+            delete_link(&ep->ee_next);
+            free(ep);
+
+            break;
+            }
+
+          ep = (eventent *)GET_NEXT(ep->ee_next);
+          }
+
+        tm_batch_fill_event(tb, event, (command == IM_SPAWN_TASKS) ? TM_NULL_TASK : -1);
+        }
+      }
+    }
+  } /* END send_batch_to_hosts() */
+
+
+
+/*
+ * read_batch_where()
+ *
+ * Reads the node of each task in a batched request and checks that
+ * they all belong to the job.
+ *
+ * read (
+ *  count  int;
+ *  node   int;
+ *  [task  int;]
+ *  ...
+ * )
+ *
+ * @return PBSE_NONE, TM_ENOTFOUND for an unknown node or a DIS error
+ */
+
+int read_batch_where(
+
+  struct tcp_chan         *chan,
+  job                     *pjob,
+  bool                     with_tasks,
+  std::vector<tm_node_id> &where,
+  std::vector<tm_task_id> &tasks)
+
+  {
+  int  ret;
+  int  count;
+  int  i;
+  int  rc = PBSE_NONE;
+
+  count = disrsi(chan, &ret);
+
+  if (ret != DIS_SUCCESS)
+    return(ret);
+
+  if (count <= 0)
+    return(DIS_PROTO);
+
+  for (int slot = 0; slot < count; slot++)
+    {
+    where.push_back(disrsi(chan, &ret));
+
+    if ((ret == DIS_SUCCESS) && (with_tasks == true))
+      tasks.push_back(disrsi(chan, &ret));
+
+    if (ret != DIS_SUCCESS)
+      return(ret);
+
+    for (i = 0; i < pjob->ji_numvnod; i++)
+      {
+      if (pjob->ji_vnods[i].vn_node == where[slot])
+        break;
+      }
+
+    if (i == pjob->ji_numvnod)
+      rc = TM_ENOTFOUND;
+    }
+
+  return(rc);
+  } /* END read_batch_where() */
+
+
+
+/*
+ * tm_spawn_multi_request
+ *
+ * Spawn one task on each of the requested nodes.  Only mother superior
+ * hands out task ids, so the request is refused anywhere else.  Tasks
+ * for this host are started here; every other host gets one
+ * IM_SPAWN_TASKS message for all of its tasks, the connections being
+ * opened SISTER_CONNECT_BATCH at a time.  The task ids go back to the
+ * caller in one reply when the last host answers.
+ *
+ * read (
+ *  count  int;
+ *  node 0  int;
+ *  ...
+ *  node count-1 int;
+ *  argc  int;
+ *  arg 0  string;
+ *  ...
+ *  arg argc-1 string;
+ *  env 0  string;
+ *  ...
+ *  env m  string;
+ * )
+ */
+
+int tm_spawn_multi_request(
+
+  struct tcp_chan *chan,
+  job             *pjob,      /* I */
+  int              event,     /* I */
+  int             *reply_ptr, /* O */
+  int             *ret,       /* O */
+  tm_task_id       fromtask)  /* I */
+
+  {
+  std::vector<tm_node_id>                 where;
+  std::vector<tm_task_id>                 unused;
+  std::vector<hnodent *>                  hosts;
+  std::map<hnodent *, std::vector<int> >  host_slots;
+  char                                  **argv = NULL;
+  char                                  **envp = NULL;
+  char                                   *jobid = pjob->ji_qs.ji_jobid;
+  int                                     rc;
+  int                                     argc;
+  tm_batch                               *tb;
+  unsigned int                            momport = 0;
+
+  rc = read_batch_where(chan, pjob, false, where, unused);
+
+  if ((rc != PBSE_NONE) &&
+      (rc != TM_ENOTFOUND))
+    {
+    *ret = rc;
+    return(TM_ERROR);
+    }
+
+  argc = disrsi(chan, ret);
+
+  if ((*ret != DIS_SUCCESS) ||
+      (argc <= 0))
+    return(TM_ERROR);
+
+  if ((argv = (char **)calloc(argc + 1, sizeof(char *))) == NULL)
+    {
+    log_err(ENOMEM, __func__, "No memory available, cannot calloc!");
+
+    return(TM_ERROR);
+    }
+
+  for (int i = 0; i < argc; i++)
+    {
+    argv[i] = disrst(chan, ret);
+
+    if (*ret != DIS_SUCCESS)
+      {
+      arrayfree(argv);
+
+      return(TM_ERROR);
+      }
+    }
+
+  if ((envp = read_batch_strings(chan, ret)) == NULL)
+    {
+    arrayfree(argv);
+
+    return(TM_ERROR);
+    }
+
+  if (LOGLEVEL >= 7)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "%s: SPAWN_MULTI %s %d tasks\n",
+      __func__,
+      jobid,
+      (int)where.size());
+
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, jobid, log_buffer);
+    }
+
+  if ((rc == TM_ENOTFOUND) ||
+      (pjob->ji_nodeid != 0))
+    {
+    arrayfree(argv);
+    arrayfree(envp);
+
+    *ret = tm_reply(chan, TM_ERROR, event);
+
+    if (*ret == DIS_SUCCESS)
+      *ret = diswsi(chan, (rc == TM_ENOTFOUND) ? TM_ENOTFOUND : TM_ENOTIMPLEMENTED);
+
+    return(TM_DONE);
+    }
+
+  tb = tm_batch_create(pjob, TM_SPAWN_MULTI, pjob->ji_nodeid, event, fromtask, where.size());
+
+  group_batch_slots(pjob, where, hosts, host_slots);
+
+  /* hand out the remote task ids before anything is sent */
+  for (unsigned int h = 0; h < hosts.size(); h++)
+    {
+    std::vector<int> &slots = host_slots[hosts[h]];
+    eventent         *ep = event_alloc(IM_SPAWN_TASKS, hosts[h], TM_NULL_EVENT, fromtask);
+
+    ep->ee_forward.fe_node = pjob->ji_nodeid;
+    ep->ee_forward.fe_event = tb->tb_id;
+    ep->ee_forward.fe_taskid = fromtask;
+
+    for (unsigned int i = 0; i < slots.size(); i++)
+      {
+      tb->tb_tasks[slots[i]] = pjob->ji_taskid++;
+      tb->tb_events[slots[i]] = ep->ee_event;
+      }
+    }
+
+  if (hosts.size() > 0)
+    {
+    if (multi_mom)
+      momport = pbs_rm_port;
+
+    job_save(pjob, SAVEJOB_FULL, momport);
+    }
+
+  for (unsigned int slot = 0; slot < where.size(); slot++)
+    {
+    if (tb->tb_events[slot] == TM_NULL_EVENT)
+      tm_batch_fill(tb, slot, spawn_batch_task(pjob, argv, envp, where[slot], pjob->ji_nodeid, fromtask, TM_NULL_TASK));
+    }
+
+  send_batch_to_hosts(pjob, tb, IM_SPAWN_TASKS, hosts, host_slots, where, argv, envp);
+
+  arrayfree(argv);
+  arrayfree(envp);
+
+  if (tb->tb_pending == 0)
+    *ret = tm_batch_reply(pjob, tb);
+
+  *reply_ptr = FALSE;
+
+  return(TM_DONE);
+  } /* END tm_spawn_multi_request() */
+
+
+
+/*
+ * tm_obit_multi_request
+ *
+ * Register one obit for a list of tasks.  Tasks on this host are watched
+ * here; every other host gets one IM_OBIT_TASKS message for all of its
+ * tasks and answers once they have all exited.  The exit values go back
+ * to the caller in one reply.
+ *
+ * read (
+ *  count  int;
+ *  node 0  int;
+ *  task 0  int;
+ *  ...
+ * )
+ */
+
+int tm_obit_multi_request(
+
+  struct tcp_chan *chan,
+  job             *pjob,      /* I */
+  int              event,     /* I */
+  int             *reply_ptr, /* O */
+  int             *ret,       /* O */
+  tm_task_id       fromtask)  /* I */
+
+  {
+  std::vector<tm_node_id>                 where;
+  std::vector<tm_task_id>                 tasks;
+  std::vector<hnodent *>                  hosts;
+  std::map<hnodent *, std::vector<int> >  host_slots;
+  char                                   *jobid = pjob->ji_qs.ji_jobid;
+  int                                     rc;
+  tm_batch                               *tb;
+
+  rc = read_batch_where(chan, pjob, true, where, tasks);
+
+  if (rc == TM_ENOTFOUND)
+    {
+    *ret = tm_reply(chan, TM_ERROR, event);
+
+    if (*ret == DIS_SUCCESS)
+      *ret = diswsi(chan, TM_ENOTFOUND);
+
+    return(TM_DONE);
+    }
+  else if (rc != PBSE_NONE)
+    {
+    *ret = rc;
+    return(TM_ERROR);
+    }
+
+  if (LOGLEVEL >= 7)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "%s: OBIT_MULTI %s %d tasks\n",
+      __func__,
+      jobid,
+      (int)tasks.size());
+
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, jobid, log_buffer);
+    }
+
+  tb = tm_batch_create(pjob, TM_OBIT_MULTI, pjob->ji_nodeid, event, fromtask, tasks.size());
+  tb->tb_tasks = tasks;
+
+  group_batch_slots(pjob, where, hosts, host_slots);
+
+  for (unsigned int h = 0; h < hosts.size(); h++)
+    {
+    std::vector<int> &slots = host_slots[hosts[h]];
+    eventent         *ep = event_alloc(IM_OBIT_TASKS, hosts[h], TM_NULL_EVENT, fromtask);
+
+    ep->ee_forward.fe_node = pjob->ji_nodeid;
+    ep->ee_forward.fe_event = tb->tb_id;
+    ep->ee_forward.fe_taskid = fromtask;
+
+    for (unsigned int i = 0; i < slots.size(); i++)
+      tb->tb_events[slots[i]] = ep->ee_event;
+    }
+
+  for (unsigned int slot = 0; slot < tasks.size(); slot++)
+    {
+    if (tb->tb_events[slot] == TM_NULL_EVENT)
+      tm_batch_watch(pjob, tb, slot);
+    }
+
+  send_batch_to_hosts(pjob, tb, IM_OBIT_TASKS, hosts, host_slots, where, NULL, NULL);
+
+  if (tb->tb_pending == 0)
+    *ret = tm_batch_reply(pjob, tb);
+
+  *reply_ptr = FALSE;
+
+  return(TM_DONE);
+  } /* END tm_obit_multi_request() */
+
+
+
+/*
+ * im_spawn_tasks
+ *
+ * Sender is mother superior starting a share of a tm_spawn_multi()
+ * request on this host.  The task ids were handed out by mother
+ * superior; the answer carries each one back, or TM_NULL_TASK for a
+ * task that could not be started.
+ *
+ * auxiliary info (
+ * parent node tm_node_id;
+ * count  int;
+ * node   tm_node_id;
+ * task id  tm_task_id;
+ * ...
+ * global id string;
+ * argv 0  string;
+ * ...
+ * ""
+ * envp 0  string;
+ * ...
+ * ""
+ * )
+ */
+
+int im_spawn_tasks(
+
+  struct tcp_chan    *chan,
+  job                *pjob,     /* M */
+  char               *cookie,   /* I */
+  tm_event_t          event,    /* I */
+  struct sockaddr_in *addr,     /* I */
+  tm_task_id          fromtask) /* I */
+
+  {
+  int                      ret;
+  int                      count = 0;
+  int                      local_socket;
+  struct tcp_chan         *local_chan = NULL;
+  tm_node_id               parentnode;
+  char                    *globid = NULL;
+  char                    *jobid = pjob->ji_qs.ji_jobid;
+  char                   **argv = NULL;
+  char                   **envp = NULL;
+  std::vector<tm_node_id>  nodes;
+  std::vector<tm_task_id>  tasks;
+
+  parentnode = disrsi(chan, &ret);
+
+  if (ret == DIS_SUCCESS)
+    count = disrsi(chan, &ret);
+
+  if ((ret == DIS_SUCCESS) &&
+      (count <= 0))
+    ret = DIS_PROTO;
+
+  for (int i = 0; (ret == DIS_SUCCESS) && (i < count); i++)
+    {
+    nodes.push_back(disrsi(chan, &ret));
+
+    if (ret == DIS_SUCCESS)
+      tasks.push_back(disrsi(chan, &ret));
+    }
+
+  if (ret == DIS_SUCCESS)
+    globid = disrst(chan, &ret);
+
+  if (ret == DIS_SUCCESS)
+    argv = read_batch_strings(chan, &ret);
+
+  if (ret == DIS_SUCCESS)
+    envp = read_batch_strings(chan, &ret);
+
+  if ((ret != DIS_SUCCESS) ||
+      (argv == NULL) ||
+      (argv[0] == NULL) ||
+      (envp == NULL))
+    {
+    if (globid != NULL)
+      free(globid);
+
+    arrayfree(argv);
+    arrayfree(envp);
+
+    return(IM_FAILURE);
+    }
+
+  if (LOGLEVEL >= 3)
+    {
+    sprintf(log_buffer, "INFO:     received request '%s' from %s for job '%s' (spawning %d tasks, globid='%s')",
+      PMOMCommand[IM_SPAWN_TASKS],
+      netaddr(addr),
+      jobid,
+      count,
+      globid);
+
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, jobid, log_buffer);
+    }
+
+  if ((pjob->ji_globid[0] == '\0') ||
+      (strcmp(pjob->ji_globid, noglobid) == 0))
+    {
+    snprintf(pjob->ji_globid, sizeof(pjob->ji_globid), "%s", globid);
+    }
+
+  free(globid);
+
+  for (int i = 0; i < count; i++)
+    tasks[i] = spawn_batch_task(pjob, argv, envp, nodes[i], parentnode, fromtask, tasks[i]);
+
+  arrayfree(argv);
+  arrayfree(envp);
+
+  if ((local_socket = get_reply_stream(pjob)) < 0)
+    ret = DIS_NOCOMMIT;
+  else if ((local_chan = DIS_tcp_setup(local_socket)) == NULL)
+    ret = DIS_NOMALLOC;
+  else if ((ret = im_compose(local_chan, jobid, cookie, IM_ALL_OKAY, event, fromtask)) == DIS_SUCCESS)
+    {
+    ret = diswsi(local_chan, count);
+
+    for (int i = 0; (ret == DIS_SUCCESS) && (i < count); i++)
+      ret = diswsi(local_chan, tasks[i]);
+
+    if (ret == DIS_SUCCESS)
+      ret = DIS_tcp_wflush(local_chan);
+    }
+
+  if (local_socket >= 0)
+    close(local_socket);
+
+  if (local_chan != NULL)
+    DIS_tcp_cleanup(local_chan);
+
+  if (ret != DIS_SUCCESS)
+    {
+    sprintf(log_buffer,
+      "ALERT:    received request '%s' from %s for job '%s' (tasks started but send response failed)",
+      PMOMCommand[IM_SPAWN_TASKS], netaddr(addr), jobid);
+
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, jobid, log_buffer);
+    }
+
+  return(IM_DONE);
+  } /* END im_spawn_tasks() */
+
+
+
+/*
+ * im_obit_tasks
+ *
+ * Sender is a MOM waiting for a list of tasks on this host to exit.  The
+ * exit values go back in one message once the last of them has exited,
+ * -1 for a task that is not here.
+ *
+ * auxiliary info (
+ * sending node tm_node_id;
+ * count  int;
+ * taskid  tm_task_id;
+ * ...
+ * )
+ */
+
+int im_obit_tasks(
+
+  struct tcp_chan *chan,
+  job             *pjob,     /* M */
+  char            *cookie,   /* I */
+  tm_event_t       event,    /* I */
+  tm_task_id       fromtask) /* I */
+
+  {
+  int        ret;
+  int        count = 0;
+  tm_node_id nodeid;
+  tm_batch  *tb;
+
+  nodeid = disrsi(chan, &ret);
+
+  if (ret == DIS_SUCCESS)
+    count = disrsi(chan, &ret);
+
+  if ((ret != DIS_SUCCESS) ||
+      (count <= 0))
+    return(IM_FAILURE);
+
+  if (find_node(pjob, chan->sock, nodeid) == NULL)
+    {
+    send_im_error(PBSE_BADHOST, 1, pjob, cookie, event, fromtask);
+
+    return(IM_DONE);
+    }
+
+  tb = tm_batch_create(pjob, IM_OBIT_TASKS, nodeid, event, fromtask, count);
+
+  for (int i = 0; i < count; i++)
+    {
+    tb->tb_tasks[i] = disrsi(chan, &ret);
+
+    if (ret != DIS_SUCCESS)
+      {
+      tm_batch_free(tb);
+
+      return(IM_FAILURE);
+      }
+    }
+
+  if (LOGLEVEL >= 3)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "%s: OBIT_TASKS %s from node %d for %d tasks",
+      __func__,
+      pjob->ji_qs.ji_jobid,
+      nodeid,
+      count);
+
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buffer);
+    }
+
+  for (int i = 0; i < count; i++)
+    tm_batch_watch(pjob, tb, i);
+
+  if (tb->tb_pending == 0)
+    tm_batch_reply(pjob, tb);
+
+  return(IM_DONE);
+  } /* END im_obit_tasks() */
+
+
+
+/*
+ * Sender is MOM answering an IM_SPAWN_TASKS or IM_OBIT_TASKS request
+ * for the batch named in efwd.
+ *
+ * auxiliary info (
+ * count  int;
+ * task id or exit value int;
+ * ...
+ * )
+ */
+
+int handle_im_batch_response(
+
+  struct tcp_chan *chan,
+  job             *pjob,  /* I */
+  fwdevent        *efwd,  /* I */
+  tm_event_t       event) /* I */
+
+  {
+  int       ret;
+  int       count;
+  int       value;
+  tm_batch *tb;
+
+  count = disrsi(chan, &ret);
+
+  if (ret != DIS_SUCCESS)
+    return(IM_FAILURE);
+
+  if ((tb = tm_batch_find(efwd->fe_event)) == NULL)
+    return(IM_DONE);
+
+  for (unsigned int slot = 0; slot < tb->tb_events.size(); slot++)
+    {
+    if (tb->tb_events[slot] != event)
+      continue;
+
+    if (count-- <= 0)
+      break;
+
+    value = disrsi(chan, &ret);
+
+    if (ret != DIS_SUCCESS)
+      {
+      tm_batch_abandon(pjob, efwd->fe_event, event);
+
+      return(IM_FAILURE);
+      }
+
+    tm_batch_fill(tb, slot, value);
+    }
+
+  /* anything the sister did not account for failed */
+  if (tm_batch_fill_event(tb, event, (tb->tb_command == TM_SPAWN_MULTI) ? TM_NULL_TASK : -1) == 0)
+    tm_batch_reply(pjob, tb);
+
+  return(IM_DONE);
+  } /* END handle_im_batch_response() */
+
+
+
+
+
+
+/*
+ * tm_getinfo_request
+ *
+ * Get named info for a specified task.
+ *
+ * read (
+ *  task   int
+ *  name   string
+ * )
+ */
+ 
+int tm_getinfo_request(
+ 
+  struct tcp_chan *chan,
+  job        *pjob,       /* I */
+  int         prev_error, /* I */
+  int         event,      /* I */
+  char       *cookie,     /* I */
+  int        *reply_ptr,  /* O */
+  int        *ret,        /* O */
+  tm_task_id  fromtask,   /* I */
+  hnodent    *phost,      /* M */
+  int         nodeid)     /* I */
+ 
+  {
+  int       taskid;
+  char     *jobid = pjob->ji_qs.ji_jobid;
+  char     *name;
+  task     *ptask;
+  infoent  *ip;
+
+#ifndef NUMA_SUPPORT 
+  int local_socket;
+  struct tcp_chan *local_chan = NULL;
+#endif
+  
+  taskid = disrui(chan, ret);
+  
+  if (*ret == DIS_SUCCESS)
+    {
+    name = disrst(chan, ret);
+    }
+  
+  if (*ret != DIS_SUCCESS)
+    return(TM_ERROR);
+  
+  if (LOGLEVEL >= 7)
+    {
+    snprintf(log_buffer,sizeof(log_buffer),
+      "%s: GETINFO %s from node %d task %d name %s\n",
+      __func__,
+      jobid,
+      nodeid,
+      taskid,
+      name);
+    
+    log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,jobid,log_buffer);
+    }
+  
+  if (prev_error)
+    {
+    free(name);
+    return(TM_DONE);
+    }
+  
+#ifndef NUMA_SUPPORT
+  if (is_nodeid_on_this_host(pjob, nodeid) == false)
+    {
+    /* not me */
+    event_alloc(IM_GET_INFO,phost,event,fromtask);
+    
+    local_socket = tcp_connect_sockaddr((struct sockaddr *)&phost->sock_addr,sizeof(phost->sock_addr), true);
+    
+    if (IS_VALID_STREAM(local_socket) == FALSE)
+      {
+      free(name);
+
+      return(TM_ERROR);
+      }
+    if ((local_chan = DIS_tcp_setup(local_socket)) == NULL)
+      {
+      }
     else if ((*ret = im_compose(local_chan,jobid,cookie,IM_GET_INFO,event,fromtask)) == DIS_SUCCESS)
       {
       if ((*ret = diswui(local_chan, pjob->ji_nodeid)) == DIS_SUCCESS)
@@ -8037,6 +9534,24 @@ int tm_request(
  
       break;
  
+    case TM_SPAWN_MULTI:
+
+      rc = tm_spawn_multi_request(ptask->ti_chan,pjob,event,&reply,&ret,fromtask);
+
+      if (rc == TM_ERROR)
+        goto err;
+
+      goto tm_req_finish;
+
+    case TM_OBIT_MULTI:
+
+      rc = tm_obit_multi_request(ptask->ti_chan,pjob,event,&reply,&ret,fromtask);
+
+      if (rc == TM_ERROR)
+        goto err;
+
+      goto tm_req_finish;
+ 
     case TM_REGISTER:
  
       sprintf(log_buffer, "REGISTER - NOT IMPLEMENTED %s",
@@ -9477,7 +10992,7 @@ void send_pmix_operation_via_stream(
                               TM_NULL_TASK)) != DIS_SUCCESS)
       {
       }
-    else if ((rc = diswst(local_chan, data.c_str())) != DIS_SUCCESS)
+    else if ((rc = diswcs(local_chan, data.c_str(), data.size())) != DIS_SUCCESS)
       {
       }
     else
@@ -9514,20 +11029,191 @@ void send_pmix_operation_via_stream(
 
 
 
-void report_fence_to_ms(
+/*
+ * open_pmix_stream()
+ *
+ * Connects to one of the job's hosts and starts a pmix message to it
+ *
+ * @param pjob - the job the message is about
+ * @param remote_host - the name of the host to send to
+ * @param pmix_op - the IM_* command of the message
+ * @return the channel to write the rest of the message on, or NULL if the host couldn't be reached
+ */
+
+struct tcp_chan *open_pmix_stream(
 
-  job  *pjob,
-  char *data)
+  job        *pjob,
+  const char *remote_host,
+  int         pmix_op)
 
   {
-  std::string      local_data;
-  int              stream = get_reply_stream(pjob);
+  struct tcp_chan *chan = NULL;
+  hnodent         *np = NULL;
+  int              stream;
 
-  if (data != NULL)
-    local_data = data;
+  for (int i = 0; i < pjob->ji_numnodes; i++)
+    {
+    if (!strcmp(remote_host, pjob->ji_hosts[i].hn_host))
+      {
+      np = pjob->ji_hosts + i;
+      break;
+      }
+    }
+
+  if (np == NULL)
+    return(NULL);
+
+  stream = tcp_connect_sockaddr((struct sockaddr *)&np->sock_addr, sizeof(np->sock_addr), true);
+
+  if (IS_VALID_STREAM(stream) == FALSE)
+    return(NULL);
+
+  if ((chan = DIS_tcp_setup(stream)) == NULL)
+    {
+    close(stream);
+    }
+  else if (im_compose(chan,
+                      pjob->ji_qs.ji_jobid,
+                      pjob->ji_wattr[JOB_ATR_Cookie].at_val.at_str,
+                      pmix_op,
+                      TM_NULL_EVENT,
+                      TM_NULL_TASK) != DIS_SUCCESS)
+    {
+    close(stream);
+    DIS_tcp_cleanup(chan);
+    chan = NULL;
+    }
+
+  return(chan);
+  } // END open_pmix_stream()
+
+
+
+/*
+ * finish_pmix_stream()
+ *
+ * Flushes and closes a channel from open_pmix_stream()
+ * @return PBSE_NONE if the message went out, or a DIS error
+ */
+
+int finish_pmix_stream(
+
+  struct tcp_chan *chan,
+  int              rc)
+
+  {
+  if (rc == DIS_SUCCESS)
+    rc = DIS_tcp_wflush(chan);
+
+  close(chan->sock);
+  DIS_tcp_cleanup(chan);
+
+  return(rc);
+  } // END finish_pmix_stream()
+
+
+
+/*
+ * report_fence_to_parent()
+ *
+ * Passes this host's fence data, along with everything its children in the fence tree
+ * sent it, up to its parent
+ */
+
+void report_fence_to_parent(
+
+  job               *pjob,
+  const char        *parent,
+  const std::string &data)
+
+  {
+  struct tcp_chan *chan = open_pmix_stream(pjob, parent, IM_FENCE);
+  int              rc = -1;
+
+  if (chan != NULL)
+    {
+    if ((rc = diswst(chan, mom_alias)) == DIS_SUCCESS)
+      rc = diswcs(chan, data.c_str(), data.size());
+
+    rc = finish_pmix_stream(chan, rc);
+    }
+
+  if (rc != PBSE_NONE)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "Couldn't pass fence data up to %s", parent);
+    log_err(-1, pjob->ji_qs.ji_jobid, log_buffer);
+    }
+  } // END report_fence_to_parent()
+
+
+
+/*
+ * request_modex_from_host()
+ *
+ * Asks the host running rank for its modex data. The answer comes back as IM_DMODEX_DATA.
+ * @return PBSE_NONE if the request went out
+ */
+
+int request_modex_from_host(
+
+  job        *pjob,
+  const char *remote_host,
+  int         rank)
+
+  {
+  struct tcp_chan *chan = open_pmix_stream(pjob, remote_host, IM_DMODEX_REQ);
+  int              rc = -1;
+
+  if (chan != NULL)
+    {
+    if ((rc = diswst(chan, mom_alias)) == DIS_SUCCESS)
+      rc = diswsi(chan, rank);
+
+    rc = finish_pmix_stream(chan, rc);
+    }
+
+  return(rc);
+  } // END request_modex_from_host()
+
+
+
+/*
+ * send_modex_data()
+ *
+ * Answers a direct modex request from another host
+ */
 
-  send_pmix_operation_via_stream(stream, pjob->ji_wattr[JOB_ATR_Cookie].at_val.at_str, pjob, local_data, IM_FENCE);
-  } // END report_fence_to_ms()
+void send_modex_data(
+
+  job               *pjob,
+  const char        *requestor,
+  int                rank,
+  int                status,
+  const std::string &data)
+
+  {
+  struct tcp_chan *chan = open_pmix_stream(pjob, requestor, IM_DMODEX_DATA);
+  int              rc = -1;
+
+  if (chan != NULL)
+    {
+    if ((rc = diswsi(chan, rank)) == DIS_SUCCESS)
+      {
+      if ((rc = diswsi(chan, status)) == DIS_SUCCESS)
+        rc = diswcs(chan, data.c_str(), data.size());
+      }
+
+    rc = finish_pmix_stream(chan, rc);
+    }
+
+  if (rc != PBSE_NONE)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "Couldn't send the modex data for rank %d to %s", rank, requestor);
+    log_err(-1, pjob->ji_qs.ji_jobid, log_buffer);
+    }
+  } // END send_modex_data()
         
 
 
@@ -3,6 +3,9 @@
 #include "license_pbs.h" /* See here for the software license */
 #include "tm_.h" /* tm_event_t */
 
+#include <string>
+#include <vector>
+
 /* Forward declarations */
 struct job;
 struct task;
@@ -14,6 +17,34 @@ struct sockaddr_in;
 struct resource;
 struct tcp_chan;
 
+/* hosts whose connections are opened together when contacting sisters */
+#define SISTER_CONNECT_BATCH   64
+/* seconds to wait for a batch of sister connections */
+#define SISTER_CONNECT_TIMEOUT 5
+
+/*
+ * A tm_spawn_multi() or tm_obit_multi() request, or a sister's share of
+ * a tm_obit_multi() request, waiting on its tasks.  Each slot holds the
+ * task id or exit value of one task in the order the tasks were
+ * requested, so the answer goes back in one message once every slot is
+ * filled.
+ */
+
+typedef struct tm_batch
+  {
+  int                     tb_id;
+  std::string             tb_jobid;
+  int                     tb_command;  /* TM_SPAWN_MULTI, TM_OBIT_MULTI or IM_OBIT_TASKS */
+  tm_node_id              tb_node;     /* node whose MOM gets an IM_OBIT_TASKS answer */
+  tm_event_t              tb_event;    /* event the answer is sent for */
+  tm_task_id              tb_fromtask; /* task the answer is sent to */
+  std::vector<tm_task_id> tb_tasks;    /* task each slot waits on */
+  std::vector<int>        tb_values;   /* task id or exit value of each slot */
+  std::vector<tm_event_t> tb_events;   /* sister event a slot waits on, TM_NULL_EVENT if local */
+  std::vector<bool>       tb_filled;
+  int                     tb_pending;  /* slots not yet filled */
+  } tm_batch;
+
 int task_save(struct task *ptask);
 
 struct eventent *event_alloc(int command, struct hnodent *pnode, tm_event_t event, tm_task_id taskid);
@@ -62,6 +93,10 @@ int im_signal_task(struct tcp_chan *chan, struct job *pjob, char *cookie, tm_eve
 
 int im_obit_task(struct tcp_chan *chan, struct job *pjob, char *cookie, tm_event_t event, tm_task_id fromtask);
 
+int im_spawn_tasks(struct tcp_chan *chan, struct job *pjob, char *cookie, tm_event_t event, struct sockaddr_in *addr, tm_task_id fromtask);
+
+int im_obit_tasks(struct tcp_chan *chan, struct job *pjob, char *cookie, tm_event_t event, tm_task_id fromtask);
+
 int im_get_info(struct tcp_chan *chan, struct job *pjob, char *cookie, tm_event_t event, tm_task_id fromtask);
 
 int im_get_resc_as_sister(struct tcp_chan *chan, struct job *pjob, char *cookie, tm_event_t event, tm_task_id fromtask);
@@ -84,6 +119,8 @@ int handle_im_get_tasks_response(struct tcp_chan *chan, struct job *pjob, tm_tas
 
 int handle_im_obit_task_response(struct tcp_chan *chan, struct job *pjob, tm_task_id event_task, tm_event_t event);
 
+int handle_im_batch_response(struct tcp_chan *chan, struct job *pjob, struct fwdevent *efwd, tm_event_t event);
+
 int handle_im_get_info_response(struct tcp_chan *chan, struct job *pjob, tm_task_id event_task, tm_event_t event);
 
 int handle_im_get_resc_response(struct tcp_chan *chan, struct job *pjob, tm_task_id event_task, tm_event_t event);
@@ -108,6 +145,28 @@ int tm_signal_request(struct tcp_chan *chan, struct job *pjob, int prev_error, i
 
 int tm_obit_request(struct tcp_chan *chan, struct job *pjob, int prev_error, int event, char *cookie, int *reply_ptr, int *ret, tm_task_id fromtask, struct hnodent *phost, int nodeid);
 
+int tm_spawn_multi_request(struct tcp_chan *chan, struct job *pjob, int event, int *reply_ptr, int *ret, tm_task_id fromtask);
+
+int tm_obit_multi_request(struct tcp_chan *chan, struct job *pjob, int event, int *reply_ptr, int *ret, tm_task_id fromtask);
+
+struct tm_batch *tm_batch_create(struct job *pjob, int command, tm_node_id node, tm_event_t event, tm_task_id fromtask, int count);
+
+struct tm_batch *tm_batch_find(int id);
+
+void tm_batch_free(struct tm_batch *tb);
+
+int tm_batch_fill(struct tm_batch *tb, int slot, int value);
+
+int tm_batch_fill_task(struct tm_batch *tb, tm_task_id taskid, int value);
+
+int tm_batch_fill_event(struct tm_batch *tb, tm_event_t event, int value);
+
+int tm_batch_reply(struct job *pjob, struct tm_batch *tb);
+
+void tm_batch_obit(struct job *pjob, int id, struct task *ptask);
+
+void tm_batch_abandon(struct job *pjob, int id, tm_event_t event);
+
 int tm_getinfo_request(struct tcp_chan *chan, struct job *pjob, int prev_error, int event, char *cookie, int *reply_ptr, int *ret, tm_task_id fromtask, struct hnodent *phost, int nodeid);
 
 int tm_resources_request(struct tcp_chan *chan, struct job *pjob, int prev_error, int event, char *cookie, int *reply_ptr, int *ret, tm_task_id fromtask, struct hnodent *phost, int nodeid);
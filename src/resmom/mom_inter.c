@@ -108,6 +108,9 @@
 #include "port_forwarding.h"
 #include "mom_config.h"
 
+/* bytes moved per read between the qsub socket and the job's pty */
+#define INTER_BUFSIZE  65536
+
 static char cc_array[PBS_TERM_CCA];
 
 static struct winsize wsz;
@@ -353,7 +356,7 @@ int mom_reader(
 
   {
   extern ssize_t read_blocking_socket(int fd, void *buf, ssize_t count);
-  char buf[1024];
+  static char buf[INTER_BUFSIZE];
   int c;
 
   /* read from the socket, and write to ptc */
@@ -434,7 +437,7 @@ int mom_writer(
   int ptc)
 
   {
-  char buf[1024];
+  static char buf[INTER_BUFSIZE];
   int c;
 
   /* read from ptc, and write to the socket */
@@ -504,6 +504,8 @@ job *mom_job_alloc(void)
 
 
 #ifdef ENABLE_PMIX
+void forget_pmix_job(const char *jobid);
+
 void deregister_jobs_nspace(
 
   job *pj)
@@ -516,6 +518,7 @@ void deregister_jobs_nspace(
     nspace.erase(pos);
 
   PMIx_server_deregister_nspace(nspace.c_str());
+  forget_pmix_job(pj->ji_qs.ji_jobid);
 
   if (LOGLEVEL >= 6)
     {
@@ -100,6 +100,8 @@
 #include "mcom.h"
 #include "mom_server_lib.h" /* shutdown_to_server */
 #include "node_frequency.hpp"
+#include "event_trace.h"
+#include "mom_snapshot.h"
 #include <string>
 #include <vector>
 #include "trq_cgroups.h"
@@ -292,6 +294,7 @@ extern void     mom_server_all_update_stat(void);
 extern void     mom_server_all_update_gpustat(void);
 void            empty_received_nodes();
 extern int      send_job_obit(job *, int);
+extern void     send_pending_obits(void);
 extern int      mom_checkpoint_init(void);
 extern void     mom_checkpoint_check_periodic_timer(job *pjob);
 extern void     mom_checkpoint_set_directory_path(const char *str);
@@ -5261,6 +5264,10 @@ int setup_program_environment(void)
     return(2);
     }
 
+  /* we won't fork away from here on, so records can be queued for a writer thread */
+  if (log_async_start() != PBSE_NONE)
+    log_err(-1, msg_daemonname, "could not start the log writer thread, logging synchronously");
+
 #if (PLOCK_DAEMONS & 4)
   /* lock daemon into memory */
 
@@ -6484,6 +6491,113 @@ time_t calculate_select_timeout() {
 
 
 
+/*
+ * update_mom_snapshot - rewrites mom_priv/status_snapshot from the jobs'
+ * latest poll so local monitoring agents can read it without asking us.
+ * Creates or removes the file when $status_snapshot has changed.
+ */
+
+void update_mom_snapshot(void)
+
+  {
+  static mom_snapshot_map     snapshot = { -1, 0, false, NULL };
+
+  char                        path[MAXPATHLEN];
+  mom_snapshot_header        *hdr;
+  double                      la;
+  uint32_t                    count = 0;
+  std::list<job *>::iterator  iter;
+
+  snprintf(path, sizeof(path), "%s/%s", mom_home, MOM_SNAPSHOT_FILE);
+
+  if (status_snapshot == false)
+    {
+    if (snapshot.sm_header != NULL)
+      {
+      mom_snapshot_detach(&snapshot);
+      unlink(path);
+      }
+
+    return;
+    }
+
+  if (snapshot.sm_header == NULL)
+    {
+    if (mom_snapshot_create(path, &snapshot) != PBSE_NONE)
+      {
+      snprintf(log_buffer, sizeof(log_buffer), "could not create the status snapshot %s", path);
+      log_err(errno, __func__, log_buffer);
+
+      status_snapshot = false;
+
+      return;
+      }
+    }
+
+  if (mom_snapshot_reserve(&snapshot, alljobs_list.size()) != PBSE_NONE)
+    {
+    snprintf(log_buffer, sizeof(log_buffer),
+      "could not grow the status snapshot for %d jobs, publishing what fits",
+      (int)alljobs_list.size());
+    log_err(errno, __func__, log_buffer);
+    }
+
+  if (get_la(&la) != 0)
+    la = 0.0;
+
+  mom_snapshot_begin(&snapshot);
+
+  hdr = snapshot.sm_header;
+
+  for (iter = alljobs_list.begin(); iter != alljobs_list.end(); iter++)
+    {
+    job              *pjob = *iter;
+    mom_snapshot_job *entry;
+
+    if ((entry = mom_snapshot_job_at(&snapshot, count)) == NULL)
+      break;
+
+    memset(entry, 0, sizeof(*entry));
+
+    snprintf(entry->mj_jobid, sizeof(entry->mj_jobid), "%s", pjob->ji_qs.ji_jobid);
+
+    if (pjob->ji_wattr[JOB_ATR_euser].at_val.at_str != NULL)
+      snprintf(entry->mj_owner, sizeof(entry->mj_owner), "%s", pjob->ji_wattr[JOB_ATR_euser].at_val.at_str);
+
+    entry->mj_state = pjob->ji_qs.ji_state;
+    entry->mj_substate = pjob->ji_qs.ji_substate;
+    entry->mj_mother_superior = (am_i_mother_superior(*pjob) == true) ? 1 : 0;
+    entry->mj_nodes = pjob->ji_numnodes;
+    entry->mj_tasks = pjob->ji_tasks->size();
+
+    if (pjob->ji_tasks->size() != 0)
+      entry->mj_session = pjob->ji_tasks->at(0)->ti_qs.ti_sid;
+
+    if (pjob->ji_wattr[JOB_ATR_start_time].at_flags & ATR_VFLAG_SET)
+      entry->mj_start_time = pjob->ji_wattr[JOB_ATR_start_time].at_val.at_long;
+
+    entry->mj_cput = resc_used(pjob, "cput", gettime);
+    entry->mj_walltime = resc_used(pjob, "walltime", gettime);
+    entry->mj_mem = resc_used(pjob, "mem", getsize);
+    entry->mj_vmem = resc_used(pjob, "vmem", getsize);
+
+    count++;
+    }
+
+  hdr->ms_updated = time_now;
+  hdr->ms_state = internal_state;
+  hdr->ms_ncpus = system_ncpus;
+  hdr->ms_job_count = count;
+  hdr->ms_polls++;
+  hdr->ms_loadave = la;
+  snprintf(hdr->ms_host, sizeof(hdr->ms_host), "%s", mom_alias);
+
+  mom_snapshot_end(&snapshot);
+  } /* END update_mom_snapshot() */
+
+
+
+
 /**
  * main_loop
  *
@@ -6513,6 +6627,22 @@ void main_loop(void)
 
     time_now = time(NULL);
 
+    /* $record_job_trace may have changed with a reconfig */
+    if (record_job_trace != trace_is_open())
+      {
+      if (record_job_trace == false)
+        trace_close();
+      else if (trace_open(path_log, TRACE_SOURCE_MOM) != PBSE_NONE)
+        {
+        sprintf(log_buffer, "could not open the job trace in %s", path_log);
+        log_err(errno, __func__, log_buffer);
+
+        record_job_trace = false;
+        }
+      }
+
+    trace_flush();
+
     /* check if loadave means we should be "busy" */
 
     if (max_load_val > 0.0)
@@ -6561,6 +6691,8 @@ void main_loop(void)
           examine_all_polled_jobs();
           }
         }
+
+      update_mom_snapshot();
       }
 
 #ifdef USESAVEDRESOURCES
@@ -6601,6 +6733,8 @@ void main_loop(void)
 
     TMOMScanForStarting();
 
+    send_pending_obits();
+
     /* unblock signals */
 
     if (sigprocmask(SIG_UNBLOCK, &allsigs, NULL) == -1)
@@ -85,6 +85,7 @@ static const int munge_on = 0;
 static void mom_close_client(int sfds);
 static void freebr_manage(struct rq_manage *);
 static void freebr_cpyfile(struct rq_cpyfile *);
+static void freebr_jobobit_batch(struct rq_jobobit_batch *);
 static void close_quejob(int sfds);
 
 /* END private prototypes */
@@ -681,6 +682,12 @@ void free_br(
 
       break;
 
+    case PBS_BATCH_JobObitBatch:
+
+      freebr_jobobit_batch(&preq->rq_ind.rq_jobobit_batch);
+
+      break;
+
     case PBS_BATCH_CopyFiles:
 
     case PBS_BATCH_DelFiles:
@@ -745,6 +752,30 @@ static void freebr_cpyfile(
 
 
 
+static void freebr_jobobit_batch(
+
+  struct rq_jobobit_batch *pbatch)
+
+  {
+  int i;
+
+  if (pbatch->rq_obits == NULL)
+    return;
+
+  for (i = 0; i < pbatch->rq_count; i++)
+    free_attrlist(&pbatch->rq_obits[i].rq_attr);
+
+  free(pbatch->rq_obits);
+
+  pbatch->rq_obits = NULL;
+  pbatch->rq_count = 0;
+
+  return;
+  }  /* END freebr_jobobit_batch() */
+
+
+
+
 
 /* END process_requests.c */
 
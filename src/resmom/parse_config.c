@@ -107,6 +107,7 @@ void encode_flagged_attrs(job *pjob, int perm, Json::Value *job_info, tlist_head
 /* these are the global variables we set or don't set as a result of the config file.
  * They should be externed in mom_config.h */
 bool             thread_unlink_calls = true;
+bool             record_job_trace = false;
 /* by default, enforce these policies */
 int              ignwalltime = 0; 
 int              ignmem = 0;
@@ -117,6 +118,13 @@ bool             check_rur = true; /* on by default */
 bool             force_file_overwrite = false;
 int              spoolasfinalname = 0;
 int              maxupdatesbeforesending = MAX_UPDATES_BEFORE_SENDING;
+int              copy_threads = DEFAULT_COPY_THREADS;
+int              copy_node_threads = 0;    /* no node wide limit */
+long             copy_bandwidth = 0;       /* MB/s for each copy request, 0 is unlimited */
+long             copy_node_bandwidth = 0;  /* MB/s for all copies on the node, 0 is unlimited */
+bool             copy_fsync = false;
+int              job_launch_radix = JOB_RADIX_AUTO;
+bool             status_snapshot = true;
 char            *apbasil_path     = NULL;
 char            *apbasil_protocol = NULL;
 int              reject_job_submit = 0;
@@ -284,6 +292,12 @@ unsigned long setreduceprologchecks(const char *);
 unsigned long setextpwdretry(const char *);
 unsigned long setexecwithexec(const char *);
 unsigned long setmaxupdatesbeforesending(const char *);
+unsigned long setcopythreads(const char *);
+unsigned long setcopynodethreads(const char *);
+unsigned long setcopybandwidth(const char *);
+unsigned long setcopynodebandwidth(const char *);
+unsigned long setcopyfsync(const char *);
+unsigned long setjoblaunchradix(const char *);
 unsigned long setthreadunlinkcalls(const char *);
 unsigned long setapbasilpath(const char *);
 unsigned long setapbasilprotocol(const char *);
@@ -299,6 +313,8 @@ unsigned long setmomhierarchyretrytime(const char *);
 unsigned long setjobdirectorysticky(const char *);
 unsigned long setcudavisibledevices(const char *);
 unsigned long set_presetup_prologue(const char *);
+unsigned long setrecordjobtrace(const char *);
+unsigned long setstatussnapshot(const char *);
 
 struct specials special[] = {
   { "force_overwrite",     setforceoverwrite}, 
@@ -384,6 +400,14 @@ struct specials special[] = {
   { "cuda_visible_devices", setcudavisibledevices},
   { "cray_check_rur",       setrur },
   { "presetup_prologue",    set_presetup_prologue},
+  { "record_job_trace",     setrecordjobtrace},
+  { "copy_threads",         setcopythreads},
+  { "copy_node_threads",    setcopynodethreads},
+  { "copy_bandwidth",       setcopybandwidth},
+  { "copy_node_bandwidth",  setcopynodebandwidth},
+  { "copy_fsync",           setcopyfsync},
+  { "job_launch_radix",     setjoblaunchradix},
+  { "status_snapshot",      setstatussnapshot},
   { NULL,                  NULL }
   };
 
@@ -1399,6 +1423,28 @@ u_long setjobdirectorysticky(
 
 
 
+/*
+ * setrecordjobtrace - $record_job_trace turns the binary job event trace on
+ * or off. main_loop() opens or closes the trace to match.
+ */
+
+u_long setrecordjobtrace(
+
+  const char *value)  /* I */
+
+  {
+  int enable;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  if ((enable = setbool(value)) != -1)
+    record_job_trace = (enable != 0);
+
+  return(1);
+  }  /* END setrecordjobtrace() */
+
+
+
 
 u_long addclient(
 
@@ -2009,6 +2055,183 @@ unsigned long setmaxupdatesbeforesending(
 
 
 
+/*
+ * setcopythreads - $copy_threads is the number of worker processes req_cpyfile()
+ * uses to copy files to local destinations. 0 copies every file with cp.
+ */
+
+unsigned long setcopythreads(
+
+  const char *value)
+
+  {
+  int i;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  i = (int)atoi(value);
+
+  if ((i < 0) ||
+      (i > MAX_COPY_THREADS))
+    return(0); /* error */
+
+  copy_threads = i;
+
+  return(1);
+  } /* END setcopythreads() */
+
+
+
+/*
+ * setcopynodethreads - $copy_node_threads limits the copies in flight for
+ * all copy requests on the node. 0 is no limit.
+ */
+
+unsigned long setcopynodethreads(
+
+  const char *value)
+
+  {
+  int i;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  i = (int)atoi(value);
+
+  if (i < 0)
+    return(0); /* error */
+
+  copy_node_threads = i;
+
+  return(1);
+  } /* END setcopynodethreads() */
+
+
+
+/*
+ * setcopybandwidth - $copy_bandwidth caps each copy request in MB/s
+ */
+
+unsigned long setcopybandwidth(
+
+  const char *value)
+
+  {
+  long l;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  l = atol(value);
+
+  if (l < 0)
+    return(0); /* error */
+
+  copy_bandwidth = l;
+
+  return(1);
+  } /* END setcopybandwidth() */
+
+
+
+/*
+ * setcopynodebandwidth - $copy_node_bandwidth caps all copies on the node in
+ * MB/s. It is split evenly over the $copy_node_threads slots.
+ */
+
+unsigned long setcopynodebandwidth(
+
+  const char *value)
+
+  {
+  long l;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  l = atol(value);
+
+  if (l < 0)
+    return(0); /* error */
+
+  copy_node_bandwidth = l;
+
+  return(1);
+  } /* END setcopynodebandwidth() */
+
+
+
+/*
+ * setcopyfsync - with $copy_fsync each copied file is synced before the copy
+ * is reported done, so a job's obit isn't sent until its output is on disk
+ */
+
+unsigned long setcopyfsync(
+
+  const char *value)
+
+  {
+  int enable;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  if ((enable = setbool(value)) != -1)
+    copy_fsync = (enable != 0);
+
+  return(1);
+  } /* END setcopyfsync() */
+
+
+
+/*
+ * setjoblaunchradix - $job_launch_radix sets the fan-out used to start and
+ * kill multi-node jobs that don't set job_radix themselves. 0 picks one from
+ * the job's node count, -1 has mother superior contact every sister itself.
+ */
+
+unsigned long setjoblaunchradix(
+
+  const char *value)
+
+  {
+  int i;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  i = (int)atoi(value);
+
+  if ((i < JOB_RADIX_FLAT) ||
+      (i == 1))
+    return(0); /* error */
+
+  job_launch_radix = i;
+
+  return(1);
+  } /* END setjoblaunchradix() */
+
+
+
+/*
+ * setstatussnapshot - $status_snapshot turns the mom_priv/status_snapshot
+ * file local monitoring agents read on or off. main_loop() creates or removes
+ * it to match.
+ */
+
+unsigned long setstatussnapshot(
+
+  const char *value)
+
+  {
+  int enable;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  if ((enable = setbool(value)) != -1)
+    status_snapshot = (enable != 0);
+
+  return(1);
+  } /* END setstatussnapshot() */
+
+
+
 
 
 unsigned long setumask(
@@ -2240,6 +2463,13 @@ void reset_config_vars()
   /* end policies */
   spoolasfinalname = 0;
   maxupdatesbeforesending = MAX_UPDATES_BEFORE_SENDING;
+  copy_threads = DEFAULT_COPY_THREADS;
+  copy_node_threads = 0;
+  copy_bandwidth = 0;
+  copy_node_bandwidth = 0;
+  copy_fsync = false;
+  job_launch_radix = JOB_RADIX_AUTO;
+  status_snapshot = true;
   apbasil_path     = NULL;
   apbasil_protocol = NULL;
   reject_job_submit = 0;
@@ -83,98 +83,541 @@
  * Standard Out and Standard Error of each task is bound to
  * stream sockets connected to pbs_demux which inputs from the
  * various streams and writes to the JOB's out and error.
+ *
+ * Streams are watched with epoll where available (poll() otherwise)
+ * so the number of tasks is bounded by the descriptor limit rather
+ * than FD_SETSIZE.  Each stream is read in large chunks and forwarded
+ * a line at a time, so output from different tasks never interleaves
+ * within a line.
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
 #include "server_limits.h"
 
 #include <sys/time.h>
+#include <sys/resource.h>
 #include <netdb.h>
 #include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif /* HAVE_SYS_EPOLL_H */
 #ifdef ENABLE_BLCR
 #include <libcr.h>
 #endif /* ENABLE_BLCR */
 
-#if defined(FD_SET_IN_SYS_SELECT_H)
-#  include <sys/select.h>
-#endif
 #include "lib_ifl.h"
 #include "pbs_helper.h"
+#include "pbs_demux.h"
+
+
+
+/*
+ * write_all - write all of data to fd, retrying short and interrupted
+ * writes
+ */
 
+static int write_all(
 
-enum rwhere {invalid, new_out, new_err, old_out, old_err};
+  int         fd,
+  const char *data,
+  size_t      len)
 
-struct routem
   {
-  enum rwhere r_where;
-  short  r_nl;
-  };
+  ssize_t rc;
 
-fd_set readset;
+  while (len > 0)
+    {
+    rc = write(fd, data, len);
 
+    if (rc < 0)
+      {
+      if (errno == EINTR)
+        continue;
 
-void readit(
+      return(-1);
+      }
+
+    data += rc;
+    len  -= rc;
+    }
+
+  return(0);
+  }  /* END write_all() */
+
+
+
+/*
+ * demux_write - forward data read from sock to fd
+ */
 
+static int demux_write(
+
+  int            fd,
   int            sock,
-  struct routem *prm)
+  struct routem *prm,
+  const char    *data,
+  size_t         len)
 
   {
-  int   amt;
-  char  buf[256];
-  FILE *fil;
-  int   i;
-  char *pc;
-
-  if (prm->r_where == old_out)
-    fil = stdout;
-  else
-    fil = stderr;
-
-  i = 0;
+#ifdef DEBUG
+  const char *nl;
+  char        prefix[32];
+  size_t      chunk;
 
-  if ((amt = read_ac_socket(sock, buf, 256)) > 0)
+  while (len > 0)
     {
+    if (prm->r_nl != 0)
+      {
+      snprintf(prefix, sizeof(prefix), "socket %d: ", sock);
 
-    for (pc = buf + i;pc < buf + amt;++pc)
+      if (write_all(fd, prefix, strlen(prefix)) < 0)
+        return(-1);
+
+      prm->r_nl = 0;
+      }
+
+    if ((nl = (const char *)memchr(data, '\n', len)) != NULL)
       {
-#ifdef DEBUG
+      chunk = nl - data + 1;
+      prm->r_nl = 1;
+      }
+    else
+      chunk = len;
 
-      if (prm->r_nl != 0)
-        {
-        fprintf(fil, "socket %d: ",
-                sock);
+    if (write_all(fd, data, chunk) < 0)
+      return(-1);
 
-        prm->r_nl = 0;
-        }
+    data += chunk;
+    len  -= chunk;
+    }
 
+  return(0);
+#else
+  return(write_all(fd, data, len));
 #endif /* DEBUG */
+  }  /* END demux_write() */
 
-      putc(*pc, fil);
 
-      if (*pc == '\n')
-        {
-        prm->r_nl = 1;
 
-        fflush(fil);
+/*
+ * hold_line - keep the start of a line until the rest of it arrives
+ */
+
+static int hold_line(
+
+  struct routem *prm,
+  const char    *data,
+  size_t         len)
+
+  {
+  char *line;
+
+  if ((line = (char *)realloc(prm->r_line, prm->r_line_len + len)) == NULL)
+    return(-1);
+
+  memcpy(line + prm->r_line_len, data, len);
+
+  prm->r_line = line;
+  prm->r_line_len += len;
+
+  return(0);
+  }  /* END hold_line() */
+
+
+
+/*
+ * readit - read what is waiting on a task's stream and forward every
+ * complete line to fd.  A trailing partial line is held until its
+ * newline arrives, the stream closes or it grows past DEMUX_BUFSIZE.
+ *
+ * @return the number of bytes read, or 0 once the stream has closed
+ */
+
+int readit(
+
+  int            sock,
+  struct routem *prm,
+  int            fd)
+
+  {
+  static char  buf[DEMUX_BUFSIZE];
+  ssize_t      amt;
+  const char  *nl;
+  size_t       complete;
+
+  if ((amt = read_ac_socket(sock, buf, sizeof(buf))) <= 0)
+    {
+    if (prm->r_line_len > 0)
+      demux_write(fd, sock, prm, prm->r_line, prm->r_line_len);
+
+    free(prm->r_line);
+
+    prm->r_line = NULL;
+    prm->r_line_len = 0;
+    prm->r_nl = 1;
+
+    close(sock);
+
+    prm->r_where = invalid;
+
+    return(0);
+    }
+
+  /* find the end of the last complete line */
+  nl = NULL;
+
+  for (const char *pc = buf + amt - 1; pc >= buf; pc--)
+    {
+    if (*pc == '\n')
+      {
+      nl = pc;
+      break;
+      }
+    }
+
+  if (nl == NULL)
+    {
+    if (hold_line(prm, buf, amt) < 0)
+      {
+      /* buf could not be held, send what was held ahead of it */
+      if (prm->r_line_len > 0)
+        {
+        demux_write(fd, sock, prm, prm->r_line, prm->r_line_len);
+        prm->r_line_len = 0;
         }
+
+      demux_write(fd, sock, prm, buf, amt);
+      }
+    else if (prm->r_line_len >= DEMUX_BUFSIZE)
+      {
+      /* no newline in sight, pass along what we have */
+      demux_write(fd, sock, prm, prm->r_line, prm->r_line_len);
+      prm->r_line_len = 0;
       }
+
+    return(amt);
+    }
+
+  complete = nl - buf + 1;
+
+  if ((prm->r_line_len > 0) &&
+      (hold_line(prm, buf, complete) == 0))
+    {
+    /* finish the held line so it goes out in a single write */
+    demux_write(fd, sock, prm, prm->r_line, prm->r_line_len);
     }
   else
     {
-    close(sock);
+    if (prm->r_line_len > 0)
+      demux_write(fd, sock, prm, prm->r_line, prm->r_line_len);
 
-    prm->r_where = invalid;
+    demux_write(fd, sock, prm, buf, complete);
+    }
 
-    FD_CLR(sock, &readset);
+  prm->r_line_len = 0;
+
+  if (complete < (size_t)amt)
+    {
+    if (hold_line(prm, buf + complete, amt - complete) < 0)
+      demux_write(fd, sock, prm, buf + complete, amt - complete);
     }
 
-  return;
+  return(amt);
   }  /* END readit() */
 
+
+
+/*
+ * demux_init - set up io to watch descriptors below maxfd, forwarding
+ * stdout streams to out and stderr streams to err
+ */
+
+int demux_init(
+
+  demux_io *io,
+  int       maxfd,
+  int       out,
+  int       err)
+
+  {
+  int i;
+
+  memset(io, 0, sizeof(*io));
+
+  io->di_out = out;
+  io->di_err = err;
+  io->di_maxfd = maxfd;
+  io->di_highfd = -1;
+  io->di_poll = -1;
+
+  io->di_routem = (struct routem *)calloc(maxfd, sizeof(struct routem));
+
+  if (io->di_routem == NULL)
+    return(-1);
+
+  for (i = 0;i < maxfd;++i)
+    {
+    io->di_routem[i].r_where = invalid;
+    io->di_routem[i].r_nl    = 1;
+    }
+
+#ifdef HAVE_SYS_EPOLL_H
+  if ((io->di_poll = epoll_create(DEMUX_MAX_EVENTS)) < 0)
+    {
+    free(io->di_routem);
+    io->di_routem = NULL;
+
+    return(-1);
+    }
+#endif /* HAVE_SYS_EPOLL_H */
+
+  return(0);
+  }  /* END demux_init() */
+
+
+
+/*
+ * demux_watch - start watching sock, a listening socket when where is
+ * new_out or new_err, or an accepted task stream otherwise
+ */
+
+int demux_watch(
+
+  demux_io    *io,
+  int          sock,
+  enum rwhere  where)
+
+  {
+  if ((sock < 0) || (sock >= io->di_maxfd))
+    return(-1);
+
+#ifdef HAVE_SYS_EPOLL_H
+  struct epoll_event ev;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = sock;
+
+  if (epoll_ctl(io->di_poll, EPOLL_CTL_ADD, sock, &ev) < 0)
+    return(-1);
+#endif /* HAVE_SYS_EPOLL_H */
+
+  io->di_routem[sock].r_where = where;
+  io->di_routem[sock].r_nl = 1;
+
+  if ((where == old_out) || (where == old_err))
+    io->di_streams++;
+
+  if (sock > io->di_highfd)
+    io->di_highfd = sock;
+
+  return(0);
+  }  /* END demux_watch() */
+
+
+
+/*
+ * demux_ready - handle one descriptor that has something to read
+ */
+
+static int demux_ready(
+
+  demux_io *io,
+  int       fd)
+
+  {
+  struct routem *prm = io->di_routem + fd;
+  int            newsock;
+  int            amt;
+
+  switch (prm->r_where)
+    {
+    case new_out:
+
+    case new_err:
+
+      newsock = accept(fd, 0, 0);
+
+      if (newsock < 0)
+        {
+        /* the connection went away or we are out of descriptors */
+        if ((errno != EINTR) &&
+            (errno != EAGAIN) &&
+            (errno != ECONNABORTED))
+          perror("accept");
+
+        break;
+        }
+
+      if (demux_watch(io, newsock, prm->r_where == new_out ? old_out : old_err) < 0)
+        {
+        perror("watching new stream");
+
+        close(newsock);
+        }
+
+      break;
+
+    case old_out:
+
+    case old_err:
+
+      amt = readit(fd, prm, prm->r_where == old_out ? io->di_out : io->di_err);
+
+      if (amt == 0)
+        io->di_streams--;
+      else
+        io->di_bytes += amt;
+
+      break;
+
+    default:
+
+      /* descriptor was closed earlier in this batch */
+
+      break;
+    }
+
+  return(0);
+  }  /* END demux_ready() */
+
+
+
+/*
+ * demux_once - wait up to timeout_ms for activity and handle it
+ *
+ * @return the number of descriptors handled, 0 on timeout or -1 on error
+ */
+
+int demux_once(
+
+  demux_io *io,
+  int       timeout_ms)
+
+  {
+  int n;
+  int i;
+
+#ifdef HAVE_SYS_EPOLL_H
+  struct epoll_event events[DEMUX_MAX_EVENTS];
+
+  n = epoll_wait(io->di_poll, events, DEMUX_MAX_EVENTS, timeout_ms);
+
+  if (n < 0)
+    return((errno == EINTR) ? 0 : -1);
+
+  for (i = 0;i < n;i++)
+    demux_ready(io, events[i].data.fd);
+#else
+  struct pollfd *fds;
+  int            count = 0;
+  int            handled = 0;
+
+  fds = (struct pollfd *)calloc(io->di_highfd + 1, sizeof(struct pollfd));
+
+  if (fds == NULL)
+    return(-1);
+
+  for (i = 0;i <= io->di_highfd;i++)
+    {
+    if (io->di_routem[i].r_where == invalid)
+      continue;
+
+    fds[count].fd = i;
+    fds[count].events = POLLIN;
+    count++;
+    }
+
+  n = poll(fds, count, timeout_ms);
+
+  if (n < 0)
+    {
+    free(fds);
+
+    return((errno == EINTR) ? 0 : -1);
+    }
+
+  for (i = 0;(i < count) && (handled < n);i++)
+    {
+    if (fds[i].revents == 0)
+      continue;
+
+    handled++;
+
+    demux_ready(io, fds[i].fd);
+    }
+
+  free(fds);
+#endif /* HAVE_SYS_EPOLL_H */
+
+  return(n);
+  }  /* END demux_once() */
+
+
+
+/*
+ * demux_loop - forward task output until our parent goes away
+ */
+
+int demux_loop(
+
+  demux_io *io,
+  pid_t     parent)
+
+  {
+  int n;
+
+  while (1)
+    {
+    if ((n = demux_once(io, DEMUX_TIMEOUT * 1000)) < 0)
+      return(-1);
+
+    /* NOTE:  on TRU64, init process does not have pid==1 */
+
+    if ((n == 0) &&
+        (getppid() != parent))
+      {
+#ifdef DEBUG
+      fprintf(stderr, "pbs_demux: Parent has gone, and so will I\n");
+#endif /* DEBUG */
+
+      break;
+      }
+    }    /* END while(1) */
+
+  return(0);
+  }  /* END demux_loop() */
+
+
+
+void demux_free(
+
+  demux_io *io)
+
+  {
+  int i;
+
+  if (io->di_routem != NULL)
+    {
+    for (i = 0;i <= io->di_highfd;i++)
+      free(io->di_routem[i].r_line);
+
+    free(io->di_routem);
+    io->di_routem = NULL;
+    }
+
+  if (io->di_poll >= 0)
+    {
+    close(io->di_poll);
+    io->di_poll = -1;
+    }
+  }  /* END demux_free() */
+
 #ifdef ENABLE_BLCR
 static int demux_callback(void* arg)
 {
@@ -193,17 +636,12 @@ int main(
   char *argv[])
 
   {
-  struct timeval timeout;
-  int i;
-  int maxfd;
-  int main_sock_out = 3;
-  int main_sock_err = 4;
-  int n;
-  int newsock;
-  pid_t parent;
-  fd_set selset;
-
-  struct routem *routem;
+  int           maxfd;
+  int           main_sock_out = 3;
+  int           main_sock_err = 4;
+  pid_t         parent;
+  struct rlimit rl;
+  demux_io      io;
 
 #ifdef ENABLE_BLCR
   if (cr_init() < 0)
@@ -236,6 +674,16 @@ int main(
   #endif
   */
 
+  /* one descriptor per task stream, so take all we are allowed */
+
+  if ((getrlimit(RLIMIT_NOFILE, &rl) == 0) &&
+      (rl.rlim_cur < rl.rlim_max))
+    {
+    rl.rlim_cur = rl.rlim_max;
+
+    setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
   if((maxfd = sysconf(_SC_OPEN_MAX)) < 0)
     {
     perror("unexpected return from sysconf.");
@@ -243,28 +691,13 @@ int main(
     exit(5);
     }
 
-  routem = (struct routem *)calloc(maxfd, sizeof(struct routem));
-
-  if (routem == NULL)
+  if (demux_init(&io, maxfd, fileno(stdout), fileno(stderr)) < 0)
     {
     perror("cannot alloc memory");
 
     exit(5);
     }
 
-  for (i = 0;i < maxfd;++i)
-    {
-    routem[i].r_where = invalid;
-    routem[i].r_nl    = 1;
-    }
-
-  routem[main_sock_out].r_where = new_out;
-  routem[main_sock_err].r_where = new_err;
-
-  FD_ZERO(&readset);
-  FD_SET(main_sock_out, &readset);
-  FD_SET(main_sock_err, &readset);
-
   if (listen(main_sock_out, TORQUE_LISTENQUEUE) < 0)
     {
     perror("listen on out");
@@ -279,92 +712,23 @@ int main(
     exit(5);
     }
 
-  while (1)
+  if ((demux_watch(&io, main_sock_out, new_out) < 0) ||
+      (demux_watch(&io, main_sock_err, new_err) < 0))
     {
-    selset = readset;
-    timeout.tv_usec = 0;
-    timeout.tv_sec  = 10;
-
-    n = select(FD_SETSIZE, &selset, (fd_set *)0, (fd_set *)0, &timeout);
-
-    if (n == -1)
-      {
-      if (errno == EINTR)
-        {
-        n = 0;
-        }
-      else
-        {
-        fprintf(stderr, "%s: select failed\n",
-          argv[0]);
-
-        exit(1);
-        }
-      }
-    else if (n == 0)
-      {
-      /* NOTE:  on TRU64, init process does not have pid==1 */
-
-      if (getppid() != parent)
-        {
-#ifdef DEBUG
-        fprintf(stderr, "%s: Parent has gone, and so will I\n",
-                argv[0]);
-#endif /* DEBUG */
-
-        break;
-        }
-      }    /* END else if (n == 0) */
-
-    for (i = 0;(n != 0) && (i < maxfd);++i)
-      {
-      if (FD_ISSET(i, &selset))
-        {
-        /* this socket has data */
-        n--;
-
-        switch ((routem + i)->r_where)
-          {
-
-          case new_out:
-
-          case new_err:
-
-            newsock = accept(i, 0, 0);
+    perror("watching listen sockets");
 
-            (routem + newsock)->r_where = (routem + i)->r_where == new_out ?
-            old_out :
-            old_err;
-
-            FD_SET(newsock, &readset);
-
-            break;
-
-          case old_out:
-
-          case old_err:
-
-            readit(i, routem + i);
-
-            break;
-
-          default:
-
-            fprintf(stderr, "%s: internal error\n",
-                    argv[0]);
-
-            exit(2);
+    exit(5);
+    }
 
-            /*NOTREACHED*/
+  if (demux_loop(&io, parent) < 0)
+    {
+    fprintf(stderr, "%s: wait for task output failed\n",
+      argv[0]);
 
-            break;
-          }
-        }
-      }
-    }    /* END while(1) */
+    exit(1);
+    }
 
   return(0);
   }  /* END main() */
 
 /* END pbs_demux.c */
-
@@ -2,6 +2,14 @@
 #define _PBS_DEMUX_H
 #include "license_pbs.h" /* See here for the software license */
 
+#include <sys/types.h>
+
+/* bytes read from a task's stream at a time */
+#define DEMUX_BUFSIZE      65536
+/* ready descriptors handled per wakeup */
+#define DEMUX_MAX_EVENTS   256
+/* seconds between checks that our parent is still around */
+#define DEMUX_TIMEOUT      10
 
 enum rwhere {invalid, new_out, new_err, old_out, old_err};
 
@@ -9,9 +17,33 @@ struct routem
   {
   enum rwhere r_where;
   short  r_nl;
+  char  *r_line;      /* start of a line still waiting for its newline */
+  size_t r_line_len;
   };
 
-void readit(int sock, struct routem *prm);
+typedef struct demux_io
+  {
+  int                 di_out;       /* where old_out streams are written */
+  int                 di_err;       /* where old_err streams are written */
+  struct routem      *di_routem;    /* indexed by descriptor */
+  int                 di_maxfd;
+  int                 di_highfd;    /* highest descriptor being watched */
+  int                 di_poll;      /* epoll descriptor, -1 when using poll() */
+  int                 di_streams;   /* task streams currently open */
+  unsigned long long  di_bytes;     /* bytes forwarded */
+  } demux_io;
+
+int  readit(int sock, struct routem *prm, int fd);
+
+int  demux_init(demux_io *io, int maxfd, int out, int err);
+
+int  demux_watch(demux_io *io, int sock, enum rwhere where);
+
+int  demux_once(demux_io *io, int timeout_ms);
+
+int  demux_loop(demux_io *io, pid_t parent);
+
+void demux_free(demux_io *io);
 
 /* #ifdef ENABLE_BLCR */
 /* static int demux_callback(void* arg); */
@@ -10,7 +10,9 @@
 #include "mom_func.h"
 
 job *mom_find_job_by_int_string(const char *);
-void report_fence_to_ms(job *pjob, char *data);
+void report_fence_to_parent(job *pjob, const char *parent, const std::string &data);
+int  request_modex_from_host(job *pjob, const char *remote_host, int rank);
+void send_modex_data(job *pjob, const char *requestor, int rank, int status, const std::string &data);
 int start_process(task *ptask, char **argv, char **envp);
 int send_tm_spawn_request(job *pjob, hnodent *remote_host, char **argv, char **env, int event, int fromtask, int *reply_ptr);
 
@@ -123,14 +125,17 @@ pmix_status_t pmix_server_abort(
 
 
 std::map<std::string, pmix_operation> pending_fences;
+std::map<std::string, std::map<int, std::string> > modex_cache;
+std::map<std::string, std::map<int, std::vector<dmodex_waiter> > > dmodex_waiting;
 
 
 
 /*
  * check_and_record_fence()
  *
- * Adds this fence operation if it isn't already pending; if it isn't create it.
- * @return true if the fence operation is now complete
+ * Records that this host's clients have entered the fence, taking in anything our children
+ * in the fence tree sent before they did.
+ * @return true if this host's part of the fence is now complete
  */
 
 bool check_and_record_fence(
@@ -139,22 +144,19 @@ bool check_and_record_fence(
   const std::string   &jobid,
   const pmix_proc_t    procs[],
   size_t               nprocs,
-  char                *data,
+  const std::string   &info,
   const std::string   &mom_host,
   pmix_modex_cbfunc_t  cbfunc,
   void                *cbdata)
 
   {
-  std::string info;
+  std::map<std::string, pmix_operation>::iterator it = pending_fences.find(jobid);
+  pmix_operation                                  fence(pjob, procs, nprocs, info, cbfunc, cbdata);
 
-  if (data != NULL)
-    info = data;
+  if (it != pending_fences.end())
+    fence.absorb(it->second);
 
-  if (pending_fences.find(jobid) == pending_fences.end())
-    {
-    pmix_operation fence(pjob, procs, nprocs, info, cbfunc, cbdata);
-    pending_fences[jobid] = fence;
-    }
+  pending_fences[jobid] = fence;
 
   return(pending_fences[jobid].mark_reported(mom_host));
   } // END check_and_record_fence()
@@ -166,14 +168,108 @@ void notify_fence_complete(
   job *pjob)
 
   {
-  if (pending_fences.find(pjob->ji_qs.ji_jobid) != pending_fences.end())
+  std::map<std::string, pmix_operation>::iterator it = pending_fences.find(pjob->ji_qs.ji_jobid);
+
+  if (it != pending_fences.end())
     {
-    pending_fences[pjob->ji_qs.ji_jobid].complete_operation(pjob, 0);
+    pmix_operation fence(it->second);
+
+    // Our children may start the job's next fence as soon as they hear about this one
+    pending_fences.erase(it);
+    fence.complete_operation(pjob, 0);
     }
   } // END notify_fence_complete()
 
 
 
+/*
+ * fence_subtree_complete()
+ *
+ * This host and everything below it in the fence tree have reported. The root completes
+ * the fence; everyone else passes the data up to their parent.
+ */
+
+void fence_subtree_complete(
+
+  job *pjob)
+
+  {
+  std::map<std::string, pmix_operation>::iterator it = pending_fences.find(pjob->ji_qs.ji_jobid);
+
+  if (it == pending_fences.end())
+    return;
+
+  if (it->second.get_parent().size() == 0)
+    notify_fence_complete(pjob);
+  else
+    report_fence_to_parent(pjob, it->second.get_parent().c_str(), it->second.get_data());
+  } // END fence_subtree_complete()
+
+
+
+/*
+ * record_fence_contribution()
+ *
+ * A child in the fence tree has sent up the data for itself and everything below it
+ *
+ * @param pjob - the job the fence belongs to
+ * @param host - the child that sent it
+ * @param data - the modex data of the child's subtree
+ */
+
+void record_fence_contribution(
+
+  job               *pjob,
+  const char        *host,
+  const std::string &data)
+
+  {
+  std::string jobid(pjob->ji_qs.ji_jobid);
+
+  if (pending_fences.find(jobid) == pending_fences.end())
+    {
+    // A child can get here before our own clients enter the fence
+    pmix_operation early;
+    pending_fences[jobid] = early;
+    }
+
+  pmix_operation &fence = pending_fences[jobid];
+
+  fence.add_data(data);
+
+  if (fence.mark_reported(host) == true)
+    fence_subtree_complete(pjob);
+  } // END record_fence_contribution()
+
+
+
+/*
+ * release_fence()
+ *
+ * Our parent in the fence tree has sent down the data of the whole fence. Pass it on to our
+ * children and hand it to our local clients.
+ */
+
+void release_fence(
+
+  job               *pjob,
+  const std::string &all_data)
+
+  {
+  std::map<std::string, pmix_operation>::iterator it = pending_fences.find(pjob->ji_qs.ji_jobid);
+
+  if (it == pending_fences.end())
+    {
+    log_err(-1, pjob->ji_qs.ji_jobid, "Received the result of a fence this host isn't in");
+    return;
+    }
+
+  it->second.set_data(all_data);
+  notify_fence_complete(pjob);
+  } // END release_fence()
+
+
+
 /*
  * pmix_server_fencenb()
  *
@@ -199,15 +295,13 @@ pmix_status_t pmix_server_fencenb(
 
   if (pjob != NULL)
     {
-    if (am_i_mother_superior(*pjob) == false)
-      {
-      check_and_record_fence(NULL, procs[0].nspace, procs, nprocs, data, mom_alias, cbfunc, cbdata);
-      report_fence_to_ms(pjob, data);
-      }
-    else if (check_and_record_fence(pjob, procs[0].nspace, procs, nprocs, data, mom_alias, cbfunc, cbdata) == true)
-      {
-      notify_fence_complete(pjob);
-      }
+    std::string local_data;
+
+    if (data != NULL)
+      local_data.assign(data, ndata);
+
+    if (check_and_record_fence(pjob, pjob->ji_qs.ji_jobid, procs, nprocs, local_data, mom_alias, cbfunc, cbdata) == true)
+      fence_subtree_complete(pjob);
     }
   else
     rc = PMIX_ERR_NOT_FOUND;
@@ -217,6 +311,14 @@ pmix_status_t pmix_server_fencenb(
 
 
 
+/*
+ * pmix_server_dmodex_req()
+ *
+ * A local client wants the modex data of a rank whose data wasn't collected by a fence.
+ * Answers come from the node-local cache when we can. Otherwise the rank's host is asked,
+ * once no matter how many local clients are waiting on the same rank.
+ */
+
 pmix_status_t pmix_server_dmodex_req(
 
   const pmix_proc_t   *proc,
@@ -226,11 +328,184 @@ pmix_status_t pmix_server_dmodex_req(
   void                *cbdata)
 
   {
-  return(PMIX_ERR_NOT_SUPPORTED);
+  job         *pjob = mom_find_job_by_int_string(proc->nspace);
+  std::string  jobid;
+  int          rank;
+
+  if (pjob == NULL)
+    return(PMIX_ERR_NOT_FOUND);
+
+  if (proc->rank >= (pmix_rank_t)pjob->ji_numvnod)
+    return(PMIX_ERR_BAD_PARAM);
+
+  jobid = pjob->ji_qs.ji_jobid;
+  rank = proc->rank;
+
+  std::map<int, std::string> &cached = modex_cache[jobid];
+  std::map<int, std::string>::iterator it = cached.find(rank);
+
+  if (it != cached.end())
+    {
+    pass_modex_data(cbfunc, cbdata, PMIX_SUCCESS, it->second);
+    return(PMIX_SUCCESS);
+    }
+
+  const char *remote_host = pjob->ji_vnods[rank].vn_host->hn_host;
+
+  // Our own server already has everything its clients put
+  if (!strcmp(remote_host, mom_alias))
+    return(PMIX_ERR_NOT_FOUND);
+
+  std::vector<dmodex_waiter> &waiting = dmodex_waiting[jobid][rank];
+
+  waiting.push_back(dmodex_waiter(cbfunc, cbdata));
+
+  if ((waiting.size() == 1) &&
+      (request_modex_from_host(pjob, remote_host, rank) != PBSE_NONE))
+    {
+    dmodex_waiting[jobid].erase(rank);
+    return(PMIX_ERROR);
+    }
+
+  return(PMIX_SUCCESS);
   } // END pmix_dmodex_req()
 
 
 
+class modex_request
+  {
+  public:
+  std::string nspace;
+  std::string requestor;
+  int         rank;
+
+  modex_request(const std::string &ns, const char *req, int r) : nspace(ns), requestor(req), rank(r) {}
+  };
+
+
+
+void modex_request_done(
+
+  pmix_status_t  status,
+  char          *data,
+  size_t         sz,
+  void          *cbdata)
+
+  {
+  modex_request *req = (modex_request *)cbdata;
+  job           *pjob = mom_find_job_by_int_string(req->nspace.c_str());
+  std::string    modex;
+
+  if (data != NULL)
+    modex.assign(data, sz);
+
+  if (pjob != NULL)
+    send_modex_data(pjob, req->requestor.c_str(), req->rank, status, modex);
+
+  delete req;
+  } // END modex_request_done()
+
+
+
+/*
+ * serve_modex_request()
+ *
+ * Another host wants the modex data for one of our ranks. Our PMIx server gets it and we
+ * send it back once it does.
+ *
+ * @param pjob - the job the rank belongs to
+ * @param requestor - the host that asked
+ * @param rank - the rank whose data is wanted
+ */
+
+void serve_modex_request(
+
+  job        *pjob,
+  const char *requestor,
+  int         rank)
+
+  {
+  std::string    nspace(pjob->ji_qs.ji_jobid);
+  size_t         pos = nspace.find(".");
+  pmix_proc_t    proc;
+  pmix_status_t  rc;
+
+  if (pos != std::string::npos)
+    nspace.erase(pos);
+
+  memset(&proc, 0, sizeof(proc));
+  snprintf(proc.nspace, sizeof(proc.nspace), "%s", nspace.c_str());
+  proc.rank = rank;
+
+  modex_request *req = new modex_request(nspace, requestor, rank);
+
+  if ((rc = PMIx_server_dmodex_request(&proc, modex_request_done, req)) != PMIX_SUCCESS)
+    {
+    send_modex_data(pjob, requestor, rank, rc, "");
+    delete req;
+    }
+  } // END serve_modex_request()
+
+
+
+/*
+ * deliver_modex()
+ *
+ * The modex data we asked another host for has arrived. Cache it and answer everyone
+ * waiting on it.
+ */
+
+void deliver_modex(
+
+  job               *pjob,
+  int                rank,
+  int                status,
+  const std::string &data)
+
+  {
+  std::string                 jobid(pjob->ji_qs.ji_jobid);
+  std::vector<dmodex_waiter>  waiting;
+
+  std::map<std::string, std::map<int, std::vector<dmodex_waiter> > >::iterator it = dmodex_waiting.find(jobid);
+
+  if (it != dmodex_waiting.end())
+    {
+    std::map<int, std::vector<dmodex_waiter> >::iterator rit = it->second.find(rank);
+
+    if (rit != it->second.end())
+      {
+      waiting.swap(rit->second);
+      it->second.erase(rit);
+      }
+    }
+
+  if (status == PMIX_SUCCESS)
+    modex_cache[jobid][rank] = data;
+
+  for (size_t i = 0; i < waiting.size(); i++)
+    pass_modex_data(waiting[i].cbfunc, waiting[i].cbdata, status, data);
+  } // END deliver_modex()
+
+
+
+/*
+ * forget_pmix_job()
+ *
+ * Drops the fence and modex state kept for a job that is going away
+ */
+
+void forget_pmix_job(
+
+  const char *jobid)
+
+  {
+  pending_fences.erase(jobid);
+  modex_cache.erase(jobid);
+  dmodex_waiting.erase(jobid);
+  } // END forget_pmix_job()
+
+
+
 pmix_status_t pmix_server_publish(
 
   const pmix_proc_t *proc,
@@ -3,6 +3,8 @@
 
 #ifdef ENABLE_PMIX
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <signal.h>
 
 #include "pmix_operation.hpp"
@@ -13,6 +15,7 @@ extern char mom_alias[];
 
 void remote_notify_pmix_operation(job *pjob, const char *remote_host, const std::string &data,
                                   int op, struct sockaddr_in *dont_contact);
+int  choose_job_radix(int nodenum);
 
 const int FENCE_OPERATION = 0;
 const int CONNECT_OPERATION = 1;
@@ -25,6 +28,123 @@ std::map<unsigned int, pmix_operation> existing_connections;
 
 
 
+/*
+ * fence_tree_parent()
+ *
+ * Fences are gathered up a tree of the hosts taking part, in the order they appear in the job.
+ * Host index has children index * radix + 1 through index * radix + radix, so every host can
+ * work out its place without asking anyone. A radix of 0 hangs everyone off the first host.
+ *
+ * @param index - this host's position among the hosts in the fence
+ * @param radix - the fan-out of the tree
+ * @return the position of this host's parent, or -1 for the root
+ */
+
+int fence_tree_parent(
+
+  int index,
+  int radix)
+
+  {
+  if (index <= 0)
+    return(-1);
+  else if (radix <= 0)
+    return(0);
+
+  return((index - 1) / radix);
+  } // END fence_tree_parent()
+
+
+
+/*
+ * fence_tree_children()
+ *
+ * @param index - this host's position among the hosts in the fence
+ * @param count - the number of hosts in the fence
+ * @param radix - the fan-out of the tree, 0 for flat
+ * @param kids (O) - the positions of this host's children
+ */
+
+void fence_tree_children(
+
+  int               index,
+  int               count,
+  int               radix,
+  std::vector<int> &kids)
+
+  {
+  int first;
+  int last;
+
+  kids.clear();
+
+  if (radix <= 0)
+    {
+    if (index != 0)
+      return;
+
+    first = 1;
+    last = count;
+    }
+  else
+    {
+    first = index * radix + 1;
+    last = first + radix;
+
+    if (last > count)
+      last = count;
+    }
+
+  for (int i = first; i < last; i++)
+    kids.push_back(i);
+  } // END fence_tree_children()
+
+
+
+void free_modex_copy(
+
+  void *cbdata)
+
+  {
+  free(cbdata);
+  } // END free_modex_copy()
+
+
+
+/*
+ * pass_modex_data()
+ *
+ * Hands modex data to a PMIx server callback. The server may keep the pointer until it
+ * calls the release function, so it gets its own copy.
+ */
+
+void pass_modex_data(
+
+  pmix_modex_cbfunc_t  cbfunc,
+  void                *cbdata,
+  pmix_status_t        status,
+  const std::string   &modex)
+
+  {
+  char *copy;
+
+  if (cbfunc == NULL)
+    return;
+
+  if ((copy = (char *)malloc(modex.size() + 1)) == NULL)
+    {
+    cbfunc(PMIX_ERR_NOMEM, NULL, 0, cbdata, NULL, NULL);
+    return;
+    }
+
+  memcpy(copy, modex.data(), modex.size());
+  copy[modex.size()] = '\0';
+
+  cbfunc(status, copy, modex.size(), cbdata, free_modex_copy, copy);
+  } // END pass_modex_data()
+
+
+
 bool pmix_operation::safe_insert_rank(
 
   job *pjob,
@@ -65,32 +185,92 @@ pmix_operation::pmix_operation(
   size_t               nprocs,
   const std::string   &info,
   pmix_modex_cbfunc_t  cbfunc,
-  void                *rdata) : data(info), hosts_reported(), hosts_to_report(), local_ranks(),
-                                all_ranks(), to_call_fence(cbfunc), to_call_connect(NULL),
-                                op_id(0), complete(false), type(FENCE_OPERATION), cbdata(rdata)
+  void                *rdata) : data(info), hosts_reported(), hosts_to_report(), parent(),
+                                children(), joined(true), local_ranks(), all_ranks(),
+                                to_call_fence(cbfunc), to_call_connect(NULL), op_id(0),
+                                complete(false), type(FENCE_OPERATION), cbdata(rdata)
 
   {
-  // if pjob is NULL, we are not mother superior
   if (pjob != NULL)
     {
-    for (size_t i = 0; i < nprocs; i++)
+    this->jobid = pjob->ji_qs.ji_jobid;
+    this->build_fence_tree(pjob, procs, nprocs);
+    }
+  } // END constructor used for fence requests
+
+
+
+/*
+ * build_fence_tree()
+ *
+ * Works out this host's parent and children in the tree the fence is gathered over. The
+ * fence waits for this host and its children; the data then goes to the parent, and the
+ * root sends the combined data back down the tree.
+ *
+ * @param pjob - the job the fence belongs to
+ * @param procs - the processes taking part, as given to us by the PMIx server
+ * @param nprocs - the number of entries in procs
+ */
+
+void pmix_operation::build_fence_tree(
+
+  job               *pjob,
+  const pmix_proc_t  procs[],
+  size_t             nprocs)
+
+  {
+  std::set<int>    host_indices;
+  std::vector<int> members;
+  std::vector<int> kids;
+  int              me = -1;
+  int              radix;
+  int              up;
+
+  for (size_t i = 0; i < nprocs; i++)
+    {
+    if (procs[i].rank == PMIX_RANK_WILDCARD)
       {
-      if (this->safe_insert_rank(pjob, procs[i].rank) == false)
-        {
-        // Fence is asking for a rank that shouldn't exist on this job?
-        snprintf(log_buffer, sizeof(log_buffer),
-          "Fence request from PMIx server requested rank %d but we only have %d ranks",
-          procs[i].rank, pjob->ji_numvnod);
-        log_err(-1, pjob->ji_qs.ji_jobid, log_buffer);
-        }
+      for (int h = 0; h < pjob->ji_numnodes; h++)
+        host_indices.insert(h);
+      }
+    else if (procs[i].rank < (pmix_rank_t)pjob->ji_numvnod)
+      host_indices.insert(pjob->ji_vnods[procs[i].rank].vn_host - pjob->ji_hosts);
+    else
+      {
+      // Fence is asking for a rank that shouldn't exist on this job?
+      snprintf(log_buffer, sizeof(log_buffer),
+        "Fence request from PMIx server requested rank %u but we only have %d ranks",
+        procs[i].rank, pjob->ji_numvnod);
+      log_err(-1, pjob->ji_qs.ji_jobid, log_buffer);
       }
     }
-  else
+
+  for (std::set<int>::iterator it = host_indices.begin(); it != host_indices.end(); it++)
     {
-    // We are a sister. Mother superior will send the data later
-    this->data.clear();
+    if (!strcmp(pjob->ji_hosts[*it].hn_host, mom_alias))
+      me = members.size();
+
+    members.push_back(*it);
     }
-  } // END constructor used for fence requests
+
+  this->hosts_to_report.insert(mom_alias);
+
+  if (me == -1)
+    return;
+
+  radix = choose_job_radix(members.size());
+
+  if ((up = fence_tree_parent(me, radix)) >= 0)
+    this->parent = pjob->ji_hosts[members[up]].hn_host;
+
+  fence_tree_children(me, members.size(), radix, kids);
+
+  for (size_t i = 0; i < kids.size(); i++)
+    {
+    this->children.insert(pjob->ji_hosts[members[kids[i]]].hn_host);
+    this->hosts_to_report.insert(pjob->ji_hosts[members[kids[i]]].hn_host);
+    }
+  } // END build_fence_tree()
 
 
 
@@ -110,9 +290,9 @@ int get_pmix_connection_id()
 pmix_operation::pmix_operation(
 
   char *connect_data,
-  job  *pjob) : data(), hosts_reported(), hosts_to_report(), local_ranks(), all_ranks(),
-                to_call_fence(NULL), to_call_connect(NULL), op_id(0), complete(false),
-                type(CONNECT_OPERATION), cbdata(NULL)
+  job  *pjob) : data(), hosts_reported(), hosts_to_report(), parent(), children(), joined(true),
+                local_ranks(), all_ranks(), to_call_fence(NULL), to_call_connect(NULL), op_id(0),
+                complete(false), type(CONNECT_OPERATION), cbdata(NULL)
 
   {
   char *ptr = connect_data;
@@ -147,9 +327,10 @@ pmix_operation::pmix_operation(
   const pmix_proc_t  procs[],
   size_t             nprocs,
   pmix_op_cbfunc_t   cbfunc,
-  void              *rdata) : data(), hosts_reported(), hosts_to_report(), local_ranks(),
-                              all_ranks(), to_call_fence(NULL), to_call_connect(cbfunc), op_id(0),
-                              complete(false), type(CONNECT_OPERATION), cbdata(rdata)
+  void              *rdata) : data(), hosts_reported(), hosts_to_report(), parent(), children(),
+                              joined(true), local_ranks(), all_ranks(), to_call_fence(NULL),
+                              to_call_connect(cbfunc), op_id(0), complete(false),
+                              type(CONNECT_OPERATION), cbdata(rdata)
 
   {
   for (size_t i = 0; i < nprocs; i++)
@@ -177,8 +358,9 @@ pmix_operation::pmix_operation(
   size_t             nprocs,
   pmix_op_cbfunc_t   cbfunc,
   void              *rdata,
-  int                op_type) : data(), hosts_reported(), hosts_to_report(), local_ranks(),
-                              all_ranks(), to_call_fence(NULL), to_call_connect(cbfunc), op_id(0),
+  int                op_type) : data(), hosts_reported(), hosts_to_report(), parent(),
+                              children(), joined(true), local_ranks(), all_ranks(),
+                              to_call_fence(NULL), to_call_connect(cbfunc), op_id(0),
                               complete(false), type(op_type), cbdata(rdata)
 
   {
@@ -210,7 +392,12 @@ bool pmix_operation::mark_reported(
   std::set<std::string>::iterator it = this->hosts_to_report.find(hostname);
   bool done = false;
 
-  if (it != this->hosts_to_report.end())
+  if (this->joined == false)
+    {
+    // Our own clients haven't entered the fence yet, so we don't know who to wait for
+    this->hosts_reported.insert(hostname);
+    }
+  else if (it != this->hosts_to_report.end())
     {
     // Found
     this->hosts_to_report.erase(it);
@@ -229,13 +416,37 @@ bool pmix_operation::mark_reported(
 
   return(done);
   } // END mark_reported()
+
+
+
+/*
+ * absorb()
+ *
+ * Takes in the data and reports that arrived from children before this host's own clients
+ * entered the fence.
+ *
+ * @param early - the placeholder operation that collected them
+ */
+
+void pmix_operation::absorb(
+
+  const pmix_operation &early)
+
+  {
+  this->add_data(early.data);
+
+  for (std::set<std::string>::const_iterator it = early.hosts_reported.begin();
+       it != early.hosts_reported.end();
+       it++)
+    this->mark_reported(*it);
+  } // END absorb()
   
 
 
 pmix_operation::pmix_operation() : jobid(), data(), hosts_reported(), hosts_to_report(),
-                                   local_ranks(), all_ranks(), to_call_fence(NULL),
-                                   to_call_connect(NULL), op_id(), complete(false),
-                                   type(FENCE_OPERATION)
+                                   parent(), children(), joined(false), local_ranks(),
+                                   all_ranks(), to_call_fence(NULL), to_call_connect(NULL),
+                                   op_id(), complete(false), type(FENCE_OPERATION), cbdata(NULL)
 
   {
   }
@@ -245,10 +456,13 @@ pmix_operation::pmix_operation(
   const pmix_operation &other) : jobid(other.jobid), data(other.data), 
                                   hosts_reported(other.hosts_reported),
                                   hosts_to_report(other.hosts_to_report),
+                                  parent(other.parent), children(other.children),
+                                  joined(other.joined),
                                   local_ranks(other.local_ranks), all_ranks(other.all_ranks),
                                   to_call_fence(other.to_call_fence),
                                   to_call_connect(other.to_call_connect),
-                                  op_id(other.op_id), complete(other.complete), type(other.type)
+                                  op_id(other.op_id), complete(other.complete), type(other.type),
+                                  cbdata(other.cbdata)
 
   {
   }
@@ -263,6 +477,9 @@ pmix_operation &pmix_operation::operator =(
   this->data = other.data;
   this->hosts_reported = other.hosts_reported;
   this->hosts_to_report = other.hosts_to_report;
+  this->parent = other.parent;
+  this->children = other.children;
+  this->joined = other.joined;
   this->to_call_fence = other.to_call_fence;
   this->to_call_connect = other.to_call_connect;
   this->local_ranks = other.local_ranks;
@@ -281,6 +498,38 @@ const std::set<std::string> &pmix_operation::get_hosts_reported() const
   return(this->hosts_reported);
   }
 
+const std::string &pmix_operation::get_parent() const
+
+  {
+  return(this->parent);
+  }
+
+const std::set<std::string> &pmix_operation::get_children() const
+
+  {
+  return(this->children);
+  }
+
+const std::string &pmix_operation::get_data() const
+
+  {
+  return(this->data);
+  }
+
+void pmix_operation::set_data(
+
+  const std::string &all_data)
+
+  {
+  this->data = all_data;
+  }
+
+bool pmix_operation::has_joined() const
+
+  {
+  return(this->joined);
+  }
+
 
 void pmix_operation::populate_rank_string(
 
@@ -306,7 +555,9 @@ void pmix_operation::populate_rank_string(
  * complete_operation()
  *
  * Completes this objects pmix operation, which as of now is either fence or connect
- * For either, this includes notifying all participating moms and, for me, executing the callback
+ * For either, this includes notifying all participating moms and, for me, executing the callback.
+ * A fence only notifies this host's children in the fence tree, which pass it on to theirs
+ * before calling back locally.
  *
  * @param pjob - the job this pmix operation pertains to
  * @param timeout - a timeout, or 0 if no timeout should be enforced
@@ -326,8 +577,10 @@ pmix_status_t pmix_operation::complete_operation(
   if (this->type == CONNECT_OPERATION)
     this->populate_rank_string(ranks);
 
-  for (std::set<std::string>::iterator it = this->hosts_reported.begin();
-       it != this->hosts_reported.end();
+  const std::set<std::string> &to_notify = (this->type == FENCE_OPERATION) ? this->children : this->hosts_reported;
+
+  for (std::set<std::string>::const_iterator it = to_notify.begin();
+       it != to_notify.end();
        it++)
     {
     if (timeout > 0)
@@ -347,7 +600,7 @@ pmix_status_t pmix_operation::complete_operation(
     else
       {
       if (this->type == FENCE_OPERATION)
-        remote_notify_pmix_operation(pjob, it->c_str(), this->data, IM_FENCE, NULL);
+        remote_notify_pmix_operation(pjob, it->c_str(), this->data, IM_FENCE_RELEASE, NULL);
       else if (this->type == CONNECT_OPERATION)
         remote_notify_pmix_operation(pjob, it->c_str(), ranks, IM_CONNECT, NULL);
       else
@@ -380,9 +633,7 @@ void pmix_operation::execute_callback()
   {
   if (this->type == FENCE_OPERATION)
     {
-    if (this->to_call_fence != NULL)
-      this->to_call_fence(PMIX_SUCCESS, this->data.c_str(), this->data.size(), this->cbdata,
-                          NULL, NULL);
+    pass_modex_data(this->to_call_fence, this->cbdata, PMIX_SUCCESS, this->data);
     }
   else if (this->to_call_connect != NULL)
     {
@@ -397,11 +648,8 @@ void pmix_operation::add_data(
   const std::string &additional)
 
   {
-  if (this->data.size() > 0)
-    {
-    this->data += ",";
-    this->data += additional;
-    }
+  // each server's part of the modex is self-describing, so the parts are simply concatenated
+  this->data += additional;
   }
 
 
@@ -79,6 +79,7 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <sstream>
+#include <set>
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -93,6 +94,7 @@
 #include <time.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/time.h>
 #include "dis.h"
 #include "libpbs.h"
 #include "pbs_error.h"
@@ -120,6 +122,7 @@
 #include "tcp.h" /* tcp_chan */
 #include "mom_config.h"
 #include "power_state.hpp"
+#include "file_copy.h"
 #ifdef USE_RESOURCE_PLUGIN
 #include "plugin_internal.h"
 #include "json/json.h"
@@ -169,6 +172,7 @@ extern int  exiting_tasks;
 extern char            *msg_err_unlink;
 extern char            *path_spool;
 extern char            *path_undeliv;
+extern char            *mom_home;
 extern attribute_def job_attr_def[];
 extern char            *msg_jobmod;
 extern char            *msg_manager;
@@ -196,6 +200,8 @@ static char  *output_retained = (char *)"Output retained on that host in: ";
 
 static char   rcperr[MAXPATHLEN]; /* file to contain rcp error */
 
+#define COPY_PROGRESS_INTERVAL 30 /* seconds between staging progress messages */
+
 extern int  LOGLEVEL;
 extern char checkpoint_run_exe_name[]; 
 
@@ -3467,6 +3473,8 @@ void copy_file_cleanup(
  *
  * We have a lot of error processing around the call to sys_copy(). As a result, we move
  * it all into this function
+ * @param copied - true if copy_local_files() already made this copy, so only
+ * the processing is left
  */
 
 int copy_and_process(
@@ -3478,12 +3486,14 @@ int copy_and_process(
   int    dir,
   char  *localname,
   char **bad_list,
-  int   &bad_files)
+  int   &bad_files,
+  bool   copied)
 
   {
-  int rc;
+  int rc = PBSE_NONE;
 
-  if ((rc = sys_copy(rmtflag, src, dest, conn)) != 0)
+  if ((copied == false) &&
+      ((rc = sys_copy(rmtflag, src, dest, conn)) != 0))
     {
     FILE *fp;
 
@@ -3592,6 +3602,197 @@ int copy_and_process(
 
 
 
+/* a copy req_cpyfile() has worked out but not yet made */
+typedef struct pending_copy
+  {
+  bool            pc_rmtflag;
+  bool            pc_from_spool;
+  std::string     pc_src;
+  std::string     pc_dest;
+  std::string     pc_localname;
+  struct rqfpair *pc_pair;
+  int             pc_task;  /* index into the copy_local_files() tasks, or -1 */
+  } pending_copy;
+
+
+
+/*
+ * open_copy_slots()
+ *
+ * Opens mom_priv/copy_slots once for each worker a copy request may use, so
+ * the copies of every request on the node can share $copy_node_threads slots.
+ * This is done before fork_to_user() since only root can open the file.
+ */
+
+void open_copy_slots(
+
+  std::vector<int> &slot_fds)
+
+  {
+  char path[MAXPATHLEN + 1];
+  int  workers = MIN(copy_threads, copy_node_threads);
+
+  if ((workers <= 0) ||
+      (mom_home == NULL))
+    return;
+
+  snprintf(path, sizeof(path), "%s/copy_slots", mom_home);
+
+  for (int i = 0; i < workers; i++)
+    {
+    int fd;
+
+    if ((fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600)) < 0)
+      {
+      snprintf(log_buffer, sizeof(log_buffer), "cannot open %s, copies will not be limited per node", path);
+      log_err(errno, __func__, log_buffer);
+
+      break;
+      }
+
+    slot_fds.push_back(fd);
+    }
+  } /* END open_copy_slots() */
+
+
+
+void close_copy_slots(
+
+  std::vector<int> &slot_fds)
+
+  {
+  for (size_t i = 0; i < slot_fds.size(); i++)
+    close(slot_fds[i]);
+
+  slot_fds.clear();
+  } /* END close_copy_slots() */
+
+
+
+void log_copy_progress(
+
+  const copy_stats *stats,
+  size_t            done,
+  size_t            total,
+  void             *arg)
+
+  {
+  char buf[LOG_BUF_SIZE];
+
+  snprintf(buf, sizeof(buf), "staging in progress: %lu of %lu copies done, %llu bytes copied",
+    (unsigned long)done,
+    (unsigned long)total,
+    stats->cs_bytes);
+
+  log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, (const char *)arg, buf);
+  } /* END log_copy_progress() */
+
+
+
+/*
+ * copy_local_files()
+ *
+ * Makes the copies from pending[first] up to the next one that needs rcp or
+ * that writes the same target as an earlier one, in-process on up to
+ * copy_threads worker processes and within the node's copy limits, and logs
+ * the throughput.  Copies are started in order and none are started once one
+ * fails, so req_cpyfile() still stops at the first failed pair.
+ *
+ * @param pending - the copies, each copy made here has pc_task set
+ * @param first - the first copy to make
+ * @param tasks - populated with the result of each copy made here
+ * @param slot_fds - from open_copy_slots()
+ * @param jobid - the job the copies are for, for logging
+ */
+
+void copy_local_files(
+
+  std::vector<pending_copy> &pending,
+  size_t                     first,
+  std::vector<copy_task>    &tasks,
+  std::vector<int>          &slot_fds,
+  const char                *jobid)
+
+  {
+  std::set<std::string> targets;
+  copy_stats            stats;
+  copy_limits           limits;
+  struct timeval        start;
+  struct timeval        end;
+  double                elapsed;
+  int                   workers;
+
+  tasks.clear();
+
+  if (copy_threads <= 0)
+    return;
+
+  for (size_t i = first; i < pending.size(); i++)
+    {
+    copy_task task;
+
+    if (pending[i].pc_rmtflag == true)
+      break;
+
+    if (targets.insert(copy_target(pending[i].pc_src.c_str(), pending[i].pc_dest.c_str())).second == false)
+      break;
+
+    task.ct_src = pending[i].pc_src;
+    task.ct_dest = pending[i].pc_dest;
+    task.ct_rc = PBSE_NONE;
+
+    pending[i].pc_task = tasks.size();
+    tasks.push_back(task);
+    }
+
+  if (tasks.size() == 0)
+    return;
+
+  init_copy_limits(&limits);
+
+  limits.cl_workers = copy_threads;
+  limits.cl_bandwidth = copy_bandwidth * 1024.0 * 1024.0;
+  limits.cl_sync = copy_fsync;
+  limits.cl_progress_interval = COPY_PROGRESS_INTERVAL;
+  limits.cl_progress = log_copy_progress;
+  limits.cl_progress_arg = (void *)jobid;
+
+  workers = MIN(copy_threads, (int)tasks.size());
+
+  if (slot_fds.size() > 0)
+    {
+    limits.cl_node_slots = copy_node_threads;
+    limits.cl_slot_fds = &slot_fds[0];
+    limits.cl_slot_fd_count = slot_fds.size();
+    limits.cl_slot_bandwidth = copy_node_bandwidth * 1024.0 * 1024.0 / copy_node_threads;
+
+    workers = MIN(workers, (int)slot_fds.size());
+    }
+
+  memset(&stats, 0, sizeof(stats));
+
+  gettimeofday(&start, NULL);
+
+  copy_files_in_parallel(tasks, &limits, &stats);
+
+  gettimeofday(&end, NULL);
+
+  /* the copies not started are tried again when req_cpyfile() reaches them */
+  for (size_t i = first; i < first + tasks.size(); i++)
+    {
+    if (tasks[pending[i].pc_task].ct_rc == COPY_SKIPPED)
+      pending[i].pc_task = -1;
+    }
+
+  elapsed = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
+
+  format_copy_stats(log_buffer, sizeof(log_buffer), &stats, workers, elapsed);
+
+  log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, jobid, log_buffer);
+  } /* END copy_local_files() */
+
+
+
 /*
  * determine_spooldir()
  *
@@ -3737,6 +3938,12 @@ void req_cpyfile(
 
   job            *pjob = NULL;
 
+  std::vector<pending_copy> pending;
+  std::vector<copy_task>    tasks;
+  std::vector<int>          slot_fds;
+  struct rqfpair           *unexpanded_pair = NULL;  /* pair whose paths couldn't be expanded */
+  bool                      unexpanded_from_spool = false;
+
 #ifdef HAVE_WORDEXP
   std::vector<std::string> sources;
   int             madefaketmpdir = 0;
@@ -3772,8 +3979,16 @@ void req_cpyfile(
   
   pjob = mom_find_job(preq->rq_ind.rq_cpyfile.rq_jobid);
 
+  open_copy_slots(slot_fds);
+
   rc = (int)fork_to_user(preq, TRUE, HDir, EMsg);
 
+  if (rc != 0)
+    {
+    // only the child copies, the slot locks go away with it
+    close_copy_slots(slot_fds);
+    }
+
   if (rc < 0)
     {
     char tmpLine[1024];
@@ -3913,6 +4128,8 @@ void req_cpyfile(
     copy_file_cleanup(dir, from_spool, preq, pair, localname, sizeof(localname), &bad_list);
     }
 
+  localname[0] = '\0';
+
   for (pair = (struct rqfpair *)GET_NEXT(preq->rq_ind.rq_cpyfile.rq_pair);
        pair != NULL;
        pair = (struct rqfpair *)GET_NEXT(pair->fp_link))
@@ -4063,7 +4280,9 @@ void req_cpyfile(
       if (bad_list != NULL)
         bad_files = 1;
 
-      copy_file_cleanup(dir, from_spool, preq, pair, localname, sizeof(localname), &bad_list);
+      /* cleaned up once the copies for the pairs before it are made */
+      unexpanded_pair = pair;
+      unexpanded_from_spool = from_spool;
 
       break;
       }
@@ -4100,25 +4319,72 @@ void req_cpyfile(
         continue;
         }
 
-      if ((rc = copy_and_process(rmtflag,
-                                 arg2,
-                                 arg3,
-                                 preq->rq_conn,
-                                 dir,
-                                 localname,
-                                 &bad_list,
-                                 bad_files)) != PBSE_NONE)
-        {
-        copy_file_cleanup(dir, from_spool, preq, pair, localname, sizeof(localname), &bad_list);
-        exitcode = COPY_FILE_FAIL;
+      pending_copy pc;
 
-        break;
-        }
+      pc.pc_rmtflag = rmtflag;
+      pc.pc_from_spool = from_spool;
+      pc.pc_src = arg2;
+      pc.pc_dest = arg3;
+      pc.pc_localname = localname;
+      pc.pc_pair = pair;
+      pc.pc_task = -1;
 
-      unlink(rcperr);
+      pending.push_back(pc);
       } // END for each source
     }  /* END for (pair) */
 
+  // process every copy in order, making each run of local copies in-process and in parallel
+  for (size_t i = 0; i < pending.size(); i++)
+    {
+    pending_copy &pc = pending[i];
+    bool          copied = false;
+
+    snprintf(localname, sizeof(localname), "%s", pc.pc_localname.c_str());
+
+    if ((pc.pc_rmtflag == false) &&
+        (pc.pc_task < 0))
+      copy_local_files(pending, i, tasks, slot_fds, preq->rq_ind.rq_cpyfile.rq_jobid);
+
+    if (pc.pc_task >= 0)
+      {
+      copy_task &task = tasks[pc.pc_task];
+
+      if (task.ct_rc == PBSE_NONE)
+        copied = true;
+      else if (task.ct_rc != COPY_UNSUPPORTED)
+        {
+        snprintf(log_buffer, sizeof(log_buffer), "in-process copy failed (%s), retrying with /bin/cp",
+          task.ct_err.c_str());
+
+        log_err(task.ct_rc, __func__, log_buffer);
+        }
+      }
+
+    if ((rc = copy_and_process(pc.pc_rmtflag,
+                               (char *)pc.pc_src.c_str(),
+                               (char *)pc.pc_dest.c_str(),
+                               preq->rq_conn,
+                               dir,
+                               localname,
+                               &bad_list,
+                               bad_files,
+                               copied)) != PBSE_NONE)
+      {
+      copy_file_cleanup(dir, pc.pc_from_spool, preq, pc.pc_pair, localname, sizeof(localname), &bad_list);
+      exitcode = COPY_FILE_FAIL;
+      unexpanded_pair = NULL;
+
+      break;
+      }
+
+    unlink(rcperr);
+    } // END for each pending copy
+
+  close_copy_slots(slot_fds);
+
+  if (unexpanded_pair != NULL)
+    copy_file_cleanup(dir, unexpanded_from_spool, preq, unexpanded_pair, localname, sizeof(localname), &bad_list);
+
 error:
 #ifdef HAVE_WORDEXP
   if (madefaketmpdir && !usedfaketmpdir)
@@ -133,6 +133,7 @@ extern "C"
 #include "node_internals.hpp"
 #include "job_host_data.hpp"
 #include "pmix_tracker.hpp"
+#include "event_trace.h"
 
 #ifdef PENABLE_LINUX_CGROUPS
 #include "trq_cgroups.h"
@@ -198,7 +199,6 @@ typedef enum
 
 #define MAX_JOB_ARGS          64
 
-
 #define KB  1024
 /* Global Variables */
 extern node_internals internal_layout;
@@ -1919,17 +1919,40 @@ int open_tcp_stream_to_sisters(
   int                flag)
 
   {
-  int              rc = DIS_SUCCESS;
-  int              i;
-  hnodent         *np;
-  int              stream;
-  eventent        *ep;
-  svrattrl        *psatl;
-  struct tcp_chan *chan = NULL;
+  int                               rc = DIS_SUCCESS;
+  int                               i;
+  hnodent                          *np;
+  int                               stream;
+  eventent                         *ep;
+  svrattrl                         *psatl;
+  struct tcp_chan                  *chan = NULL;
+  std::vector<struct sockaddr_in *> addrs;
+  std::vector<int>                  streams(mom_radix + 1, TRANSIENT_SOCKET_FAIL);
 
   np = hosts;
   pjob->ji_outstanding = 0;
 
+  /* open the connections to all of our children at once */
+  for (i = 1; i <= mom_radix; i++)
+    {
+    if (sister_list[i-1]->count >= 2)
+      addrs.push_back(&hosts[i].sock_addr);
+    }
+
+  if (addrs.size() > 0)
+    {
+    std::vector<int> socks(addrs.size());
+    unsigned int     k = 0;
+
+    socket_connect_addrs(&addrs[0], addrs.size(), &socks[0], TRUE, SISTER_CONNECT_TIMEOUT);
+
+    for (i = 1; i <= mom_radix; i++)
+      {
+      if (sister_list[i-1]->count >= 2)
+        streams[i] = socks[k++];
+      }
+    }
+
   /* the sister lists have been made. Now contact the intermediate moms as designated by mom_radix */
   for (i = 1; i <= mom_radix; i++)
     {
@@ -1944,7 +1967,11 @@ int open_tcp_stream_to_sisters(
 
     pjob->ji_outstanding++;
 
-    stream = tcp_connect_sockaddr((struct sockaddr *)&np->sock_addr,sizeof(np->sock_addr), false);
+    stream = streams[i];
+
+    /* try again the slow way if the handshake didn't finish in time */
+    if (stream == TRANSIENT_SOCKET_FAIL)
+      stream = tcp_connect_sockaddr((struct sockaddr *)&np->sock_addr,sizeof(np->sock_addr), false);
 
     if (IS_VALID_STREAM(stream) == FALSE)
       {
@@ -1958,6 +1985,12 @@ int open_tcp_stream_to_sisters(
       log_err(errno, __func__, log_buffer);
       log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_JOB, __func__, log_buffer);
 
+      for (i++; i <= mom_radix; i++)
+        {
+        if (IS_VALID_STREAM(streams[i]))
+          close(streams[i]);
+        }
+
       exec_bail(pjob, JOB_EXEC_FAIL1);
 
       return(PBSE_SISCOMM);
@@ -1974,6 +2007,13 @@ int open_tcp_stream_to_sisters(
       close(stream);
       sprintf(log_buffer, "failed to allocate channel: %s", pjob->ji_qs.ji_jobid);
       log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_JOB, __func__, log_buffer);
+
+      for (i++; i <= mom_radix; i++)
+        {
+        if (IS_VALID_STREAM(streams[i]))
+          close(streams[i]);
+        }
+
       exec_bail(pjob, JOB_EXEC_FAIL1);
       return(PBSE_SISCOMM);
       }
@@ -5341,6 +5381,8 @@ int TMomFinalizeJob3(
 
   log_record(PBSEVENT_ERROR, PBS_EVENTCLASS_JOB, __func__, log_buffer);
 
+  trace_event(TRACE_JOB_START, pjob->ji_qs.ji_jobid, 0, (int)sjr.sj_session);
+
   return(SUCCESS);
   } /* END TMomFinalizeJob3() */
 
@@ -6945,6 +6987,116 @@ int send_join_job_to_a_sister(
 
 
 
+/*
+ * radix_tree_depth - the number of levels below mother superior when
+ * nodenum nodes are split radix ways at each level
+ */
+
+int radix_tree_depth(
+
+  int nodenum,
+  int radix)
+
+  {
+  int depth = 0;
+  int below = nodenum - 1;  /* nodes beneath the current MOM */
+
+  if (radix < 1)
+    return((below > 0) ? 1 : 0);
+
+  while (below > 0)
+    {
+    depth++;
+
+    /* each child heads one of radix lists and passes the rest on */
+    below = (below + radix - 1) / radix - 1;
+    }
+
+  return(depth);
+  } /* END radix_tree_depth() */
+
+
+
+/*
+ * choose_job_radix - pick the radix to launch a job on nodenum nodes with
+ * when the job doesn't ask for one. $job_launch_radix can fix the radix or
+ * turn fan-out off; by default the radix grows with the cube root of the
+ * node count, so even large jobs are three hops from mother superior while
+ * no MOM contacts more than MAX_AUTO_JOB_RADIX sisters itself.
+ *
+ * @return the radix, or 0 to contact every sister directly
+ */
+
+int choose_job_radix(
+
+  int nodenum)
+
+  {
+  int radix;
+
+  if (job_launch_radix == JOB_RADIX_FLAT)
+    return(0);
+
+  if (job_launch_radix > 0)
+    radix = job_launch_radix;
+  else if (nodenum < MIN_AUTO_RADIX_NODES)
+    return(0);
+  else
+    {
+    radix = MIN_AUTO_JOB_RADIX;
+
+    while ((radix < MAX_AUTO_JOB_RADIX) &&
+           (radix * radix * radix < nodenum))
+      radix++;
+    }
+
+  /* a radix is only worth it when there are more sisters than children */
+  if (radix + 1 > nodenum)
+    return(0);
+
+  return(radix);
+  } /* END choose_job_radix() */
+
+
+
+/*
+ * connect_sister_batch - connect to up to SISTER_CONNECT_BATCH sisters that
+ * still need a join, starting with sister first, all at once. batch holds the
+ * sister indexes in the order send_join_job_to_sisters() will visit them and
+ * streams their connections.
+ */
+
+void connect_sister_batch(
+
+  job              *pjob,
+  int               first,
+  int               nodenum,
+  int              *send_failed,
+  std::vector<int> &batch,
+  std::vector<int> &streams)
+
+  {
+  std::vector<struct sockaddr_in *> addrs;
+
+  batch.clear();
+
+  for (int i = first; (i < nodenum) && (batch.size() < SISTER_CONNECT_BATCH); i++)
+    {
+    if (send_failed[i] == DIS_SUCCESS)
+      continue;
+
+    batch.push_back(i);
+    addrs.push_back(&pjob->ji_hosts[i].sock_addr);
+    }
+
+  streams.assign(batch.size(), TRANSIENT_SOCKET_FAIL);
+
+  if (batch.size() > 0)
+    socket_connect_addrs(&addrs[0], addrs.size(), &streams[0], TRUE, SISTER_CONNECT_TIMEOUT);
+  } /* END connect_sister_batch() */
+
+
+
 int send_join_job_to_sisters(
 
   job        *pjob,
@@ -6963,6 +7115,9 @@ int send_join_job_to_sisters(
   int            unsent_count = nodenum - 1;
   bool           permanent_fail = false;
   std::set<int>  sisters_contacted;
+  std::vector<int> batch;
+  std::vector<int> batch_streams;
+  unsigned int   batch_next = 0;
 
   errno = 0;
 
@@ -6986,6 +7141,14 @@ int send_join_job_to_sisters(
       if (send_failed[i] == DIS_SUCCESS)
         continue;
 
+      /* start the handshakes for the next batch of sisters together
+       * rather than waiting on each connect in turn */
+      if (batch_next >= batch.size())
+        {
+        connect_sister_batch(pjob, i, nodenum, send_failed, batch, batch_streams);
+        batch_next = 0;
+        }
+
       np = &pjob->ji_hosts[i];
 
       if (LOGLEVEL >= 7)
@@ -6997,7 +7160,10 @@ int send_join_job_to_sisters(
       log_buffer[0] = '\0';
 
       ret = -1;
-      stream = tcp_connect_sockaddr((struct sockaddr *)&np->sock_addr,sizeof(np->sock_addr), false);
+      stream = batch_streams[batch_next++];
+
+      if (stream == TRANSIENT_SOCKET_FAIL)
+        stream = tcp_connect_sockaddr((struct sockaddr *)&np->sock_addr,sizeof(np->sock_addr), false);
 
       if (IS_VALID_STREAM(stream))
         {
@@ -7029,6 +7195,17 @@ int send_join_job_to_sisters(
         log_buffer[0] = '\0';
         }
       } /* END for each node */
+
+    /* drop the connections we didn't get to before bailing out */
+    for (; batch_next < batch_streams.size(); batch_next++)
+      {
+      if (IS_VALID_STREAM(batch_streams[batch_next]))
+        close(batch_streams[batch_next]);
+      }
+
+    batch.clear();
+    batch_streams.clear();
+    batch_next = 0;
     } /* END for 5 retries */
 
   if (unsent_count > 0)
@@ -7320,6 +7497,24 @@ int start_exec(
     /* parallel job */
     mom_radix = pjob->ji_wattr[JOB_ATR_job_radix].at_val.at_long;
     }
+  else if ((is_login_node == FALSE) &&
+           ((mom_radix = choose_job_radix(nodenum)) > 0))
+    {
+    /* the sisters take the radix from the job, so record the one we chose */
+    pjob->ji_wattr[JOB_ATR_job_radix].at_val.at_long = mom_radix;
+    pjob->ji_wattr[JOB_ATR_job_radix].at_flags |= ATR_VFLAG_SET;
+
+    if (LOGLEVEL >= 3)
+      {
+      snprintf(log_buffer, sizeof(log_buffer),
+        "launching on %d nodes with a job radix of %d (%d levels)",
+        nodenum,
+        mom_radix,
+        radix_tree_depth(nodenum, mom_radix));
+
+      log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buffer);
+      }
+    }
 
   pjob->ji_radix = mom_radix;
 
@@ -37,6 +37,10 @@ int mom_jobstarter_execute_job(job *pjob, char *shell, char *arg[], struct var_t
 
 int open_tcp_stream_to_sisters(job *pjob, int com, tm_event_t parent_event, int mom_radix, hnodent *hosts, struct radix_buf **sister_list, tlist_head *phead, int flag);
 
+int radix_tree_depth(int nodenum, int radix);
+
+int choose_job_radix(int nodenum);
+
 void free_sisterlist(struct radix_buf **list, int radix);
 
 struct radix_buf **allocate_sister_list(int radix);
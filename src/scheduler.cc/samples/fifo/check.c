@@ -82,6 +82,9 @@
 #include "pbs_ifl.h"
 #include "log.h"
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
 #include "check.h"
 #include "config.h"
 #include "server_info.h"
@@ -100,6 +103,36 @@ int check_ded_time_queue(queue_info *qinfo);
 int check_node_availability(job_info *jinfo, node_info **ninfo_arr);
 int check_starvation(job_info *jinfo);
 int check_ded_time_boundry(job_info *jinfo);
+int find_available_node(job_info *jinfo, node_info **ninfo_arr, node_info **found);
+void check_job_feasibility(server_info *sinfo, job_info *jinfo);
+int feasible_node_result(job_info *jinfo, int *rc);
+
+/* jobs handed to a feasibility thread at a time.  No threads are used for
+ * fewer jobs than this per thread
+ */
+#define FEASIBILITY_MIN_JOBS 32
+
+/* the feasibility workers are started once and wait here for passes */
+struct feasibility_pool
+  {
+  pthread_mutex_t mutex;
+  pthread_cond_t work;  /* broadcast when a pass is handed out */
+  pthread_cond_t done;  /* signalled when the last busy worker finishes */
+  int workers;   /* number of workers started */
+  int helpers;   /* number of workers wanted for the current pass */
+  int active;   /* number of workers busy with the current pass */
+  unsigned pass;  /* bumped for every pass */
+  server_info *sinfo;  /* the server of the current pass */
+  job_info **jobs;  /* the jobs of the current pass */
+  int num_jobs;   /* number of jobs in jobs */
+  int next;   /* index of the next job to hand out */
+  };
+
+static struct feasibility_pool feasibility_pool =
+  {
+  PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+  0, 0, 0, 0, NULL, NULL, 0, 0
+  };
 
 
 /*
@@ -182,7 +215,11 @@ int is_ok_to_run_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
   if ((rc = check_starvation(jinfo)))
     return rc;
 
-  if ((rc = check_nodes(pbs_sd, jinfo, sinfo -> timesharing_nodes)))
+  /* the feasibility pass may already have checked the nodes */
+  if (!feasible_node_result(jinfo, &rc))
+    rc = check_nodes(pbs_sd, jinfo, sinfo -> timesharing_nodes);
+
+  if (rc)
     return rc;
 
   if ((rc = check_avail_resources(qinfo -> qres, jinfo)) != SUCCESS)
@@ -544,6 +581,24 @@ int check_nodes(int pbs_sd, job_info *jinfo, node_info **ninfo_arr)
  *
  */
 int check_node_availability(job_info *jinfo, node_info **ninfo_arr)
+  {
+  return find_available_node(jinfo, ninfo_arr, NULL);
+  }
+
+/*
+ *
+ *      find_available_node - check_node_availability() that also reports
+ *                            the node the job fits on
+ *
+ *        jinfo - the job to run
+ *        ninfo_arr - the array of nodes to check in
+ *        found - set to the first node the job fits on, or to NULL if no
+ *                node was found or needed.  May be NULL.
+ *
+ *      returns the same as check_node_availability()
+ *
+ */
+int find_available_node(job_info *jinfo, node_info **ninfo_arr, node_info **found)
   {
   int rc = NO_AVAILABLE_NODE; /* return code */
   resource_req *req;  /* used to get resource values */
@@ -553,6 +608,9 @@ int check_node_availability(job_info *jinfo, node_info **ninfo_arr)
   char *host;   /* host name the job requested */
   int i;
 
+  if (found != NULL)
+    *found = NULL;
+
   if (cstat.load_balancing || cstat.load_balancing_rr)
     {
     if (jinfo != NULL && ninfo_arr != NULL)
@@ -585,7 +643,12 @@ int check_node_availability(job_info *jinfo, node_info **ninfo_arr)
             mem <= ninfo_arr[i] -> physmem)
           {
           if (ninfo_arr[i] -> loadave + ncpus <= ninfo_arr[i] -> max_load)
+            {
             rc = 0;
+
+            if (found != NULL)
+              *found = ninfo_arr[i];
+            }
           }
         }
       }
@@ -598,6 +661,299 @@ int check_node_availability(job_info *jinfo, node_info **ninfo_arr)
   return rc;
   }
 
+/*
+ *
+ *      check_job_feasibility - do the node check of is_ok_to_run_job()
+ *                              ahead of time and remember the result in
+ *                              the job
+ *
+ *        sinfo - the server
+ *        jinfo - the job to check
+ *
+ *      returns nothing
+ *
+ *      NOTE: this only reads the server, job and node structures and only
+ *            writes jinfo, so it is safe to call for different jobs from
+ *            several threads.  Jobs that request "nodes" need
+ *            pbs_rescquery() on the server connection and are left alone.
+ *
+ */
+void check_job_feasibility(server_info *sinfo, job_info *jinfo)
+  {
+  if (find_resource_req(jinfo -> resreq, "nodes") != NULL)
+    return;
+
+  jinfo -> feasible_rc = find_available_node(jinfo, sinfo -> timesharing_nodes,
+                                             &(jinfo -> feasible_node));
+
+  if (jinfo -> feasible_node != NULL)
+    jinfo -> feasible_gen = jinfo -> feasible_node -> load_gen;
+
+  jinfo -> feasible_valid = 1;
+  }
+
+/*
+ *
+ *      feasible_node_result - find out if the node check done by the
+ *                             feasibility pass still holds
+ *
+ *        jinfo - the job
+ *        rc - set to what check_node_availability() would return now
+ *
+ *      returns 1 if rc was set, 0 if the nodes have to be checked again
+ *
+ *      NOTE: running a job only ever raises the load of the node it runs on
+ *            (see run_update_job()).  A job that fit on no node still fits
+ *            on none, and a job still fits on the first node it fit on
+ *            unless the load of that very node was raised.
+ *
+ */
+int feasible_node_result(job_info *jinfo, int *rc)
+  {
+  if (!jinfo -> feasible_valid)
+    return 0;
+
+  if (jinfo -> feasible_node != NULL &&
+      jinfo -> feasible_node -> load_gen != jinfo -> feasible_gen)
+    return 0;
+
+  *rc = jinfo -> feasible_rc;
+
+  return 1;
+  }
+
+/*
+ *
+ *      check_feasibility_chunks - check the jobs of the current feasibility
+ *                                 pass, FEASIBILITY_MIN_JOBS at a time,
+ *                                 until there are none left
+ *
+ *      returns nothing
+ *
+ */
+void check_feasibility_chunks(void)
+  {
+  server_info *sinfo;
+  job_info **jobs;
+  int first;
+  int last;
+  int i;
+
+  while (1)
+    {
+    pthread_mutex_lock(&feasibility_pool.mutex);
+
+    sinfo = feasibility_pool.sinfo;
+    jobs = feasibility_pool.jobs;
+    first = feasibility_pool.next;
+    last = feasibility_pool.num_jobs;
+
+    if (first < last)
+      feasibility_pool.next += FEASIBILITY_MIN_JOBS;
+
+    pthread_mutex_unlock(&feasibility_pool.mutex);
+
+    if (first >= last)
+      break;
+
+    if (last - first > FEASIBILITY_MIN_JOBS)
+      last = first + FEASIBILITY_MIN_JOBS;
+
+    for (i = first; i < last; i++)
+      check_job_feasibility(sinfo, jobs[i]);
+    }
+  }
+
+/*
+ *
+ *      feasibility_worker - wait for feasibility passes and help check
+ *                           their jobs
+ *
+ *        arg - the index of the worker
+ *
+ *      returns nothing, the worker runs as long as the scheduler
+ *
+ */
+void *feasibility_worker(void *arg)
+  {
+  long index = (long)arg;
+  unsigned pass;
+
+  pthread_mutex_lock(&feasibility_pool.mutex);
+
+  pass = feasibility_pool.pass;
+
+  while (1)
+    {
+    while (feasibility_pool.pass == pass)
+      pthread_cond_wait(&feasibility_pool.work, &feasibility_pool.mutex);
+
+    pass = feasibility_pool.pass;
+
+    /* the pass may not need every worker */
+    if (index >= feasibility_pool.helpers)
+      continue;
+
+    feasibility_pool.active++;
+
+    pthread_mutex_unlock(&feasibility_pool.mutex);
+
+    check_feasibility_chunks();
+
+    pthread_mutex_lock(&feasibility_pool.mutex);
+
+    if (--feasibility_pool.active == 0)
+      pthread_cond_signal(&feasibility_pool.done);
+    }
+
+  return NULL;
+  }
+
+/*
+ *
+ *      start_feasibility_workers - make sure there are at least num
+ *                                  feasibility workers waiting for passes
+ *
+ *        num - the number of workers wanted
+ *
+ *      returns the number of workers running
+ *
+ *      NOTE: the workers are started once and kept for the following
+ *            scheduling cycles
+ *
+ */
+int start_feasibility_workers(int num)
+  {
+  pthread_attr_t attr;
+  pthread_t tid;
+
+  if (feasibility_pool.workers >= num)
+    return feasibility_pool.workers;
+
+  if (pthread_attr_init(&attr) != 0)
+    return feasibility_pool.workers;
+
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  while (feasibility_pool.workers < num)
+    {
+    if (pthread_create(&tid, &attr, feasibility_worker, (void *)(long)feasibility_pool.workers) != 0)
+      break;
+
+    feasibility_pool.workers++;
+    }
+
+  pthread_attr_destroy(&attr);
+
+  return feasibility_pool.workers;
+  }
+
+/*
+ *
+ *      evaluate_job_feasibility - check every job that can still be run
+ *                                 against the nodes, sharing the jobs
+ *                                 between this thread and up to
+ *                                 conf.feasibility_threads - 1 workers
+ *
+ *        sinfo - the server
+ *
+ *      returns the number of jobs checked
+ *
+ *      NOTE: the pass is done once per scheduling cycle.  Running a job
+ *            only makes the results of the jobs that fit on its node stale,
+ *            see feasible_node_result().  Each job is checked by exactly
+ *            one thread, so the results don't depend on the number of
+ *            threads.
+ *
+ */
+int evaluate_job_feasibility(server_info *sinfo)
+  {
+  job_info **jobs;
+  struct timeval start;
+  struct timeval end;
+  char log_buf[256];
+  int num_jobs = 0;
+  int num_threads;
+  int i;
+
+  sinfo -> feasibility_evaluated = 1;
+
+  /* the nodes only need checking when we are load balancing */
+  if (!(cstat.load_balancing || cstat.load_balancing_rr) ||
+      sinfo -> timesharing_nodes == NULL ||
+      sinfo -> jobs == NULL)
+    return 0;
+
+  if ((num_threads = conf.feasibility_threads) <= 0)
+    num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+  if (num_threads <= 1)
+    return 0;
+
+  if ((jobs = (job_info **)malloc(sizeof(job_info *) * (sinfo -> sc.total + 1))) == NULL)
+    return 0;
+
+  for (i = 0; sinfo -> jobs[i] != NULL; i++)
+    {
+    if (sinfo -> jobs[i] -> is_queued &&
+        !sinfo -> jobs[i] -> can_not_run &&
+        !sinfo -> jobs[i] -> feasible_valid)
+      jobs[num_jobs++] = sinfo -> jobs[i];
+    }
+
+  if (num_jobs / FEASIBILITY_MIN_JOBS < num_threads)
+    num_threads = num_jobs / FEASIBILITY_MIN_JOBS;
+
+  /* this thread checks jobs as well */
+  if (num_threads > 1)
+    num_threads = start_feasibility_workers(num_threads - 1) + 1;
+
+  if (num_threads <= 1)
+    {
+    free(jobs);
+    return 0;
+    }
+
+  gettimeofday(&start, NULL);
+
+  pthread_mutex_lock(&feasibility_pool.mutex);
+
+  feasibility_pool.sinfo = sinfo;
+  feasibility_pool.jobs = jobs;
+  feasibility_pool.num_jobs = num_jobs;
+  feasibility_pool.next = 0;
+  feasibility_pool.helpers = num_threads - 1;
+  feasibility_pool.pass++;
+
+  pthread_cond_broadcast(&feasibility_pool.work);
+  pthread_mutex_unlock(&feasibility_pool.mutex);
+
+  check_feasibility_chunks();
+
+  /* a worker that joins late finds no jobs left */
+  pthread_mutex_lock(&feasibility_pool.mutex);
+
+  while (feasibility_pool.active > 0)
+    pthread_cond_wait(&feasibility_pool.done, &feasibility_pool.mutex);
+
+  feasibility_pool.jobs = NULL;
+  feasibility_pool.num_jobs = 0;
+
+  pthread_mutex_unlock(&feasibility_pool.mutex);
+
+  gettimeofday(&end, NULL);
+
+  snprintf(log_buf, sizeof(log_buf), "Checked %d jobs against the nodes with %d threads in %ld usec",
+    num_jobs,
+    num_threads,
+    (long)((end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec)));
+  sched_log(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SERVER, "", log_buf);
+
+  free(jobs);
+
+  return num_jobs;
+  }
+
 /*
  *
  * check_ded_time_queue - check if it is the approprate time to run jobs
@@ -185,5 +185,7 @@ int check_token_utilization(server_info *sinfo, job_info *jinfo);
 */
 int check_ignored(queue_info *qinfo);
 
+int evaluate_job_feasibility(server_info *sinfo);
+
 #endif
 
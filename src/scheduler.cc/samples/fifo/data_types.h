@@ -173,6 +173,7 @@ struct server_info
   node_info **nodes;  /* array of nodes associated with the server */
   node_info **timesharing_nodes;/* array of timesharing nodes */
   token **tokens;               /* array of tokens */
+  char feasibility_evaluated; /* feasibility pass done this cycle - set once, never reset */
   };
 
 struct queue_info
@@ -255,6 +256,10 @@ unsigned can_never_run:
   resource_req *resused; /* a list of resources used */
   group_info *ginfo;  /* the fair share node for the owner */
   node_info *job_node;  /* node the job is running on */
+  int feasible_rc;  /* node check result from the feasibility pass */
+  node_info *feasible_node; /* node the feasibility pass found for the job */
+  unsigned feasible_gen; /* load_gen of feasible_node when it was found */
+  char feasible_valid;  /* the feasibility pass checked the job */
   };
 
 struct node_info
@@ -304,6 +309,7 @@ unsigned is_cluster:
   int ncpus;   /* number of cpus */
   int physmem;   /* amount of physical memory in kilobytes */
   float loadave;  /* current load average */
+  unsigned load_gen;  /* bumped whenever the scheduler raises loadave */
   };
 
 struct resource
@@ -480,6 +486,7 @@ unsigned non_prime_lbrr:
   int log_filter;   /* what events to filter out */
   char ded_prefix[PBS_MAXQUEUENAME +1]; /* prefix to dedicated queues */
   time_t max_starve;   /* starving threshold */
+  int feasibility_threads;  /* threads used to evaluate jobs against nodes */
   char* ignored_queues[MAX_IGNORED_QUEUES]; /* list of ignored queues */
   };
 
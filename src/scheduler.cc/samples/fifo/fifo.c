@@ -85,6 +85,7 @@
 #include "pbs_ifl.h"
 #include "sched_cmds.h"
 #include <time.h>
+#include <sys/time.h>
 #include "log.h"
 #include <string.h>
 #include "queue_info.h"
@@ -308,9 +309,15 @@ int init_scheduling_cycle(server_info *sinfo)
 
   if (cstat.sort_by[0].sort != NO_SORT)
     {
+    struct timeval sort_start;
+    struct timeval sort_end;
+    char           log_buf[256];
+
+    gettimeofday(&sort_start, NULL);
+
     if (cstat.strict_fifo)
       {
-      qsort(sinfo -> jobs, sinfo -> sc.total, sizeof(job_info *), fifo_sort);
+      sort_jobs(sinfo -> jobs, sinfo -> sc.total, 1);
       }
     else
       {
@@ -319,12 +326,20 @@ int init_scheduling_cycle(server_info *sinfo)
         for (i = 0; i < sinfo -> num_queues; i++)
           {
           qinfo = sinfo -> queues[i];
-          qsort(qinfo -> jobs, qinfo -> sc.total, sizeof(job_info *), cmp_sort);
+          sort_jobs(qinfo -> jobs, qinfo -> sc.total, 0);
           }
         }
       else
-        qsort(sinfo -> jobs, sinfo -> sc.total, sizeof(job_info *), cmp_sort);
+        sort_jobs(sinfo -> jobs, sinfo -> sc.total, 0);
       }
+
+    gettimeofday(&sort_end, NULL);
+
+    snprintf(log_buf, sizeof(log_buf), "Sorted %d jobs in %ld usec",
+      sinfo -> sc.total,
+      (long)((sort_end.tv_sec - sort_start.tv_sec) * 1000000 +
+             (sort_end.tv_usec - sort_start.tv_usec)));
+    sched_log(PBSEVENT_DEBUG2, PBS_EVENTCLASS_SERVER, "", log_buf);
     }
 
   next_job(sinfo, INITIALIZE);
@@ -519,6 +534,13 @@ int scheduling_cycle(
       }
     else
       {
+      /* check the jobs that are still to be considered against the nodes
+       * at once.  Running a job later only makes the results of the jobs
+       * that fit on its node stale.
+       */
+      if (!sinfo->feasibility_evaluated)
+        evaluate_job_feasibility(sinfo);
+
       if (jinfo->can_never_run)
         {
         sched_log(
@@ -703,6 +725,9 @@ int run_update_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
         ncpus = res -> amount;
 
       best_node -> loadave += ncpus;
+
+      /* only the feasibility results of jobs that fit on this node are stale */
+      best_node -> load_gen++;
       }
 
     if (cstat.help_starving_jobs && jinfo == cstat.starving_job)
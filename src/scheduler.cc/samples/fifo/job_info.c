@@ -343,6 +343,14 @@ job_info *new_job_info()
 
   jinfo -> job_node = NULL;
 
+  jinfo -> feasible_rc = UNSPECIFIED;
+
+  jinfo -> feasible_node = NULL;
+
+  jinfo -> feasible_gen = 0;
+
+  jinfo -> feasible_valid = 0;
+
   return jinfo;
   }
 
@@ -255,6 +255,7 @@ node_info *new_node_info()
   new_node_info -> ncpus = 0;
   new_node_info -> physmem = 0;
   new_node_info -> loadave = 0.0;
+  new_node_info -> load_gen = 0;
 
   return new_node_info;
   }
@@ -260,6 +260,8 @@ int parse_config(const char *fname)
           conf.unknown_shares = num;
         else if (!strcmp(config_name, PARSE_LOG_FILTER))
           conf.log_filter = num;
+        else if (!strcmp(config_name, PARSE_FEASIBILITY_THREADS))
+          conf.feasibility_threads = num;
         else if (!strcmp(config_name, PARSE_DEDICATED_PREFIX))
           {
           if (strlen(config_value) > PBS_MAXQUEUENAME)
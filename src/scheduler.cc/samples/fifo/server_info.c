@@ -459,6 +459,8 @@ server_info *new_server_info()
 
   sinfo -> tokens = NULL;
 
+  sinfo -> feasibility_evaluated = 0;
+
   init_state_count(&(sinfo -> sc));
 
   return sinfo;
@@ -79,6 +79,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "data_types.h"
 #include "sort.h"
 #include "job_info.h"
@@ -397,3 +398,283 @@ int fifo_sort(const void *v1, const void *v2)
       return(0);
     }
   }
+
+/*
+ * Precomputed sort keys
+ *
+ * Sorting through qsort() and the compare functions above re-derives the
+ * sort values (resource list walks, strtoll() on the job name) on every
+ * comparison.  Instead, sort_jobs() computes one unsigned key per job per
+ * sort criterion once per cycle, stores them column by column and radix
+ * sorts an index array on them.  Each key is mapped so that ascending
+ * unsigned order is the wanted order.
+ */
+
+#define SORT_KEY_RADIX_BITS   8
+#define SORT_KEY_RADIX_SIZE   (1 << SORT_KEY_RADIX_BITS)
+#define SORT_KEY_MISSING      0xffffffffffffffffULL
+
+/*
+ * signed_sort_key - map a signed value onto an unsigned key with the
+ *                   same ordering
+ */
+static unsigned long long signed_sort_key(
+
+  long long value)
+
+  {
+  return((unsigned long long)value ^ 0x8000000000000000ULL);
+  }
+
+/*
+ * float_sort_key - map a float onto an unsigned key with the same ordering
+ */
+static unsigned long long float_sort_key(
+
+  float value)
+
+  {
+  unsigned int bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+
+  if (bits & 0x80000000)
+    bits = ~bits;
+  else
+    bits |= 0x80000000;
+
+  return(bits);
+  }
+
+/*
+ * resource_sort_key - key for a requested resource.  Jobs which do not
+ *                     request the resource sort after the ones that do.
+ */
+static unsigned long long resource_sort_key(
+
+  job_info   *jinfo,
+  const char *name,
+  int         descending)
+
+  {
+  resource_req *req = find_resource_req(jinfo->resreq, name);
+
+  if (req == NULL)
+    return(SORT_KEY_MISSING);
+
+  if (descending)
+    return(~signed_sort_key(req->amount));
+
+  return(signed_sort_key(req->amount));
+  }
+
+/*
+ * job_sort_key - compute the key of a job for a single sort criterion
+ *
+ * returns the key, smaller keys sort first
+ */
+static unsigned long long job_sort_key(
+
+  job_info       *jinfo,
+  enum sort_type  sort)
+
+  {
+  switch (sort)
+    {
+    case SHORTEST_JOB_FIRST:
+      return(resource_sort_key(jinfo, "cput", 0));
+
+    case LONGEST_JOB_FIRST:
+      return(resource_sort_key(jinfo, "cput", 1));
+
+    case SMALLEST_MEM_FIRST:
+      return(resource_sort_key(jinfo, "mem", 0));
+
+    case LARGEST_MEM_FIRST:
+      return(resource_sort_key(jinfo, "mem", 1));
+
+    case HIGH_PRIORITY_FIRST:
+      return(~signed_sort_key(jinfo->priority));
+
+    case LOW_PRIORITY_FIRST:
+      return(signed_sort_key(jinfo->priority));
+
+    case LARGE_WALLTIME_FIRST:
+      return(resource_sort_key(jinfo, "walltime", 1));
+
+    case SHORT_WALLTIME_FIRST:
+      return(resource_sort_key(jinfo, "walltime", 0));
+
+    case FAIR_SHARE:
+      if (jinfo->ginfo == NULL)
+        return(SORT_KEY_MISSING);
+
+      return(float_sort_key(jinfo->ginfo->percentage));
+
+    default:
+      return(0);
+    }
+  }
+
+/*
+ * radix_sort_keys - stable LSD radix sort of an index array
+ *
+ *   keys     - num_keys columns of num_jobs keys, most significant first
+ *   num_keys - number of key columns
+ *   num_jobs - number of jobs (length of each column)
+ *   idx      - index array to sort, initially 0 .. num_jobs - 1
+ *   tmp      - scratch array of num_jobs entries
+ *
+ * returns the sorted index array (either idx or tmp)
+ */
+static int *radix_sort_keys(
+
+  unsigned long long *keys,
+  int                 num_keys,
+  int                 num_jobs,
+  int                *idx,
+  int                *tmp)
+
+  {
+  int  count[SORT_KEY_RADIX_SIZE];
+  int  col;
+  int  shift;
+  int  i;
+  int *swap;
+
+  for (col = num_keys - 1; col >= 0; col--)
+    {
+    unsigned long long *column = keys + (size_t)col * num_jobs;
+
+    for (shift = 0; shift < 64; shift += SORT_KEY_RADIX_BITS)
+      {
+      int bucket;
+      int sum = 0;
+
+      memset(count, 0, sizeof(count));
+
+      for (i = 0; i < num_jobs; i++)
+        count[(column[idx[i]] >> shift) & (SORT_KEY_RADIX_SIZE - 1)]++;
+
+      /* every key has the same digit - this pass would not move anything */
+      if (count[(column[idx[0]] >> shift) & (SORT_KEY_RADIX_SIZE - 1)] == num_jobs)
+        continue;
+
+      for (bucket = 0; bucket < SORT_KEY_RADIX_SIZE; bucket++)
+        {
+        int c = count[bucket];
+
+        count[bucket] = sum;
+        sum += c;
+        }
+
+      for (i = 0; i < num_jobs; i++)
+        tmp[count[(column[idx[i]] >> shift) & (SORT_KEY_RADIX_SIZE - 1)]++] = idx[i];
+
+      swap = idx;
+      idx = tmp;
+      tmp = swap;
+      }
+    }
+
+  return(idx);
+  }
+
+/*
+ * sort_jobs - sort an array of jobs for this scheduling cycle
+ *
+ *   jobs     - array of jobs to sort
+ *   num_jobs - number of jobs in the array
+ *   fifo     - if true, sort by queue time and job id (strict_fifo),
+ *              otherwise sort by the starvation priority and then the
+ *              current sort_by policy (same ordering as cmp_sort())
+ *
+ * returns nothing
+ */
+void sort_jobs(
+
+  job_info **jobs,
+  int        num_jobs,
+  int        fifo)
+
+  {
+  struct sort_info   *sorts = cstat.sort_by;
+  int                 num_keys = 0;
+  unsigned long long *keys;
+  int                *idx;
+  int                *tmp;
+  int                *sorted;
+  job_info          **sorted_jobs;
+  int                 i;
+  int                 k;
+
+  if (num_jobs < 2)
+    return;
+
+  if (!fifo)
+    {
+    if (sorts[0].sort == MULTI_SORT)
+      {
+      sorts++;
+
+      while ((num_keys < num_sorts) && (sorts[num_keys].sort != NO_SORT))
+        num_keys++;
+      }
+    else
+      num_keys = 1;
+    }
+
+  /* fifo: qtime, job id.  otherwise: sch_priority followed by the sorts */
+  num_keys++;
+  if (fifo)
+    num_keys++;
+
+  keys = (unsigned long long *)malloc(sizeof(unsigned long long) * num_keys * num_jobs);
+  idx = (int *)malloc(sizeof(int) * num_jobs);
+  tmp = (int *)malloc(sizeof(int) * num_jobs);
+  sorted_jobs = (job_info **)malloc(sizeof(job_info *) * num_jobs);
+
+  if ((keys == NULL) || (idx == NULL) || (tmp == NULL) || (sorted_jobs == NULL))
+    {
+    free(keys);
+    free(idx);
+    free(tmp);
+    free(sorted_jobs);
+
+    qsort(jobs, num_jobs, sizeof(job_info *), (fifo) ? fifo_sort : cmp_sort);
+
+    return;
+    }
+
+  for (i = 0; i < num_jobs; i++)
+    {
+    job_info *jinfo = jobs[i];
+
+    idx[i] = i;
+
+    if (fifo)
+      {
+      keys[i] = signed_sort_key(jinfo->qtime);
+      keys[(size_t)num_jobs + i] = signed_sort_key(strtoll(jinfo->name, NULL, 10));
+      }
+    else
+      {
+      keys[i] = ~signed_sort_key(jinfo->sch_priority);
+
+      for (k = 1; k < num_keys; k++)
+        keys[(size_t)k * num_jobs + i] = job_sort_key(jinfo, sorts[k - 1].sort);
+      }
+    }
+
+  sorted = radix_sort_keys(keys, num_keys, num_jobs, idx, tmp);
+
+  for (i = 0; i < num_jobs; i++)
+    sorted_jobs[i] = jobs[sorted[i]];
+
+  memcpy(jobs, sorted_jobs, sizeof(job_info *) * num_jobs);
+
+  free(keys);
+  free(idx);
+  free(tmp);
+  free(sorted_jobs);
+  }
@@ -176,5 +176,12 @@ int cmp_sort(const void *v1, const void *v2);
 
 int fifo_sort(const void *v1, const void *v2);
 
+/*
+ *      sort_jobs - sort an array of jobs on keys computed once per cycle
+ *                  (strict fifo order if fifo is true, cmp_sort order
+ *                  otherwise)
+ */
+void sort_jobs(job_info **jobs, int num_jobs, int fifo);
+
 
 #endif
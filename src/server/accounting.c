@@ -97,7 +97,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <string>
+#include <map>
+#include <vector>
 #include "list_link.h"
 #include "attribute.h"
 #include "server_limits.h"
@@ -106,9 +111,8 @@
 #include "log.h"
 #include "../lib/Liblog/pbs_log.h"
 #include "acct.h"
-#ifdef USESAVEDRESOURCES
+#include "acct_usage.h"
 #include "resource.h"
-#endif
 #include "svrfunc.h"
 #include "server.h"
 #include "utils.h"
@@ -122,6 +126,23 @@ static int           acct_opened_day;
 static int           acct_auto_switch = 0;
 pthread_mutex_t     *acctfile_mutex;
 
+/* records are formatted here and written in blocks, guarded by acctfile_mutex */
+static char          acct_buffer[ACCT_BUFFER_SIZE];
+static size_t        acct_buffer_len = 0;
+static time_t        acct_buffer_oldest = 0;
+static time_t        acct_stamp_time = -1;
+static char          acct_stamp[80];   /* "MM/DD/YYYY hh:mm:ss" of acct_stamp_time, room for any six ints */
+static int           acct_stamp_yday;
+static std::string   acct_path;        /* the open accounting file */
+
+/* the binary usage sidecar, see acct_usage.h */
+static bool               acct_usage_enabled = false;
+static int                acct_usage_fd = -1;
+static uint32_t           acct_usage_count = 0;  /* records written or buffered */
+static acct_usage_record  acct_usage_buffer[ACCT_USAGE_BUFFER_RECORDS];
+static int                acct_usage_buffered = 0;
+static std::map<std::string, std::vector<uint32_t> > acct_usage_index;
+
 /* Global Data */
 
 extern attribute_def job_attr_def[];
@@ -297,6 +318,263 @@ int acct_job(
 
 
 
+/*
+ * acct_write_buffer - writes the buffered text and usage records
+ *
+ * acctfile_mutex must be held
+ */
+
+static void acct_write_buffer(void)
+
+  {
+  if ((acct_opened != 0) &&
+      (acct_buffer_len > 0))
+    {
+    if (fwrite(acct_buffer, 1, acct_buffer_len, acctfile) != acct_buffer_len)
+      log_err(errno, __func__, "could not write the accounting file");
+    }
+
+  acct_buffer_len = 0;
+
+  if ((acct_usage_fd >= 0) &&
+      (acct_usage_buffered > 0))
+    {
+    const char *ptr = (const char *)acct_usage_buffer;
+    size_t      len = acct_usage_buffered * sizeof(acct_usage_record);
+
+    while (len > 0)
+      {
+      ssize_t amt = write(acct_usage_fd, ptr, len);
+
+      if (amt < 0)
+        {
+        if (errno == EINTR)
+          continue;
+
+        log_err(errno, __func__, "could not write the usage file");
+        break;
+        }
+
+      ptr += amt;
+      len -= amt;
+      }
+    }
+
+  acct_usage_buffered = 0;
+  }  /* END acct_write_buffer() */
+
+
+
+/*
+ * acct_usage_open - opens the usage file of the open accounting file
+ *
+ * Records already in the file are read back into the user index, so a
+ * restarted server keeps indexing the same day.
+ * acctfile_mutex must be held
+ *
+ * @return PBSE_NONE on success, -1 if the file can't be used
+ */
+
+static int acct_usage_open(void)
+
+  {
+  std::string        path(acct_path + ACCT_USAGE_SUFFIX);
+  acct_usage_header  header;
+  acct_usage_record  rec;
+  struct stat        sb;
+  char               log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if (acct_usage_fd >= 0)
+    return(PBSE_NONE);
+
+  if ((acct_usage_fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644)) < 0)
+    {
+    log_err(errno, __func__, path.c_str());
+    return(-1);
+    }
+
+  acct_usage_count = 0;
+  acct_usage_index.clear();
+
+  if ((fstat(acct_usage_fd, &sb) == 0) &&
+      (sb.st_size == 0))
+    {
+    memset(&header, 0, sizeof(header));
+    header.uh_magic = ACCT_USAGE_MAGIC;
+    header.uh_version = ACCT_USAGE_VERSION;
+    header.uh_record_size = sizeof(acct_usage_record);
+    header.uh_created = time(NULL);
+
+    if (write(acct_usage_fd, &header, sizeof(header)) != sizeof(header))
+      {
+      log_err(errno, __func__, path.c_str());
+      close(acct_usage_fd);
+      acct_usage_fd = -1;
+      return(-1);
+      }
+
+    return(PBSE_NONE);
+    }
+
+  if ((pread(acct_usage_fd, &header, sizeof(header), 0) != sizeof(header)) ||
+      (header.uh_magic != ACCT_USAGE_MAGIC) ||
+      (header.uh_version != ACCT_USAGE_VERSION) ||
+      (header.uh_record_size != sizeof(acct_usage_record)))
+    {
+    snprintf(log_buf, sizeof(log_buf), "%s is not a usage file, not recording usage", path.c_str());
+    log_err(-1, __func__, log_buf);
+    close(acct_usage_fd);
+    acct_usage_fd = -1;
+    return(-1);
+    }
+
+  off_t offset = sizeof(header);
+
+  while (pread(acct_usage_fd, &rec, sizeof(rec), offset) == sizeof(rec))
+    {
+    rec.ur_user[ACCT_USAGE_NAME_LEN - 1] = '\0';
+    acct_usage_index[rec.ur_user].push_back(acct_usage_count++);
+    offset += sizeof(rec);
+    }
+
+  /* drop a partial record left by a crash so the records stay aligned */
+  if (ftruncate(acct_usage_fd, offset) != 0)
+    log_err(errno, __func__, path.c_str());
+
+  return(PBSE_NONE);
+  }  /* END acct_usage_open() */
+
+
+
+/*
+ * acct_usage_write_index - writes the user index of the open usage file
+ *
+ * acctfile_mutex must be held
+ */
+
+static void acct_usage_write_index(void)
+
+  {
+  std::string                          path(acct_path + ACCT_USAGE_INDEX_SUFFIX);
+  std::string                          tmp_path(path + ".new");
+  acct_usage_index_header              header;
+  std::vector<acct_usage_index_entry>  entries;
+  std::vector<uint32_t>                record_numbers;
+  FILE                                *fp;
+
+  memset(&header, 0, sizeof(header));
+  header.uih_magic = ACCT_USAGE_INDEX_MAGIC;
+  header.uih_version = ACCT_USAGE_VERSION;
+  header.uih_user_count = acct_usage_index.size();
+  header.uih_record_count = acct_usage_count;
+
+  for (std::map<std::string, std::vector<uint32_t> >::iterator it = acct_usage_index.begin();
+       it != acct_usage_index.end();
+       it++)
+    {
+    acct_usage_index_entry entry;
+
+    memset(&entry, 0, sizeof(entry));
+    snprintf(entry.uie_user, sizeof(entry.uie_user), "%s", it->first.c_str());
+    entry.uie_first = record_numbers.size();
+    entry.uie_count = it->second.size();
+    entries.push_back(entry);
+
+    record_numbers.insert(record_numbers.end(), it->second.begin(), it->second.end());
+    }
+
+  if ((fp = fopen(tmp_path.c_str(), "w")) == NULL)
+    {
+    log_err(errno, __func__, tmp_path.c_str());
+    return;
+    }
+
+  if ((fwrite(&header, sizeof(header), 1, fp) != 1) ||
+      ((entries.size() > 0) &&
+       (fwrite(&entries[0], sizeof(acct_usage_index_entry), entries.size(), fp) != entries.size())) ||
+      ((record_numbers.size() > 0) &&
+       (fwrite(&record_numbers[0], sizeof(uint32_t), record_numbers.size(), fp) != record_numbers.size())))
+    {
+    log_err(errno, __func__, tmp_path.c_str());
+    fclose(fp);
+    unlink(tmp_path.c_str());
+    return;
+    }
+
+  fclose(fp);
+
+  if (rename(tmp_path.c_str(), path.c_str()) != 0)
+    log_err(errno, __func__, path.c_str());
+  }  /* END acct_usage_write_index() */
+
+
+
+/*
+ * acct_usage_close - writes the index of the usage file and closes it
+ *
+ * acctfile_mutex must be held
+ */
+
+static void acct_usage_close(void)
+
+  {
+  if (acct_usage_fd < 0)
+    return;
+
+  acct_write_buffer();
+  acct_usage_write_index();
+
+  close(acct_usage_fd);
+  acct_usage_fd = -1;
+  acct_usage_count = 0;
+  acct_usage_index.clear();
+  }  /* END acct_usage_close() */
+
+
+
+/*
+ * acct_usage_enable - starts or stops the usage sidecar
+ *
+ * Called when record_job_usage is set. The sidecar follows the accounting
+ * file, so it is opened now if the accounting file is.
+ */
+
+void acct_usage_enable(
+
+  bool enable)
+
+  {
+  pthread_mutex_lock(acctfile_mutex);
+
+  acct_usage_enabled = enable;
+
+  if (enable == false)
+    acct_usage_close();
+  else if (acct_opened != 0)
+    acct_usage_open();
+
+  pthread_mutex_unlock(acctfile_mutex);
+  }  /* END acct_usage_enable() */
+
+
+
+/*
+ * acct_flush - writes the buffered accounting records
+ */
+
+void acct_flush(void)
+
+  {
+  if (acct_opened == 0)
+    return;
+
+  pthread_mutex_lock(acctfile_mutex);
+  acct_write_buffer();
+  pthread_mutex_unlock(acctfile_mutex);
+  }  /* END acct_flush() */
+
+
+
 /*
  * acct_open() - open the acct file for append.
  *
@@ -365,12 +643,20 @@ int acct_open(
     pthread_mutex_lock(acctfile_mutex);
 
   if (acct_opened > 0)          /* if acct was open, close it */
+    {
+    acct_write_buffer();
+    acct_usage_close();
     fclose(acctfile);
+    }
 
   acctfile = newacct;
+  acct_path = filename;
   
   acct_opened = 1;  /* note that file is open */
 
+  if (acct_usage_enabled == true)
+    acct_usage_open();
+
   if (acct_mutex_locked == false)
     pthread_mutex_unlock(acctfile_mutex);
 
@@ -400,6 +686,8 @@ void acct_close(
 
   if (acct_opened == 1)
     {
+    acct_write_buffer();
+    acct_usage_close();
     fclose(acctfile);
 
     acct_opened = 0;
@@ -415,6 +703,10 @@ void acct_close(
 
 /*
  * account_record - write basic accounting record
+ *
+ * Records are buffered and written when the buffer fills or holds a record
+ * older than ACCT_FLUSH_INTERVAL seconds. The main loop calls acct_flush()
+ * so an idle server doesn't hold records either.
  */
 
 void account_record(
@@ -425,8 +717,9 @@ void account_record(
 
   {
   time_t     time_now = time(NULL);
-  struct tm *ptm;
   struct tm  tmpPtm;
+  size_t     space;
+  int        len;
 
   pthread_mutex_lock(acctfile_mutex);
   if (acct_opened == 0)
@@ -434,31 +727,84 @@ void account_record(
     acct_open(acct_file, true);
     }
 
-  ptm = localtime_r(&time_now,&tmpPtm);
+  /* localtime_r() only when the second changes */
+  if (time_now != acct_stamp_time)
+    {
+    localtime_r(&time_now, &tmpPtm);
+
+    snprintf(acct_stamp, sizeof(acct_stamp), "%02d/%02d/%04d %02d:%02d:%02d",
+      tmpPtm.tm_mon + 1,
+      tmpPtm.tm_mday,
+      tmpPtm.tm_year + 1900,
+      tmpPtm.tm_hour,
+      tmpPtm.tm_min,
+      tmpPtm.tm_sec);
+
+    acct_stamp_time = time_now;
+    acct_stamp_yday = tmpPtm.tm_yday;
+    }
 
   /* Do we need to switch files */
 
   if ((acct_auto_switch != 0) &&
-      (acct_opened_day != ptm->tm_yday))
+      (acct_opened_day != acct_stamp_yday))
     {
     acct_close(true);
 
     acct_open(NULL, true);
     }
 
+  if (acct_opened == 0)
+    {
+    pthread_mutex_unlock(acctfile_mutex);
+    return;
+    }
+
   if (text == NULL)
     text = (char *)"";
 
-  fprintf(acctfile, "%02d/%02d/%04d %02d:%02d:%02d;%c;%s;%s\n",
-          ptm->tm_mon + 1,
-          ptm->tm_mday,
-          ptm->tm_year + 1900,
-          ptm->tm_hour,
-          ptm->tm_min,
-          ptm->tm_sec,
+  space = sizeof(acct_buffer) - acct_buffer_len;
+  len = snprintf(acct_buffer + acct_buffer_len, space, "%s;%c;%s;%s\n",
+          acct_stamp,
           (char)acctype,
           pjob->ji_qs.ji_jobid,
           text);
+
+  if ((size_t)len >= space)
+    {
+    /* make room, and write records too big for the buffer directly */
+    acct_write_buffer();
+
+    len = snprintf(acct_buffer, sizeof(acct_buffer), "%s;%c;%s;%s\n",
+            acct_stamp,
+            (char)acctype,
+            pjob->ji_qs.ji_jobid,
+            text);
+
+    if ((size_t)len >= sizeof(acct_buffer))
+      {
+      fprintf(acctfile, "%s;%c;%s;%s\n",
+        acct_stamp,
+        (char)acctype,
+        pjob->ji_qs.ji_jobid,
+        text);
+
+      len = 0;
+      }
+    }
+
+  if (len > 0)
+    {
+    if (acct_buffer_len == 0)
+      acct_buffer_oldest = time_now;
+
+    acct_buffer_len += len;
+    }
+
+  if ((acct_buffer_len > 0) &&
+      (time_now - acct_buffer_oldest >= ACCT_FLUSH_INTERVAL))
+    acct_write_buffer();
+
   pthread_mutex_unlock(acctfile_mutex);
 
   return;
@@ -500,20 +846,21 @@ void account_jobstr(
  * @param acct_data (O) - the string we're adding to
  */
 
-void add_procs_and_nodes_used(
+void count_procs_and_nodes(
 
-  job         &pjob,
-  std::string &acct_data)
+  job &pjob,
+  int &total_execution_slots,
+  int &hosts)
 
   {
+  total_execution_slots = 0;
+  hosts = 0;
+
   if (pjob.ji_wattr[JOB_ATR_exec_host].at_val.at_str != NULL)
     {
-    char        resc_buf[1024];
     std::string nodelist(pjob.ji_wattr[JOB_ATR_exec_host].at_val.at_str);
     std::size_t pos = 0;
     std::string last_host;
-    int         hosts = 0;
-    int         total_execution_slots = 0;
 
     while (pos < nodelist.size())
       {
@@ -546,6 +893,24 @@ void add_procs_and_nodes_used(
       else
         break;
       }
+    }
+  } // END count_procs_and_nodes()
+
+
+
+void add_procs_and_nodes_used(
+
+  job         &pjob,
+  std::string &acct_data)
+
+  {
+  if (pjob.ji_wattr[JOB_ATR_exec_host].at_val.at_str != NULL)
+    {
+    char resc_buf[1024];
+    int  total_execution_slots;
+    int  hosts;
+
+    count_procs_and_nodes(pjob, total_execution_slots, hosts);
 
     snprintf(resc_buf, sizeof(resc_buf), "total_execution_slots=%d unique_node_count=%d ",
       total_execution_slots, hosts);
@@ -557,6 +922,110 @@ void add_procs_and_nodes_used(
 
 
 
+/*
+ * fill_usage_record
+ *
+ * Builds the usage sidecar record for a job that ended
+ *
+ * @param pjob (I) - the job that ended
+ * @param end_time (I) - the end time written to its E record
+ * @param rec (O) - the record
+ */
+
+void fill_usage_record(
+
+  job               &pjob,
+  long               end_time,
+  acct_usage_record &rec)
+
+  {
+  pbs_attribute *pattr = &pjob.ji_wattr[JOB_ATR_resc_used];
+  int            slots;
+  int            nodes;
+
+  memset(&rec, 0, sizeof(rec));
+
+  rec.ur_time = time(NULL);
+  rec.ur_type = PBS_ACCT_END;
+  rec.ur_qtime = pjob.ji_wattr[JOB_ATR_qtime].at_val.at_long;
+  rec.ur_start = pjob.ji_wattr[JOB_ATR_start_time].at_val.at_long;
+  rec.ur_end = end_time;
+  rec.ur_exit_status = pjob.ji_wattr[JOB_ATR_exitstat].at_val.at_long;
+
+  count_procs_and_nodes(pjob, slots, nodes);
+  rec.ur_slots = slots;
+  rec.ur_nodes = nodes;
+
+  snprintf(rec.ur_job_id, sizeof(rec.ur_job_id), "%s", pjob.ji_qs.ji_jobid);
+  snprintf(rec.ur_queue, sizeof(rec.ur_queue), "%s", pjob.ji_qs.ji_queue);
+
+  if (pjob.ji_wattr[JOB_ATR_euser].at_val.at_str != NULL)
+    snprintf(rec.ur_user, sizeof(rec.ur_user), "%s", pjob.ji_wattr[JOB_ATR_euser].at_val.at_str);
+
+  if (pjob.ji_wattr[JOB_ATR_egroup].at_val.at_str != NULL)
+    snprintf(rec.ur_group, sizeof(rec.ur_group), "%s", pjob.ji_wattr[JOB_ATR_egroup].at_val.at_str);
+
+  if (pjob.ji_wattr[JOB_ATR_account].at_val.at_str != NULL)
+    snprintf(rec.ur_account, sizeof(rec.ur_account), "%s", pjob.ji_wattr[JOB_ATR_account].at_val.at_str);
+
+  if (((pattr->at_flags & ATR_VFLAG_SET) == 0) ||
+      (pattr->at_val.at_ptr == NULL))
+    return;
+
+  std::vector<resource> *resources = (std::vector<resource> *)pattr->at_val.at_ptr;
+
+  for (size_t i = 0; i < resources->size(); i++)
+    {
+    resource   &r = resources->at(i);
+    const char *pname = r.rs_defin->rs_name;
+
+    if (!strcmp(pname, "walltime"))
+      rec.ur_walltime = r.rs_value.at_val.at_long;
+    else if (!strcmp(pname, "cput"))
+      rec.ur_cput = r.rs_value.at_val.at_long;
+    else if (!strcmp(pname, "mem"))
+      rec.ur_mem = (r.rs_value.at_val.at_size.atsv_num << r.rs_value.at_val.at_size.atsv_shift) >> 10;
+    else if (!strcmp(pname, "vmem"))
+      rec.ur_vmem = (r.rs_value.at_val.at_size.atsv_num << r.rs_value.at_val.at_size.atsv_shift) >> 10;
+    }
+  } // END fill_usage_record()
+
+
+
+/*
+ * account_usage - buffer a job's usage sidecar record
+ */
+
+void account_usage(
+
+  job  *pjob,
+  long  end_time)
+
+  {
+  if (acct_usage_fd < 0)
+    return;
+
+  acct_usage_record rec;
+
+  fill_usage_record(*pjob, end_time, rec);
+
+  pthread_mutex_lock(acctfile_mutex);
+
+  /* the file may have been closed or switched since the check above */
+  if (acct_usage_fd >= 0)
+    {
+    acct_usage_buffer[acct_usage_buffered++] = rec;
+    acct_usage_index[rec.ur_user].push_back(acct_usage_count++);
+
+    if (acct_usage_buffered == ACCT_USAGE_BUFFER_RECORDS)
+      acct_write_buffer();
+    }
+
+  pthread_mutex_unlock(acctfile_mutex);
+  } // END account_usage()
+
+
+
 /*
  * account_jobend - write a job termination/resource usage record
  */
@@ -569,6 +1038,7 @@ void account_jobend(
   {
   std::string ds = "";
   char                local_buf[MAXLINE * 4];
+  long                end_time;
 #ifdef USESAVEDRESOURCES
   pbs_attribute      *pattr;
   long                walltime_val = 0;
@@ -620,10 +1090,11 @@ void account_jobend(
         }
       }
     }
-  sprintf(local_buf, "end=%ld ", (long)pjob->ji_qs.ji_stime + walltime_val);
+  end_time = (long)pjob->ji_qs.ji_stime + walltime_val;
 #else
-  sprintf(local_buf, "end=%ld ", (long)pjob->ji_wattr[JOB_ATR_comp_time].at_val.at_long);
+  end_time = (long)pjob->ji_wattr[JOB_ATR_comp_time].at_val.at_long;
 #endif /* USESAVEDRESOURCES */
+  sprintf(local_buf, "end=%ld ", end_time);
 
   ds += local_buf;
 
@@ -632,6 +1103,8 @@ void account_jobend(
 
   account_record(PBS_ACCT_END, pjob, ds.c_str());
 
+  account_usage(pjob, end_time);
+
   return;
   }  /* END account_jobend() */
 
@@ -62,7 +62,6 @@
 
 extern int array_upgrade(job_array *, int, int, int *);
 extern char *get_correct_jobname(const char *jobid);
-extern int count_user_queued_jobs(pbs_queue *,char *);
 extern void post_modify_arrayreq(batch_request *preq);
 
 /* global data items used */
@@ -765,15 +764,8 @@ int parse_array_dom(
   if ((!rc))
     {
     job_array  *new_pa = *pa;
-    if (new_pa->ai_qs.array_size > 0)
-      if ((new_pa->job_ids = (char **)calloc(new_pa->ai_qs.array_size, sizeof(char *))) == NULL)
-        {
-        snprintf(log_buf, buflen, "%s", "unable to allocate memory for array job_ids strings");
-        rc = -1;
-        }
 
-    if ((!(rc)) &&
-        (num_tokens > 0) && tokensNode)
+    if ((num_tokens > 0) && tokensNode)
       rc = parse_num_tokens(pa, tokensNode, log_buf, buflen);
 
     new_pa->initialize_uncreated_ids();
@@ -926,13 +918,6 @@ int array_recov_binary(
     return PBSE_SYSTEM;
     }
 
-  pa->job_ids = (char **)calloc(pa->ai_qs.array_size, sizeof(char *));
-  if(pa->job_ids == NULL)
-    {
-    close(fd);
-    return PBSE_SYSTEM;
-    }
-
   /* check to see if there is any additional info saved in the array file */
   /* check if there are any array request tokens that haven't been fully
      processed */
@@ -1435,13 +1420,12 @@ int delete_array_range(
     if (index >= pa->ai_qs.array_size)
       continue;
     
-    if (pa->job_ids[index] == NULL)
+    if (pa->get_job_id(index) == NULL)
       continue;
 
-    if ((pjob = svr_find_job(pa->job_ids[index], FALSE)) == NULL)
+    if ((pjob = svr_find_job(pa->get_job_id(index), FALSE)) == NULL)
       {
-      free(pa->job_ids[index]);
-      pa->job_ids[index] = NULL;
+      pa->remove_job_id(index);
       }
     else
       {
@@ -1452,7 +1436,8 @@ int delete_array_range(
         continue;
         }
 
-      int old_state = pjob->ji_qs.ji_state;
+      int         old_state = pjob->ji_qs.ji_state;
+      std::string job_id(pjob->ji_qs.ji_jobid);
 
       running = (pjob->ji_qs.ji_state == JOB_STATE_RUNNING);
 
@@ -1470,7 +1455,7 @@ int delete_array_range(
           if (err != PBSE_JOB_RECYCLED)
             {
             char log_buf[LOCAL_LOG_BUF_SIZE];
-            sprintf(log_buf, "Error when purging %s", pa->job_ids[i]);
+            sprintf(log_buf, "Error when purging %s", job_id.c_str());
             log_err(err, __func__, log_buf);
             deleted = false;
             }
@@ -1495,7 +1480,7 @@ int delete_array_range(
         if (running == FALSE)
           num_deleted++;
 
-        pa->update_array_values(old_state, aeTerminate, pa->job_ids[i], cancel_exit_code);
+        pa->update_array_values(old_state, aeTerminate, job_id.c_str(), cancel_exit_code);
         }
       }
     }
@@ -1519,15 +1504,7 @@ int first_job_index(
   job_array *pa)
 
   {
-  int i;
-
-  for (i = 0; i < pa->ai_qs.array_size; i++)
-    {
-    if (pa->job_ids[i] != NULL)
-      return(i);
-    }
-
-  return(-1);
+  return(pa->next_job_index(-1));
   } /* END first_job_index() */
 
 
@@ -1561,15 +1538,11 @@ int delete_whole_array(
 
   job *pjob;
 
-  for (i = 0; i < pa->ai_qs.array_size; i++)
+  for (i = pa->next_job_index(-1); i >= 0; i = pa->next_job_index(i))
     {
-    if (pa->job_ids[i] == NULL)
-      continue;
-
-    if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
+    if ((pjob = svr_find_job(pa->get_job_id(i), FALSE)) == NULL)
       {
-      free(pa->job_ids[i]);
-      pa->job_ids[i] = NULL;
+      pa->remove_job_id(i);
       }
     else
       {
@@ -1583,7 +1556,8 @@ int delete_whole_array(
         continue;
         }
 
-      int old_state = pjob->ji_qs.ji_state;
+      int         old_state = pjob->ji_qs.ji_state;
+      std::string job_id(pjob->ji_qs.ji_jobid);
         
       running = (pjob->ji_qs.ji_state == JOB_STATE_RUNNING);
 
@@ -1602,7 +1576,7 @@ int delete_whole_array(
           if (err != PBSE_JOB_RECYCLED)
             {
             char log_buf[LOCAL_LOG_BUF_SIZE];
-            sprintf(log_buf, "Error when purging %s", pa->job_ids[i]);
+            sprintf(log_buf, "Error when purging %s", job_id.c_str());
             log_err(err, __func__, log_buf);
             deleted = false;
             }
@@ -1631,7 +1605,7 @@ int delete_whole_array(
       
       if ((deleted == true) &&
           (purge == false))
-        pa->update_array_values(old_state, aeTerminate, pa->job_ids[i], cancel_exit_code);
+        pa->update_array_values(old_state, aeTerminate, job_id.c_str(), cancel_exit_code);
       }
     }
 
@@ -1685,13 +1659,12 @@ int hold_array_range(
       if (index >= pa->ai_qs.array_size)
         continue;
       
-      if (pa->job_ids[index] == NULL)
+      if (pa->get_job_id(index) == NULL)
         continue;
 
-      if ((pjob = svr_find_job(pa->job_ids[index], FALSE)) == NULL)
+      if ((pjob = svr_find_job(pa->get_job_id(index), FALSE)) == NULL)
         {
-        free(pa->job_ids[index]);
-        pa->job_ids[index] = NULL;
+        pa->remove_job_id(index);
         }
       else
         {
@@ -1739,13 +1712,12 @@ int release_array_range(
     if (index >= pa->ai_qs.array_size)
       continue;
 
-    if (pa->job_ids[index] == NULL)
+    if (pa->get_job_id(index) == NULL)
       continue;
 
-    if ((pjob = svr_find_job(pa->job_ids[index], FALSE)) == NULL)
+    if ((pjob = svr_find_job(pa->get_job_id(index), FALSE)) == NULL)
       {
-      free(pa->job_ids[index]);
-      pa->job_ids[index] = NULL;
+      pa->remove_job_id(index);
       }
     else
       {
@@ -1791,13 +1763,12 @@ int modify_array_range(
       int index = range_vec[i];
 
       if ((index >= pa->ai_qs.array_size) ||
-          (pa->job_ids[index] == NULL))
+          (pa->get_job_id(index) == NULL))
         continue;
 
-      if ((pjob = svr_find_job(pa->job_ids[index], FALSE)) == NULL)
+      if ((pjob = svr_find_job(pa->get_job_id(index), FALSE)) == NULL)
         {
-        free(pa->job_ids[index]);
-        pa->job_ids[index] = NULL;
+        pa->remove_job_id(index);
         }
       else
         {
@@ -1820,7 +1791,7 @@ int modify_array_range(
         if (pjob == NULL)
           {
           pjob_mutex.set_unlock_on_exit(false);
-          pa->job_ids[i] = NULL;
+          pa->remove_job_id(index);
           }
         }
       }
@@ -1928,7 +1899,7 @@ int update_slot_values(
             continue;
           }
         
-        job *pj = svr_find_job(pa->job_ids[i], TRUE);
+        job *pj = svr_find_job(candidates[i].c_str(), TRUE);
         
         if (pj != NULL)
           {
@@ -1995,24 +1966,20 @@ int check_array_slot_limits(
       number_queued++;
     
     job *pj;
-    int  i = 0;
+    int  i = pa->next_job_index(-1);
 
     // Only loop until we verify that we have the correct running count
     while ((jobs_currently_running < pa->ai_qs.jobs_running) &&
-           (i < pa->ai_qs.num_jobs))
+           (i >= 0))
       {
-      for (; i < pa->ai_qs.num_jobs; i++)
+      for (; i >= 0; i = pa->next_job_index(i))
         {
-        if (pa->job_ids[i] == NULL)
-          continue;
-
-        if (!strcmp(pjob->ji_qs.ji_jobid, pa->job_ids[i]))
+        if (!strcmp(pjob->ji_qs.ji_jobid, pa->get_job_id(i)))
           continue;
 
-        if ((pj = svr_find_job(pa->job_ids[i], TRUE)) == NULL)
+        if ((pj = svr_find_job(pa->get_job_id(i), TRUE)) == NULL)
           {
-          free(pa->job_ids[i]);
-          pa->job_ids[i] = NULL;
+          pa->remove_job_id(i);
           }
         else
           {
@@ -2061,9 +2028,9 @@ void update_slot_held_jobs(
   int        num_to_release)
 
   {
-  for (int i = 0; i < pa->ai_qs.num_jobs && num_to_release > 0; i++)
+  for (int i = pa->next_job_index(-1); i >= 0 && num_to_release > 0; i = pa->next_job_index(i))
     {
-    job *pjob = svr_find_job(pa->job_ids[i], TRUE);
+    job *pjob = svr_find_job(pa->get_job_id(i), TRUE);
 
     if (pjob != NULL)
       {
@@ -2072,9 +2039,9 @@ void update_slot_held_jobs(
       }
     }
   
-  for (int i = 0; i < pa->ai_qs.num_jobs && num_to_release < 0; i++)
+  for (int i = pa->next_job_index(-1); i >= 0 && num_to_release < 0; i = pa->next_job_index(i))
     {
-    job *pjob = svr_find_job(pa->job_ids[i], TRUE);
+    job *pjob = svr_find_job(pa->get_job_id(i), TRUE);
 
     if (pjob != NULL)
       {
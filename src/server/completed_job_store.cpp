@@ -0,0 +1,921 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "pbs_error.h"
+#include "completed_job_store.hpp"
+
+
+
+/*
+ * append_string()
+ *
+ * Appends a length-prefixed string to a record being built
+ */
+
+static void append_string(
+
+  std::string       &out,
+  const std::string &str)
+
+  {
+  unsigned int len = str.size();
+
+  out.append((const char *)&len, sizeof(len));
+  out.append(str);
+  } /* END append_string() */
+
+
+
+/*
+ * read_string()
+ *
+ * Reads a length-prefixed string from a record
+ * @return true if the string fit inside the record
+ */
+
+static bool read_string(
+
+  const char   *data,
+  size_t        length,
+  size_t       &pos,
+  std::string  &str)
+
+  {
+  unsigned int len;
+
+  if (pos + sizeof(len) > length)
+    return(false);
+
+  memcpy(&len, data + pos, sizeof(len));
+  pos += sizeof(len);
+
+  if (len > length - pos)
+    return(false);
+
+  str.assign(data + pos, len);
+  pos += len;
+
+  return(true);
+  } /* END read_string() */
+
+
+
+/*
+ * encode_completed_record()
+ *
+ * Packs a compacted job into the record format shared by memory and the
+ * spill file. Records are padded to 8 bytes so headers stay aligned in
+ * the file.
+ * @param out - set to the packed record
+ * @return PBSE_NONE on success
+ */
+
+int encode_completed_record(
+
+  const char                            *job_id,
+  const completed_job_info              &info,
+  const std::vector<completed_job_attr> &attrs,
+  std::string                           &out)
+
+  {
+  completed_record_header hdr;
+
+  if (job_id == NULL)
+    return(PBSE_BAD_PARAMETER);
+
+  out.assign(sizeof(hdr), '\0');
+
+  append_string(out, job_id);
+  append_string(out, info.ci_owner);
+  append_string(out, info.ci_submit_host);
+  append_string(out, info.ci_queue);
+
+  for (size_t i = 0; i < attrs.size(); i++)
+    {
+    int index = attrs[i].ca_index;
+
+    out.append((const char *)&index, sizeof(index));
+    append_string(out, attrs[i].ca_name);
+    append_string(out, attrs[i].ca_resc);
+    append_string(out, attrs[i].ca_value);
+    }
+
+  if (out.size() % 8 != 0)
+    out.append(8 - (out.size() % 8), '\0');
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.cr_magic = COMPLETED_STORE_MAGIC;
+  hdr.cr_length = out.size();
+  hdr.cr_live = 1;
+  hdr.cr_attr_count = attrs.size();
+  hdr.cr_mod_time = info.ci_mod_time;
+  hdr.cr_expires = info.ci_expires;
+
+  memcpy(&out[0], &hdr, sizeof(hdr));
+
+  return(PBSE_NONE);
+  } /* END encode_completed_record() */
+
+
+
+/*
+ * decode_completed_record()
+ *
+ * Unpacks a record built by encode_completed_record()
+ * @param attrs - set to the encoded status, or NULL to only read the header
+ * @return true if the record is well formed
+ */
+
+bool decode_completed_record(
+
+  const char                      *data,
+  size_t                           length,
+  std::string                     &job_id,
+  completed_job_info              &info,
+  std::vector<completed_job_attr> *attrs)
+
+  {
+  completed_record_header hdr;
+  size_t                  pos = sizeof(hdr);
+
+  if ((data == NULL) ||
+      (length < sizeof(hdr)))
+    return(false);
+
+  memcpy(&hdr, data, sizeof(hdr));
+
+  if ((hdr.cr_magic != COMPLETED_STORE_MAGIC) ||
+      (hdr.cr_length > length))
+    return(false);
+
+  length = hdr.cr_length;
+  info.ci_mod_time = hdr.cr_mod_time;
+  info.ci_expires = hdr.cr_expires;
+
+  if ((read_string(data, length, pos, job_id) == false) ||
+      (read_string(data, length, pos, info.ci_owner) == false) ||
+      (read_string(data, length, pos, info.ci_submit_host) == false) ||
+      (read_string(data, length, pos, info.ci_queue) == false))
+    return(false);
+
+  if (attrs == NULL)
+    return(true);
+
+  attrs->clear();
+
+  for (unsigned int i = 0; i < hdr.cr_attr_count; i++)
+    {
+    completed_job_attr ca;
+
+    if (pos + sizeof(ca.ca_index) > length)
+      return(false);
+
+    memcpy(&ca.ca_index, data + pos, sizeof(ca.ca_index));
+    pos += sizeof(ca.ca_index);
+
+    if ((read_string(data, length, pos, ca.ca_name) == false) ||
+        (read_string(data, length, pos, ca.ca_resc) == false) ||
+        (read_string(data, length, pos, ca.ca_value) == false))
+      return(false);
+
+    attrs->push_back(ca);
+    }
+
+  return(true);
+  } /* END decode_completed_record() */
+
+
+
+completed_job_store::completed_job_store() : records(), expiry(), spill_path(),
+                                             spill_fd(-1), spill_map(NULL), spill_size(0),
+                                             spill_used(0), spill_dead(0)
+
+  {
+  pthread_mutex_init(&this->lock, NULL);
+  }
+
+
+
+completed_job_store::~completed_job_store()
+
+  {
+  this->spill_close();
+  }
+
+
+
+/*
+ * record_data()
+ *
+ * @return the packed bytes of rec, wherever they are kept
+ */
+
+const char *completed_job_store::record_data(
+
+  const stored_record &rec)
+
+  {
+  if (rec.sr_data.size() != 0)
+    return(rec.sr_data.c_str());
+
+  return(this->spill_map + rec.sr_offset);
+  } /* END record_data() */
+
+
+
+/*
+ * remove_record()
+ *
+ * Drops a record, marking its bytes dead in the spill file if it lives
+ * there. The caller holds the lock.
+ */
+
+void completed_job_store::remove_record(
+
+  std::map<std::string, stored_record>::iterator it)
+
+  {
+  stored_record &rec = it->second;
+
+  if (rec.sr_data.size() == 0)
+    {
+    unsigned int dead = 0;
+
+    memcpy(this->spill_map + rec.sr_offset + offsetof(completed_record_header, cr_live),
+      &dead, sizeof(dead));
+    this->spill_dead += rec.sr_length;
+    }
+
+  this->expiry.erase(std::pair<time_t, std::string>(rec.sr_expires, it->first));
+  this->records.erase(it);
+  } /* END remove_record() */
+
+
+
+/*
+ * spill_reserve()
+ *
+ * Grows the spill file and its mapping so that needed more bytes fit
+ * @return true if there is room
+ */
+
+bool completed_job_store::spill_reserve(
+
+  size_t needed)
+
+  {
+  size_t  new_size = this->spill_size;
+  char   *new_map;
+
+  if (this->spill_used + needed + sizeof(completed_record_header) <= this->spill_size)
+    return(true);
+
+  if (new_size < COMPLETED_STORE_MIN_MAP)
+    new_size = COMPLETED_STORE_MIN_MAP;
+
+  while (this->spill_used + needed + sizeof(completed_record_header) > new_size)
+    new_size *= 2;
+
+  if (ftruncate(this->spill_fd, new_size) != 0)
+    return(false);
+
+  new_map = (char *)mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->spill_fd, 0);
+
+  if (new_map == MAP_FAILED)
+    return(false);
+
+  if (this->spill_map != NULL)
+    munmap(this->spill_map, this->spill_size);
+
+  this->spill_map = new_map;
+  this->spill_size = new_size;
+
+  return(true);
+  } /* END spill_reserve() */
+
+
+
+/*
+ * spill_append()
+ *
+ * Writes a record to the end of the spill file and points rec at it.
+ * A zeroed header always follows the last record so recovery knows where
+ * the file ends.
+ * @return true if the record was written
+ */
+
+bool completed_job_store::spill_append(
+
+  stored_record     &rec,
+  const std::string &data)
+
+  {
+  if (this->spill_reserve(data.size()) == false)
+    return(false);
+
+  memcpy(this->spill_map + this->spill_used, data.c_str(), data.size());
+
+  rec.sr_offset = this->spill_used;
+  rec.sr_length = data.size();
+  rec.sr_data.clear();
+
+  this->spill_used += data.size();
+  memset(this->spill_map + this->spill_used, 0, sizeof(completed_record_header));
+
+  return(true);
+  } /* END spill_append() */
+
+
+
+/*
+ * spill_recover()
+ *
+ * Rebuilds the index from the records already in a spill file. Records
+ * that expired while the server was down, or that are also held in
+ * memory, are marked dead.
+ */
+
+void completed_job_store::spill_recover()
+
+  {
+  size_t pos = 0;
+  time_t now = time(NULL);
+
+  while (pos + sizeof(completed_record_header) <= this->spill_size)
+    {
+    completed_record_header hdr;
+    std::string             job_id;
+    completed_job_info      info;
+
+    memcpy(&hdr, this->spill_map + pos, sizeof(hdr));
+
+    if ((hdr.cr_magic != COMPLETED_STORE_MAGIC) ||
+        (hdr.cr_length < sizeof(hdr)) ||
+        (hdr.cr_length > this->spill_size - pos) ||
+        (decode_completed_record(this->spill_map + pos, hdr.cr_length, job_id, info, NULL) == false))
+      break;
+
+    if (hdr.cr_live != 0)
+      {
+      if ((info.ci_expires <= now) ||
+          (this->records.find(job_id) != this->records.end()))
+        {
+        unsigned int dead = 0;
+
+        memcpy(this->spill_map + pos + offsetof(completed_record_header, cr_live), &dead, sizeof(dead));
+        this->spill_dead += hdr.cr_length;
+        }
+      else
+        {
+        stored_record &rec = this->records[job_id];
+
+        rec.sr_queue = info.ci_queue;
+        rec.sr_expires = info.ci_expires;
+        rec.sr_offset = pos;
+        rec.sr_length = hdr.cr_length;
+        this->expiry.insert(std::pair<time_t, std::string>(rec.sr_expires, job_id));
+        }
+      }
+    else
+      this->spill_dead += hdr.cr_length;
+
+    pos += hdr.cr_length;
+    }
+
+  this->spill_used = pos;
+
+  if (this->spill_used + sizeof(completed_record_header) <= this->spill_size)
+    memset(this->spill_map + this->spill_used, 0, sizeof(completed_record_header));
+  } /* END spill_recover() */
+
+
+
+/*
+ * spill_compact()
+ *
+ * Slides the live records of the spill file down over the dead ones and
+ * gives back the space once more than half of the file is dead
+ */
+
+void completed_job_store::spill_compact()
+
+  {
+  std::vector<std::pair<size_t, stored_record *> > by_offset;
+  size_t                                           pos = 0;
+  size_t                                           new_size;
+
+  if ((this->spill_map == NULL) ||
+      (this->spill_dead < COMPLETED_STORE_MIN_MAP) ||
+      (this->spill_dead * 2 < this->spill_used))
+    return;
+
+  for (std::map<std::string, stored_record>::iterator it = this->records.begin();
+       it != this->records.end();
+       it++)
+    {
+    if (it->second.sr_data.size() == 0)
+      by_offset.push_back(std::pair<size_t, stored_record *>(it->second.sr_offset, &it->second));
+    }
+
+  std::sort(by_offset.begin(), by_offset.end());
+
+  for (size_t i = 0; i < by_offset.size(); i++)
+    {
+    stored_record *rec = by_offset[i].second;
+
+    if (rec->sr_offset != pos)
+      memmove(this->spill_map + pos, this->spill_map + rec->sr_offset, rec->sr_length);
+
+    rec->sr_offset = pos;
+    pos += rec->sr_length;
+    }
+
+  this->spill_used = pos;
+  this->spill_dead = 0;
+  memset(this->spill_map + this->spill_used, 0, sizeof(completed_record_header));
+
+  new_size = COMPLETED_STORE_MIN_MAP;
+
+  while (this->spill_used * 2 + sizeof(completed_record_header) > new_size)
+    new_size *= 2;
+
+  if (new_size < this->spill_size)
+    {
+    char *new_map;
+
+    munmap(this->spill_map, this->spill_size);
+    this->spill_map = NULL;
+
+    if ((ftruncate(this->spill_fd, new_size) == 0) &&
+        ((new_map = (char *)mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->spill_fd, 0)) != MAP_FAILED))
+      {
+      this->spill_map = new_map;
+      this->spill_size = new_size;
+      }
+    else
+      {
+      /* the file still holds everything, map it at its old size */
+      this->spill_map = (char *)mmap(NULL, this->spill_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->spill_fd, 0);
+      }
+    }
+  } /* END spill_compact() */
+
+
+
+/*
+ * spill_close()
+ *
+ * Unmaps and closes the spill file, leaving it on disk
+ */
+
+void completed_job_store::spill_close()
+
+  {
+  if ((this->spill_map != NULL) &&
+      (this->spill_map != MAP_FAILED))
+    munmap(this->spill_map, this->spill_size);
+
+  if (this->spill_fd >= 0)
+    close(this->spill_fd);
+
+  this->spill_map = NULL;
+  this->spill_fd = -1;
+  this->spill_size = 0;
+  this->spill_used = 0;
+  this->spill_dead = 0;
+  this->spill_path.clear();
+  } /* END spill_close() */
+
+
+
+/*
+ * set_spill_file()
+ *
+ * Moves the store into the spill file at path, recovering any records a
+ * previous server left there, or back into memory if path is NULL or empty.
+ * @return PBSE_NONE on success, PBSE_SYSTEM if the file can't be used
+ */
+
+int completed_job_store::set_spill_file(
+
+  const char *path)
+
+  {
+  struct stat st;
+  int         rc = PBSE_NONE;
+
+  pthread_mutex_lock(&this->lock);
+
+  if ((path != NULL) &&
+      (this->spill_path == path))
+    {
+    pthread_mutex_unlock(&this->lock);
+    return(PBSE_NONE);
+    }
+
+  if (this->spill_map != NULL)
+    {
+    std::string old_path(this->spill_path);
+
+    /* bring everything back into memory, the old file is no longer kept */
+    for (std::map<std::string, stored_record>::iterator it = this->records.begin();
+         it != this->records.end();
+         it++)
+      {
+      if (it->second.sr_data.size() == 0)
+        it->second.sr_data.assign(this->spill_map + it->second.sr_offset, it->second.sr_length);
+      }
+
+    this->spill_close();
+    unlink(old_path.c_str());
+    }
+
+  if ((path == NULL) ||
+      (*path == '\0'))
+    {
+    pthread_mutex_unlock(&this->lock);
+    return(PBSE_NONE);
+    }
+
+  if (((this->spill_fd = open(path, O_RDWR | O_CREAT, 0600)) < 0) ||
+      (fstat(this->spill_fd, &st) != 0))
+    rc = PBSE_SYSTEM;
+  else
+    {
+    this->spill_size = st.st_size;
+
+    if (this->spill_size < COMPLETED_STORE_MIN_MAP)
+      {
+      this->spill_size = COMPLETED_STORE_MIN_MAP;
+
+      if (ftruncate(this->spill_fd, this->spill_size) != 0)
+        rc = PBSE_SYSTEM;
+      }
+
+    if ((rc == PBSE_NONE) &&
+        ((this->spill_map = (char *)mmap(NULL, this->spill_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->spill_fd, 0)) == MAP_FAILED))
+      {
+      this->spill_map = NULL;
+      rc = PBSE_SYSTEM;
+      }
+    }
+
+  if (rc != PBSE_NONE)
+    {
+    this->spill_close();
+    pthread_mutex_unlock(&this->lock);
+    return(rc);
+    }
+
+  this->spill_path = path;
+  this->spill_recover();
+
+  /* the records that were held in memory move into the file */
+  for (std::map<std::string, stored_record>::iterator it = this->records.begin();
+       it != this->records.end();
+       it++)
+    {
+    if (it->second.sr_data.size() != 0)
+      {
+      std::string data(it->second.sr_data);
+
+      this->spill_append(it->second, data);
+      }
+    }
+
+  this->spill_compact();
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(PBSE_NONE);
+  } /* END set_spill_file() */
+
+
+
+/*
+ * add_job()
+ *
+ * Stores the compacted status of a completed job until info.ci_expires
+ * @return true if the job was added, false if it is already stored
+ */
+
+bool completed_job_store::add_job(
+
+  const char                            *job_id,
+  const completed_job_info              &info,
+  const std::vector<completed_job_attr> &attrs)
+
+  {
+  std::string data;
+
+  if (encode_completed_record(job_id, info, attrs, data) != PBSE_NONE)
+    return(false);
+
+  pthread_mutex_lock(&this->lock);
+
+  if (this->records.find(job_id) != this->records.end())
+    {
+    pthread_mutex_unlock(&this->lock);
+    return(false);
+    }
+
+  stored_record &rec = this->records[job_id];
+
+  rec.sr_queue = info.ci_queue;
+  rec.sr_expires = info.ci_expires;
+  rec.sr_offset = 0;
+  rec.sr_length = data.size();
+
+  /* keep it in memory if the file can't take it */
+  if ((this->spill_map == NULL) ||
+      (this->spill_append(rec, data) == false))
+    rec.sr_data = data;
+
+  this->expiry.insert(std::pair<time_t, std::string>(rec.sr_expires, job_id));
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(true);
+  } /* END add_job() */
+
+
+
+/*
+ * remove_job()
+ *
+ * @return true if the job was stored
+ */
+
+bool completed_job_store::remove_job(
+
+  const char *job_id)
+
+  {
+  bool found = false;
+
+  if (job_id == NULL)
+    return(false);
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, stored_record>::iterator it = this->records.find(job_id);
+
+  if (it != this->records.end())
+    {
+    this->remove_record(it);
+    this->spill_compact();
+    found = true;
+    }
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(found);
+  } /* END remove_job() */
+
+
+
+bool completed_job_store::has_job(
+
+  const char *job_id)
+
+  {
+  bool found;
+
+  if (job_id == NULL)
+    return(false);
+
+  pthread_mutex_lock(&this->lock);
+  found = this->records.find(job_id) != this->records.end();
+  pthread_mutex_unlock(&this->lock);
+
+  return(found);
+  } /* END has_job() */
+
+
+
+/*
+ * get_job()
+ *
+ * Copies out the stored status of a job
+ * @return true if the job is stored
+ */
+
+bool completed_job_store::get_job(
+
+  const char                      *job_id,
+  completed_job_info              &info,
+  std::vector<completed_job_attr> &attrs)
+
+  {
+  bool        found = false;
+  std::string stored_id;
+
+  if (job_id == NULL)
+    return(false);
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, stored_record>::iterator it = this->records.find(job_id);
+
+  if (it != this->records.end())
+    found = decode_completed_record(this->record_data(it->second), it->second.sr_length, stored_id, info, &attrs);
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(found);
+  } /* END get_job() */
+
+
+
+/*
+ * get_job_ids()
+ *
+ * @param queue - only list the jobs completed in this queue, or all jobs if NULL
+ * @param ids - the stored job ids are appended here
+ */
+
+void completed_job_store::get_job_ids(
+
+  const char               *queue,
+  std::vector<std::string> &ids)
+
+  {
+  pthread_mutex_lock(&this->lock);
+
+  for (std::map<std::string, stored_record>::iterator it = this->records.begin();
+       it != this->records.end();
+       it++)
+    {
+    if ((queue == NULL) ||
+        (it->second.sr_queue == queue))
+      ids.push_back(it->first);
+    }
+
+  pthread_mutex_unlock(&this->lock);
+  } /* END get_job_ids() */
+
+
+
+/*
+ * cleanup_expired()
+ *
+ * Drops every record whose keep_completed time is up
+ * @return the number of records dropped
+ */
+
+int completed_job_store::cleanup_expired(
+
+  time_t now)
+
+  {
+  int removed = 0;
+
+  pthread_mutex_lock(&this->lock);
+
+  while ((this->expiry.size() != 0) &&
+         (this->expiry.begin()->first <= now))
+    {
+    std::map<std::string, stored_record>::iterator it = this->records.find(this->expiry.begin()->second);
+
+    if (it != this->records.end())
+      this->remove_record(it);
+    else
+      this->expiry.erase(this->expiry.begin());
+
+    removed++;
+    }
+
+  this->spill_compact();
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(removed);
+  } /* END cleanup_expired() */
+
+
+
+bool completed_job_store::is_spilled()
+
+  {
+  bool spilled;
+
+  pthread_mutex_lock(&this->lock);
+  spilled = this->spill_map != NULL;
+  pthread_mutex_unlock(&this->lock);
+
+  return(spilled);
+  } /* END is_spilled() */
+
+
+
+size_t completed_job_store::count()
+
+  {
+  size_t c;
+
+  pthread_mutex_lock(&this->lock);
+  c = this->records.size();
+  pthread_mutex_unlock(&this->lock);
+
+  return(c);
+  } /* END count() */
+
+
+
+size_t completed_job_store::spill_bytes_used()
+
+  {
+  size_t used;
+
+  pthread_mutex_lock(&this->lock);
+  used = this->spill_used;
+  pthread_mutex_unlock(&this->lock);
+
+  return(used);
+  } /* END spill_bytes_used() */
+
@@ -82,7 +82,7 @@
 
 const char *mgr = "manager";
 
-delete_all_tracker::delete_all_tracker() : qdel_map()
+delete_all_tracker::delete_all_tracker() : qdel_map(), progress_map()
 
   {
   pthread_mutex_init(&this->lock, NULL);
@@ -95,7 +95,7 @@ delete_all_tracker::delete_all_tracker() : qdel_map()
 
 delete_all_tracker::delete_all_tracker(
     
-  const delete_all_tracker &other) : qdel_map(other.qdel_map)
+  const delete_all_tracker &other) : qdel_map(other.qdel_map), progress_map(other.progress_map)
 
   {
   pthread_mutex_init(&this->lock, NULL);
@@ -220,8 +220,85 @@ void delete_all_tracker::done_deleting_all(
   try
     {
     this->qdel_map[user_name] = false;
+    this->progress_map.erase(user_name);
     }
   catch (...) {}
   
   pthread_mutex_unlock(&this->lock);
   }
+
+
+
+/*
+ * update_progress()
+ *
+ * Records how far along the current delete all for this user is
+ * @param handled - the jobs processed so far
+ * @param total - the jobs selected for deletion
+ */
+
+void delete_all_tracker::update_progress(
+
+  const char *user,
+  int         perm,
+  int         handled,
+  int         total)
+
+  {
+  std::string user_name;
+
+  if (is_manager(perm))
+    user_name = mgr;
+  else
+    user_name = user;
+
+  pthread_mutex_lock(&this->lock);
+
+  try
+    {
+    this->progress_map[user_name] = std::pair<int, int>(handled, total);
+    }
+  catch (...) {}
+
+  pthread_mutex_unlock(&this->lock);
+  } /* END update_progress() */
+
+
+
+/*
+ * get_progress()
+ *
+ * @return true and the progress of this user's delete all if one is running
+ */
+
+bool delete_all_tracker::get_progress(
+
+  const char *user,
+  int         perm,
+  int        &handled,
+  int        &total)
+
+  {
+  std::string user_name;
+  bool        found = false;
+
+  if (is_manager(perm))
+    user_name = mgr;
+  else
+    user_name = user;
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, std::pair<int, int> >::iterator it = this->progress_map.find(user_name);
+
+  if (it != this->progress_map.end())
+    {
+    handled = it->second.first;
+    total = it->second.second;
+    found = true;
+    }
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(found);
+  } /* END get_progress() */
@@ -0,0 +1,355 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include <string.h>
+#include <stdio.h>
+
+#include "dependency_graph.hpp"
+
+
+
+dependency_graph::dependency_graph() : dependents(), unsatisfied(), edges(0)
+
+  {
+  pthread_mutex_init(&this->lock, NULL);
+  }
+
+
+
+dependency_graph::~dependency_graph()
+
+  {
+  }
+
+
+
+/*
+ * add_edge()
+ *
+ * Records that child waits on parent
+ * @param parent - the job being waited on
+ * @param child - the waiting job
+ * @param type - the child's JOB_DEPEND_TYPE_AFTER* type
+ * @return true if the edge is new
+ */
+
+bool dependency_graph::add_edge(
+
+  const char *parent,
+  const char *child,
+  int         type)
+
+  {
+  bool added = false;
+
+  if ((parent == NULL) ||
+      (child == NULL))
+    return(false);
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, int> &out = this->dependents[parent];
+
+  if (out.find(child) == out.end())
+    {
+    out[child] = type;
+    this->unsatisfied[child]++;
+    this->edges++;
+    added = true;
+    }
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(added);
+  } /* END add_edge() */
+
+
+
+/*
+ * remove_edge()
+ *
+ * Drops the edge from parent to child, counting it as no longer unsatisfied
+ * @return true if the edge was there
+ */
+
+bool dependency_graph::remove_edge(
+
+  const char *parent,
+  const char *child)
+
+  {
+  return(this->satisfy_edge(parent, child) >= 0);
+  } /* END remove_edge() */
+
+
+
+bool dependency_graph::has_edge(
+
+  const char *parent,
+  const char *child)
+
+  {
+  bool found = false;
+
+  if ((parent == NULL) ||
+      (child == NULL))
+    return(false);
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, std::map<std::string, int> >::iterator it = this->dependents.find(parent);
+
+  if (it != this->dependents.end())
+    found = it->second.find(child) != it->second.end();
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(found);
+  } /* END has_edge() */
+
+
+
+/*
+ * satisfy_edge()
+ *
+ * Removes the edge from parent to child because parent released child
+ * @return the number of edges child still waits on, or -1 if the edge wasn't indexed
+ */
+
+int dependency_graph::satisfy_edge(
+
+  const char *parent,
+  const char *child)
+
+  {
+  int left = -1;
+
+  if ((parent == NULL) ||
+      (child == NULL))
+    return(-1);
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, std::map<std::string, int> >::iterator it = this->dependents.find(parent);
+
+  if ((it != this->dependents.end()) &&
+      (it->second.erase(child) > 0))
+    {
+    if (it->second.size() == 0)
+      this->dependents.erase(it);
+
+    this->edges--;
+
+    std::map<std::string, int>::iterator count = this->unsatisfied.find(child);
+
+    if (count != this->unsatisfied.end())
+      {
+      left = --count->second;
+
+      if (left <= 0)
+        {
+        this->unsatisfied.erase(count);
+        left = 0;
+        }
+      }
+    else
+      left = 0;
+    }
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(left);
+  } /* END satisfy_edge() */
+
+
+
+/*
+ * get_unsatisfied()
+ *
+ * @return the number of indexed edges job_id still waits on
+ */
+
+int dependency_graph::get_unsatisfied(
+
+  const char *job_id)
+
+  {
+  int count = 0;
+
+  if (job_id == NULL)
+    return(0);
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, int>::iterator it = this->unsatisfied.find(job_id);
+
+  if (it != this->unsatisfied.end())
+    count = it->second;
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(count);
+  } /* END get_unsatisfied() */
+
+
+
+/*
+ * get_dependents()
+ *
+ * Copies out the jobs waiting on parent
+ */
+
+void dependency_graph::get_dependents(
+
+  const char                   *parent,
+  std::vector<dependency_edge> &out)
+
+  {
+  out.clear();
+
+  if (parent == NULL)
+    return;
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, std::map<std::string, int> >::iterator it = this->dependents.find(parent);
+
+  if (it != this->dependents.end())
+    {
+    out.reserve(it->second.size());
+
+    for (std::map<std::string, int>::iterator e = it->second.begin(); e != it->second.end(); e++)
+      {
+      dependency_edge edge;
+
+      edge.de_job = e->first;
+      edge.de_type = e->second;
+      out.push_back(edge);
+      }
+    }
+
+  pthread_mutex_unlock(&this->lock);
+  } /* END get_dependents() */
+
+
+
+/*
+ * remove_job()
+ *
+ * Forgets a purged job. Jobs still waiting on it keep their counts, since
+ * their depend attribute still holds them.
+ */
+
+void dependency_graph::remove_job(
+
+  const char *job_id)
+
+  {
+  if (job_id == NULL)
+    return;
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, std::map<std::string, int> >::iterator it = this->dependents.find(job_id);
+
+  if (it != this->dependents.end())
+    {
+    this->edges -= it->second.size();
+    this->dependents.erase(it);
+    }
+
+  this->unsatisfied.erase(job_id);
+
+  pthread_mutex_unlock(&this->lock);
+  } /* END remove_job() */
+
+
+
+unsigned long dependency_graph::edge_count()
+
+  {
+  unsigned long count;
+
+  pthread_mutex_lock(&this->lock);
+  count = this->edges;
+  pthread_mutex_unlock(&this->lock);
+
+  return(count);
+  } /* END edge_count() */
+
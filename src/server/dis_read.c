@@ -207,6 +207,22 @@ int dis_request_read(
 
       break;
 
+    case PBS_BATCH_SubmitJob:
+
+      CLEAR_HEAD(request->rq_ind.rq_submitjob.rq_job.rq_attr);
+
+      rc = decode_DIS_SubmitJob(chan, request);
+
+      break;
+
+    case PBS_BATCH_SubmitJobs:
+
+      CLEAR_HEAD(request->rq_ind.rq_submitjobs.rq_template.rq_job.rq_attr);
+
+      rc = decode_DIS_SubmitJobs(chan, request);
+
+      break;
+
     case PBS_BATCH_JobCred:
 
       rc = decode_DIS_JobCred(chan, request);
@@ -384,6 +400,12 @@ int dis_request_read(
 
       break;
 
+    case PBS_BATCH_JobObitBatch:
+
+      rc = decode_DIS_JobObitBatch(chan, request);
+
+      break;
+
 #else  /* PBS_MOM */
       
     /* pbs_mom services */
@@ -31,12 +31,28 @@ execution_slot_tracker::execution_slot_tracker(
 
   {
   this->open_count = 0;
-  
-  for (int i = 0; i < size; i++)
-    this->add_execution_slot();
+  this->grow_to(size);
   }
 
 
+
+/*
+ * grow_to()
+ * adds free slots until there are size slots
+ */
+void execution_slot_tracker::grow_to(
+
+  int size)
+
+  {
+  if (size > this->slots.size())
+    {
+    this->open_count += size - this->slots.size();
+    this->slots.resize(size);
+    }
+  } /* END grow_to() */
+
+
 execution_slot_tracker& execution_slot_tracker::operator= (
 	
   const execution_slot_tracker& est)
@@ -65,11 +81,8 @@ int execution_slot_tracker::unset_subset(
   if (subset.get_total_execution_slots() > this->get_total_execution_slots())
     return(SUBSET_TOO_LARGE);
 
-  for (int i = 0; i < subset.get_total_execution_slots(); i++)
-    {
-    if (subset.slots[i] == OCCUPIED)
-      this->mark_as_free(i);
-    }
+  this->slots.subtract(subset.slots);
+  this->open_count = this->slots.size() - this->slots.count();
 
   return(PBSE_NONE);
   }
@@ -94,20 +107,13 @@ int execution_slot_tracker::mark_as_used (
       (index >= size))
     return(OUT_OF_RANGE);
 
-  try 
+  if (this->slots.test(index) == FREE)
     {
-    if (this->slots[index] == FREE)
-      {
-      this->slots[index] = OCCUPIED;
-      this->open_count--;
-      }
-
-    return(PBSE_NONE);
-    }
-  catch (std::out_of_range &oor)
-    {
-    return(OUT_OF_RANGE);
+    this->slots.set(index);
+    this->open_count--;
     }
+
+  return(PBSE_NONE);
   }
 
 
@@ -130,20 +136,13 @@ int execution_slot_tracker::mark_as_free (
       (index >= size))
     return(OUT_OF_RANGE);
   
-  try
+  if (this->slots.test(index) == OCCUPIED)
     {
-    if (this->slots[index] == OCCUPIED)
-      {
-      this->slots[index] = FREE;
-      this->open_count++;
-      }
-
-    return(PBSE_NONE);
-    }
-  catch (std::out_of_range &oor)
-    {
-    return(OUT_OF_RANGE);
+    this->slots.reset(index);
+    this->open_count++;
     }
+
+  return(PBSE_NONE);
   }
   
 
@@ -156,8 +155,7 @@ int execution_slot_tracker::reserve_execution_slot(
   {
   int rc;
  
-  while (subset.get_total_execution_slots() < this->get_total_execution_slots())
-    subset.add_execution_slot();
+  subset.grow_to(this->get_total_execution_slots());
 
   if ((rc = this->mark_as_used(index)) == PBSE_NONE)
     {
@@ -195,18 +193,17 @@ int execution_slot_tracker::reserve_execution_slots(
   if (this->open_count < num_slots_to_reserve)
     return(INSUFFICIENT_FREE_EXECUTION_SLOTS);
 
-  while (est.get_total_execution_slots() < this->get_total_execution_slots())
-    est.add_execution_slot();
+  est.grow_to(this->get_total_execution_slots());
 
-  for (int i = 0; i < this->slots.size() && reserved_so_far < num_slots_to_reserve; i++)
+  /* skip over the occupied slots a word at a time */
+  for (int i = this->slots.find_next_clear(0);
+       (i != -1) && (reserved_so_far < num_slots_to_reserve);
+       i = this->slots.find_next_clear(i + 1))
     {
-    if (this->slots[i] == FREE)
-      {
-      reserved_so_far++;
-      this->mark_as_used(i);
+    reserved_so_far++;
+    this->mark_as_used(i);
 
-      est.mark_as_used(i);
-      }
+    est.mark_as_used(i);
     }
 
   return(PBSE_NONE);
@@ -229,11 +226,8 @@ int execution_slot_tracker::unreserve_execution_slots(
   if (this->slots.size() < subset.slots.size())
     return(SUBSET_TOO_LARGE);
 
-  for (int i = 0; i < subset.slots.size(); i++)
-    {
-    if (subset.slots[i] == OCCUPIED)
-      this->mark_as_free(i);
-    }
+  this->slots.subtract(subset.slots);
+  this->open_count = this->slots.size() - this->slots.count();
 
   return(PBSE_NONE);
   }
@@ -265,19 +259,15 @@ void execution_slot_tracker::add_execution_slot ()
 
 int execution_slot_tracker::remove_execution_slot ()
   {
-  try
-    {
-    if (this->slots[this->slots.size() - 1] == FREE)
-      this->open_count--;
+  if (this->slots.size() == 0)
+    return(-4);
 
-    this->slots.pop_back();
+  if (this->slots.test(this->slots.size() - 1) == FREE)
+    this->open_count--;
 
-    return(PBSE_NONE);
-    }
-  catch (...)
-    {
-    return(-4);
-    }
+  this->slots.pop_back();
+
+  return(PBSE_NONE);
   }
 
 
@@ -297,17 +287,15 @@ int execution_slot_tracker::get_next_occupied_index(
   if (iterator == -1)
     iterator = 0;
 
-  while (iterator < this->slots.size())
+  occupied_index = this->slots.find_next_set(iterator);
+
+  if (occupied_index == -1)
     {
-    if (this->slots[iterator] == OCCUPIED)
-      {
-      occupied_index = iterator;
-      iterator++;
-      break;
-      }
-    else
-      iterator++;
+    if (iterator < this->slots.size())
+      iterator = this->slots.size();
     }
+  else
+    iterator = occupied_index + 1;
 
   return(occupied_index);
   }
@@ -317,21 +305,5 @@ bool execution_slot_tracker::is_occupied(
   int index) const
 
   {
-  int  size = this->slots.size();
-  bool occupied = false;
-
-  if ((index < 0) ||
-      (index >= size))
-    return(false);
-  
-  try
-    {
-    occupied = this->slots[index] == OCCUPIED;
-    }
-  catch (std::out_of_range &oor)
-    {
-    return(false);
-    }
-
-  return(occupied);
+  return(this->slots.test(index) == OCCUPIED);
   }
@@ -23,6 +23,208 @@ const int DEFAULT_IDLE_SLOT_LIMIT = 300;
 
 
 
+/*
+ * parse()
+ *
+ * Reads a range string such as "0-99,200,300-399" into ranges without expanding it.
+ * Accepts the same syntax as translate_range_string_to_vector().
+ *
+ * @param range_string - the string specifying the indices
+ * @return PBSE_NONE on success, -1 if the string is malformed or names no indices
+ */
+
+int index_ranges::parse(
+
+  const char *range_string)
+
+  {
+  const char *ptr = range_string;
+  int         rc = PBSE_NONE;
+
+  this->clear();
+
+  while (is_whitespace(*ptr))
+    ptr++;
+
+  while (*ptr != '\0')
+    {
+    char *end;
+    int   first = strtol(ptr, &end, 10);
+    int   last = first;
+
+    if (end == ptr)
+      {
+      // not numeric, stop before we loop forever
+      rc = -1;
+      break;
+      }
+
+    ptr = end;
+
+    if (*ptr == '-')
+      {
+      ptr++;
+      last = strtol(ptr, &end, 10);
+      ptr = end;
+      }
+
+    if (first <= last)
+      {
+      this->ranges.push_back(std::pair<int, int>(first, last));
+      this->count += last - first + 1;
+      }
+
+    while ((*ptr == ',') ||
+           (is_whitespace(*ptr)))
+      ptr++;
+    }
+
+  if ((rc == PBSE_NONE) &&
+      (this->count == 0))
+    rc = -1;
+
+  return(rc);
+  } /* END parse() */
+
+
+
+void index_ranges::clear()
+
+  {
+  this->ranges.clear();
+  this->head = 0;
+  this->count = 0;
+  } /* END clear() */
+
+
+
+int index_ranges::size() const
+
+  {
+  return(this->count);
+  } /* END size() */
+
+
+
+bool index_ranges::empty() const
+
+  {
+  return(this->count == 0);
+  } /* END empty() */
+
+
+
+/*
+ * front()
+ *
+ * @return the next index to be handed out, or -1 if there are none left
+ */
+
+int index_ranges::front() const
+
+  {
+  if (this->count == 0)
+    return(-1);
+
+  return(this->ranges[this->head].first);
+  } /* END front() */
+
+
+
+void index_ranges::pop_front()
+
+  {
+  if (this->count == 0)
+    return;
+
+  this->count--;
+
+  if (this->ranges[this->head].first == this->ranges[this->head].second)
+    this->head++;
+  else
+    this->ranges[this->head].first++;
+  } /* END pop_front() */
+
+
+
+/*
+ * max_index()
+ *
+ * @return the highest index left, or -1 if there are none
+ */
+
+int index_ranges::max_index() const
+
+  {
+  int highest = -1;
+
+  for (size_t i = this->head; i < this->ranges.size(); i++)
+    {
+    if (this->ranges[i].second > highest)
+      highest = this->ranges[i].second;
+    }
+
+  return(highest);
+  } /* END max_index() */
+
+
+
+/*
+ * remove_through()
+ *
+ * Drops every index less than or equal to index
+ */
+
+void index_ranges::remove_through(
+
+  int index)
+
+  {
+  std::vector<std::pair<int, int> > kept;
+
+  this->count = 0;
+
+  for (size_t i = this->head; i < this->ranges.size(); i++)
+    {
+    std::pair<int, int> r = this->ranges[i];
+
+    if (r.second <= index)
+      continue;
+
+    if (r.first <= index)
+      r.first = index + 1;
+
+    kept.push_back(r);
+    this->count += r.second - r.first + 1;
+    }
+
+  this->ranges.swap(kept);
+  this->head = 0;
+  } /* END remove_through() */
+
+
+
+size_t index_ranges::range_count() const
+
+  {
+  return(this->ranges.size() - this->head);
+  } /* END range_count() */
+
+
+
+void index_ranges::get_range(
+
+  size_t  i,
+  int    &first,
+  int    &last) const
+
+  {
+  first = this->ranges[this->head + i].first;
+  last = this->ranges[this->head + i].second;
+  } /* END get_range() */
+
+
+
 // array_info empty constructor
 array_info::array_info() : struct_version(ARRAY_QS_STRUCT_VERSION), array_size(0), num_jobs(0),
                            slot_limit(NO_SLOT_LIMIT), jobs_running(0), jobs_done(0), num_cloned(0),
@@ -54,7 +256,7 @@ array_info::~array_info()
 
 
 // job_array empty constructor
-job_array::job_array() : job_ids(NULL), jobs_recovered(0), ai_ghost_recovered(false), uncreated_ids(),
+job_array::job_array() : job_ids(), jobs_recovered(0), ai_ghost_recovered(false), uncreated_ids(),
                          ai_mutex(NULL), ai_qs(), being_deleted(false)
 
   {
@@ -70,18 +272,6 @@ job_array::~job_array()
   {
   pthread_mutex_unlock(this->ai_mutex);
   free(this->ai_mutex);
-
-  /* free the memory for the job pointers */
-  if (this->job_ids != NULL)
-    {
-    for (int i = 0; i < this->ai_qs.array_size; i++)
-      {
-      if (this->job_ids[i] != NULL)
-        free(this->job_ids[i]);
-      }
-
-    free(this->job_ids);
-    }
   }
 
 void job_array::set_array_id(
@@ -226,8 +416,7 @@ int job_array::set_idle_slot_limit(
  *
  * @param request - the user submitted array request
  * @return PBSE_NONE on success, or ARRAY_TOO_LARGE if we're above the maximum size, or
- *         PBSE_MEM_MALLOC, or the rc from translate_range_string_to_vector if an invalid range
- *         was submitted.
+ *         PBSE_MEM_MALLOC, or -1 if an invalid range was submitted.
  */
 
 int job_array::parse_array_request(
@@ -237,17 +426,15 @@ int job_array::parse_array_request(
   {
   int  rc = PBSE_NONE;
   long max_array_size;
-  char log_buf[LOCAL_LOG_BUF_SIZE];
-  this->uncreated_ids.clear();
 
-  if ((rc = translate_range_string_to_vector(request, this->uncreated_ids)) != PBSE_NONE)
+  if ((rc = this->uncreated_ids.parse(request)) != PBSE_NONE)
     return(rc);
 
   this->ai_qs.range_str = request;
   this->ai_qs.num_jobs = this->uncreated_ids.size();
 
   // size of array is the biggest index + 1
-  this->ai_qs.array_size = this->uncreated_ids[this->uncreated_ids.size() - 1] + 1;
+  this->ai_qs.array_size = this->uncreated_ids.max_index() + 1;
 
   if (get_svr_attr_l(SRV_ATR_MaxArraySize, &max_array_size) == PBSE_NONE)
     {
@@ -257,15 +444,6 @@ int job_array::parse_array_request(
       }
     }
 
-  /* initialize the array */
-  this->job_ids = (char **)calloc(this->ai_qs.array_size, sizeof(char *));
-  if (this->job_ids == NULL)
-    {
-    sprintf(log_buf, "Failed to alloc job_ids: job %s", this->ai_qs.parent_id);
-    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, __func__, log_buf);
-    return(PBSE_MEM_MALLOC);
-    }
-
   return(rc);
   } /* END parse_array_request() */
 
@@ -284,18 +462,14 @@ bool job_array::need_to_update_slot_limits() const
  *
  * Determines the index of the next subjob that should be created
  *
- * @param internal_index - the index of uncreated_ids that corresponds to the subjob index returned
  * @return the index of the next subjob to be created, or -1 if no job should be created
  * at this time.
  */
 
-int job_array::get_next_index_to_create(
-    
-  int &internal_index)
+int job_array::get_next_index_to_create()
 
   {
   int index = -1;
-  internal_index = -1;
 
   // Don't instantiate new jobs after we've been deleted
   if (this->being_deleted == false)
@@ -303,15 +477,7 @@ int job_array::get_next_index_to_create(
     if ((this->ai_qs.idle_slot_limit == NO_SLOT_LIMIT) ||
         (this->ai_qs.num_idle < this->ai_qs.idle_slot_limit))
       {
-      for (size_t i = 0; i < this->uncreated_ids.size(); i++)
-        {
-        if (this->uncreated_ids[i] != -1)
-          {
-          index = this->uncreated_ids[i];
-          internal_index = i;
-          break;
-          }
-        }
+      index = this->uncreated_ids.front();
       }
     }
 
@@ -329,8 +495,7 @@ int job_array::get_next_index_to_create(
 void job_array::create_job_if_needed()
 
   {
-  int  uncreated_ids_index;
-  int  next_index = this->get_next_index_to_create(uncreated_ids_index);
+  int  next_index = this->get_next_index_to_create();
 
   if (next_index >= 0)
     {
@@ -366,7 +531,10 @@ void job_array::create_job_if_needed()
 
       if (rc == PBSE_NONE)
         {
-        this->uncreated_ids[uncreated_ids_index] = -1;
+        // the array may have been unlocked while the job was queued
+        if (this->uncreated_ids.front() == next_index)
+          this->uncreated_ids.pop_front();
+
         this->ai_qs.highest_id_created = next_index;
         }
       }
@@ -468,18 +636,14 @@ void job_array::update_array_values(
           job *pj;
 
           /* find the first held job and release its hold */
-          for (i = 0; i < this->ai_qs.array_size; i++)
+          for (i = this->next_job_index(-1); i >= 0; i = this->next_job_index(i))
             {
-            if (this->job_ids[i] == NULL)
-              continue;
-
-            if (!strcmp(this->job_ids[i], job_id))
+            if (!strcmp(this->get_job_id(i), job_id))
               continue;
 
-            if ((pj = svr_find_job(this->job_ids[i], TRUE)) == NULL)
+            if ((pj = svr_find_job(this->get_job_id(i), TRUE)) == NULL)
               {
-              free(this->job_ids[i]);
-              this->job_ids[i] = NULL;
+              this->remove_job_id(i);
               }
             else
               {
@@ -544,16 +708,8 @@ void job_array::update_array_values(
 void job_array::initialize_uncreated_ids()
 
   {
-  std::vector<int> temp;
-  translate_range_string_to_vector(this->ai_qs.range_str.c_str(), temp);
-
-  this->uncreated_ids.clear();
-
-  for (size_t i = 0; i < temp.size(); i++)
-    {
-    if (temp[i] > this->ai_qs.highest_id_created)
-      this->uncreated_ids.push_back(temp[i]);
-    }
+  this->uncreated_ids.parse(this->ai_qs.range_str.c_str());
+  this->uncreated_ids.remove_through(this->ai_qs.highest_id_created);
   }
 
 
@@ -149,6 +149,7 @@
 #include "job_route.h" /* job_route */
 #include "id_map.hpp"
 #include "completed_jobs_map.h"
+#include "dependency_graph.hpp"
 #include "utils.h"
 
 #ifndef TRUE
@@ -1104,7 +1105,7 @@ job *job_clone(
       }
     }
 
-  pa->job_ids[taskid] = strdup(pnewjob->ji_qs.ji_jobid);
+  pa->set_job_id(taskid, pnewjob->ji_qs.ji_jobid);
   strcpy(pnewjob->ji_arraystructid, pa->ai_qs.parent_id);
 
   pnewjob->ji_internal_id = job_mapper.get_new_id(pnewjob->ji_qs.ji_jobid);
@@ -1267,17 +1268,13 @@ int perform_array_postprocessing(
   pbs_queue *pque;
 
   /* scan over all the jobs in the array and unset the hold */
-  for (int i = 0; i < pa->ai_qs.array_size; i++)
+  for (int i = pa->next_job_index(-1); i >= 0; i = pa->next_job_index(i))
     {
-    if (pa->job_ids[i] == NULL)
-      continue;
-    
-    job *pjob = svr_find_job(pa->job_ids[i], TRUE);
+    job *pjob = svr_find_job(pa->get_job_id(i), TRUE);
 
     if (pjob == NULL)
       {
-      free(pa->job_ids[i]);
-      pa->job_ids[i] = NULL;
+      pa->remove_job_id(i);
       }
     else
       {
@@ -1420,18 +1417,15 @@ void *job_clone_wt(
 
   template_job_mgr.unlock();
 
-  for (size_t i = 0; i < pa->uncreated_ids.size(); i++)
+  while (pa->uncreated_ids.empty() == false)
     {
-    if (pa->uncreated_ids[i] == -1)
-      continue;
-
-    int index = pa->uncreated_ids[i];
-    pa->uncreated_ids[i] = -1;
+    int index = pa->uncreated_ids.front();
+    pa->uncreated_ids.pop_front();
     pa->ai_qs.highest_id_created = index;
 
     /* This job already exists. This can happen when trying to recover a job
      * array that wasn't fully cloned. */
-    if (pa->job_ids[index] != NULL)
+    if (pa->get_job_id(index) != NULL)
       continue;
 
     rc = create_and_queue_array_subjob(pa, array_mgr, template_job, template_job_mgr, index,
@@ -1446,7 +1440,7 @@ void *job_clone_wt(
     if ((pa->ai_qs.idle_slot_limit != NO_SLOT_LIMIT) &&
         (pa->ai_qs.idle_slot_limit <= pa->ai_qs.num_idle))
       break;
-    }  /* END for (i) */
+    }  /* END while (uncreated_ids) */
 
   array_save(pa);
 
@@ -1892,6 +1886,8 @@ int svr_job_purge(
   if (LOGLEVEL >= 10)
     log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, __func__, pjob->ji_qs.ji_jobid);
 
+  depend_graph.remove_job(job_id);
+
   /* check to see if we are keeping a log of all jobs completed */
   get_svr_attr_b(SRV_ATR_RecordJobInfo, &record_job_info);
   if (record_job_info)
@@ -1939,11 +1935,7 @@ int svr_job_purge(
       {
       if (pa != NULL)
         {
-        if (pa->job_ids != NULL)
-          {
-          free(pa->job_ids[pjob->ji_wattr[JOB_ATR_job_array_id].at_val.at_long]);
-          pa->job_ids[pjob->ji_wattr[JOB_ATR_job_array_id].at_val.at_long] = NULL;
-          }
+        pa->remove_job_id(pjob->ji_wattr[JOB_ATR_job_array_id].at_val.at_long);
         
         /* if there are no more jobs in the array,
          * then we can clean that up too */
@@ -0,0 +1,606 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+
+#include "pbs_error.h"
+#include "job_history.hpp"
+
+
+
+/*
+ * history_day()
+ *
+ * @return the YYYYMMDD local date of when, which names its history file
+ */
+
+int history_day(
+
+  time_t when)
+
+  {
+  struct tm tm;
+
+  if (localtime_r(&when, &tm) == NULL)
+    return(0);
+
+  return((tm.tm_year + 1900) * 10000 + (tm.tm_mon + 1) * 100 + tm.tm_mday);
+  } /* END history_day() */
+
+
+
+job_history::job_history() : directory(), day_fds(), by_id(), by_user(), by_time()
+
+  {
+  pthread_mutex_init(&this->lock, NULL);
+  }
+
+
+
+job_history::~job_history()
+
+  {
+  this->close_unlocked();
+  }
+
+
+
+/*
+ * day_fd()
+ *
+ * @return the open descriptor of the file for day, opening it if needed,
+ * or -1. The caller holds the lock.
+ */
+
+int job_history::day_fd(
+
+  int day)
+
+  {
+  std::map<int, int>::iterator it = this->day_fds.find(day);
+  char                         path[MAXPATHLEN + 1];
+  int                          fd;
+
+  if (it != this->day_fds.end())
+    return(it->second);
+
+  snprintf(path, sizeof(path), "%s/%08d", this->directory.c_str(), day);
+
+  if ((fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0600)) >= 0)
+    this->day_fds[day] = fd;
+
+  return(fd);
+  } /* END day_fd() */
+
+
+
+/*
+ * index_record()
+ *
+ * Adds a record to the id, user and time indexes. A job id seen again,
+ * for example after the ids wrapped, now refers to the newer record.
+ * The caller holds the lock.
+ */
+
+void job_history::index_record(
+
+  const std::string      &job_id,
+  const history_location &loc)
+
+  {
+  std::map<std::string, history_location>::iterator it = this->by_id.find(job_id);
+
+  if (it != this->by_id.end())
+    {
+    this->by_user[it->second.hl_user].erase(std::pair<time_t, std::string>(it->second.hl_end, job_id));
+    this->by_time.erase(std::pair<time_t, std::string>(it->second.hl_end, job_id));
+    }
+
+  this->by_id[job_id] = loc;
+  this->by_user[loc.hl_user].insert(std::pair<time_t, std::string>(loc.hl_end, job_id));
+  this->by_time.insert(std::pair<time_t, std::string>(loc.hl_end, job_id));
+  } /* END index_record() */
+
+
+
+/*
+ * load_day()
+ *
+ * Indexes every record in the file for day. A torn record at the end,
+ * left by a crash during a write, is cut off.
+ * @return the number of records indexed, or -1 if the file can't be read
+ */
+
+int job_history::load_day(
+
+  int day)
+
+  {
+  int         fd = this->day_fd(day);
+  struct stat st;
+  size_t      pos = 0;
+  int         loaded = 0;
+
+  if ((fd < 0) ||
+      (fstat(fd, &st) != 0))
+    return(-1);
+
+  while (pos + sizeof(completed_record_header) <= (size_t)st.st_size)
+    {
+    completed_record_header hdr;
+    std::string             data;
+    std::string             job_id;
+    completed_job_info      info;
+    history_location        loc;
+
+    if ((pread(fd, &hdr, sizeof(hdr), pos) != (ssize_t)sizeof(hdr)) ||
+        (hdr.cr_magic != COMPLETED_STORE_MAGIC) ||
+        (hdr.cr_length < sizeof(hdr)) ||
+        (hdr.cr_length > st.st_size - pos))
+      break;
+
+    data.resize(hdr.cr_length);
+
+    if ((pread(fd, &data[0], hdr.cr_length, pos) != (ssize_t)hdr.cr_length) ||
+        (decode_completed_record(data.c_str(), data.size(), job_id, info, NULL) == false))
+      break;
+
+    loc.hl_day = day;
+    loc.hl_offset = pos;
+    loc.hl_length = hdr.cr_length;
+    loc.hl_end = info.ci_mod_time;
+    loc.hl_user = info.ci_owner.substr(0, info.ci_owner.find('@'));
+    loc.hl_queue = info.ci_queue;
+
+    this->index_record(job_id, loc);
+
+    pos += hdr.cr_length;
+    loaded++;
+    }
+
+  if (pos < (size_t)st.st_size)
+    {
+    if (ftruncate(fd, pos) != 0)
+      return(-1);
+    }
+
+  return(loaded);
+  } /* END load_day() */
+
+
+
+/*
+ * close_unlocked()
+ *
+ * Closes every day file and forgets the indexes. The caller holds the lock.
+ */
+
+void job_history::close_unlocked()
+
+  {
+  for (std::map<int, int>::iterator it = this->day_fds.begin(); it != this->day_fds.end(); it++)
+    close(it->second);
+
+  this->day_fds.clear();
+  this->by_id.clear();
+  this->by_user.clear();
+  this->by_time.clear();
+  this->directory.clear();
+  } /* END close_unlocked() */
+
+
+
+/*
+ * open_history()
+ *
+ * Starts recording into dir, creating it if needed, and indexes the
+ * records already there
+ * @return PBSE_NONE on success, PBSE_SYSTEM if dir can't be used
+ */
+
+int job_history::open_history(
+
+  const char *dir)
+
+  {
+  DIR           *dp;
+  struct dirent *de;
+
+  if ((dir == NULL) ||
+      (*dir == '\0'))
+    return(PBSE_BAD_PARAMETER);
+
+  pthread_mutex_lock(&this->lock);
+
+  this->close_unlocked();
+
+  if ((mkdir(dir, 0750) != 0) &&
+      (errno != EEXIST))
+    {
+    pthread_mutex_unlock(&this->lock);
+    return(PBSE_SYSTEM);
+    }
+
+  if ((dp = opendir(dir)) == NULL)
+    {
+    pthread_mutex_unlock(&this->lock);
+    return(PBSE_SYSTEM);
+    }
+
+  this->directory = dir;
+
+  while ((de = readdir(dp)) != NULL)
+    {
+    int i;
+
+    for (i = 0; isdigit(de->d_name[i]); i++);
+
+    if ((i == 8) &&
+        (de->d_name[i] == '\0'))
+      this->load_day(atoi(de->d_name));
+    }
+
+  closedir(dp);
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(PBSE_NONE);
+  } /* END open_history() */
+
+
+
+void job_history::close_history()
+
+  {
+  pthread_mutex_lock(&this->lock);
+  this->close_unlocked();
+  pthread_mutex_unlock(&this->lock);
+  } /* END close_history() */
+
+
+
+bool job_history::is_open()
+
+  {
+  bool open;
+
+  pthread_mutex_lock(&this->lock);
+  open = this->directory.size() != 0;
+  pthread_mutex_unlock(&this->lock);
+
+  return(open);
+  } /* END is_open() */
+
+
+
+/*
+ * add_job()
+ *
+ * Appends a finished job to the file for the day in info.ci_mod_time
+ * @return PBSE_NONE on success
+ */
+
+int job_history::add_job(
+
+  const char                            *job_id,
+  const completed_job_info              &info,
+  const std::vector<completed_job_attr> &attrs)
+
+  {
+  std::string      data;
+  history_location loc;
+  int              fd;
+  off_t            offset;
+  int              rc;
+
+  if ((rc = encode_completed_record(job_id, info, attrs, data)) != PBSE_NONE)
+    return(rc);
+
+  loc.hl_day = history_day(info.ci_mod_time);
+  loc.hl_length = data.size();
+  loc.hl_end = info.ci_mod_time;
+  loc.hl_user = info.ci_owner.substr(0, info.ci_owner.find('@'));
+  loc.hl_queue = info.ci_queue;
+
+  pthread_mutex_lock(&this->lock);
+
+  if ((this->directory.size() == 0) ||
+      ((fd = this->day_fd(loc.hl_day)) < 0) ||
+      ((offset = lseek(fd, 0, SEEK_END)) < 0))
+    {
+    pthread_mutex_unlock(&this->lock);
+    return(PBSE_SYSTEM);
+    }
+
+  if (write(fd, data.c_str(), data.size()) != (ssize_t)data.size())
+    {
+    /* don't leave a torn record for the next one to follow */
+    while ((ftruncate(fd, offset) != 0) &&
+           (errno == EINTR));
+
+    pthread_mutex_unlock(&this->lock);
+    return(PBSE_SYSTEM);
+    }
+
+  loc.hl_offset = offset;
+  this->index_record(job_id, loc);
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(PBSE_NONE);
+  } /* END add_job() */
+
+
+
+bool job_history::has_job(
+
+  const char *job_id)
+
+  {
+  bool found;
+
+  if (job_id == NULL)
+    return(false);
+
+  pthread_mutex_lock(&this->lock);
+  found = this->by_id.find(job_id) != this->by_id.end();
+  pthread_mutex_unlock(&this->lock);
+
+  return(found);
+  } /* END has_job() */
+
+
+
+/*
+ * get_job()
+ *
+ * Reads the history record of a job
+ * @return true if the job is in the history
+ */
+
+bool job_history::get_job(
+
+  const char                      *job_id,
+  completed_job_info              &info,
+  std::vector<completed_job_attr> &attrs)
+
+  {
+  bool        found = false;
+  std::string data;
+  std::string stored_id;
+  int         fd;
+
+  if (job_id == NULL)
+    return(false);
+
+  pthread_mutex_lock(&this->lock);
+
+  std::map<std::string, history_location>::iterator it = this->by_id.find(job_id);
+
+  if ((it != this->by_id.end()) &&
+      ((fd = this->day_fd(it->second.hl_day)) >= 0))
+    {
+    data.resize(it->second.hl_length);
+
+    if (pread(fd, &data[0], data.size(), it->second.hl_offset) == (ssize_t)data.size())
+      found = decode_completed_record(data.c_str(), data.size(), stored_id, info, &attrs);
+    }
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(found);
+  } /* END get_job() */
+
+
+
+/*
+ * find_jobs()
+ *
+ * Lists the jobs that finished between since and until, oldest first
+ * @param user - only jobs owned by this user, or all users if NULL
+ * @param queue - only jobs from this queue, or all queues if NULL
+ * @param until - the latest completion time, or 0 for no limit
+ * @param ids - the matching job ids are appended here
+ */
+
+void job_history::find_jobs(
+
+  const char               *user,
+  const char               *queue,
+  time_t                    since,
+  time_t                    until,
+  std::vector<std::string> &ids)
+
+  {
+  std::set<std::pair<time_t, std::string> >           *range = &this->by_time;
+  std::set<std::pair<time_t, std::string> >::iterator  it;
+
+  pthread_mutex_lock(&this->lock);
+
+  if (user != NULL)
+    {
+    std::map<std::string, std::set<std::pair<time_t, std::string> > >::iterator uit = this->by_user.find(user);
+
+    if (uit == this->by_user.end())
+      {
+      pthread_mutex_unlock(&this->lock);
+      return;
+      }
+
+    range = &uit->second;
+    }
+
+  for (it = range->lower_bound(std::pair<time_t, std::string>(since, ""));
+       it != range->end();
+       it++)
+    {
+    if ((until != 0) &&
+        (it->first > until))
+      break;
+
+    if ((queue != NULL) &&
+        (this->by_id[it->second].hl_queue != queue))
+      continue;
+
+    ids.push_back(it->second);
+    }
+
+  pthread_mutex_unlock(&this->lock);
+  } /* END find_jobs() */
+
+
+
+/*
+ * expire()
+ *
+ * Removes the days that are more than keep_days old
+ * @param keep_days - days to keep, or <= 0 to keep everything
+ * @return the number of records removed
+ */
+
+int job_history::expire(
+
+  time_t now,
+  long   keep_days)
+
+  {
+  int  removed = 0;
+  int  oldest_day;
+  char path[MAXPATHLEN + 1];
+
+  if (keep_days <= 0)
+    return(0);
+
+  oldest_day = history_day(now - keep_days * 24 * 60 * 60);
+
+  pthread_mutex_lock(&this->lock);
+
+  while ((this->by_time.size() != 0) &&
+         (this->by_id[this->by_time.begin()->second].hl_day < oldest_day))
+    {
+    std::string                                        job_id(this->by_time.begin()->second);
+    std::map<std::string, history_location>::iterator  it = this->by_id.find(job_id);
+
+    this->by_user[it->second.hl_user].erase(std::pair<time_t, std::string>(it->second.hl_end, job_id));
+
+    if (this->by_user[it->second.hl_user].size() == 0)
+      this->by_user.erase(it->second.hl_user);
+
+    this->by_time.erase(this->by_time.begin());
+    this->by_id.erase(it);
+    removed++;
+    }
+
+  while ((this->day_fds.size() != 0) &&
+         (this->day_fds.begin()->first < oldest_day))
+    {
+    snprintf(path, sizeof(path), "%s/%08d", this->directory.c_str(), this->day_fds.begin()->first);
+    close(this->day_fds.begin()->second);
+    unlink(path);
+    this->day_fds.erase(this->day_fds.begin());
+    }
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(removed);
+  } /* END expire() */
+
+
+
+size_t job_history::count()
+
+  {
+  size_t c;
+
+  pthread_mutex_lock(&this->lock);
+  c = this->by_id.size();
+  pthread_mutex_unlock(&this->lock);
+
+  return(c);
+  } /* END count() */
+
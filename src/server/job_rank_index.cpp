@@ -0,0 +1,202 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include "job_rank_index.hpp"
+
+
+
+job_rank_index::job_rank_index() : by_rank(), by_id()
+
+  {
+  }
+
+
+
+/*
+ * insert()
+ *
+ * Adds a job at the place svr_enquejob() links it into the list: after every
+ * job of lower rank and before any job of the same or higher rank.
+ * @param job_id - the job being added
+ * @param rank - the job's queue rank
+ * @return true if the job wasn't indexed yet
+ */
+
+bool job_rank_index::insert(
+
+  const std::string &job_id,
+  long               rank)
+
+  {
+  std::multimap<long, std::string>::iterator it;
+
+  if (this->by_id.find(job_id) != this->by_id.end())
+    return(false);
+
+  /* the hint places the job in front of any job with the same rank */
+  it = this->by_rank.insert(this->by_rank.lower_bound(rank), std::make_pair(rank, job_id));
+  this->by_id[job_id] = it;
+
+  return(true);
+  } /* END insert() */
+
+
+
+/*
+ * remove()
+ *
+ * @param job_id - the job to drop from the index
+ * @return true if the job was indexed
+ */
+
+bool job_rank_index::remove(
+
+  const std::string &job_id)
+
+  {
+  std::map<std::string, std::multimap<long, std::string>::iterator>::iterator it;
+
+  if ((it = this->by_id.find(job_id)) == this->by_id.end())
+    return(false);
+
+  this->by_rank.erase(it->second);
+  this->by_id.erase(it);
+
+  return(true);
+  } /* END remove() */
+
+
+
+/*
+ * change_rank()
+ *
+ * Moves an indexed job to a new rank, as when qorder swaps two jobs' ranks
+ * @param job_id - the job whose rank changed
+ * @param rank - the job's new queue rank
+ * @return true if the job was indexed
+ */
+
+bool job_rank_index::change_rank(
+
+  const std::string &job_id,
+  long               rank)
+
+  {
+  if (this->remove(job_id) == false)
+    return(false);
+
+  return(this->insert(job_id, rank));
+  } /* END change_rank() */
+
+
+
+/*
+ * find_preceding()
+ *
+ * Finds the job a job of the given rank is linked after: the last job whose
+ * rank is lower.
+ * @param rank - the rank of the job being placed
+ * @param job_id - set to the preceding job's id when there is one
+ * @return false if the job belongs at the front of the list
+ */
+
+bool job_rank_index::find_preceding(
+
+  long         rank,
+  std::string &job_id) const
+
+  {
+  std::multimap<long, std::string>::const_iterator it = this->by_rank.lower_bound(rank);
+
+  if (it == this->by_rank.begin())
+    return(false);
+
+  job_id = (--it)->second;
+
+  return(true);
+  } /* END find_preceding() */
+
+
+
+size_t job_rank_index::count() const
+
+  {
+  return(this->by_id.size());
+  } /* END count() */
+
@@ -1353,8 +1353,7 @@ job_array *ghost_create_jobs_array(
   if (pjob->ji_wattr[JOB_ATR_job_array_id].at_val.at_long > array_size)
     array_size = pjob->ji_wattr[JOB_ATR_job_array_id].at_val.at_long + 1;
 
-  pa->job_ids = (char **)calloc(array_size, sizeof(char *));
-  pa->job_ids[(int)pjob->ji_wattr[JOB_ATR_job_array_id].at_val.at_long] = strdup(pjob->ji_qs.ji_jobid);
+  pa->set_job_id(pjob->ji_wattr[JOB_ATR_job_array_id].at_val.at_long, pjob->ji_qs.ji_jobid);
 
   pa->ai_qs.array_size = array_size;
   pa->ai_ghost_recovered = true;
@@ -1369,15 +1368,15 @@ job_array *ghost_create_jobs_array(
 
 
 /*
- * check_and_reallocate_job_ids()
+ * check_and_grow_array_size()
  *
- * Reallocates the job_ids array of pa if necessary to make space for the new job id at index
+ * Grows the array_size of pa if necessary so that index is a valid sub-job index
  *
- * @param pa - the job array that we're checking to make sure has enough space for this job id
- * @param index - the index of the new job id
+ * @param pa - the job array that we're checking to make sure is big enough for this job
+ * @param index - the index of the new job
  */
 
-void check_and_reallocate_job_ids(
+void check_and_grow_array_size(
 
   job_array *pa,
   int        index)
@@ -1390,14 +1389,9 @@ void check_and_reallocate_job_ids(
     while (new_size <= index)
       new_size *= 2;
 
-    char **new_ids = (char **)calloc(new_size, sizeof(char *));
-    memcpy(new_ids, pa->job_ids, (sizeof(char *) * pa->ai_qs.array_size));
-    free(pa->job_ids);
-
-    pa->job_ids = new_ids;
     pa->ai_qs.array_size = new_size;
     }
-  } // END check_and_reallocate_job_ids()
+  } // END check_and_grow_array_size()
 
 
 
@@ -1513,15 +1507,15 @@ int set_array_job_ids(
       }
     else
       {
-      // If the original array wasn't recovered, then we don't know if we have the right size for
-      // job_ids. Check and ensure that it's big enough.
+      // If the original array wasn't recovered, then we don't know if we have the right
+      // array size. Check and ensure that it's big enough.
       if (pa->ai_ghost_recovered)
         {
-        check_and_reallocate_job_ids(pa, pj->ji_wattr[JOB_ATR_job_array_id].at_val.at_long);
+        check_and_grow_array_size(pa, pj->ji_wattr[JOB_ATR_job_array_id].at_val.at_long);
         update_recovered_array_values(pa, pj);
         }
 
-      pa->job_ids[(int)pj->ji_wattr[JOB_ATR_job_array_id].at_val.at_long] = strdup(pj->ji_qs.ji_jobid);
+      pa->set_job_id(pj->ji_wattr[JOB_ATR_job_array_id].at_val.at_long, pj->ji_qs.ji_jobid);
       pa->jobs_recovered++;
 
       /* This is a bit of a kluge, but for some reason if an array job was 
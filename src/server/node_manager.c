@@ -142,6 +142,8 @@
 #include "plugin_internal.h"
 #include "json/json.h"
 #include "authorized_hosts.hpp"
+#include "run_sched.h"
+#include "sched_event_tracker.hpp"
 
 #define IS_VALID_STR(STR)  (((STR) != NULL) && ((STR)[0] != '\0'))
 
@@ -389,6 +391,8 @@ void update_node_state(
 
       np->nd_state |= INUSE_DOWN;
       np->nd_state &= ~INUSE_UNKNOWN;
+
+      notify_scheduler(SCHED_EVENT_NODE_DOWN);
       }
 
     /* ignoring the obvious possibility of a "down,busy" node */
@@ -418,6 +422,10 @@ void update_node_state(
       sprintf(log_buf, "node %s marked free", np->get_name());
       }
 
+    /* new resources are available for scheduling */
+    if (np->nd_state & (INUSE_DOWN | INUSE_BUSY))
+      notify_scheduler(SCHED_EVENT_NODE_UP);
+
     np->nd_state &= ~INUSE_BUSY;
     np->nd_state &= ~INUSE_UNKNOWN;
     np->nd_state &= ~INUSE_DOWN;
@@ -4226,7 +4234,9 @@ int place_subnodes_in_hostlist(
     std::string       cpus;
     std::string       mems;
     bool              legacy_vmem = false;
+    bool              topology_aware = false;
     get_svr_attr_b(SRV_ATR_LegacyVmem, &legacy_vmem);
+    get_svr_attr_b(SRV_ATR_TopologyAwarePlacement, &topology_aware);
 
     // We shouldn't be starting a job if the layout hasn't been set up yet.
     if (pnode->nd_layout.is_initialized() == false)
@@ -4234,6 +4244,7 @@ int place_subnodes_in_hostlist(
 
     update_req_hostlist(pjob, pnode->get_name(), naji.req_index, naji.ppn_needed);
 
+    pnode->nd_layout.set_topology_aware(topology_aware);
     rc = pnode->nd_layout.place_job(pjob, cpus, mems, pnode->get_name(), legacy_vmem);
     if (rc != PBSE_NONE)
       return(rc);
@@ -2033,17 +2033,14 @@ int cleanup_recovered_arrays()
         {
         int        i;
 
-        for (i = 0; i < pa->ai_qs.array_size; i++)
+        for (i = pa->next_job_index(-1); i >= 0; i = pa->next_job_index(i))
           {
-          if (pa->job_ids[i] != NULL)
+          if ((pjob = svr_find_job(pa->get_job_id(i), FALSE)) != NULL)
             {
-            if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) != NULL)
-              {
-              unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
-              svr_job_purge(pjob);
+            unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
+            svr_job_purge(pjob);
 
-              pa = get_array(arrayid);
-              }
+            pa = get_array(arrayid);
             }
           }
 
@@ -147,6 +147,10 @@
 #include "node_func.h"
 #include "mom_hierarchy_handler.h"
 #include "completed_jobs_map.h"
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
+#include "sched_event_tracker.hpp"
+#include "event_trace.h"
 
 
 #define TASK_CHECK_INTERVAL      10
@@ -165,6 +169,7 @@ extern void shutdown_ack();
 extern void tcp_settimeout(long);
 extern int  schedule_jobs(void);
 extern int  notify_listeners(void);
+extern void notify_scheduler(int);
 extern void svr_shutdown(int);
 extern int  svr_startjob(job *, struct batch_request **, char *, char *);
 extern int RPPConfigure(int, int);
@@ -401,6 +406,8 @@ static void need_y_response(
  
 
 completed_jobs_map_class completed_jobs_map;
+completed_job_store completed_store;
+job_history job_hist;
 
 void clear_listeners(void)   /* I */
 
@@ -947,13 +954,7 @@ void *check_tasks(void *notUsed)
   /* should the scheduler be run?  If so, adjust the schedule time  */
   if (server.sv_next_schedule - time_now <= 0)
     {
-    pthread_mutex_lock(svr_do_schedule_mutex);
-    svr_do_schedule = SCH_SCHEDULE_TIME;
-    pthread_mutex_unlock(svr_do_schedule_mutex);
-
-    pthread_mutex_lock(listener_command_mutex);
-    listener_command = SCH_SCHEDULE_TIME;
-    pthread_mutex_unlock(listener_command_mutex);
+    notify_scheduler(SCHED_EVENT_TIMER);
     }
 
   pthread_mutex_unlock(check_tasks_mutex);
@@ -1285,6 +1286,7 @@ void main_loop(void)
   long          log = 0;
   bool          scheduling = false;
   long          sched_iteration = PBS_SCHEDULE_CYCLE;
+  long          sched_min_interval = 0;
   time_t        time_now = time(NULL);
 //  time_t        try_hellos = 0;
   time_t        update_loglevel = 0;
@@ -1296,6 +1298,9 @@ void main_loop(void)
   void check_log(struct work_task *);
   void check_job_log(struct work_task *);
   void check_acct_log(struct work_task *);
+#ifndef NDEBUG
+  void check_queued_job_counts(struct work_task *);
+#endif /* NDEBUG */
 
   server.sv_started = time_now; /* time server started */
 
@@ -1332,6 +1337,10 @@ void main_loop(void)
 
   set_task(WORK_Timed,time_now + 10,check_acct_log, (char *)NULL, FALSE);
 
+#ifndef NDEBUG
+  set_task(WORK_Timed, time_now + PBS_QUEUED_CT_CHECK_RATE, check_queued_job_counts, (char *)NULL, FALSE);
+#endif /* NDEBUG */
+
   /*
    * Now at last, we are ready to do some batch work.  The
    * following section constitutes the "main" loop of the server
@@ -1394,11 +1403,15 @@ void main_loop(void)
       /* if time or event says to run scheduler, do it */
       get_svr_attr_b(SRV_ATR_scheduling, &scheduling);
       get_svr_attr_l(SRV_ATR_scheduler_iteration, &sched_iteration);
+      get_svr_attr_l(SRV_ATR_scheduler_min_interval, &sched_min_interval);
 
       pthread_mutex_lock(svr_do_schedule_mutex);
 
+      /* events are coalesced until at least scheduler_min_interval seconds
+       * have passed since the last cycle, and while a cycle is in progress */
       if ((svr_do_schedule != SCH_SCHEDULE_NULL) &&
-          scheduling)
+          scheduling &&
+          (sched_events.claim_cycle(time_now, sched_min_interval) == true))
         {
         pthread_mutex_unlock(svr_do_schedule_mutex);
 
@@ -1422,6 +1435,10 @@ void main_loop(void)
       LOGLEVEL = log;
       }
 
+    /* don't leave job trace and accounting records sitting in memory while the server is idle */
+    trace_flush();
+    acct_flush();
+
     /* 
      * Can we comment this out? Would anything above change the
      * server state without setting the 'state' variable? 
@@ -1882,6 +1899,10 @@ int main(
   log_open(log_file, path_log);
   pthread_mutex_unlock(&log_mutex);
 
+  /* from here on threads queue their records for a writer thread */
+  if (log_async_start() != PBSE_NONE)
+    log_err(-1, msg_daemonname, "could not start the log writer thread, logging synchronously");
+
   sprintf(log_buf, msg_startup1, server_name, server_init_type);
 
   log_event(
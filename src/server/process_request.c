@@ -190,6 +190,7 @@ static const int munge_on = 0;
 
 static void freebr_manage(struct rq_manage *);
 static void freebr_cpyfile(struct rq_cpyfile *);
+static void freebr_jobobit_batch(struct rq_jobobit_batch *);
 static void free_rescrq(struct rq_rescq *);
 void        close_quejob(int sfds);
 
@@ -685,6 +686,8 @@ int process_request(
       case PBS_BATCH_QueueJob2:
       case PBS_BATCH_RunJob:
       case PBS_BATCH_StageIn:
+      case PBS_BATCH_SubmitJob:
+      case PBS_BATCH_SubmitJobs:
       case PBS_BATCH_jobscript:
       case PBS_BATCH_jobscript2:
 
@@ -767,6 +770,18 @@ int dispatch_request(
       
       break;
 
+    case PBS_BATCH_SubmitJob:
+
+      rc = req_submitjob(request);
+
+      break;
+
+    case PBS_BATCH_SubmitJobs:
+
+      rc = req_submitjobs(request);
+
+      break;
+
 
     case PBS_BATCH_RdytoCommit:
      
@@ -1002,6 +1017,12 @@ int dispatch_request(
 
       break;
 
+    case PBS_BATCH_JobObitBatch:
+
+      rc = req_jobobit_batch(request);
+
+      break;
+
     case PBS_BATCH_StageIn:
 
       rc = req_stagein(request);
@@ -1175,6 +1196,35 @@ void free_br(
 
       break;
 
+    case PBS_BATCH_SubmitJob:
+    case PBS_BATCH_SubmitJobs:
+
+      if ((preq->rq_type == PBS_BATCH_SubmitJobs) &&
+          (preq->rq_ind.rq_submitjobs.rq_overrides != NULL))
+        {
+        for (int i = 0; i < preq->rq_ind.rq_submitjobs.rq_count; i++)
+          free_attrlist(&preq->rq_ind.rq_submitjobs.rq_overrides[i]);
+
+        free(preq->rq_ind.rq_submitjobs.rq_overrides);
+        preq->rq_ind.rq_submitjobs.rq_overrides = NULL;
+        }
+
+      free_attrlist(&preq->rq_ind.rq_submitjob.rq_job.rq_attr);
+
+      if (preq->rq_ind.rq_submitjob.rq_cred.rq_data)
+        {
+        free(preq->rq_ind.rq_submitjob.rq_cred.rq_data);
+        preq->rq_ind.rq_submitjob.rq_cred.rq_data = NULL;
+        }
+
+      if (preq->rq_ind.rq_submitjob.rq_script)
+        {
+        free(preq->rq_ind.rq_submitjob.rq_script);
+        preq->rq_ind.rq_submitjob.rq_script = NULL;
+        }
+
+      break;
+
     case PBS_BATCH_JobCred:
 
       if (preq->rq_ind.rq_jobcred.rq_data)
@@ -1245,6 +1295,12 @@ void free_br(
 
       break;
 
+    case PBS_BATCH_JobObitBatch:
+
+      freebr_jobobit_batch(&preq->rq_ind.rq_jobobit_batch);
+
+      break;
+
     case PBS_BATCH_CopyFiles:
 
     case PBS_BATCH_DelFiles:
@@ -1352,6 +1408,30 @@ static void freebr_cpyfile(
 
 
 
+static void freebr_jobobit_batch(
+
+  struct rq_jobobit_batch *pbatch)
+
+  {
+  int i;
+
+  if (pbatch->rq_obits == NULL)
+    return;
+
+  for (i = 0; i < pbatch->rq_count; i++)
+    free_attrlist(&pbatch->rq_obits[i].rq_attr);
+
+  free(pbatch->rq_obits);
+
+  pbatch->rq_obits = NULL;
+  pbatch->rq_count = 0;
+
+  return;
+  }  /* END freebr_jobobit_batch() */
+
+
+
+
 
 static void free_rescrq(
 
@@ -236,6 +236,8 @@ pbs_queue *que_alloc(
   pq->qu_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
   pq->qu_jobs = new all_jobs();
   pq->qu_jobs_array_sum = new all_jobs();
+  pq->qu_jobs_ranks = new job_rank_index();
+  pq->qu_jobs_array_sum_ranks = new job_rank_index();
   
   if ((pq->qu_mutex == NULL) ||
       (pq->qu_jobs == NULL) ||
@@ -60,6 +60,8 @@ void *remove_some_recycle_queues(
   free(pq->qu_mutex);
   delete pq->qu_jobs;
   delete pq->qu_jobs_array_sum;
+  delete pq->qu_jobs_ranks;
+  delete pq->qu_jobs_array_sum_ranks;
   memset(pq, 254, sizeof(pbs_queue));
   free(pq);
 
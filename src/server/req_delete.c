@@ -118,12 +118,20 @@
 #include "threadpool.h"
 #include "req_delete.h"
 #include "delete_all_tracker.hpp"
+#include "event_trace.h"
 #include <string>
+#include <map>
+#include <set>
 
 #define PURGE_SUCCESS 1
 #define MOM_DELETE    2
 #define ROUTE_DELETE  3
 
+/* non-running jobs handled by each delete all task */
+#define DELETE_ALL_CHUNK_SIZE         1000
+/* jobs between delete all progress updates */
+#define DELETE_ALL_PROGRESS_INTERVAL  1000
+
 /* Global Data Items: */
 
 delete_all_tracker qdel_all_tracker;
@@ -583,6 +591,8 @@ jump:
 
   log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,pjob->ji_qs.ji_jobid,log_buf);
 
+  trace_event(TRACE_JOB_DELETED, pjob->ji_qs.ji_jobid, trace_elapsed(pjob->ji_wattr[JOB_ATR_qtime].at_val.at_long), 0);
+
   /* NOTE:  should incorporate job delete message */
 
   if (Msg != NULL)
@@ -948,28 +958,229 @@ batch_request *duplicate_request(
 
 
 
+/*
+ * finish_delete_all_partition()
+ *
+ * Called as each partition of a delete all finishes. The last one releases
+ * the user's delete all and answers the client.
+ */
+
+void finish_delete_all_partition(
+
+  delete_all_state *das)
+
+  {
+  bool last;
+  char tmpLine[MAXLINE];
+
+  pthread_mutex_lock(&das->das_mutex);
+  last = (--das->das_partitions == 0);
+  pthread_mutex_unlock(&das->das_mutex);
+
+  if (last == false)
+    return;
+
+  batch_request *preq = das->das_preq;
+
+  qdel_all_tracker.done_deleting_all(preq->rq_user, preq->rq_perm);
+
+  snprintf(tmpLine, sizeof(tmpLine), "delete all: handled %d jobs, %d failed",
+    das->das_handled, das->das_failed);
+  log_event(PBSEVENT_JOB, PBS_EVENTCLASS_SERVER, __func__, tmpLine);
+
+  if (das->das_failed == 0)
+    {
+    snprintf(tmpLine, sizeof(tmpLine), "Deleted %d jobs", das->das_total);
+    reply_text(preq, PBSE_NONE, tmpLine);
+    }
+  else
+    {
+    snprintf(tmpLine,sizeof(tmpLine),"Deletes failed for %d of %d jobs",
+      das->das_failed,
+      das->das_total);
+    
+    req_reject(PBSE_SYSTEM, 0, preq, NULL, tmpLine);
+    }
+
+  pthread_mutex_destroy(&das->das_mutex);
+  delete das;
+  } /* END finish_delete_all_partition() */
+
+
+
+/*
+ * delete_all_one_job()
+ *
+ * Deletes or purges one job on behalf of a delete all request
+ * @param jobid - the job to delete
+ * @param preq - the client's request, copied for the job
+ * @return ROUTE_DELETE if the delete couldn't be processed now, PURGE_SUCCESS
+ * if the job was purged, -1 if the job was rejected or left for the mom, 
+ * PBSE_NONE otherwise
+ */
+
+int delete_all_one_job(
+
+  const char    *jobid,
+  batch_request *preq)
+
+  {
+  job           *pjob;
+  batch_request *preq_dup;
+  int            rc;
+
+  if ((pjob = svr_find_job(jobid, FALSE)) == NULL)
+    return(PBSE_NONE);
+
+  mutex_mgr job_mutex(pjob->ji_mutex, true);
+
+  if ((preq_dup = duplicate_request(preq)) == NULL)
+    return(PBSE_SYSTEM);
+
+  preq_dup->rq_noreply = TRUE;
+
+  if ((rc = forced_jobpurge(pjob, preq_dup)) != PBSE_NONE)
+    {
+    if (rc == -1)
+      {
+      /* forced_jobpurge() rejected preq_dup and unlocked the job */
+      job_mutex.set_unlock_on_exit(false);
+      }
+    else
+      {
+      if (rc == PURGE_SUCCESS)
+        job_mutex.set_unlock_on_exit(false);
+
+      free_br(preq_dup);
+      }
+
+    return(rc);
+    }
+
+  if (pjob->ji_qs.ji_state >= JOB_STATE_EXITING)
+    {
+    free_br(preq_dup);
+    return(PBSE_NONE);
+    }
+
+  /* execute_job_delete() handles the job's mutex from here on */
+  job_mutex.set_unlock_on_exit(false);
+
+  if ((rc = execute_job_delete(pjob, preq->rq_extend, preq_dup)) == PBSE_NONE)
+    reply_ack(preq_dup);
+
+  return(rc);
+  } /* END delete_all_one_job() */
+
+
+
+/*
+ * delete_all_partition_work()
+ *
+ * Threadpool task that deletes one partition of a delete all
+ */
+
+void *delete_all_partition_work(
+
+  void *vp)
+
+  {
+  delete_all_partition *dap = (delete_all_partition *)vp;
+  delete_all_state     *das = dap->dap_state;
+  batch_request        *preq = das->das_preq;
+  char                  log_buf[LOCAL_LOG_BUF_SIZE];
+
+  for (size_t i = 0; i < dap->dap_jobs.size(); i++)
+    {
+    int rc = delete_all_one_job(dap->dap_jobs[i].c_str(), preq);
+    int handled;
+
+    pthread_mutex_lock(&das->das_mutex);
+
+    if ((rc == MOM_DELETE) ||
+        (rc == ROUTE_DELETE))
+      das->das_failed++;
+
+    handled = ++das->das_handled;
+
+    pthread_mutex_unlock(&das->das_mutex);
+
+    if ((handled % DELETE_ALL_PROGRESS_INTERVAL) == 0)
+      {
+      qdel_all_tracker.update_progress(preq->rq_user, preq->rq_perm, handled, das->das_total);
+
+      snprintf(log_buf, sizeof(log_buf), "delete all for %s@%s: %d of %d jobs handled",
+        preq->rq_user, preq->rq_host, handled, das->das_total);
+      log_event(PBSEVENT_JOB, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+      }
+    }
+
+  finish_delete_all_partition(das);
+
+  delete dap;
+
+  return(NULL);
+  } /* END delete_all_partition_work() */
+
+
+
+/*
+ * queue_delete_all_partition()
+ *
+ * Hands a partition to the threadpool, or runs it here if it can't be queued
+ */
+
+void queue_delete_all_partition(
+
+  delete_all_partition *dap)
+
+  {
+  if (enqueue_threadpool_request(delete_all_partition_work, dap, request_pool) != PBSE_NONE)
+    delete_all_partition_work(dap);
+  } /* END queue_delete_all_partition() */
+
+
+
+/*
+ * delete_all_work()
+ *
+ * Services qdel all. The jobs are split into partitions that the threadpool
+ * deletes in parallel: jobs that aren't running are purged in chunks of
+ * DELETE_ALL_CHUNK_SIZE, and running jobs are grouped by mother superior so
+ * that each mom's kill requests are sent by a single task. The last partition
+ * to finish replies to the client.
+ */
+
 void *delete_all_work(
 
   void *vp)
 
   {
   batch_request *preq = (batch_request *)vp;
+  int            handled;
+  int            total;
+  char           tmpLine[LOCAL_LOG_BUF_SIZE];
 
   if (qdel_all_tracker.start_deleting_all_if_possible(preq->rq_user, preq->rq_perm) == false)
     {
-    reply_ack(preq);
+    if (qdel_all_tracker.get_progress(preq->rq_user, preq->rq_perm, handled, total) == true)
+      {
+      snprintf(tmpLine, sizeof(tmpLine), "delete all in progress: %d of %d jobs handled",
+        handled, total);
+      reply_text(preq, PBSE_NONE, tmpLine);
+      }
+    else
+      reply_ack(preq);
+
     return(NULL);
     }
 
-  batch_request         *preq_dup = duplicate_request(preq);
-  job                   *pjob;
-  all_jobs_iterator     *iter = NULL;
-  int                    failed_deletes = 0;
-  int                    total_jobs = 0;
-  int                    rc = PBSE_NONE;
-  char                   tmpLine[MAXLINE];
-  char                  *Msg = preq->rq_extend;
-  std::set<std::string>  marked_arrays;
+  job                                          *pjob;
+  all_jobs_iterator                            *iter = NULL;
+  std::set<std::string>                         marked_arrays;
+  std::vector<std::string>                      queued_ids;
+  std::map<std::string, std::vector<std::string> > running_ids;
+  delete_all_state                             *das = new delete_all_state();
   
   alljobs.lock();
   iter = alljobs.get_iterator();
@@ -1001,90 +1212,77 @@ void *delete_all_work(
     
     // use mutex manager to make sure job mutex locks are properly handled at exit
     mutex_mgr job_mutex(pjob->ji_mutex, true);
- 
-    if ((rc = forced_jobpurge(pjob, preq_dup)) == PURGE_SUCCESS)
-      {
-      job_mutex.set_unlock_on_exit(false);
 
-      continue;
-      }
-
-    if (pjob->ji_qs.ji_state >= JOB_STATE_EXITING)
-      {
-      job_mutex.unlock();
-      
-      if (rc == -1)
-        {
-        //forced_jobpurge freed preq_dup so reallocate it.
-        preq_dup = duplicate_request(preq);
-        preq_dup->rq_noreply = TRUE;
-        }
-      continue;
-      }
-    
-    total_jobs++;
-    
-    /* mutex is freed below */
-    if (rc == PBSE_NONE)
+    if (pjob->ji_qs.ji_state == JOB_STATE_RUNNING)
       {
-      if ((rc = execute_job_delete(pjob, Msg, preq_dup)) == PBSE_NONE)
-        {
-        // execute_job_delete() handles mutex so don't unlock on exit
-        job_mutex.set_unlock_on_exit(false);
-        reply_ack(preq_dup);
-        }
-       
-      /* preq_dup has been freed at this point. Either reallocate it or set it to NULL*/
-      if (rc == PURGE_SUCCESS)
-        {
-        preq_dup = duplicate_request(preq);
-        preq_dup->rq_noreply = TRUE;
-        }
-      else
-        preq_dup = NULL;
+      unsigned int  dummy;
+      char         *ms_name = parse_servername(pjob->ji_wattr[JOB_ATR_exec_host].at_val.at_str, &dummy);
+
+      running_ids[ms_name].push_back(pjob->ji_qs.ji_jobid);
+      free(ms_name);
       }
-    
-    if (rc != PURGE_SUCCESS)
+    else if (pjob->ji_qs.ji_state < JOB_STATE_EXITING)
+      queued_ids.push_back(pjob->ji_qs.ji_jobid);
+    else if ((preq->rq_extend != NULL) &&
+             (!strncmp(preq->rq_extend, delpurgestr, strlen(delpurgestr))))
       {
-      /* duplicate the preq so we don't have a problem with double frees */
-      preq_dup = duplicate_request(preq);
-      preq_dup->rq_noreply = TRUE;
-      
-      if ((rc == MOM_DELETE) ||
-          (rc == ROUTE_DELETE))
-        failed_deletes++;
+      /* exiting and complete jobs are only touched by a purge */
+      queued_ids.push_back(pjob->ji_qs.ji_jobid);
       }
     }
 
   delete iter;
-  
-  qdel_all_tracker.done_deleting_all(preq->rq_user, preq->rq_perm);
-  
-  if (failed_deletes == 0)
+
+  pthread_mutex_init(&das->das_mutex, NULL);
+  das->das_preq = preq;
+  das->das_total = queued_ids.size();
+  das->das_handled = 0;
+  das->das_failed = 0;
+
+  std::vector<delete_all_partition *> partitions;
+
+  for (size_t i = 0; i < queued_ids.size(); i += DELETE_ALL_CHUNK_SIZE)
     {
-    reply_ack(preq);
+    delete_all_partition *dap = new delete_all_partition();
+    size_t                end = i + DELETE_ALL_CHUNK_SIZE;
 
-    /* PURGE SUCCESS means this was qdel -p all. In this case no reply_*() 
-     * functions have been called */
-    if (rc == PURGE_SUCCESS)
-      {
-      free_br(preq_dup);
-      preq_dup = NULL;
-      }
+    if (end > queued_ids.size())
+      end = queued_ids.size();
+
+    dap->dap_state = das;
+    dap->dap_jobs.assign(queued_ids.begin() + i, queued_ids.begin() + end);
+    partitions.push_back(dap);
     }
-  else
+
+  for (std::map<std::string, std::vector<std::string> >::iterator it = running_ids.begin();
+       it != running_ids.end();
+       it++)
     {
-    snprintf(tmpLine,sizeof(tmpLine),"Deletes failed for %d of %d jobs",
-      failed_deletes,
-      total_jobs);
-    
-    req_reject(PBSE_SYSTEM, 0, preq, NULL, tmpLine);
+    delete_all_partition *dap = new delete_all_partition();
+
+    dap->dap_state = das;
+    dap->dap_jobs.swap(it->second);
+    das->das_total += dap->dap_jobs.size();
+    partitions.push_back(dap);
     }
-    
-  /* preq_dup happens at the end of the loop, so free the extra one if
-   * it is there */
-  if (preq_dup != NULL)
-    free_br(preq_dup);
+
+  /* hold one partition count here so no task can finish the request before
+   * all of them are queued */
+  das->das_partitions = partitions.size() + 1;
+
+  qdel_all_tracker.update_progress(preq->rq_user, preq->rq_perm, 0, das->das_total);
+
+  if (LOGLEVEL >= 6)
+    {
+    snprintf(tmpLine, sizeof(tmpLine), "delete all for %s@%s: %d jobs in %d partitions",
+      preq->rq_user, preq->rq_host, das->das_total, (int)partitions.size());
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_SERVER, __func__, tmpLine);
+    }
+
+  for (size_t i = 0; i < partitions.size(); i++)
+    queue_delete_all_partition(partitions[i]);
+
+  finish_delete_all_partition(das);
 
   return(NULL);
   } /* END delete_all_work() */
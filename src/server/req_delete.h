@@ -6,12 +6,35 @@
 #include "work_task.h" /* work_task */
 #include "batch_request.h" /* batch_request */
 
+#include <string>
+#include <vector>
+
+/* shared by the partitions of one delete all */
+typedef struct delete_all_state
+  {
+  batch_request   *das_preq;       /* answered when the last partition finishes */
+  pthread_mutex_t  das_mutex;
+  int              das_partitions; /* partitions not yet finished */
+  int              das_total;
+  int              das_handled;
+  int              das_failed;
+  } delete_all_state;
+
+/* the jobs one threadpool task deletes */
+typedef struct delete_all_partition
+  {
+  delete_all_state         *dap_state;
+  std::vector<std::string>  dap_jobs;
+  } delete_all_partition;
+
 void remove_stagein(job **pjob);
 
 void ensure_deleted(struct work_task *ptask);
 
 int execute_job_delete(job *pjob, char *Msg, struct batch_request *preq);
 
+void *delete_all_partition_work(void *vp);
+
 int req_deletejob(struct batch_request *preq);
 
 void change_restart_comment_if_needed(struct job *pjob);
@@ -150,15 +150,11 @@ int req_holdarray(
   else
     {
     /* do the entire array */
-    for (i = 0;i < pa->ai_qs.array_size;i++)
+    for (i = pa->next_job_index(-1); i >= 0; i = pa->next_job_index(i))
       {
-      if (pa->job_ids[i] == NULL)
-        continue;
-
-      if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
+      if ((pjob = svr_find_job(pa->get_job_id(i), FALSE)) == NULL)
         {
-        free(pa->job_ids[i]);
-        pa->job_ids[i] = NULL;
+        pa->remove_job_id(i);
         }
       else
         {
@@ -531,15 +531,11 @@ int release_whole_array(
   int  rc;
   job *pjob;
 
-  for (i = 0; i < pa->ai_qs.array_size; i++)
+  for (i = pa->next_job_index(-1); i >= 0; i = pa->next_job_index(i))
     {
-    if (pa->job_ids[i] == NULL)
-      continue;
-
-    if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
+    if ((pjob = svr_find_job(pa->get_job_id(i), FALSE)) == NULL)
       {
-      free(pa->job_ids[i]);
-      pa->job_ids[i] = NULL;
+      pa->remove_job_id(i);
       }
     else
       {
@@ -579,15 +575,14 @@ int req_releasearray(
   while (TRUE)
     {
     if (((index = first_job_index(pa)) == -1) ||
-        (pa->job_ids[index] == NULL))
+        (pa->get_job_id(index) == NULL))
       {
       return(PBSE_NONE);
       }
 
-    if ((pjob = svr_find_job(pa->job_ids[index], FALSE)) == NULL)
+    if ((pjob = svr_find_job(pa->get_job_id(index), FALSE)) == NULL)
       {
-      free(pa->job_ids[index]);
-      pa->job_ids[index] = NULL;
+      pa->remove_job_id(index);
       }
     else
       break;
@@ -124,7 +124,12 @@
 #include "track_alps_reservations.hpp"
 #include "id_map.hpp"
 #include "completed_jobs_map.h"
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 #include "policy_values.h"
+#include "run_sched.h"
+#include "sched_event_tracker.hpp"
+#include "event_trace.h"
 
 #define RESC_USED_BUF 2048
 #define JOBMUSTREPORTDEFAULTKEEP 30
@@ -152,10 +157,6 @@ extern char            *msg_obitnojob;
 extern char            *msg_obitnocpy;
 extern char            *msg_obitnodel;
 extern char             server_host[];
-extern int              svr_do_schedule;
-extern pthread_mutex_t *svr_do_schedule_mutex;
-extern pthread_mutex_t *listener_command_mutex;
-extern int              listener_command;
 
 extern int              LOGLEVEL;
 
@@ -174,6 +175,8 @@ int         kill_job_on_mom(const char *job_id, struct pbsnode *pnode);
 void        handle_complete_second_time(struct work_task *ptask);
 void       *on_job_exit_task(struct work_task *vp);
 bool        single_cleanup_transaction(job *pjob);
+int         compact_completed_job(job *pjob, time_t expires);
+int         record_job_history(job *pjob);
 
 /*
  * setup_from - setup the "from" name for a standard job file:
@@ -753,13 +756,7 @@ void rel_resc(
   set_resc_assigned(pjob, DECR);
 
   /* mark that scheduler should be called */
-  pthread_mutex_lock(svr_do_schedule_mutex);
-  svr_do_schedule = SCH_SCHEDULE_TERM;
-  pthread_mutex_unlock(svr_do_schedule_mutex);
-
-  pthread_mutex_lock(listener_command_mutex);
-  listener_command = SCH_SCHEDULE_TERM;
-  pthread_mutex_unlock(listener_command_mutex);
+  notify_scheduler(SCHED_EVENT_JOB_FINISHED);
 
   return;
   }  /* END rel_resc() */
@@ -1792,6 +1789,7 @@ int handle_complete_first_time(
   int          KeepSeconds = 0;
   char         log_buf[LOCAL_LOG_BUF_SIZE+1];
   bool         must_report = false;
+  bool         compact = false;
   std::string  jid;
   char         acctbuf[RESC_USED_BUF];
   std::string  acct_data;
@@ -1804,6 +1802,11 @@ int handle_complete_first_time(
   if (LOGLEVEL >= 4)
     log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, "JOB_SUBSTATE_COMPLETE");
 
+  trace_event(TRACE_JOB_COMPLETE,
+    pjob->ji_qs.ji_jobid,
+    trace_elapsed(pjob->ji_wattr[JOB_ATR_qtime].at_val.at_long),
+    pjob->ji_qs.ji_un.ji_exect.ji_exitstat);
+
   remove_job_from_exiting_list(&pjob);
 
   if (pjob == NULL)
@@ -1882,12 +1885,27 @@ int handle_complete_first_time(
   sprintf(acctbuf, msg_job_end_stat, pjob->ji_qs.ji_un.ji_exect.ji_exitstat);
   acct_data = acctbuf;
   end_of_job_accounting(pjob, acct_data, accttail);
+
+  if ((rc = record_job_history(pjob)) != PBSE_NONE)
+    log_err(rc, __func__, "could not record the job in the job history");
   
   if (KeepSeconds <= 0)
     {
     rc = svr_job_purge(pjob);
     return(rc);
     }
+
+  /* keep only a compact status record rather than the whole job. Array
+   * sub-jobs stay whole so the array can still report them */
+  if ((must_report == false) &&
+      (pjob->ji_arraystructid[0] == '\0') &&
+      (get_svr_attr_b(SRV_ATR_CompactCompletedJobs, &compact) == PBSE_NONE) &&
+      (compact == true) &&
+      (compact_completed_job(pjob, time(NULL) + KeepSeconds) == PBSE_NONE))
+    {
+    rc = svr_job_purge(pjob);
+    return(rc);
+    }
     
   jid = pjob->ji_qs.ji_jobid;
 
@@ -2667,6 +2685,8 @@ void on_job_rerun(
 
       /* Now re-queue the job */
 
+      trace_event(TRACE_JOB_REQUEUE, pjob->ji_qs.ji_jobid, trace_elapsed(pjob->ji_qs.ji_stime), 0);
+
       pjob->ji_modified = 1; /* force full job save */
 
       pjob->ji_momhandle = -1;
@@ -3437,13 +3457,41 @@ bool is_job_finished(
 
 
 /*
- * req_jobobit - process the Job Obituary Notice (request) from MOM.
- * This notice is sent from MOM when a job terminates.
+ * reply_to_obit - answer an obit, noting the code for a batched obit
  */
 
-int req_jobobit(
+static void reply_to_obit(
 
-  batch_request *preq) /* I */
+  batch_request *preq,        /* I (freed) */
+  int            code,
+  int           *reply_code)  /* O (optional) */
+
+  {
+  if (reply_code != NULL)
+    *reply_code = code;
+
+  if (code == PBSE_NONE)
+    reply_ack(preq);
+  else
+    req_reject(code, 0, preq, NULL, NULL);
+  }  /* END reply_to_obit() */
+
+
+
+
+/*
+ * process_job_obit - process one Job Obituary Notice from MOM.
+ *
+ * reply_code is NULL for an obit that arrived on its own. For one taken
+ * from a JobObitBatch it receives the code the obit was answered with, and
+ * an obit that would have to wait for the job to finish starting is
+ * answered with PBSE_SERVER_BUSY so MOM sends it again later.
+ */
+
+static int process_job_obit(
+
+  batch_request *preq,        /* I */
+  int           *reply_code)  /* O (optional) */
 
   {
   int                   alreadymailed = 0;
@@ -3487,7 +3535,7 @@ int req_jobobit(
       sprintf(log_buf, msg_obitnojob, preq->rq_host, PBSE_CLEANEDOUT);
 
       rc = PBSE_CLEANEDOUT;
-      req_reject(PBSE_CLEANEDOUT, 0, preq, NULL, NULL);
+      reply_to_obit(preq, PBSE_CLEANEDOUT, reply_code);
       }
     else if (pjob != NULL)
       {
@@ -3495,14 +3543,14 @@ int req_jobobit(
         "Received obit for job %s from mom %s, but mom address doesn't match",
         pjob->ji_qs.ji_jobid, preq->rq_host);
 
-      req_reject(PBSE_UNKJOBID, 0, preq, NULL, NULL);
+      reply_to_obit(preq, PBSE_UNKJOBID, reply_code);
       }
     else
       {
       sprintf(log_buf, msg_obitnojob, preq->rq_host, PBSE_UNKJOBID);
 
       rc = PBSE_UNKJOBID;
-      req_reject(PBSE_UNKJOBID, 0, preq, NULL, NULL);
+      reply_to_obit(preq, PBSE_UNKJOBID, reply_code);
       }
 
     log_err(rc, job_id, log_buf);
@@ -3521,7 +3569,7 @@ int req_jobobit(
 
   if (pjob->ji_qs.ji_state == JOB_STATE_COMPLETE)
     {
-    reply_ack(preq);
+    reply_to_obit(preq, PBSE_NONE, reply_code);
     return(PBSE_BADSTATE);
     /* Mom didn't update correctly past time, so this was resent. */
     }
@@ -3563,7 +3611,7 @@ int req_jobobit(
       rc = PBSE_BADSTATE;
       }
 
-    req_reject(rc, 0, preq, NULL, NULL);
+    reply_to_obit(preq, rc, reply_code);
 
     return(rc);
     }  /* END if (pjob->ji_qs.ji_state != JOB_STATE_RUNNING) */
@@ -3573,10 +3621,18 @@ int req_jobobit(
     /* have hit a race condition, the send_job child's SIGCHLD */
     /* has not yet been reaped.  Must wait for it.     */
 
+    if (reply_code != NULL)
+      {
+      /* a batched obit has no connection of its own to wait with */
+      reply_to_obit(preq, PBSE_SERVER_BUSY, reply_code);
+
+      return(PBSE_SERVER_BUSY);
+      }
+
     ptask = set_task(WORK_Timed, time_now + 1, wait_for_send, (void *)preq, FALSE);
 
     if (ptask == NULL)
-      req_reject(PBSE_SYSTEM, 0, preq, NULL, NULL);
+      reply_to_obit(preq, PBSE_SYSTEM, reply_code);
 
     /* In else case, the request is after callback. Please don't change things 
      * when you aren't sure what should happen. */
@@ -3619,12 +3675,14 @@ int req_jobobit(
     pjob->ji_wattr[JOB_ATR_exitstat].at_flags |= ATR_VFLAG_SET;
     }
 
+  trace_event(TRACE_JOB_OBIT, pjob->ji_qs.ji_jobid, trace_elapsed(pjob->ji_qs.ji_stime), exitstatus);
+
   if ((exitstatus != JOB_EXEC_RETRY) &&
       (pjob->ji_parent_job != NULL))
     {
     if (handle_subjob_exit_status(pjob) == PBSE_JOB_RECYCLED)
       {
-      req_reject(PBSE_UNKJOBID, 0, preq, NULL, NULL);
+      reply_to_obit(preq, PBSE_UNKJOBID, reply_code);
       return(PBSE_NONE);
       }
     }
@@ -3686,7 +3744,7 @@ int req_jobobit(
 
       log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
 
-      req_reject(PBSE_SYSTEM, 0, preq, NULL, NULL);
+      reply_to_obit(preq, PBSE_SYSTEM, reply_code);
       return(PBSE_SYSTEM);
       }
 
@@ -3709,7 +3767,7 @@ int req_jobobit(
 
   safe_strncat(mailbuf, acct_data.c_str(), sizeof(mailbuf) - strlen(mailbuf) - 1);
 
-  reply_ack(preq);
+  reply_to_obit(preq, PBSE_NONE, reply_code);
 
   /* clear suspended flag if it was set */
   pjob->ji_qs.ji_svrflags &= ~JOB_SVFLG_Suspend;
@@ -3782,10 +3840,77 @@ int req_jobobit(
     }
 
   return(PBSE_NONE);
+  }  /* END process_job_obit() */
+
+
+
+
+/*
+ * req_jobobit - process the Job Obituary Notice (request) from MOM.
+ * This notice is sent from MOM when a job terminates.
+ */
+
+int req_jobobit(
+
+  batch_request *preq) /* I */
+
+  {
+  return(process_job_obit(preq, NULL));
   }  /* END req_jobobit() */
 
 
 
+
+/*
+ * req_jobobit_batch - process a JobObitBatch request from MOM.
+ *
+ * Each obit is handled as if it had arrived on its own. The reply is a
+ * text reply with one "<jobid> <code>" line per obit, in request order.
+ */
+
+int req_jobobit_batch(
+
+  batch_request *preq) /* I (freed) */
+
+  {
+  struct rq_jobobit_batch *pbatch = &preq->rq_ind.rq_jobobit_batch;
+  std::string              results;
+  char                     line[PBS_MAXSVRJOBID + 32];
+  int                      i;
+
+  for (i = 0; i < pbatch->rq_count; i++)
+    {
+    struct rq_jobobit *pobit = &pbatch->rq_obits[i];
+    batch_request     *obit_req;
+    int                reply_code = PBSE_SYSTEM;
+
+    if ((obit_req = alloc_br(PBS_BATCH_JobObit)) != NULL)
+      {
+      /* rq_conn stays -1 so the reply only records the code and frees obit_req */
+      obit_req->rq_perm = preq->rq_perm;
+      obit_req->rq_fromsvr = preq->rq_fromsvr;
+      snprintf(obit_req->rq_user, sizeof(obit_req->rq_user), "%s", preq->rq_user);
+      snprintf(obit_req->rq_host, sizeof(obit_req->rq_host), "%s", preq->rq_host);
+
+      snprintf(obit_req->rq_ind.rq_jobobit.rq_jid, sizeof(obit_req->rq_ind.rq_jobobit.rq_jid),
+        "%s", pobit->rq_jid);
+      obit_req->rq_ind.rq_jobobit.rq_status = pobit->rq_status;
+      list_move(&pobit->rq_attr, &obit_req->rq_ind.rq_jobobit.rq_attr);
+
+      process_job_obit(obit_req, &reply_code);
+      }
+
+    snprintf(line, sizeof(line), "%s %d\n", pobit->rq_jid, reply_code);
+    results += line;
+    }
+
+  reply_text(preq, PBSE_NONE, results.c_str());
+
+  return(PBSE_NONE);
+  }  /* END req_jobobit_batch() */
+
+
+
 void *remove_completed_jobs(
 
   void *vp)
@@ -3795,6 +3920,11 @@ void *remove_completed_jobs(
     {
     // cleanup any completed jobs
     completed_jobs_map.cleanup_completed_jobs();
+    completed_store.cleanup_expired(time(NULL));
+
+    long history_days = JOB_HISTORY_DAYS_DEFAULT;
+    get_svr_attr_l(SRV_ATR_JobHistoryDays, &history_days);
+    job_hist.expire(time(NULL), history_days);
 
     // wait a bit before trying again
     sleep(REMOVE_COMPLETED_JOBS_SLEEP_TIME);
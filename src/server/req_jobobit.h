@@ -46,4 +46,6 @@ void encode_job_used(job *pjob, tlist_head *phead);
 
 int req_jobobit(struct batch_request *preq);
 
+int req_jobobit_batch(struct batch_request *preq);
+
 #endif /* _REQ_JOBOBIT_H */
@@ -140,6 +140,10 @@
 #include "req_delete.h"
 #include "mom_hierarchy_handler.h"
 #include "attr_req_info.hpp"
+#include "event_trace.h"
+#include "acct.h"
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 
 
 #define PERM_MANAGER (ATR_DFLAG_MGWR | ATR_DFLAG_MGRD)
@@ -162,6 +166,8 @@ extern char          *msg_man_set;
 extern char          *msg_man_uns;
 extern time_t         pbs_incoming_tcp_timeout;
 extern int            default_gpu_mode;
+extern char          *path_log;
+extern char          *path_priv;
 //extern mom_hierarchy_t *mh;
 
 
@@ -2754,6 +2760,153 @@ int check_default_gpu_mode_str(
 
 
 
+/*
+ * record_job_trace_action()
+ *
+ * Starts or stops the binary job event trace when record_job_trace is set,
+ * including when it is recovered at startup.
+ */
+
+int record_job_trace_action(
+
+  pbs_attribute *pattr,
+  void          *pobj,
+  int            actmode)
+
+  {
+  char log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((actmode != ATR_ACTION_ALTER) &&
+      (actmode != ATR_ACTION_RECOV))
+    return(PBSE_NONE);
+
+  if (((pattr->at_flags & ATR_VFLAG_SET) == 0) ||
+      (pattr->at_val.at_bool == false))
+    {
+    trace_close();
+    return(PBSE_NONE);
+    }
+
+  if (trace_open(path_log, TRACE_SOURCE_SERVER) != PBSE_NONE)
+    {
+    snprintf(log_buf, sizeof(log_buf), "could not open the job trace in %s", path_log);
+    log_err(errno, __func__, log_buf);
+    return(PBSE_SYSTEM);
+    }
+
+  return(PBSE_NONE);
+  } // END record_job_trace_action()
+
+
+
+/*
+ * record_job_usage_action()
+ *
+ * Starts or stops the binary usage sidecar of the accounting file when
+ * record_job_usage is set, including when it is recovered at startup.
+ */
+
+int record_job_usage_action(
+
+  pbs_attribute *pattr,
+  void          *pobj,
+  int            actmode)
+
+  {
+  if ((actmode != ATR_ACTION_ALTER) &&
+      (actmode != ATR_ACTION_RECOV))
+    return(PBSE_NONE);
+
+  acct_usage_enable(((pattr->at_flags & ATR_VFLAG_SET) != 0) &&
+                    (pattr->at_val.at_bool == true));
+
+  return(PBSE_NONE);
+  } // END record_job_usage_action()
+
+
+
+/*
+ * spill_completed_jobs_action()
+ *
+ * Moves the compacted completed jobs into the spill file in server_priv
+ * when spill_completed_jobs is set, recovering the records a previous
+ * server left there, and back into memory when it is cleared.
+ */
+
+int spill_completed_jobs_action(
+
+  pbs_attribute *pattr,
+  void          *pobj,
+  int            actmode)
+
+  {
+  char log_buf[LOCAL_LOG_BUF_SIZE];
+  char spill_file[MAXPATHLEN + 1];
+
+  if ((actmode != ATR_ACTION_ALTER) &&
+      (actmode != ATR_ACTION_RECOV))
+    return(PBSE_NONE);
+
+  if (((pattr->at_flags & ATR_VFLAG_SET) == 0) ||
+      (pattr->at_val.at_bool == false))
+    return(completed_store.set_spill_file(NULL));
+
+  snprintf(spill_file, sizeof(spill_file), "%s%s", path_priv, COMPLETED_STORE_SPILL_FILE);
+
+  if (completed_store.set_spill_file(spill_file) != PBSE_NONE)
+    {
+    snprintf(log_buf, sizeof(log_buf), "could not map the completed job file %s", spill_file);
+    log_err(errno, __func__, log_buf);
+    return(PBSE_SYSTEM);
+    }
+
+  return(PBSE_NONE);
+  } // END spill_completed_jobs_action()
+
+
+
+/*
+ * record_job_history_action()
+ *
+ * Opens the job history in server_priv when record_job_history is set,
+ * indexing the jobs already recorded there, and closes it when cleared.
+ */
+
+int record_job_history_action(
+
+  pbs_attribute *pattr,
+  void          *pobj,
+  int            actmode)
+
+  {
+  char log_buf[LOCAL_LOG_BUF_SIZE];
+  char history_dir[MAXPATHLEN + 1];
+
+  if ((actmode != ATR_ACTION_ALTER) &&
+      (actmode != ATR_ACTION_RECOV))
+    return(PBSE_NONE);
+
+  if (((pattr->at_flags & ATR_VFLAG_SET) == 0) ||
+      (pattr->at_val.at_bool == false))
+    {
+    job_hist.close_history();
+    return(PBSE_NONE);
+    }
+
+  snprintf(history_dir, sizeof(history_dir), "%s%s", path_priv, JOB_HISTORY_DIR);
+
+  if (job_hist.open_history(history_dir) != PBSE_NONE)
+    {
+    snprintf(log_buf, sizeof(log_buf), "could not open the job history in %s", history_dir);
+    log_err(errno, __func__, log_buf);
+    return(PBSE_SYSTEM);
+    }
+
+  return(PBSE_NONE);
+  } // END record_job_history_action()
+
+
+
 /*
  * free_extraresc() makes sure that the init_resc_defs() is called after
  * the list has changed by 'unset'.
@@ -367,6 +367,12 @@ int req_orderjob(
       mutex_mgr pque1_mutex = mutex_mgr(pque1->qu_mutex, true);
       swap_jobs(pque1->qu_jobs,pjob1,pjob2);
       swap_jobs(NULL,pjob1,pjob2);
+
+      /* keep the rank indexes in step with the swapped ranks */
+      pque1->qu_jobs_ranks->change_rank(pjob1->ji_qs.ji_jobid, pjob1->ji_wattr[JOB_ATR_qrank].at_val.at_long);
+      pque1->qu_jobs_ranks->change_rank(pjob2->ji_qs.ji_jobid, pjob2->ji_wattr[JOB_ATR_qrank].at_val.at_long);
+      pque1->qu_jobs_array_sum_ranks->change_rank(pjob1->ji_qs.ji_jobid, pjob1->ji_wattr[JOB_ATR_qrank].at_val.at_long);
+      pque1->qu_jobs_array_sum_ranks->change_rank(pjob2->ji_qs.ji_jobid, pjob2->ji_wattr[JOB_ATR_qrank].at_val.at_long);
       }
     }
 
@@ -101,6 +101,9 @@
 #include <ctype.h>
 #include <string.h>
 #include <pthread.h>
+#include <set>
+#include <string>
+#include <vector>
 #include "libpbs.h"
 #include "server_limits.h"
 #include "list_link.h"
@@ -133,6 +136,7 @@
 #include "mutex_mgr.hpp"
 #include "id_map.hpp"
 #include "policy_values.h"
+#include "event_trace.h"
 
 
 /* External Functions Called: */
@@ -696,14 +700,23 @@ job *create_and_initialize_job_structure(
 
 
 
-int decode_attributes_into_job(
+/*
+ * decode_attribute_list()
+ *
+ * @param add_variables - true if a Variable_List in attrs adds to the job's
+ *                        variables instead of replacing them
+ * @param bad_attr - set to the attribute that could not be decoded on failure
+ */
+
+static int decode_attribute_list(
     
-  job           *pj,
-  int            resc_access_perm,
-  batch_request *preq,
-  mutex_mgr     &job_mutex,
-  pbs_queue     *pque,
-  std::string   &cpuClock)
+  job          *pj,
+  int           resc_access_perm,
+  tlist_head   *attrs,
+  pbs_queue    *pque,
+  std::string  &cpuClock,
+  bool          add_variables,
+  svrattrl    **bad_attr)
 
   {
   svrattrl    *psatl;
@@ -714,7 +727,7 @@ int decode_attributes_into_job(
   
   get_svr_attr_b(SRV_ATR_pass_cpu_clock,&passCpu);
 
-  psatl = (svrattrl *)GET_NEXT(preq->rq_ind.rq_queuejob.rq_attr);
+  psatl = (svrattrl *)GET_NEXT(*attrs);
 
   while (psatl != NULL)
     {
@@ -758,9 +771,7 @@ int decode_attributes_into_job(
       {
       /* FAILURE */
       rc = PBSE_ATTRRO;
-      svr_job_purge(pj);
-      job_mutex.set_unlock_on_exit(false);
-      reply_badattr(rc, 1, psatl, preq);
+      *bad_attr = psatl;
       return(rc);
       }
 
@@ -794,9 +805,7 @@ int decode_attributes_into_job(
           {
           /* FAILURE */
           /* any other error is fatal */
-          svr_job_purge(pj);
-          job_mutex.set_unlock_on_exit(false);
-          reply_badattr(rc, 1, psatl, preq);
+          *bad_attr = psatl;
           return(rc);
           }
         }
@@ -805,12 +814,30 @@ int decode_attributes_into_job(
 
     /* decode pbs_attribute */
 
-    rc = pdef->at_decode(
-           &pj->ji_wattr[attr_index],
-           psatl->al_name,
-           psatl->al_resc,
-           psatl->al_value,
-           resc_access_perm);
+    if ((add_variables == true) &&
+        (attr_index == JOB_ATR_variables))
+      {
+      pbs_attribute tempattr;
+
+      clear_attr(&tempattr, pdef);
+
+      if ((rc = pdef->at_decode(
+                  &tempattr,
+                  psatl->al_name,
+                  psatl->al_resc,
+                  psatl->al_value,
+                  resc_access_perm)) == PBSE_NONE)
+        rc = pdef->at_set(&pj->ji_wattr[attr_index], &tempattr, INCR);
+
+      pdef->at_free(&tempattr);
+      }
+    else
+      rc = pdef->at_decode(
+             &pj->ji_wattr[attr_index],
+             psatl->al_name,
+             psatl->al_resc,
+             psatl->al_value,
+             resc_access_perm);
 
     if (rc != 0)
       {
@@ -825,9 +852,7 @@ int decode_attributes_into_job(
         if (pque->qu_qs.qu_type == QTYPE_Execution)
           {
           /* FAILURE */
-          svr_job_purge(pj);
-          job_mutex.set_unlock_on_exit(false);
-          reply_badattr(rc, 1, psatl, preq);
+          *bad_attr = psatl;
           return(rc);
           }
         }
@@ -835,9 +860,7 @@ int decode_attributes_into_job(
         {
         /* FAILURE */
         /* any other error is fatal */
-        svr_job_purge(pj);
-        job_mutex.set_unlock_on_exit(false);
-        reply_badattr(rc, 1, psatl, preq);
+        *bad_attr = psatl;
         return(rc);
         }
       }    /* END if (rc != 0) */
@@ -845,6 +868,36 @@ int decode_attributes_into_job(
     psatl = (svrattrl *)GET_NEXT(psatl->al_link);
     } /* END while (psatl != NULL) */
 
+  return(rc);
+  } /* END decode_attribute_list() */
+
+
+
+int decode_attributes_into_job(
+    
+  job           *pj,
+  int            resc_access_perm,
+  batch_request *preq,
+  mutex_mgr     &job_mutex,
+  pbs_queue     *pque,
+  std::string   &cpuClock,
+  bool           add_variables)
+
+  {
+  svrattrl *bad_attr = NULL;
+  int       rc;
+
+  rc = decode_attribute_list(pj, resc_access_perm, &preq->rq_ind.rq_queuejob.rq_attr, pque,
+                             cpuClock, add_variables, &bad_attr);
+
+  if (bad_attr != NULL)
+    {
+    /* FAILURE */
+    svr_job_purge(pj);
+    job_mutex.set_unlock_on_exit(false);
+    reply_badattr(rc, 1, bad_attr, preq);
+    }
+
   return(rc);
   } /* END decode_attributes_into_job() */
 
@@ -1610,6 +1663,8 @@ int perform_commit_work(
        is done routing the job with this flag */
     pj->ji_commit_done = 1;
 
+    trace_event(TRACE_JOB_QUEUED, pj->ji_qs.ji_jobid, trace_elapsed(pj->ji_wattr[JOB_ATR_qtime].at_val.at_long), 0);
+
     /* need to format message first, before request goes away - 
      * moved here because we have the queue name */
     snprintf(log_buf, sizeof(log_buf),
@@ -1704,21 +1759,35 @@ int perform_commit_work(
 
 
 
+/* the attributes shared by the jobs of a SubmitJobs request, decoded once */
+typedef struct submit_template
+  {
+  job         *st_job;      /* never queued, only holds the decoded attributes */
+  std::string  st_cpuclock;
+  } submit_template;
+
+
+
 /*
- * req_quejob - Queue Job Batch Request processing routine
+ * queue_new_job - create a new job from the attributes in preq
  *
  * @param preq - the batch request that contains the job's information
- * @param version - Tells us what version of queue job this is. Right now the 
- *                  options are 1 and 2. If it's version 2 and we are interactive,
- *                  then we should do the commit
- * @return PBSE_NONE on success, otherwise a PBSE_* error code
- *
+ * @param version - see req_quejob()
+ * @param submitted - if not NULL, the new job is returned here still locked and
+ *                    preq is left for the caller to finish and reply to. Otherwise
+ *                    preq is answered with the job id.
+ * @param ptemplate - if not NULL, the job starts with these attributes and the
+ *                    ones in preq are only its overrides
+ * @return PBSE_NONE on success, otherwise a PBSE_* error code. On failure preq
+ *         has been rejected and freed.
  */
 
-int req_quejob(
+static int queue_new_job(
 
-  batch_request *preq,
-  int            version)
+  batch_request    *preq,
+  int               version,
+  job             **submitted,
+  submit_template  *ptemplate)
 
   {
   int                   created_here = 0;
@@ -1775,7 +1844,25 @@ int req_quejob(
 
   mutex_mgr job_mutex(pj->ji_mutex, true);
   std::string  cpuClock = "";
-  rc = decode_attributes_into_job(pj, resc_access_perm, preq, job_mutex, pque, cpuClock);
+
+  if (ptemplate != NULL)
+    {
+    for (int i = 0; i < JOB_ATR_LAST; i++)
+      {
+      if (ptemplate->st_job->ji_wattr[i].at_flags & ATR_VFLAG_SET)
+        {
+        job_attr_def[i].at_set(
+          &pj->ji_wattr[i],
+          &ptemplate->st_job->ji_wattr[i],
+          SET);
+        }
+      }
+
+    pj->ji_have_nodes_request = ptemplate->st_job->ji_have_nodes_request;
+    cpuClock = ptemplate->st_cpuclock;
+    }
+
+  rc = decode_attributes_into_job(pj, resc_access_perm, preq, job_mutex, pque, cpuClock, ptemplate != NULL);
 
   if (rc != PBSE_NONE)
     return(rc);
@@ -1918,6 +2005,15 @@ int req_quejob(
   /* link job into server's new jobs list request  */
   insert_job(&newjobs,pj);
 
+  if (submitted != NULL)
+    {
+    /* the caller commits the job and replies */
+    *submitted = pj;
+    job_mutex.set_unlock_on_exit(false);
+
+    return(PBSE_NONE);
+    }
+
   if ((version > 1) &&
       (pj->ji_wattr[JOB_ATR_interactive].at_val.at_long))
     {
@@ -1949,6 +2045,28 @@ int req_quejob(
     }
 
   return(rc);
+  }  /* END queue_new_job() */
+
+
+
+/*
+ * req_quejob - Queue Job Batch Request processing routine
+ *
+ * @param preq - the batch request that contains the job's information
+ * @param version - Tells us what version of queue job this is. Right now the 
+ *                  options are 1 and 2. If it's version 2 and we are interactive,
+ *                  then we should do the commit
+ * @return PBSE_NONE on success, otherwise a PBSE_* error code
+ *
+ */
+
+int req_quejob(
+
+  batch_request *preq,
+  int            version)
+
+  {
+  return(queue_new_job(preq, version, NULL, NULL));
   }  /* END req_quejob() */
 
 
@@ -1992,6 +2110,79 @@ int req_jobcredential(
 
 
 
+/*
+ * append_job_script - append a section of a new job's script to its script file
+ *
+ * @return PBSE_NONE on success, otherwise a PBSE_* error code with the reason in log_buf
+ */
+
+static int append_job_script(
+
+  job        *pj,
+  const char *data,
+  long        size,
+  bool        sync_write, /* false if the caller flushes the script itself */
+  char       *log_buf,
+  size_t      buf_len)
+
+  {
+  int         fds;
+  char        namebuf[MAXPATHLEN];
+  int         filemode = 0600;
+  int         sync_flag = (sync_write == true) ? O_Sync : 0;
+  std::string adjusted_path_jobs;
+
+  // get adjusted path_jobs path
+  adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
+  snprintf(namebuf, sizeof(namebuf), "%s%s%s", adjusted_path_jobs.c_str(),
+    pj->ji_qs.ji_fileprefix, JOB_SCRIPT_SUFFIX);
+
+  if (pj->ji_qs.ji_un.ji_newt.ji_scriptsz == 0)
+    {
+    /* NOTE:  fail is job script already exists */
+
+    fds = open(namebuf, O_WRONLY | O_CREAT | O_EXCL | sync_flag, filemode);
+    }
+  else
+    {
+    fds = open(namebuf, O_WRONLY | O_APPEND | sync_flag, filemode);
+    }
+
+  if (fds < 0)
+    {
+    snprintf(log_buf, buf_len, "cannot open '%s' errno=%d - %s (%s)",
+             namebuf,
+             errno,
+             strerror(errno),
+             msg_script_open);
+    return(PBSE_CAN_NOT_OPEN_FILE);
+    }
+
+  if (write_ac_socket(fds, data, (unsigned)size) != size)
+    {
+    snprintf(log_buf, buf_len, "cannot write to file %s (%d-%s) %s",
+        namebuf,
+        errno,
+        strerror(errno),
+        msg_script_write);
+    close(fds);
+    return(PBSE_CAN_NOT_WRITE_FILE);
+    }
+
+  close(fds);
+
+  pj->ji_qs.ji_un.ji_newt.ji_scriptsz += size;
+
+  /* job has a script file */
+
+  pj->ji_qs.ji_svrflags =
+    (pj->ji_qs.ji_svrflags & ~JOB_SVFLG_CHECKPOINT_FILE) | JOB_SVFLG_SCRIPT;
+
+  return(PBSE_NONE);
+  }  /* END append_job_script() */
+
+
+
 /*
  * req_jobscript - receive job script section
  *
@@ -2004,13 +2195,9 @@ int req_jobscript(
   bool           perform_commit)
 
   {
-  int   fds;
-  char  namebuf[MAXPATHLEN];
   job  *pj;
-  int   filemode = 0600;
   char  log_buf[LOCAL_LOG_BUF_SIZE];
   int   rc = PBSE_NONE;
-  std::string adjusted_path_jobs;
 
   errno = 0;
 
@@ -2065,73 +2252,380 @@ int req_jobscript(
     return rc;
     }
 
-  // get adjusted path_jobs path
-  adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
-  snprintf(namebuf, sizeof(namebuf), "%s%s%s", adjusted_path_jobs.c_str(),
-    pj->ji_qs.ji_fileprefix, JOB_SCRIPT_SUFFIX);
+  if ((rc = append_job_script(pj, preq->rq_ind.rq_jobfile.rq_data, preq->rq_ind.rq_jobfile.rq_size,
+                              true, log_buf, sizeof(log_buf))) != PBSE_NONE)
+    {
+    log_err(rc, __func__, log_buf);
+    req_reject((rc == PBSE_CAN_NOT_WRITE_FILE) ? PBSE_INTERNAL : rc, 0, preq, NULL, log_buf);
+    return(rc);
+    }
 
-  if (pj->ji_qs.ji_un.ji_newt.ji_scriptsz == 0)
+  /* SUCCESS */
+  if (perform_commit == true)
     {
-    /* NOTE:  fail is job script already exists */
+    // On error, preq has been replied to and freed
+    if ((rc = perform_commit_work(preq, pj, 2)) != PBSE_NONE)
+      return(rc);
+    }
+    
+  reply_ack(preq);
+
+  return(rc);
+  }  /* END req_jobscript() */
+
+
+
+/*
+ * req_submitjob - create, write the script of and commit a job in one request
+ *
+ * The job is only committed once its script is safely on disk, so a failure
+ * at any step leaves nothing behind. On error preq has been rejected and freed.
+ */
+
+int req_submitjob(
+
+  batch_request *preq)
+
+  {
+  job                 *pj = NULL;
+  struct rq_submitjob *psubmit = &preq->rq_ind.rq_submitjob;
+  char                 log_buf[LOCAL_LOG_BUF_SIZE];
+  char                 jobid[PBS_MAXSVRJOBID + 1];
+  int                  rc;
+
+  // On failure, the request has been replied to and freed
+  if ((rc = queue_new_job(preq, 2, &pj, NULL)) != PBSE_NONE)
+    return(rc);
+
+  mutex_mgr job_mutex(pj->ji_mutex, true);
+
+  if (psubmit->rq_script_size > 0)
+    {
+    if ((rc = append_job_script(pj, psubmit->rq_script, psubmit->rq_script_size,
+                                true, log_buf, sizeof(log_buf))) != PBSE_NONE)
+      {
+      log_err(rc, __func__, log_buf);
+      remove_job(&newjobs, pj);
+      svr_job_purge(pj);
+      job_mutex.set_unlock_on_exit(false);
+      req_reject((rc == PBSE_CAN_NOT_WRITE_FILE) ? PBSE_INTERNAL : rc, 0, preq, NULL, log_buf);
+      return(rc);
+      }
+    }
+
+  snprintf(jobid, sizeof(jobid), "%s", pj->ji_qs.ji_jobid);
+
+  // On error, preq has been replied to and freed
+  if ((rc = perform_commit_work(preq, pj, 2)) != PBSE_NONE)
+    return(rc);
+
+  reply_jobid(preq, jobid, BATCH_REPLY_CHOICE_Queue);
+
+  return(PBSE_NONE);
+  }  /* END req_submitjob() */
+
+
+
+/*
+ * sync_job_files - flush the job files written without O_Sync in one go
+ *
+ * syncfs() flushes the jobs file system in one call. Without it each file
+ * and the directories holding them are flushed in turn.
+ */
+
+static void sync_job_files(
+
+  std::vector<std::string> &files)
+
+  {
+  std::set<std::string> dirs;
+  int                   fd;
 
-    fds = open(namebuf, O_WRONLY | O_CREAT | O_EXCL | O_Sync, filemode);
+  if (O_Sync == 0)
+    {
+    /* file syncing is disabled */
+    return;
     }
-  else
+
+#ifdef HAVE_SYNCFS
+  if ((fd = open(path_jobs, O_RDONLY)) >= 0)
     {
-    fds = open(namebuf, O_WRONLY | O_APPEND | O_Sync, filemode);
+    syncfs(fd);
+    close(fd);
+
+    return;
     }
+#endif /* HAVE_SYNCFS */
 
-  if (fds < 0)
+  for (unsigned int i = 0; i < files.size(); i++)
     {
-    rc = PBSE_CAN_NOT_OPEN_FILE;
-    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "cannot open '%s' errno=%d - %s (%s)",
-             namebuf,
-             errno,
-             strerror(errno),
-             msg_script_open);
-    log_err(rc, __func__, log_buf);
-    req_reject(rc, 0, preq, NULL, log_buf);
-    return rc;
+    if ((fd = open(files[i].c_str(), O_RDONLY)) >= 0)
+      {
+      fsync(fd);
+      close(fd);
+      }
+
+    dirs.insert(files[i].substr(0, files[i].rfind('/') + 1));
     }
 
-  if (write_ac_socket(
-        fds,
-        preq->rq_ind.rq_jobfile.rq_data,
-        (unsigned)preq->rq_ind.rq_jobfile.rq_size) != preq->rq_ind.rq_jobfile.rq_size)
+  /* the new files' directory entries */
+  for (std::set<std::string>::iterator it = dirs.begin(); it != dirs.end(); it++)
     {
-    rc = PBSE_CAN_NOT_WRITE_FILE;
-    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "cannot write to file %s (%d-%s) %s",
-        namebuf,
-        errno,
-        strerror(errno),
-        msg_script_write);
-    log_err(rc, __func__, log_buf);
-    req_reject(PBSE_INTERNAL, 0, preq, NULL, log_buf);
-    close(fds);
-    return rc;
+    if ((fd = open(it->c_str(), O_RDONLY)) >= 0)
+      {
+      fsync(fd);
+      close(fd);
+      }
     }
+  }  /* END sync_job_files() */
 
-  close(fds);
 
-  pj->ji_qs.ji_un.ji_newt.ji_scriptsz += preq->rq_ind.rq_jobfile.rq_size;
 
-  /* job has a script file */
+/*
+ * copy_submit_attr - copy a SubmitJobs attribute
+ */
 
-  pj->ji_qs.ji_svrflags =
-    (pj->ji_qs.ji_svrflags & ~JOB_SVFLG_CHECKPOINT_FILE) | JOB_SVFLG_SCRIPT;
+static svrattrl *copy_submit_attr(
 
-  /* SUCCESS */
-  if (perform_commit == true)
+  svrattrl *pal)
+
+  {
+  svrattrl *pnew;
+
+  if ((pnew = attrlist_create(pal->al_name, pal->al_resc, pal->al_valln)) == NULL)
+    return(NULL);
+
+  if (pal->al_value != NULL)
+    strcpy(pnew->al_value, pal->al_value);
+
+  pnew->al_op = pal->al_op;
+  pnew->al_flags = pal->al_flags;
+
+  return(pnew);
+  }  /* END copy_submit_attr() */
+
+
+
+/*
+ * free_submit_template - free the job holding a SubmitJobs request's shared attributes
+ */
+
+static void free_submit_template(
+
+  submit_template *ptemplate)
+
+  {
+  job *pj = ptemplate->st_job;
+
+  /* it was never queued, so nothing else can be waiting on it */
+  unlock_ji_mutex(pj, __func__, NULL, LOGLEVEL);
+  delete pj;
+
+  ptemplate->st_job = NULL;
+  }  /* END free_submit_template() */
+
+
+
+/*
+ * decode_submit_template - decode and check a SubmitJobs request's shared attributes
+ *
+ * A bad shared attribute would fail every job, so preq is rejected for it the
+ * way a SubmitJob with that attribute would be.
+ *
+ * @return PBSE_NONE on success, otherwise a PBSE_* error code. On failure preq
+ *         has been rejected and freed.
+ */
+
+static int decode_submit_template(
+
+  batch_request   *preq,      /* I */
+  submit_template *ptemplate) /* O */
+
+  {
+  struct rq_submitjob *psubmit = &preq->rq_ind.rq_submitjobs.rq_template;
+  int                  resc_access_perm = ATR_DFLAG_USWR | ATR_DFLAG_Creat;
+  int                  rc = PBSE_NONE;
+  svrattrl            *bad_attr = NULL;
+  pbs_queue           *pque;
+  std::string          no_jobid;
+
+  if (preq->rq_fromsvr)
+    resc_access_perm |= ATR_DFLAG_MGWR | ATR_DFLAG_SvWR;
+
+  if ((pque = get_queue_for_job(psubmit->rq_job.rq_destin, rc)) == NULL)
     {
-    // On error, preq has been replied to and freed
-    if ((rc = perform_commit_work(preq, pj, 2)) != PBSE_NONE)
-      return(rc);
+    req_reject(rc, 0, preq, NULL, "requested queue not found");
+    return(rc);
     }
-    
-  reply_ack(preq);
 
-  return(rc);
-  }  /* END req_jobscript() */
+  mutex_mgr que_mgr(pque->qu_mutex, true);
+  que_mgr.unlock();
+
+  if ((ptemplate->st_job = create_and_initialize_job_structure(0, no_jobid)) == NULL)
+    {
+    req_reject(PBSE_SYSTEM, 0, preq, NULL, "");
+    return(PBSE_SYSTEM);
+    }
+
+  rc = decode_attribute_list(ptemplate->st_job, resc_access_perm, &psubmit->rq_job.rq_attr, pque,
+                             ptemplate->st_cpuclock, false, &bad_attr);
+
+  if (bad_attr != NULL)
+    {
+    free_submit_template(ptemplate);
+    reply_badattr(rc, 1, bad_attr, preq);
+    return(rc);
+    }
+
+  return(PBSE_NONE);
+  }  /* END decode_submit_template() */
+
+
+
+/*
+ * req_submitjobs - create and commit many jobs from one SubmitJobs request
+ *
+ * The shared attributes are decoded and checked once. Each job is then queued
+ * as a SubmitJob request of its own, starting from those attributes and
+ * decoding only its overrides. The scripts and job files are written without
+ * syncing and flushed together before the reply. The reply has a "code jobid"
+ * line for each job, in order, with "-" for a rejected job's id.
+ */
+
+int req_submitjobs(
+
+  batch_request *preq)
+
+  {
+  struct rq_submitjobs         *psubmits = &preq->rq_ind.rq_submitjobs;
+  struct rq_submitjob          *ptemplate = &psubmits->rq_template;
+  std::vector<batch_request *>  subs(psubmits->rq_count, NULL);
+  std::vector<std::string>      jobids(psubmits->rq_count);
+  std::vector<int>              codes(psubmits->rq_count, PBSE_NONE);
+  std::vector<std::string>      written;
+  std::string                   results;
+  std::string                   adjusted_path_jobs;
+  submit_template               shared;
+  char                          log_buf[LOCAL_LOG_BUF_SIZE];
+  char                          line[PBS_MAXSVRJOBID + 32];
+  batch_request                *sub;
+  svrattrl                     *pal;
+  svrattrl                     *pnew;
+  job                          *pj;
+  int                           rc;
+  int                           i;
+
+  // On failure, preq has been replied to and freed
+  if ((rc = decode_submit_template(preq, &shared)) != PBSE_NONE)
+    return(rc);
+
+  /* queue every job and write its script */
+  for (i = 0; i < psubmits->rq_count; i++)
+    {
+    if ((sub = alloc_br(PBS_BATCH_SubmitJob)) == NULL)
+      {
+      codes[i] = PBSE_SYSTEM;
+      continue;
+      }
+
+    sub->rq_perm = preq->rq_perm;
+    sub->rq_fromsvr = preq->rq_fromsvr;
+    sub->rq_conn = preq->rq_conn;
+    sub->rq_time = preq->rq_time;
+    sub->rq_noreply = TRUE; /* the results go back in preq's reply */
+    strcpy(sub->rq_user, preq->rq_user);
+    strcpy(sub->rq_host, preq->rq_host);
+
+    CLEAR_HEAD(sub->rq_ind.rq_submitjob.rq_job.rq_attr);
+    strcpy(sub->rq_ind.rq_submitjob.rq_job.rq_destin, ptemplate->rq_job.rq_destin);
+
+    for (pal = (svrattrl *)GET_NEXT(psubmits->rq_overrides[i]);
+         pal != NULL;
+         pal = (svrattrl *)GET_NEXT(pal->al_link))
+      {
+      if ((pnew = copy_submit_attr(pal)) == NULL)
+        {
+        codes[i] = PBSE_SYSTEM;
+        break;
+        }
+
+      append_link(&sub->rq_ind.rq_submitjob.rq_job.rq_attr, &pnew->al_link, pnew);
+      }
+
+    if (codes[i] != PBSE_NONE)
+      {
+      free_br(sub);
+      continue;
+      }
+
+    // On failure, sub has been freed
+    if ((codes[i] = queue_new_job(sub, 2, &pj, &shared)) != PBSE_NONE)
+      continue;
+
+    if ((ptemplate->rq_script_size > 0) &&
+        ((codes[i] = append_job_script(pj, ptemplate->rq_script, ptemplate->rq_script_size,
+                                       false, log_buf, sizeof(log_buf))) != PBSE_NONE))
+      {
+      log_err(codes[i], __func__, log_buf);
+      remove_job(&newjobs, pj);
+      svr_job_purge(pj);
+      free_br(sub);
+      continue;
+      }
+
+    jobids[i] = pj->ji_qs.ji_jobid;
+    subs[i] = sub;
+
+    unlock_ji_mutex(pj, __func__, NULL, LOGLEVEL);
+    }
+
+  free_submit_template(&shared);
+
+  /* now commit them */
+  for (i = 0; i < psubmits->rq_count; i++)
+    {
+    if (subs[i] == NULL)
+      continue;
+
+    if ((pj = locate_new_job((char *)jobids[i].c_str())) == NULL)
+      {
+      codes[i] = PBSE_UNKJOBID;
+      free_br(subs[i]);
+      continue;
+      }
+
+    mutex_mgr job_mutex(pj->ji_mutex, true);
+
+    adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
+    adjusted_path_jobs += pj->ji_qs.ji_fileprefix;
+
+    // On error, subs[i] has been replied to and freed
+    if ((codes[i] = perform_commit_work(subs[i], pj, 2)) != PBSE_NONE)
+      continue;
+
+    written.push_back(adjusted_path_jobs + JOB_SCRIPT_SUFFIX);
+    written.push_back(adjusted_path_jobs +
+      ((pj->ji_is_array_template == true) ? JOB_FILE_TMP_SUFFIX : JOB_FILE_SUFFIX));
+
+    free_br(subs[i]);
+    }
+
+  /* one flush for every job's script and job file */
+  sync_job_files(written);
+
+  for (i = 0; i < psubmits->rq_count; i++)
+    {
+    snprintf(line, sizeof(line), "%d %s\n",
+      codes[i],
+      (codes[i] == PBSE_NONE) ? jobids[i].c_str() : "-");
+
+    results += line;
+    }
+
+  reply_text(preq, PBSE_NONE, results.c_str());
+
+  return(PBSE_NONE);
+  }  /* END req_submitjobs() */
 
 
 
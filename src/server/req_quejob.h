@@ -12,6 +12,10 @@ int req_jobcredential(struct batch_request *preq);
 
 int req_jobscript(batch_request *preq, bool perform_commit);
 
+int req_submitjob(batch_request *preq);
+
+int req_submitjobs(batch_request *preq);
+
 int req_mvjobfile(struct batch_request *preq);
 
 int req_rdytocommit(struct batch_request *preq);
@@ -107,6 +107,8 @@
 #include "mutex_mgr.hpp"
 #include "utils.h"
 #include "job_func.h"
+#include "dependency_graph.hpp"
+#include "req_register.h"
 
 
 #define SYNC_SCHED_HINT_NULL 0
@@ -147,6 +149,10 @@ int    release_cheapest(job *, struct depend *);
 int    send_depend_req(job *, depend_job *pparent, int, int, int, void (*postfunc)(batch_request *),bool bAsyncOk);
 depend_job *alloc_dependjob(const char *jobid);
 
+/* Global Data Items */
+
+dependency_graph depend_graph;
+
 /* External Global Data Items */
 
 extern struct server server;
@@ -428,6 +434,12 @@ int register_dependency(
     case JOB_DEPEND_TYPE_AFTERNOTOK:
       
       rc = register_dep(&pjob->ji_wattr[JOB_ATR_depend], preq, type, &made);
+
+      /* index dependents on this server so depend_on_term() can release them directly */
+      if ((rc == PBSE_NONE) &&
+          (made) &&
+          (!strcmp(preq->rq_ind.rq_register.rq_svr, server_name)))
+        depend_graph.add_edge(pjob->ji_qs.ji_jobid, preq->rq_ind.rq_register.rq_child, type);
       
       break;
 
@@ -457,11 +469,51 @@ int register_dependency(
 
 
 
-int release_before_dependency(
+/*
+ * has_pending_after_depend()
+ *
+ * @return true if pjob still waits on another job through an after* dependency
+ */
 
-  batch_request *preq,
-  job           *pjob,
-  int            type)
+bool has_pending_after_depend(
+
+  pbs_attribute *pattr)
+
+  {
+  struct depend *pdep = (struct depend *)GET_NEXT(pattr->at_val.at_list);
+
+  while (pdep != NULL)
+    {
+    if ((pdep->dp_type >= JOB_DEPEND_TYPE_AFTERSTART) &&
+        (pdep->dp_type <= JOB_DEPEND_TYPE_AFTERANY) &&
+        (pdep->dp_jobs.size() > 0))
+      return(true);
+
+    pdep = (struct depend *)GET_NEXT(pdep->dp_link);
+    }
+
+  return(false);
+  } /* END has_pending_after_depend() */
+
+
+
+
+/*
+ * release_dependent_job()
+ *
+ * job_id sent release-reduce "on"; removes it from pjob's dependency and
+ * sees if pjob can now run
+ *
+ * @param job_id - the job releasing pjob
+ * @param pjob - the dependent job, locked
+ * @param type - the JOB_DEPEND_TYPE_BEFORE* type job_id has for pjob
+ */
+
+int release_dependent_job(
+
+  const char *job_id,
+  job        *pjob,
+  int         type)
  
   {
   int                rc = PBSE_NONE;
@@ -469,28 +521,31 @@ int release_before_dependency(
   struct depend     *pdep = NULL;
   depend_job        *pdj = NULL;
   char               log_buf[LOCAL_LOG_BUF_SIZE];
-  /*char               job_id[PBS_MAXSVRJOBID+1];*/
- 
-  /* predecessor sent release-reduce "on", */
-  /* see if this job can now run    */
   
   type ^= (JOB_DEPEND_TYPE_BEFORESTART - JOB_DEPEND_TYPE_AFTERSTART);
   
   if ((pdep = find_depend(type, pattr)))
     {
-    if ((pdj = find_dependjob(pdep, preq->rq_ind.rq_register.rq_child)))
+    if ((pdj = find_dependjob(pdep, job_id)))
       {
+      int left;
+
       del_depend_job(pdep, pdj);
+
+      left = depend_graph.satisfy_edge(job_id, pjob->ji_qs.ji_jobid);
       
-      sprintf(log_buf, msg_registerrel, preq->rq_ind.rq_register.rq_child);
+      sprintf(log_buf, msg_registerrel, job_id);
       log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,pjob->ji_qs.ji_jobid,log_buf);
       
       if (pdep->dp_jobs.size() == 0)
         {
         /* no more dependencies of this type */
         delete pdep;
-        
-        set_depend_hold(pjob, pattr, NULL);
+
+        /* skip re-checking every dependency while the job is known to still wait */
+        if ((left <= 0) ||
+            (has_pending_after_depend(pattr) == false))
+          set_depend_hold(pjob, pattr, NULL);
         }
       
       return(rc);
@@ -500,6 +555,19 @@ int release_before_dependency(
   rc = PBSE_IVALREQ;
  
   return(rc);
+  } /* END release_dependent_job() */
+
+
+
+
+int release_before_dependency(
+
+  batch_request *preq,
+  job           *pjob,
+  int            type)
+ 
+  {
+  return(release_dependent_job(preq->rq_ind.rq_register.rq_child, pjob, type));
   } /* END release_before_dependency() */
 
 
@@ -624,19 +692,21 @@ int ready_dependency(
 
 
 /*
- * delete_dependency_job()
+ * delete_dependent_job()
  *
  * Deletes the dependent job. We are here because the dependency can never be satisfied.
- * @param preq - the batch request specifying the request
- * @param pjob_ptr - a pointer to a pointer to the job
+ * @param job_id - the job whose dependency can't be satisfied
+ * @param dependent_id - the id the dependent job was registered with
+ * @param pjob_ptr - a pointer to a pointer to the dependent job
  * @return PBSE_NONE on success or PBSE_IVALREQ if a job is detected to be dependent on
  * itself.
  */
 
-int delete_dependency_job(
+int delete_dependent_job(
  
-  batch_request *preq,
-  job           **pjob_ptr)
+  const char  *job_id,
+  const char  *dependent_id,
+  job        **pjob_ptr)
  
   {
   job *pjob = *pjob_ptr;
@@ -644,8 +714,7 @@ int delete_dependency_job(
   char log_buf[LOCAL_LOG_BUF_SIZE];
   
   // Do not take action for a job depending on itself.
-  if (!strcmp(preq->rq_ind.rq_register.rq_parent,
-        preq->rq_ind.rq_register.rq_child))
+  if (!strcmp(dependent_id, job_id))
     {
     rc = PBSE_IVALREQ; /* prevent an infinite loop */
     }
@@ -654,7 +723,7 @@ int delete_dependency_job(
   else if ((pjob->ji_qs.ji_state < JOB_STATE_EXITING) &&
            (pjob->ji_qs.ji_state != JOB_STATE_RUNNING))
     {
-    sprintf(log_buf, msg_registerdel, preq->rq_ind.rq_register.rq_child);
+    sprintf(log_buf, msg_registerdel, job_id);
     log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buf);
     
     /* pjob freed and set to NULL */
@@ -662,6 +731,19 @@ int delete_dependency_job(
     }
 
   return(rc);
+  } /* END delete_dependent_job() */
+
+
+
+int delete_dependency_job(
+ 
+  batch_request *preq,
+  job           **pjob_ptr)
+ 
+  {
+  return(delete_dependent_job(preq->rq_ind.rq_register.rq_child,
+                              preq->rq_ind.rq_register.rq_parent,
+                              pjob_ptr));
   } /* END delete_dependency_job() */
 
 
@@ -699,7 +781,8 @@ int unregister_dependency(
     }
   else
     {
-    unregister_dep(pattr, preq);
+    if (unregister_dep(pattr, preq) == PBSE_NONE)
+      depend_graph.remove_edge(pjob->ji_qs.ji_jobid, preq->rq_ind.rq_register.rq_child);
     }
   
   set_depend_hold(pjob, pattr, NULL);
@@ -1663,6 +1746,68 @@ int depend_on_exec(
 
 
 
+/*
+ * release_local_dependents()
+ *
+ * Applies the releases and deletes depend_on_term() decided on to dependents on
+ * this server, doing for each what req_register() does for the request
+ * send_depend_req() would have built. pjob is unlocked once for all of them
+ * rather than once per dependent.
+ *
+ * @param pjob - the job that terminated, locked
+ * @param ops - the dependents and what to do to each
+ * @return PBSE_NONE, or PBSE_JOBNOTFOUND if pjob went away while it was unlocked
+ */
+
+int release_local_dependents(
+
+  job                          *pjob,
+  std::vector<local_depend_op> &ops)
+
+  {
+  std::string job_id(pjob->ji_qs.ji_jobid);
+
+  unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+
+  for (size_t i = 0; i < ops.size(); i++)
+    {
+    job *pdep_job = svr_find_job(ops[i].ldo_job.c_str(), TRUE);
+    int  rc = PBSE_NONE;
+
+    if (pdep_job == NULL)
+      continue;
+
+    try
+      {
+      if (ops[i].ldo_op == JOB_DEPEND_OP_RELEASE)
+        rc = release_dependent_job(job_id.c_str(), pdep_job, ops[i].ldo_type);
+      else
+        rc = delete_dependent_job(job_id.c_str(), ops[i].ldo_job.c_str(), &pdep_job);
+      }
+    catch (int pbs_errcode)
+      {
+      if (pbs_errcode == PBSE_JOBNOTFOUND)
+        continue;
+      }
+
+    if (pdep_job != NULL)
+      {
+      if (rc == PBSE_NONE)
+        job_save(pdep_job, SAVEJOB_FULL, 0);
+
+      unlock_ji_mutex(pdep_job, __func__, "2", LOGLEVEL);
+      }
+    }
+
+  if (svr_find_job(job_id.c_str(), TRUE) == NULL)
+    return(PBSE_JOBNOTFOUND);
+
+  return(PBSE_NONE);
+  } /* END release_local_dependents() */
+
+
+
+
 /* depend_on_term - Perform actions if job has "afterany, afterok, afternotok"
  * dependencies, send "register-release" or register-delete" as
  * appropriate.
@@ -1688,6 +1833,8 @@ int depend_on_term(
   int                shouldkill = 0;
   int                type;
 
+  std::vector<local_depend_op> local_ops;
+
   if (pjob == NULL)
     return(PBSE_BAD_PARAMETER);
  
@@ -1785,6 +1932,19 @@ int depend_on_term(
         {
         pparent = pdep->dp_jobs[i];
 
+        /* dependents indexed on this server are handled below without a request */
+        if (depend_graph.has_edge(pjob->ji_qs.ji_jobid, pparent->dc_child.c_str()))
+          {
+          local_depend_op lop;
+
+          lop.ldo_job = pparent->dc_child;
+          lop.ldo_type = type;
+          lop.ldo_op = op;
+          local_ops.push_back(lop);
+
+          continue;
+          }
+
         /* "release" the job to execute */
         if ((rc = send_depend_req(pjob, pparent, type, op, SYNC_SCHED_HINT_NULL, free_br,true)) != PBSE_NONE)
           {
@@ -1796,6 +1956,9 @@ int depend_on_term(
     pdep = (struct depend *)GET_NEXT(pdep->dp_link);
     } /* END loop over each dependency */
 
+  if (local_ops.size() > 0)
+    return(release_local_dependents(pjob, local_ops));
+
   return(PBSE_NONE);
   }  /* END depend_on_term() */
 
@@ -3368,6 +3531,7 @@ void removeAfterAnyDependency(
     if (pDepJob != NULL)
       {
       del_depend_job(pDep, pDepJob);
+      depend_graph.remove_edge(pTargetJobID, pJId);
 
       try
         {
@@ -8,6 +8,17 @@
 #include "pbs_job.h" /* job */
 #include "list_link.h" /* tlist_head */
 
+#include <string>
+#include <vector>
+
+/* a release or delete depend_on_term() applies to a job on this server */
+typedef struct local_depend_op
+  {
+  std::string ldo_job;
+  int         ldo_type;
+  int         ldo_op;
+  } local_depend_op;
+
 int req_register(struct batch_request *preq);
 
 int req_registerarray(struct batch_request *preq);
@@ -120,6 +120,7 @@
 #include "../lib/Libnet/lib_net.h"
 #include "complete_req.hpp"
 #include "policy_values.h"
+#include "event_trace.h"
 
 #ifdef HAVE_NETINET_IN_H
 #include <netinet/in.h>
@@ -1476,6 +1477,8 @@ void finish_sendmom(
       
       /* record start time for accounting */      
       pjob->ji_qs.ji_stime = time_now;
+
+      trace_event(TRACE_JOB_RUN, pjob->ji_qs.ji_jobid, trace_elapsed(pjob->ji_wattr[JOB_ATR_qtime].at_val.at_long), 0);
       
       /* update resource usage attributes */        
       set_resc_assigned(pjob, INCR);
@@ -92,6 +92,7 @@
 #include "libpbs.h"
 #include <ctype.h>
 #include <stdint.h>
+#include <sstream>
 #include "server_limits.h"
 #include "list_link.h"
 #include "attribute.h"
@@ -122,6 +123,8 @@
 #include "unistd.h"
 #include "log.h"
 #include "job_func.h"
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 
 /* Global Data Items: */
 
@@ -144,6 +147,9 @@ extern pthread_mutex_t *netrates_mutex;
 
 int status_job(job *, struct batch_request *, svrattrl *, tlist_head *, bool, int *);
 int status_attrib(svrattrl *, attribute_def *, pbs_attribute *, int, int, tlist_head *, bool, int *, int);
+int status_completed_job(const char *, struct batch_request *, svrattrl *, tlist_head *, bool, int *);
+int status_completed_jobs(const char *, struct batch_request *, svrattrl *, tlist_head *, bool, int *);
+int status_history_job(const char *, struct batch_request *, svrattrl *, tlist_head *, int *);
 extern int  status_nodeattrib(svrattrl *, attribute_def *, struct pbsnode *, int, int, tlist_head *, int*);
 extern void rel_resc(job*);
 
@@ -175,6 +181,94 @@ enum TJobStatTypeEnum
 
 
 
+/*
+ * req_stat_history()
+ *
+ * Answers a job status request with the JOBHISTORY extension from the job
+ * history instead of the job table.
+ * FORMAT:  history[:user=<USER>][:since=<EPOCH>][:until=<EPOCH>]
+ * The request's id is a job id, a queue name, or empty for the whole server.
+ *
+ * @param preq - the status request
+ * @return PBSE_NONE if the reply was sent, or the error the request was rejected with
+ */
+
+int req_stat_history(
+
+  struct batch_request *preq)
+
+  {
+  char                     *name = preq->rq_ind.rq_status.rq_id;
+  svrattrl                 *pal = (svrattrl *)GET_NEXT(preq->rq_ind.rq_status.rq_attr);
+  struct batch_reply       *preply = &preq->rq_reply;
+  std::stringstream         extend(preq->rq_extend + strlen(JOBHISTORY));
+  std::string               option;
+  std::string               user;
+  time_t                    since = 0;
+  time_t                    until = 0;
+  std::vector<std::string>  ids;
+  int                       bad = 0;
+  int                       rc = PBSE_NONE;
+
+  if (job_hist.is_open() == false)
+    {
+    req_reject(PBSE_NOSUP, 0, preq, NULL, "the job history is not being recorded");
+    return(PBSE_NOSUP);
+    }
+
+  while (std::getline(extend, option, ':'))
+    {
+    if (option.compare(0, strlen("user="), "user=") == 0)
+      user = option.substr(strlen("user="));
+    else if (option.compare(0, strlen("since="), "since=") == 0)
+      since = strtol(option.c_str() + strlen("since="), NULL, 10);
+    else if (option.compare(0, strlen("until="), "until=") == 0)
+      until = strtol(option.c_str() + strlen("until="), NULL, 10);
+    }
+
+  set_reply_type(preply, BATCH_REPLY_CHOICE_Status);
+
+  CLEAR_HEAD(preply->brp_un.brp_status);
+
+  if (isdigit((int)*name))
+    {
+    rc = status_history_job(name, preq, pal, &preply->brp_un.brp_status, &bad);
+    }
+  else
+    {
+    job_hist.find_jobs((user.size() != 0) ? user.c_str() : NULL,
+      isalpha((int)*name) ? name : NULL,
+      since,
+      until,
+      ids);
+
+    for (size_t i = 0; i < ids.size(); i++)
+      {
+      rc = status_history_job(ids[i].c_str(), preq, pal, &preply->brp_un.brp_status, &bad);
+
+      /* skip jobs the requestor may not see or that expired meanwhile */
+      if ((rc == PBSE_PERM) ||
+          (rc == PBSE_UNKJOBID))
+        rc = PBSE_NONE;
+      else if (rc != PBSE_NONE)
+        break;
+      }
+    }
+
+  if (rc != PBSE_NONE)
+    {
+    req_reject(rc, bad, preq, NULL, NULL);
+    return(rc);
+    }
+
+  reply_send_svr(preq);
+
+  return(PBSE_NONE);
+  }  /* END req_stat_history() */
+
+
+
+
 /**
  * req_stat_job - service the Status Job Request
  *
@@ -215,6 +309,13 @@ int req_stat_job(
 
   name = preq->rq_ind.rq_status.rq_id;
 
+  if ((preq->rq_extend != NULL) &&
+      (!strncmp(preq->rq_extend, JOBHISTORY, strlen(JOBHISTORY))))
+    {
+    /* finished jobs come from the job history, not the job table */
+    return(req_stat_history(preq));
+    }
+
   if (preq->rq_extend != NULL)
     {
     /* evaluate pbs_job_stat() 'extension' field */
@@ -254,7 +355,9 @@ int req_stat_job(
 
       if ((pjob = svr_find_job(name, FALSE)) == NULL)
         {
-        rc = PBSE_UNKJOBID;
+        /* a compacted completed job is still reported */
+        if (completed_store.has_job(name) == false)
+          rc = PBSE_UNKJOBID;
         }
       else
         unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
@@ -428,6 +531,18 @@ void handle_truncated_qstat(
         qjcounter++;
       } /* END foreach (pjob from pque) */
 
+    /* compacted completed jobs are never queued, so max_report doesn't apply */
+    int rc = status_completed_jobs(pque->qu_qs.qu_name, preq, pal, &preply->brp_un.brp_status, condensed, &bad);
+
+    if (rc != PBSE_NONE)
+      {
+      req_reject(rc, bad, preq, NULL, NULL);
+
+      delete queue_iter;
+
+      return;
+      }
+
     if (LOGLEVEL >= 5)
       {
       snprintf(log_buf, sizeof(log_buf), "Reported %ld total jobs for queue %s\n",
@@ -508,17 +623,15 @@ job *get_next_status_job(
     pjob = next_job(&array_summary,iter);
   else if (cntl->sc_type == tjstArray)
     {
-    /* increment job_array_index until we find a non-null pointer or hit the end */
-    while (++job_array_index < pa->ai_qs.array_size)
+    /* move job_array_index to the next created sub-job we can find or past the end */
+    while ((job_array_index = pa->next_job_index(job_array_index)) >= 0)
       {
-      if (pa->job_ids[job_array_index] != NULL)
-        {
-        if ((pjob = svr_find_job(pa->job_ids[job_array_index], FALSE)) != NULL)
-          {
-          break;
-          }
-        }
+      if ((pjob = svr_find_job(pa->get_job_id(job_array_index), FALSE)) != NULL)
+        break;
       }
+
+    if (pjob == NULL)
+      job_array_index = pa->ai_qs.array_size;
     }
   else
     pjob = next_job(&alljobs, iter);
@@ -565,6 +678,164 @@ bool in_execution_queue(
 
 
 
+/*
+ * replace_status_value()
+ *
+ * Swaps the value of an attribute in a status reply for value
+ */
+
+void replace_status_value(
+
+  svrattrl   *pal,
+  const char *value)
+
+  {
+  svrattrl *new_pal = attrlist_create(pal->al_name, pal->al_resc, strlen(value) + 1);
+
+  if (new_pal == NULL)
+    return;
+
+  strcpy(new_pal->al_value, value);
+  new_pal->al_flags = pal->al_flags;
+  new_pal->al_op = pal->al_op;
+
+  insert_link(&pal->al_link, &new_pal->al_link, new_pal, LINK_INSET_BEFORE);
+  delete_link(&pal->al_link);
+  free(pal);
+  } /* END replace_status_value() */
+
+
+
+/*
+ * make_subjob_status()
+ *
+ * Turns a copy of an array template's status into the status the sub-job at
+ * index would have, making the same changes job_clone() makes to its attributes
+ *
+ * @param pstat - the template's status entry, modified in place
+ * @param index - the sub-job's index in the array
+ */
+
+void make_subjob_status(
+
+  struct brp_status *pstat,
+  int                index)
+
+  {
+  char      id[PBS_MAXSVRJOBID + 1];
+  char      buf[MAXLINE];
+  char     *bracket;
+  char     *close;
+  svrattrl *pal;
+  svrattrl *next;
+
+  snprintf(id, sizeof(id), "%s", pstat->brp_objname);
+
+  if ((bracket = strchr(id, '[')) != NULL)
+    {
+    close = strchr(bracket, ']');
+    *bracket = '\0';
+
+    std::stringstream subjob_id;
+
+    subjob_id << id << "[" << index << "]" << ((close != NULL) ? close + 1 : "");
+
+    /* an id that doesn't fit keeps the template's name rather than a truncated one */
+    if (subjob_id.str().length() < sizeof(pstat->brp_objname))
+      strcpy(pstat->brp_objname, subjob_id.str().c_str());
+    }
+
+  for (pal = (svrattrl *)GET_NEXT(pstat->brp_attr); pal != NULL; pal = next)
+    {
+    next = (svrattrl *)GET_NEXT(pal->al_link);
+
+    if ((!strcmp(pal->al_name, ATTR_N)) ||
+        (!strcmp(pal->al_name, ATTR_o)) ||
+        (!strcmp(pal->al_name, ATTR_e)))
+      {
+      snprintf(buf, sizeof(buf), "%s-%d", pal->al_value, index);
+      replace_status_value(pal, buf);
+      }
+    else if (!strcmp(pal->al_name, ATTR_t))
+      {
+      delete_link(&pal->al_link);
+      free(pal);
+      }
+    }
+
+  snprintf(buf, sizeof(buf), "%d", index);
+
+  if ((pal = attrlist_create(ATTR_array_id, NULL, strlen(buf) + 1)) != NULL)
+    {
+    strcpy(pal->al_value, buf);
+    pal->al_flags = ATR_VFLAG_SET;
+    append_link(&pstat->brp_attr, &pal->al_link, pal);
+    }
+  } /* END make_subjob_status() */
+
+
+
+/*
+ * status_uncreated_subjobs()
+ *
+ * Adds a status entry for each sub-job of pa that hasn't been created yet.
+ * Those sub-jobs only exist as index ranges in the array, so their status
+ * is built from the template job they'll be cloned from.
+ *
+ * @param pa - the array, locked
+ * @return PBSE_NONE or the error from status_job()
+ */
+
+int status_uncreated_subjobs(
+
+  job_array     *pa,
+  batch_request *preq,
+  svrattrl      *pal,
+  bool           condensed,
+  int           *bad)
+
+  {
+  tlist_head *pstatus = &preq->rq_reply.brp_un.brp_status;
+  job        *template_job;
+  int         rc = PBSE_NONE;
+
+  if (pa->uncreated_ids.empty() == true)
+    return(PBSE_NONE);
+
+  if ((template_job = svr_find_job(pa->ai_qs.parent_id, FALSE)) == NULL)
+    return(PBSE_NONE);
+
+  mutex_mgr template_mgr(template_job->ji_mutex, true);
+
+  for (size_t i = 0; i < pa->uncreated_ids.range_count(); i++)
+    {
+    int first;
+    int last;
+
+    pa->uncreated_ids.get_range(i, first, last);
+
+    for (int index = first; index <= last; index++)
+      {
+      struct brp_status *prior = (struct brp_status *)GET_PRIOR(*pstatus);
+
+      rc = status_job(template_job, preq, pal, pstatus, condensed, bad);
+
+      if (rc != PBSE_NONE)
+        return(rc);
+
+      struct brp_status *pstat = (struct brp_status *)GET_PRIOR(*pstatus);
+
+      if ((pstat != NULL) &&
+          (pstat != prior))
+        make_subjob_status(pstat, index);
+      }
+    }
+
+  return(rc);
+  } /* END status_uncreated_subjobs() */
+
+
+
 /*
  * req_stat_job_step2 - continue with statusing of jobs
  *
@@ -632,7 +903,15 @@ void req_stat_job_step2(
       }
     else
       {
-      req_reject(PBSE_JOBNOTFOUND, bad, preq, NULL, NULL);
+      rc = status_completed_job(preq->rq_ind.rq_status.rq_id, preq, pal,
+             &preply->brp_un.brp_status, cntl->sc_condensed, &bad);
+
+      if (rc == PBSE_UNKJOBID)
+        req_reject(PBSE_JOBNOTFOUND, bad, preq, NULL, NULL);
+      else if (rc != PBSE_NONE)
+        req_reject(rc, bad, preq, NULL, NULL);
+      else
+        reply_send_svr(preq);
       }
     }
   else
@@ -694,7 +973,30 @@ void req_stat_job_step2(
 
     if (pa != NULL)
       {
+      rc = status_uncreated_subjobs(pa, preq, pal, cntl->sc_condensed, &bad);
+
       unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
+
+      if ((rc != PBSE_NONE) &&
+          (rc != PBSE_PERM))
+        {
+        req_reject(rc, bad, preq, NULL, NULL);
+        return;
+        }
+      }
+    else if ((type == tjstServer) ||
+             ((type == tjstQueue) &&
+              ((exec_only == false) ||
+               (cntl->sc_pque->qu_qs.qu_type == QTYPE_Execution))))
+      {
+      rc = status_completed_jobs((type == tjstQueue) ? cntl->sc_pque->qu_qs.qu_name : NULL,
+             preq, pal, &preply->brp_un.brp_status, cntl->sc_condensed, &bad);
+
+      if (rc != PBSE_NONE)
+        {
+        req_reject(rc, bad, preq, NULL, NULL);
+        return;
+        }
       }
    
     reply_send_svr(preq);
@@ -96,6 +96,8 @@
 #include "lib_ifl.h" /* get_port_from_server_name_file */
 #include "pbsd_main.h" /* process_pbs_server_port */
 #include "process_request.h" /*process_request */
+#include "sched_event_tracker.hpp"
+#include "run_sched.h"
 
 /* Global Data */
 
@@ -117,6 +119,8 @@ extern struct listener_connection listener_conns[];
 int scheduler_sock;
 int scheduler_jobct;
 int listener_command = SCH_SCHEDULE_NULL;
+
+sched_event_tracker sched_events;
 extern pthread_mutex_t *listener_command_mutex;
 extern pthread_mutex_t *scheduler_sock_jobct_mutex;
 
@@ -154,6 +158,72 @@ const char *PSchedCmdType[] =
 
 
 
+/*
+ * notify_scheduler - record an event which may make a scheduling cycle
+ * worthwhile.  Events are coalesced until the main loop decides a cycle
+ * is due, see sched_event_tracker::claim_cycle().
+ *
+ * event - one of the SCHED_EVENT_* values
+ */
+
+void notify_scheduler(
+
+  int event) /* I */
+
+  {
+  int cmd;
+
+  switch (event)
+    {
+    case SCHED_EVENT_JOB_QUEUED:
+    case SCHED_EVENT_NODE_UP:
+
+      cmd = SCH_SCHEDULE_NEW;
+      break;
+
+    case SCHED_EVENT_JOB_FINISHED:
+
+      cmd = SCH_SCHEDULE_TERM;
+      break;
+
+    case SCHED_EVENT_COMMAND:
+
+      cmd = SCH_SCHEDULE_CMD;
+      break;
+
+    case SCHED_EVENT_TIMER:
+
+      cmd = SCH_SCHEDULE_TIME;
+      break;
+
+    case SCHED_EVENT_RECYCLE:
+
+      cmd = SCH_SCHEDULE_RECYC;
+      break;
+
+    default:
+
+      cmd = SCH_SCHEDULE_NULL;
+      break;
+    }
+
+  sched_events.record_event(event);
+
+  if (cmd == SCH_SCHEDULE_NULL)
+    return;
+
+  pthread_mutex_lock(svr_do_schedule_mutex);
+  svr_do_schedule = cmd;
+  pthread_mutex_unlock(svr_do_schedule_mutex);
+
+  pthread_mutex_lock(listener_command_mutex);
+  listener_command = cmd;
+  pthread_mutex_unlock(listener_command_mutex);
+  }  /* END notify_scheduler() */
+
+
+
+
 /*
  * contact_sched - open connection to the scheduler and send it a command
  */
@@ -185,8 +255,10 @@ void *contact_sched(
 
   if (sock < 0)
     {
-    /* Thread exit */
+    /* no cycle was started, let the next one be claimed */
+    scheduler_close();
 
+    /* Thread exit */
     return(NULL);
     }
 
@@ -217,6 +289,7 @@ void *contact_sched(
     log_ext(errno, __func__, tmpLine, LOG_ALERT);
 
     close_conn(sock, FALSE);
+    scheduler_close();
 
     /* Thread exit */
     return(NULL);
@@ -234,8 +307,9 @@ void *contact_sched(
 
 
 /*
- * schedule_jobs - contact scheduler and direct it to run a scheduling cycle
- * If a request is already outstanding, skip this one.
+ * schedule_jobs - contact scheduler and direct it to run the scheduling cycle
+ * the main loop claimed with sched_event_tracker::claim_cycle(). The cycle
+ * stays in progress until scheduler_close() ends it.
  *
  * Returns: -1 = error
  *    0 = scheduler notified
@@ -252,6 +326,19 @@ int schedule_jobs(void)
   pthread_t tid;
   pthread_attr_t t_attr;
   int   *new_cmd = NULL;
+  std::string events;
+  char  log_buf[LOCAL_LOG_BUF_SIZE];
+
+  pthread_mutex_lock(scheduler_sock_jobct_mutex);
+  if (scheduler_sock == -1)
+    scheduler_jobct = 0;
+  else
+    tmp_sched_sock = scheduler_sock;
+  pthread_mutex_unlock(scheduler_sock_jobct_mutex);
+
+  /* the pending events wait, the cycle ends when that connection closes */
+  if (tmp_sched_sock != -1)
+    return(1);
 
   pthread_mutex_lock(svr_do_schedule_mutex);
 
@@ -265,54 +352,57 @@ int schedule_jobs(void)
   svr_do_schedule = SCH_SCHEDULE_NULL;
   pthread_mutex_unlock(svr_do_schedule_mutex);
 
-  pthread_mutex_lock(scheduler_sock_jobct_mutex);
-  if (scheduler_sock == -1)
-    scheduler_jobct = 0;
-  else
-    tmp_sched_sock = scheduler_sock;
-  pthread_mutex_unlock(scheduler_sock_jobct_mutex);
+  /* all events recorded so far are handled by this cycle, later ones set
+   * svr_do_schedule again for the next one */
+  sched_events.start_cycle(time(NULL), events);
 
-  if (tmp_sched_sock == -1)
+  if (LOGLEVEL >= 6)
     {
-    if (pthread_attr_init(&t_attr) != 0)
-      {
-      /* Can not init thread attribute structure */
-      perror("could not create listener thread for scheduler");
-      log_err(-1, __func__, "Failed to create listener thread for scheduler");
-      }
-    else if (pthread_attr_setdetachstate(&t_attr, PTHREAD_CREATE_DETACHED) != 0)
+    snprintf(log_buf, sizeof(log_buf), "starting scheduling cycle for %s", events.c_str());
+    log_event(PBSEVENT_SCHED, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+    }
+
+  if (pthread_attr_init(&t_attr) != 0)
+    {
+    /* Can not init thread attribute structure */
+    perror("could not create listener thread for scheduler");
+    log_err(-1, __func__, "Failed to create listener thread for scheduler");
+    sched_events.end_cycle();
+    }
+  else if (pthread_attr_setdetachstate(&t_attr, PTHREAD_CREATE_DETACHED) != 0)
+    {
+    /* Can not set thread initial state as detached */
+    pthread_attr_destroy(&t_attr);
+    perror("could not detach listener thread for scheduler");
+    log_err(-1, __func__, "Failed to detach listener thread for scheduler");
+    sched_events.end_cycle();
+    }
+  else
+    {
+    new_cmd = (int *)calloc(1, sizeof(int));
+    if (!new_cmd)
       {
-      /* Can not set thread initial state as detached */
-      pthread_attr_destroy(&t_attr);
-      perror("could not detach listener thread for scheduler");
-      log_err(-1, __func__, "Failed to detach listener thread for scheduler");
+      log_err(ENOMEM,__func__,"Could not allocate memory to set command");
+      sched_events.end_cycle();
+      return(-1);
       }
-    else
-      {
-      new_cmd = (int *)calloc(1, sizeof(int));
-      if (!new_cmd)
-        {
-        log_err(ENOMEM,__func__,"Could not allocate memory to set command");
-        return(-1);
-        }
-      *new_cmd = cmd;
+    *new_cmd = cmd;
 
-      if (pthread_create(&tid, &t_attr, contact_sched, (void *)new_cmd)
-   != 0)
-        {
-        perror("could not start listener thread for scheduler");
-        log_err(-1, __func__, "Failed to start listener thread for scheduler");
-      return(-1);
-        }
+    if (pthread_create(&tid, &t_attr, contact_sched, (void *)new_cmd)
+ != 0)
+      {
+      perror("could not start listener thread for scheduler");
+      log_err(-1, __func__, "Failed to start listener thread for scheduler");
+      sched_events.end_cycle();
+    return(-1);
       }
+    }
 
-    pthread_attr_destroy(&t_attr);
+  pthread_attr_destroy(&t_attr);
 
-    first_time = 0;
+  first_time = 0;
 
-    return(0);
-    }
-  return(1);
+  return(0);
   }  /* END schedule_jobs() */
 
 
@@ -457,6 +547,7 @@ void notify_listeners(void)
 
 /*
  * scheduler_close - connection to scheduler has closed, clear scheduler_called
+ * and end the scheduling cycle so events recorded during it can start the next
  */
 void scheduler_close()
 
@@ -464,6 +555,8 @@ void scheduler_close()
   pthread_mutex_lock(scheduler_sock_jobct_mutex);
   scheduler_sock = -1;
 
+  sched_events.end_cycle();
+
   /*
    * This bit of code is intended to support the scheduler - server - mom
    * sequence.  A scheduler script may best written to run only one job per
@@ -477,14 +570,7 @@ void scheduler_close()
   if (scheduler_jobct == 1)
     {
     /* recycle the scheduler */
-
-    pthread_mutex_lock(svr_do_schedule_mutex);
-    svr_do_schedule = SCH_SCHEDULE_RECYC;
-    pthread_mutex_unlock(svr_do_schedule_mutex);
-
-    pthread_mutex_lock(listener_command_mutex);
-    listener_command = SCH_SCHEDULE_RECYC;
-    pthread_mutex_unlock(listener_command_mutex);
+    notify_scheduler(SCHED_EVENT_RECYCLE);
     }
 
   pthread_mutex_unlock(scheduler_sock_jobct_mutex);
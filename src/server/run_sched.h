@@ -2,6 +2,8 @@
 #define _RUN_SCHED_H
 #include "license_pbs.h" /* See here for the software license */
 
+void notify_scheduler(int event);
+
 /* static int contact_sched(int cmd); */
 
 int schedule_jobs(void);
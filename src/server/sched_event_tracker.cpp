@@ -0,0 +1,363 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include <string.h>
+#include <stdio.h>
+
+#include "sched_event_tracker.hpp"
+
+const char *sched_event_names[] =
+  {
+  "job queued",
+  "job finished",
+  "node up",
+  "node down",
+  "command",
+  "timer",
+  "recycle"
+  };
+
+
+
+sched_event_tracker::sched_event_tracker() : last_cycle(0), in_progress(false)
+
+  {
+  memset(this->pending, 0, sizeof(this->pending));
+  pthread_mutex_init(&this->lock, NULL);
+  }
+
+
+
+sched_event_tracker::~sched_event_tracker()
+
+  {
+  }
+
+
+
+/*
+ * record_event()
+ *
+ * Records that an event happened since the last scheduling cycle
+ * @param event_type - one of the SCHED_EVENT_* values
+ */
+
+void sched_event_tracker::record_event(
+
+  int event_type)
+
+  {
+  if ((event_type < 0) ||
+      (event_type >= SCHED_EVENT_TYPE_COUNT))
+    return;
+
+  pthread_mutex_lock(&this->lock);
+
+  this->pending[event_type]++;
+
+  pthread_mutex_unlock(&this->lock);
+  } // END record_event()
+
+
+
+/*
+ * due()
+ *
+ * cycle_due() for callers that hold the lock
+ */
+
+bool sched_event_tracker::due(
+
+  time_t now,
+  long   min_interval)
+
+  {
+  if (this->in_progress == true)
+    return(false);
+
+  if ((this->pending[SCHED_EVENT_COMMAND] > 0) ||
+      (this->pending[SCHED_EVENT_TIMER] > 0))
+    return(true);
+
+  if ((this->pending[SCHED_EVENT_JOB_QUEUED] > 0) ||
+      (this->pending[SCHED_EVENT_JOB_FINISHED] > 0) ||
+      (this->pending[SCHED_EVENT_NODE_UP] > 0) ||
+      (this->pending[SCHED_EVENT_RECYCLE] > 0))
+    return(now - this->last_cycle >= min_interval);
+
+  return(false);
+  } // END due()
+
+
+
+/*
+ * cycle_due()
+ *
+ * @param now - the current time
+ * @param min_interval - the minimum number of seconds between two cycles
+ * @return true if no cycle is in progress, an event which warrants a
+ * scheduling cycle is pending and either min_interval has passed since the
+ * last cycle or the event is urgent
+ */
+
+bool sched_event_tracker::cycle_due(
+
+  time_t now,
+  long   min_interval)
+
+  {
+  bool is_due;
+
+  pthread_mutex_lock(&this->lock);
+  is_due = this->due(now, min_interval);
+  pthread_mutex_unlock(&this->lock);
+
+  return(is_due);
+  } // END cycle_due()
+
+
+
+/*
+ * claim_cycle()
+ *
+ * Marks a cycle in progress if one is due, so the cycle is only started once
+ * however often the caller asks before the scheduler is contacted.
+ * @param now - the current time
+ * @param min_interval - the minimum number of seconds between two cycles
+ * @return true if the caller should start the cycle
+ */
+
+bool sched_event_tracker::claim_cycle(
+
+  time_t now,
+  long   min_interval)
+
+  {
+  bool is_due;
+
+  pthread_mutex_lock(&this->lock);
+
+  if ((is_due = this->due(now, min_interval)) == true)
+    this->in_progress = true;
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(is_due);
+  } // END claim_cycle()
+
+
+
+/*
+ * end_cycle()
+ *
+ * Called once the cycle claimed by claim_cycle() is over, when the scheduler
+ * connection closes or the scheduler couldn't be contacted. Events recorded
+ * since the cycle started make the next one due again.
+ */
+
+void sched_event_tracker::end_cycle()
+
+  {
+  pthread_mutex_lock(&this->lock);
+  this->in_progress = false;
+  pthread_mutex_unlock(&this->lock);
+  } // END end_cycle()
+
+
+
+bool sched_event_tracker::cycle_in_progress()
+
+  {
+  bool in_cycle;
+
+  pthread_mutex_lock(&this->lock);
+  in_cycle = this->in_progress;
+  pthread_mutex_unlock(&this->lock);
+
+  return(in_cycle);
+  } // END cycle_in_progress()
+
+
+
+/*
+ * has_pending()
+ *
+ * @return true if any event that can trigger a cycle is pending
+ */
+
+bool sched_event_tracker::has_pending()
+
+  {
+  bool pending_event = false;
+
+  pthread_mutex_lock(&this->lock);
+
+  for (int i = 0; i < SCHED_EVENT_TYPE_COUNT; i++)
+    {
+    if ((i != SCHED_EVENT_NODE_DOWN) &&
+        (this->pending[i] > 0))
+      {
+      pending_event = true;
+      break;
+      }
+    }
+
+  pthread_mutex_unlock(&this->lock);
+
+  return(pending_event);
+  } // END has_pending()
+
+
+
+/*
+ * start_cycle()
+ *
+ * Consumes the pending events for the cycle that is being started
+ * @param now - the time the cycle is started
+ * @param summary - set to a description of the coalesced events, suitable
+ *                  for logging
+ */
+
+void sched_event_tracker::start_cycle(
+
+  time_t       now,
+  std::string &summary)
+
+  {
+  char buf[64];
+
+  summary.clear();
+
+  pthread_mutex_lock(&this->lock);
+
+  for (int i = 0; i < SCHED_EVENT_TYPE_COUNT; i++)
+    {
+    if (this->pending[i] == 0)
+      continue;
+
+    if (summary.size() != 0)
+      summary += ", ";
+
+    snprintf(buf, sizeof(buf), "%lu %s", this->pending[i], sched_event_names[i]);
+    summary += buf;
+    }
+
+  if (summary.size() == 0)
+    summary = "no events";
+
+  memset(this->pending, 0, sizeof(this->pending));
+  this->last_cycle = now;
+
+  pthread_mutex_unlock(&this->lock);
+  } // END start_cycle()
+
+
+
+unsigned long sched_event_tracker::get_pending_count(
+
+  int event_type)
+
+  {
+  unsigned long count = 0;
+
+  if ((event_type < 0) ||
+      (event_type >= SCHED_EVENT_TYPE_COUNT))
+    return(0);
+
+  pthread_mutex_lock(&this->lock);
+  count = this->pending[event_type];
+  pthread_mutex_unlock(&this->lock);
+
+  return(count);
+  } // END get_pending_count()
+
+
+
+time_t sched_event_tracker::get_last_cycle()
+
+  {
+  time_t last;
+
+  pthread_mutex_lock(&this->lock);
+  last = this->last_cycle;
+  pthread_mutex_unlock(&this->lock);
+
+  return(last);
+  } // END get_last_cycle()
+
@@ -86,7 +86,12 @@
  * Included funtions are:
  * status_job()
  * status_attrib()
+ * compact_completed_job()
+ * record_job_history()
+ * status_completed_job()
+ * status_history_job()
  */
+#include <algorithm>
 #include <stdlib.h>
 #include "libpbs.h"
 #include <ctype.h>
@@ -106,13 +111,18 @@
 #include "svr_func.h" /* get_svr_attr_* */
 #include "log.h"
 #include "job_route.h" /* remove_procct */
+#include "svr_chk_owner.h" /* svr_authorize_req */
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 
 extern int     svr_authorize_jobreq(struct batch_request *, job *);
+bool include_in_status(int index);
 int status_attrib(svrattrl *, attribute_def *, pbs_attribute *, int, int, tlist_head *, bool, int *, int);
 
 /* Global Data Items: */
 
 extern attribute_def job_attr_def[];
+extern char         *pbs_o_host;
 
 extern struct server server;
 
@@ -208,6 +218,422 @@ int status_job(
 
 
 
+/*
+ * in_job_history()
+ *
+ * Tells which attributes are kept in the job history
+ *
+ * @param index - the index of the attribute
+ * @return true if the attribute is recorded when the job finishes
+ */
+
+bool in_job_history(
+
+  int index)
+
+  {
+  switch (index)
+    {
+    case JOB_ATR_jobname:
+    case JOB_ATR_job_owner:
+    case JOB_ATR_state:
+    case JOB_ATR_in_queue:
+    case JOB_ATR_euser:
+    case JOB_ATR_egroup:
+    case JOB_ATR_account:
+    case JOB_ATR_exitstat:
+    case JOB_ATR_ctime:
+    case JOB_ATR_qtime:
+    case JOB_ATR_start_time:
+    case JOB_ATR_comp_time:
+    case JOB_ATR_resource:
+    case JOB_ATR_resc_used:
+    case JOB_ATR_exec_host:
+    case JOB_ATR_total_runtime:
+
+      return(true);
+
+    default:
+
+      return(false);
+    }
+  } /* END in_job_history() */
+
+
+
+/*
+ * encode_finished_job()
+ *
+ * Encodes the readable attributes of a finished job, with full read
+ * privilege, into the form kept by completed_store and job_hist. The
+ * requestor's privilege is applied when the record is reported.
+ *
+ * @param pjob - the finished job, locked
+ * @param history - true to encode only the attributes kept in the history
+ * @param info - set to the owner, queue and times of the job
+ * @param attrs - set to the encoded attributes
+ */
+
+void encode_finished_job(
+
+  job                             *pjob,
+  bool                             history,
+  completed_job_info              &info,
+  std::vector<completed_job_attr> &attrs)
+
+  {
+  tlist_head  head;
+  svrattrl   *pal;
+  char       *submit_host;
+
+  remove_procct(pjob);
+
+  if (pjob->ji_wattr[JOB_ATR_job_owner].at_val.at_str != NULL)
+    info.ci_owner = pjob->ji_wattr[JOB_ATR_job_owner].at_val.at_str;
+
+  if ((submit_host = get_variable(pjob, pbs_o_host)) != NULL)
+    info.ci_submit_host = submit_host;
+
+  info.ci_queue = pjob->ji_qs.ji_queue;
+  info.ci_mod_time = pjob->ji_mod_time;
+  info.ci_expires = 0;
+
+  attrs.clear();
+
+  for (int index = 0; index < JOB_ATR_LAST; index++)
+    {
+    if (((job_attr_def[index].at_flags & ATR_DFLAG_RDACC) == 0) ||
+        (job_attr_def[index].at_flags & ATR_DFLAG_NOSTAT))
+      continue;
+
+    if ((history == true) &&
+        (in_job_history(index) == false))
+      continue;
+
+    CLEAR_HEAD(head);
+
+    job_attr_def[index].at_encode(
+      pjob->ji_wattr + index,
+      &head,
+      job_attr_def[index].at_name,
+      NULL,
+      ATR_ENCODE_CLIENT,
+      ATR_DFLAG_RDACC);
+
+    if (index == JOB_ATR_resc_used)
+      pjob->encode_plugin_resource_usage(&head);
+
+    for (pal = (svrattrl *)GET_NEXT(head); pal != NULL; pal = (svrattrl *)GET_NEXT(pal->al_link))
+      {
+      completed_job_attr ca;
+
+      ca.ca_index = index;
+      ca.ca_name = pal->al_name;
+
+      if (pal->al_resc != NULL)
+        ca.ca_resc = pal->al_resc;
+
+      if (pal->al_value != NULL)
+        ca.ca_value = pal->al_value;
+
+      attrs.push_back(ca);
+      }
+
+    free_attrlist(&head);
+    }
+  } /* END encode_finished_job() */
+
+
+
+/*
+ * compact_completed_job()
+ *
+ * Encodes every readable attribute of a completed job once and stores the
+ * result in completed_store, so the job itself can be purged while it is
+ * still reported for keep_completed.
+ *
+ * @param pjob - the completed job, locked
+ * @param expires - when the record should be dropped
+ * @return PBSE_NONE if the job was stored
+ */
+
+int compact_completed_job(
+
+  job    *pjob,
+  time_t  expires)
+
+  {
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+
+  encode_finished_job(pjob, false, info, attrs);
+  info.ci_expires = expires;
+
+  if (completed_store.add_job(pjob->ji_qs.ji_jobid, info, attrs) == false)
+    return(PBSE_JOBEXIST);
+
+  return(PBSE_NONE);
+  } /* END compact_completed_job() */
+
+
+
+/*
+ * record_job_history()
+ *
+ * Appends the key attributes of a finished job to the job history
+ *
+ * @param pjob - the finished job, locked
+ * @return PBSE_NONE if the job was recorded
+ */
+
+int record_job_history(
+
+  job *pjob)
+
+  {
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+
+  if (job_hist.is_open() == false)
+    return(PBSE_NONE);
+
+  encode_finished_job(pjob, true, info, attrs);
+
+  if ((pjob->ji_wattr[JOB_ATR_comp_time].at_flags & ATR_VFLAG_SET) != 0)
+    info.ci_mod_time = pjob->ji_wattr[JOB_ATR_comp_time].at_val.at_long;
+
+  return(job_hist.add_job(pjob->ji_qs.ji_jobid, info, attrs));
+  } /* END record_job_history() */
+
+
+
+/*
+ * status_finished_job()
+ *
+ * Builds the status reply for a job kept as an encoded record, applying
+ * the same permission, condensed and attribute list rules as status_job().
+ *
+ * @param job_id - the job the record is for
+ * @param info - the record's owner and times
+ * @param attrs - the record's encoded attributes
+ * @return PBSE_NONE on success, or PBSE_PERM / PBSE_NOATTR as status_job() does
+ */
+
+int status_finished_job(
+
+  const char                      *job_id,
+  completed_job_info              &info,
+  std::vector<completed_job_attr> &attrs,
+  batch_request                   *preq,
+  svrattrl                        *pal,
+  tlist_head                      *pstathd,
+  bool                             condensed,
+  int                             *bad)
+
+  {
+  std::vector<int>                 wanted;
+  struct brp_status               *pstat;
+  char                             owner[PBS_MAXUSER + 1];
+  int                              IsOwner = 0;
+  bool                             query_others = false;
+  long                             condensed_timeout = JOB_CONDENSED_TIMEOUT;
+  int                              priv = preq->rq_perm & ATR_DFLAG_RDACC;
+  int                              nth = 0;
+
+  get_jobowner((char *)info.ci_owner.c_str(), owner);
+
+  if (svr_authorize_req(preq, owner, (char *)info.ci_submit_host.c_str()) == 0)
+    IsOwner = 1;
+
+  get_svr_attr_b(SRV_ATR_query_others, &query_others);
+  if ((!query_others) &&
+      (IsOwner == 0))
+    return(PBSE_PERM);
+
+  get_svr_attr_l(SRV_ATR_job_full_report_time, &condensed_timeout);
+
+  if ((condensed == true) &&
+      (time(NULL) < info.ci_mod_time + condensed_timeout))
+    condensed = false;
+
+  *bad = 0;
+
+  for (; pal != NULL; pal = (svrattrl *)GET_NEXT(pal->al_link))
+    {
+    int index = find_attr(job_attr_def, pal->al_name, JOB_ATR_LAST);
+
+    nth++;
+
+    if (index < 0)
+      {
+      *bad = nth;
+      return(PBSE_NOATTR);
+      }
+
+    wanted.push_back(index);
+    }
+
+  if ((pstat = (struct brp_status *)calloc(1, sizeof(struct brp_status))) == NULL)
+    return(PBSE_SYSTEM);
+
+  CLEAR_LINK(pstat->brp_stlink);
+  pstat->brp_objtype = MGR_OBJ_JOB;
+  snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%s", job_id);
+  CLEAR_HEAD(pstat->brp_attr);
+  append_link(pstathd, &pstat->brp_stlink, pstat);
+
+  for (size_t i = 0; i < attrs.size(); i++)
+    {
+    completed_job_attr &ca = attrs[i];
+    attribute_def      *padef = job_attr_def + ca.ca_index;
+    svrattrl           *entry;
+
+    if ((ca.ca_index < 0) ||
+        (ca.ca_index >= JOB_ATR_LAST))
+      continue;
+
+    if (wanted.size() != 0)
+      {
+      if (std::find(wanted.begin(), wanted.end(), ca.ca_index) == wanted.end())
+        continue;
+      }
+    else if ((condensed == true) &&
+             (include_in_status(ca.ca_index) == false))
+      continue;
+
+    if (((padef->at_flags & priv) == 0) ||
+        ((padef->at_flags & ATR_DFLAG_PRIVR) && (IsOwner == 0)))
+      continue;
+
+    if (ca.ca_resc.size() != 0)
+      {
+      resource_def *prdef = find_resc_def(svr_resc_def, ca.ca_resc.c_str(), svr_resc_size);
+
+      /* plugin resources have no definition and are always readable */
+      if ((prdef != NULL) &&
+          ((prdef->rs_flags & priv) == 0))
+        continue;
+      }
+
+    entry = attrlist_create(ca.ca_name.c_str(),
+              (ca.ca_resc.size() != 0) ? ca.ca_resc.c_str() : NULL,
+              ca.ca_value.size() + 1);
+
+    if (entry == NULL)
+      return(PBSE_SYSTEM);
+
+    strcpy(entry->al_value, ca.ca_value.c_str());
+    entry->al_flags = ATR_VFLAG_SET;
+
+    append_link(&pstat->brp_attr, &entry->al_link, entry);
+    }
+
+  return(PBSE_NONE);
+  } /* END status_finished_job() */
+
+
+
+/*
+ * status_completed_job()
+ *
+ * Builds the status reply for a job held in completed_store
+ *
+ * @param job_id - the job to status
+ * @return PBSE_NONE on success, PBSE_UNKJOBID if the job isn't stored,
+ * or PBSE_PERM / PBSE_NOATTR as status_job() does
+ */
+
+int status_completed_job(
+
+  const char    *job_id,
+  batch_request *preq,
+  svrattrl      *pal,
+  tlist_head    *pstathd,
+  bool           condensed,
+  int           *bad)
+
+  {
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+
+  if (completed_store.get_job(job_id, info, attrs) == false)
+    return(PBSE_UNKJOBID);
+
+  return(status_finished_job(job_id, info, attrs, preq, pal, pstathd, condensed, bad));
+  } /* END status_completed_job() */
+
+
+
+/*
+ * status_completed_jobs()
+ *
+ * Appends the status of the jobs held in completed_store to a server or
+ * queue status reply. Jobs the requestor may not see are skipped.
+ *
+ * @param queue - only report jobs that completed in this queue, or all if NULL
+ * @return PBSE_NONE, or the first error that isn't PBSE_PERM
+ */
+
+int status_completed_jobs(
+
+  const char    *queue,
+  batch_request *preq,
+  svrattrl      *pal,
+  tlist_head    *pstathd,
+  bool           condensed,
+  int           *bad)
+
+  {
+  std::vector<std::string> ids;
+
+  completed_store.get_job_ids(queue, ids);
+
+  for (size_t i = 0; i < ids.size(); i++)
+    {
+    int rc = status_completed_job(ids[i].c_str(), preq, pal, pstathd, condensed, bad);
+
+    /* a job that expired since the ids were listed is simply left out */
+    if ((rc != PBSE_NONE) &&
+        (rc != PBSE_PERM) &&
+        (rc != PBSE_UNKJOBID))
+      return(rc);
+    }
+
+  return(PBSE_NONE);
+  } /* END status_completed_jobs() */
+
+
+
+/*
+ * status_history_job()
+ *
+ * Builds the status reply for a job from the job history
+ *
+ * @param job_id - the job to status
+ * @return PBSE_NONE on success, PBSE_UNKJOBID if the job isn't in the
+ * history, or PBSE_PERM / PBSE_NOATTR as status_job() does
+ */
+
+int status_history_job(
+
+  const char    *job_id,
+  batch_request *preq,
+  svrattrl      *pal,
+  tlist_head    *pstathd,
+  int           *bad)
+
+  {
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+
+  if (job_hist.get_job(job_id, info, attrs) == false)
+    return(PBSE_UNKJOBID);
+
+  return(status_finished_job(job_id, info, attrs, preq, pal, pstathd, false, bad));
+  } /* END status_history_job() */
+
+
+
 /* Is this dead code? It isn't called anywhere. */
 int add_walltime_remaining(
    
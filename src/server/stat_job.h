@@ -13,4 +13,14 @@ int status_job(job *pjob, struct batch_request *preq, svrattrl *pal, tlist_head
 
 int status_attrib(svrattrl *pal, attribute_def *padef, pbs_attribute *pattr, int limit, int priv, tlist_head *phead, int *bad, int IsOwner);
 
+int compact_completed_job(job *pjob, time_t expires);
+
+int status_completed_job(const char *job_id, struct batch_request *preq, svrattrl *pal, tlist_head *pstathd, bool condensed, int *bad);
+
+int record_job_history(job *pjob);
+
+int status_history_job(const char *job_id, struct batch_request *preq, svrattrl *pal, tlist_head *pstathd, int *bad);
+
+int status_completed_jobs(const char *queue, struct batch_request *preq, svrattrl *pal, tlist_head *pstathd, bool condensed, int *bad);
+
 #endif /* _STAT_JOB_H */
@@ -101,6 +101,8 @@ extern int poke_scheduler (pbs_attribute * pattr, void *pobject, int actmode);
 
 extern int encode_svrstate (pbs_attribute * pattr, tlist_head * phead,
 			    const char *aname, const char *rsname, int mode, int perm);
+extern int encode_combined_submit (pbs_attribute * pattr, tlist_head * phead,
+			    const char *aname, const char *rsname, int mode, int perm);
 
 extern int decode_rcost (pbs_attribute * patr, const char *name, const char *rn, const char *val, int perm);
 extern int encode_rcost (pbs_attribute * attr, tlist_head * phead, const char *atname,
@@ -120,6 +122,10 @@ int         update_user_acls(pbs_attribute *pattr, void *pobject, int actmode);
 int         update_group_acls(pbs_attribute *pattr, void *pobject, int actmode);
 int         node_exception_check(pbs_attribute *pattr, void *pobject, int actmode);
 int         check_default_gpu_mode_str(pbs_attribute *pattr, void *pobject, int actmode);
+int         record_job_trace_action(pbs_attribute *pattr, void *pobject, int actmode);
+int         record_job_usage_action(pbs_attribute *pattr, void *pobject, int actmode);
+int         spill_completed_jobs_action(pbs_attribute *pattr, void *pobject, int actmode);
+int         record_job_history_action(pbs_attribute *pattr, void *pobject, int actmode);
 extern int  keep_completed_val_check(pbs_attribute *pattr,void *pobj,int actmode);
 /* DIAGTODO: write diag_attr_def.c */
 
@@ -1651,4 +1657,121 @@ attribute_def svr_attr_def[] =
    PARENT_TYPE_SERVER
   },
 
+  // SRV_ATR_scheduler_min_interval
+  {(char *)ATTR_sched_min_interval, // "scheduler_min_interval"
+   decode_l,
+   encode_l,
+   set_l,
+   comp_l,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_TopologyAwarePlacement
+  {(char *)ATTR_topology_aware_placement, // "topology_aware_placement"
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_RecordJobTrace
+  {(char *)ATTR_record_job_trace, // "record_job_trace"
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   record_job_trace_action,
+   MGR_ONLY_SET,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_RecordJobUsage
+  {(char *)ATTR_record_job_usage, // "record_job_usage"
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   record_job_usage_action,
+   MGR_ONLY_SET,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_CompactCompletedJobs
+  {(char *)ATTR_compact_completed_jobs, // "compact_completed_jobs"
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_SpillCompletedJobs
+  {(char *)ATTR_spill_completed_jobs, // "spill_completed_jobs"
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   spill_completed_jobs_action,
+   MGR_ONLY_SET,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_RecordJobHistory
+  {(char *)ATTR_record_job_history, // "record_job_history"
+   decode_b,
+   encode_b,
+   set_b,
+   comp_b,
+   free_null,
+   record_job_history_action,
+   MGR_ONLY_SET,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_JobHistoryDays
+  {(char *)ATTR_job_history_days, // "job_history_days"
+   decode_l,
+   encode_l,
+   set_l,
+   comp_l,
+   free_null,
+   NULL_FUNC,
+   MGR_ONLY_SET,
+   ATR_TYPE_LONG,
+   PARENT_TYPE_SERVER
+  },
+
+  // SRV_ATR_CombinedSubmit
+  {(char *)ATTR_combined_submit, // "combined_submit"
+   decode_null,
+   encode_combined_submit,
+   set_null,
+   comp_b,
+   free_null,
+   NULL_FUNC,
+   READ_ONLY | ATR_DFLAG_NOSTAT,
+   ATR_TYPE_BOOL,
+   PARENT_TYPE_SERVER
+  },
+
   };
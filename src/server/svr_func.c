@@ -102,14 +102,12 @@
 #include "log.h"
 #include "../lib/Liblog/pbs_log.h"
 #include "mutex_mgr.hpp"
+#include "run_sched.h"
+#include "sched_event_tracker.hpp"
 
 extern int              LOGLEVEL;
 extern int              scheduler_sock;
 extern pthread_mutex_t *scheduler_sock_jobct_mutex;
-extern int              svr_do_schedule;
-extern pthread_mutex_t *svr_do_schedule_mutex;
-extern pthread_mutex_t *listener_command_mutex;
-extern int              listener_command;
 
 /*
  * the following array of strings is used in decoding/encoding the server state
@@ -210,6 +208,50 @@ int encode_svrstate(
 
 
 
+/*
+ * encode_combined_submit - report that this server accepts the SubmitJob
+ * request. qsub asks for the attribute by name before sending a job in a
+ * single request; a server which predates SubmitJob doesn't know the name.
+ * The attribute is never set, so it isn't written to serverdb where an
+ * older server couldn't read it back.
+ *
+ * @param pattr - NOT USED
+ * @param phead - the linked list to append the encoded attribute
+ * @param atname - the attribute's name
+ * @param rsname - NOT USED
+ * @param mode - encode mode
+ * @param perm - NOT USED
+ */
+
+int encode_combined_submit(
+
+  pbs_attribute  *pattr,
+  tlist_head     *phead,
+  const char     *atname,
+  const char     *rsname,
+  int             mode,
+  int             perm)
+
+  {
+  svrattrl *pal;
+
+  if (mode == ATR_ENCODE_SAVE)
+    return(0);
+
+  if ((pal = attrlist_create(atname, rsname, strlen(ATR_TRUE) + 1)) == NULL)
+    return(-1);
+
+  strcpy(pal->al_value, ATR_TRUE);
+  pal->al_flags = ATR_VFLAG_SET;
+
+  append_link(phead, &pal->al_link, pal);
+
+  return(1);
+  }  /* END encode_combined_submit() */
+
+
+
+
 /*
  * set_resc_assigned - set the resources used by a job in the server and
  * queue resources_used pbs_attribute
@@ -683,14 +725,7 @@ int poke_scheduler(
   if (actmode == ATR_ACTION_ALTER)
     {
     if (pattr->at_val.at_long)
-      {
-      pthread_mutex_lock(svr_do_schedule_mutex);
-      svr_do_schedule = SCH_SCHEDULE_CMD;
-      pthread_mutex_unlock(svr_do_schedule_mutex);
-      pthread_mutex_lock(listener_command_mutex);
-      listener_command = SCH_SCHEDULE_CMD;
-      pthread_mutex_unlock(listener_command_mutex);
-      }
+      notify_scheduler(SCHED_EVENT_COMMAND);
     }
 
   return(0);
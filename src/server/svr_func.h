@@ -8,6 +8,8 @@
 
 int encode_svrstate(pbs_attribute *pattr, tlist_head *phead, const char *atname, const char *rsname, int mode, int perm);
 
+int encode_combined_submit(pbs_attribute *pattr, tlist_head *phead, const char *atname, const char *rsname, int mode, int perm);
+
 void set_resc_assigned(job *pjob, enum batch_op op);
 
 int ck_checkpoint(pbs_attribute *pattr, void *pobject, int mode);
@@ -154,6 +154,8 @@
 #include "policy_values.h"
 
 #include "user_info.h" /* remove_server_suffix() */
+#include "run_sched.h"
+#include "sched_event_tracker.hpp"
 
 #define MSG_LEN_LONG 160
 
@@ -176,10 +178,6 @@ extern char  *pbs_o_host;
 extern char   server_name[];
 extern int    comp_resc_lt;
 extern int    comp_resc_gt;
-extern int    svr_do_schedule;
-extern pthread_mutex_t *svr_do_schedule_mutex;
-extern pthread_mutex_t *listener_command_mutex;
-extern int    listener_command;
 extern int    LOGLEVEL;
 
 extern int    DEBUGMODE;
@@ -303,68 +301,61 @@ const char *PJobSubState[] =
 
 
 
+/*
+ * insert_into_alljobs_by_rank()
+ *
+ * Links a job into one of a queue's job lists after the last job of lower
+ * queue rank. The list's rank index finds that job in O(log n), so bulk
+ * submits and recovery no longer walk the list on every enqueue.
+ *
+ * @param aj - the queue's job list
+ * @param ranks - the rank index of aj
+ * @param pjob - the job to link, locked
+ * @param jobid - pjob's id
+ * @return ALREADY_IN_LIST if the job is already in aj, else PBSE_NONE
+ */
+
 int insert_into_alljobs_by_rank(
 
-  all_jobs         *aj,
-  job              *pjob,
-  char            *jobid)
+  all_jobs       *aj,
+  job_rank_index *ranks,
+  job            *pjob,
+  char           *jobid)
 
   {
-  job  *pjcur;
+  long         job_qrank = pjob->ji_wattr[JOB_ATR_qrank].at_val.at_long;
+  std::string  prev_id;
+  bool         linked = false;
+
   aj->lock();
-  all_jobs_iterator  *iter = aj->get_iterator(true);
-  long  job_qrank = pjob->ji_wattr[JOB_ATR_qrank].at_val.at_long;
-  std::string curJobid = "";
-  
-  unlock_ji_mutex(pjob, __func__, "4", LOGLEVEL);
 
-  while ((pjcur = iter->get_next_item()) != NULL)
+  if (aj->find(jobid) != NULL)
     {
-    mutex_mgr pjcur_mgr(pjcur->ji_mutex, true);
-    if (job_qrank > pjcur->ji_wattr[JOB_ATR_qrank].at_val.at_long)
-      {
-      pjcur_mgr.set_unlock_on_exit(false);
-      break;
-      }
-    
-    if (strcmp(jobid, pjcur->ji_qs.ji_jobid) == 0)
-      {
-      delete iter;
-
-      aj->unlock();
-      return(ALREADY_IN_LIST);
-      }
+    aj->unlock();
+    return(ALREADY_IN_LIST);
     }
 
-  delete iter;
-
-  if (pjcur != NULL)
+  while (ranks->find_preceding(job_qrank, prev_id) == true)
     {
-    if (aj->find(pjcur->ji_qs.ji_jobid))
+    /* link after the preceding job in list */
+    if (aj->insert_after(prev_id, pjob, pjob->ji_qs.ji_jobid))
       {
-      curJobid = pjcur->ji_qs.ji_jobid;
+      linked = true;
+      break;
       }
-    unlock_ji_mutex(pjcur, __func__, "8", LOGLEVEL);
-    pjcur = NULL;
-    }
-  aj->unlock();
 
-  if ((pjob = svr_find_job(jobid, FALSE)) == NULL)
-    {
-    return(PBSE_JOBNOTFOUND);
+    /* the preceding job left the list without leaving the index */
+    ranks->remove(prev_id);
     }
 
-  aj->lock();
-  if (curJobid.length() == 0)
+  if (linked == false)
     {
     /* link first in list */
-    aj->insert_first(pjob,pjob->ji_qs.ji_jobid);
-    }
-  else
-    {
-    /* link after 'current' job in list */
-    aj->insert_after(curJobid, pjob,pjob->ji_qs.ji_jobid);
+    aj->insert_first(pjob, pjob->ji_qs.ji_jobid);
     }
+
+  ranks->insert(jobid, job_qrank);
+
   aj->unlock();
 
   return(PBSE_NONE);
@@ -551,17 +542,11 @@ int svr_enquejob(
 
   if (!pjob->ji_is_array_template)
     {
-    rc = insert_into_alljobs_by_rank(pque->qu_jobs, pjob, job_id);
+    rc = insert_into_alljobs_by_rank(pque->qu_jobs, pque->qu_jobs_ranks, pjob, job_id);
 
-    if ((rc == ALREADY_IN_LIST) ||
-        (rc == PBSE_JOBNOTFOUND))
+    if (rc == ALREADY_IN_LIST)
       {
-      if (rc == ALREADY_IN_LIST)
-        {
-        rc = PBSE_NONE;
-        }
-
-      return(rc);
+      return(PBSE_NONE);
       }
 
     /* update counts: queue and queue by state */
@@ -582,16 +567,10 @@ int svr_enquejob(
   if ((pjob->ji_is_array_template) ||
       (pjob->ji_arraystructid[0] == '\0'))
     {
-    rc = insert_into_alljobs_by_rank(pque->qu_jobs_array_sum, pjob, job_id);
-
-    if ((rc == ALREADY_IN_LIST) ||
-        (rc == PBSE_JOBNOTFOUND))
-      {
-      if (rc == ALREADY_IN_LIST)
-        rc = PBSE_NONE;
+    rc = insert_into_alljobs_by_rank(pque->qu_jobs_array_sum, pque->qu_jobs_array_sum_ranks, pjob, job_id);
 
-      return(rc);
-      }
+    if (rc == ALREADY_IN_LIST)
+      return(PBSE_NONE);
     }
 
   /* update the current location and type pbs_attribute */
@@ -681,12 +660,7 @@ int svr_enquejob(
       }
       
     /* notify the scheduler we have a new job */
-    pthread_mutex_lock(svr_do_schedule_mutex);
-    svr_do_schedule = SCH_SCHEDULE_NEW;
-    pthread_mutex_unlock(svr_do_schedule_mutex);
-    pthread_mutex_lock(listener_command_mutex);
-    listener_command = SCH_SCHEDULE_NEW;
-    pthread_mutex_unlock(listener_command_mutex);
+    notify_scheduler(SCHED_EVENT_JOB_QUEUED);
     }
   else if (pque->qu_qs.qu_type == QTYPE_RoutePush)
     {
@@ -783,7 +757,10 @@ int svr_dequejob(
       }
 
     std::string jobid = pjob->ji_qs.ji_jobid;
-    if ((rc = remove_job(pque->qu_jobs, pjob)) == PBSE_NONE)
+    rc = remove_job(pque->qu_jobs, pjob);
+    pque->qu_jobs_ranks->remove(jobid);
+
+    if (rc == PBSE_NONE)
       {
       if (--pque->qu_numjobs < 0)
         {
@@ -811,8 +788,10 @@ int svr_dequejob(
       }
 
     /* the only reason to care about the error is if the job is gone */
-    int rc2;
-    if ((rc2 = remove_job(pque->qu_jobs_array_sum, pjob)) == PBSE_JOBNOTFOUND)
+    int rc2 = remove_job(pque->qu_jobs_array_sum, pjob);
+    pque->qu_jobs_array_sum_ranks->remove(jobid);
+
+    if (rc2 == PBSE_JOBNOTFOUND)
       return(rc2);
 
     if (rc2 == THING_NOT_FOUND && (LOGLEVEL >= 8))
@@ -923,13 +902,7 @@ int svr_dequejob(
 #endif /* NDEBUG */
 
   /* notify scheduler a job has been removed */
-
-  pthread_mutex_lock(svr_do_schedule_mutex);
-  svr_do_schedule = SCH_SCHEDULE_TERM;
-  pthread_mutex_unlock(svr_do_schedule_mutex);
-  pthread_mutex_lock(listener_command_mutex);
-  listener_command = SCH_SCHEDULE_TERM;
-  pthread_mutex_unlock(listener_command_mutex);
+  notify_scheduler(SCHED_EVENT_JOB_FINISHED);
 
   return(PBSE_NONE);
   }  /* END svr_dequejob() */
@@ -1249,12 +1222,7 @@ int svr_setjobstate(
           if ((pque->qu_qs.qu_type == QTYPE_Execution) &&
               (newstate == JOB_STATE_QUEUED))
             {
-            pthread_mutex_lock(svr_do_schedule_mutex);
-            svr_do_schedule = SCH_SCHEDULE_NEW;
-            pthread_mutex_unlock(svr_do_schedule_mutex);
-            pthread_mutex_lock(listener_command_mutex);
-            listener_command = SCH_SCHEDULE_NEW;
-            pthread_mutex_unlock(listener_command_mutex);
+            notify_scheduler(SCHED_EVENT_JOB_QUEUED);
 
             if ((pjob->ji_wattr[JOB_ATR_etime].at_flags & ATR_VFLAG_SET) == 0)
               {
@@ -3827,12 +3795,95 @@ static void eval_checkpoint(
 
 #ifndef NDEBUG
 
+/*
+ * count_user_queued_job - adds pjob to its owner's recounted queued jobs,
+ * the same way svr_enquejob() counts them
+ */
+
+static void count_user_queued_job(
+
+  job                                 *pjob,
+  std::map<std::string, unsigned int> &queue_queued,
+  std::map<std::string, unsigned int> &server_queued)
+
+  {
+  if (pjob->ji_qs.ji_state == JOB_STATE_COMPLETE)
+    return;
+
+  std::string uname(pjob->ji_wattr[JOB_ATR_job_owner].at_val.at_str);
+
+  remove_server_suffix(uname);
+  queue_queued[uname] += count_jobs_submitted(pjob);
+  server_queued[uname] += count_jobs_submitted(pjob);
+  }  /* END count_user_queued_job() */
+
+
+
+
+/*
+ * check_queued_job_counts - periodic consistency check of the per user
+ * queued job counts that the queuable limits are checked against. Each
+ * queue's counts are recounted while the queue is locked, so any difference
+ * is logged and corrected. The server wide counts can't be recounted without
+ * stopping every queue, so they are left to correct_ct().
+ */
+
+void check_queued_job_counts(
+
+  struct work_task *ptask)
+
+  {
+  job                 *pjob;
+  pbs_queue           *pque;
+  all_queues_iterator *queue_iter = NULL;
+  all_jobs_iterator   *job_iter = NULL;
+
+  std::map<std::string, unsigned int> server_queued;
+
+  svr_queues.lock();
+  queue_iter = svr_queues.get_iterator();
+  svr_queues.unlock();
+
+  while ((pque = next_queue(&svr_queues, queue_iter)) != NULL)
+    {
+    mutex_mgr pque_mutex = mutex_mgr(pque->qu_mutex, true);
+    std::map<std::string, unsigned int> queue_queued;
+
+    pque->qu_jobs->lock();
+    job_iter = pque->qu_jobs->get_iterator();
+    pque->qu_jobs->unlock();
+
+    while ((pjob = next_job(pque->qu_jobs, job_iter)) != NULL)
+      {
+      count_user_queued_job(pjob, queue_queued, server_queued);
+
+      unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+      }
+
+    delete job_iter;
+
+    reconcile_queued_jobs(pque->qu_uih, queue_queued);
+    }
+
+  delete queue_iter;
+
+  free(ptask->wt_mutex);
+  free(ptask);
+
+  set_task(WORK_Timed, time(NULL) + PBS_QUEUED_CT_CHECK_RATE, check_queued_job_counts, NULL, FALSE);
+  }  /* END check_queued_job_counts() */
+
+
+
+
 /*
  * correct_ct - This is a work-around for an as yet unfound bug where
  * the counts of jobs in each state sometimes (rarely) become wrong.
  * When this happens, the count for a state can become negative.
  * If this is detected (see above), this routine is called to reset
- * all of the counts and log a message.
+ * all of the counts and log a message. The per user counts of queued jobs
+ * that the queuable limits are checked against are recounted as well, and
+ * any user whose count had drifted is logged and corrected.
  */
 
 static void correct_ct()
@@ -3847,6 +3898,8 @@ static void correct_ct()
   int           num_jobs = 0;
   int           job_counts[PBS_NUMJOBSTATE];
   char          log_buf[LOCAL_LOG_BUF_SIZE];
+
+  std::map<std::string, unsigned int> server_queued;
   
   lock_startup();
   lock_sv_qs_mutex(server.sv_qs_mutex, __func__);
@@ -3877,6 +3930,7 @@ static void correct_ct()
   while ((pque = next_queue(&svr_queues,queue_iter)) != NULL)
     {
     mutex_mgr pque_mutex = mutex_mgr(pque->qu_mutex, true);
+    std::map<std::string, unsigned int> queue_queued;
     snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "checking queue %s", pque->qu_qs.qu_name);
     log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
     pque->qu_numjobs = 0;
@@ -3905,14 +3959,20 @@ static void correct_ct()
       
       pque->qu_numjobs++;
       pque->qu_njstate[pjob->ji_qs.ji_state]++;
+
+      count_user_queued_job(pjob, queue_queued, server_queued);
       
       unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
       }
 
     delete job_iter;
+
+    reconcile_queued_jobs(pque->qu_uih, queue_queued);
     } /* END for each queue */
 
   delete queue_iter;
+
+  reconcile_queued_jobs(&users, server_queued);
   
   sprintf(log_buf, "%s:2", __func__);
   lock_sv_qs_mutex(server.sv_qs_mutex, log_buf);
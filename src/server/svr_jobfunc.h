@@ -9,6 +9,7 @@ struct pbs_attribute;
 struct resource;
 struct resource_def;
 struct pbs_queue;
+struct work_task;
 
 char *get_variable(struct job *pjob, const char *variable);
 
@@ -33,6 +34,7 @@ void set_statechar(struct job *pjob);
 
 #ifndef NDEBUG
 /* static void correct_ct(); */
+void check_queued_job_counts(struct work_task *ptask);
 #endif /* NDEBUG */
 
 #endif /* _SVR_JOBFUNC_H */
@@ -296,3 +296,80 @@ int  decrement_queued_jobs(
 
 
 
+
+/*
+ * reconcile_queued_jobs()
+ *
+ * Checks each user's count of queued jobs against a recount made by walking
+ * the jobs themselves. Every count that has drifted is logged and replaced by
+ * the recount, and users the holder is missing are added.
+ *
+ * @param uih - the holder whose counts are checked
+ * @param counted - the recounted number of queued jobs for each user
+ * @return the number of users whose count was wrong
+ */
+
+int reconcile_queued_jobs(
+
+  user_info_holder                    *uih,
+  std::map<std::string, unsigned int> &counted)
+
+  {
+  user_info                                     *ui;
+  user_info_holder_iterator                     *iter;
+  std::map<std::string, unsigned int>::iterator  it;
+  unsigned int                                   expected;
+  int                                            wrong = 0;
+  char                                           log_buf[LOCAL_LOG_BUF_SIZE];
+
+  uih->lock();
+
+  iter = uih->get_iterator();
+
+  while ((ui = iter->get_next_item()) != NULL)
+    {
+    expected = 0;
+
+    if ((it = counted.find(ui->user_name)) != counted.end())
+      expected = it->second;
+
+    if ((unsigned int)ui->num_jobs_queued != expected)
+      {
+      snprintf(log_buf, sizeof(log_buf),
+        "user %s has %d jobs counted as queued but %u are queued",
+        ui->user_name, ui->num_jobs_queued, expected);
+      log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+
+      ui->num_jobs_queued = expected;
+      wrong++;
+      }
+    }
+
+  delete iter;
+
+  for (it = counted.begin(); it != counted.end(); it++)
+    {
+    if ((it->second == 0) ||
+        (uih->find(it->first) != NULL))
+      continue;
+
+    snprintf(log_buf, sizeof(log_buf),
+      "user %s has no queued job count but %u are queued",
+      it->first.c_str(), it->second);
+    log_event(PBSEVENT_ERROR, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+
+    ui = (user_info *)calloc(1, sizeof(user_info));
+    ui->user_name = strdup(it->first.c_str());
+    ui->num_jobs_queued = it->second;
+
+    if (!uih->insert(ui, ui->user_name))
+      log_err(ENOMEM, __func__, "Can't resize the user info array");
+
+    wrong++;
+    }
+
+  uih->unlock();
+
+  return(wrong);
+  } /* END reconcile_queued_jobs() */
+
@@ -4,12 +4,19 @@
 #include <stdio.h>
 #include <string>
 #include "pbs_error.h"
+#include <unistd.h>
+#include <sys/stat.h>
 #include "pbs_job.h"
+#include "acct.h"
+#include "acct_usage.h"
 #include "test_accounting.h"
 
 
 extern char *acct_file;
+extern pthread_mutex_t *acctfile_mutex;
 void add_procs_and_nodes_used(job &pjob, std::string &acct_data);
+void fill_usage_record(job &pjob, long end_time, acct_usage_record &rec);
+void account_usage(job *pjob, long end_time);
 const char *exec1 = "napali/0+napali/1+napali/2+napali/3+napali/4+napali/5";
 const char *exec2 = "2/0+2/1+2/2+2/3+3/0+3/1+3/2+3/3+4/0+4/1+4/2+4/3";
 const char *exec3 = "2/0-31+3/0-31+4/0-31+5/0-31+6/0-31+7/0-31+8/0-31+9/0-31+10/0-31";
@@ -41,10 +48,152 @@ START_TEST(test_add_procs_and_nodes_used)
   }
 END_TEST
 
-START_TEST(test_two)
+START_TEST(test_account_record_buffered)
   {
+  char        path[] = "/tmp/acct_test_XXXXXX";
+  int         fd = mkstemp(path);
+  job         pjob;
+  struct stat sb;
+  char        buf[256];
+  FILE       *fp;
 
+  fail_unless(fd >= 0);
+  close(fd);
 
+  strcpy(pjob.ji_qs.ji_jobid, "1.napali");
+  fail_unless(acct_open(path, false) == 0);
+
+  // records wait in the buffer until they are flushed
+  account_record(PBS_ACCT_QUEUE, &pjob, "queue=batch");
+  account_record(PBS_ACCT_DEL, &pjob, NULL);
+  acct_flush();
+
+  fail_unless(stat(path, &sb) == 0);
+  fail_unless(sb.st_size > 0);
+
+  fp = fopen(path, "r");
+  fail_unless(fgets(buf, sizeof(buf), fp) != NULL);
+  fail_unless(strstr(buf, ";Q;1.napali;queue=batch\n") != NULL, buf);
+  fail_unless(fgets(buf, sizeof(buf), fp) != NULL);
+  fail_unless(strstr(buf, ";D;1.napali;\n") != NULL, buf);
+  fclose(fp);
+
+  // closing writes anything left
+  account_record(PBS_ACCT_ABT, &pjob, "");
+  acct_close(false);
+  fail_unless(stat(path, &sb) == 0);
+  fail_unless(sb.st_size > 0);
+  fp = fopen(path, "r");
+  int lines = 0;
+  while (fgets(buf, sizeof(buf), fp) != NULL)
+    lines++;
+  fclose(fp);
+  fail_unless(lines == 3);
+
+  unlink(path);
+  }
+END_TEST
+
+
+
+START_TEST(test_fill_usage_record)
+  {
+  job               pjob;
+  acct_usage_record rec;
+
+  strcpy(pjob.ji_qs.ji_jobid, "2.napali");
+  strcpy(pjob.ji_qs.ji_queue, "batch");
+  pjob.ji_wattr[JOB_ATR_euser].at_val.at_str = strdup("dbeer");
+  pjob.ji_wattr[JOB_ATR_egroup].at_val.at_str = strdup("staff");
+  pjob.ji_wattr[JOB_ATR_account].at_val.at_str = strdup("proj1");
+  pjob.ji_wattr[JOB_ATR_exec_host].at_val.at_str = strdup(exec2);
+  pjob.ji_wattr[JOB_ATR_exitstat].at_val.at_long = 3;
+  pjob.ji_wattr[JOB_ATR_start_time].at_val.at_long = 1000;
+
+  fill_usage_record(pjob, 2000, rec);
+  fail_unless(!strcmp(rec.ur_job_id, "2.napali"));
+  fail_unless(!strcmp(rec.ur_user, "dbeer"));
+  fail_unless(!strcmp(rec.ur_group, "staff"));
+  fail_unless(!strcmp(rec.ur_queue, "batch"));
+  fail_unless(!strcmp(rec.ur_account, "proj1"));
+  fail_unless(rec.ur_slots == 12);
+  fail_unless(rec.ur_nodes == 3);
+  fail_unless(rec.ur_exit_status == 3);
+  fail_unless(rec.ur_start == 1000);
+  fail_unless(rec.ur_end == 2000);
+  fail_unless(rec.ur_type == PBS_ACCT_END);
+  }
+END_TEST
+
+
+
+START_TEST(test_usage_sidecar)
+  {
+  char                     path[] = "/tmp/acct_usage_XXXXXX";
+  int                      fd = mkstemp(path);
+  std::string              usage_path;
+  std::string              index_path;
+  job                      pjob;
+  acct_usage_header        header;
+  acct_usage_index_header  ih;
+  acct_usage_index_entry   entries[2];
+  uint32_t                 numbers[3];
+  struct stat              sb;
+  FILE                    *fp;
+
+  fail_unless(fd >= 0);
+  close(fd);
+  usage_path = std::string(path) + ACCT_USAGE_SUFFIX;
+  index_path = std::string(path) + ACCT_USAGE_INDEX_SUFFIX;
+
+  strcpy(pjob.ji_qs.ji_jobid, "3.napali");
+  pjob.ji_wattr[JOB_ATR_euser].at_val.at_str = strdup("dbeer");
+
+  fail_unless(acct_open(path, false) == 0);
+  acct_usage_enable(true);
+  account_usage(&pjob, 100);
+
+  pjob.ji_wattr[JOB_ATR_euser].at_val.at_str = strdup("tom");
+  account_usage(&pjob, 200);
+  acct_close(false);
+
+  fail_unless(stat(usage_path.c_str(), &sb) == 0);
+  fail_unless(sb.st_size == sizeof(acct_usage_header) + 2 * sizeof(acct_usage_record));
+
+  fp = fopen(usage_path.c_str(), "r");
+  fail_unless(fread(&header, sizeof(header), 1, fp) == 1);
+  fclose(fp);
+  fail_unless(header.uh_magic == ACCT_USAGE_MAGIC);
+  fail_unless(header.uh_record_size == sizeof(acct_usage_record));
+
+  // reopening continues the file and its index
+  fail_unless(acct_open(path, false) == 0);
+  pjob.ji_wattr[JOB_ATR_euser].at_val.at_str = strdup("dbeer");
+  account_usage(&pjob, 300);
+  acct_close(false);
+
+  fp = fopen(index_path.c_str(), "r");
+  fail_unless(fp != NULL);
+  fail_unless(fread(&ih, sizeof(ih), 1, fp) == 1);
+  fail_unless(ih.uih_magic == ACCT_USAGE_INDEX_MAGIC);
+  fail_unless(ih.uih_user_count == 2);
+  fail_unless(ih.uih_record_count == 3);
+  fail_unless(fread(entries, sizeof(entries[0]), 2, fp) == 2);
+  fail_unless(fread(numbers, sizeof(numbers[0]), 3, fp) == 3);
+  fclose(fp);
+
+  fail_unless(!strcmp(entries[0].uie_user, "dbeer"));
+  fail_unless(entries[0].uie_count == 2);
+  fail_unless(numbers[entries[0].uie_first] == 0);
+  fail_unless(numbers[entries[0].uie_first + 1] == 2);
+  fail_unless(!strcmp(entries[1].uie_user, "tom"));
+  fail_unless(entries[1].uie_count == 1);
+  fail_unless(numbers[entries[1].uie_first] == 1);
+
+  acct_usage_enable(false);
+  unlink(path);
+  unlink(usage_path.c_str());
+  unlink(index_path.c_str());
   }
 END_TEST
 
@@ -55,8 +204,10 @@ Suite *accounting_suite(void)
   tcase_add_test(tc_core, test_add_procs_and_nodes_used);
   suite_add_tcase(s, tc_core);
 
-  tc_core = tcase_create("test_two");
-  tcase_add_test(tc_core, test_two);
+  tc_core = tcase_create("test_account_record_buffered");
+  tcase_add_test(tc_core, test_account_record_buffered);
+  tcase_add_test(tc_core, test_fill_usage_record);
+  tcase_add_test(tc_core, test_usage_sidecar);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -71,6 +222,8 @@ int main(void)
   int number_failed = 0;
   SRunner *sr = NULL;
   rundebug();
+  acctfile_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(acctfile_mutex, NULL);
   sr = srunner_create(accounting_suite());
   srunner_set_log(sr, "accounting_suite.log");
   srunner_run_all(sr, CK_NORMAL);
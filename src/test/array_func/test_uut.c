@@ -36,12 +36,11 @@ job_array *get_job_array(
   char       buf[1024];
   job_array *pa = new job_array();
   pa->ai_qs.num_jobs = size;
-  pa->job_ids = (char **)calloc(size, sizeof(char *));
 
   for (int i = 0; i < size; i++)
     {
     snprintf(buf, sizeof(buf), "0[%d].napali", i);
-    pa->job_ids[i] = strdup(buf);
+    pa->set_job_id(i, buf);
     }
 
   return(pa);
@@ -220,17 +219,16 @@ START_TEST(first_job_index_test)
   int index;
   char buf[4096];
 
-  pa.job_ids = (char **)calloc(10, sizeof(char *));
   pa.ai_qs.array_size = 10;
 
   fail_unless(first_job_index(&pa) == -1, "no jobs fail");
   
-  pa.job_ids[8] = strdup("bob");
+  pa.set_job_id(8, "bob");
   index = first_job_index(&pa);
   snprintf(buf, sizeof(buf), "first job index should be 8 but is %d", index);
   fail_unless(index == 8, buf);
 
-  pa.job_ids[4] = strdup("tom");
+  pa.set_job_id(4, "tom");
   index = first_job_index(&pa);
   snprintf(buf, sizeof(buf), "first job index should be 4 but is %d", index);
   fail_unless(index == 4, buf);
@@ -256,7 +254,6 @@ START_TEST(array_delete_test)
   job_array *pa;
 
   pa = new job_array();
-  pa->job_ids = (char **)calloc(10, sizeof(char *));
   pa->ai_qs.array_size = 10;
 
   //Set up the save path
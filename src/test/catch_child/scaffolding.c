@@ -21,6 +21,7 @@
 #include "mom_job_cleanup.h"
 #include "complete_req.hpp"
 #include "json/json.h"
+#include "event_trace.h"
 
 int server_down;
 int called_open_socket = 0;
@@ -690,6 +691,8 @@ int tm_reply(tcp_chan *, int com, int i)
   return 0;
   }
 
+void tm_batch_obit(job *pjob, int id, task *ptask) {}
+
 int diswsl(struct tcp_chan *chan, long value)
   {
   return 0;
@@ -988,6 +991,11 @@ int encode_DIS_JobObit(struct tcp_chan *chan, struct batch_request *preq)
   return rc;
   }
 
+int encode_DIS_JobObitBatch(struct tcp_chan *chan, struct batch_request *preq)
+  {
+  return(0);
+  }
+
 void free_br(struct batch_request *preq)
   {
   }
@@ -1406,6 +1414,17 @@ int complete_req::get_task_stats(unsigned int &req_index, std::vector<int> &task
   return(0);
   }
 
+job *mom_find_job(const char *jobid)
+  {
+  for (std::list<job *>::iterator it = alljobs_list.begin(); it != alljobs_list.end(); it++)
+    {
+    if (!strcmp((*it)->ji_qs.ji_jobid, jobid))
+      return(*it);
+    }
+
+  return(NULL);
+  }
+
 void set_jobs_substate(job *pjob, int substate)
   {
   pjob->ji_qs.ji_substate = substate;
@@ -1418,3 +1437,10 @@ int send_back_std_and_staged_files(job *pjob, int exit_value)
 
 
 task::~task() {}
+
+void trace_event(int event, const char *job_id, uint64_t duration, int value) {}
+
+uint64_t trace_elapsed(time_t since)
+  {
+  return(0);
+  }
@@ -12,6 +12,9 @@ void check_jobs_main_process(job *pjob, task *ptask);
 bool non_mother_superior_cleanup(job *pjob);
 bool mother_superior_cleanup(job *pjob, int limit, int *found);
 void *obit_reply(void *new_sock);
+void *obit_batch_reply(void *new_sock);
+int send_job_obit(job *pjob, int ev);
+void send_pending_obits(void);
 hnodent *get_node(job *pjob, tm_node_id nodeid);
 
 extern int termin_child;
@@ -23,6 +26,8 @@ extern int  called_open_socket;
 extern int  called_fork_me;
 extern bool eintr_test;
 extern std::vector<exiting_job_info> exiting_job_list;
+extern std::list<job *> alljobs_list;
+extern std::vector<std::string> pending_obits;
 
 
 /*
@@ -104,6 +109,72 @@ START_TEST(obit_reply_test)
   }
 END_TEST
 
+START_TEST(send_pending_obits_test)
+  {
+  job *pjob1 = (job *)calloc(1, sizeof(job));
+  job *pjob2 = (job *)calloc(1, sizeof(job));
+
+  strcpy(pjob1->ji_qs.ji_jobid, "1.napali");
+  strcpy(pjob2->ji_qs.ji_jobid, "2.napali");
+  pjob1->ji_wattr[JOB_ATR_at_server].at_val.at_str = strdup("napali");
+  pjob2->ji_wattr[JOB_ATR_at_server].at_val.at_str = strdup("napali");
+  pjob1->ji_momhandle = -1;
+  pjob2->ji_momhandle = -1;
+
+  alljobs_list.clear();
+  alljobs_list.push_back(pjob1);
+  alljobs_list.push_back(pjob2);
+
+  // obits are only queued, and only once per job
+  called_open_socket = 0;
+  send_job_obit(pjob1, 0);
+  send_job_obit(pjob2, 0);
+  send_job_obit(pjob1, 0);
+  fail_unless(pending_obits.size() == 2);
+  fail_unless(called_open_socket == 0);
+  fail_unless(pjob1->ji_qs.ji_substate == JOB_SUBSTATE_OBIT);
+
+  // both go out in one batch
+  send_pending_obits();
+  fail_unless(pending_obits.size() == 0);
+  fail_unless(called_open_socket == 1);
+  fail_unless(pjob1->ji_momhandle == 1);
+  fail_unless(pjob2->ji_momhandle == 1);
+
+  // a reply without the jobs' codes makes both retry
+  int sock = 1;
+  obit_batch_reply(&sock);
+  fail_unless(pjob1->ji_momhandle == -1);
+  fail_unless(pjob1->ji_qs.ji_substate == JOB_SUBSTATE_EXITING);
+  fail_unless(pjob2->ji_qs.ji_substate == JOB_SUBSTATE_EXITING);
+
+  // a job that left JOB_SUBSTATE_OBIT before the send is skipped
+  called_open_socket = 0;
+  send_job_obit(pjob1, 0);
+  pjob1->ji_qs.ji_substate = JOB_SUBSTATE_EXITED;
+  send_pending_obits();
+  fail_unless(called_open_socket == 0);
+
+  // with no reply to a batch, the obits are resent one at a time...
+  send_job_obit(pjob1, 0);
+  send_job_obit(pjob2, 0);
+  send_pending_obits();
+  fail_unless(called_open_socket == 1);
+  eintr_test = true;
+  obit_batch_reply(&sock);
+  eintr_test = false;
+  fail_unless(called_open_socket == 3);
+
+  // ...and so are that server's next obits
+  send_job_obit(pjob1, 0);
+  send_job_obit(pjob2, 0);
+  send_pending_obits();
+  fail_unless(called_open_socket == 5);
+
+  alljobs_list.clear();
+  }
+END_TEST
+
 START_TEST(test_catch_child_1)
   {
   termin_child = 0;
@@ -206,6 +277,7 @@ Suite *catch_child_suite(void)
   TCase *tc_core = tcase_create("Core");
   tcase_add_test(tc_core, test_catch_child_1);
   tcase_add_test(tc_core, obit_reply_test);
+  tcase_add_test(tc_core, send_pending_obits_test);
   tcase_add_test(tc_core, test_eligible_for_exiting_check);
   tcase_add_test(tc_core, test_jobs_main_process);
   tcase_add_test(tc_core, test_non_mother_superior_cleanup);
@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "completed_job_store.hpp"
+#include "pbs_error.h"
+
+#include <check.h>
+
+const char *spill_file = "./completed_jobs_test";
+
+
+void make_job(
+
+  int                              i,
+  time_t                           expires,
+  completed_job_info              &info,
+  std::vector<completed_job_attr> &attrs,
+  size_t                           value_size)
+
+  {
+  completed_job_attr ca;
+  char               buf[64];
+
+  info.ci_owner = "dbeer@napali";
+  info.ci_submit_host = "napali";
+  info.ci_queue = (i % 2 == 0) ? "batch" : "short";
+  info.ci_mod_time = 100;
+  info.ci_expires = expires;
+
+  attrs.clear();
+
+  snprintf(buf, sizeof(buf), "job%d", i);
+  ca.ca_index = 0;
+  ca.ca_name = "Job_Name";
+  ca.ca_value = buf;
+  attrs.push_back(ca);
+
+  ca.ca_index = 5;
+  ca.ca_name = "resources_used";
+  ca.ca_resc = "walltime";
+  ca.ca_value = std::string(value_size, '1');
+  attrs.push_back(ca);
+  }
+
+
+START_TEST(test_encode_decode)
+  {
+  completed_job_info              info;
+  completed_job_info              out_info;
+  std::vector<completed_job_attr> attrs;
+  std::vector<completed_job_attr> out_attrs;
+  std::string                     data;
+  std::string                     job_id;
+
+  make_job(1, 500, info, attrs, 8);
+
+  fail_unless(encode_completed_record("1.napali", info, attrs, data) == PBSE_NONE);
+  fail_unless(data.size() % 8 == 0);
+  fail_unless(decode_completed_record(data.c_str(), data.size(), job_id, out_info, &out_attrs) == true);
+  fail_unless(job_id == "1.napali");
+  fail_unless(out_info.ci_owner == "dbeer@napali");
+  fail_unless(out_info.ci_queue == "short");
+  fail_unless(out_info.ci_expires == 500);
+  fail_unless(out_attrs.size() == 2);
+  fail_unless(out_attrs[1].ca_index == 5);
+  fail_unless(out_attrs[1].ca_resc == "walltime");
+  fail_unless(out_attrs[1].ca_value == "11111111");
+
+  // a truncated record is rejected
+  fail_unless(decode_completed_record(data.c_str(), data.size() - 16, job_id, out_info, &out_attrs) == false);
+  fail_unless(encode_completed_record(NULL, info, attrs, data) != PBSE_NONE);
+  }
+END_TEST
+
+
+START_TEST(test_add_get_expire)
+  {
+  completed_job_store             store;
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+  std::vector<std::string>        ids;
+
+  make_job(1, 200, info, attrs, 8);
+  fail_unless(store.add_job("1.napali", info, attrs) == true);
+  fail_unless(store.add_job("1.napali", info, attrs) == false);
+
+  make_job(2, 100, info, attrs, 8);
+  fail_unless(store.add_job("2.napali", info, attrs) == true);
+
+  fail_unless(store.has_job("1.napali") == true);
+  fail_unless(store.has_job("3.napali") == false);
+  fail_unless(store.count() == 2);
+
+  fail_unless(store.get_job("2.napali", info, attrs) == true);
+  fail_unless(attrs[0].ca_value == "job2");
+  fail_unless(store.get_job("3.napali", info, attrs) == false);
+
+  store.get_job_ids("batch", ids);
+  fail_unless(ids.size() == 1);
+  fail_unless(ids[0] == "2.napali");
+  ids.clear();
+  store.get_job_ids(NULL, ids);
+  fail_unless(ids.size() == 2);
+
+  fail_unless(store.cleanup_expired(99) == 0);
+  fail_unless(store.cleanup_expired(150) == 1);
+  fail_unless(store.has_job("2.napali") == false);
+  fail_unless(store.remove_job("1.napali") == true);
+  fail_unless(store.remove_job("1.napali") == false);
+  fail_unless(store.count() == 0);
+  }
+END_TEST
+
+
+START_TEST(test_spill_and_recover)
+  {
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+  time_t                          later = time(NULL) + 3600;
+
+  unlink(spill_file);
+
+    {
+    completed_job_store store;
+
+    // a record held in memory moves into the file
+    make_job(1, later, info, attrs, 8);
+    fail_unless(store.add_job("1.napali", info, attrs) == true);
+    fail_unless(store.set_spill_file(spill_file) == PBSE_NONE);
+    fail_unless(store.is_spilled() == true);
+
+    make_job(2, later, info, attrs, 8);
+    fail_unless(store.add_job("2.napali", info, attrs) == true);
+    make_job(3, later, info, attrs, 8);
+    fail_unless(store.add_job("3.napali", info, attrs) == true);
+    fail_unless(store.remove_job("3.napali") == true);
+
+    fail_unless(store.get_job("1.napali", info, attrs) == true);
+    fail_unless(attrs[0].ca_value == "job1");
+    }
+
+  // a new server finds the live records and skips the removed one
+  completed_job_store store;
+
+  fail_unless(store.set_spill_file(spill_file) == PBSE_NONE);
+  fail_unless(store.count() == 2);
+  fail_unless(store.get_job("2.napali", info, attrs) == true);
+  fail_unless(attrs[0].ca_value == "job2");
+  fail_unless(store.has_job("3.napali") == false);
+
+  // going back to memory keeps the records and drops the file
+  fail_unless(store.set_spill_file(NULL) == PBSE_NONE);
+  fail_unless(store.is_spilled() == false);
+  fail_unless(access(spill_file, F_OK) != 0);
+  fail_unless(store.get_job("1.napali", info, attrs) == true);
+  fail_unless(attrs[0].ca_value == "job1");
+  }
+END_TEST
+
+
+START_TEST(test_spill_compaction)
+  {
+  completed_job_store             store;
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+  char                            job_id[64];
+
+  unlink(spill_file);
+  fail_unless(store.set_spill_file(spill_file) == PBSE_NONE);
+
+  // about 4MB of records, all but the last of which expire at 100
+  for (int i = 0; i < 4000; i++)
+    {
+    snprintf(job_id, sizeof(job_id), "%d.napali", i);
+    make_job(i, (i == 3999) ? time(NULL) + 3600 : 100, info, attrs, 1000);
+    fail_unless(store.add_job(job_id, info, attrs) == true);
+    }
+
+  fail_unless(store.spill_bytes_used() > 4000 * 1000);
+  fail_unless(store.cleanup_expired(200) == 3999);
+
+  // the dead records were squeezed out and the survivor is intact
+  fail_unless(store.spill_bytes_used() < 2000);
+  fail_unless(store.get_job("3999.napali", info, attrs) == true);
+  fail_unless(attrs[0].ca_value == "job3999");
+  fail_unless(attrs[1].ca_value.size() == 1000);
+
+  fail_unless(store.set_spill_file(NULL) == PBSE_NONE);
+  }
+END_TEST
+
+
+Suite *completed_job_store_suite(void)
+  {
+  Suite *s = suite_create("completed_job_store test suite methods");
+  TCase *tc_core = tcase_create("test_encode_decode");
+  tcase_add_test(tc_core, test_encode_decode);
+  tcase_add_test(tc_core, test_add_get_expire);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_spill_and_recover");
+  tcase_add_test(tc_core, test_spill_and_recover);
+  tcase_add_test(tc_core, test_spill_compaction);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(completed_job_store_suite());
+  srunner_set_log(sr, "completed_job_store_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -26,11 +26,36 @@ END_TEST
 
 
 
+START_TEST(test_progress)
+  {
+  delete_all_tracker dat;
+  int                handled = -1;
+  int                total = -1;
+
+  fail_unless(dat.get_progress("dbeer", 0, handled, total) == false);
+
+  fail_unless(dat.start_deleting_all_if_possible("dbeer", 0) == true);
+  dat.update_progress("dbeer", 0, 1000, 5000);
+  fail_unless(dat.get_progress("dbeer", 0, handled, total) == true);
+  fail_unless(handled == 1000);
+  fail_unless(total == 5000);
+
+  // managers share one entry
+  fail_unless(dat.get_progress("root", 0x20, handled, total) == false);
+
+  dat.done_deleting_all("dbeer", 0);
+  fail_unless(dat.get_progress("dbeer", 0, handled, total) == false);
+  }
+END_TEST
+
+
+
 Suite *delete_all_tracker_suite(void)
   {
   Suite *s = suite_create("delete_all_tracker test suite methods");
   TCase *tc_core = tcase_create("test_basic_functionality");
   tcase_add_test(tc_core, test_basic_functionality);
+  tcase_add_test(tc_core, test_progress);
   suite_add_tcase(s, tc_core);
   
   return(s);
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "dependency_graph.hpp"
+#include "pbs_job.h"
+
+/*
+ * Synthetic dependency DAG benchmark. Not part of make check: build it with
+ * "make bench_dag" and run it as ./bench_dag [scale].
+ *
+ * Builds layered DAGs of about 100k edges at scale 1, where each job depends
+ * on several jobs of the layer before it, then finishes the jobs layer by
+ * layer the way release_local_dependents() does, and prints how long building
+ * and releasing the edges took.
+ */
+
+long elapsed_usec(
+
+  struct timeval *start,
+  struct timeval *end)
+
+  {
+  return((end->tv_sec - start->tv_sec) * 1000000 + (end->tv_usec - start->tv_usec));
+  } /* END elapsed_usec() */
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  int scale = 1;
+
+  if (argc > 1)
+    scale = atoi(argv[1]);
+
+  if (scale < 1)
+    {
+    fprintf(stderr, "usage: %s [scale >= 1]\n", argv[0]);
+    return(1);
+    }
+
+  int shapes[][3] = { { 20, 1000 * scale, 5 }, { 2, 20000 * scale, 5 }, { 100000 * scale, 1, 1 } };
+
+  for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++)
+    {
+    dependency_graph             graph;
+    std::vector<dependency_edge> out;
+    int                          nlayers = shapes[s][0];
+    int                          nwidth = shapes[s][1];
+    int                          nfan = shapes[s][2];
+    char                         parent[64];
+    char                         child[64];
+    struct timeval               start;
+    struct timeval               built;
+    struct timeval               end;
+    unsigned long                edges = 0;
+    int                          ready = 0;
+
+    srand(s + 1);
+    gettimeofday(&start, NULL);
+
+    for (int l = 1; l < nlayers + 1; l++)
+      {
+      for (int w = 0; w < nwidth; w++)
+        {
+        snprintf(child, sizeof(child), "%d.napali", l * nwidth + w);
+
+        for (int f = 0; f < nfan; f++)
+          {
+          snprintf(parent, sizeof(parent), "%d.napali", (l - 1) * nwidth + ((w + f * 7 + rand() % 3) % nwidth));
+
+          if (graph.add_edge(parent, child, JOB_DEPEND_TYPE_AFTEROK) == true)
+            edges++;
+          }
+        }
+      }
+
+    gettimeofday(&built, NULL);
+
+    for (int l = 0; l < nlayers; l++)
+      {
+      for (int w = 0; w < nwidth; w++)
+        {
+        snprintf(parent, sizeof(parent), "%d.napali", l * nwidth + w);
+        graph.get_dependents(parent, out);
+
+        for (size_t i = 0; i < out.size(); i++)
+          {
+          if (graph.satisfy_edge(parent, out[i].de_job.c_str()) == 0)
+            ready++;
+          }
+
+        graph.remove_job(parent);
+        }
+      }
+
+    gettimeofday(&end, NULL);
+
+    if ((ready != nlayers * nwidth) ||
+        (graph.edge_count() != 0))
+      fprintf(stderr, "dag %d x %d: %d of %d jobs became ready\n", nlayers, nwidth, ready, nlayers * nwidth);
+
+    printf("dag %6d x %6d, fan-in %d: %7lu edges built in %8ld usec, released in %8ld usec\n",
+      nlayers, nwidth, nfan, edges, elapsed_usec(&start, &built), elapsed_usec(&built, &end));
+    }
+
+  return(0);
+  } /* END main() */
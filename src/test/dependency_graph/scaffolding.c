@@ -0,0 +1,4 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+int    LOGLEVEL = 10;
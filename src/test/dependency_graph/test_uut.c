@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dependency_graph.hpp"
+#include "pbs_job.h"
+
+#include <check.h>
+
+
+START_TEST(test_edges)
+  {
+  dependency_graph             graph;
+  std::vector<dependency_edge> out;
+
+  fail_unless(graph.add_edge("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTEROK) == true);
+  fail_unless(graph.add_edge("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTEROK) == false);
+  fail_unless(graph.add_edge("1.napali", "3.napali", JOB_DEPEND_TYPE_AFTERANY) == true);
+  fail_unless(graph.add_edge("4.napali", "3.napali", JOB_DEPEND_TYPE_AFTEROK) == true);
+  fail_unless(graph.add_edge(NULL, "3.napali", JOB_DEPEND_TYPE_AFTEROK) == false);
+  fail_unless(graph.edge_count() == 3);
+
+  fail_unless(graph.has_edge("1.napali", "3.napali") == true);
+  fail_unless(graph.has_edge("3.napali", "1.napali") == false);
+  fail_unless(graph.get_unsatisfied("3.napali") == 2);
+  fail_unless(graph.get_unsatisfied("1.napali") == 0);
+
+  graph.get_dependents("1.napali", out);
+  fail_unless(out.size() == 2);
+  fail_unless(out[0].de_job == "2.napali");
+  fail_unless(out[1].de_type == JOB_DEPEND_TYPE_AFTERANY);
+
+  // 3 still waits on 4 after 1 releases it
+  fail_unless(graph.satisfy_edge("1.napali", "3.napali") == 1);
+  fail_unless(graph.satisfy_edge("1.napali", "3.napali") == -1);
+  fail_unless(graph.satisfy_edge("4.napali", "3.napali") == 0);
+  fail_unless(graph.get_unsatisfied("3.napali") == 0);
+
+  fail_unless(graph.remove_edge("1.napali", "2.napali") == true);
+  fail_unless(graph.remove_edge("1.napali", "2.napali") == false);
+  fail_unless(graph.edge_count() == 0);
+  }
+END_TEST
+
+
+START_TEST(test_remove_job)
+  {
+  dependency_graph graph;
+
+  graph.add_edge("1.napali", "2.napali", JOB_DEPEND_TYPE_AFTEROK);
+  graph.add_edge("1.napali", "3.napali", JOB_DEPEND_TYPE_AFTEROK);
+  graph.add_edge("2.napali", "3.napali", JOB_DEPEND_TYPE_AFTEROK);
+
+  // a purged parent's edges go, but its dependents stay held
+  graph.remove_job("1.napali");
+  fail_unless(graph.edge_count() == 1);
+  fail_unless(graph.has_edge("1.napali", "2.napali") == false);
+  fail_unless(graph.get_unsatisfied("3.napali") == 2);
+
+  graph.remove_job("3.napali");
+  fail_unless(graph.get_unsatisfied("3.napali") == 0);
+  fail_unless(graph.satisfy_edge("2.napali", "3.napali") == 0);
+  fail_unless(graph.edge_count() == 0);
+  }
+END_TEST
+
+
+/*
+ * Builds layered DAGs of up to about 10k edges, where each job depends on several
+ * jobs of the layer before it, then finishes the jobs layer by layer and checks
+ * every job becomes ready exactly when its last parent finishes.
+ */
+
+START_TEST(test_synthetic_dag)
+  {
+  const int layers = 10;
+  const int width = 200;
+  const int fan_in = 5;
+  int       shapes[][3] = { { layers, width, fan_in }, { 2, 2000, 5 }, { 10000, 1, 1 } };
+
+  for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++)
+    {
+    dependency_graph             graph;
+    std::vector<dependency_edge> out;
+    int                          nlayers = shapes[s][0];
+    int                          nwidth = shapes[s][1];
+    int                          nfan = shapes[s][2];
+    char                         parent[64];
+    char                         child[64];
+    unsigned long                edges = 0;
+    int                          ready = 0;
+
+    srand(s + 1);
+
+    for (int l = 1; l < nlayers + 1; l++)
+      {
+      for (int w = 0; w < nwidth; w++)
+        {
+        snprintf(child, sizeof(child), "%d.napali", l * nwidth + w);
+
+        for (int f = 0; f < nfan; f++)
+          {
+          snprintf(parent, sizeof(parent), "%d.napali", (l - 1) * nwidth + ((w + f * 7 + rand() % 3) % nwidth));
+
+          if (graph.add_edge(parent, child, JOB_DEPEND_TYPE_AFTEROK) == true)
+            edges++;
+          }
+        }
+      }
+
+    fail_unless(graph.edge_count() == edges);
+
+    for (int l = 0; l < nlayers; l++)
+      {
+      for (int w = 0; w < nwidth; w++)
+        {
+        snprintf(parent, sizeof(parent), "%d.napali", l * nwidth + w);
+        graph.get_dependents(parent, out);
+
+        for (size_t i = 0; i < out.size(); i++)
+          {
+          int left = graph.satisfy_edge(parent, out[i].de_job.c_str());
+
+          fail_unless(left >= 0);
+
+          if (left == 0)
+            ready++;
+          }
+
+        graph.remove_job(parent);
+        }
+      }
+
+    fail_unless(ready == nlayers * nwidth, "%d of %d ready", ready, nlayers * nwidth);
+    fail_unless(graph.edge_count() == 0);
+    }
+  }
+END_TEST
+
+
+Suite *dependency_graph_suite(void)
+  {
+  Suite *s = suite_create("dependency_graph test suite methods");
+  TCase *tc_core = tcase_create("test_edges");
+  tcase_add_test(tc_core, test_edges);
+  tcase_add_test(tc_core, test_remove_job);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_synthetic_dag");
+  tcase_add_test(tc_core, test_synthetic_dag);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(dependency_graph_suite());
+  srunner_set_log(sr, "dependency_graph_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
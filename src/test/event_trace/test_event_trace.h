@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _EVENT_TRACE_CT_H
+#define _EVENT_TRACE_CT_H
+#include <check.h>
+
+Suite *event_trace_suite();
+
+#endif /* _EVENT_TRACE_CT_H */
@@ -0,0 +1,221 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "event_trace.h"
+#include "test_event_trace.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <vector>
+
+#include "pbs_error.h"
+
+
+/* reads every record of the only trace file in dir */
+int read_trace(
+
+  const char                *dir,
+  std::vector<trace_record> &records)
+
+  {
+  char         path[256];
+  char         date[16];
+  time_t       now = time(NULL);
+  struct tm    tm;
+  trace_record rec;
+  int          fd;
+
+  localtime_r(&now, &tm);
+  strftime(date, sizeof(date), "%Y%m%d", &tm);
+  snprintf(path, sizeof(path), "%s/%s%s", dir, date, TRACE_FILE_SUFFIX);
+
+  records.clear();
+
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return(-1);
+
+  while (read(fd, &rec, sizeof(rec)) == sizeof(rec))
+    records.push_back(rec);
+
+  close(fd);
+
+  return(records.size());
+  }
+
+
+void remove_trace(
+
+  const char *dir)
+
+  {
+  char cmd[256];
+
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+  system(cmd);
+  }
+
+
+START_TEST(test_trace_event)
+  {
+  char                      dir[] = "/tmp/event_trace_test.XXXXXX";
+  std::vector<trace_record> records;
+
+  fail_unless(mkdtemp(dir) != NULL);
+
+  // nothing is recorded until the trace is opened
+  trace_event(TRACE_JOB_QUEUED, "1.napali", 0, 0);
+  fail_unless(trace_is_open() == false);
+
+  fail_unless(trace_open(dir, TRACE_SOURCE_SERVER) == PBSE_NONE);
+  fail_unless(trace_is_open() == true);
+
+  trace_event(TRACE_JOB_QUEUED, "1.napali", 0, 0);
+  trace_event(TRACE_JOB_RUN, "1.napali", 5000000, 0);
+  trace_event(TRACE_JOB_OBIT, "1.napali", 60000000, 271);
+
+  // buffered until flushed
+  fail_unless(read_trace(dir, records) == 1);
+
+  trace_flush();
+  fail_unless(read_trace(dir, records) == 4);
+
+  fail_unless(records[0].tr_event == TRACE_FILE_HEADER);
+  fail_unless(records[0].tr_job_hash == TRACE_MAGIC);
+  fail_unless(records[0].tr_job_num == sizeof(trace_record));
+  fail_unless(records[0].tr_value == TRACE_VERSION);
+
+  fail_unless(records[1].tr_event == TRACE_JOB_QUEUED);
+  fail_unless(records[1].tr_job_num == 1);
+  fail_unless(records[1].tr_job_hash == trace_job_hash("1.napali"));
+  fail_unless(records[1].tr_source == TRACE_SOURCE_SERVER);
+
+  fail_unless(records[2].tr_event == TRACE_JOB_RUN);
+  fail_unless(records[2].tr_duration == 5000000);
+  fail_unless(records[2].tr_time >= records[1].tr_time);
+
+  fail_unless(records[3].tr_event == TRACE_JOB_OBIT);
+  fail_unless(records[3].tr_value == 271);
+
+  // a full buffer is written without a flush
+  for (int i = 0; i < TRACE_BUFFER_RECORDS; i++)
+    trace_event(TRACE_JOB_EXIT, "2.napali", 0, 0);
+
+  fail_unless(read_trace(dir, records) == 4 + TRACE_BUFFER_RECORDS);
+
+  // reopening an existing file doesn't add a second header
+  trace_close();
+  fail_unless(trace_is_open() == false);
+  trace_event(TRACE_JOB_EXIT, "2.napali", 0, 0);
+
+  fail_unless(trace_open(dir, TRACE_SOURCE_MOM) == PBSE_NONE);
+  trace_event(TRACE_JOB_START, "3.napali", 0, 1234);
+  trace_close();
+
+  fail_unless(read_trace(dir, records) == 5 + TRACE_BUFFER_RECORDS);
+  fail_unless(records.back().tr_event == TRACE_JOB_START);
+  fail_unless(records.back().tr_source == TRACE_SOURCE_MOM);
+  fail_unless(records.back().tr_value == 1234);
+
+  fail_unless(trace_open("/nonexistent/dir", TRACE_SOURCE_SERVER) != PBSE_NONE);
+  fail_unless(trace_is_open() == false);
+
+  remove_trace(dir);
+  }
+END_TEST
+
+
+START_TEST(test_trace_fork)
+  {
+  char                      dir[] = "/tmp/event_trace_test.XXXXXX";
+  std::vector<trace_record> records;
+  pid_t                     pid;
+  int                       status;
+
+  fail_unless(mkdtemp(dir) != NULL);
+  fail_unless(trace_open(dir, TRACE_SOURCE_MOM) == PBSE_NONE);
+
+  trace_event(TRACE_JOB_START, "1.napali", 0, 0);
+
+  // the child must neither write the parent's buffer nor trace on its own
+  if ((pid = fork()) == 0)
+    {
+    trace_event(TRACE_JOB_EXIT, "1.napali", 0, 0);
+    exit(trace_is_open() == true);
+    }
+
+  waitpid(pid, &status, 0);
+  fail_unless(WEXITSTATUS(status) == 0);
+
+  trace_close();
+
+  fail_unless(read_trace(dir, records) == 2);
+  fail_unless(records[1].tr_event == TRACE_JOB_START);
+
+  remove_trace(dir);
+  }
+END_TEST
+
+
+START_TEST(test_trace_helpers)
+  {
+  fail_unless(trace_job_hash("1.napali") == trace_job_hash("1.napali"));
+  fail_unless(trace_job_hash("1.napali") != trace_job_hash("1.napali2"));
+  fail_unless(trace_job_hash("") == 2166136261U);
+
+  fail_unless(trace_job_num("1234.napali") == 1234);
+  fail_unless(trace_job_num("12[3].napali") == 12);
+  fail_unless(trace_job_num("napali") == 0);
+
+  fail_unless(trace_elapsed(0) == 0);
+  fail_unless(trace_elapsed(time(NULL) + 100) == 0);
+  fail_unless(trace_elapsed(time(NULL) - 10) >= 10000000);
+
+  fail_unless(!strcmp(trace_event_name(TRACE_JOB_REQUEUE), "requeue"));
+  fail_unless(!strcmp(trace_event_name(TRACE_EVENT_COUNT), "unknown"));
+  fail_unless(!strcmp(trace_event_name(-1), "unknown"));
+
+  for (int i = 0; i < TRACE_EVENT_COUNT; i++)
+    fail_unless(trace_event_from_name(trace_event_name(i)) == i);
+
+  fail_unless(trace_event_from_name("EXIT") == TRACE_JOB_EXIT);
+  fail_unless(trace_event_from_name("bogus") == -1);
+
+  fail_unless(sizeof(trace_record) == 32);
+  }
+END_TEST
+
+
+Suite *event_trace_suite(void)
+  {
+  Suite *s = suite_create("event_trace_suite methods");
+  TCase *tc_core = tcase_create("test_trace_event");
+  tcase_add_test(tc_core, test_trace_event);
+  tcase_add_test(tc_core, test_trace_fork);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_trace_helpers");
+  tcase_add_test(tc_core, test_trace_helpers);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(event_trace_suite());
+  srunner_set_log(sr, "event_trace_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -193,6 +193,103 @@ START_TEST(test_occupied_iterator)
 END_TEST
 
 
+START_TEST(test_slot_bitset)
+  {
+  slot_bitset bits(130);
+
+  fail_unless(bits.size() == 130);
+  fail_unless(bits.count() == 0);
+  fail_unless(bits.find_next_set(0) == -1);
+  fail_unless(bits.find_next_clear(0) == 0);
+  fail_unless(bits.find_last_set() == -1);
+
+  bits.set(0);
+  bits.set(63);
+  bits.set(64);
+  bits.set(129);
+  fail_unless(bits.count() == 4);
+  fail_unless(bits.test(63) == true);
+  fail_unless(bits.test(62) == false);
+  fail_unless(bits.test(130) == false);
+  fail_unless(bits.find_next_set(1) == 63);
+  fail_unless(bits.find_next_set(65) == 129);
+  fail_unless(bits.find_next_clear(63) == 65);
+  fail_unless(bits.find_last_set() == 129);
+
+  // runs of clear bits: 1-62, 65-128
+  fail_unless(bits.find_clear_run(62, 0) == 1);
+  fail_unless(bits.find_clear_run(63, 0) == 65);
+  fail_unless(bits.find_clear_run(64, 0) == 65);
+  fail_unless(bits.find_clear_run(65, 0) == -1);
+
+  // shrinking drops the bits past the end
+  bits.resize(100);
+  fail_unless(bits.count() == 3);
+  bits.resize(130);
+  fail_unless(bits.test(129) == false);
+  fail_unless(bits.find_next_clear(101) == 101);
+
+  slot_bitset other(64);
+  other.set(63);
+  bits.subtract(other);
+  fail_unless(bits.test(63) == false);
+  fail_unless(bits.count() == 2);
+  }
+END_TEST
+
+
+START_TEST(test_reserve_last_free_slot)
+  {
+  // a 256 thread node with a single slot job on every slot
+  execution_slot_tracker              node(256);
+  std::vector<execution_slot_tracker> jobs(256);
+  int                                 free_slots[] = { 0, 63, 64, 127, 128, 200, 255 };
+
+  for (int i = 0; i < 256; i++)
+    {
+    fail_unless(node.reserve_execution_slots(1, jobs[i]) == PBSE_NONE);
+    fail_unless(jobs[i].is_occupied(i) == true);
+    }
+
+  fail_unless(node.get_number_free() == 0);
+
+  // the one free slot is found wherever it is in the bitset, and reserving
+  // and releasing it again leaves the node as it was
+  for (size_t f = 0; f < sizeof(free_slots) / sizeof(free_slots[0]); f++)
+    {
+    int slot = free_slots[f];
+
+    fail_unless(node.unreserve_execution_slots(jobs[slot]) == PBSE_NONE);
+    fail_unless(node.get_number_free() == 1);
+    fail_unless(node.is_occupied(slot) == false);
+
+    for (int i = 0; i < 100; i++)
+      {
+      execution_slot_tracker subset;
+
+      fail_unless(node.reserve_execution_slots(1, subset) == PBSE_NONE);
+      fail_unless(subset.is_occupied(slot) == true);
+      fail_unless(subset.get_number_free() == 255);
+      fail_unless(node.get_number_free() == 0);
+
+      fail_unless(node.unreserve_execution_slots(subset) == PBSE_NONE);
+      fail_unless(node.get_number_free() == 1);
+      }
+
+    execution_slot_tracker again;
+
+    fail_unless(node.reserve_execution_slot(slot, again) == PBSE_NONE);
+    fail_unless(node.get_number_free() == 0);
+    }
+
+  // a full node can't take another job
+  execution_slot_tracker job;
+
+  fail_unless(node.reserve_execution_slots(1, job) != PBSE_NONE);
+  }
+END_TEST
+
+
 Suite *execution_slot_tracker_suite(void)
   {
   Suite *s = suite_create("execution_slot_tracker test suite methods");
@@ -206,6 +303,11 @@ Suite *execution_slot_tracker_suite(void)
   tcase_add_test(tc_core, test_reserving);
   tcase_add_test(tc_core, test_occupied_iterator);
   tcase_add_test(tc_core, test_reserve_slot);
+  tcase_add_test(tc_core, test_slot_bitset);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_reserve_last_free_slot");
+  tcase_add_test(tc_core, test_reserve_last_free_slot);
   suite_add_tcase(s, tc_core);
   
   return(s);
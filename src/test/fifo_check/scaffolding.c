@@ -0,0 +1,63 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../scheduler.cc/samples/fifo/data_types.h"
+
+int LOGLEVEL = 10;
+
+resource_req *find_resource_req(resource_req *reqlist, const char *name)
+  {
+  while (reqlist != NULL && strcmp(reqlist -> name, name))
+    reqlist = reqlist -> next;
+
+  return reqlist;
+  }
+
+resource *find_resource(resource *reslist, const char *name)
+  {
+  while (reslist != NULL && strcmp(reslist -> name, name))
+    reslist = reslist -> next;
+
+  return reslist;
+  }
+
+void sched_log(int event, int cls, const char *name, const char *text)
+  {
+  }
+
+int pbs_rescquery(int c, char **resclist, int num_resc, int *available, int *allocated, int *reserved, int *down)
+  {
+  fprintf(stderr, "The call to pbs_rescquery needs to be mocked!!\n");
+  exit(1);
+  }
+
+token *get_token(char *tokenstring)
+  {
+  fprintf(stderr, "The call to get_token needs to be mocked!!\n");
+  exit(1);
+  }
+
+void free_token(token *token_ptr)
+  {
+  fprintf(stderr, "The call to free_token needs to be mocked!!\n");
+  exit(1);
+  }
+
+void token_account_record(int acctype, char *jobid, char *text)
+  {
+  fprintf(stderr, "The call to token_account_record needs to be mocked!!\n");
+  exit(1);
+  }
+
+int cmp_job_cput_asc(const void *j1, const void *j2) { return(0); }
+int cmp_job_cput_dsc(const void *j1, const void *j2) { return(0); }
+int cmp_job_mem_asc(const void *j1, const void *j2) { return(0); }
+int cmp_job_mem_dsc(const void *j1, const void *j2) { return(0); }
+int cmp_job_prio_asc(const void *j1, const void *j2) { return(0); }
+int cmp_job_prio_dsc(const void *j1, const void *j2) { return(0); }
+int cmp_job_walltime_asc(const void *j1, const void *j2) { return(0); }
+int cmp_job_walltime_dsc(const void *j1, const void *j2) { return(0); }
+int cmp_fair_share(const void *j1, const void *j2) { return(0); }
+int multi_sort(const void *j1, const void *j2) { return(0); }
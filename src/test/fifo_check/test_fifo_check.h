@@ -0,0 +1,9 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _FIFO_CHECK_CT_H
+#define _FIFO_CHECK_CT_H
+#include <check.h>
+
+#define FIFO_CHECK_SUITE 1
+Suite *fifo_check_suite();
+
+#endif /* _FIFO_CHECK_CT_H */
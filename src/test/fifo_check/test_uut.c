@@ -0,0 +1,256 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "test_fifo_check.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <dirent.h>
+
+#include "../../scheduler.cc/samples/fifo/globals.h"
+
+int find_available_node(job_info *jinfo, node_info **ninfo_arr, node_info **found);
+void check_job_feasibility(server_info *sinfo, job_info *jinfo);
+int feasible_node_result(job_info *jinfo, int *rc);
+int evaluate_job_feasibility(server_info *sinfo);
+
+#define TEST_NODES 8
+#define TEST_JOBS  1000
+
+node_info *make_node(
+
+  const char *name,
+  int         is_free,
+  float       max_load,
+  float       loadave)
+
+  {
+  node_info *ninfo = (node_info *)calloc(1, sizeof(node_info));
+
+  ninfo -> name = strdup(name);
+  ninfo -> arch = strdup("linux");
+  ninfo -> is_free = is_free;
+  ninfo -> max_load = max_load;
+  ninfo -> loadave = loadave;
+  ninfo -> physmem = 1024;
+
+  return(ninfo);
+  }
+
+job_info *make_job(
+
+  int ncpus)
+
+  {
+  job_info     *jinfo = (job_info *)calloc(1, sizeof(job_info));
+  resource_req *req = (resource_req *)calloc(1, sizeof(resource_req));
+
+  req -> name = strdup("ncpus");
+  req -> amount = ncpus;
+
+  jinfo -> resreq = req;
+  jinfo -> is_queued = 1;
+  jinfo -> feasible_rc = UNSPECIFIED;
+
+  return(jinfo);
+  }
+
+/* the number of threads in this process */
+int count_threads()
+
+  {
+  DIR           *dir = opendir("/proc/self/task");
+  struct dirent *entry;
+  int            count = 0;
+
+  fail_unless(dir != NULL);
+
+  while ((entry = readdir(dir)) != NULL)
+    {
+    if (entry -> d_name[0] != '.')
+      count++;
+    }
+
+  closedir(dir);
+
+  return(count);
+  }
+
+START_TEST(test_find_available_node)
+  {
+  node_info *nodes[4];
+  node_info *found;
+  job_info  *small = make_job(2);
+  job_info  *big = make_job(10);
+
+  nodes[0] = make_node("n0", 1, 4.0, 3.0);
+  nodes[1] = make_node("n1", 1, 8.0, 0.0);
+  nodes[2] = make_node("n2", 0, 16.0, 0.0);
+  nodes[3] = NULL;
+
+  cstat.load_balancing = 0;
+  fail_unless(find_available_node(big, nodes, &found) == 0);
+  fail_unless(found == NULL);
+
+  cstat.load_balancing = 1;
+  fail_unless(find_available_node(small, nodes, &found) == 0);
+  fail_unless(found == nodes[1]);
+
+  /* n2 would have room but isn't free */
+  fail_unless(find_available_node(big, nodes, &found) == NO_AVAILABLE_NODE);
+  fail_unless(found == NULL);
+  fail_unless(find_available_node(big, nodes, NULL) == NO_AVAILABLE_NODE);
+  }
+END_TEST
+
+START_TEST(test_feasible_node_result)
+  {
+  server_info   sinfo;
+  node_info    *nodes[3];
+  job_info     *small = make_job(2);
+  job_info     *big = make_job(10);
+  job_info     *by_nodes = make_job(1);
+  resource_req *req = (resource_req *)calloc(1, sizeof(resource_req));
+  int           rc;
+
+  nodes[0] = make_node("n0", 1, 4.0, 3.0);
+  nodes[1] = make_node("n1", 1, 8.0, 0.0);
+  nodes[2] = NULL;
+
+  memset(&sinfo, 0, sizeof(sinfo));
+  sinfo.timesharing_nodes = nodes;
+  cstat.load_balancing = 1;
+
+  /* nothing was checked yet */
+  fail_unless(feasible_node_result(small, &rc) == 0);
+
+  check_job_feasibility(&sinfo, small);
+  check_job_feasibility(&sinfo, big);
+
+  fail_unless(feasible_node_result(small, &rc) == 1);
+  fail_unless(rc == 0);
+  fail_unless(small -> feasible_node == nodes[1]);
+  fail_unless(feasible_node_result(big, &rc) == 1);
+  fail_unless(rc == NO_AVAILABLE_NODE);
+
+  /* raising the load of a node the job didn't fit on changes nothing */
+  nodes[0] -> loadave += 1;
+  nodes[0] -> load_gen++;
+  fail_unless(feasible_node_result(small, &rc) == 1);
+  fail_unless(rc == 0);
+
+  /* raising the load of the node the job fit on makes the result stale */
+  nodes[1] -> loadave += 7;
+  nodes[1] -> load_gen++;
+  fail_unless(feasible_node_result(small, &rc) == 0);
+
+  /* a job that fit nowhere still fits nowhere */
+  fail_unless(feasible_node_result(big, &rc) == 1);
+  fail_unless(rc == NO_AVAILABLE_NODE);
+
+  /* jobs that request nodes are left to pbs_rescquery() */
+  req -> name = strdup("nodes");
+  req -> res_str = strdup("2");
+  by_nodes -> resreq -> next = req;
+
+  check_job_feasibility(&sinfo, by_nodes);
+  fail_unless(by_nodes -> feasible_valid == 0);
+  fail_unless(feasible_node_result(by_nodes, &rc) == 0);
+  }
+END_TEST
+
+START_TEST(test_evaluate_job_feasibility)
+  {
+  server_info  sinfo;
+  node_info   *nodes[TEST_NODES + 1];
+  job_info   **jobs = (job_info **)calloc(TEST_JOBS + 1, sizeof(job_info *));
+  char         name[16];
+  node_info   *found;
+  int          rc;
+  int          threads;
+
+  for (int i = 0; i < TEST_NODES; i++)
+    {
+    snprintf(name, sizeof(name), "n%d", i);
+    nodes[i] = make_node(name, 1, 8.0, (float)i);
+    }
+
+  nodes[TEST_NODES] = NULL;
+
+  for (int i = 0; i < TEST_JOBS; i++)
+    jobs[i] = make_job(1 + i % 10);
+
+  /* jobs that can't be considered any more are skipped */
+  jobs[0] -> can_not_run = 1;
+  jobs[1] -> is_queued = 0;
+
+  memset(&sinfo, 0, sizeof(sinfo));
+  sinfo.jobs = jobs;
+  sinfo.timesharing_nodes = nodes;
+  sinfo.sc.total = TEST_JOBS;
+
+  conf.feasibility_threads = 4;
+
+  /* nothing to do when not load balancing */
+  cstat.load_balancing = 0;
+  fail_unless(evaluate_job_feasibility(&sinfo) == 0);
+  fail_unless(sinfo.feasibility_evaluated == 1);
+
+  cstat.load_balancing = 1;
+  fail_unless(evaluate_job_feasibility(&sinfo) == TEST_JOBS - 2);
+
+  fail_unless(jobs[0] -> feasible_valid == 0);
+  fail_unless(jobs[1] -> feasible_valid == 0);
+
+  /* every job gets the result of the sequential check */
+  for (int i = 2; i < TEST_JOBS; i++)
+    {
+    fail_unless(feasible_node_result(jobs[i], &rc) == 1);
+    fail_unless(rc == find_available_node(jobs[i], nodes, &found));
+    fail_unless(jobs[i] -> feasible_node == found);
+    }
+
+  /* the workers are started once and kept for the next pass */
+  threads = count_threads();
+  fail_unless(threads > 1);
+
+  for (int i = 2; i < TEST_JOBS; i++)
+    jobs[i] -> feasible_valid = 0;
+
+  fail_unless(evaluate_job_feasibility(&sinfo) == TEST_JOBS - 2);
+  fail_unless(count_threads() == threads);
+
+  /* jobs that were already checked aren't checked again */
+  fail_unless(evaluate_job_feasibility(&sinfo) == 0);
+  }
+END_TEST
+
+Suite *fifo_check_suite(void)
+  {
+  Suite *s = suite_create("fifo_check_suite methods");
+  TCase *tc_core = tcase_create("test_find_available_node");
+  tcase_add_test(tc_core, test_find_available_node);
+  tcase_add_test(tc_core, test_feasible_node_result);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_evaluate_job_feasibility");
+  tcase_add_test(tc_core, test_evaluate_job_feasibility);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(fifo_check_suite());
+  srunner_set_log(sr, "fifo_check_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
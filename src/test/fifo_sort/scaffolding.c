@@ -0,0 +1,14 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../scheduler.cc/samples/fifo/data_types.h"
+
+resource_req *find_resource_req(resource_req *reqlist, const char *name)
+  {
+  while (reqlist != NULL && strcmp(reqlist -> name, name))
+    reqlist = reqlist -> next;
+
+  return reqlist;
+  }
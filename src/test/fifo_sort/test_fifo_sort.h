@@ -0,0 +1,9 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _FIFO_SORT_CT_H
+#define _FIFO_SORT_CT_H
+#include <check.h>
+
+#define FIFO_SORT_SUITE 1
+Suite *fifo_sort_suite();
+
+#endif /* _FIFO_SORT_CT_H */
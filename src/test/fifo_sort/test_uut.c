@@ -0,0 +1,239 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "test_fifo_sort.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../scheduler.cc/samples/fifo/globals.h"
+#include "../../scheduler.cc/samples/fifo/sort.h"
+#include "../../scheduler.cc/samples/fifo/job_info.h"
+
+#define TEST_JOBS 300
+
+unsigned int test_seed = 1;
+
+/* small deterministic generator so the job set has plenty of ties */
+int next_value(
+
+  int range)
+
+  {
+  test_seed = test_seed * 1103515245 + 12345;
+
+  return((test_seed >> 16) % range);
+  }
+
+void add_req(
+
+  job_info       *jinfo,
+  const char     *name,
+  sch_resource_t  amount)
+
+  {
+  resource_req *req = (resource_req *)calloc(1, sizeof(resource_req));
+
+  req -> name = strdup(name);
+  req -> amount = amount;
+  req -> next = jinfo -> resreq;
+  jinfo -> resreq = req;
+  }
+
+job_info **make_jobs(
+
+  int num_jobs,
+  int with_resources)
+
+  {
+  job_info **jobs = (job_info **)calloc(num_jobs + 1, sizeof(job_info *));
+  char       name[32];
+
+  test_seed = 1;
+
+  for (int i = 0; i < num_jobs; i++)
+    {
+    job_info *jinfo = (job_info *)calloc(1, sizeof(job_info));
+
+    snprintf(name, sizeof(name), "%d.napali", next_value(50));
+    jinfo -> name = strdup(name);
+    jinfo -> priority = next_value(11) - 5;
+    jinfo -> sch_priority = next_value(3);
+    jinfo -> qtime = 1000 + next_value(5);
+
+    if ((with_resources) ||
+        (next_value(4) != 0))
+      {
+      add_req(jinfo, "walltime", 60 * (1 + next_value(4)));
+      add_req(jinfo, "cput", 30 * (1 + next_value(6)));
+      add_req(jinfo, "mem", 1024 * (1 + next_value(3)));
+      }
+
+    jobs[i] = jinfo;
+    }
+
+  return(jobs);
+  }
+
+/* stable insertion sort with a qsort compare function, ties keep their order */
+void comparator_sort(
+
+  job_info **jobs,
+  int        num_jobs,
+  int      (*cmp)(const void *, const void *))
+
+  {
+  for (int i = 1; i < num_jobs; i++)
+    {
+    job_info *jinfo = jobs[i];
+    int       j = i - 1;
+
+    while ((j >= 0) &&
+           (cmp(&jobs[j], &jinfo) > 0))
+      {
+      jobs[j + 1] = jobs[j];
+      j--;
+      }
+
+    jobs[j + 1] = jinfo;
+    }
+  }
+
+/* sorts the same jobs both ways and checks the orders are identical */
+void check_same_order(
+
+  int fifo)
+
+  {
+  job_info **radix = make_jobs(TEST_JOBS, 1);
+  job_info **compared = (job_info **)calloc(TEST_JOBS + 1, sizeof(job_info *));
+
+  memcpy(compared, radix, sizeof(job_info *) * TEST_JOBS);
+
+  sort_jobs(radix, TEST_JOBS, fifo);
+  comparator_sort(compared, TEST_JOBS, (fifo) ? fifo_sort : cmp_sort);
+
+  for (int i = 0; i < TEST_JOBS; i++)
+    fail_unless(radix[i] == compared[i], "job %d differs (%s != %s)", i, radix[i] -> name, compared[i] -> name);
+  }
+
+/* finds the sorting_info entry for a sort */
+struct sort_info find_sort(
+
+  enum sort_type sort)
+
+  {
+  for (int i = 0; i < num_sorts; i++)
+    {
+    if (sorting_info[i].sort == sort)
+      return(sorting_info[i]);
+    }
+
+  return(sorting_info[0]);
+  }
+
+
+START_TEST(test_single_sorts)
+  {
+  struct sort_info sorts[2];
+  enum sort_type   types[] = { SHORTEST_JOB_FIRST, LONGEST_JOB_FIRST, SMALLEST_MEM_FIRST,
+                               LARGEST_MEM_FIRST, HIGH_PRIORITY_FIRST, LOW_PRIORITY_FIRST,
+                               LARGE_WALLTIME_FIRST, SHORT_WALLTIME_FIRST };
+
+  sorts[1] = find_sort(NO_SORT);
+  cstat.sort_by = sorts;
+
+  for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+    {
+    sorts[0] = find_sort(types[i]);
+    check_same_order(0);
+    }
+  }
+END_TEST
+
+
+START_TEST(test_multi_sort)
+  {
+  struct sort_info sorts[5];
+
+  sorts[0] = find_sort(MULTI_SORT);
+  sorts[1] = find_sort(HIGH_PRIORITY_FIRST);
+  sorts[2] = find_sort(SHORT_WALLTIME_FIRST);
+  sorts[3] = find_sort(LARGEST_MEM_FIRST);
+  sorts[4] = find_sort(NO_SORT);
+  cstat.sort_by = sorts;
+
+  check_same_order(0);
+  }
+END_TEST
+
+
+START_TEST(test_fifo_sort)
+  {
+  check_same_order(1);
+  }
+END_TEST
+
+
+START_TEST(test_missing_resource)
+  {
+  struct sort_info sorts[2];
+  job_info       **jobs = make_jobs(TEST_JOBS, 0);
+  int              i;
+
+  sorts[0] = find_sort(SHORT_WALLTIME_FIRST);
+  sorts[1] = find_sort(NO_SORT);
+  cstat.sort_by = sorts;
+
+  for (i = 0; i < TEST_JOBS; i++)
+    jobs[i] -> sch_priority = 0;
+
+  sort_jobs(jobs, TEST_JOBS, 0);
+
+  /* jobs which don't request walltime sort after the ones that do */
+  for (i = 0; (i < TEST_JOBS) && (jobs[i] -> resreq != NULL); i++)
+    {
+    if (i > 0)
+      fail_unless(find_resource_req(jobs[i - 1] -> resreq, "walltime") -> amount <=
+                  find_resource_req(jobs[i] -> resreq, "walltime") -> amount);
+    }
+
+  fail_unless(i > 0);
+  fail_unless(i < TEST_JOBS);
+
+  for (; i < TEST_JOBS; i++)
+    fail_unless(jobs[i] -> resreq == NULL);
+  }
+END_TEST
+
+
+Suite *fifo_sort_suite(void)
+  {
+  Suite *s = suite_create("fifo_sort_suite methods");
+  TCase *tc_core = tcase_create("test_single_sorts");
+  tcase_add_test(tc_core, test_single_sorts);
+  tcase_add_test(tc_core, test_multi_sort);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_fifo_sort");
+  tcase_add_test(tc_core, test_fifo_sort);
+  tcase_add_test(tc_core, test_missing_resource);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(fifo_sort_suite());
+  srunner_set_log(sr, "fifo_sort_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
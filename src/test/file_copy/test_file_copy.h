@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _FILE_COPY_CT_H
+#define _FILE_COPY_CT_H
+#include <check.h>
+
+Suite *file_copy_suite();
+
+#endif /* _FILE_COPY_CT_H */
@@ -0,0 +1,473 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "file_copy.h"
+#include "test_file_copy.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <string>
+#include <vector>
+
+#include "pbs_error.h"
+
+
+char test_dir[] = "/tmp/file_copy_XXXXXX";
+
+
+void write_file(
+
+  const std::string &path,
+  const std::string &contents,
+  mode_t             mode)
+
+  {
+  FILE *fp = fopen(path.c_str(), "w");
+
+  fail_unless(fp != NULL, path.c_str());
+  fwrite(contents.c_str(), 1, contents.size(), fp);
+  fclose(fp);
+  chmod(path.c_str(), mode);
+  }
+
+
+std::string read_file(
+
+  const std::string &path)
+
+  {
+  std::string  contents;
+  char         buf[4096];
+  size_t       len;
+  FILE        *fp = fopen(path.c_str(), "r");
+
+  fail_unless(fp != NULL, path.c_str());
+
+  while ((len = fread(buf, 1, sizeof(buf), fp)) > 0)
+    contents.append(buf, len);
+
+  fclose(fp);
+
+  return(contents);
+  }
+
+
+std::string make_dir(
+
+  const char *name)
+
+  {
+  std::string path(test_dir);
+
+  path += "/";
+  path += name;
+
+  fail_unless(mkdir(path.c_str(), 0755) == 0, path.c_str());
+
+  return(path);
+  }
+
+
+START_TEST(test_local_copy_file)
+  {
+  std::string     src = make_dir("file_src") + "/job.OU";
+  std::string     dest = make_dir("file_dest") + "/out";
+  std::string     contents;
+  std::string     err;
+  copy_stats      stats;
+  struct stat     st;
+  struct timeval  times[2];
+
+  for (int i = 0; i < 100000; i++)
+    contents += (char)('a' + (i % 26));
+
+  write_file(src, contents, 0640);
+
+  times[0].tv_sec = 1000000000;
+  times[0].tv_usec = 0;
+  times[1].tv_sec = 1000000100;
+  times[1].tv_usec = 0;
+  utimes(src.c_str(), times);
+
+  memset(&stats, 0, sizeof(stats));
+  fail_unless(local_copy(src.c_str(), dest.c_str(), &stats, err) == PBSE_NONE, err.c_str());
+  fail_unless(read_file(dest) == contents);
+  fail_unless(stats.cs_files == 1);
+  fail_unless(stats.cs_bytes == contents.size());
+
+  fail_unless(stat(dest.c_str(), &st) == 0);
+  fail_unless((st.st_mode & 07777) == 0640);
+  fail_unless(st.st_mtime == 1000000100);
+
+  // copying again truncates and overwrites
+  write_file(src, "short", 0600);
+  fail_unless(local_copy(src.c_str(), dest.c_str(), &stats, err) == PBSE_NONE, err.c_str());
+  fail_unless(read_file(dest) == "short");
+  fail_unless(stat(dest.c_str(), &st) == 0);
+  fail_unless((st.st_mode & 07777) == 0600);
+  fail_unless(stats.cs_files == 2);
+  }
+END_TEST
+
+
+START_TEST(test_copy_target)
+  {
+  std::string dir = make_dir("target");
+
+  fail_unless(copy_target("/a/b/job.ER", dir.c_str()) == dir + "/job.ER");
+  fail_unless(copy_target("/a/b/job.ER", (dir + "/").c_str()) == dir + "/job.ER");
+  fail_unless(copy_target("/a/b/results/", dir.c_str()) == dir + "/results");
+  fail_unless(copy_target("job.ER", dir.c_str()) == dir + "/job.ER");
+  fail_unless(copy_target("/a/b/job.ER", (dir + "/new").c_str()) == dir + "/new");
+  }
+END_TEST
+
+
+START_TEST(test_copy_directory_tree)
+  {
+  std::string src = make_dir("results");
+  std::string dest = make_dir("tree_dest");
+  std::string err;
+  std::string target = dest + "/results";
+  copy_stats  stats;
+  struct stat st;
+  char        link_value[256];
+  ssize_t     len;
+
+  fail_unless(mkdir((src + "/sub").c_str(), 0700) == 0);
+  write_file(src + "/a", "first file", 0644);
+  write_file(src + "/sub/b", "second file", 0600);
+  fail_unless(symlink("sub/b", (src + "/link").c_str()) == 0);
+  chmod(src.c_str(), 0550);
+
+  memset(&stats, 0, sizeof(stats));
+  fail_unless(local_copy(src.c_str(), dest.c_str(), &stats, err) == PBSE_NONE, err.c_str());
+  chmod(src.c_str(), 0755);
+
+  fail_unless(stats.cs_files == 2);
+  fail_unless(stats.cs_dirs == 2);
+  fail_unless(read_file(target + "/a") == "first file");
+  fail_unless(read_file(target + "/sub/b") == "second file");
+
+  fail_unless(stat(target.c_str(), &st) == 0);
+  fail_unless((st.st_mode & 07777) == 0550);
+  fail_unless(stat((target + "/sub").c_str(), &st) == 0);
+  fail_unless((st.st_mode & 07777) == 0700);
+
+  fail_unless(lstat((target + "/link").c_str(), &st) == 0);
+  fail_unless(S_ISLNK(st.st_mode));
+  len = readlink((target + "/link").c_str(), link_value, sizeof(link_value) - 1);
+  fail_unless(len > 0);
+  link_value[len] = '\0';
+  fail_unless(!strcmp(link_value, "sub/b"));
+
+  // copying into an existing copy merges
+  chmod(target.c_str(), 0755);
+  write_file(src + "/c", "third file", 0644);
+  fail_unless(local_copy(src.c_str(), dest.c_str(), &stats, err) == PBSE_NONE, err.c_str());
+  fail_unless(read_file(target + "/c") == "third file");
+  fail_unless(read_file(target + "/a") == "first file");
+  }
+END_TEST
+
+
+START_TEST(test_copy_errors)
+  {
+  std::string dir = make_dir("errors");
+  std::string missing = dir + "/missing";
+  std::string fifo = dir + "/fifo";
+  std::string err;
+  copy_stats  stats;
+
+  memset(&stats, 0, sizeof(stats));
+  fail_unless(local_copy(missing.c_str(), (dir + "/out").c_str(), &stats, err) == ENOENT);
+  fail_unless(err.find(missing) != std::string::npos, err.c_str());
+
+  write_file(dir + "/file", "data", 0644);
+  fail_unless(local_copy((dir + "/file").c_str(), (dir + "/nodir/out").c_str(), &stats, err) == ENOENT);
+  fail_unless(err.find("nodir") != std::string::npos, err.c_str());
+
+  fail_unless(mkfifo(fifo.c_str(), 0600) == 0);
+  fail_unless(local_copy(fifo.c_str(), (dir + "/out").c_str(), &stats, err) == COPY_UNSUPPORTED);
+  fail_unless(stats.cs_files == 0);
+  }
+END_TEST
+
+
+START_TEST(test_copy_files_in_parallel)
+  {
+  std::string            src = make_dir("parallel_src");
+  std::string            dest = make_dir("parallel_dest");
+  std::vector<copy_task> tasks;
+  copy_stats             stats;
+  copy_limits            limits;
+  unsigned long long     bytes = 0;
+  char                   name[64];
+
+  for (int i = 0; i < 200; i++)
+    {
+    copy_task   task;
+    std::string contents(i * 37, 'x');
+
+    snprintf(name, sizeof(name), "/%d.OU", i);
+    contents += name;
+    write_file(src + name, contents, 0644);
+    bytes += contents.size();
+
+    task.ct_src = src + name;
+    task.ct_dest = dest;
+    task.ct_rc = -2;
+    tasks.push_back(task);
+    }
+
+  init_copy_limits(&limits);
+  limits.cl_workers = 8;
+
+  memset(&stats, 0, sizeof(stats));
+  fail_unless(copy_files_in_parallel(tasks, &limits, &stats) == 0);
+  fail_unless(stats.cs_files == 200);
+  fail_unless(stats.cs_bytes == bytes);
+
+  for (int i = 0; i < 200; i++)
+    {
+    snprintf(name, sizeof(name), "/%d.OU", i);
+    fail_unless(tasks[i].ct_rc == PBSE_NONE);
+    fail_unless(read_file(dest + name) == read_file(src + name), name);
+    }
+
+  // failures are counted and described, and no copy is started after one
+  tasks[3].ct_src = src + "/missing";
+  limits.cl_workers = 1;
+  memset(&stats, 0, sizeof(stats));
+  fail_unless(copy_files_in_parallel(tasks, &limits, &stats) == 1);
+  fail_unless(tasks[3].ct_rc == ENOENT);
+  fail_unless(tasks[3].ct_err.find("missing") != std::string::npos);
+  fail_unless(stats.cs_files == 3);
+
+  for (int i = 4; i < 200; i++)
+    fail_unless(tasks[i].ct_rc == COPY_SKIPPED);
+
+  // with several workers only the copies already running can finish
+  limits.cl_workers = 8;
+  memset(&stats, 0, sizeof(stats));
+  fail_unless(copy_files_in_parallel(tasks, &limits, &stats) == 1);
+  fail_unless(tasks[3].ct_rc == ENOENT);
+  fail_unless(stats.cs_files < 3 + 8);
+  fail_unless(tasks[199].ct_rc == COPY_SKIPPED);
+  }
+END_TEST
+
+
+double elapsed_since(
+
+  struct timeval *start)
+
+  {
+  struct timeval now;
+
+  gettimeofday(&now, NULL);
+
+  return((now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1000000.0);
+  }
+
+
+START_TEST(test_throttle_copy)
+  {
+  rate_limiter   rl;
+  struct timeval start;
+
+  // the first booking goes right away, the rest wait their turn
+  init_rate_limiter(&rl, 1024 * 1024);
+  gettimeofday(&start, NULL);
+
+  for (int i = 0; i < 3; i++)
+    throttle_copy(&rl, 256 * 1024);
+
+  fail_unless(elapsed_since(&start) >= 0.45);
+  fail_unless(elapsed_since(&start) < 2.0);
+
+  // unlimited never waits
+  init_rate_limiter(&rl, 0);
+  gettimeofday(&start, NULL);
+  throttle_copy(&rl, 1024 * 1024 * 1024);
+  throttle_copy(NULL, 1024 * 1024 * 1024);
+  fail_unless(elapsed_since(&start) < 0.1);
+  }
+END_TEST
+
+
+size_t progress_calls;
+size_t progress_total;
+
+void record_progress(
+
+  const copy_stats *stats,
+  size_t            done,
+  size_t            total,
+  void             *arg)
+
+  {
+  progress_calls++;
+  progress_total = total;
+  fail_unless(done <= total);
+  fail_unless(arg == &progress_calls);
+  }
+
+
+START_TEST(test_copy_limits)
+  {
+  std::string            src = make_dir("limits_src");
+  std::string            dest = make_dir("limits_dest");
+  std::string            slot_file = std::string(test_dir) + "/copy_slots";
+  std::vector<copy_task> tasks;
+  std::vector<int>       slot_fds;
+  copy_stats             stats;
+  copy_limits            limits;
+  struct timeval         start;
+  struct flock           fl;
+  char                   name[64];
+  int                    held_fd;
+
+  for (int i = 0; i < 4; i++)
+    {
+    copy_task task;
+
+    snprintf(name, sizeof(name), "/%d.ER", i);
+    write_file(src + name, std::string(512 * 1024, 'a' + i), 0644);
+
+    task.ct_src = src + name;
+    task.ct_dest = dest;
+    tasks.push_back(task);
+    }
+
+  // 2 MB at 2 MB/s for the request, split over 4 workers
+  init_copy_limits(&limits);
+  limits.cl_workers = 4;
+  limits.cl_bandwidth = 2 * 1024 * 1024;
+  limits.cl_sync = true;
+  limits.cl_progress_interval = 1;
+  limits.cl_progress = record_progress;
+  limits.cl_progress_arg = &progress_calls;
+
+  gettimeofday(&start, NULL);
+  memset(&stats, 0, sizeof(stats));
+  fail_unless(copy_files_in_parallel(tasks, &limits, &stats) == 0);
+  fail_unless(elapsed_since(&start) >= 0.7);
+  fail_unless(stats.cs_bytes == 4 * 512 * 1024);
+  fail_unless(progress_calls >= 1);
+  fail_unless(progress_total == 4);
+
+  for (int i = 0; i < 4; i++)
+    {
+    snprintf(name, sizeof(name), "/%d.ER", i);
+    fail_unless(read_file(dest + name) == std::string(512 * 1024, 'a' + i));
+    }
+
+  // another process holds one of the two node slots, the copies use the other
+  for (int i = 0; i < 2; i++)
+    slot_fds.push_back(open(slot_file.c_str(), O_RDWR | O_CREAT, 0600));
+
+  held_fd = open(slot_file.c_str(), O_RDWR);
+  memset(&fl, 0, sizeof(fl));
+  fl.l_type = F_WRLCK;
+  fl.l_whence = SEEK_SET;
+  fl.l_start = 0;
+  fl.l_len = 1;
+  fail_unless(fcntl(held_fd, F_OFD_SETLK, &fl) == 0);
+
+  init_copy_limits(&limits);
+  limits.cl_workers = 4;
+  limits.cl_node_slots = 2;
+  limits.cl_slot_fds = &slot_fds[0];
+  limits.cl_slot_fd_count = slot_fds.size();
+  limits.cl_slot_bandwidth = 4 * 1024 * 1024;
+
+  gettimeofday(&start, NULL);
+  memset(&stats, 0, sizeof(stats));
+  fail_unless(copy_files_in_parallel(tasks, &limits, &stats) == 0);
+  fail_unless(elapsed_since(&start) >= 0.4);
+  fail_unless(stats.cs_files == 4);
+
+  close(held_fd);
+
+  for (size_t i = 0; i < slot_fds.size(); i++)
+    close(slot_fds[i]);
+  }
+END_TEST
+
+
+START_TEST(test_format_copy_stats)
+  {
+  copy_stats stats;
+  char       buf[256];
+
+  stats.cs_files = 10;
+  stats.cs_dirs = 1;
+  stats.cs_bytes = 4 * 1024 * 1024;
+
+  format_copy_stats(buf, sizeof(buf), &stats, 4, 2.0);
+  fail_unless(!strcmp(buf, "copied 10 files and 1 directories (4194304 bytes) in 2.000 seconds, 2.00 MB/s using 4 workers"), buf);
+
+  format_copy_stats(buf, sizeof(buf), &stats, 1, 0.0);
+  fail_unless(strstr(buf, "0.00 MB/s") != NULL, buf);
+  }
+END_TEST
+
+
+Suite *file_copy_suite(void)
+  {
+  Suite *s = suite_create("file_copy_suite methods");
+  TCase *tc_core = tcase_create("test_local_copy_file");
+  tcase_add_test(tc_core, test_local_copy_file);
+  tcase_add_test(tc_core, test_copy_target);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_copy_directory_tree");
+  tcase_add_test(tc_core, test_copy_directory_tree);
+  tcase_add_test(tc_core, test_copy_errors);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_copy_files_in_parallel");
+  tcase_add_test(tc_core, test_copy_files_in_parallel);
+  tcase_add_test(tc_core, test_format_copy_stats);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_copy_limits");
+  tcase_add_test(tc_core, test_throttle_copy);
+  tcase_add_test(tc_core, test_copy_limits);
+  tcase_set_timeout(tc_core, 30);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  char     cmd[64];
+
+  rundebug();
+
+  if (mkdtemp(test_dir) == NULL)
+    return(1);
+
+  sr = srunner_create(file_copy_suite());
+  srunner_set_log(sr, "file_copy_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", test_dir);
+  if (system(cmd) != 0)
+    fprintf(stderr, "couldn't remove %s\n", test_dir);
+
+  return(number_failed);
+  }
@@ -66,23 +66,19 @@ int array_save(
   return(PBSE_NONE);
   }
 
-int translate_range_string_to_vector(
+int is_whitespace(
 
-  const char       *range_string,
-  std::vector<int> &indices)
+  char c)
 
   {
-  if (range_string == NULL)
-    return(-1);
-
-  if (!isdigit(*range_string))
-    return(-1);
-
-  indices.clear();
-  for (int i = 0; i < 10; i++)
-    indices.push_back(i);
-
-  return(PBSE_NONE);
+  if ((c == ' ')  ||
+      (c == '\n') ||
+      (c == '\t') ||
+      (c == '\r') ||
+      (c == '\f'))
+    return(TRUE);
+  else
+    return(FALSE);
   }
 
 int job_save(
@@ -133,7 +129,7 @@ int create_and_queue_array_subjob(
   char buf[1024];
 
   sprintf(buf, "%d.roshar", index);
-  pa->job_ids[index] = strdup(buf);
+  pa->set_job_id(index, buf);
 
   return(PBSE_NONE);
   }
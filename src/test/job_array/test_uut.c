@@ -36,7 +36,7 @@ START_TEST(test_constructors)
   fail_unless(strlen(pa.ai_qs.fileprefix) == 0);
   fail_unless(strlen(pa.ai_qs.submit_host) == 0);
 
-  fail_unless(pa.job_ids == NULL);
+  fail_unless(pa.job_ids.size() == 0);
   fail_unless(pa.jobs_recovered == 0);
   fail_unless(pa.ai_ghost_recovered == false);
   fail_unless(pa.uncreated_ids.size() == 0);
@@ -117,24 +117,26 @@ START_TEST(test_parse_array_request)
   fail_unless(pa.ai_qs.array_size == 10);
   fail_unless(pa.ai_qs.num_jobs == 10);
   fail_unless(pa.ai_qs.range_str == "0-9");
-  fail_unless(pa.job_ids != NULL);
+  fail_unless(pa.job_ids.size() == 0);
   fail_unless(pa.uncreated_ids.size() == 10);
 
   pa.ai_qs.idle_slot_limit = 2;
   pa.ai_qs.num_idle = 0;
-  int internal_index = -1;
 
   // It should tell us to create sub job 0 next
-  fail_unless(pa.get_next_index_to_create(internal_index) == 0);
-  fail_unless(internal_index == 0);
+  fail_unless(pa.get_next_index_to_create() == 0);
 
   // Make sure we'll create a job
   pa.create_job_if_needed();
-  fail_unless(pa.job_ids[0] != NULL);
+  fail_unless(pa.get_job_id(0) != NULL);
   fail_unless(pa.ai_qs.highest_id_created == 0);
   pa.create_job_if_needed();
-  fail_unless(pa.job_ids[1] != NULL);
+  fail_unless(pa.get_job_id(1) != NULL);
   fail_unless(pa.ai_qs.highest_id_created == 1);
+  fail_unless(pa.job_ids.size() == 2);
+  fail_unless(pa.next_job_index(-1) == 0);
+  fail_unless(pa.next_job_index(0) == 1);
+  fail_unless(pa.next_job_index(1) == -1);
   }
 END_TEST
 
@@ -154,6 +156,46 @@ START_TEST(test_initialize_uncreated_ids)
 END_TEST
 
 
+START_TEST(test_index_ranges)
+  {
+  index_ranges ids;
+  int          first;
+  int          last;
+
+  fail_unless(ids.parse("the Lopen") != PBSE_NONE);
+  fail_unless(ids.parse("5-3") != PBSE_NONE);
+  fail_unless(ids.empty() == true);
+  fail_unless(ids.front() == -1);
+
+  // a million indices are still only two ranges
+  fail_unless(ids.parse("0-999998, 1000000") == PBSE_NONE);
+  fail_unless(ids.size() == 1000000);
+  fail_unless(ids.range_count() == 2);
+  fail_unless(ids.max_index() == 1000000);
+
+  fail_unless(ids.front() == 0);
+  ids.pop_front();
+  fail_unless(ids.front() == 1);
+  fail_unless(ids.size() == 999999);
+
+  ids.remove_through(999998);
+  fail_unless(ids.size() == 1);
+  fail_unless(ids.range_count() == 1);
+  fail_unless(ids.front() == 1000000);
+  ids.pop_front();
+  fail_unless(ids.empty() == true);
+
+  fail_unless(ids.parse("1,3-5,7") == PBSE_NONE);
+  ids.remove_through(3);
+  fail_unless(ids.size() == 3);
+  ids.get_range(0, first, last);
+  fail_unless((first == 4) && (last == 5));
+  ids.get_range(1, first, last);
+  fail_unless((first == 7) && (last == 7));
+  }
+END_TEST
+
+
 START_TEST(need_to_update_slot_limits_test)
   {
   job_array pa;
@@ -203,6 +245,7 @@ Suite *job_array_suite(void)
   tcase_add_test(tc_core, update_array_values_test);
   tcase_add_test(tc_core, test_set_slot_limit);
   tcase_add_test(tc_core, test_initialize_uncreated_ids);
+  tcase_add_test(tc_core, test_index_ranges);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -18,6 +18,7 @@
 #include "array.h" /* ArrayEventsEnum */
 #include "id_map.hpp"
 #include "completed_jobs_map.h"
+#include "dependency_graph.hpp"
 
 /* This section is for manipulting function return values */
 #include "test_job_func.h" /* *_SUITE */
@@ -49,6 +50,7 @@ char *path_jobinfo_log;
 int LOGLEVEL = 7; /* force logging code to be exercised as tests run */
 pthread_mutex_t job_log_mutex = PTHREAD_MUTEX_INITIALIZER;
 completed_jobs_map_class completed_jobs_map;
+dependency_graph depend_graph;
 
 user_info_holder users;
 extern bool add_job_called;
@@ -677,6 +679,12 @@ void handle_complete_second_time(struct work_task *ptask)
   }
 
 completed_jobs_map_class::completed_jobs_map_class() {}
+
+dependency_graph::dependency_graph() {}
+
+dependency_graph::~dependency_graph() {}
+
+void dependency_graph::remove_job(const char *job_id) {}
 completed_jobs_map_class::~completed_jobs_map_class() {}
 bool completed_jobs_map_class::add_job(char const* s, time_t t)
   {
@@ -715,3 +723,15 @@ bool job_array::is_deleted() const
   {
   return(this->being_deleted);
   }
+
+bool index_ranges::empty() const
+  {
+  return(true);
+  }
+
+int index_ranges::front() const
+  {
+  return(-1);
+  }
+
+void index_ranges::pop_front() {}
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "job_history.hpp"
+#include "pbs_error.h"
+
+#include <check.h>
+
+const char *history_dir = "./job_history_test";
+
+
+void clean_history_dir()
+  {
+  char cmd[256];
+
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", history_dir);
+  if (system(cmd) != 0)
+    fprintf(stderr, "couldn't remove %s\n", history_dir);
+  }
+
+
+void make_job(
+
+  const char                      *owner,
+  const char                      *queue,
+  time_t                           finished,
+  completed_job_info              &info,
+  std::vector<completed_job_attr> &attrs)
+
+  {
+  completed_job_attr ca;
+
+  info.ci_owner = owner;
+  info.ci_submit_host = "napali";
+  info.ci_queue = queue;
+  info.ci_mod_time = finished;
+  info.ci_expires = 0;
+
+  attrs.clear();
+  ca.ca_index = 0;
+  ca.ca_name = "exit_status";
+  ca.ca_value = "0";
+  attrs.push_back(ca);
+  }
+
+
+START_TEST(test_add_and_find)
+  {
+  job_history                     history;
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+  std::vector<std::string>        ids;
+  time_t                          now = time(NULL);
+
+  clean_history_dir();
+
+  make_job("dbeer@napali", "batch", now, info, attrs);
+  fail_unless(history.add_job("1.napali", info, attrs) == PBSE_SYSTEM);
+
+  fail_unless(history.open_history(history_dir) == PBSE_NONE);
+  fail_unless(history.is_open() == true);
+
+  fail_unless(history.add_job("1.napali", info, attrs) == PBSE_NONE);
+  make_job("astacey@napali", "batch", now + 10, info, attrs);
+  fail_unless(history.add_job("2.napali", info, attrs) == PBSE_NONE);
+  make_job("dbeer@napali", "short", now + 20, info, attrs);
+  fail_unless(history.add_job("3.napali", info, attrs) == PBSE_NONE);
+  fail_unless(history.count() == 3);
+
+  fail_unless(history.get_job("2.napali", info, attrs) == true);
+  fail_unless(info.ci_owner == "astacey@napali");
+  fail_unless(attrs.size() == 1);
+  fail_unless(attrs[0].ca_value == "0");
+  fail_unless(history.get_job("4.napali", info, attrs) == false);
+
+  history.find_jobs(NULL, NULL, 0, 0, ids);
+  fail_unless(ids.size() == 3);
+  fail_unless(ids[0] == "1.napali");
+  fail_unless(ids[2] == "3.napali");
+
+  ids.clear();
+  history.find_jobs("dbeer", NULL, 0, 0, ids);
+  fail_unless(ids.size() == 2);
+
+  ids.clear();
+  history.find_jobs("dbeer", "short", 0, 0, ids);
+  fail_unless(ids.size() == 1);
+  fail_unless(ids[0] == "3.napali");
+
+  ids.clear();
+  history.find_jobs(NULL, NULL, now + 5, now + 15, ids);
+  fail_unless(ids.size() == 1);
+  fail_unless(ids[0] == "2.napali");
+
+  ids.clear();
+  history.find_jobs("nobody", NULL, 0, 0, ids);
+  fail_unless(ids.size() == 0);
+
+  history.close_history();
+  fail_unless(history.is_open() == false);
+  fail_unless(history.count() == 0);
+  }
+END_TEST
+
+
+START_TEST(test_reopen_and_expire)
+  {
+  completed_job_info              info;
+  std::vector<completed_job_attr> attrs;
+  std::vector<std::string>        ids;
+  time_t                          now = time(NULL);
+  char                            path[256];
+  int                             fd;
+
+  clean_history_dir();
+
+    {
+    job_history history;
+
+    fail_unless(history.open_history(history_dir) == PBSE_NONE);
+    make_job("dbeer@napali", "batch", now - 10 * 24 * 60 * 60, info, attrs);
+    fail_unless(history.add_job("1.napali", info, attrs) == PBSE_NONE);
+    make_job("dbeer@napali", "batch", now, info, attrs);
+    fail_unless(history.add_job("2.napali", info, attrs) == PBSE_NONE);
+    }
+
+  // a torn write at the end of today's file is cut off when reopened
+  snprintf(path, sizeof(path), "%s/%08d", history_dir, history_day(now));
+  fd = open(path, O_WRONLY | O_APPEND);
+  fail_unless(fd >= 0);
+  fail_unless(write(fd, "PBCJ", 4) == 4);
+  close(fd);
+
+  job_history history;
+
+  fail_unless(history.open_history(history_dir) == PBSE_NONE);
+  fail_unless(history.count() == 2);
+  fail_unless(history.get_job("1.napali", info, attrs) == true);
+
+  make_job("dbeer@napali", "batch", now + 1, info, attrs);
+  fail_unless(history.add_job("3.napali", info, attrs) == PBSE_NONE);
+  fail_unless(history.get_job("3.napali", info, attrs) == true);
+
+  // keeping every day removes nothing, keeping a week drops the old day
+  fail_unless(history.expire(now, 0) == 0);
+  fail_unless(history.expire(now, 7) == 1);
+  fail_unless(history.has_job("1.napali") == false);
+  fail_unless(history.count() == 2);
+
+  snprintf(path, sizeof(path), "%s/%08d", history_dir, history_day(now - 10 * 24 * 60 * 60));
+  fail_unless(access(path, F_OK) != 0);
+
+  history.find_jobs("dbeer", NULL, 0, 0, ids);
+  fail_unless(ids.size() == 2);
+
+  history.close_history();
+  clean_history_dir();
+  }
+END_TEST
+
+
+Suite *job_history_suite(void)
+  {
+  Suite *s = suite_create("job_history test suite methods");
+  TCase *tc_core = tcase_create("test_add_and_find");
+  tcase_add_test(tc_core, test_add_and_find);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_reopen_and_expire");
+  tcase_add_test(tc_core, test_reopen_and_expire);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_history_suite());
+  srunner_set_log(sr, "job_history_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include "job_rank_index.hpp"
+
+#include <check.h>
+
+
+START_TEST(test_find_preceding)
+  {
+  job_rank_index ranks;
+  std::string    prev;
+
+  fail_unless(ranks.find_preceding(5, prev) == false);
+
+  fail_unless(ranks.insert("1.napali", 10) == true);
+  fail_unless(ranks.insert("1.napali", 10) == false);
+  fail_unless(ranks.insert("2.napali", 20) == true);
+  fail_unless(ranks.insert("3.napali", 30) == true);
+  fail_unless(ranks.count() == 3);
+
+  // lower than everything goes first
+  fail_unless(ranks.find_preceding(5, prev) == false);
+
+  fail_unless(ranks.find_preceding(25, prev) == true);
+  fail_unless(prev == "2.napali");
+  fail_unless(ranks.find_preceding(100, prev) == true);
+  fail_unless(prev == "3.napali");
+
+  // a job goes in front of jobs with its own rank
+  fail_unless(ranks.find_preceding(20, prev) == true);
+  fail_unless(prev == "1.napali");
+
+  fail_unless(ranks.remove("2.napali") == true);
+  fail_unless(ranks.remove("2.napali") == false);
+  fail_unless(ranks.find_preceding(25, prev) == true);
+  fail_unless(prev == "1.napali");
+  fail_unless(ranks.count() == 2);
+  }
+END_TEST
+
+
+START_TEST(test_equal_ranks)
+  {
+  job_rank_index ranks;
+  std::string    prev;
+
+  // each new job of rank 10 is linked in front of the older ones
+  fail_unless(ranks.insert("1.napali", 10) == true);
+  fail_unless(ranks.insert("2.napali", 10) == true);
+  fail_unless(ranks.insert("3.napali", 10) == true);
+
+  fail_unless(ranks.find_preceding(11, prev) == true);
+  fail_unless(prev == "1.napali");
+
+  fail_unless(ranks.remove("1.napali") == true);
+  fail_unless(ranks.find_preceding(11, prev) == true);
+  fail_unless(prev == "2.napali");
+  }
+END_TEST
+
+
+START_TEST(test_change_rank)
+  {
+  job_rank_index ranks;
+  std::string    prev;
+
+  fail_unless(ranks.insert("1.napali", 10) == true);
+  fail_unless(ranks.insert("2.napali", 20) == true);
+
+  // swap the ranks the way qorder does
+  fail_unless(ranks.change_rank("1.napali", 20) == true);
+  fail_unless(ranks.change_rank("2.napali", 10) == true);
+  fail_unless(ranks.change_rank("3.napali", 10) == false);
+
+  fail_unless(ranks.find_preceding(15, prev) == true);
+  fail_unless(prev == "2.napali");
+  fail_unless(ranks.find_preceding(25, prev) == true);
+  fail_unless(prev == "1.napali");
+  fail_unless(ranks.count() == 2);
+  }
+END_TEST
+
+
+Suite *job_rank_index_suite(void)
+  {
+  Suite *s = suite_create("job_rank_index test suite methods");
+  TCase *tc_core = tcase_create("test_find_preceding");
+  tcase_add_test(tc_core, test_find_preceding);
+  tcase_add_test(tc_core, test_equal_ranks);
+  tcase_add_test(tc_core, test_change_rank);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_rank_index_suite());
+  srunner_set_log(sr, "job_rank_index_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -15,6 +15,7 @@
 #include "id_map.hpp"
 #include "completed_jobs_map.h"
 #include "pbs_nodes.h"
+#include "event_trace.h"
 
 const char *text_name              = "text";
 const char *PJobSubState[10];
@@ -483,7 +484,7 @@ void clear_attr(
 
 array_info::array_info() {}
 
-job_array::job_array() : job_ids(NULL), jobs_recovered(0), ai_ghost_recovered(false), uncreated_ids(),
+job_array::job_array() : job_ids(), jobs_recovered(0), ai_ghost_recovered(false), uncreated_ids(),
                          ai_mutex(NULL), ai_qs()
 
   {
@@ -534,3 +535,10 @@ int check_default_gpu_mode_str(pbs_attribute *pattr, void *pobj, int mode)
   {
   return(PBSE_NONE);
   }
+
+void trace_event(int event, const char *job_id, uint64_t duration, int value) {}
+
+uint64_t trace_elapsed(time_t since)
+  {
+  return(0);
+  }
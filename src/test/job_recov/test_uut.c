@@ -33,7 +33,7 @@ int  set_array_job_ids(job **pjob, char *log_buf, size_t buflen);
 svrattrl *fill_svrattr_info(const char *aname, const char *avalue, const char *rname, char *log_buf, size_t      buf_len);
 void decode_attribute(svrattrl *pal, job **pjob, bool freeExisting);
 job_array *ghost_create_jobs_array(job *pjob, const char *array_id);
-void check_and_reallocate_job_ids(job_array *pa, int index);
+void check_and_grow_array_size(job_array *pa, int index);
 void update_recovered_array_values(job_array *pa, job *pjob);
 
 void clear_attr(pbs_attribute *pattr, attribute_def *def);
@@ -63,15 +63,17 @@ START_TEST(ghost_array_test)
   job_array *pa = ghost_create_jobs_array(pjob, array_id);
   fail_unless(!strcmp(pa->ai_qs.parent_id, array_id));
   fail_unless(!strcmp(pa->ai_qs.fileprefix, "10.napali"), "prefix=%s", pa->ai_qs.fileprefix);
-  fail_unless(pa->job_ids[0] != NULL);
-  fail_unless(!strcmp(pa->job_ids[0], pjob->ji_qs.ji_jobid));
+  fail_unless(pa->get_job_id(0) != NULL);
+  fail_unless(!strcmp(pa->get_job_id(0), pjob->ji_qs.ji_jobid));
   fail_unless(pa->ai_qs.array_size == 101); // DEFAULT_ARRAY_RECOV_SIZE
+  fail_unless(pa->job_ids.size() == 1);
 
-  pa->job_ids[50] = strdup("10[50].napali");
+  pa->set_job_id(50, "10[50].napali");
 
-  check_and_reallocate_job_ids(pa, 210);
-  fail_unless(!strcmp(pa->job_ids[0], "10[0].napali"));
-  fail_unless(!strcmp(pa->job_ids[50], "10[50].napali"));
+  check_and_grow_array_size(pa, 210);
+  fail_unless(!strcmp(pa->get_job_id(0), "10[0].napali"));
+  fail_unless(!strcmp(pa->get_job_id(50), "10[50].napali"));
+  fail_unless(pa->get_job_id(210) == NULL);
   fail_unless(pa->ai_qs.array_size == 404); // should have doubled twice to accomodate index 210
 
   pjob->ji_qs.ji_state = JOB_STATE_RUNNING;
@@ -27,6 +27,9 @@ int sockets;
 int numa_node_count;
 int exec_slots;
 int placed_all;
+int cheapest_socket = -1;
+int called_lowest_cost_place;
+int called_order_sockets;
 const int exclusive_socket = 2;
 const int exclusive_node = 1;
 const int exclusive_chip = 3;
@@ -191,12 +194,38 @@ bool Socket::partially_place(allocation &remaining, allocation &master)
   return(partially_placed);
   }
 
-int Socket::place_task(req &r, allocation &a, int to_place, const char *hostname)
+int Socket::place_task(req &r, allocation &a, int to_place, const char *hostname, bool lowest_cost)
   {
   called_place_task++;
+
+  if (lowest_cost == true)
+    called_lowest_cost_place++;
+
   return(num_placed);
   }
 
+void Machine::initialize_numa_distances(hwloc_topology_t topology) {}
+
+void Machine::initialize_numa_distances(const Json::Value &distances) {}
+
+int Machine::lowest_cost_socket(const req &r, int place_type, int tasks) const
+  {
+  return(cheapest_socket);
+  }
+
+void Machine::order_sockets_by_distance(const req &r, int place_type, std::vector<int> &order) const
+  {
+  called_order_sockets++;
+
+  for (int i = this->sockets.size() - 1; i >= 0; i--)
+    order.push_back(i);
+  }
+
+void Machine::set_topology_aware(bool aware)
+  {
+  this->topology_aware = aware;
+  }
+
 int Socket::getTotalChips() const
   {
   return(1);
@@ -33,6 +33,9 @@ extern int sockets;
 extern int numa_node_count;
 extern int exec_slots;
 extern int placed_all;
+extern int cheapest_socket;
+extern int called_lowest_cost_place;
+extern int called_order_sockets;
 extern bool socket_fit;
 extern bool partially_placed;
 extern bool spreaded;
@@ -375,6 +378,46 @@ START_TEST(test_place_and_free_job)
 END_TEST
 
 
+START_TEST(test_topology_aware_place_job)
+  {
+  std::string cpu;
+  std::string mem;
+  Machine m;
+  m.addSocket(2);
+  m.set_topology_aware(true);
+  job pjob;
+  complete_req cr;
+  pjob.ji_wattr[JOB_ATR_req_information].at_val.at_ptr = &cr;
+  strcpy(pjob.ji_qs.ji_jobid, "1.napali");
+
+  // The whole req goes to the cheapest socket
+  my_req_count = 1;
+  num_for_host = 4;
+  num_tasks_fit = 4;
+  num_placed = 4;
+  cheapest_socket = 1;
+  called_place_task = 0;
+  called_lowest_cost_place = 0;
+  called_order_sockets = 0;
+  fail_unless(m.place_job(&pjob, cpu, mem, "napali", false) == PBSE_NONE);
+  fail_unless(called_place_task == 1, "Expected 1 call but got %d", called_place_task);
+  fail_unless(called_lowest_cost_place == 1);
+  fail_unless(called_order_sockets == 0);
+  m.free_job_allocation("1.napali");
+
+  // No socket holds the req, so it is split across the sockets nearest to each other
+  num_for_host = 8;
+  cheapest_socket = -1;
+  called_place_task = 0;
+  called_lowest_cost_place = 0;
+  fail_unless(m.place_job(&pjob, cpu, mem, "napali", false) == PBSE_NONE);
+  fail_unless(called_order_sockets == 1);
+  fail_unless(called_place_task == 2, "Expected 2 calls but got %d", called_place_task);
+  fail_unless(called_lowest_cost_place == 2);
+  }
+END_TEST
+
+
 
 Suite *machine_suite(void)
   {
@@ -393,6 +436,7 @@ Suite *machine_suite(void)
   
   tc_core = tcase_create("test_place_and_free_job");
   tcase_add_test(tc_core, test_place_and_free_job);
+  tcase_add_test(tc_core, test_topology_aware_place_job);
   tcase_add_test(tc_core, test_store_pci_device_on_appropriate_chip);
   tcase_add_test(tc_core, test_spread_place);
   tcase_add_test(tc_core, test_place_all_execution_slots);
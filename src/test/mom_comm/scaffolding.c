@@ -10,6 +10,7 @@
 #include "resmon.h" /* PBS_MAXSERVER */
 #include "attribute.h" /* attribute_def, pbs_attribute */
 #include "net_connect.h" /* connection, PBS_NET_MAX_CONNECTIONS */
+#include "net_cache.h" /* PERMANENT_SOCKET_FAIL */
 #include "log.h" /* LOG_BUF_SIZE */
 #include "list_link.h" /* tlist_head */
 #include "resource.h" /* resource_def */
@@ -676,3 +677,11 @@ void authorized_hosts::list_authorized_hosts(std::string &output) {}
 authorized_hosts::authorized_hosts() {}
 authorized_hosts auth_hosts;
 
+
+int socket_connect_addrs(struct sockaddr_in **remotes, int count, int *sockets, int is_privileged, unsigned int timeout)
+  {
+  for (int i = 0; i < count; i++)
+    sockets[i] = PERMANENT_SOCKET_FAIL;
+
+  return(PBSE_NONE);
+  }
@@ -511,6 +511,108 @@ START_TEST(tm_spawn_request_test)
   }
 END_TEST
 
+START_TEST(tm_batch_test)
+  {
+  job       pjob;
+  tm_batch *tb;
+  int       id;
+
+  memset(&pjob, 0, sizeof(pjob));
+  strcpy(pjob.ji_qs.ji_jobid, "1.napali");
+
+  tb = tm_batch_create(&pjob, TM_SPAWN_MULTI, 0, 7, 1, 3);
+  id = tb->tb_id;
+  fail_unless(tm_batch_find(id) == tb);
+  fail_unless(tb->tb_pending == 3);
+
+  tb->tb_tasks[1] = 5;
+  tb->tb_tasks[2] = 5;
+  tb->tb_events[2] = 12;
+
+  fail_unless(tm_batch_fill(tb, 0, 4) == 2);
+  /* a slot is only filled once */
+  fail_unless(tm_batch_fill(tb, 0, 9) == 2);
+  fail_unless(tb->tb_values[0] == 4);
+
+  /* only the local slot watching task 5 is filled */
+  fail_unless(tm_batch_fill_task(tb, 5, 6) == 1);
+  fail_unless(tm_batch_fill_task(tb, 5, 6) == 1);
+  fail_unless(tb->tb_values[1] == 6);
+
+  fail_unless(tm_batch_fill_event(tb, 12, TM_NULL_TASK) == 0);
+  fail_unless(tb->tb_values[2] == TM_NULL_TASK);
+
+  tm_batch_free(tb);
+  fail_unless(tm_batch_find(id) == NULL);
+  }
+END_TEST
+
+START_TEST(tm_obit_multi_request_test)
+  {
+  job             *pjob = (job *)calloc(1, sizeof(job));
+  hnodent          host;
+  struct tcp_chan *chan = (struct tcp_chan *)calloc(1, sizeof(struct tcp_chan));
+  task            *exited = new task();
+  task            *running = new task();
+  task            *client = new task();
+  tm_batch        *tb;
+  int              reply = TRUE;
+  int              ret = DIS_SUCCESS;
+  int              id;
+
+  strcpy(pjob->ji_qs.ji_jobid, "1.napali");
+  pjob->ji_tasks = new std::vector<task *>();
+  pjob->ji_numvnod = 2;
+  pjob->ji_vnods = (vnodent *)calloc(2, sizeof(vnodent));
+  pjob->ji_vnods[0].vn_node = 0;
+  pjob->ji_vnods[0].vn_host = &host;
+  pjob->ji_vnods[1].vn_node = 1;
+  pjob->ji_vnods[1].vn_host = &host;
+
+  exited->ti_qs.ti_task = 1;
+  exited->ti_qs.ti_status = TI_STATE_EXITED;
+  exited->ti_qs.ti_exitstat = 3;
+  running->ti_qs.ti_task = 2;
+  running->ti_qs.ti_status = TI_STATE_RUNNING;
+  client->ti_qs.ti_task = 3;
+  client->ti_chan = chan;
+  pjob->ji_tasks->push_back(exited);
+  pjob->ji_tasks->push_back(running);
+  pjob->ji_tasks->push_back(client);
+
+  /* a node outside the job is refused */
+  disrsi_return_index = 0;
+  disrsi_array[0] = 1;
+  disrsi_array[1] = 9;
+  disrsi_array[2] = 1;
+  fail_unless(tm_obit_multi_request(chan, pjob, 42, &reply, &ret, 3) == TM_DONE);
+  fail_unless(reply == TRUE);
+  fail_unless(running->ti_obits.size() == 0);
+
+  /* task 1 has already exited, task 2 answers when it does */
+  disrsi_return_index = 0;
+  disrsi_array[0] = 2;
+  disrsi_array[1] = 0;
+  disrsi_array[2] = 1;
+  disrsi_array[3] = 1;
+  disrsi_array[4] = 2;
+  fail_unless(tm_obit_multi_request(chan, pjob, 42, &reply, &ret, 3) == TM_DONE);
+  fail_unless(reply == FALSE);
+  fail_unless(running->ti_obits.size() == 1);
+  fail_unless(running->ti_obits[0].oe_batch == true);
+
+  id = running->ti_obits[0].oe_info.fe_event;
+  fail_unless((tb = tm_batch_find(id)) != NULL);
+  fail_unless(tb->tb_pending == 1);
+  fail_unless(tb->tb_values[0] == 3);
+
+  running->ti_qs.ti_status = TI_STATE_EXITED;
+  running->ti_qs.ti_exitstat = 5;
+  tm_batch_obit(pjob, id, running);
+  fail_unless(tm_batch_find(id) == NULL);
+  }
+END_TEST
+
 START_TEST(pbs_task_create_test)
   {
   job *pjob = (job *)calloc(1, sizeof(job));
@@ -623,6 +725,8 @@ Suite *mom_comm_suite(void)
 
   tc_core = tcase_create("pbs_task_create_test");
   tcase_add_test(tc_core, pbs_task_create_test);
+  tcase_add_test(tc_core, tm_batch_test);
+  tcase_add_test(tc_core, tm_obit_multi_request_test);
   tcase_add_test(tc_core,test_find_task_by_pid); 
   suite_add_tcase(s, tc_core);
 
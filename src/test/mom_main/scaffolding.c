@@ -28,6 +28,7 @@
 #include <vector>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include "authorized_hosts.hpp"
+#include "event_trace.h"
 
 extern mom_hierarchy_t *mh;
 
@@ -39,6 +40,7 @@ extern mom_hierarchy_t *mh;
 #endif
 
 bool   thread_unlink_calls;
+bool   record_job_trace;
 extern mom_hierarchy_t *mh;
 std::list<job *> alljobs_list;
 int              job_exit_wait_time = DEFAULT_JOB_EXIT_WAIT_TIME;
@@ -514,6 +516,11 @@ int log_open(char *filename, char *directory)
   exit(1);
   }
 
+int log_async_start(void)
+  {
+  return(0);
+  }
+
 int send_sisters(job *pjob, int com, int using_radix, std::set<int> *sisters_to_contact)
   {
   fprintf(stderr, "The call to send_sisters needs to be mocked!!\n");
@@ -1136,3 +1143,17 @@ void authorized_hosts::add_authorized_address(unsigned long addr, unsigned short
 
 authorized_hosts::authorized_hosts() {}
 authorized_hosts auth_hosts;
+
+int trace_open(const char *directory, int source)
+  {
+  return(0);
+  }
+
+void trace_close(void) {}
+
+void trace_flush(void) {}
+
+bool trace_is_open(void)
+  {
+  return(false);
+  }
@@ -4,6 +4,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/socket.h>
 
 #include "pbs_error.h"
 #include "net_cache.h"
@@ -105,6 +108,52 @@ START_TEST(test_socket_connect_unix)
   }
 END_TEST
 
+START_TEST(test_socket_connect_addrs)
+  {
+  struct sockaddr_in  addr;
+  struct sockaddr_in *remotes[3] = { &addr, &addr, &addr };
+  int                 sockets[3];
+  int                 sv[2];
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+
+  /* socket() is mocked to return 10, so put a real socket there */
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  fail_unless(dup2(sv[0], 10) == 10);
+
+  socket_success = true;
+  close_success = true;
+  connect_success = true;
+
+  fail_unless(socket_connect_addrs(remotes, 3, sockets, 0, 1) == 3);
+  fail_unless((sockets[0] == 10) && (sockets[1] == 10) && (sockets[2] == 10));
+
+  /* handshakes that are still in progress are waited for */
+  connect_success = false;
+  errno = EINPROGRESS;
+  fail_unless(socket_connect_addrs(remotes, 3, sockets, 0, 1) == 3);
+  fail_unless(sockets[2] == 10);
+
+  errno = ECONNREFUSED;
+  fail_unless(socket_connect_addrs(remotes, 3, sockets, 0, 1) == 0);
+  fail_unless(sockets[0] == PERMANENT_SOCKET_FAIL);
+
+  errno = EADDRNOTAVAIL;
+  fail_unless(socket_connect_addrs(remotes, 2, sockets, 0, 1) == 0);
+  fail_unless(sockets[1] == TRANSIENT_SOCKET_FAIL);
+
+  socket_success = false;
+  connect_success = true;
+  fail_unless(socket_connect_addrs(remotes, 3, sockets, 0, 1) == 0);
+  fail_unless(sockets[0] == TRANSIENT_SOCKET_FAIL);
+
+  fail_unless(socket_connect_addrs(remotes, 0, sockets, 0, 1) == 0);
+
+  socket_success = true;
+  }
+END_TEST
+
 Suite *net_common_suite(void)
   {
   Suite *s = suite_create("net_common_suite methods");
@@ -128,6 +177,10 @@ Suite *net_common_suite(void)
   tcase_add_test(tc_core, test_socket_connect_unix);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_socket_connect_addrs");
+  tcase_add_test(tc_core, test_socket_connect_addrs);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -991,6 +991,8 @@ int Machine::place_job(
   return(0);
   }
 
+void Machine::set_topology_aware(bool aware) {}
+
 int Machine::getTotalThreads() const
  {
  return(0);
@@ -1092,3 +1094,5 @@ pbsnode *authorized_hosts::get_authorized_node(unsigned long addr, unsigned shor
 
 authorized_hosts::authorized_hosts() {}
 authorized_hosts auth_hosts;
+
+void notify_scheduler(int event) {}
@@ -1187,6 +1187,56 @@ START_TEST(test_place_and_free_task)
 END_TEST
 
 
+START_TEST(test_getContiguousCoreVector)
+  {
+  const char        *jobid = "1.napali";
+  allocation         a(jobid);
+  Chip               c;
+  std::vector<int>   slots;
+
+  c.setId(0);
+  c.setThreads(32);
+  c.setCores(16);
+  c.setMemory(6);
+  c.setChipAvailable(true);
+  for (int i = 0; i < 16; i++)
+    c.make_core(i);
+
+  fail_unless(c.getContiguousCoreVector(slots, 0) == true);
+  fail_unless(slots.size() == 0);
+
+  // cores 2 and 5 are busy, so the first run of 4 free cores starts at 6
+  c.reserve_core(2, a);
+  c.reserve_core(5, a);
+  fail_unless(c.getContiguousCoreVector(slots, 4) == true);
+  fail_unless(slots.size() == 4);
+  fail_unless(slots[0] == 6);
+  fail_unless(slots[3] == 9);
+
+  // a run of 2 fits before core 2
+  slots.clear();
+  fail_unless(c.getContiguousCoreVector(slots, 2) == true);
+  fail_unless(slots[0] == 0);
+  fail_unless(slots[1] == 1);
+
+  // no run of 12 cores, but the run at the end of the chip is taken
+  slots.clear();
+  fail_unless(c.getContiguousCoreVector(slots, 12) == true);
+  fail_unless(slots.size() == 10, "%d slots", (int)slots.size());
+  fail_unless(slots[0] == 6);
+
+  // with the last core busy there is no contiguous run, so take any free cores
+  c.reserve_core(15, a);
+  slots.clear();
+  fail_unless(c.getContiguousCoreVector(slots, 12) == false);
+  fail_unless(slots.size() == 12, "%d slots", (int)slots.size());
+  fail_unless(slots[0] == 0);
+  fail_unless(slots[2] == 3);
+  fail_unless(slots[11] == 13);
+  }
+END_TEST
+
+
 Suite *numa_socket_suite(void)
   {
   Suite *s = suite_create("numa_socket test suite methods");
@@ -1209,6 +1259,7 @@ Suite *numa_socket_suite(void)
   tcase_add_test(tc_core, test_place_all_execution_slots);
   tcase_add_test(tc_core, test_initialize_allocation);
   tcase_add_test(tc_core, test_place_tasks_execution_slots);
+  tcase_add_test(tc_core, test_getContiguousCoreVector);
   suite_add_tcase(s, tc_core);
   
   return(s);
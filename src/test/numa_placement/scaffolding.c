@@ -0,0 +1,149 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "machine.hpp"
+#include "log.h"
+#include "pbs_error.h"
+#include "complete_req.hpp"
+#include "json/json.h"
+#include "numa_constants.h"
+
+const int   ALL_EXECUTION_SLOTS = -1;
+const char *use_cores = "usecores";
+const char *use_threads = "usethreads";
+const char *place_node = "node";
+const char *place_socket = "socket";
+const char *place_numa_node = "numanode";
+const char *place_core = "core";
+const char *place_thread = "thread";
+const char *place_legacy = "legacy";
+const char *place_legacy2 = "legacy2";
+
+int         tasks_for_host;
+std::string thread_type = "usecores";
+req         the_req;
+
+void log_err(int errnum, const char *routine, const char *text)
+  {
+  }
+
+int is_whitespace(
+
+  char c)
+
+  {
+  if ((c == ' ')  ||
+      (c == '\n') ||
+      (c == '\t') ||
+      (c == '\r') ||
+      (c == '\f'))
+    return(TRUE);
+  else
+    return(FALSE);
+  } /* END is_whitespace */
+
+req::req() : execution_slots(1), mem(0), socket(0), numa_nodes(0), cores(0), threads(0), gpus(0),
+             mics(0) {}
+
+req::req(const req &other) {}
+
+req &req::operator =(const req &other)
+  {
+  return(*this);
+  }
+
+int req::set_value(const char *name, const char *value, bool is_default)
+  {
+  if (!strcmp(name, LPROCS))
+    this->execution_slots = atoi(value);
+  else if (!strcmp(name, MEMORY))
+    this->mem = atoi(value);
+  else if (!strcmp(name, GPUS))
+    this->gpus = atoi(value);
+  else if (!strcmp(name, MICS))
+    this->mics = atoi(value);
+
+  return(0);
+  }
+
+unsigned long req::getMemory() const
+  {
+  return(this->mem);
+  }
+
+int req::getPlaceCores() const
+  {
+  return(this->cores);
+  }
+
+int req::getPlaceThreads() const
+  {
+  return(this->threads);
+  }
+
+std::string req::getPlacementType() const
+  {
+  return("");
+  }
+
+void req::set_placement_type(const std::string &type) {}
+
+std::string req::getThreadUsageString() const
+  {
+  return(thread_type);
+  }
+
+int req::getExecutionSlots() const
+  {
+  return(this->execution_slots);
+  }
+
+int req::get_execution_slots() const
+  {
+  return(this->execution_slots);
+  }
+
+int req::get_sockets() const
+  {
+  return(this->socket);
+  }
+
+int req::get_numa_nodes() const
+  {
+  return(this->numa_nodes);
+  }
+
+int req::getMics() const
+  {
+  return(this->mics);
+  }
+
+int req::getGpus() const
+  {
+  return(this->gpus);
+  }
+
+int req::get_num_tasks_for_host(
+
+  const std::string &name) const
+
+  {
+  return(tasks_for_host);
+  }
+
+void req::record_allocation(const allocation &a) {}
+
+complete_req::complete_req() {}
+
+int complete_req::req_count() const
+  {
+  return(1);
+  }
+
+req &complete_req::get_req(int index)
+  {
+  return(the_req);
+  }
+
+job::job() {}
+job::~job() {}
@@ -0,0 +1,414 @@
+#include "machine.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <check.h>
+#include "pbs_error.h"
+#include "complete_req.hpp"
+#include "utils.h"
+#include "json/json.h"
+#include "numa_constants.h"
+
+extern int         tasks_for_host;
+extern req         the_req;
+
+
+/*
+ * Builds a synthetic layout in the format Machine(const std::string &layout, ...) reads.
+ * The first gpu_chips chips get two gpus each. distances may be NULL.
+ */
+
+void build_layout(
+
+  std::string &layout,
+  int          sockets,
+  int          chips_per_socket,
+  int          cores_per_chip,
+  int          gpu_chips,
+  const int   *distances)
+
+  {
+  Json::Value root;
+  int         chip = 0;
+  int         gpu = 0;
+  int         total_chips = sockets * chips_per_socket;
+
+  for (int s = 0; s < sockets; s++)
+    {
+    Json::Value &sock = root[NODE][s][SOCKET];
+
+    sock[OS_INDEX] = s;
+
+    for (int c = 0; c < chips_per_socket; c++, chip++)
+      {
+      Json::Value &numa = sock[NUMA_NODES][c][NUMA_NODE];
+      char         buf[64];
+
+      numa[OS_INDEX] = chip;
+      snprintf(buf, sizeof(buf), "%d-%d", chip * cores_per_chip, (chip + 1) * cores_per_chip - 1);
+      numa[CORES] = buf;
+      numa[THREADS] = "";
+      numa[MEM] = 16000000;
+
+      if (chip < gpu_chips)
+        {
+        snprintf(buf, sizeof(buf), "%d-%d", gpu, gpu + 1);
+        numa[GPUS] = buf;
+        gpu += 2;
+        }
+      }
+    }
+
+  if (distances != NULL)
+    {
+    for (int i = 0; i < total_chips; i++)
+      for (int j = 0; j < total_chips; j++)
+        root[DISTANCES][i][j] = distances[i * total_chips + j];
+    }
+
+  Json::FastWriter writer;
+  layout = writer.write(root);
+  }
+
+
+void set_req(
+
+  int lprocs,
+  int gpus)
+
+  {
+  char buf[16];
+
+  snprintf(buf, sizeof(buf), "%d", lprocs);
+  the_req.set_value(LPROCS, buf, false);
+  snprintf(buf, sizeof(buf), "%d", gpus);
+  the_req.set_value(GPUS, buf, false);
+  }
+
+
+int place(
+
+  Machine     &m,
+  const char  *jobid,
+  int          tasks,
+  std::string &mems)
+
+  {
+  job          pjob;
+  complete_req cr;
+  std::string  cpus;
+
+  mems.clear();
+  tasks_for_host = tasks;
+  pjob.ji_wattr[JOB_ATR_req_information].at_val.at_ptr = &cr;
+  snprintf(pjob.ji_qs.ji_jobid, sizeof(pjob.ji_qs.ji_jobid), "%s", jobid);
+
+  return(m.place_job(&pjob, cpus, mems, "napali", false));
+  }
+
+
+START_TEST(test_numa_distance)
+  {
+  numa_distance_matrix none;
+  numa_distance_matrix d(2, std::vector<int>(2, 20));
+
+  fail_unless(numa_distance(none, 1, 1, true) == LOCAL_NUMA_DISTANCE);
+  fail_unless(numa_distance(none, 0, 1, true) == SOCKET_NUMA_DISTANCE);
+  fail_unless(numa_distance(none, 0, 1, false) == REMOTE_NUMA_DISTANCE);
+
+  d[0][0] = 10;
+  fail_unless(numa_distance(d, 0, 0, true) == 10);
+  fail_unless(numa_distance(d, 1, 0, true) == 20);
+  // chips outside of the matrix fall back to the estimate
+  fail_unless(numa_distance(d, 0, 2, false) == REMOTE_NUMA_DISTANCE);
+  }
+END_TEST
+
+
+START_TEST(test_json_distances)
+  {
+  std::vector<std::string> valid_ids;
+  std::string              layout;
+  std::stringstream        out;
+  int                      distances[] = {10, 12, 20, 22,
+                                          12, 10, 22, 20,
+                                          20, 22, 10, 12,
+                                          22, 20, 12, 10};
+
+  build_layout(layout, 2, 2, 4, 0, NULL);
+  Machine estimated(layout, valid_ids);
+  fail_unless(estimated.getTotalSockets() == 2);
+  fail_unless(estimated.get_numa_distance(1, 1) == LOCAL_NUMA_DISTANCE);
+  fail_unless(estimated.get_numa_distance(0, 1) == SOCKET_NUMA_DISTANCE);
+  fail_unless(estimated.get_numa_distance(1, 2) == REMOTE_NUMA_DISTANCE);
+  fail_unless(estimated.get_socket_distance(0, 1) == REMOTE_NUMA_DISTANCE);
+
+  build_layout(layout, 2, 2, 4, 0, distances);
+  Machine m(layout, valid_ids);
+  fail_unless(m.get_numa_distance(0, 1) == 12);
+  fail_unless(m.get_numa_distance(0, 3) == 22);
+  fail_unless(m.get_socket_distance(0, 1) == 21, "%d", m.get_socket_distance(0, 1));
+
+  // The distances survive being sent to the server
+  m.displayAsJson(out, false);
+  Machine copy(out.str(), valid_ids);
+  fail_unless(copy.get_numa_distance(3, 0) == 22);
+  fail_unless(copy.get_numa_distance(2, 3) == 12);
+  }
+END_TEST
+
+
+START_TEST(test_chip_placement_cost)
+  {
+  std::vector<std::string> valid_ids;
+  std::string              layout;
+
+  build_layout(layout, 1, 2, 8, 1, NULL);
+  Machine m(layout, valid_ids);
+  m.set_topology_aware(true);
+  fail_unless(m.is_topology_aware() == true);
+
+  // Four single core tasks leave half of either chip idle, but chip 0 has gpus
+  set_req(1, 0);
+  std::string mems;
+  fail_unless(place(m, "1.napali", 4, mems) == PBSE_NONE);
+  fail_unless(mems == "1", "placed on '%s'", mems.c_str());
+
+  // Jobs that use gpus go next to them
+  set_req(1, 1);
+  fail_unless(place(m, "2.napali", 2, mems) == PBSE_NONE);
+  fail_unless(mems == "0", "placed on '%s'", mems.c_str());
+
+  // Without topology awareness the first chip that fits is used
+  Machine first_fit(layout, valid_ids);
+  set_req(1, 0);
+  fail_unless(place(first_fit, "1.napali", 4, mems) == PBSE_NONE);
+  fail_unless(mems == "0", "placed on '%s'", mems.c_str());
+  }
+END_TEST
+
+
+START_TEST(test_lowest_cost_socket)
+  {
+  std::vector<std::string> valid_ids;
+  std::string              layout;
+  std::string              mems;
+
+  // Fill most of socket 1 so that it's the tighter fit for the next job
+  build_layout(layout, 2, 1, 8, 0, NULL);
+  Machine m(layout, valid_ids);
+  m.set_topology_aware(true);
+  set_req(1, 0);
+  fail_unless(place(m, "1.napali", 2, mems) == PBSE_NONE);
+  fail_unless(mems == "0", "placed on '%s'", mems.c_str());
+  fail_unless(place(m, "2.napali", 8, mems) == PBSE_NONE);
+  fail_unless(mems == "1", "placed on '%s'", mems.c_str());
+  m.free_job_allocation("2.napali");
+  fail_unless(place(m, "3.napali", 4, mems) == PBSE_NONE);
+  fail_unless(mems == "0", "placed on '%s'", mems.c_str());
+  }
+END_TEST
+
+
+START_TEST(test_split_by_distance)
+  {
+  std::vector<std::string> valid_ids;
+  std::string              layout;
+  std::string              mems;
+  // sockets 0 and 2 are neighbors, as are 1 and 3
+  int                      distances[] = {10, 31, 21, 31,
+                                          31, 10, 31, 21,
+                                          21, 31, 10, 31,
+                                          31, 21, 31, 10};
+
+  build_layout(layout, 4, 1, 4, 0, distances);
+  set_req(1, 0);
+
+  Machine first_fit(layout, valid_ids);
+  fail_unless(place(first_fit, "1.napali", 8, mems) == PBSE_NONE);
+  fail_unless(mems == "0-1", "placed on '%s'", mems.c_str());
+
+  Machine m(layout, valid_ids);
+  m.set_topology_aware(true);
+  fail_unless(place(m, "1.napali", 8, mems) == PBSE_NONE);
+  fail_unless(mems == "0,2", "placed on '%s'", mems.c_str());
+  }
+END_TEST
+
+
+/*
+ * Places the same stream of jobs, with some finishing along the way, on a topology and
+ * reports how far apart each job's numa nodes ended up.
+ */
+
+void place_job_stream(
+
+  const std::string &layout,
+  bool               topology_aware,
+  int                jobs,
+  int               &spanning,
+  double            &mean_distance,
+  int               &rejected)
+
+  {
+  std::vector<std::string> valid_ids;
+  std::vector<std::string> running;
+  Machine                  m(layout, valid_ids);
+  unsigned int             seed = 1;
+  double                   total_distance = 0;
+  int                      placed = 0;
+  static const int         sizes[] = {1, 2, 3, 4, 6, 8, 2, 1};
+
+  m.set_topology_aware(topology_aware);
+  spanning = 0;
+  rejected = 0;
+
+  for (int i = 0; i < jobs; i++)
+    {
+    char             jobid[64];
+    std::string      mems;
+    std::vector<int> chips;
+
+    seed = seed * 1103515245 + 12345;
+    int tasks = sizes[(seed >> 16) % 8];
+    set_req(1, ((seed >> 8) % 10 == 0) ? 1 : 0);
+    tasks_for_host = tasks;
+
+    // finish the oldest jobs to fragment the node
+    while ((running.size() > 0) &&
+           ((m.how_many_tasks_can_be_placed(the_req) < tasks) ||
+            (running.size() > 6)))
+      {
+      m.free_job_allocation(running[0].c_str());
+      running.erase(running.begin());
+      }
+
+    if (m.how_many_tasks_can_be_placed(the_req) < tasks)
+      {
+      rejected++;
+      continue;
+      }
+
+    snprintf(jobid, sizeof(jobid), "%d.napali", i);
+
+    int rc = place(m, jobid, tasks, mems);
+
+    running.push_back(jobid);
+
+    if (rc != PBSE_NONE)
+      {
+      rejected++;
+      continue;
+      }
+
+    translate_range_string_to_vector(mems.c_str(), chips);
+    placed++;
+
+    if (chips.size() > 1)
+      {
+      double sum = 0;
+
+      spanning++;
+
+      for (unsigned int a = 0; a < chips.size(); a++)
+        for (unsigned int b = 0; b < chips.size(); b++)
+          sum += m.get_numa_distance(chips[a], chips[b]);
+
+      total_distance += sum / (chips.size() * chips.size());
+      }
+    else
+      total_distance += LOCAL_NUMA_DISTANCE;
+    }
+
+  mean_distance = (placed > 0) ? total_distance / placed : 0;
+  }
+
+
+START_TEST(test_placement_distance)
+  {
+  std::string layouts[3];
+  const char *names[] = {"2 sockets x 2 numa x 8 cores",
+                         "4 sockets x 2 numa x 6 cores",
+                         "2 sockets x 4 numa x 4 cores"};
+  int         ring[64];
+  int         jobs = 2000;
+
+  // 4 sockets in a ring: 11 within a socket, 21 to a neighbor, 31 across
+  for (int i = 0; i < 8; i++)
+    {
+    for (int j = 0; j < 8; j++)
+      {
+      int hops = abs(i / 2 - j / 2);
+
+      if (hops == 3)
+        hops = 1;
+
+      if (i == j)
+        ring[i * 8 + j] = 10;
+      else if (hops == 0)
+        ring[i * 8 + j] = 11;
+      else
+        ring[i * 8 + j] = 11 + hops * 10;
+      }
+    }
+
+  build_layout(layouts[0], 2, 2, 8, 1, NULL);
+  build_layout(layouts[1], 4, 2, 6, 2, ring);
+  build_layout(layouts[2], 2, 4, 4, 2, NULL);
+
+  for (int l = 0; l < 3; l++)
+    {
+    int    spanning[2];
+    double distance[2];
+    int    rejected[2];
+
+    for (int mode = 0; mode < 2; mode++)
+      place_job_stream(layouts[l], mode == 1, jobs, spanning[mode], distance[mode],
+                       rejected[mode]);
+
+    // the lowest cost placement takes the same jobs and spreads them no wider or farther
+    fail_unless(rejected[1] == rejected[0], "%s: %d != %d", names[l], rejected[1], rejected[0]);
+    fail_unless(spanning[1] <= spanning[0], "%s: %d > %d", names[l], spanning[1], spanning[0]);
+    fail_unless(distance[1] <= distance[0], "%s: %.2f > %.2f", names[l], distance[1], distance[0]);
+    }
+  }
+END_TEST
+
+
+Suite *numa_placement_suite(void)
+  {
+  Suite *s = suite_create("numa_placement test suite methods");
+  TCase *tc_core = tcase_create("test_numa_distance");
+  tcase_add_test(tc_core, test_numa_distance);
+  tcase_add_test(tc_core, test_json_distances);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_chip_placement_cost");
+  tcase_add_test(tc_core, test_chip_placement_cost);
+  tcase_add_test(tc_core, test_lowest_cost_socket);
+  tcase_add_test(tc_core, test_split_by_distance);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_placement_distance");
+  tcase_add_test(tc_core, test_placement_distance);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(numa_placement_suite());
+  srunner_set_log(sr, "numa_placement_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -265,6 +265,11 @@ int Chip::place_task(req &r, allocation &a, int to_place, const char *hostname)
   return(placed);
   }
 
+int Socket::lowest_cost_chip(const req &r, int place_type, int tasks) const
+  {
+  return(-1);
+  }
+
 bool Chip::free_task(const char *jobid)
   {
   static int count = 0;
@@ -1,11 +1,17 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <unistd.h>
+#include <errno.h>
 
 ssize_t read_ac_socket(int fd, void *buf, ssize_t count)
   {
-  fprintf(stderr, "The call to read_nonblocking_socket needs to be mocked!!\n");
-  exit(1);
+  ssize_t rc;
+
+  while (((rc = read(fd, buf, count)) < 0) && (errno == EINTR))
+    ;
+
+  return(rc);
   }
 
 time_t get_stat_update_interval()
@@ -5,7 +5,5 @@
 
 #define PBS_DEMUX_SUITE 1
 Suite *pbs_demux_suite();
-#define METH_2 2
-Suite *meth_2_suite();
 
 #endif /* _PBS_DEMUX_CT_H */
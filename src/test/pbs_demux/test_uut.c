@@ -2,33 +2,252 @@
 #include "test_pbs_demux.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <sys/un.h>
+#include <string>
+#include <vector>
 
-
+#include "pbs_demux.h"
 #include "pbs_error.h"
 
-START_TEST(test_one)
+#define DEMUX_WRITERS     1000
+#define DEMUX_LINES       20
+
+int output_file()
+  {
+  char path[] = "/tmp/demux_test_XXXXXX";
+  int  fd = mkstemp(path);
+
+  unlink(path);
+
+  return(fd);
+  }
+
+std::string file_contents(int fd)
   {
+  std::string contents;
+  char        buf[65536];
+  ssize_t     rc;
+
+  lseek(fd, 0, SEEK_SET);
+
+  while ((rc = read(fd, buf, sizeof(buf))) > 0)
+    contents.append(buf, rc);
+
+  return(contents);
+  }
+
+START_TEST(test_readit_holds_partial_lines)
+  {
+  int           sv[2];
+  int           out = output_file();
+  struct routem r;
+
+  memset(&r, 0, sizeof(r));
+  r.r_where = old_out;
+  r.r_nl = 1;
+
+  fail_unless(out >= 0);
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
 
+  fail_unless(write(sv[1], "abc\nde", 6) == 6);
+  fail_unless(readit(sv[0], &r, out) == 6);
+  fail_unless(file_contents(out) == "abc\n");
+  fail_unless(r.r_line_len == 2);
 
+  fail_unless(write(sv[1], "f\ng", 3) == 3);
+  fail_unless(readit(sv[0], &r, out) == 3);
+  fail_unless(file_contents(out) == "abc\ndef\n");
+  fail_unless(r.r_line_len == 1);
+
+  /* the unfinished last line still goes out when the task exits */
+  close(sv[1]);
+  fail_unless(readit(sv[0], &r, out) == 0);
+  fail_unless(file_contents(out) == "abc\ndef\ng");
+  fail_unless(r.r_where == invalid);
+  fail_unless(r.r_line == NULL);
+
+  close(out);
   }
 END_TEST
 
-START_TEST(test_two)
+START_TEST(test_demux_accepts_streams)
   {
+  demux_io           io;
+  struct sockaddr_un addr;
+  int                listener;
+  int                client;
+  int                out = output_file();
+  int                err = output_file();
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "/tmp/demux_test_%d", (int)getpid());
+  unlink(addr.sun_path);
+
+  listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  fail_unless(bind(listener, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+  fail_unless(listen(listener, 5) == 0);
+
+  fail_unless(demux_init(&io, sysconf(_SC_OPEN_MAX), out, err) == 0);
+  fail_unless(demux_watch(&io, listener, new_err) == 0);
+  fail_unless(io.di_streams == 0);
+
+  client = socket(AF_UNIX, SOCK_STREAM, 0);
+  fail_unless(connect(client, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+
+  fail_unless(demux_once(&io, 5000) == 1);
+  fail_unless(io.di_streams == 1);
+
+  fail_unless(write(client, "to stderr\n", 10) == 10);
+  fail_unless(demux_once(&io, 5000) == 1);
 
+  close(client);
+  fail_unless(demux_once(&io, 5000) == 1);
+  fail_unless(io.di_streams == 0);
 
+  /* nothing left to do */
+  fail_unless(demux_once(&io, 10) == 0);
+
+  fail_unless(file_contents(err) == "to stderr\n");
+  fail_unless(file_contents(out).size() == 0);
+  fail_unless(io.di_bytes == 10);
+
+  demux_free(&io);
+  close(listener);
+  unlink(addr.sun_path);
+  }
+END_TEST
+
+struct writers
+  {
+  std::vector<int> socks;
+  };
+
+void *write_lines(
+
+  void *arg)
+
+  {
+  writers *w = (writers *)arg;
+  char     line[128];
+  int      len;
+
+  for (int l = 0; l < DEMUX_LINES; l++)
+    {
+    for (size_t rank = 0; rank < w->socks.size(); rank++)
+      {
+      len = snprintf(line, sizeof(line), "rank %04d line %04d %s\n",
+        (int)rank, l, "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+
+      if (write(w->socks[rank], line, len) != len)
+        return((void *)1);
+      }
+    }
+
+  for (size_t rank = 0; rank < w->socks.size(); rank++)
+    close(w->socks[rank]);
+
+  return(NULL);
+  }
+
+START_TEST(test_demux_many_streams)
+  {
+  demux_io        io;
+  writers         w;
+  pthread_t       writer;
+  void           *writer_rc;
+  int             out = output_file();
+  int             sv[2];
+  int             streams = DEMUX_WRITERS;
+  struct rlimit   rl;
+  std::vector<int> next_line(DEMUX_WRITERS, 0);
+
+  /* each stream takes two descriptors, make room for them if we can */
+  fail_unless(getrlimit(RLIMIT_NOFILE, &rl) == 0);
+
+  if (rl.rlim_cur < (rlim_t)(streams * 2 + 64))
+    {
+    rl.rlim_cur = (rlim_t)(streams * 2 + 64);
+
+    if (rl.rlim_cur > rl.rlim_max)
+      rl.rlim_cur = rl.rlim_max;
+
+    setrlimit(RLIMIT_NOFILE, &rl);
+    getrlimit(RLIMIT_NOFILE, &rl);
+
+    if (rl.rlim_cur < (rlim_t)(streams * 2 + 64))
+      streams = (rl.rlim_cur - 64) / 2;
+    }
+
+  fail_unless(streams > 0);
+  fail_unless(demux_init(&io, sysconf(_SC_OPEN_MAX), out, out) == 0);
+
+  for (int rank = 0; rank < streams; rank++)
+    {
+    fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    fail_unless(demux_watch(&io, sv[0], old_out) == 0);
+    w.socks.push_back(sv[1]);
+    }
+
+  fail_unless(pthread_create(&writer, NULL, write_lines, &w) == 0);
+
+  while (io.di_streams > 0)
+    fail_unless(demux_once(&io, 5000) > 0);
+
+  pthread_join(writer, &writer_rc);
+  fail_unless(writer_rc == NULL);
+
+  /* every line arrives whole and each task's lines stay in order */
+  std::string output = file_contents(out);
+  size_t      pos = 0;
+  int         lines = 0;
+
+  fail_unless(output.size() == io.di_bytes);
+
+  while (pos < output.size())
+    {
+    size_t nl = output.find('\n', pos);
+    int    rank;
+    int    l;
+    char   rest[128];
+
+    fail_unless(nl != std::string::npos);
+    fail_unless(sscanf(output.c_str() + pos, "rank %d line %d %127s", &rank, &l, rest) == 3);
+    fail_unless(nl - pos == 84);
+    fail_unless(rank >= 0 && rank < streams);
+    fail_unless(next_line[rank] == l);
+
+    next_line[rank]++;
+    lines++;
+    pos = nl + 1;
+    }
+
+  fail_unless(lines == streams * DEMUX_LINES);
+
+  demux_free(&io);
+  close(out);
   }
 END_TEST
 
 Suite *pbs_demux_suite(void)
   {
   Suite *s = suite_create("pbs_demux_suite methods");
-  TCase *tc_core = tcase_create("test_one");
-  tcase_add_test(tc_core, test_one);
+  TCase *tc_core = tcase_create("test_readit_holds_partial_lines");
+  tcase_add_test(tc_core, test_readit_holds_partial_lines);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_demux_accepts_streams");
+  tcase_add_test(tc_core, test_demux_accepts_streams);
   suite_add_tcase(s, tc_core);
 
-  tc_core = tcase_create("test_two");
-  tcase_add_test(tc_core, test_two);
+  tc_core = tcase_create("test_demux_many_streams");
+  tcase_add_test(tc_core, test_demux_many_streams);
+  tcase_set_timeout(tc_core, 60);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -0,0 +1,135 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "pbs_log.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "pbs_error.h"
+
+/*
+ * log_record() throughput against writer threads, synchronous versus the
+ * asynchronous log writer. Not part of make check: build it with
+ * "make bench_log" and run it as ./bench_log [records per run].
+ *
+ * Each run splits the records evenly over 1, 2, 4 ... 64 threads logging
+ * job state changes into a temporary log and prints the records/sec of
+ * both modes, along with how many records the asynchronous writer dropped.
+ */
+
+int bench_per_thread;
+
+void *bench_logger(
+
+  void *arg)
+
+  {
+  char text[128];
+
+  for (int i = 0; i < bench_per_thread; i++)
+    {
+    snprintf(text, sizeof(text), "job %d.napali changed state from RUNNING to EXITING", i);
+    log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "bench", text);
+    }
+
+  return(NULL);
+  } /* END bench_logger() */
+
+double bench_run(
+
+  int  records,
+  int  threads,
+  bool async)
+
+  {
+  char            path[64];
+  pthread_t       ids[64];
+  struct timeval  start;
+  struct timeval  end;
+  int             fd;
+
+  strcpy(path, "/tmp/pbs_log_bench.XXXXXX");
+
+  if ((fd = mkstemp(path)) < 0)
+    {
+    perror("can't create the log");
+    exit(1);
+    }
+
+  close(fd);
+
+  pthread_mutex_lock(&log_mutex);
+  fd = log_open(path, (char *)"/tmp");
+  pthread_mutex_unlock(&log_mutex);
+
+  if (fd != 0)
+    {
+    fprintf(stderr, "can't open %s\n", path);
+    exit(1);
+    }
+
+  if ((async) &&
+      (log_async_start() != PBSE_NONE))
+    {
+    fprintf(stderr, "can't start the log writer\n");
+    exit(1);
+    }
+
+  bench_per_thread = records / threads;
+
+  gettimeofday(&start, NULL);
+
+  for (int i = 0; i < threads; i++)
+    pthread_create(&ids[i], NULL, bench_logger, NULL);
+
+  for (int i = 0; i < threads; i++)
+    pthread_join(ids[i], NULL);
+
+  /* the records aren't logged until the writer has them on disk */
+  if (async)
+    log_async_stop();
+
+  gettimeofday(&end, NULL);
+
+  pthread_mutex_lock(&log_mutex);
+  log_close(0);
+  pthread_mutex_unlock(&log_mutex);
+  unlink(path);
+
+  return((bench_per_thread * threads) /
+         ((end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0));
+  } /* END bench_run() */
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  int           records = 200000;
+  unsigned long dropped = 0;
+
+  if (argc > 1)
+    records = atoi(argv[1]);
+
+  if (records < 64)
+    {
+    fprintf(stderr, "usage: %s [records per run >= 64]\n", argv[0]);
+    return(1);
+    }
+
+  for (int threads = 1; threads <= 64; threads *= 2)
+    {
+    double sync_rate = bench_run(records, threads, false);
+    double async_rate = bench_run(records, threads, true);
+
+    printf("log_record %2d threads: %10.0f records/sec sync, %10.0f records/sec async, %lu dropped\n",
+      threads, sync_rate, async_rate, log_async_dropped() - dropped);
+
+    dropped = log_async_dropped();
+    }
+
+  return(0);
+  } /* END main() */
@@ -5,6 +5,9 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include <dirent.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/wait.h>
 
 #include <string>
 
@@ -16,6 +19,44 @@ extern bool first_time;
 extern bool dir_is_null;
 extern bool time_expired;
 extern bool stat_fail;
+extern pthread_mutex_t log_mutex;
+
+
+/* opens a fresh log in a temporary file and returns its name in path */
+void open_test_log(
+
+  char *path)
+
+  {
+  int fd;
+
+  strcpy(path, "/tmp/pbs_log_test.XXXXXX");
+  fd = mkstemp(path);
+  fail_unless(fd >= 0);
+  close(fd);
+
+  pthread_mutex_lock(&log_mutex);
+  fail_unless(log_open(path, (char *)"/tmp") == 0);
+  pthread_mutex_unlock(&log_mutex);
+  }
+
+
+/* strips the timestamp and thread id so lines from different calls compare */
+std::string strip_log_line(
+
+  const char *line)
+
+  {
+  std::string stripped(line);
+  size_t      pos = stripped.find(';');
+
+  stripped.erase(0, pos);
+
+  pos = stripped.find('.', 4);
+  stripped.erase(pos, stripped.find(';', pos) - pos);
+
+  return(stripped);
+  }
 
 START_TEST(test_one)
   {
@@ -94,6 +135,225 @@ START_TEST(test_two)
   }
 END_TEST
 
+
+START_TEST(test_async_format)
+  {
+  char  path[64];
+  char  line[1024];
+  FILE *fp;
+  int   count = 0;
+  std::string sync_lines[3];
+  std::string async_lines[3];
+
+  open_test_log(path);
+
+  log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "1.napali", "first line\nsecond line\r\nthird line");
+
+  fail_unless(log_async_start() == PBSE_NONE);
+  log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "1.napali", "first line\nsecond line\r\nthird line");
+
+  /* nothing is written until the writer runs */
+  log_async_flush();
+  log_async_stop();
+  fail_unless(log_async_dropped() == 0);
+
+  fp = fopen(path, "r");
+  fail_unless(fp != NULL);
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+    /* the first line is "Log opened" */
+    if ((count > 0) &&
+        (count < 4))
+      sync_lines[count - 1] = strip_log_line(line);
+    else if ((count >= 4) &&
+             (count < 7))
+      async_lines[count - 4] = strip_log_line(line);
+
+    count++;
+    }
+
+  fclose(fp);
+
+  pthread_mutex_lock(&log_mutex);
+  log_close(0);
+  pthread_mutex_unlock(&log_mutex);
+  unlink(path);
+
+  fail_unless(count == 7, "%d lines", count);
+  fail_unless(sync_lines[1].find("[continued]second line") != std::string::npos, sync_lines[1].c_str());
+
+  for (int i = 0; i < 3; i++)
+    fail_unless(sync_lines[i] == async_lines[i], "'%s' != '%s'", sync_lines[i].c_str(), async_lines[i].c_str());
+  }
+END_TEST
+
+
+START_TEST(test_async_order)
+  {
+  char  path[64];
+  char  line[8192];
+  char  text[6000];
+  FILE *fp;
+  int   expected = 0;
+
+  open_test_log(path);
+  fail_unless(log_async_start() == PBSE_NONE);
+
+  /* records too big for a ring are written synchronously, after the ones queued before them */
+  for (int i = 0; i < 100; i++)
+    {
+    if (i % 10 == 9)
+      {
+      snprintf(text, sizeof(text), "record %d %05000d", i, 0);
+      }
+    else
+      snprintf(text, sizeof(text), "record %d", i);
+
+    log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "order", text);
+    }
+
+  log_async_stop();
+
+  fp = fopen(path, "r");
+  fail_unless(fp != NULL);
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+    char *ptr = strstr(line, ";order;record ");
+
+    if (ptr == NULL)
+      continue;
+
+    fail_unless(atoi(ptr + strlen(";order;record ")) == expected, line);
+    expected++;
+    }
+
+  fclose(fp);
+
+  pthread_mutex_lock(&log_mutex);
+  log_close(0);
+  pthread_mutex_unlock(&log_mutex);
+  unlink(path);
+
+  fail_unless(expected == 100, "%d records", expected);
+  }
+END_TEST
+
+
+#define THREAD_RECORDS 2000
+
+void *thread_logger(
+
+  void *arg)
+
+  {
+  char text[128];
+
+  for (int i = 0; i < THREAD_RECORDS; i++)
+    {
+    snprintf(text, sizeof(text), "job %d.napali changed state from RUNNING to EXITING", i);
+    log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "threads", text);
+    }
+
+  return(NULL);
+  }
+
+
+/* counts the lines of the log at path that contain match */
+int count_log_lines(
+
+  const char *path,
+  const char *match)
+
+  {
+  char  line[1024];
+  int   count = 0;
+  FILE *fp = fopen(path, "r");
+
+  fail_unless(fp != NULL);
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+    if (strstr(line, match) != NULL)
+      count++;
+    }
+
+  fclose(fp);
+
+  return(count);
+  }
+
+
+START_TEST(test_async_threads)
+  {
+  char          path[64];
+  pthread_t     ids[8];
+  unsigned long dropped = log_async_dropped();
+
+  open_test_log(path);
+  fail_unless(log_async_start() == PBSE_NONE);
+
+  for (int i = 0; i < 8; i++)
+    pthread_create(&ids[i], NULL, thread_logger, NULL);
+
+  for (int i = 0; i < 8; i++)
+    pthread_join(ids[i], NULL);
+
+  log_async_stop();
+
+  pthread_mutex_lock(&log_mutex);
+  log_close(0);
+  pthread_mutex_unlock(&log_mutex);
+
+  /* every record is written once, unless it was dropped */
+  dropped = log_async_dropped() - dropped;
+  fail_unless(count_log_lines(path, ";threads;job ") == (int)(8 * THREAD_RECORDS - dropped));
+
+  unlink(path);
+  }
+END_TEST
+
+
+START_TEST(test_async_fork)
+  {
+  char  path[64];
+  char  text[64];
+  int   status;
+  pid_t pid;
+
+  open_test_log(path);
+  fail_unless(log_async_start() == PBSE_NONE);
+
+  for (int i = 0; i < 50; i++)
+    {
+    snprintf(text, sizeof(text), "record %d", i);
+    log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, "fork", text);
+    }
+
+  pid = fork();
+  fail_unless(pid >= 0);
+
+  if (pid == 0)
+    {
+    /* the parent's pending records must not be written again by the child */
+    log_async_flush();
+    exit(0);
+    }
+
+  fail_unless(waitpid(pid, &status, 0) == pid);
+  log_async_stop();
+
+  pthread_mutex_lock(&log_mutex);
+  log_close(0);
+  pthread_mutex_unlock(&log_mutex);
+
+  fail_unless(count_log_lines(path, ";fork;record ") == 50);
+
+  unlink(path);
+  }
+END_TEST
+
 Suite *pbs_log_suite(void)
   {
   Suite *s = suite_create("pbs_log_suite methods");
@@ -105,6 +365,16 @@ Suite *pbs_log_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_async_format");
+  tcase_add_test(tc_core, test_async_format);
+  tcase_add_test(tc_core, test_async_order);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_async_threads");
+  tcase_add_test(tc_core, test_async_threads);
+  tcase_add_test(tc_core, test_async_fork);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -17,8 +17,12 @@
 #include "threadpool.h"
 #include "mom_hierarchy_handler.h"
 #include "completed_jobs_map.h"
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 #include "acl_special.hpp"
 #include "authorized_hosts.hpp"
+#include "sched_event_tracker.hpp"
+#include "event_trace.h"
 
 bool exit_called = false;
 pthread_mutex_t *job_log_mutex;
@@ -222,6 +226,11 @@ int log_open(char *filename, char *directory)
   exit(1);
   }
 
+int log_async_start(void)
+  {
+  return(0);
+  }
+
 int init_network(unsigned int socket, void *(*readfunc)(void *))
   {
   fprintf(stderr, "The call to init_network needs to be mocked!!\n");
@@ -514,8 +523,30 @@ void clear_all_alps_reservations() {}
 
 completed_jobs_map_class::completed_jobs_map_class() {}
 completed_jobs_map_class::~completed_jobs_map_class() {}
+completed_job_store::completed_job_store() {}
+completed_job_store::~completed_job_store() {}
+job_history::job_history() {}
+job_history::~job_history() {}
 void *remove_completed_jobs(void *vp) {return(NULL);}
 
 acl_special::acl_special() {}
 
 authorized_hosts::authorized_hosts() {}
+
+void notify_scheduler(int event) {}
+
+void check_queued_job_counts(struct work_task *ptask) {}
+
+sched_event_tracker sched_events;
+
+sched_event_tracker::sched_event_tracker() {}
+sched_event_tracker::~sched_event_tracker() {}
+
+bool sched_event_tracker::claim_cycle(time_t now, long min_interval)
+  {
+  return(false);
+  }
+
+void trace_flush(void) {}
+
+void acct_flush(void) {}
@@ -11,7 +11,12 @@
 std::map<unsigned int, pmix_operation> existing_connections;
 
 int    completed_op = 0;
+int    reported_up = 0;
+int    modex_requests = 0;
+int    modex_answers = 0;
+int    last_modex_status = 0;
 bool   ms = false;
+job   *found_job = NULL;
 time_t pbs_tcp_timeout = 300;
 const int DISCONNECT_OPERATION = 3;
 char         mom_alias[PBS_MAXHOSTNAME + 1];
@@ -29,6 +34,22 @@ bool pmix_operation::mark_reported(const std::string &hostname)
   return(true);
   }
 
+void pmix_operation::absorb(const pmix_operation &early) {}
+
+void pmix_operation::add_data(const std::string &additional) {}
+
+const std::string &pmix_operation::get_parent() const
+  {
+  return(this->parent);
+  }
+
+const std::string &pmix_operation::get_data() const
+  {
+  return(this->data);
+  }
+
+void pmix_operation::set_data(const std::string &all_data) {}
+
 pmix_operation::pmix_operation() {}
 pmix_operation::pmix_operation(job *pjob, const pmix_proc_t procs[], size_t nprocs, const std::string &data,
     pmix_modex_cbfunc_t cbfunc, void *cbdata)
@@ -84,10 +105,66 @@ int pmix_tracker::abort(int status, pmix_proc_t proc_list[], size_t nprocs, cons
   return(0);
   }
 
-void report_fence_to_ms(
+void report_fence_to_parent(
 
-  job  *pjob,
-  char *data)
+  job               *pjob,
+  const char        *parent,
+  const std::string &data)
+
+  {
+  reported_up++;
+  }
+
+int request_modex_from_host(
+
+  job        *pjob,
+  const char *remote_host,
+  int         rank)
+
+  {
+  modex_requests++;
+  return(0);
+  }
+
+void send_modex_data(
+
+  job               *pjob,
+  const char        *requestor,
+  int                rank,
+  int                status,
+  const std::string &data)
+
+  {
+  modex_answers++;
+  last_modex_status = status;
+  }
+
+void pass_modex_data(
+
+  pmix_modex_cbfunc_t  cbfunc,
+  void                *cbdata,
+  pmix_status_t        status,
+  const std::string   &modex)
+
+  {
+  cbfunc(status, modex.c_str(), modex.size(), cbdata, NULL, NULL);
+  }
+
+pmix_status_t PMIx_server_dmodex_request(
+
+  const pmix_proc_t         *proc,
+  pmix_dmodex_response_fn_t  cbfunc,
+  void                      *cbdata)
+
+  {
+  return(PMIX_ERR_NOT_FOUND);
+  }
+
+void log_err(
+
+  int         errnum,
+  const char *routine,
+  const char *text)
 
   {
   }
@@ -124,7 +201,7 @@ job *mom_find_job_by_int_string(
   const char *int_string)
 
   {
-  return(NULL);
+  return(found_job);
   }
 
 task *pbs_task_create(
@@ -5,8 +5,32 @@
 #include <check.h>
 
 void notify_fence_complete(job *pjob);
+pmix_status_t pmix_server_dmodex_req(const pmix_proc_t *proc, const pmix_info_t info[], size_t ninfo,
+                                     pmix_modex_cbfunc_t cbfunc, void *cbdata);
 
-extern int completed_op;
+extern int  completed_op;
+extern int  modex_requests;
+extern int  modex_answers;
+extern int  last_modex_status;
+extern job *found_job;
+extern char mom_alias[];
+
+int         modex_callbacks;
+std::string last_modex;
+
+void count_modex(
+
+  pmix_status_t       status,
+  const char         *data,
+  size_t              ndata,
+  void               *cbdata,
+  pmix_release_cbfunc_t relfn,
+  void               *release_cbdata)
+
+  {
+  modex_callbacks++;
+  last_modex.assign(data, ndata);
+  }
 
 START_TEST(test_fences)
   {
@@ -24,6 +48,83 @@ START_TEST(test_fences)
   strcpy(pjob.ji_qs.ji_jobid, jid.c_str());
   notify_fence_complete(&pjob);
   fail_unless(completed_op == 1);
+
+  // completing a fence forgets it so the job's next fence starts fresh
+  fail_unless(pending_fences.find(jid) == pending_fences.end());
+  }
+END_TEST
+
+
+START_TEST(test_dmodex)
+  {
+  job          pjob;
+  hnodent      hosts[2];
+  vnodent      vnods[4];
+  pmix_proc_t  proc;
+
+  memset(&pjob, 0, sizeof(pjob));
+  memset(hosts, 0, sizeof(hosts));
+  memset(vnods, 0, sizeof(vnods));
+  memset(&proc, 0, sizeof(proc));
+
+  strcpy(pjob.ji_qs.ji_jobid, "4.napali");
+  hosts[0].hn_host = strdup("napali");
+  hosts[1].hn_host = strdup("waimea");
+  pjob.ji_hosts = hosts;
+  pjob.ji_numnodes = 2;
+  pjob.ji_vnods = vnods;
+  pjob.ji_numvnod = 4;
+
+  for (int i = 0; i < 4; i++)
+    vnods[i].vn_host = hosts + i / 2;
+
+  strcpy(mom_alias, "napali");
+  strcpy(proc.nspace, "4");
+
+  found_job = NULL;
+  fail_unless(pmix_server_dmodex_req(&proc, NULL, 0, count_modex, NULL) == PMIX_ERR_NOT_FOUND);
+
+  found_job = &pjob;
+  proc.rank = 9;
+  fail_unless(pmix_server_dmodex_req(&proc, NULL, 0, count_modex, NULL) == PMIX_ERR_BAD_PARAM);
+
+  // our own server has the data for local ranks
+  proc.rank = 1;
+  fail_unless(pmix_server_dmodex_req(&proc, NULL, 0, count_modex, NULL) == PMIX_ERR_NOT_FOUND);
+
+  // two local clients waiting on one remote rank only cost one fetch
+  modex_requests = 0;
+  modex_callbacks = 0;
+  proc.rank = 2;
+  fail_unless(pmix_server_dmodex_req(&proc, NULL, 0, count_modex, NULL) == PMIX_SUCCESS);
+  fail_unless(pmix_server_dmodex_req(&proc, NULL, 0, count_modex, NULL) == PMIX_SUCCESS);
+  fail_unless(modex_requests == 1);
+  fail_unless(modex_callbacks == 0);
+
+  deliver_modex(&pjob, 2, PMIX_SUCCESS, std::string("two\0bytes", 9));
+  fail_unless(modex_callbacks == 2);
+  fail_unless(last_modex.size() == 9);
+
+  // later requests are answered from the cache
+  fail_unless(pmix_server_dmodex_req(&proc, NULL, 0, count_modex, NULL) == PMIX_SUCCESS);
+  fail_unless(modex_requests == 1);
+  fail_unless(modex_callbacks == 3);
+
+  // failures are passed on but not cached
+  proc.rank = 3;
+  fail_unless(pmix_server_dmodex_req(&proc, NULL, 0, count_modex, NULL) == PMIX_SUCCESS);
+  deliver_modex(&pjob, 3, PMIX_ERR_TIMEOUT, "");
+  fail_unless(modex_callbacks == 4);
+  fail_unless(modex_cache[pjob.ji_qs.ji_jobid].find(3) == modex_cache[pjob.ji_qs.ji_jobid].end());
+
+  forget_pmix_job(pjob.ji_qs.ji_jobid);
+  fail_unless(modex_cache.find(pjob.ji_qs.ji_jobid) == modex_cache.end());
+
+  // a request we can't serve still gets an answer
+  modex_answers = 0;
+  serve_modex_request(&pjob, "waimea", 0);
+  fail_unless(modex_answers == 1);
+  fail_unless(last_modex_status == PMIX_ERR_NOT_FOUND);
   }
 END_TEST
 
@@ -35,6 +136,10 @@ Suite *pmix_interface_suite(void)
   tcase_add_test(tc_core, test_fences);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_dmodex");
+  tcase_add_test(tc_core, test_dmodex);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
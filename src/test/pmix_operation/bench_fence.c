@@ -0,0 +1,235 @@
+#include "pmix_operation.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <vector>
+
+/*
+ * Fence and modex exchange time against host count, flat versus the fence
+ * tree. Not part of make check: build it with "make bench_fence" and run it
+ * as ./bench_fence [max hosts] [modex bytes per host].
+ *
+ * Each host is a local stand-in listening on loopback. It waits for the
+ * data of its children in the fence tree, passes its subtree's data up to
+ * its parent and then passes the whole fence's data down to its children,
+ * spending BENCH_MSG_USEC on every message it sends or receives.
+ */
+
+#define BENCH_MSG_USEC  500   /* encoding or decoding one fence message */
+
+std::vector<struct sockaddr_in> bench_addrs;
+std::vector<int>                bench_listeners;
+std::vector<size_t>             bench_received;
+int                             bench_nodes;
+int                             bench_radix;
+size_t                          bench_modex_bytes = 256;
+pthread_barrier_t               bench_start;
+
+bool bench_io(
+
+  int     sock,
+  char   *buf,
+  size_t  len,
+  bool    sending)
+
+  {
+  while (len > 0)
+    {
+    ssize_t done = sending ? write(sock, buf, len) : read(sock, buf, len);
+
+    if (done <= 0)
+      return(false);
+
+    buf += done;
+    len -= done;
+    }
+
+  return(true);
+  } /* END bench_io() */
+
+void bench_send(
+
+  int                to,
+  const std::string &data)
+
+  {
+  uint64_t len = data.size();
+  int      sock = socket(AF_INET, SOCK_STREAM, 0);
+
+  usleep(BENCH_MSG_USEC);
+
+  if ((connect(sock, (struct sockaddr *)&bench_addrs[to], sizeof(struct sockaddr_in)) != 0) ||
+      (bench_io(sock, (char *)&len, sizeof(len), true) == false) ||
+      (bench_io(sock, (char *)data.data(), len, true) == false))
+    fprintf(stderr, "host couldn't send to %d\n", to);
+
+  close(sock);
+  } /* END bench_send() */
+
+std::string bench_recv(
+
+  int me)
+
+  {
+  std::string data;
+  uint64_t    len = 0;
+  int         sock = accept(bench_listeners[me], NULL, NULL);
+
+  if (bench_io(sock, (char *)&len, sizeof(len), false) == true)
+    {
+    data.resize(len);
+
+    if (bench_io(sock, &data[0], len, false) == false)
+      data.clear();
+    }
+
+  close(sock);
+  usleep(BENCH_MSG_USEC);
+
+  return(data);
+  } /* END bench_recv() */
+
+void bench_fence_step(
+
+  int me)
+
+  {
+  std::vector<int> kids;
+  std::string      data(bench_modex_bytes, 'a' + me % 26);
+  int              up = fence_tree_parent(me, bench_radix);
+
+  fence_tree_children(me, bench_nodes, bench_radix, kids);
+
+  for (size_t i = 0; i < kids.size(); i++)
+    data += bench_recv(me);
+
+  if (up >= 0)
+    {
+    bench_send(up, data);
+    data = bench_recv(me);
+    }
+
+  for (size_t i = 0; i < kids.size(); i++)
+    bench_send(kids[i], data);
+
+  bench_received[me] = data.size();
+  } /* END bench_fence_step() */
+
+void *bench_host(
+
+  void *arg)
+
+  {
+  int me = (int)(long)arg;
+
+  pthread_barrier_wait(&bench_start);
+  bench_fence_step(me);
+
+  return(NULL);
+  } /* END bench_host() */
+
+double bench_fence(
+
+  int nodes,
+  int radix)
+
+  {
+  std::vector<pthread_t> threads(nodes);
+  struct timeval         start;
+  struct timeval         end;
+
+  bench_nodes = nodes;
+  bench_radix = radix;
+  bench_received.assign(nodes, 0);
+
+  pthread_barrier_init(&bench_start, NULL, nodes);
+
+  for (int i = 1; i < nodes; i++)
+    pthread_create(&threads[i], NULL, bench_host, (void *)(long)i);
+
+  pthread_barrier_wait(&bench_start);
+  gettimeofday(&start, NULL);
+
+  bench_fence_step(0);
+
+  for (int i = 1; i < nodes; i++)
+    pthread_join(threads[i], NULL);
+
+  gettimeofday(&end, NULL);
+  pthread_barrier_destroy(&bench_start);
+
+  /* every host has to end up with the whole fence's data */
+  for (int i = 0; i < nodes; i++)
+    {
+    if (bench_received[i] != (size_t)nodes * bench_modex_bytes)
+      fprintf(stderr, "host %d got %lu bytes\n", i, (unsigned long)bench_received[i]);
+    }
+
+  return((end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_usec - start.tv_usec) / 1000.0);
+  } /* END bench_fence() */
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  int max_nodes = 256;
+  int radix = 4;
+
+  if (argc > 1)
+    max_nodes = atoi(argv[1]);
+
+  if (argc > 2)
+    bench_modex_bytes = strtoul(argv[2], NULL, 10);
+
+  if (max_nodes < 16)
+    {
+    fprintf(stderr, "usage: %s [max hosts >= 16] [modex bytes per host]\n", argv[0]);
+    return(1);
+    }
+
+  bench_addrs.resize(max_nodes);
+  bench_listeners.resize(max_nodes);
+
+  for (int i = 0; i < max_nodes; i++)
+    {
+    socklen_t len = sizeof(struct sockaddr_in);
+
+    bench_listeners[i] = socket(AF_INET, SOCK_STREAM, 0);
+    memset(&bench_addrs[i], 0, sizeof(struct sockaddr_in));
+    bench_addrs[i].sin_family = AF_INET;
+    bench_addrs[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if ((bench_listeners[i] < 0) ||
+        (bind(bench_listeners[i], (struct sockaddr *)&bench_addrs[i], sizeof(struct sockaddr_in)) != 0) ||
+        (listen(bench_listeners[i], max_nodes) != 0) ||
+        (getsockname(bench_listeners[i], (struct sockaddr *)&bench_addrs[i], &len) != 0))
+      {
+      perror("can't start the hosts");
+      return(1);
+      }
+    }
+
+  for (int nodes = 16; nodes <= max_nodes; nodes *= 2)
+    {
+    double flat = bench_fence(nodes, 0);
+    double tree = bench_fence(nodes, radix);
+
+    printf("fence on %4d hosts, %lu modex bytes each: flat %8.1f ms, radix %d %8.1f ms\n",
+      nodes, (unsigned long)bench_modex_bytes, flat, radix, tree);
+    }
+
+  for (int i = 0; i < max_nodes; i++)
+    close(bench_listeners[i]);
+
+  return(0);
+  } /* END main() */
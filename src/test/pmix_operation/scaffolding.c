@@ -11,6 +11,8 @@ char         log_buffer[LOG_BUF_SIZE];
 // sensing variables
 int notified = 0;
 int killed_task = 0;
+int last_notified_op = -1;
+int fence_radix = 0;
 
 void log_event(
 
@@ -63,6 +65,15 @@ void remote_notify_pmix_operation(
 
   {
   notified++;
+  last_notified_op = pmix_op;
+  }
+
+int choose_job_radix(
+
+  int nodenum)
+
+  {
+  return(fence_radix);
   }
 
 bool am_i_mother_superior(
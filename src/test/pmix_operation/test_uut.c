@@ -4,11 +4,15 @@
 #include <check.h>
 #include <string.h>
 #include <stdio.h>
+#include <vector>
+#include <algorithm>
 
 extern char mom_alias[];
 
 extern int notified;
 extern int killed_task;
+extern int last_notified_op;
+extern int fence_radix;
 
 job *get_initialized_job()
   {
@@ -141,6 +145,7 @@ START_TEST(fence_test)
   procs[1].rank = 13;
   procs[2].rank = 17;
 
+  sprintf(mom_alias, "napali");
   pmix_operation fence(pjob, procs, 3, "", NULL, NULL);
   fail_unless(fence.get_type() == FENCE_OPERATION);
   fail_unless(fence.mark_reported("napali") == false);
@@ -151,6 +156,244 @@ START_TEST(fence_test)
 END_TEST
 
 
+job *get_tree_job(
+
+  int nodes)
+
+  {
+  job *pjob = (job *)calloc(1, sizeof(job));
+
+  strcpy(pjob->ji_qs.ji_jobid, "3.napali");
+  pjob->ji_numnodes = nodes;
+  pjob->ji_numvnod = nodes;
+  pjob->ji_hosts = (hnodent *)calloc(nodes, sizeof(hnodent));
+  pjob->ji_vnods = (vnodent *)calloc(nodes, sizeof(vnodent));
+
+  for (int i = 0; i < nodes; i++)
+    {
+    char name[16];
+
+    sprintf(name, "host%d", i);
+    pjob->ji_hosts[i].hn_node = i;
+    pjob->ji_hosts[i].hn_host = strdup(name);
+    pjob->ji_vnods[i].vn_host = pjob->ji_hosts + i;
+    pjob->ji_vnods[i].vn_node = i;
+    }
+
+  return(pjob);
+  }
+
+
+START_TEST(fence_tree_layout_test)
+  {
+  std::vector<int> kids;
+
+  fail_unless(fence_tree_parent(0, 4) == -1);
+  fail_unless(fence_tree_parent(1, 4) == 0);
+  fail_unless(fence_tree_parent(4, 4) == 0);
+  fail_unless(fence_tree_parent(5, 4) == 1);
+  fail_unless(fence_tree_parent(20, 4) == 4);
+  fail_unless(fence_tree_parent(20, 0) == 0);
+
+  fence_tree_children(1, 20, 4, kids);
+  fail_unless(kids.size() == 4);
+  fail_unless(kids[0] == 5);
+  fail_unless(kids[3] == 8);
+
+  // the last parent only gets what's left
+  fence_tree_children(4, 20, 4, kids);
+  fail_unless(kids.size() == 3);
+  fail_unless(kids[2] == 19);
+
+  fence_tree_children(5, 20, 4, kids);
+  fail_unless(kids.size() == 0);
+
+  fence_tree_children(0, 20, 0, kids);
+  fail_unless(kids.size() == 19);
+  fence_tree_children(3, 20, 0, kids);
+  fail_unless(kids.size() == 0);
+
+  // every host is somebody's child exactly once
+  for (int radix = 0; radix < 6; radix++)
+    {
+    std::vector<int> parents(50, -2);
+
+    for (int i = 0; i < 50; i++)
+      {
+      fence_tree_children(i, 50, radix, kids);
+
+      for (size_t k = 0; k < kids.size(); k++)
+        {
+        fail_unless(parents[kids[k]] == -2);
+        parents[kids[k]] = i;
+        }
+      }
+
+    for (int i = 1; i < 50; i++)
+      fail_unless(parents[i] == fence_tree_parent(i, radix), "radix %d host %d", radix, i);
+    }
+  }
+END_TEST
+
+
+START_TEST(fence_tree_test)
+  {
+  job         *pjob = get_tree_job(7);
+  pmix_proc_t  all;
+
+  all.rank = PMIX_RANK_WILDCARD;
+  fence_radix = 2;
+
+  // host1 waits for host3 and host4 and then reports to host0
+  sprintf(mom_alias, "host1");
+
+  pmix_operation early;
+  fail_unless(early.has_joined() == false);
+  early.add_data("three");
+  fail_unless(early.mark_reported("host3") == false);
+
+  pmix_operation fence(pjob, &all, 1, "one", NULL, NULL);
+  fail_unless(fence.has_joined() == true);
+  fail_unless(fence.get_parent() == "host0");
+  fail_unless(fence.get_children().size() == 2);
+  fail_unless(fence.get_children().find("host3") != fence.get_children().end());
+  fail_unless(fence.get_children().find("host4") != fence.get_children().end());
+
+  fence.absorb(early);
+  fail_unless(fence.get_data() == "onethree");
+  fail_unless(fence.mark_reported("host5") == false);
+  fail_unless(fence.mark_reported("host4") == false);
+  fence.add_data("four");
+  fail_unless(fence.mark_reported("host1") == true);
+  fail_unless(fence.get_data() == "onethreefour");
+
+  // the root only sends the result to its own children
+  sprintf(mom_alias, "host0");
+  pmix_operation root(pjob, &all, 1, "zero", NULL, NULL);
+  fail_unless(root.get_parent().size() == 0);
+  fail_unless(root.get_children().size() == 2);
+
+  notified = 0;
+  fail_unless(root.complete_operation(pjob, 0) == PMIX_SUCCESS);
+  fail_unless(notified == 2);
+  fail_unless(last_notified_op == IM_FENCE_RELEASE);
+
+  // a flat fence hangs everyone off the first host
+  fence_radix = 0;
+  pmix_operation flat(pjob, &all, 1, "zero", NULL, NULL);
+  fail_unless(flat.get_children().size() == 6);
+
+  sprintf(mom_alias, "host6");
+  pmix_operation leaf(pjob, &all, 1, "six", NULL, NULL);
+  fail_unless(leaf.get_parent() == "host0");
+  fail_unless(leaf.get_children().size() == 0);
+  fail_unless(leaf.mark_reported("host6") == true);
+  }
+END_TEST
+
+
+/*
+ * The time a fence takes when every fence message sent or received costs
+ * FENCE_MSG_COST, on the tree fence_tree_parent() and fence_tree_children()
+ * lay out. Each host takes its children's data in the order it arrives,
+ * passes its subtree's data up to its parent, and once the root has
+ * everything the data is passed down to the children one after another.
+ */
+
+#define FENCE_MSG_COST  1  /* encoding or decoding one fence message */
+
+int fence_gather(
+
+  int  me,
+  int  nodes,
+  int  radix,
+  int &gathered)
+
+  {
+  std::vector<int> kids;
+  std::vector<int> arrivals;
+  int              done = 0;
+
+  gathered = 1;
+  fence_tree_children(me, nodes, radix, kids);
+
+  for (size_t i = 0; i < kids.size(); i++)
+    {
+    int below;
+
+    fail_unless(fence_tree_parent(kids[i], radix) == me);
+
+    /* the child sends once it has its own subtree's data */
+    arrivals.push_back(fence_gather(kids[i], nodes, radix, below) + FENCE_MSG_COST);
+    gathered += below;
+    }
+
+  std::sort(arrivals.begin(), arrivals.end());
+
+  for (size_t i = 0; i < arrivals.size(); i++)
+    done = std::max(done, arrivals[i]) + FENCE_MSG_COST;
+
+  return(done);
+  } /* END fence_gather() */
+
+int fence_release(
+
+  int me,
+  int nodes,
+  int radix,
+  int start)
+
+  {
+  std::vector<int> kids;
+  int              sent = start;
+  int              slowest = start;
+
+  fence_tree_children(me, nodes, radix, kids);
+
+  for (size_t i = 0; i < kids.size(); i++)
+    {
+    sent += FENCE_MSG_COST;
+    slowest = std::max(slowest, fence_release(kids[i], nodes, radix, sent + FENCE_MSG_COST));
+    }
+
+  return(slowest);
+  } /* END fence_release() */
+
+int fence_cost(
+
+  int nodes,
+  int radix)
+
+  {
+  int gathered;
+  int done = fence_gather(0, nodes, radix, gathered);
+
+  /* the root ends up with every host's data */
+  fail_unless(gathered == nodes, "%d of %d hosts", gathered, nodes);
+
+  return(fence_release(0, nodes, radix, done));
+  } /* END fence_cost() */
+
+START_TEST(test_fence_cost)
+  {
+  int radix = 4;
+
+  /* host1 sends, host0 receives, then the same on the way back */
+  fail_unless(fence_cost(2, 0) == 4 * FENCE_MSG_COST);
+  fail_unless(fence_cost(2, radix) == 4 * FENCE_MSG_COST);
+
+  /* the root of a flat fence handles two messages per host */
+  fail_unless(fence_cost(16, 0) == (15 + 1) + 15 + 1);
+
+  for (int nodes = 16; nodes <= 2048; nodes += 16)
+    fail_unless(fence_cost(nodes, radix) < fence_cost(nodes, 0), "%d nodes", nodes);
+
+  /* the messages the root handles dominate flat fences of large jobs */
+  fail_unless(fence_cost(256, radix) < fence_cost(256, 0) / 4);
+  }
+END_TEST
+
+
 Suite *pmix_operation_suite(void)
   {
   Suite *s = suite_create("pmix_operation_suite methods");
@@ -160,6 +403,12 @@ Suite *pmix_operation_suite(void)
 
   tc_core = tcase_create("fence_test");
   tcase_add_test(tc_core, fence_test);
+  tcase_add_test(tc_core, fence_tree_layout_test);
+  tcase_add_test(tc_core, fence_tree_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_fence_cost");
+  tcase_add_test(tc_core, test_fence_cost);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <grp.h>
@@ -11,6 +12,7 @@
 #include "req.hpp"
 #include "complete_req.hpp"
 #include "pbs_ifl.h"
+#include "pbs_error.h"
 
 #include "utils.h"
 #include "log.h"
@@ -86,8 +88,7 @@ int parse_destination_id(char *destination_in, char **queue_name_out, char **ser
 
 int check_job_name(char *name, int chk_alpha)
   {
-  fprintf(stderr, "The call to check_job_name to be mocked!!\n");
-  exit(1);
+  return(0);
   }
 
 int hash_add_hash(job_data_container *dest, job_data_container *src, int overwrite_existing)
@@ -247,6 +248,13 @@ void set_env_opts(job_data_container *env_attr, char **envp)
   exit(1);
   }
 
+int         connects = 0;
+int         submitjob_calls = 0;
+int         submitjob_rc = PBSE_NONE;
+int         submit_socket = -1;
+int         statserver_calls = 0;
+const char *combined_submit = NULL;
+
 extern "C"
 {
 char *pbs_strerror(int err)
@@ -269,14 +277,39 @@ int get_fullhostname( char *shortname,  char *namebuf,  int bufsize,  char *EMsg
 
 int pbs_disconnect(int connect)
   {
-  fprintf(stderr, "The call to pbs_disconnect to be mocked!!\n");
-  exit(1);
+  return(0);
   }
 
 int cnt2server(const char *SpecServer)
   {
-  fprintf(stderr, "The call to cnt2server to be mocked!!\n");
-  exit(1);
+  connects++;
+  return(connects + 1);
+  }
+
+struct batch_status *pbs_statserver(int connect, struct attrl *attrib, char *extend)
+  {
+  struct batch_status *status;
+
+  statserver_calls++;
+
+  // an older server rejects the unknown attribute
+  if (combined_submit == NULL)
+    return(NULL);
+
+  status = (struct batch_status *)calloc(1, sizeof(struct batch_status));
+  status->attribs = (struct attrl *)calloc(1, sizeof(struct attrl));
+  status->attribs->name = strdup(attrib->name);
+  status->attribs->value = strdup(combined_submit);
+
+  return(status);
+  }
+
+void pbs_statfree(struct batch_status *stat)
+  {
+  free(stat->attribs->name);
+  free(stat->attribs->value);
+  free(stat->attribs);
+  free(stat);
   }
 }
 
@@ -292,8 +325,30 @@ int pbs_submit_hash(
   char               **msg)
 
   {
-  fprintf(stderr, "The call to pbs_submit_hash to be mocked!!\n");
-  exit(1);
+  submit_socket = socket;
+  *return_jobid = strdup("1.napali");
+  return(PBSE_NONE);
+  }
+
+int pbs_submitjob_hash(
+
+  int                 socket,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char               *script,
+  char               *destination,
+  char               *extend,  /* (optional) */
+  char               **return_jobid,
+  char               **msg)
+
+  {
+  submitjob_calls++;
+  submit_socket = socket;
+
+  if (submitjob_rc == PBSE_NONE)
+    *return_jobid = strdup("1.napali");
+
+  return(submitjob_rc);
   }
 
 int hash_count(job_data_container *head)
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <string>
 #include <vector>
@@ -14,6 +15,8 @@ void validate_basic_resourcing(job_info *ji);
 bool is_resource_request_valid(job_info *ji, std::string &err_msg);
 void add_new_request_if_present(job_info *ji);
 bool retry_submit_error(int error);
+int  parse_bulk_spec(const char *line, job_info *spec);
+int  submit_job(int *sock_num, job_data_container *job_attr, job_data_container *res_attr, char *script, char *destination, char **job_id, char **errmsg);
 int  process_opt_d(job_info *ji, const char *cmd_arg, int data_type, job_data *tmp_job_info);
 int  process_opt_j(job_info *ji, const char *cmd_arg, int data_type);
 int  process_opt_k(job_info *ji, const char *cmd_arg, int data_type);
@@ -22,6 +25,12 @@ int  process_opt_m(job_info *ji, const char *cmd_arg, int data_type);
 int  process_opt_p(job_info *ji, const char *cmd_arg, int data_type);
 
 extern complete_req cr;
+extern int          connects;
+extern int          submitjob_calls;
+extern int          submitjob_rc;
+extern int          submit_socket;
+extern int          statserver_calls;
+extern const char  *combined_submit;
 extern bool         submission_string_fail;
 extern bool         added_req;
 extern bool         find_nodes;
@@ -149,6 +158,97 @@ START_TEST(test_retry_submit_error)
 END_TEST
 
 
+START_TEST(test_submit_job)
+  {
+  int   sock = 1;
+  char *job_id = NULL;
+  char *errmsg = NULL;
+
+  // the server reports that it accepts SubmitJob
+  combined_submit = "True";
+  submitjob_rc = PBSE_NONE;
+  fail_unless(submit_job(&sock, NULL, NULL, NULL, NULL, &job_id, &errmsg) == PBSE_NONE);
+  fail_unless(statserver_calls == 1);
+  fail_unless(submitjob_calls == 1);
+  fail_unless(!strcmp(job_id, "1.napali"));
+  free(job_id);
+  job_id = NULL;
+
+  // the server is only asked once, and errors are returned rather than retried
+  submitjob_rc = PBSE_EOF;
+  fail_unless(submit_job(&sock, NULL, NULL, NULL, NULL, &job_id, &errmsg) == PBSE_EOF);
+  fail_unless(statserver_calls == 1);
+  fail_unless(submitjob_calls == 2);
+  fail_unless(connects == 0);
+  fail_unless(sock == 1);
+  }
+END_TEST
+
+
+START_TEST(test_submit_job_older_server)
+  {
+  int   sock = 1;
+  char *job_id = NULL;
+  char *errmsg = NULL;
+
+  // a server from before SubmitJob doesn't know combined_submit
+  combined_submit = NULL;
+  fail_unless(submit_job(&sock, NULL, NULL, NULL, NULL, &job_id, &errmsg) == PBSE_NONE);
+  fail_unless(statserver_calls == 1);
+  fail_unless(submitjob_calls == 0);
+  fail_unless(submit_socket == 1);
+  fail_unless(!strcmp(job_id, "1.napali"));
+  free(job_id);
+  job_id = NULL;
+
+  fail_unless(submit_job(&sock, NULL, NULL, NULL, NULL, &job_id, &errmsg) == PBSE_NONE);
+  fail_unless(statserver_calls == 1);
+  fail_unless(submitjob_calls == 0);
+  free(job_id);
+  }
+END_TEST
+
+
+START_TEST(test_submit_job_not_accepted)
+  {
+  int   sock = 1;
+  char *job_id = NULL;
+  char *errmsg = NULL;
+
+  // anything but true means the old sequence
+  combined_submit = "False";
+  fail_unless(submit_job(&sock, NULL, NULL, NULL, NULL, &job_id, &errmsg) == PBSE_NONE);
+  fail_unless(statserver_calls == 1);
+  fail_unless(submitjob_calls == 0);
+  free(job_id);
+  }
+END_TEST
+
+
+START_TEST(test_parse_bulk_spec)
+  {
+  job_info spec;
+
+  fail_unless(parse_bulk_spec("-N job1", &spec) == PBSE_NONE);
+  fail_unless(added_name == ATTR_N);
+  fail_unless(added_value == "job1");
+
+  fail_unless(parse_bulk_spec("-N job2 -l walltime=10:00,nodes=2", &spec) == PBSE_NONE);
+  fail_unless(added_name == "nodes");
+  fail_unless(added_value == "2");
+
+  fail_unless(parse_bulk_spec("-v \"INPUT=a b\"", &spec) == PBSE_NONE);
+  fail_unless(added_name == ATTR_v);
+  fail_unless(added_value == "INPUT=a b");
+
+  fail_unless(parse_bulk_spec("-N", &spec) == PBSE_IVALREQ);
+  fail_unless(parse_bulk_spec("-q batch", &spec) == PBSE_IVALREQ);
+  fail_unless(parse_bulk_spec("-l walltime", &spec) == PBSE_IVALREQ);
+  fail_unless(parse_bulk_spec("job3", &spec) == PBSE_IVALREQ);
+  }
+END_TEST
+
+
 START_TEST(test_process_opt_d)
   {
   job_info    ji;
@@ -390,6 +490,10 @@ Suite *qsub_functions_suite(void)
   tcase_add_test(tc_core, test_process_opt_m);
   tcase_add_test(tc_core, test_process_opt_p);
   tcase_add_test(tc_core, test_retry_submit_error);
+  tcase_add_test(tc_core, test_submit_job);
+  tcase_add_test(tc_core, test_submit_job_older_server);
+  tcase_add_test(tc_core, test_submit_job_not_accepted);
+  tcase_add_test(tc_core, test_parse_bulk_spec);
   suite_add_tcase(s, tc_core);
 
   tc_core = tcase_create("test isWindowsFormat");
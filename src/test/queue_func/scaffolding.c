@@ -66,3 +66,5 @@ void free_user_info_holder(user_info_holder *uih) {}
 void log_err(int errnum, const char *routine, const char *text) {}
 void log_record(int eventtype, int objclass, const char *objname, const char *text) {}
 void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
+
+job_rank_index::job_rank_index() {}
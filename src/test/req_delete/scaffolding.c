@@ -14,6 +14,7 @@
 #include "node_func.h" /* node_info */
 #include "threadpool.h"
 #include "delete_all_tracker.hpp"
+#include "event_trace.h"
 
 int lock_ji_mutex(job *pjob, const char *id, const char *msg, int logging);
 int unlock_ji_mutex(job *pjob, const char *id, const char *msg, int logging);
@@ -36,6 +37,8 @@ int  signal_issued;
 int  nanny = 1;
 bool  br_freed;
 int  alloc_work = 1;
+bool text_replied;
+int  progress_updates;
 int  depend_term_called;
 
 batch_request *alloc_br(int type)
@@ -106,6 +109,11 @@ pbs_queue *get_jobs_queue(job **pjob)
 
 void reply_ack(struct batch_request *preq) {}
 
+void reply_text(struct batch_request *preq, int code, const char *text)
+  {
+  text_replied = true;
+  }
+
 void free_nodes(job *pjob, const char *spec) 
   {
   pjob->ji_wattr[JOB_ATR_exec_host].at_val.at_str = NULL;
@@ -526,6 +534,21 @@ bool delete_all_tracker::start_deleting_all_if_possible(const char *username, in
   return(true);
   }
 
+void delete_all_tracker::update_progress(const char *user, int perm, int handled, int total)
+  {
+  progress_updates++;
+  }
+
+bool delete_all_tracker::get_progress(const char *user, int perm, int &handled, int &total)
+  {
+  return(false);
+  }
+
+char *parse_servername(const char *name, unsigned int *service)
+  {
+  return(strdup("napali"));
+  }
+
 int get_fullhostname(
 
   char *shortname,  /* I */
@@ -596,3 +619,10 @@ void job_array::update_array_values(
 void job_array::mark_deleted() {}
 
 
+
+void trace_event(int event, const char *job_id, uint64_t duration, int value) {}
+
+uint64_t trace_elapsed(time_t since)
+  {
+  return(0);
+  }
@@ -38,6 +38,8 @@ extern int bad_relay;
 extern int signal_issued;
 extern int nanny;
 extern bool br_freed;
+extern bool text_replied;
+extern int  progress_updates;
 extern int alloc_work;
 struct server server;
 extern const char *delpurgestr;
@@ -196,6 +198,40 @@ START_TEST(test_delete_all_work)
   }
 END_TEST
 
+START_TEST(test_delete_all_partition_work)
+  {
+  delete_all_state     *das = new delete_all_state();
+  delete_all_partition *dap = new delete_all_partition();
+  batch_request        *preq = (batch_request *)calloc(1, sizeof(batch_request));
+
+  pthread_mutex_init(&das->das_mutex, NULL);
+  das->das_preq = preq;
+  das->das_total = 2;
+  das->das_handled = 0;
+  das->das_failed = 0;
+  // another partition is still running
+  das->das_partitions = 2;
+
+  dap->dap_state = das;
+  dap->dap_jobs.push_back("2.napali");
+  dap->dap_jobs.push_back("3.napali");
+
+  text_replied = false;
+  delete_all_partition_work(dap);
+  fail_unless(text_replied == false);
+  fail_unless(das->das_handled == 2);
+  fail_unless(das->das_failed == 0);
+  fail_unless(das->das_partitions == 1);
+
+  // the last partition answers the client
+  dap = new delete_all_partition();
+  dap->dap_state = das;
+  dap->dap_jobs.push_back("4.napali");
+  delete_all_partition_work(dap);
+  fail_unless(text_replied == true);
+  }
+END_TEST
+
 START_TEST(test_post_job_delete_nanny)
   {
   batch_request *preq_sig;
@@ -418,6 +454,7 @@ Suite *req_delete_suite(void)
   tc_core = tcase_create("more");
   tcase_add_test(tc_core, test_duplicate_request);
   tcase_add_test(tc_core, test_handle_delete_all);
+  tcase_add_test(tc_core, test_delete_all_partition_work);
   tcase_add_test(tc_core, test_handle_single_delete);
   suite_add_tcase(s, tc_core);
 
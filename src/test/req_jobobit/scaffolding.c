@@ -21,8 +21,12 @@
 #include "queue.h" /* pbs_queue */
 #include "id_map.hpp"
 #include "completed_jobs_map.h"
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 #include "resource.h"
 #include "track_alps_reservations.hpp"
+#include "sched_event_tracker.hpp"
+#include "event_trace.h"
 
 
 bool cray_enabled;
@@ -64,6 +68,7 @@ bool completed = false;
 bool exited = false;
 long disable_requeue = 0;
 completed_jobs_map_class completed_jobs_map;
+completed_job_store completed_store;
 
 
 struct batch_request *alloc_br(int type)
@@ -78,6 +83,17 @@ struct batch_request *alloc_br(int type)
   return(preq);
   }
 
+void reply_ack(batch_request *preq) {}
+
+void req_reject(int code, int aux, batch_request *preq, const char *HostName, const char *Msg) {}
+
+std::string last_reply_text;
+
+void reply_text(batch_request *preq, int code, const char *text)
+  {
+  last_reply_text = text;
+  }
+
 char *parse_servername(const char *name, unsigned int *service)
   {
   return(strdup(name));
@@ -362,6 +378,24 @@ completed_jobs_map_class::completed_jobs_map_class() {}
 completed_jobs_map_class::~completed_jobs_map_class() {}
 int completed_jobs_map_class::cleanup_completed_jobs() {return 0;}
 bool completed_jobs_map_class::add_job(char const *s, time_t t) {return true;}
+completed_job_store::completed_job_store() {}
+completed_job_store::~completed_job_store() {}
+int completed_job_store::cleanup_expired(time_t now) {return 0;}
+
+job_history job_hist;
+job_history::job_history() {}
+job_history::~job_history() {}
+int job_history::expire(time_t now, long keep_days) {return 0;}
+
+int record_job_history(job *pjob)
+  {
+  return(0);
+  }
+
+int compact_completed_job(job *pjob, time_t expires)
+  {
+  return(0);
+  }
 
 int attr_to_str(
 
@@ -516,3 +550,19 @@ void job_array::update_array_values(
   {
   }
 
+
+void notify_scheduler(int event)
+  {
+  if (event == SCHED_EVENT_JOB_FINISHED)
+    {
+    svr_do_schedule = SCH_SCHEDULE_TERM;
+    listener_command = SCH_SCHEDULE_TERM;
+    }
+  }
+
+void trace_event(int event, const char *job_id, uint64_t duration, int value) {}
+
+uint64_t trace_elapsed(time_t since)
+  {
+  return(0);
+  }
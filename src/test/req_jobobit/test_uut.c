@@ -58,6 +58,7 @@ extern bool completed;
 extern bool exited;
 extern bool purged;
 extern long disable_requeue;
+extern std::string last_reply_text;
 extern int  attr_count;
 extern int  next_count;
 extern int  called_account_jobend;
@@ -680,6 +681,38 @@ END_TEST
 
 
 
+START_TEST(req_jobobit_batch_test)
+  {
+  batch_request *preq = (batch_request *)calloc(1, sizeof(batch_request));
+  char           expected[256];
+  struct rq_jobobit_batch *pbatch = &preq->rq_ind.rq_jobobit_batch;
+
+  strcpy(preq->rq_host, "napali");
+  pbatch->rq_count = 2;
+  pbatch->rq_obits = (struct rq_jobobit *)calloc(2, sizeof(struct rq_jobobit));
+  strcpy(pbatch->rq_obits[0].rq_jid, "1.napali");
+  strcpy(pbatch->rq_obits[1].rq_jid, "2.napali");
+  CLEAR_HEAD(pbatch->rq_obits[0].rq_attr);
+  CLEAR_HEAD(pbatch->rq_obits[1].rq_attr);
+
+  // each obit gets its own code, in request order
+  bad_job = 1;
+  fail_unless(req_jobobit_batch(preq) == PBSE_NONE);
+  snprintf(expected, sizeof(expected), "1.napali %d\n2.napali %d\n", PBSE_UNKJOBID, PBSE_UNKJOBID);
+  fail_unless(last_reply_text == expected, "%s", last_reply_text.c_str());
+
+  alloc_br_null = 1;
+  fail_unless(req_jobobit_batch(preq) == PBSE_NONE);
+  snprintf(expected, sizeof(expected), "1.napali %d\n2.napali %d\n", PBSE_SYSTEM, PBSE_SYSTEM);
+  fail_unless(last_reply_text == expected, "%s", last_reply_text.c_str());
+  alloc_br_null = 0;
+  bad_job = 0;
+  }
+END_TEST
+
+
+
+
 Suite *req_jobobit_suite(void)
   {
   Suite *s = suite_create("req_jobobit_suite methods");
@@ -707,6 +740,7 @@ Suite *req_jobobit_suite(void)
   tcase_add_test(tc_core, handle_stagedel_test);
   tcase_add_test(tc_core, get_used_test);
   tcase_add_test(tc_core, set_job_comment_test);
+  tcase_add_test(tc_core, req_jobobit_batch_test);
   suite_add_tcase(s, tc_core);
 
   return(s);
@@ -16,6 +16,9 @@
 #include "work_task.h" /* work_type */
 #include "mom_hierarchy_handler.h"
 #include "acl_special.hpp"
+#include "event_trace.h"
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 
 
 all_nodes allnodes;
@@ -30,6 +33,8 @@ const char *msg_man_set = "attributes set: ";
 const char *msg_manager = "%s at request of %s@%s";
 const char *msg_man_uns = "attributes unset: ";
 char server_name[PBS_MAXSERVERNAME + 1];
+char *path_log;
+char *path_priv;
 resource_def *svr_resc_def;
 attribute_def que_attr_def[10];
 attribute_def node_attr_def[2];
@@ -512,3 +517,34 @@ acl_special::acl_special() {}
 
 acl_special limited_acls;
 
+
+int trace_open(const char *directory, int source)
+  {
+  return(0);
+  }
+
+void trace_close(void) {}
+
+void acct_usage_enable(bool enable) {}
+
+completed_job_store completed_store;
+
+completed_job_store::completed_job_store() {}
+completed_job_store::~completed_job_store() {}
+
+int completed_job_store::set_spill_file(const char *path)
+  {
+  return(0);
+  }
+
+job_history job_hist;
+
+job_history::job_history() {}
+job_history::~job_history() {}
+
+int job_history::open_history(const char *dir)
+  {
+  return(0);
+  }
+
+void job_history::close_history() {}
@@ -109,3 +109,8 @@ bool have_reservation(job *pjob, struct pbs_queue *pque)
   }
 
 
+bool job_rank_index::change_rank(const std::string &job_id, long rank)
+  {
+  return(true);
+  }
+
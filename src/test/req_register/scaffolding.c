@@ -11,6 +11,7 @@
 #include "array.h" /* job_array */
 #include "work_task.h" /* work_task */
 #include "queue.h"
+#include "dependency_graph.hpp"
 
 const int DEFAULT_IDLE_SLOT_LIMIT = 300;
 const char *msg_illregister = "Illegal op in register request received for job %s";
@@ -391,8 +392,32 @@ array_info::array_info() : struct_version(ARRAY_QS_STRUCT_VERSION), array_size(0
   {
   }
 
-job_array::job_array() : job_ids(NULL), jobs_recovered(0), ai_ghost_recovered(false), uncreated_ids(),
+job_array::job_array() : job_ids(), jobs_recovered(0), ai_ghost_recovered(false), uncreated_ids(),
                          ai_mutex(NULL), ai_qs()
 
   {
   }
+
+dependency_graph::dependency_graph() {}
+
+dependency_graph::~dependency_graph() {}
+
+bool dependency_graph::add_edge(const char *parent, const char *child, int type)
+  {
+  return(false);
+  }
+
+bool dependency_graph::remove_edge(const char *parent, const char *child)
+  {
+  return(false);
+  }
+
+bool dependency_graph::has_edge(const char *parent, const char *child)
+  {
+  return(false);
+  }
+
+int dependency_graph::satisfy_edge(const char *parent, const char *child)
+  {
+  return(-1);
+  }
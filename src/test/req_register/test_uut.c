@@ -39,6 +39,7 @@ int req_register(batch_request *preq);
 bool remove_array_dependency_job_from_job(struct array_depend *pdep, job *pjob, char *job_array_id);
 void removeAfterAnyDependency(const char *pJobID, const char *targetJob);
 bool job_ids_match(const char *parent, const char *child);
+int release_local_dependents(job *pjob, std::vector<local_depend_op> &ops);
 
 
 extern char server_name[];
@@ -724,6 +725,61 @@ END_TEST
 
 extern job *pGlobalJob;
 
+START_TEST(release_local_dependents_test)
+  {
+  job                          *parent = job_alloc();
+  job                          *dependent = job_alloc();
+  pbs_attribute                *pattr;
+  struct depend                *pdep;
+  std::vector<local_depend_op>  ops;
+  local_depend_op               op;
+
+  strcpy(parent->ji_qs.ji_jobid, job1);
+  strcpy(dependent->ji_qs.ji_jobid, "4.napali");
+
+  // 4.napali is held until 1.napali completes successfully
+  pattr = &dependent->ji_wattr[JOB_ATR_depend];
+  initialize_depend_attr(pattr);
+  pdep = make_depend(JOB_DEPEND_TYPE_AFTEROK, pattr);
+  make_dependjob(pdep, job1);
+  dependent->ji_qs.ji_state = JOB_STATE_HELD;
+  dependent->ji_qs.ji_substate = JOB_SUBSTATE_DEPNHOLD;
+  dependent->ji_wattr[JOB_ATR_hold].at_val.at_long = HOLD_s;
+  dependent->ji_wattr[JOB_ATR_hold].at_flags = ATR_VFLAG_SET;
+
+  pGlobalJob = dependent;
+
+  // a dependent which is already gone is skipped
+  op.ldo_job = "9.napali";
+  op.ldo_type = JOB_DEPEND_TYPE_BEFOREOK;
+  op.ldo_op = JOB_DEPEND_OP_RELEASE;
+  ops.push_back(op);
+
+  op.ldo_job = "4.napali";
+  ops.push_back(op);
+
+  fail_unless(release_local_dependents(parent, ops) == PBSE_NONE);
+  fail_unless(find_depend(JOB_DEPEND_TYPE_AFTEROK, pattr) == NULL);
+  fail_unless((dependent->ji_wattr[JOB_ATR_hold].at_val.at_long & HOLD_s) == 0);
+  fail_unless(dependent->ji_qs.ji_substate != JOB_SUBSTATE_DEPNHOLD);
+
+  // releasing it a second time finds nothing left to release and changes nothing
+  ops.clear();
+  ops.push_back(op);
+  fail_unless(release_local_dependents(parent, ops) == PBSE_NONE);
+  fail_unless(find_depend(JOB_DEPEND_TYPE_AFTEROK, pattr) == NULL);
+
+  // a queued dependent whose dependency can no longer be met is deleted
+  op.ldo_op = JOB_DEPEND_OP_DELETE;
+  ops.clear();
+  ops.push_back(op);
+  dependent->ji_qs.ji_state = JOB_STATE_QUEUED;
+  fail_unless(release_local_dependents(parent, ops) == PBSE_NONE);
+
+  pGlobalJob = NULL;
+  }
+END_TEST
+
 START_TEST(remove_after_any_test)
   {
   job *pJob = job_alloc();
@@ -824,6 +880,7 @@ Suite *req_register_suite(void)
   tcase_add_test(tc_core, set_depend_hold_test);
   tcase_add_test(tc_core, delete_dependency_job_test);
   tcase_add_test(tc_core, remove_after_any_test);
+  tcase_add_test(tc_core, release_local_dependents_test);
   tcase_add_test(tc_core, req_register_test);
   tcase_add_test(tc_core, set_array_depend_holds_test);
   tcase_add_test(tc_core, remove_array_dependency_from_job_test);
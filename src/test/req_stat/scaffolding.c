@@ -14,6 +14,8 @@
 #include "work_task.h" /* work_task, work_type */
 #include "u_tree.h" /* AvlTree */
 #include "queue.h"
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 
 all_nodes allnodes;
 pthread_mutex_t *netrates_mutex = NULL;
@@ -74,8 +76,7 @@ int status_nodeattrib(svrattrl *pal, attribute_def *padef, struct pbsnode *pnode
 
 int reply_send_svr(struct batch_request *request)
   {
-  fprintf(stderr, "The call to reply_send_svr to be mocked!!\n");
-  exit(1);
+  return(0);
   }
 
 void free_br(struct batch_request *preq)
@@ -168,8 +169,7 @@ int job_abt(struct job **pjobp, const char *text, bool b=false)
 
 void *get_next(list_link pl, char *file, int line)
   {
-  fprintf(stderr, "The call to get_next to be mocked!!\n");
-  exit(1);
+  return(pl.ll_next->ll_struct);
   }
 
 int issue_Drequest(int conn, struct batch_request *request, bool close_handle)
@@ -338,6 +338,12 @@ int lock_ai_mutex(job_array *pa, const char *id, const char *msg, int logging)
   return(0);
   }
 
+job_array::job_array() {}
+job_array::~job_array() {}
+
+array_info::array_info() {}
+array_info::~array_info() {}
+
 void log_err(int errnum, const char *routine, const char *text) {}
 void log_record(int eventtype, int objclass, const char *objname, const char *text) {}
 void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
@@ -368,3 +374,53 @@ bool pbsnode::hasprop(std::vector<prop> *needed) const
   {
   preply->brp_choice = type;
   }
+
+bool index_ranges::empty() const
+  {
+  return(true);
+  }
+
+size_t index_ranges::range_count() const
+  {
+  return(0);
+  }
+
+void index_ranges::get_range(size_t i, int &first, int &last) const {}
+
+completed_job_store completed_store;
+
+completed_job_store::completed_job_store() {}
+completed_job_store::~completed_job_store() {}
+
+bool completed_job_store::has_job(const char *job_id)
+  {
+  return(false);
+  }
+
+int status_completed_job(const char *job_id, batch_request *preq, svrattrl *pal, tlist_head *pstathd, bool condensed, int *bad)
+  {
+  return(PBSE_UNKJOBID);
+  }
+
+int status_completed_jobs(const char *queue, batch_request *preq, svrattrl *pal, tlist_head *pstathd, bool condensed, int *bad)
+  {
+  return(PBSE_NONE);
+  }
+
+job_history job_hist;
+bool history_open = false;
+
+job_history::job_history() {}
+job_history::~job_history() {}
+
+bool job_history::is_open()
+  {
+  return(history_open);
+  }
+
+void job_history::find_jobs(const char *user, const char *queue, time_t since, time_t until, std::vector<std::string> &ids) {}
+
+int status_history_job(const char *job_id, batch_request *preq, svrattrl *pal, tlist_head *pstathd, int *bad)
+  {
+  return(PBSE_UNKJOBID);
+  }
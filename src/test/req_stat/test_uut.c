@@ -8,7 +8,9 @@
 
 bool in_execution_queue(job *pjob, job_array *pa);
 job *get_next_status_job(struct stat_cntl *cntl, int &job_array_index, job_array *pa, all_jobs_iterator *iter);
+int  req_stat_history(struct batch_request *preq);
 extern int abort_called;
+extern bool history_open;
 
 enum TJobStatTypeEnum
   {
@@ -67,11 +69,10 @@ START_TEST(test_get_next_status_job)
   int              array_index = -1;
   pbs_queue        pque;
 
-  job_array *pa = (job_array *)calloc(1, sizeof(job_array));
+  job_array *pa = new job_array();
   pa->ai_qs.array_size = 2;
-  pa->job_ids = (char **)calloc(2, sizeof(char *));
-  pa->job_ids[0] = strdup("1[0].napali");
-  pa->job_ids[1] = strdup("1[1].napali");
+  pa->set_job_id(0, "1[0].napali");
+  pa->set_job_id(1, "1[1].napali");
 
   // next job is currently set to return NULL every time, so all of these are NULL
   cntl.sc_type = tjstQueue;
@@ -107,6 +108,28 @@ START_TEST(test_get_next_status_job)
 END_TEST
 
 
+START_TEST(test_req_stat_history)
+  {
+  batch_request preq;
+  char          extend[] = "history:user=dbeer:since=100";
+
+  memset(&preq, 0, sizeof(preq));
+  preq.rq_extend = extend;
+  CLEAR_HEAD(preq.rq_ind.rq_status.rq_attr);
+
+  // nothing to report without a history
+  history_open = false;
+  fail_unless(req_stat_history(&preq) == PBSE_NOSUP);
+
+  history_open = true;
+  fail_unless(req_stat_history(&preq) == PBSE_NONE);
+
+  strcpy(preq.rq_ind.rq_status.rq_id, "1.napali");
+  fail_unless(req_stat_history(&preq) == PBSE_UNKJOBID);
+  }
+END_TEST
+
+
 Suite *req_stat_suite(void)
   {
   Suite *s = suite_create("req_stat_suite methods");
@@ -117,6 +140,7 @@ Suite *req_stat_suite(void)
 
   tc_core = tcase_create("test_get_next_status_job");
   tcase_add_test(tc_core, test_get_next_status_job);
+  tcase_add_test(tc_core, test_req_stat_history);
   suite_add_tcase(s, tc_core);
 
   return s;
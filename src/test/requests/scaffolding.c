@@ -23,6 +23,7 @@
 #include "list_link.h" /* list_link, tlist_head */
 #include "power_state.hpp"
 #include "sys_file.hpp"
+#include "file_copy.h"
 #include "log.h"
 
 char *apbasil_protocol;
@@ -42,6 +43,12 @@ int cphosts_num = 0;
 struct var_table vtable; 
 char mom_host[PBS_MAXHOSTNAME + 1];
 int spoolasfinalname = 0;
+int copy_threads = 0;
+int copy_node_threads = 0;
+long copy_bandwidth = 0;
+long copy_node_bandwidth = 0;
+bool copy_fsync = false;
+char *mom_home = NULL;
 char *path_spool = strdup("/var/spool/torque/spool/");
 unsigned int pbs_rm_port = 0;
 unsigned int alarm_time = 10;
@@ -536,3 +543,17 @@ int send_job_obit(job *pjob, int exit_status)
   {
   return(PBSE_NONE);
   }
+
+std::string copy_target(const char *src, const char *dest)
+  {
+  return(dest);
+  }
+
+int copy_files_in_parallel(std::vector<copy_task> &tasks, copy_limits *limits, copy_stats *stats)
+  {
+  return(0);
+  }
+
+void format_copy_stats(char *buf, int size, const copy_stats *stats, int workers, double elapsed) {}
+
+void init_copy_limits(copy_limits *limits) {}
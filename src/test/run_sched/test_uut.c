@@ -3,17 +3,80 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "pbs_error.h"
+#include "sched_cmds.h"
+#include "sched_event_tracker.hpp"
+#include "run_sched.h"
+
+extern int svr_do_schedule;
+extern int listener_command;
+extern pthread_mutex_t *svr_do_schedule_mutex;
+extern pthread_mutex_t *listener_command_mutex;
+extern pthread_mutex_t *scheduler_sock_jobct_mutex;
+extern int scheduler_sock;
+extern int scheduler_jobct;
+
+void scheduler_close();
+
 START_TEST(test_one)
   {
+  svr_do_schedule_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  listener_command_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(svr_do_schedule_mutex, NULL);
+  pthread_mutex_init(listener_command_mutex, NULL);
+
+  // node down events are only recorded
+  notify_scheduler(SCHED_EVENT_NODE_DOWN);
+  fail_unless(svr_do_schedule == SCH_SCHEDULE_NULL);
+  fail_unless(sched_events.get_pending_count(SCHED_EVENT_NODE_DOWN) == 1);
+  fail_unless(sched_events.has_pending() == false);
 
+  notify_scheduler(SCHED_EVENT_JOB_QUEUED);
+  fail_unless(svr_do_schedule == SCH_SCHEDULE_NEW);
+  fail_unless(listener_command == SCH_SCHEDULE_NEW);
 
+  notify_scheduler(SCHED_EVENT_JOB_FINISHED);
+  fail_unless(svr_do_schedule == SCH_SCHEDULE_TERM);
+  fail_unless(listener_command == SCH_SCHEDULE_TERM);
+
+  notify_scheduler(SCHED_EVENT_COMMAND);
+  fail_unless(svr_do_schedule == SCH_SCHEDULE_CMD);
+
+  // the events are coalesced until the next cycle
+  fail_unless(sched_events.get_pending_count(SCHED_EVENT_JOB_QUEUED) == 1);
+  fail_unless(sched_events.get_pending_count(SCHED_EVENT_JOB_FINISHED) == 1);
+  fail_unless(sched_events.get_pending_count(SCHED_EVENT_COMMAND) == 1);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  svr_do_schedule_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  listener_command_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  scheduler_sock_jobct_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(svr_do_schedule_mutex, NULL);
+  pthread_mutex_init(listener_command_mutex, NULL);
+  pthread_mutex_init(scheduler_sock_jobct_mutex, NULL);
+
+  notify_scheduler(SCHED_EVENT_JOB_QUEUED);
+  fail_unless(sched_events.claim_cycle(time(NULL), 0) == true);
+
+  // the main loop can't start the cycle a second time
+  fail_unless(sched_events.claim_cycle(time(NULL), 0) == false);
 
+  // while the scheduler is still connected the events wait for it
+  scheduler_sock = 5;
+  fail_unless(schedule_jobs() == 1);
+  fail_unless(sched_events.cycle_in_progress() == true);
+  fail_unless(sched_events.get_pending_count(SCHED_EVENT_JOB_QUEUED) == 1);
+  fail_unless(svr_do_schedule == SCH_SCHEDULE_NEW);
+  fail_unless(sched_events.claim_cycle(time(NULL), 0) == false);
 
+  // and can start the next cycle once it has gone
+  scheduler_jobct = 0;
+  scheduler_close();
+  fail_unless(scheduler_sock == -1);
+  fail_unless(sched_events.cycle_in_progress() == false);
+  fail_unless(sched_events.claim_cycle(time(NULL), 0) == true);
   }
 END_TEST
 
@@ -0,0 +1,5 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+int    LOGLEVEL = 10;
+
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <check.h>
+
+#include "sched_event_tracker.hpp"
+
+
+START_TEST(test_coalescing)
+  {
+  sched_event_tracker set;
+  std::string         summary;
+
+  fail_unless(set.has_pending() == false);
+  fail_unless(set.cycle_due(100, 0) == false);
+
+  set.record_event(SCHED_EVENT_JOB_QUEUED);
+  set.record_event(SCHED_EVENT_JOB_QUEUED);
+  set.record_event(SCHED_EVENT_JOB_QUEUED);
+  set.record_event(SCHED_EVENT_JOB_FINISHED);
+  fail_unless(set.get_pending_count(SCHED_EVENT_JOB_QUEUED) == 3);
+  fail_unless(set.get_pending_count(SCHED_EVENT_JOB_FINISHED) == 1);
+  fail_unless(set.has_pending() == true);
+
+  set.start_cycle(100, summary);
+  fail_unless(summary == "3 job queued, 1 job finished", summary.c_str());
+  fail_unless(set.get_last_cycle() == 100);
+  fail_unless(set.has_pending() == false);
+  fail_unless(set.get_pending_count(SCHED_EVENT_JOB_QUEUED) == 0);
+
+  set.record_event(SCHED_EVENT_NODE_UP);
+  set.record_event(SCHED_EVENT_JOB_QUEUED);
+  set.start_cycle(110, summary);
+  fail_unless(summary == "1 job queued, 1 node up", summary.c_str());
+
+  // invalid events are ignored
+  set.record_event(-1);
+  set.record_event(SCHED_EVENT_TYPE_COUNT);
+  fail_unless(set.has_pending() == false);
+  fail_unless(set.get_pending_count(SCHED_EVENT_TYPE_COUNT) == 0);
+  }
+END_TEST
+
+
+START_TEST(test_cycle_due)
+  {
+  sched_event_tracker set;
+  std::string         summary;
+
+  set.start_cycle(1000, summary);
+
+  // node down events never trigger a cycle
+  set.record_event(SCHED_EVENT_NODE_DOWN);
+  fail_unless(set.has_pending() == false);
+  fail_unless(set.cycle_due(2000, 0) == false);
+
+  // non-urgent events wait for the minimum interval
+  set.record_event(SCHED_EVENT_JOB_QUEUED);
+  fail_unless(set.cycle_due(1000, 0) == true);
+  fail_unless(set.cycle_due(1005, 10) == false);
+  fail_unless(set.cycle_due(1010, 10) == true);
+
+  // urgent events don't wait
+  set.record_event(SCHED_EVENT_COMMAND);
+  fail_unless(set.cycle_due(1005, 10) == true);
+
+  set.start_cycle(1005, summary);
+  set.record_event(SCHED_EVENT_TIMER);
+  fail_unless(set.cycle_due(1006, 10) == true);
+  }
+END_TEST
+
+
+START_TEST(test_cycle_in_progress)
+  {
+  sched_event_tracker set;
+  std::string         summary;
+
+  fail_unless(set.claim_cycle(1000, 0) == false);
+
+  set.record_event(SCHED_EVENT_JOB_QUEUED);
+  fail_unless(set.claim_cycle(1000, 0) == true);
+  fail_unless(set.cycle_in_progress() == true);
+  set.start_cycle(1000, summary);
+
+  // events during the cycle wait for it to end, even urgent ones
+  set.record_event(SCHED_EVENT_COMMAND);
+  fail_unless(set.cycle_due(1000, 0) == false);
+  fail_unless(set.claim_cycle(1000, 0) == false);
+  fail_unless(set.has_pending() == true);
+
+  set.end_cycle();
+  fail_unless(set.cycle_in_progress() == false);
+  fail_unless(set.cycle_due(1000, 0) == true);
+  fail_unless(set.claim_cycle(1000, 0) == true);
+
+  // a cycle with nothing to do isn't claimed
+  set.start_cycle(1001, summary);
+  set.end_cycle();
+  fail_unless(set.claim_cycle(1001, 0) == false);
+  fail_unless(set.cycle_in_progress() == false);
+  }
+END_TEST
+
+
+Suite *sched_event_tracker_suite(void)
+  {
+  Suite *s = suite_create("sched_event_tracker test suite methods");
+  TCase *tc_core = tcase_create("test_coalescing");
+  tcase_add_test(tc_core, test_coalescing);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_cycle_due");
+  tcase_add_test(tc_core, test_cycle_due);
+  tcase_add_test(tc_core, test_cycle_in_progress);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(sched_event_tracker_suite());
+  srunner_set_log(sr, "sched_event_tracker_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -0,0 +1,222 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>
+#include "start_exec.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <vector>
+
+#include "mom_config.h"
+
+/*
+ * Launch latency against node count, flat fan-out versus the job radix
+ * tree. Not part of make check: build it with "make bench_launch" and run
+ * it as ./bench_launch [max nodes].
+ *
+ * Each sister mom is a local stand-in listening on loopback. For every join
+ * it receives it spends BENCH_JOIN_USEC setting up, passes the join on to
+ * the sisters below it the way a job radix splits them, spending
+ * BENCH_SEND_USEC per join it sends, and answers once all of them have.
+ */
+
+#define BENCH_SEND_USEC  1000  /* encoding and writing one join */
+#define BENCH_JOIN_USEC  2000  /* a sister setting up the job */
+
+std::vector<struct sockaddr_in> bench_addrs;
+int                             bench_radix;
+
+void bench_join(
+
+  const std::vector<int> &below,
+  int                     radix)
+
+  {
+  std::vector<std::vector<int> > lists;
+  std::vector<int>               socks;
+  char                           ack[3];
+
+  if (radix == 0)
+    {
+    for (size_t i = 0; i < below.size(); i++)
+      lists.push_back(std::vector<int>(1, below[i]));
+    }
+  else
+    {
+    lists.resize(radix);
+
+    for (size_t i = 0; i < below.size(); i++)
+      lists[i % radix].push_back(below[i]);
+    }
+
+  for (size_t l = 0; l < lists.size(); l++)
+    {
+    std::string msg;
+    int         sock;
+
+    if (lists[l].size() == 0)
+      continue;
+
+    usleep(BENCH_SEND_USEC);
+
+    for (size_t i = 1; i < lists[l].size(); i++)
+      {
+      char num[16];
+
+      snprintf(num, sizeof(num), "%d ", lists[l][i]);
+      msg += num;
+      }
+
+    msg += "\n";
+
+    sock = socket(AF_INET, SOCK_STREAM, 0);
+
+    if ((connect(sock, (struct sockaddr *)&bench_addrs[lists[l][0]], sizeof(struct sockaddr_in)) != 0) ||
+        (write(sock, msg.c_str(), msg.size()) != (ssize_t)msg.size()))
+      {
+      close(sock);
+      continue;
+      }
+
+    socks.push_back(sock);
+    }
+
+  /* every sister answers once its part of the tree has joined */
+  for (size_t i = 0; i < socks.size(); i++)
+    {
+    if (read(socks[i], ack, sizeof(ack)) <= 0)
+      fprintf(stderr, "sister didn't answer\n");
+
+    close(socks[i]);
+    }
+  } /* END bench_join() */
+
+void *bench_mom(
+
+  void *arg)
+
+  {
+  int listener = (int)(long)arg;
+
+  while (1)
+    {
+    std::vector<int> below;
+    std::string      line;
+    char             c;
+    int              sock;
+
+    if ((sock = accept(listener, NULL, NULL)) < 0)
+      continue;
+
+    while ((read(sock, &c, 1) == 1) && (c != '\n'))
+      line += c;
+
+    for (const char *p = line.c_str(); *p != '\0'; )
+      {
+      char *end;
+      long  n = strtol(p, &end, 10);
+
+      if (end == p)
+        break;
+
+      below.push_back((int)n);
+      p = end;
+      }
+
+    usleep(BENCH_JOIN_USEC);
+
+    bench_join(below, bench_radix);
+
+    if (write(sock, "ok", 2) != 2)
+      fprintf(stderr, "sister couldn't answer\n");
+
+    close(sock);
+    }
+
+  return(NULL);
+  } /* END bench_mom() */
+
+double bench_launch(
+
+  int nodes,
+  int radix)
+
+  {
+  std::vector<int> below;
+  struct timeval   start;
+  struct timeval   end;
+
+  for (int i = 1; i < nodes; i++)
+    below.push_back(i);
+
+  bench_radix = radix;
+
+  gettimeofday(&start, NULL);
+  bench_join(below, radix);
+  gettimeofday(&end, NULL);
+
+  return((end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_usec - start.tv_usec) / 1000.0);
+  } /* END bench_launch() */
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  int max_nodes = 256;
+
+  if (argc > 1)
+    max_nodes = atoi(argv[1]);
+
+  if (max_nodes < MIN_AUTO_RADIX_NODES)
+    {
+    fprintf(stderr, "usage: %s [max nodes >= %d]\n", argv[0], MIN_AUTO_RADIX_NODES);
+    return(1);
+    }
+
+  bench_addrs.resize(max_nodes);
+
+  for (int i = 1; i < max_nodes; i++)
+    {
+    pthread_t thread;
+    socklen_t len = sizeof(struct sockaddr_in);
+    int       listener = socket(AF_INET, SOCK_STREAM, 0);
+
+    memset(&bench_addrs[i], 0, sizeof(struct sockaddr_in));
+    bench_addrs[i].sin_family = AF_INET;
+    bench_addrs[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if ((listener < 0) ||
+        (bind(listener, (struct sockaddr *)&bench_addrs[i], sizeof(struct sockaddr_in)) != 0) ||
+        (listen(listener, 64) != 0) ||
+        (getsockname(listener, (struct sockaddr *)&bench_addrs[i], &len) != 0) ||
+        (pthread_create(&thread, NULL, bench_mom, (void *)(long)listener) != 0))
+      {
+      perror("can't start the sister moms");
+      return(1);
+      }
+
+    pthread_detach(thread);
+    }
+
+  job_launch_radix = JOB_RADIX_AUTO;
+
+  for (int nodes = MIN_AUTO_RADIX_NODES; nodes <= max_nodes; nodes *= 2)
+    {
+    int    radix = choose_job_radix(nodes);
+    double flat = bench_launch(nodes, 0);
+    double tree = bench_launch(nodes, radix);
+
+    printf("launch on %4d nodes: flat %8.1f ms, radix %2d (%d levels) %8.1f ms\n",
+      nodes, flat, radix, radix_tree_depth(nodes, radix), tree);
+    }
+
+  return(0);
+  } /* END main() */
@@ -32,6 +32,7 @@
 #include "complete_req.hpp"
 #include "req.hpp"
 #include "allocation.hpp"
+#include "event_trace.h"
 
 std::string cg_memory_path;
 std::string cg_cpuacct_path;
@@ -58,6 +59,7 @@ int logged_event;
 int MOMCudaVisibleDevices;
 int exec_with_exec;
 int is_login_node = 0;
+int job_launch_radix = 0;
 char *apbasil_protocol = NULL;
 char *apbasil_path = NULL;
 int lockfds = -1;
@@ -65,6 +67,7 @@ char *path_jobs;
 int multi_mom = 1;
 int svr_resc_size = 0;
 int jobstarter_set = 0;
+int jobstarter_privileged = 0;
 int src_login_interactive = TRUE;
 u_long localaddr = 0;
 time_t time_now;
@@ -562,6 +565,12 @@ int tcp_connect_sockaddr(struct sockaddr *sa, size_t sa_size, bool use_log)
   exit(1);
   }
 
+int socket_connect_addrs(struct sockaddr_in **remotes, int count, int *sockets, int is_privileged, unsigned int timeout)
+  {
+  fprintf(stderr, "The call to socket_connect_addrs needs to be mocked!!\n");
+  exit(1);
+  }
+
 void append_link(tlist_head *head, list_link *newLink, void *pobj)
   {
   fprintf(stderr, "The call to append_link needs to be mocked!!\n");
@@ -1098,3 +1107,10 @@ void register_jobs_nspace(job *pjob, pjobexec_t *TJE) {}
 int setup_gpus_for_job(job *pjob)
   {return(0);}
 
+
+void trace_event(int event, const char *job_id, uint64_t duration, int value) {}
+
+uint64_t trace_elapsed(time_t since)
+  {
+  return(0);
+  }
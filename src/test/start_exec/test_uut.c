@@ -9,10 +9,13 @@
 #include <sys/types.h>
 #include <signal.h>
 #include <limits.h>
+#include <unistd.h>
+#include <vector>
 
 #include "pbs_error.h"
 #include "pbs_nodes.h"
 #include "test_uut.h"
+#include "mom_config.h"
 
 int job_nodes(job &pjob);
 int get_indices_from_exec_str(const char *exec_str, char *buf, int buf_size);
@@ -52,7 +55,6 @@ void update_task_and_job_states_after_launch(task *ptask, job *pjob, const char
 unsigned long long get_memory_limit_from_resource_list(job *pjob);
 #endif
 
-int jobstarter_privileged = 0;
 int ac_read_amount;
 int ac_errno;
 extern int job_saved;
@@ -595,6 +597,120 @@ START_TEST(test_get_num_nodes_ppn)
   }
 END_TEST
 
+START_TEST(test_choose_job_radix)
+  {
+  job_launch_radix = JOB_RADIX_AUTO;
+
+  /* small jobs are started directly */
+  fail_unless(choose_job_radix(1) == 0);
+  fail_unless(choose_job_radix(MIN_AUTO_RADIX_NODES - 1) == 0);
+
+  fail_unless(choose_job_radix(MIN_AUTO_RADIX_NODES) == MIN_AUTO_JOB_RADIX);
+  fail_unless(choose_job_radix(1000) == 10);
+  fail_unless(choose_job_radix(2000) == 13);
+  fail_unless(choose_job_radix(1000000) == MAX_AUTO_JOB_RADIX);
+
+  /* the automatic radix keeps jobs within three levels of mother superior */
+  for (int nodes = MIN_AUTO_RADIX_NODES; nodes <= 20000; nodes += 97)
+    fail_unless(radix_tree_depth(nodes, choose_job_radix(nodes)) <= 3, "%d nodes", nodes);
+
+  job_launch_radix = 8;
+  fail_unless(choose_job_radix(4) == 0);
+  fail_unless(choose_job_radix(9) == 8);
+  fail_unless(choose_job_radix(2000) == 8);
+
+  job_launch_radix = JOB_RADIX_FLAT;
+  fail_unless(choose_job_radix(2000) == 0);
+
+  job_launch_radix = JOB_RADIX_AUTO;
+  }
+END_TEST
+
+START_TEST(test_radix_tree_depth)
+  {
+  fail_unless(radix_tree_depth(1, 4) == 0);
+  fail_unless(radix_tree_depth(2, 0) == 1);
+  fail_unless(radix_tree_depth(100, 0) == 1);
+  fail_unless(radix_tree_depth(5, 4) == 1);
+  fail_unless(radix_tree_depth(6, 4) == 2);
+  fail_unless(radix_tree_depth(21, 4) == 2);
+  fail_unless(radix_tree_depth(22, 4) == 3);
+  }
+END_TEST
+
+/*
+ * The time a launch takes when every join sent costs LAUNCH_SEND_COST and
+ * every sister spends LAUNCH_JOIN_COST setting up before it passes the join
+ * on to the sisters below it, split radix ways the way a job radix splits
+ * them. A sister sends its joins one after another and the launch is done
+ * when the slowest branch is.
+ */
+
+#define LAUNCH_SEND_COST  1  /* encoding and writing one join */
+#define LAUNCH_JOIN_COST  2  /* a sister setting up the job */
+
+int launch_cost(
+
+  int nodes_below,
+  int radix)
+
+  {
+  std::vector<int> lists;
+  int              slowest = 0;
+
+  if (nodes_below == 0)
+    return(0);
+
+  if (radix == 0)
+    lists.assign(nodes_below, 1);
+  else
+    {
+    lists.assign(radix, 0);
+
+    for (int i = 0; i < nodes_below; i++)
+      lists[i % radix]++;
+    }
+
+  for (size_t l = 0; l < lists.size(); l++)
+    {
+    int done;
+
+    if (lists[l] == 0)
+      continue;
+
+    /* the head of each list joins, then starts the rest of its list */
+    done = (l + 1) * LAUNCH_SEND_COST + LAUNCH_JOIN_COST + launch_cost(lists[l] - 1, radix);
+
+    if (done > slowest)
+      slowest = done;
+    }
+
+  return(slowest);
+  } /* END launch_cost() */
+
+START_TEST(test_launch_cost)
+  {
+  job_launch_radix = JOB_RADIX_AUTO;
+
+  /* 16 nodes: 15 sends flat.  With radix 4 the third list's head is sent
+   * its join 3rd, sets up, and starts its last sister 3rd as well */
+  fail_unless(launch_cost(15, 0) == 15 * LAUNCH_SEND_COST + LAUNCH_JOIN_COST);
+  fail_unless(launch_cost(15, 4) == (3 + 2) + (3 + 2));
+
+  /* the automatic radix never starts a job slower than the flat fan-out */
+  for (int nodes = MIN_AUTO_RADIX_NODES; nodes <= 5000; nodes += 37)
+    {
+    int radix = choose_job_radix(nodes);
+
+    fail_unless(launch_cost(nodes - 1, radix) <= launch_cost(nodes - 1, 0), "%d nodes", nodes);
+    }
+
+  /* the sends mother superior makes dominate flat launches of large jobs */
+  fail_unless(launch_cost(255, choose_job_radix(256)) < launch_cost(255, 0) / 4);
+  fail_unless(launch_cost(4095, choose_job_radix(4096)) < launch_cost(4095, 0) / 40);
+  }
+END_TEST
+
 Suite *start_exec_suite(void)
   {
   Suite *s = suite_create("start_exec_suite methods");
@@ -648,6 +764,15 @@ Suite *start_exec_suite(void)
 #endif
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_choose_job_radix");
+  tcase_add_test(tc_core, test_choose_job_radix);
+  tcase_add_test(tc_core, test_radix_tree_depth);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_launch_cost");
+  tcase_add_test(tc_core, test_launch_cost);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -1,12 +1,15 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <string.h>
 
 #include "attribute.h" /* attribute_def, svrattrl */
 #include "server.h" /* server */
 #include "batch_request.h" /* batch_request */
 #include "list_link.h" /* list_link */
 #include "resource.h" /* list_link */
+#include "completed_job_store.hpp"
+#include "job_history.hpp"
 
 attribute_def job_attr_def[10];
 struct server server;
@@ -185,3 +188,64 @@ void job::encode_plugin_resource_usage(
 
   {
   }
+
+completed_job_store completed_store;
+
+completed_job_store::completed_job_store() {}
+completed_job_store::~completed_job_store() {}
+
+bool completed_job_store::add_job(const char *job_id, const completed_job_info &info, const std::vector<completed_job_attr> &attrs)
+  {
+  return(true);
+  }
+
+bool completed_job_store::get_job(const char *job_id, completed_job_info &info, std::vector<completed_job_attr> &attrs)
+  {
+  return(false);
+  }
+
+void completed_job_store::get_job_ids(const char *queue, std::vector<std::string> &ids) {}
+
+char *pbs_o_host = (char *)"PBS_O_HOST";
+
+char *get_variable(job *pjob, const char *variable)
+  {
+  return(NULL);
+  }
+
+int svr_authorize_req(struct batch_request *preq, char *owner, char *submit_host)
+  {
+  return(0);
+  }
+
+void get_jobowner(char *from, char *to)
+  {
+  strcpy(to, from);
+  }
+
+resource_def *find_resc_def(resource_def *rscdf, const char *name, int limit)
+  {
+  return(NULL);
+  }
+
+void free_attrlist(tlist_head *pattrlisthead) {}
+
+job_history job_hist;
+
+job_history::job_history() {}
+job_history::~job_history() {}
+
+bool job_history::is_open()
+  {
+  return(false);
+  }
+
+int job_history::add_job(const char *job_id, const completed_job_info &info, const std::vector<completed_job_attr> &attrs)
+  {
+  return(0);
+  }
+
+bool job_history::get_job(const char *job_id, completed_job_info &info, std::vector<completed_job_attr> &attrs)
+  {
+  return(false);
+  }
@@ -1,12 +1,15 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "pbs_error.h"
 #include "pbs_job.h"
+#include "batch_request.h"
 #include "test_stat_job.h"
 
 bool include_in_status(int index);
+int  status_completed_job(const char *job_id, batch_request *preq, svrattrl *pal, tlist_head *pstathd, bool condensed, int *bad);
 
 
 START_TEST(test_include_in_status)
@@ -37,6 +40,20 @@ START_TEST(test_include_in_status)
   }
 END_TEST
 
+START_TEST(test_status_completed_job)
+  {
+  batch_request preq;
+  tlist_head    head;
+  int           bad = 0;
+
+  memset(&preq, 0, sizeof(preq));
+  CLEAR_HEAD(head);
+
+  // jobs that aren't in the completed store are unknown
+  fail_unless(status_completed_job("1.napali", &preq, NULL, &head, false, &bad) == PBSE_UNKJOBID);
+  }
+END_TEST
+
 START_TEST(test_two)
   {
 
@@ -49,6 +66,7 @@ Suite *stat_job_suite(void)
   Suite *s = suite_create("stat_job_suite methods");
   TCase *tc_core = tcase_create("test_include_in_status");
   tcase_add_test(tc_core, test_include_in_status);
+  tcase_add_test(tc_core, test_status_completed_job);
   suite_add_tcase(s, tc_core);
 
   tc_core = tcase_create("test_two");
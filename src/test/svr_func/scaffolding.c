@@ -105,3 +105,5 @@ int get_svr_attr_b(int index, bool *b)
   {
   return(0);
   }
+
+void notify_scheduler(int event) {}
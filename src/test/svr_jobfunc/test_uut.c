@@ -23,6 +23,7 @@ int chk_mppnodect(resource *mppnodect, pbs_queue *pque, long nppn, long mpp_widt
 void job_wait_over(struct work_task *);
 bool is_valid_state_transition(job &pjob, int newstate, int newsubstate);
 bool has_conflicting_resource_requests(job *pjob, pbs_queue *pque);
+int insert_into_alljobs_by_rank(all_jobs *aj, job_rank_index *ranks, job *pjob, char *jobid);
 
 extern int decrement_count;
 extern job napali_job;
@@ -188,6 +189,11 @@ START_TEST(chk_mppnodect_test)
   }
 END_TEST
 
+int decode_queue(pbs_attribute *patr, const char *name, const char *rescn, const char *val, int perm)
+  {
+  return(0);
+  }
+
 START_TEST(svr_enquejob_test)
   {
   struct job test_job;
@@ -207,10 +213,51 @@ START_TEST(svr_enquejob_test)
   result = svr_enquejob(NULL, 0, NULL, false, false);
   fail_unless(result != PBSE_NONE, "NULL input pointer fail");
 
+  /* the job stays locked while it's linked into the queue, so it gets queued */
+  job_attr_def[JOB_ATR_in_queue].at_free = free_null;
+  job_attr_def[JOB_ATR_in_queue].at_decode = decode_queue;
+  test_job.ji_wattr[JOB_ATR_qtime].at_flags = ATR_VFLAG_SET;
   result = svr_enquejob(&test_job, 0, NULL, false, false);
-  /*Need more complicated mocking in order to have other result than PBSE_JOBNOTFOUND*/
-  fail_unless(result == PBSE_JOBNOTFOUND, "svr_enquejob fail: %d", result);
+  fail_unless(result == PBSE_NONE, "svr_enquejob fail: %d", result);
+
+  }
+END_TEST
+
+START_TEST(insert_into_alljobs_by_rank_test)
+  {
+  all_jobs        aj;
+  job_rank_index  ranks;
+  job             jobs[4];
+  long            qranks[] = { 20, 40, 10, 30 };
+  const char     *order[] = { "3.napali", "1.napali", "4.napali", "2.napali" };
+  job            *pjob;
+  int             i = 0;
+
+  for (int j = 0; j < 4; j++)
+    {
+    memset(&jobs[j], 0, sizeof(job));
+    sprintf(jobs[j].ji_qs.ji_jobid, "%d.napali", j + 1);
+    jobs[j].ji_wattr[JOB_ATR_qrank].at_val.at_long = qranks[j];
+
+    fail_unless(insert_into_alljobs_by_rank(&aj, &ranks, &jobs[j], jobs[j].ji_qs.ji_jobid) == PBSE_NONE);
+    }
+
+  fail_unless(insert_into_alljobs_by_rank(&aj, &ranks, &jobs[1], jobs[1].ji_qs.ji_jobid) == ALREADY_IN_LIST);
+  fail_unless(ranks.count() == 4);
+
+  aj.lock();
+  all_jobs_iterator *iter = aj.get_iterator();
+
+  while ((pjob = iter->get_next_item()) != NULL)
+    {
+    fail_unless(i < 4);
+    fail_unless(!strcmp(pjob->ji_qs.ji_jobid, order[i]), "%s at %d", pjob->ji_qs.ji_jobid, i);
+    i++;
+    }
 
+  delete iter;
+  aj.unlock();
+  fail_unless(i == 4);
   }
 END_TEST
 
@@ -680,6 +727,7 @@ Suite *svr_jobfunc_suite(void)
   Suite *s = suite_create("svr_jobfunc_suite methods");
   TCase *tc_core = tcase_create("svr_enquejob_test");
   tcase_add_test(tc_core, svr_enquejob_test);
+  tcase_add_test(tc_core, insert_into_alljobs_by_rank_test);
   suite_add_tcase(s, tc_core);
 
   tc_core = tcase_create("svr_dequejob_test");
@@ -61,6 +61,27 @@ START_TEST(test_tm_adopt_ispidowner)
   }
 END_TEST
 
+START_TEST(test_tm_multi_bad_args)
+  {
+  struct tm_roots roots;
+  tm_node_id      where[2] = { 0, 1 };
+  tm_task_id      tids[2] = { 7, 8 };
+  int             obitvals[2];
+  tm_event_t      event;
+  char           *argv[] = { (char *)"/bin/true", NULL };
+
+  fake_tm_init(NULL, &roots);
+
+  fail_unless(tm_spawn_multi(1, argv, NULL, 0, where, tids, &event) == TM_EBADENVIRONMENT);
+  fail_unless(tm_spawn_multi(1, argv, NULL, 2, NULL, tids, &event) == TM_EBADENVIRONMENT);
+  fail_unless(tm_spawn_multi(0, argv, NULL, 2, where, tids, &event) == TM_ENOTFOUND);
+
+  /* neither task was ever spawned */
+  fail_unless(tm_obit_multi(2, tids, obitvals, &event) == TM_ENOTFOUND);
+  fail_unless(tm_obit_multi(0, tids, obitvals, &event) == TM_EBADENVIRONMENT);
+  }
+END_TEST
+
 Suite *tm_suite(void)
   {
   Suite *s = suite_create("tm_suite methods");
@@ -69,6 +90,7 @@ Suite *tm_suite(void)
   tcase_add_test(tc, test_tm_poll_bad_init);
   tcase_add_test(tc, test_tm_poll_bad_result);
   tcase_add_test(tc, test_tm_adopt_ispidowner);
+  tcase_add_test(tc, test_tm_multi_bad_args);
   
   suite_add_tcase(s, tc);
   return s;
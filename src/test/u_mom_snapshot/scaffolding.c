@@ -0,0 +1,16 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/types.h>
+
+
+int open_ext(
+
+  const char *path,
+  int         flags,
+  mode_t      mode)
+
+  {
+  return(open(path, flags, mode));
+  }
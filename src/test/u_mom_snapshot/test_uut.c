@@ -0,0 +1,264 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <check.h>
+
+#include "mom_snapshot.h"
+#include "pbs_error.h"
+
+const char *snapshot_path = "./test_status_snapshot";
+
+
+void fill_job(
+
+  mom_snapshot_job *entry,
+  uint32_t          index,
+  uint64_t          value)
+
+  {
+  memset(entry, 0, sizeof(*entry));
+  snprintf(entry->mj_jobid, sizeof(entry->mj_jobid), "%u.napali", index);
+  snprintf(entry->mj_owner, sizeof(entry->mj_owner), "dbeer");
+  entry->mj_cput = value;
+  entry->mj_walltime = value;
+  entry->mj_mem = value;
+  entry->mj_vmem = value;
+  }
+
+
+
+START_TEST(test_round_trip)
+  {
+  mom_snapshot_map    writer;
+  mom_snapshot_map    reader;
+  mom_snapshot_header hdr;
+  mom_snapshot_job    jobs[4];
+
+  unlink(snapshot_path);
+
+  fail_unless(mom_snapshot_attach(snapshot_path, &reader) == -1);
+
+  fail_unless(mom_snapshot_create(snapshot_path, &writer) == PBSE_NONE);
+  fail_unless(writer.sm_header->ms_job_capacity == MOM_SNAPSHOT_MIN_JOBS);
+  fail_unless((writer.sm_header->ms_sequence & 1) == 0);
+
+  mom_snapshot_begin(&writer);
+  fill_job(mom_snapshot_job_at(&writer, 0), 0, 10);
+  fill_job(mom_snapshot_job_at(&writer, 1), 1, 20);
+  writer.sm_header->ms_job_count = 2;
+  writer.sm_header->ms_ncpus = 8;
+  snprintf(writer.sm_header->ms_host, sizeof(writer.sm_header->ms_host), "napali");
+  mom_snapshot_end(&writer);
+
+  fail_unless(mom_snapshot_job_at(&writer, MOM_SNAPSHOT_MIN_JOBS) == NULL);
+
+  fail_unless(mom_snapshot_attach(snapshot_path, &reader) == PBSE_NONE);
+
+  /* only as many as fit are copied */
+  fail_unless(mom_snapshot_read(&reader, &hdr, jobs, 1) == 1);
+  fail_unless(hdr.ms_job_count == 2);
+
+  fail_unless(mom_snapshot_read(&reader, &hdr, jobs, 4) == 2);
+  fail_unless(hdr.ms_ncpus == 8);
+  fail_unless(!strcmp(hdr.ms_host, "napali"));
+  fail_unless(hdr.ms_mom_pid == getpid());
+  fail_unless(!strcmp(jobs[1].mj_jobid, "1.napali"));
+  fail_unless(jobs[1].mj_mem == 20);
+  fail_unless(!strcmp(jobs[0].mj_owner, "dbeer"));
+
+  /* a restarted mom reuses the file and carries the sequence on */
+  uint64_t sequence = hdr.ms_sequence;
+  mom_snapshot_detach(&writer);
+
+  fail_unless(mom_snapshot_create(snapshot_path, &writer) == PBSE_NONE);
+  fail_unless(mom_snapshot_read(&reader, &hdr, jobs, 4) == 0);
+  fail_unless(hdr.ms_sequence > sequence);
+
+  mom_snapshot_detach(&writer);
+  mom_snapshot_detach(&reader);
+  fail_unless(reader.sm_header == NULL);
+
+  /* files that aren't snapshots are refused */
+  FILE *fp = fopen(snapshot_path, "w");
+  for (unsigned int i = 0; i < sizeof(mom_snapshot_header); i++)
+    fputc('x', fp);
+  fclose(fp);
+  fail_unless(mom_snapshot_attach(snapshot_path, &reader) == -1);
+
+  unlink(snapshot_path);
+  }
+END_TEST
+
+
+
+START_TEST(test_growth)
+  {
+  mom_snapshot_map     writer;
+  mom_snapshot_map     reader;
+  mom_snapshot_header  hdr;
+  uint32_t             count = MOM_SNAPSHOT_MIN_JOBS * 5;
+  mom_snapshot_job    *jobs = (mom_snapshot_job *)calloc(count, sizeof(mom_snapshot_job));
+
+  unlink(snapshot_path);
+
+  fail_unless(mom_snapshot_create(snapshot_path, &writer) == PBSE_NONE);
+  fail_unless(mom_snapshot_attach(snapshot_path, &reader) == PBSE_NONE);
+  size_t mapped = reader.sm_len;
+
+  fail_unless(mom_snapshot_reserve(&writer, 10) == PBSE_NONE);
+  fail_unless(writer.sm_header->ms_job_capacity == MOM_SNAPSHOT_MIN_JOBS);
+
+  /* grows to at least double */
+  fail_unless(mom_snapshot_reserve(&writer, MOM_SNAPSHOT_MIN_JOBS + 1) == PBSE_NONE);
+  fail_unless(writer.sm_header->ms_job_capacity == MOM_SNAPSHOT_MIN_JOBS * 2);
+
+  fail_unless(mom_snapshot_reserve(&writer, count) == PBSE_NONE);
+  fail_unless(writer.sm_header->ms_job_capacity == count);
+
+  mom_snapshot_begin(&writer);
+  for (uint32_t i = 0; i < count; i++)
+    fill_job(mom_snapshot_job_at(&writer, i), i, i);
+  writer.sm_header->ms_job_count = count;
+  mom_snapshot_end(&writer);
+
+  /* the reader maps the larger file */
+  fail_unless(mom_snapshot_read(&reader, &hdr, jobs, count) == (int)count);
+  fail_unless(reader.sm_len > mapped);
+  fail_unless(jobs[count - 1].mj_cput == count - 1);
+  fail_unless(!strcmp(jobs[count - 1].mj_jobid, "319.napali"));
+
+  /* a restarted mom never shrinks the file out from under readers */
+  mom_snapshot_detach(&writer);
+  fail_unless(mom_snapshot_create(snapshot_path, &writer) == PBSE_NONE);
+  fail_unless(writer.sm_header->ms_job_capacity == count);
+
+  mom_snapshot_detach(&writer);
+  mom_snapshot_detach(&reader);
+  free(jobs);
+  unlink(snapshot_path);
+  }
+END_TEST
+
+
+
+START_TEST(test_concurrent_reader)
+  {
+  mom_snapshot_map     writer;
+  mom_snapshot_map     reader;
+  mom_snapshot_header  hdr;
+  uint32_t             max_jobs = MOM_SNAPSHOT_MIN_JOBS * 8;
+  mom_snapshot_job    *jobs = (mom_snapshot_job *)calloc(max_jobs, sizeof(mom_snapshot_job));
+  pid_t                pid;
+  pid_t                parent = getpid();
+  int                  reads = 0;
+  uint64_t             last = 0;
+
+  unlink(snapshot_path);
+
+  fail_unless(mom_snapshot_create(snapshot_path, &writer) == PBSE_NONE);
+
+  if ((pid = fork()) == 0)
+    {
+    /* every entry and the job count carry the same value, and the file grows as it goes */
+    for (uint64_t value = 1; ; value++)
+      {
+      uint32_t count = 1 + (value % max_jobs);
+
+      if (mom_snapshot_reserve(&writer, count) != PBSE_NONE)
+        _exit(1);
+
+      mom_snapshot_begin(&writer);
+
+      for (uint32_t i = 0; i < count; i++)
+        fill_job(mom_snapshot_job_at(&writer, i), i, value);
+
+      writer.sm_header->ms_job_count = count;
+      writer.sm_header->ms_polls = value;
+
+      mom_snapshot_end(&writer);
+
+      /* like the mom, don't hold the snapshot constantly, and don't outlive the test */
+      if (getppid() != parent)
+        _exit(0);
+
+      usleep(500);
+      }
+    }
+
+  fail_unless(pid > 0);
+
+  fail_unless(mom_snapshot_attach(snapshot_path, &reader) == PBSE_NONE);
+
+  while (reads < 2000)
+    {
+    int count = mom_snapshot_read(&reader, &hdr, jobs, max_jobs);
+
+    fail_unless(count >= 0);
+
+    if (hdr.ms_polls == 0)
+      continue;
+
+    fail_unless((uint32_t)count == 1 + (hdr.ms_polls % max_jobs));
+    fail_unless(hdr.ms_polls >= last);
+
+    for (int i = 0; i < count; i++)
+      {
+      fail_unless(jobs[i].mj_cput == hdr.ms_polls);
+      fail_unless(jobs[i].mj_vmem == hdr.ms_polls);
+      }
+
+    last = hdr.ms_polls;
+    reads++;
+    }
+
+  kill(pid, SIGKILL);
+  waitpid(pid, NULL, 0);
+
+  mom_snapshot_detach(&reader);
+  mom_snapshot_detach(&writer);
+  free(jobs);
+  unlink(snapshot_path);
+  }
+END_TEST
+
+
+
+Suite *u_mom_snapshot_suite(void)
+  {
+  Suite *s = suite_create("u_mom_snapshot test suite methods");
+  TCase *tc_core = tcase_create("test_round_trip");
+  tcase_add_test(tc_core, test_round_trip);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_growth");
+  tcase_add_test(tc_core, test_growth);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_concurrent_reader");
+  tcase_add_test(tc_core, test_concurrent_reader);
+  tcase_set_timeout(tc_core, 60);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(u_mom_snapshot_suite());
+  srunner_set_log(sr, "u_mom_snapshot_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
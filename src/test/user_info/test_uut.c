@@ -190,6 +190,40 @@ END_TEST
 
 
 
+START_TEST(reconcile_queued_jobs_test)
+  {
+  std::map<std::string, unsigned int> counted;
+  user_info *ui = (user_info *)calloc(1, sizeof(user_info));
+
+  users.lock();
+  users.clear();
+  ui->user_name = strdup("tom");
+  ui->num_jobs_queued = 3;
+  users.insert(ui, ui->user_name);
+  users.unlock();
+
+  counted["tom"] = 3;
+  fail_unless(reconcile_queued_jobs(&users, counted) == 0);
+  fail_unless(get_num_queued(&users, "tom") == 3);
+
+  // tom's count drifted and bob was never counted
+  counted["tom"] = 2;
+  counted["bob"] = 5;
+  fail_unless(reconcile_queued_jobs(&users, counted) == 2);
+  fail_unless(get_num_queued(&users, "tom") == 2);
+  fail_unless(get_num_queued(&users, "bob") == 5);
+
+  // a user with no queued jobs left is reset to 0
+  counted.clear();
+  fail_unless(reconcile_queued_jobs(&users, counted) == 2);
+  fail_unless(get_num_queued(&users, "tom") == 0);
+  fail_unless(get_num_queued(&users, "bob") == 0);
+  }
+END_TEST
+
+
+
+
 Suite *user_info_suite(void)
   {
   Suite *s = suite_create("user_info test suite methods");
@@ -212,6 +246,7 @@ Suite *user_info_suite(void)
   tc_core = tcase_create("decrement_queued_jobs_test");
   tcase_add_test(tc_core, decrement_queued_jobs_test);
   tcase_add_test(tc_core, remove_server_suffix_test);
+  tcase_add_test(tc_core, reconcile_queued_jobs_test);
   suite_add_tcase(s, tc_core);
   
   return(s);
@@ -0,0 +1,590 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+/*
+ * printacct - sum job usage from the binary accounting sidecar
+ *
+ * Reads the <accounting file>.usage files pbs_server writes when
+ * record_job_usage is set and prints the jobs, walltime, cpu time and
+ * slot time used per user, group, queue, account or job. When only one
+ * user is wanted the .usage.idx index is used to read just that user's
+ * records.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "pbs_ifl.h"
+#include "printacct.h"
+
+#define USAGE_READ_RECORDS 256
+#define USAGE_KEY_COUNT    5
+
+/* path from pbs home to the accounting files */
+const char *usage_path = "server_priv/accounting";
+
+const char *usage_key_names[] =
+  {
+  "user",
+  "group",
+  "queue",
+  "account",
+  "job"
+  };
+
+
+
+/*
+ * parse_usage_key - the usage_key named name
+ *
+ * @return the key, -1 if name isn't one
+ */
+
+int parse_usage_key(
+
+  const char *name)
+
+  {
+  for (int i = 0; i < USAGE_KEY_COUNT; i++)
+    {
+    if (!strcasecmp(name, usage_key_names[i]))
+      return(i);
+    }
+
+  return(-1);
+  }  /* END parse_usage_key() */
+
+
+
+bool usage_record_matches(
+
+  const acct_usage_record   *rec,
+  const struct usage_filter *filter)
+
+  {
+  if ((filter->user != NULL) &&
+      (strncmp(rec->ur_user, filter->user, ACCT_USAGE_NAME_LEN)))
+    return(false);
+
+  if ((filter->group != NULL) &&
+      (strncmp(rec->ur_group, filter->group, ACCT_USAGE_NAME_LEN)))
+    return(false);
+
+  if ((filter->queue != NULL) &&
+      (strncmp(rec->ur_queue, filter->queue, ACCT_USAGE_NAME_LEN)))
+    return(false);
+
+  if ((filter->account != NULL) &&
+      (strncmp(rec->ur_account, filter->account, ACCT_USAGE_NAME_LEN)))
+    return(false);
+
+  return(true);
+  }  /* END usage_record_matches() */
+
+
+
+/*
+ * read_usage_index - the numbers of user's records from the index of usage_path
+ *
+ * @param record_count - the records in the usage file, an index covering
+ * more than that doesn't belong to it
+ * @return the number of records the index covers, -1 if there's no usable index
+ */
+
+int read_usage_index(
+
+  const char            *usage_path,
+  const char            *user,
+  uint32_t               record_count,
+  std::vector<uint32_t> &numbers)
+
+  {
+  char                    path[MAXPATHLEN];
+  acct_usage_index_header header;
+  acct_usage_index_entry  entry;
+  FILE                   *fp;
+  size_t                  len = strlen(usage_path);
+  size_t                  suffix_len = strlen(ACCT_USAGE_SUFFIX);
+
+  if ((len < suffix_len) ||
+      (strcmp(usage_path + len - suffix_len, ACCT_USAGE_SUFFIX)))
+    return(-1);
+
+  snprintf(path, sizeof(path), "%.*s%s", (int)(len - suffix_len), usage_path, ACCT_USAGE_INDEX_SUFFIX);
+
+  if ((fp = fopen(path, "r")) == NULL)
+    return(-1);
+
+  if ((fread(&header, sizeof(header), 1, fp) != 1) ||
+      (header.uih_magic != ACCT_USAGE_INDEX_MAGIC) ||
+      (header.uih_version != ACCT_USAGE_VERSION) ||
+      (header.uih_record_count > record_count))
+    {
+    fclose(fp);
+    return(-1);
+    }
+
+  long numbers_start = sizeof(header) + header.uih_user_count * sizeof(acct_usage_index_entry);
+
+  for (uint32_t i = 0; i < header.uih_user_count; i++)
+    {
+    if (fread(&entry, sizeof(entry), 1, fp) != 1)
+      {
+      fclose(fp);
+      return(-1);
+      }
+
+    if (strncmp(entry.uie_user, user, ACCT_USAGE_NAME_LEN))
+      continue;
+
+    numbers.resize(entry.uie_count);
+
+    if ((entry.uie_count > 0) &&
+        ((fseek(fp, numbers_start + entry.uie_first * sizeof(uint32_t), SEEK_SET) != 0) ||
+         (fread(&numbers[0], sizeof(uint32_t), entry.uie_count, fp) != entry.uie_count)))
+      {
+      numbers.clear();
+      fclose(fp);
+      return(-1);
+      }
+
+    break;
+    }
+
+  fclose(fp);
+
+  return(header.uih_record_count);
+  }  /* END read_usage_index() */
+
+
+
+/*
+ * read_usage_file - appends the records in path that match filter to records
+ *
+ * @return the number of records added, -1 if path isn't a usage file
+ */
+
+int read_usage_file(
+
+  const char                     *path,
+  const struct usage_filter      *filter,
+  std::vector<acct_usage_record> &records)
+
+  {
+  acct_usage_header      header;
+  acct_usage_record      buf[USAGE_READ_RECORDS];
+  struct stat            sb;
+  std::vector<uint32_t>  numbers;
+  int                    fd;
+  int                    added = 0;
+  int                    indexed = -1;
+  uint32_t               record_count;
+  uint32_t               next = 0;
+
+  if ((fd = open(path, O_RDONLY, 0)) < 0)
+    return(-1);
+
+  if ((fstat(fd, &sb) != 0) ||
+      (read(fd, &header, sizeof(header)) != sizeof(header)) ||
+      (header.uh_magic != ACCT_USAGE_MAGIC) ||
+      (header.uh_version != ACCT_USAGE_VERSION) ||
+      (header.uh_record_size != sizeof(acct_usage_record)))
+    {
+    close(fd);
+    errno = EINVAL;
+    return(-1);
+    }
+
+  record_count = (sb.st_size - sizeof(header)) / sizeof(acct_usage_record);
+
+  if (filter->user != NULL)
+    indexed = read_usage_index(path, filter->user, record_count, numbers);
+
+  if (indexed >= 0)
+    {
+    /* read only the user's records, then anything written after the index */
+    for (unsigned int i = 0; i < numbers.size(); i++)
+      {
+      off_t offset = sizeof(header) + (off_t)numbers[i] * sizeof(acct_usage_record);
+
+      if ((numbers[i] >= record_count) ||
+          (pread(fd, buf, sizeof(acct_usage_record), offset) != sizeof(acct_usage_record)))
+        continue;
+
+      if (usage_record_matches(&buf[0], filter) == true)
+        {
+        records.push_back(buf[0]);
+        added++;
+        }
+      }
+
+    next = indexed;
+    }
+
+  while (next < record_count)
+    {
+    uint32_t count = record_count - next;
+    off_t    offset = sizeof(header) + (off_t)next * sizeof(acct_usage_record);
+    ssize_t  amt;
+
+    if (count > USAGE_READ_RECORDS)
+      count = USAGE_READ_RECORDS;
+
+    if ((amt = pread(fd, buf, count * sizeof(acct_usage_record), offset)) <= 0)
+      break;
+
+    count = amt / sizeof(acct_usage_record);
+
+    for (uint32_t i = 0; i < count; i++)
+      {
+      if (usage_record_matches(&buf[i], filter) == true)
+        {
+        records.push_back(buf[i]);
+        added++;
+        }
+      }
+
+    next += count;
+    }
+
+  close(fd);
+
+  return(added);
+  }  /* END read_usage_file() */
+
+
+
+const char *usage_record_key(
+
+  const acct_usage_record *rec,
+  int                      key)
+
+  {
+  switch (key)
+    {
+    case USAGE_BY_GROUP:
+
+      return(rec->ur_group);
+
+    case USAGE_BY_QUEUE:
+
+      return(rec->ur_queue);
+
+    case USAGE_BY_ACCOUNT:
+
+      return(rec->ur_account);
+
+    case USAGE_BY_JOB:
+
+      return(rec->ur_job_id);
+
+    default:
+
+      return(rec->ur_user);
+    }
+  }  /* END usage_record_key() */
+
+
+
+/*
+ * add_usage - adds each record to the total of its key
+ */
+
+void add_usage(
+
+  const std::vector<acct_usage_record> &records,
+  int                                   key,
+  std::map<std::string, usage_total>   &totals)
+
+  {
+  for (unsigned int i = 0; i < records.size(); i++)
+    {
+    const acct_usage_record &rec = records[i];
+    std::string              name(usage_record_key(&rec, key));
+
+    if (totals.find(name) == totals.end())
+      {
+      usage_total empty;
+
+      memset(&empty, 0, sizeof(empty));
+      totals[name] = empty;
+      }
+
+    usage_total &total = totals[name];
+
+    total.jobs++;
+    total.walltime += rec.ur_walltime;
+    total.cput += rec.ur_cput;
+    total.slot_time += rec.ur_walltime * rec.ur_slots;
+
+    if (rec.ur_mem > total.max_mem)
+      total.max_mem = rec.ur_mem;
+
+    if (rec.ur_vmem > total.max_vmem)
+      total.max_vmem = rec.ur_vmem;
+    }
+  }  /* END add_usage() */
+
+
+
+/*
+ * print_usage_totals - one line per key, times in hours
+ */
+
+void print_usage_totals(
+
+  FILE                                     *out,
+  int                                       key,
+  const std::map<std::string, usage_total> &totals)
+
+  {
+  fprintf(out, "%-20s  %8s  %12s  %12s  %12s  %12s\n",
+    usage_key_names[key], "jobs", "walltime", "cput", "slot_hours", "max_mem_kb");
+
+  for (std::map<std::string, usage_total>::const_iterator it = totals.begin();
+       it != totals.end();
+       it++)
+    {
+    fprintf(out, "%-20s  %8lu  %12.2f  %12.2f  %12.2f  %12llu\n",
+      (it->first.size() > 0) ? it->first.c_str() : "-",
+      it->second.jobs,
+      it->second.walltime / 3600.0,
+      it->second.cput / 3600.0,
+      it->second.slot_time / 3600.0,
+      (unsigned long long)it->second.max_mem);
+    }
+  }  /* END print_usage_totals() */
+
+
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  std::vector<acct_usage_record>      records;
+  std::map<std::string, usage_total>  totals;
+  struct usage_filter                 filter;
+  const char                         *files[MAX_USAGE_FILES];
+  int                                 file_count = 0;
+  const char                         *prefix_path = PBS_SERVER_HOME;
+  unsigned int                        number_of_days = 1;
+  int                                 key = USAGE_BY_USER;
+  short                               error = 0;
+  char                               *endp;
+  int                                 c;
+  char                                path[MAXPATHLEN];
+
+  memset(&filter, 0, sizeof(filter));
+
+  while ((c = getopt(argc, argv, "p:n:k:u:g:q:A:f:")) != EOF)
+    {
+    switch (c)
+      {
+      case 'p':
+
+        prefix_path = optarg;
+
+        break;
+
+      case 'n':
+
+        number_of_days = strtoul(optarg, &endp, 10);
+
+        if (*endp != '\0')
+          error = 1;
+
+        break;
+
+      case 'k':
+
+        if ((key = parse_usage_key(optarg)) < 0)
+          error = 1;
+
+        break;
+
+      case 'u':
+
+        filter.user = optarg;
+
+        break;
+
+      case 'g':
+
+        filter.group = optarg;
+
+        break;
+
+      case 'q':
+
+        filter.queue = optarg;
+
+        break;
+
+      case 'A':
+
+        filter.account = optarg;
+
+        break;
+
+      case 'f':
+
+        if (file_count < MAX_USAGE_FILES)
+          files[file_count++] = optarg;
+
+        break;
+
+      default:
+
+        error = 1;
+
+        break;
+      }
+    }
+
+  if ((error != 0) ||
+      (optind < argc))
+    {
+    fprintf(stderr, "USAGE: %s [-p path] [-n days] [-k key] [-u user] [-g group] [-q queue] [-A account] [-f file]...\n",
+      argv[0]);
+
+    fprintf(stderr,
+      "   -p : path to PBS_SERVER_HOME [default %s]\n"
+      "   -n : number of days in the past to read [default 1]\n"
+      "   -k : sum usage by user, group, queue, account or job [default user]\n"
+      "   -u, -g, -q, -A : only count jobs of this user, group, queue or account\n"
+      "   -f : read this usage file instead of the ones in PBS_SERVER_HOME\n",
+      PBS_SERVER_HOME);
+
+    return(1);
+    }
+
+  if (file_count > 0)
+    {
+    for (int i = 0; i < file_count; i++)
+      {
+      if (read_usage_file(files[i], &filter, records) < 0)
+        fprintf(stderr, "%s: %s is not a usage file\n", argv[0], files[i]);
+      }
+    }
+  else
+    {
+    time_t now = time(NULL);
+
+    for (unsigned int day = 0; day < number_of_days; day++)
+      {
+      time_t    t = now - (number_of_days - day - 1) * 86400;
+      struct tm tm;
+
+      localtime_r(&t, &tm);
+
+      snprintf(path, sizeof(path), "%s/%s/%04d%02d%02d%s",
+        prefix_path,
+        usage_path,
+        tm.tm_year + 1900,
+        tm.tm_mon + 1,
+        tm.tm_mday,
+        ACCT_USAGE_SUFFIX);
+
+      /* a missing file only means no usage was recorded that day */
+      if ((read_usage_file(path, &filter, records) < 0) &&
+          (errno != ENOENT))
+        fprintf(stderr, "%s: %s is not a usage file\n", argv[0], path);
+      }
+    }
+
+  add_usage(records, key, totals);
+  print_usage_totals(stdout, key, totals);
+
+  return(0);
+  }  /* END main() */
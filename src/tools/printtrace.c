@@ -0,0 +1,539 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+/*
+ * printtrace - decode and filter the binary job event trace
+ *
+ * Reads the YYYYMMDD.trace files pbs_server and pbs_mom write when
+ * record_job_trace is set, and prints the records in time order or a
+ * summary of the event durations.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <algorithm>
+#include <vector>
+
+#include "pbs_ifl.h"
+#include "printtrace.h"
+
+#define TRACE_READ_RECORDS 1024
+#define TRACE_PATH_COUNT   2
+
+/* path from pbs home to the trace files */
+const char *trace_paths[] =
+  {
+  "server_logs",
+  "mom_logs"
+  };
+
+
+
+/*
+ * parse_trace_events - adds the comma separated event names in list to events
+ *
+ * @return 0 on success, -1 if a name isn't a trace event
+ */
+
+int parse_trace_events(
+
+  const char   *list,
+  unsigned int *events)
+
+  {
+  char *copy = strdup(list);
+  char *ptr = copy;
+  char *name;
+  int   rc = 0;
+
+  while ((name = strsep(&ptr, ",")) != NULL)
+    {
+    int event = trace_event_from_name(name);
+
+    if ((event <= TRACE_FILE_HEADER) ||
+        (event >= TRACE_EVENT_COUNT))
+      {
+      rc = -1;
+      break;
+      }
+
+    *events |= 1 << event;
+    }
+
+  free(copy);
+
+  return(rc);
+  }  /* END parse_trace_events() */
+
+
+
+/*
+ * set_trace_job_filter - match the records of job_id
+ *
+ * A job id without a server name matches on the sequence number alone.
+ */
+
+void set_trace_job_filter(
+
+  struct trace_filter *filter,
+  const char          *job_id)
+
+  {
+  if (strchr(job_id, '.') != NULL)
+    {
+    filter->match_hash = true;
+    filter->job_hash = trace_job_hash(job_id);
+    }
+  else
+    {
+    filter->match_num = true;
+    filter->job_num = trace_job_num(job_id);
+    }
+  }  /* END set_trace_job_filter() */
+
+
+
+bool trace_record_matches(
+
+  const trace_record        *rec,
+  const struct trace_filter *filter)
+
+  {
+  if ((rec->tr_event <= TRACE_FILE_HEADER) ||
+      (rec->tr_event >= TRACE_EVENT_COUNT))
+    return(false);
+
+  if ((filter->events != 0) &&
+      ((filter->events & (1 << rec->tr_event)) == 0))
+    return(false);
+
+  if ((filter->match_hash == true) &&
+      (rec->tr_job_hash != filter->job_hash))
+    return(false);
+
+  if ((filter->match_num == true) &&
+      (rec->tr_job_num != filter->job_num))
+    return(false);
+
+  return(true);
+  }  /* END trace_record_matches() */
+
+
+
+/*
+ * read_trace_file - appends the records in path that match filter to records
+ *
+ * @return the number of records added, -1 if path isn't a trace file
+ */
+
+int read_trace_file(
+
+  const char                *path,
+  const struct trace_filter *filter,
+  std::vector<trace_record> &records)
+
+  {
+  trace_record buf[TRACE_READ_RECORDS];
+  ssize_t      amt;
+  int          fd;
+  int          added = 0;
+  bool         first = true;
+
+  if ((fd = open(path, O_RDONLY, 0)) < 0)
+    return(-1);
+
+  while ((amt = read(fd, buf, sizeof(buf))) > 0)
+    {
+    int count = amt / sizeof(trace_record);
+
+    for (int i = 0; i < count; i++)
+      {
+      if (first == true)
+        {
+        /* the file must start with a header we understand */
+        if ((buf[i].tr_event != TRACE_FILE_HEADER) ||
+            (buf[i].tr_job_hash != TRACE_MAGIC) ||
+            (buf[i].tr_job_num != sizeof(trace_record)) ||
+            (buf[i].tr_value != TRACE_VERSION))
+          {
+          close(fd);
+          errno = EINVAL;
+          return(-1);
+          }
+
+        first = false;
+        continue;
+        }
+
+      if (trace_record_matches(&buf[i], filter) == true)
+        {
+        records.push_back(buf[i]);
+        added++;
+        }
+      }
+
+    /* a partial record can only be at the end of a file being written */
+    if (amt % sizeof(trace_record) != 0)
+      break;
+    }
+
+  close(fd);
+
+  if (first == true)
+    {
+    errno = EINVAL;
+    return(-1);
+    }
+
+  return(added);
+  }  /* END read_trace_file() */
+
+
+
+bool trace_record_before(
+
+  const trace_record &a,
+  const trace_record &b)
+
+  {
+  return(a.tr_time < b.tr_time);
+  }  /* END trace_record_before() */
+
+
+
+/*
+ * format_trace_record - one line describing rec
+ */
+
+void format_trace_record(
+
+  const trace_record *rec,
+  char               *buf,
+  int                 buf_size)
+
+  {
+  time_t    secs = rec->tr_time / 1000000;
+  struct tm tm;
+
+  localtime_r(&secs, &tm);
+
+  snprintf(buf, buf_size,
+    "%02d/%02d/%04d %02d:%02d:%02d.%03d  %-6s  %-8s  %-10u  %08x  %12.3f  %d",
+    tm.tm_mon + 1,
+    tm.tm_mday,
+    tm.tm_year + 1900,
+    tm.tm_hour,
+    tm.tm_min,
+    tm.tm_sec,
+    (int)((rec->tr_time % 1000000) / 1000),
+    (rec->tr_source == TRACE_SOURCE_MOM) ? "mom" : "server",
+    trace_event_name(rec->tr_event),
+    rec->tr_job_num,
+    rec->tr_job_hash,
+    rec->tr_duration / 1000000.0,
+    rec->tr_value);
+  }  /* END format_trace_record() */
+
+
+
+/*
+ * print_trace_summary - count and duration statistics for each event
+ */
+
+void print_trace_summary(
+
+  FILE                            *out,
+  const std::vector<trace_record> &records)
+
+  {
+  unsigned long count[TRACE_EVENT_COUNT];
+  uint64_t      total[TRACE_EVENT_COUNT];
+  uint64_t      min[TRACE_EVENT_COUNT];
+  uint64_t      max[TRACE_EVENT_COUNT];
+
+  memset(count, 0, sizeof(count));
+  memset(total, 0, sizeof(total));
+  memset(max, 0, sizeof(max));
+
+  for (unsigned int i = 0; i < records.size(); i++)
+    {
+    const trace_record &rec = records[i];
+
+    if ((count[rec.tr_event] == 0) ||
+        (rec.tr_duration < min[rec.tr_event]))
+      min[rec.tr_event] = rec.tr_duration;
+
+    if (rec.tr_duration > max[rec.tr_event])
+      max[rec.tr_event] = rec.tr_duration;
+
+    total[rec.tr_event] += rec.tr_duration;
+    count[rec.tr_event]++;
+    }
+
+  fprintf(out, "%-8s  %10s  %12s  %12s  %12s\n", "event", "count", "min", "avg", "max");
+
+  for (int event = TRACE_FILE_HEADER + 1; event < TRACE_EVENT_COUNT; event++)
+    {
+    if (count[event] == 0)
+      continue;
+
+    fprintf(out, "%-8s  %10lu  %12.3f  %12.3f  %12.3f\n",
+      trace_event_name(event),
+      count[event],
+      min[event] / 1000000.0,
+      (total[event] / count[event]) / 1000000.0,
+      max[event] / 1000000.0);
+    }
+  }  /* END print_trace_summary() */
+
+
+
+int main(
+
+  int   argc,
+  char *argv[])
+
+  {
+  std::vector<trace_record>  records;
+  struct trace_filter        filter;
+  const char                *files[MAX_TRACE_FILES];
+  int                        file_count = 0;
+  const char                *prefix_path = PBS_SERVER_HOME;
+  unsigned int               number_of_days = 1;
+  bool                       summary = false;
+  bool                       no_svr = false;
+  bool                       no_mom = false;
+  short                      error = 0;
+  char                      *endp;
+  int                        c;
+  char                       path[MAXPATHLEN];
+  char                       line[256];
+
+  memset(&filter, 0, sizeof(filter));
+
+  while ((c = getopt(argc, argv, "Ssmp:n:e:f:")) != EOF)
+    {
+    switch (c)
+      {
+      case 'S':
+
+        summary = true;
+
+        break;
+
+      case 's':
+
+        no_svr = true;
+
+        break;
+
+      case 'm':
+
+        no_mom = true;
+
+        break;
+
+      case 'p':
+
+        prefix_path = optarg;
+
+        break;
+
+      case 'n':
+
+        number_of_days = strtoul(optarg, &endp, 10);
+
+        if (*endp != '\0')
+          error = 1;
+
+        break;
+
+      case 'e':
+
+        if (parse_trace_events(optarg, &filter.events) != 0)
+          error = 1;
+
+        break;
+
+      case 'f':
+
+        if (file_count < MAX_TRACE_FILES)
+          files[file_count++] = optarg;
+
+        break;
+
+      default:
+
+        error = 1;
+
+        break;
+      }
+    }
+
+  if ((error != 0) ||
+      (argc - optind > 1))
+    {
+    fprintf(stderr, "USAGE: %s [-S] [-s] [-m] [-p path] [-n days] [-e events] [-f file]... [JOBID]\n",
+      argv[0]);
+
+    fprintf(stderr,
+      "   -S : print the count and durations of each event instead of the records\n"
+      "   -s : don't use server trace files\n"
+      "   -m : don't use mom trace files\n"
+      "   -p : path to PBS_SERVER_HOME [default %s]\n"
+      "   -n : number of days in the past to read [default 1]\n"
+      "   -e : comma separated events to print: queued, run, obit, requeue,\n"
+      "        complete, deleted, start, exit\n"
+      "   -f : read this trace file instead of the ones in PBS_SERVER_HOME\n",
+      PBS_SERVER_HOME);
+
+    return(1);
+    }
+
+  if (optind < argc)
+    set_trace_job_filter(&filter, argv[optind]);
+
+  if (file_count > 0)
+    {
+    for (int i = 0; i < file_count; i++)
+      {
+      if (read_trace_file(files[i], &filter, records) < 0)
+        fprintf(stderr, "%s: %s is not a trace file\n", argv[0], files[i]);
+      }
+    }
+  else
+    {
+    time_t now = time(NULL);
+
+    for (unsigned int day = 0; day < number_of_days; day++)
+      {
+      time_t    t = now - (number_of_days - day - 1) * 86400;
+      struct tm tm;
+
+      localtime_r(&t, &tm);
+
+      for (int index = 0; index < TRACE_PATH_COUNT; index++)
+        {
+        if (((index == 0) && (no_svr == true)) ||
+            ((index == 1) && (no_mom == true)))
+          continue;
+
+        snprintf(path, sizeof(path), "%s/%s/%04d%02d%02d%s",
+          prefix_path,
+          trace_paths[index],
+          tm.tm_year + 1900,
+          tm.tm_mon + 1,
+          tm.tm_mday,
+          TRACE_FILE_SUFFIX);
+
+        /* a missing file only means nothing was traced that day */
+        if ((read_trace_file(path, &filter, records) < 0) &&
+            (errno != ENOENT))
+          fprintf(stderr, "%s: %s is not a trace file\n", argv[0], path);
+        }
+      }
+    }
+
+  std::stable_sort(records.begin(), records.end(), trace_record_before);
+
+  if (summary == true)
+    {
+    print_trace_summary(stdout, records);
+    return(0);
+    }
+
+  printf("%-23s  %-6s  %-8s  %-10s  %-8s  %12s  %s\n",
+    "time", "source", "event", "job", "job hash", "duration", "value");
+
+  for (unsigned int i = 0; i < records.size(); i++)
+    {
+    format_trace_record(&records[i], line, sizeof(line));
+    printf("%s\n", line);
+    }
+
+  return(0);
+  }  /* END main() */
@@ -0,0 +1,265 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "printacct.h"
+#include "test_printacct.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include "pbs_error.h"
+
+
+acct_usage_record make_usage(
+
+  const char *job_id,
+  const char *user,
+  const char *queue,
+  uint64_t    walltime,
+  uint32_t    slots)
+
+  {
+  acct_usage_record rec;
+
+  memset(&rec, 0, sizeof(rec));
+  snprintf(rec.ur_job_id, sizeof(rec.ur_job_id), "%s", job_id);
+  snprintf(rec.ur_user, sizeof(rec.ur_user), "%s", user);
+  snprintf(rec.ur_group, sizeof(rec.ur_group), "staff");
+  snprintf(rec.ur_queue, sizeof(rec.ur_queue), "%s", queue);
+  rec.ur_walltime = walltime;
+  rec.ur_cput = walltime / 2;
+  rec.ur_slots = slots;
+  rec.ur_mem = walltime * 10;
+  rec.ur_type = 'E';
+
+  return(rec);
+  }
+
+
+
+/* writes records to path and, if index_count isn't -1, an index covering
+ * the first index_count of them */
+void write_usage_files(
+
+  const char                     *path,
+  std::vector<acct_usage_record> &records,
+  int                             index_count)
+
+  {
+  acct_usage_header header;
+  FILE             *fp = fopen(path, "w");
+
+  memset(&header, 0, sizeof(header));
+  header.uh_magic = ACCT_USAGE_MAGIC;
+  header.uh_version = ACCT_USAGE_VERSION;
+  header.uh_record_size = sizeof(acct_usage_record);
+  fwrite(&header, sizeof(header), 1, fp);
+  fwrite(&records[0], sizeof(acct_usage_record), records.size(), fp);
+  fclose(fp);
+
+  if (index_count == -1)
+    return;
+
+  std::map<std::string, std::vector<uint32_t> > users;
+  std::string                                   index_path(path);
+
+  for (int i = 0; i < index_count; i++)
+    users[records[i].ur_user].push_back(i);
+
+  index_path.replace(index_path.size() - strlen(ACCT_USAGE_SUFFIX), std::string::npos, ACCT_USAGE_INDEX_SUFFIX);
+
+  acct_usage_index_header ih;
+  std::vector<uint32_t>   numbers;
+
+  memset(&ih, 0, sizeof(ih));
+  ih.uih_magic = ACCT_USAGE_INDEX_MAGIC;
+  ih.uih_version = ACCT_USAGE_VERSION;
+  ih.uih_user_count = users.size();
+  ih.uih_record_count = index_count;
+
+  fp = fopen(index_path.c_str(), "w");
+  fwrite(&ih, sizeof(ih), 1, fp);
+
+  for (std::map<std::string, std::vector<uint32_t> >::iterator it = users.begin(); it != users.end(); it++)
+    {
+    acct_usage_index_entry entry;
+
+    memset(&entry, 0, sizeof(entry));
+    snprintf(entry.uie_user, sizeof(entry.uie_user), "%s", it->first.c_str());
+    entry.uie_first = numbers.size();
+    entry.uie_count = it->second.size();
+    fwrite(&entry, sizeof(entry), 1, fp);
+    numbers.insert(numbers.end(), it->second.begin(), it->second.end());
+    }
+
+  fwrite(&numbers[0], sizeof(uint32_t), numbers.size(), fp);
+  fclose(fp);
+  }
+
+
+
+START_TEST(test_parse_usage_key)
+  {
+  fail_unless(parse_usage_key("user") == USAGE_BY_USER);
+  fail_unless(parse_usage_key("Queue") == USAGE_BY_QUEUE);
+  fail_unless(parse_usage_key("job") == USAGE_BY_JOB);
+  fail_unless(parse_usage_key("node") == -1);
+  }
+END_TEST
+
+
+
+START_TEST(test_usage_record_matches)
+  {
+  struct usage_filter filter;
+  acct_usage_record   rec = make_usage("1.napali", "dbeer", "batch", 100, 1);
+
+  memset(&filter, 0, sizeof(filter));
+  fail_unless(usage_record_matches(&rec, &filter) == true);
+
+  filter.user = "dbeer";
+  fail_unless(usage_record_matches(&rec, &filter) == true);
+
+  filter.queue = "long";
+  fail_unless(usage_record_matches(&rec, &filter) == false);
+
+  filter.queue = NULL;
+  filter.user = "tom";
+  fail_unless(usage_record_matches(&rec, &filter) == false);
+  }
+END_TEST
+
+
+
+START_TEST(test_read_usage_file)
+  {
+  char                            path[] = "/tmp/printacct_XXXXXX";
+  int                             fd = mkstemp(path);
+  std::string                     usage_path;
+  std::string                     index_path;
+  std::vector<acct_usage_record>  written;
+  std::vector<acct_usage_record>  records;
+  struct usage_filter             filter;
+
+  fail_unless(fd >= 0);
+  close(fd);
+  usage_path = std::string(path) + ACCT_USAGE_SUFFIX;
+  index_path = std::string(path) + ACCT_USAGE_INDEX_SUFFIX;
+
+  written.push_back(make_usage("1.napali", "dbeer", "batch", 100, 1));
+  written.push_back(make_usage("2.napali", "tom", "batch", 200, 2));
+  written.push_back(make_usage("3.napali", "dbeer", "long", 300, 4));
+  written.push_back(make_usage("4.napali", "dbeer", "batch", 400, 1));
+
+  memset(&filter, 0, sizeof(filter));
+
+  // a file that isn't a usage file
+  fail_unless(read_usage_file(path, &filter, records) == -1);
+
+  // no index, every record is scanned
+  write_usage_files(usage_path.c_str(), written, -1);
+  fail_unless(read_usage_file(usage_path.c_str(), &filter, records) == 4);
+  records.clear();
+
+  filter.user = "dbeer";
+  fail_unless(read_usage_file(usage_path.c_str(), &filter, records) == 3);
+  records.clear();
+
+  // an index of the first three records, the fourth was written after it
+  write_usage_files(usage_path.c_str(), written, 3);
+  std::vector<uint32_t> numbers;
+  fail_unless(read_usage_index(usage_path.c_str(), "dbeer", 4, numbers) == 3);
+  fail_unless(numbers.size() == 2);
+  fail_unless(numbers[0] == 0);
+  fail_unless(numbers[1] == 2);
+
+  // an index covering more records than the file doesn't belong to it
+  numbers.clear();
+  fail_unless(read_usage_index(usage_path.c_str(), "dbeer", 2, numbers) == -1);
+
+  fail_unless(read_usage_file(usage_path.c_str(), &filter, records) == 3);
+  fail_unless(!strcmp(records[0].ur_job_id, "1.napali"));
+  fail_unless(!strcmp(records[1].ur_job_id, "3.napali"));
+  fail_unless(!strcmp(records[2].ur_job_id, "4.napali"));
+  records.clear();
+
+  filter.user = "tom";
+  fail_unless(read_usage_file(usage_path.c_str(), &filter, records) == 1);
+
+  unlink(path);
+  unlink(usage_path.c_str());
+  unlink(index_path.c_str());
+  }
+END_TEST
+
+
+
+START_TEST(test_add_usage)
+  {
+  std::vector<acct_usage_record>      records;
+  std::map<std::string, usage_total>  totals;
+
+  records.push_back(make_usage("1.napali", "dbeer", "batch", 100, 1));
+  records.push_back(make_usage("2.napali", "tom", "batch", 200, 2));
+  records.push_back(make_usage("3.napali", "dbeer", "long", 300, 4));
+
+  add_usage(records, USAGE_BY_USER, totals);
+  fail_unless(totals.size() == 2);
+  fail_unless(totals["dbeer"].jobs == 2);
+  fail_unless(totals["dbeer"].walltime == 400);
+  fail_unless(totals["dbeer"].cput == 200);
+  fail_unless(totals["dbeer"].slot_time == 1300);
+  fail_unless(totals["dbeer"].max_mem == 3000);
+  fail_unless(totals["tom"].slot_time == 400);
+
+  totals.clear();
+  add_usage(records, USAGE_BY_QUEUE, totals);
+  fail_unless(totals["batch"].jobs == 2);
+  fail_unless(totals["long"].jobs == 1);
+
+  FILE *out = tmpfile();
+  char  line[256];
+
+  print_usage_totals(out, USAGE_BY_QUEUE, totals);
+  rewind(out);
+  fail_unless(fgets(line, sizeof(line), out) != NULL);
+  fail_unless(!strncmp(line, "queue", 5));
+  fail_unless(fgets(line, sizeof(line), out) != NULL);
+  fail_unless(!strncmp(line, "batch", 5));
+  fclose(out);
+  }
+END_TEST
+
+
+
+Suite *printacct_suite(void)
+  {
+  Suite *s = suite_create("printacct test suite methods");
+  TCase *tc_core = tcase_create("test_parse_usage_key");
+  tcase_add_test(tc_core, test_parse_usage_key);
+  tcase_add_test(tc_core, test_usage_record_matches);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_read_usage_file");
+  tcase_add_test(tc_core, test_read_usage_file);
+  tcase_add_test(tc_core, test_add_usage);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(printacct_suite());
+  srunner_set_log(sr, "printacct_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
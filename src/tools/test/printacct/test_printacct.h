@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _PRINTACCT_CT_H
+#define _PRINTACCT_CT_H
+#include <check.h>
+
+Suite *printacct_suite();
+
+#endif /* _PRINTACCT_CT_H */
@@ -0,0 +1,45 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+#include <strings.h>
+#include "event_trace.h"
+
+static const char *names[] =
+  {
+  "header", "queued", "run", "obit", "requeue", "complete", "deleted", "start", "exit"
+  };
+
+uint32_t trace_job_hash(const char *job_id)
+  {
+  uint32_t hash = 0;
+
+  while (*job_id != '\0')
+    hash = hash * 31 + *job_id++;
+
+  return(hash);
+  }
+
+uint32_t trace_job_num(const char *job_id)
+  {
+  return(strtoul(job_id, NULL, 10));
+  }
+
+const char *trace_event_name(int event)
+  {
+  if ((event < 0) ||
+      (event >= TRACE_EVENT_COUNT))
+    return("unknown");
+
+  return(names[event]);
+  }
+
+int trace_event_from_name(const char *name)
+  {
+  for (int i = 0; i < TRACE_EVENT_COUNT; i++)
+    {
+    if (!strcasecmp(name, names[i]))
+      return(i);
+    }
+
+  return(-1);
+  }
@@ -0,0 +1,214 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "printtrace.h"
+#include "test_printtrace.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <algorithm>
+#include "pbs_error.h"
+
+
+trace_record make_record(
+
+  int         event,
+  const char *job_id,
+  uint64_t    when,
+  uint64_t    duration)
+
+  {
+  trace_record rec;
+
+  memset(&rec, 0, sizeof(rec));
+  rec.tr_time = when;
+  rec.tr_duration = duration;
+  rec.tr_job_hash = trace_job_hash(job_id);
+  rec.tr_job_num = trace_job_num(job_id);
+  rec.tr_event = event;
+
+  return(rec);
+  }
+
+
+START_TEST(test_parse_trace_events)
+  {
+  unsigned int events = 0;
+
+  fail_unless(parse_trace_events("run", &events) == 0);
+  fail_unless(events == (1 << TRACE_JOB_RUN));
+
+  fail_unless(parse_trace_events("obit,EXIT", &events) == 0);
+  fail_unless(events == ((1 << TRACE_JOB_RUN) | (1 << TRACE_JOB_OBIT) | (1 << TRACE_JOB_EXIT)));
+
+  fail_unless(parse_trace_events("run,bogus", &events) == -1);
+  fail_unless(parse_trace_events("header", &events) == -1);
+  }
+END_TEST
+
+
+START_TEST(test_trace_record_matches)
+  {
+  struct trace_filter filter;
+  trace_record        rec = make_record(TRACE_JOB_RUN, "12.napali", 0, 0);
+
+  memset(&filter, 0, sizeof(filter));
+  fail_unless(trace_record_matches(&rec, &filter) == true);
+
+  // the header is never printed
+  rec.tr_event = TRACE_FILE_HEADER;
+  fail_unless(trace_record_matches(&rec, &filter) == false);
+  rec.tr_event = TRACE_JOB_RUN;
+
+  filter.events = 1 << TRACE_JOB_OBIT;
+  fail_unless(trace_record_matches(&rec, &filter) == false);
+  filter.events |= 1 << TRACE_JOB_RUN;
+  fail_unless(trace_record_matches(&rec, &filter) == true);
+
+  set_trace_job_filter(&filter, "12.napali");
+  fail_unless(filter.match_hash == true);
+  fail_unless(trace_record_matches(&rec, &filter) == true);
+
+  set_trace_job_filter(&filter, "12.kaena");
+  fail_unless(trace_record_matches(&rec, &filter) == false);
+
+  // without a server name only the sequence number has to match
+  memset(&filter, 0, sizeof(filter));
+  set_trace_job_filter(&filter, "12");
+  fail_unless(filter.match_num == true);
+  fail_unless(filter.match_hash == false);
+  fail_unless(trace_record_matches(&rec, &filter) == true);
+
+  set_trace_job_filter(&filter, "13");
+  fail_unless(trace_record_matches(&rec, &filter) == false);
+  }
+END_TEST
+
+
+START_TEST(test_read_trace_file)
+  {
+  char                      path[] = "/tmp/printtrace_test.XXXXXX";
+  int                       fd = mkstemp(path);
+  struct trace_filter       filter;
+  std::vector<trace_record> records;
+  trace_record              recs[4];
+
+  fail_unless(fd >= 0);
+
+  memset(&filter, 0, sizeof(filter));
+  memset(recs, 0, sizeof(recs));
+  recs[0].tr_event = TRACE_FILE_HEADER;
+  recs[0].tr_job_hash = TRACE_MAGIC;
+  recs[0].tr_job_num = sizeof(trace_record);
+  recs[0].tr_value = TRACE_VERSION;
+  recs[1] = make_record(TRACE_JOB_QUEUED, "1.napali", 100, 0);
+  recs[2] = make_record(TRACE_JOB_RUN, "1.napali", 200, 100);
+  recs[3] = make_record(TRACE_JOB_QUEUED, "2.napali", 150, 0);
+
+  fail_unless(write(fd, recs, sizeof(recs)) == sizeof(recs));
+  // a record still being written is ignored
+  fail_unless(write(fd, recs, 7) == 7);
+
+  fail_unless(read_trace_file(path, &filter, records) == 3);
+  fail_unless(records[1].tr_event == TRACE_JOB_RUN);
+
+  set_trace_job_filter(&filter, "1.napali");
+  fail_unless(read_trace_file(path, &filter, records) == 2);
+  fail_unless(records.size() == 5);
+
+  std::stable_sort(records.begin(), records.end(), trace_record_before);
+  fail_unless(records[0].tr_time == 100);
+  fail_unless(records[2].tr_time == 150);
+  fail_unless(records[4].tr_time == 200);
+
+  // a file that doesn't start with a header is rejected
+  lseek(fd, 0, SEEK_SET);
+  recs[0].tr_job_hash = 0;
+  fail_unless(write(fd, recs, sizeof(recs[0])) == sizeof(recs[0]));
+  fail_unless(read_trace_file(path, &filter, records) == -1);
+  fail_unless(errno == EINVAL);
+
+  close(fd);
+  unlink(path);
+
+  fail_unless(read_trace_file(path, &filter, records) == -1);
+  fail_unless(errno == ENOENT);
+  }
+END_TEST
+
+
+START_TEST(test_format_trace_record)
+  {
+  trace_record rec = make_record(TRACE_JOB_OBIT, "42.napali", 1000000000123456ULL, 61500000);
+  char         buf[256];
+
+  rec.tr_source = TRACE_SOURCE_MOM;
+  rec.tr_value = 271;
+
+  format_trace_record(&rec, buf, sizeof(buf));
+
+  fail_unless(strstr(buf, ".123  mom     obit      42  ") != NULL, buf);
+  fail_unless(strstr(buf, "61.500  271") != NULL, buf);
+  }
+END_TEST
+
+
+START_TEST(test_print_trace_summary)
+  {
+  std::vector<trace_record> records;
+  char                      buf[1024];
+  FILE                     *out = tmpfile();
+  size_t                    len;
+
+  records.push_back(make_record(TRACE_JOB_RUN, "1.napali", 0, 1000000));
+  records.push_back(make_record(TRACE_JOB_RUN, "2.napali", 0, 3000000));
+  records.push_back(make_record(TRACE_JOB_OBIT, "1.napali", 0, 500000));
+
+  print_trace_summary(out, records);
+
+  rewind(out);
+  len = fread(buf, 1, sizeof(buf) - 1, out);
+  buf[len] = '\0';
+  fclose(out);
+
+  fail_unless(strstr(buf, "run                2         1.000         2.000         3.000") != NULL, buf);
+  fail_unless(strstr(buf, "obit               1         0.500         0.500         0.500") != NULL, buf);
+  fail_unless(strstr(buf, "queued") == NULL, buf);
+  }
+END_TEST
+
+
+Suite *printtrace_suite(void)
+  {
+  Suite *s = suite_create("printtrace_suite methods");
+  TCase *tc_core = tcase_create("test_parse_trace_events");
+  tcase_add_test(tc_core, test_parse_trace_events);
+  tcase_add_test(tc_core, test_trace_record_matches);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_read_trace_file");
+  tcase_add_test(tc_core, test_read_trace_file);
+  tcase_add_test(tc_core, test_format_trace_record);
+  tcase_add_test(tc_core, test_print_trace_summary);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(printtrace_suite());
+  srunner_set_log(sr, "printtrace_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
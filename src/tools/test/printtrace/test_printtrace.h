@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _PRINTTRACE_CT_H
+#define _PRINTTRACE_CT_H
+#include <check.h>
+
+Suite *printtrace_suite();
+
+#endif /* _PRINTTRACE_CT_H */